@@ -12,6 +12,7 @@
 
 #include "mozilla/dom/TabChild.h"
 #include "mozilla/dom/Element.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/Telemetry.h"
 
 using namespace mozilla;
@@ -622,6 +623,20 @@ NotificationController::WillRefresh(mozilla::TimeStamp aTime)
       return;
     }
 
+    // Optionally defer building trees for documents whose presentation isn't
+    // active (background tabs), so that instantiating the accessibility
+    // service doesn't pay the construction cost for every loaded document up
+    // front. We stay attached as a refresh observer and the tree is built on
+    // the first tick after the presentation becomes active; until then no
+    // accessibles for this document exist, so there are no stale notifications
+    // to worry about. Off by default because some ATs walk documents that
+    // were never brought to the foreground.
+    if (!mPresShell->IsActive() &&
+        Preferences::GetBool("accessibility.defer_inactive_doc_trees", false)) {
+      mObservingState = eRefreshObserving;
+      return;
+    }
+
 #ifdef A11Y_LOG
     if (logging::IsEnabled(logging::eTree)) {
       logging::MsgBegin("TREE", "initial tree created");
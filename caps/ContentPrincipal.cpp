@@ -7,6 +7,7 @@
 #include "ContentPrincipal.h"
 
 #include "mozIThirdPartyUtil.h"
+#include "nsAtom.h"
 #include "nscore.h"
 #include "nsScriptSecurityManager.h"
 #include "nsString.h"
@@ -266,6 +267,15 @@ ContentPrincipal::SubsumesInternal(nsIPrincipal* aOther,
   // DNS spoofing based on document.domain (154930)
   nsresult rv;
   if (aConsideration == ConsiderDocumentDomain) {
+    // If both principals carry an interned domain origin, equality is just a
+    // pointer comparison on the atoms.
+    if (Cast(aOther)->Kind() == eCodebasePrincipal) {
+      auto* other = static_cast<ContentPrincipal*>(aOther);
+      if (mDomainOrigin && other->mDomainOrigin) {
+        return mDomainOrigin == other->mDomainOrigin;
+      }
+    }
+
     // Get .domain on each principal.
     nsCOMPtr<nsIURI> thisDomain, otherDomain;
     GetDomain(getter_AddRefs(thisDomain));
@@ -370,6 +380,37 @@ ContentPrincipal::SetDomain(nsIURI* aDomain)
   mDomainImmutable = URIIsImmutable(mDomain);
   SetHasExplicitDomain();
 
+  // Intern the domain's origin so that SubsumesInternal can compare
+  // document.domain by pointer. Only http(s) domains take the fast path;
+  // anything else keeps the null atom and falls back to the full URI
+  // comparison.
+  mDomainOrigin = nullptr;
+  if (mDomain) {
+    nsAutoCString scheme;
+    if (NS_SUCCEEDED(mDomain->GetScheme(scheme)) &&
+        (scheme.EqualsLiteral("http") || scheme.EqualsLiteral("https"))) {
+      nsAutoCString host;
+      if (NS_SUCCEEDED(mDomain->GetAsciiHost(host)) && !host.IsEmpty()) {
+        int32_t port;
+        if (NS_FAILED(mDomain->GetPort(&port))) {
+          port = -1;
+        }
+        if (port == -1) {
+          // Normalize to the scheme's default port so that explicit and
+          // implicit default ports intern to the same atom, matching
+          // SecurityCompareURIs.
+          port = scheme.EqualsLiteral("http") ? 80 : 443;
+        }
+        nsAutoCString origin(scheme);
+        origin.AppendLiteral("://");
+        origin.Append(host);
+        origin.Append(':');
+        origin.AppendInt(port);
+        mDomainOrigin = NS_Atomize(origin);
+      }
+    }
+  }
+
   // Recompute all wrappers between compartments using this principal and other
   // non-chrome compartments.
   AutoSafeJSContext cx;
@@ -52,6 +52,13 @@ public:
 
   nsCOMPtr<nsIURI> mDomain;
   nsCOMPtr<nsIURI> mCodebase;
+  // Interned scheme://host:port of mDomain, when mDomain has a host. Because
+  // atoms are process-wide unique, two principals whose document.domain
+  // resolves to the same origin share the same atom, which lets
+  // SubsumesInternal compare domains by pointer instead of going through
+  // SecurityCompareURIs. Null when no domain is set or when the domain's
+  // scheme needs the full URI comparison (e.g. file:).
+  RefPtr<nsAtom> mDomainOrigin;
   // If mCodebaseImmutable is true, mCodebase is non-null and immutable
   bool mCodebaseImmutable;
   bool mDomainImmutable;
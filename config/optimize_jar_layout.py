@@ -0,0 +1,141 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+"""Reorder jar archives by startup access order and emit index sidecars.
+
+Takes an access log recorded by libjar (run with MOZ_JAR_LOG_FILE set; each
+line is "<archive uri> <entry>") and one or more archives, then:
+
+ 1. rewrites each archive so its entries are stored in first-access order,
+    with never-accessed entries following in their original order, and
+ 2. writes an "<archive>.idx" sidecar persisting the parsed central
+    directory, which nsZipArchive reads instead of scanning the central
+    directory (see nsZipArchive::ReadIndexSidecar for the format).
+
+Usage: python optimize_jar_layout.py <access.log> <archive> [<archive>...]
+"""
+
+import os
+import struct
+import sys
+import zipfile
+import zlib
+
+# These must match the constants in modules/libjar.
+ZIP_TABSIZE = 256
+INDEX_SIDECAR_MAGIC = 0x5844494a  # 'JIDX'
+INDEX_TAIL_CRC_LENGTH = 4096
+
+CENTRAL_SIG = 0x02014b50
+CENTRAL_SIZE = 46
+END_SIG = 0x06054b50
+END_SIZE = 22
+
+
+def hash_name(name):
+    """Replicates HashName from nsZipArchive.cpp."""
+    val = 0
+    for c in bytearray(name):
+        val = (val * 37 + c) & 0xffffffff
+    return val % ZIP_TABSIZE
+
+
+def read_access_order(log_path, jar_path):
+    """Returns the unique entry names logged for jar_path, in first-access
+    order. Archives are matched by leaf name, since the log records URIs."""
+    leaf = os.path.basename(jar_path)
+    order = []
+    seen = set()
+    with open(log_path) as log:
+        for line in log:
+            parts = line.strip().split(None, 1)
+            if len(parts) != 2:
+                continue
+            uri, entry = parts
+            if not uri.endswith(leaf) and leaf + '!' not in uri:
+                continue
+            if entry not in seen:
+                seen.add(entry)
+                order.append(entry)
+    return order
+
+
+def reorder_jar(jar_path, order):
+    """Rewrites jar_path with the entries named in order first, in that
+    order, and the remaining entries after them in their original order."""
+    tmp_path = jar_path + '.tmp'
+    with zipfile.ZipFile(jar_path) as zin:
+        names = zin.namelist()
+        present = set(names)
+        ordered = [n for n in order if n in present]
+        accessed = set(ordered)
+        ordered += [n for n in names if n not in accessed]
+
+        with zipfile.ZipFile(tmp_path, 'w') as zout:
+            zout.comment = zin.comment
+            for name in ordered:
+                info = zin.getinfo(name)
+                zout.writestr(info, zin.read(name))
+
+    os.rename(tmp_path, jar_path)
+
+
+def parse_central_directory(data):
+    """Returns ([(central record offset, name length)], comment offset,
+    comment length) for the given archive data."""
+    # Find the end-of-central-directory record; it's at the very end unless
+    # the archive has a comment.
+    end_offset = data.rfind(struct.pack('<I', END_SIG))
+    if end_offset < 0 or len(data) - end_offset < END_SIZE:
+        raise Exception('no end of central directory record')
+
+    (count, central_offset, comment_len) = struct.unpack_from(
+        '<xxxxxxxxxxHxxxxIH', data, end_offset)
+
+    comment_offset = end_offset + END_SIZE if comment_len else 0
+
+    entries = []
+    offset = central_offset
+    for _ in range(count):
+        if struct.unpack_from('<I', data, offset)[0] != CENTRAL_SIG:
+            raise Exception('bad central directory record')
+        (name_len, extra_len, entry_comment_len) = struct.unpack_from(
+            '<HHH', data, offset + 28)
+        entries.append((offset, name_len))
+        offset += CENTRAL_SIZE + name_len + extra_len + entry_comment_len
+    return entries, comment_offset, comment_len
+
+
+def write_sidecar(jar_path):
+    with open(jar_path, 'rb') as jar:
+        data = jar.read()
+
+    entries, comment_offset, comment_len = parse_central_directory(data)
+    tail_crc = zlib.crc32(data[-INDEX_TAIL_CRC_LENGTH:]) & 0xffffffff
+
+    with open(jar_path + '.idx', 'wb') as sidecar:
+        sidecar.write(struct.pack('<IIIIII', INDEX_SIDECAR_MAGIC, len(data),
+                                  tail_crc, comment_offset, comment_len,
+                                  len(entries)))
+        for offset, name_len in entries:
+            name = data[offset + CENTRAL_SIZE:offset + CENTRAL_SIZE + name_len]
+            sidecar.write(struct.pack('<IHH', offset, name_len,
+                                      hash_name(name)))
+
+
+def main(args):
+    if len(args) < 2:
+        print >> sys.stderr, ('Usage: optimize_jar_layout.py <access.log> '
+                              '<archive> [<archive>...]')
+        return 1
+
+    log_path = args[0]
+    for jar_path in args[1:]:
+        reorder_jar(jar_path, read_access_order(log_path, jar_path))
+        write_sidecar(jar_path)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
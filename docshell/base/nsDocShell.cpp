@@ -15058,6 +15058,11 @@ nsDocShell::ShouldPrepareForIntercept(nsIURI* aURI, bool aIsNonSubresourceReques
   nsCOMPtr<nsIPrincipal> principal =
     BasePrincipal::CreateCodebasePrincipal(aURI, mOriginAttributes);
   *aShouldIntercept = swm->IsAvailable(principal, aURI);
+  if (*aShouldIntercept) {
+    // Start the service worker now so its startup overlaps with the channel
+    // getting to the point where we can dispatch the fetch event.
+    swm->WarmUpServiceWorker(principal, aURI);
+  }
   return NS_OK;
 }
 
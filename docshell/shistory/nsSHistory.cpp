@@ -13,6 +13,7 @@
 #include "nsDocShell.h"
 #include "nsIContentViewer.h"
 #include "nsIDocShell.h"
+#include "nsIDocument.h"
 #include "nsIDocShellLoadInfo.h"
 #include "nsIDocShellTreeItem.h"
 #include "nsILayoutHistoryState.h"
@@ -21,9 +22,11 @@
 #include "nsISHEntry.h"
 #include "nsISHistoryListener.h"
 #include "nsISHTransaction.h"
+#include "nsIMemoryReporter.h"
 #include "nsIURI.h"
 #include "nsNetUtil.h"
 #include "nsTArray.h"
+#include "nsWindowSizes.h"
 #include "prsystem.h"
 
 #include "mozilla/Attributes.h"
@@ -38,6 +41,8 @@ using namespace mozilla;
 
 #define PREF_SHISTORY_SIZE "browser.sessionhistory.max_entries"
 #define PREF_SHISTORY_MAX_TOTAL_VIEWERS "browser.sessionhistory.max_total_viewers"
+#define PREF_SHISTORY_PRESSURE_VIEWER_BUDGET_KB \
+  "browser.sessionhistory.memory_pressure_viewer_budget_kb"
 #define CONTENT_VIEWER_TIMEOUT_SECONDS "browser.sessionhistory.contentViewerTimeout"
 
 // Default this to time out unused content viewers after 30 minutes
@@ -46,6 +51,7 @@ using namespace mozilla;
 static const char* kObservedPrefs[] = {
   PREF_SHISTORY_SIZE,
   PREF_SHISTORY_MAX_TOTAL_VIEWERS,
+  PREF_SHISTORY_PRESSURE_VIEWER_BUDGET_KB,
   nullptr
 };
 
@@ -55,6 +61,10 @@ static LinkedList<nsSHistory> gSHistoryList;
 // Max viewers allowed total, across all SHistory objects - negative default
 // means we will calculate how many viewers to cache based on total memory
 int32_t nsSHistory::sHistoryMaxTotalViewers = -1;
+// On memory-pressure, keep the closest cached viewers within this many
+// kilobytes instead of evicting every one of them. A couple of average-sized
+// presentations by the estimate CalcMaxTotalViewers() uses.
+int32_t nsSHistory::sHistoryPressureViewerBudgetKB = 16 * 1024;
 
 // A counter that is used to be able to know the order in which
 // entries were touched, so that we can evict older entries first.
@@ -319,6 +329,8 @@ nsSHistory::UpdatePrefs()
   Preferences::GetInt(PREF_SHISTORY_SIZE, &gHistoryMaxSize);
   Preferences::GetInt(PREF_SHISTORY_MAX_TOTAL_VIEWERS,
                       &sHistoryMaxTotalViewers);
+  Preferences::GetInt(PREF_SHISTORY_PRESSURE_VIEWER_BUDGET_KB,
+                      &sHistoryPressureViewerBudgetKB);
   // If the pref is negative, that means we calculate how many viewers
   // we think we should cache, based on total memory
   if (sHistoryMaxTotalViewers < 0) {
@@ -1146,6 +1158,23 @@ nsSHistory::EvictOutOfRangeWindowContentViewers(int32_t aIndex)
 
 namespace {
 
+MOZ_DEFINE_MALLOC_SIZE_OF(SHistoryMallocSizeOf)
+
+// Estimates how many bytes keeping a cached presentation alive costs, using
+// the same document measurement machinery as the window memory reporters.
+uint64_t
+EstimateContentViewerBytes(nsIContentViewer* aViewer)
+{
+  nsIDocument* document = aViewer ? aViewer->GetDocument() : nullptr;
+  if (!document) {
+    return 0;
+  }
+  SizeOfState state(SHistoryMallocSizeOf);
+  nsWindowSizes sizes(state);
+  document->DocAddSizeOfIncludingThis(sizes);
+  return sizes.getTotalSize();
+}
+
 class TransactionAndDistance
 {
 public:
@@ -1157,6 +1186,7 @@ public:
   {
     mViewer = GetContentViewerForTransaction(aTrans);
     NS_ASSERTION(mViewer, "Transaction should have a content viewer");
+    mBytes = EstimateContentViewerBytes(mViewer);
 
     nsCOMPtr<nsISHEntry> shentry;
     mTransaction->GetSHEntry(getter_AddRefs(shentry));
@@ -1171,11 +1201,17 @@ public:
 
   bool operator<(const TransactionAndDistance& aOther) const
   {
-    // Compare distances first, and fall back to last-accessed times.
+    // Compare distances first, then cost, so that the most expensive of
+    // equally distant presentations is evicted first, and fall back to
+    // last-accessed times.
     if (aOther.mDistance != this->mDistance) {
       return this->mDistance < aOther.mDistance;
     }
 
+    if (aOther.mBytes != this->mBytes) {
+      return this->mBytes < aOther.mBytes;
+    }
+
     return this->mLastTouched < aOther.mLastTouched;
   }
 
@@ -1191,6 +1227,7 @@ public:
   RefPtr<nsSHistory> mSHistory;
   nsCOMPtr<nsISHTransaction> mTransaction;
   nsCOMPtr<nsIContentViewer> mViewer;
+  uint64_t mBytes;
   uint32_t mLastTouched;
   int32_t mDistance;
 };
@@ -1200,6 +1237,14 @@ public:
 // static
 void
 nsSHistory::GloballyEvictContentViewers()
+{
+  EvictContentViewersByBudget(sHistoryMaxTotalViewers, UINT64_MAX);
+}
+
+// static
+void
+nsSHistory::EvictContentViewersByBudget(int32_t aMaxViewers,
+                                        uint64_t aMaxTotalBytes)
 {
   // First, collect from each SHistory object the transactions which have a
   // cached content viewer.  Associate with each transaction its distance from
@@ -1272,7 +1317,13 @@ nsSHistory::GloballyEvictContentViewers()
 
   // We now have collected all cached content viewers.  First check that we
   // have enough that we actually need to evict some.
-  if ((int32_t)transactions.Length() <= sHistoryMaxTotalViewers) {
+  int32_t maxViewers = std::max(aMaxViewers, 0);
+  uint64_t totalBytes = 0;
+  for (uint32_t i = 0; i < transactions.Length(); ++i) {
+    totalBytes += transactions[i].mBytes;
+  }
+  if ((int32_t)transactions.Length() <= maxViewers &&
+      totalBytes <= aMaxTotalBytes) {
     return;
   }
 
@@ -1282,8 +1333,11 @@ nsSHistory::GloballyEvictContentViewers()
   // so let's not worry about it.)
   transactions.Sort();
 
-  for (int32_t i = transactions.Length() - 1; i >= sHistoryMaxTotalViewers;
-       --i) {
+  for (int32_t i = transactions.Length() - 1; i >= 0; --i) {
+    if (i < maxViewers && totalBytes <= aMaxTotalBytes) {
+      break;
+    }
+    totalBytes -= transactions[i].mBytes;
     (transactions[i].mSHistory)->
       EvictContentViewerForTransaction(transactions[i].mTransaction);
   }
@@ -1377,10 +1431,19 @@ nsSHistory::RemoveFromExpirationTracker(nsIBFCacheEntry* aEntry)
 void
 nsSHistory::GloballyEvictAllContentViewers()
 {
-  int32_t maxViewers = sHistoryMaxTotalViewers;
-  sHistoryMaxTotalViewers = 0;
-  GloballyEvictContentViewers();
-  sHistoryMaxTotalViewers = maxViewers;
+  if (sHistoryPressureViewerBudgetKB < 0) {
+    EvictContentViewersByBudget(0, 0);
+    return;
+  }
+
+  // Under memory pressure, keep the presentations closest to their
+  // histories' current indices alive within a byte budget instead of
+  // throwing every one of them away. Back navigation to the pages the user
+  // is most likely to return to stays fast while the bulk of the memory is
+  // still given back.
+  EvictContentViewersByBudget(
+    sHistoryMaxTotalViewers,
+    uint64_t(sHistoryPressureViewerBudgetKB) * 1024);
 }
 
 void
@@ -147,8 +147,19 @@ private:
   // Set to true if attached to a grouped session history.
   bool mIsPartial;
 
+  // Evicts cached content viewers, farthest from their history's index
+  // first, until at most aMaxViewers viewers costing at most aMaxTotalBytes
+  // bytes in total remain.
+  static void EvictContentViewersByBudget(int32_t aMaxViewers,
+                                          uint64_t aMaxTotalBytes);
+
   // Max viewers allowed total, across all SHistory objects
   static int32_t sHistoryMaxTotalViewers;
+
+  // How many kilobytes' worth of content viewers to retain on
+  // memory-pressure, across all SHistory objects. Negative means evict
+  // every viewer, like we historically did.
+  static int32_t sHistoryPressureViewerBudgetKB;
 };
 
 class nsSHEnumerator : public nsISimpleEnumerator
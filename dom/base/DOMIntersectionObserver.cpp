@@ -267,6 +267,22 @@ enum class BrowsingContextInfo {
   UnknownBrowsingContext
 };
 
+namespace {
+
+// Immutable per-target geometry gathered by the first pass of Update().
+// Everything the second pass needs is plain data, so the intersection
+// arithmetic below runs without touching the frame tree again.
+struct IntersectionGeometry
+{
+  Element* mTarget;
+  nsRect mTargetRect;
+  nsRect mRootIntersectionRect;
+  Maybe<nsRect> mIntersectionRect;
+  bool mDifferentOriginBrowsingContext;
+};
+
+} // anonymous namespace
+
 void
 DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time)
 {
@@ -339,6 +355,24 @@ DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time
     rootMargin.Side(side) = nsLayoutUtils::ComputeCBDependentValue(basis, coord);
   }
 
+  // Invariants of this update, hoisted out of the per-target loops: the
+  // containing block used to map intersection rects into root coordinates,
+  // and the similar-origin check, which resolves base domains from
+  // principals that all nodes of a document share.  With thousands of
+  // targets in one document the answer is the same for nearly every target,
+  // so remember the last one.
+  nsIFrame* rootContainingBlock =
+    rootFrame ? nsLayoutUtils::GetContainingBlockForClientRect(rootFrame)
+              : nullptr;
+  nsIDocument* lastTargetDocument = nullptr;
+  bool lastSimilarOrigin = false;
+
+  // First pass: walk the frame tree once per target, in the document order
+  // of mObservationTargets, and gather each target's geometry into plain
+  // rects.  The second pass computes intersection ratios and thresholds
+  // from this immutable data only.
+  AutoTArray<IntersectionGeometry, 32> geometries;
+
   for (size_t i = 0; i < mObservationTargets.Length(); ++i) {
     Element* target = mObservationTargets.ElementAt(i);
     nsIFrame* targetFrame = target->GetPrimaryFrame();
@@ -404,7 +438,12 @@ DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time
     }
 
     if (root && target) {
-      isInSimilarOriginBrowsingContext = CheckSimilarOrigin(root, target) ?
+      nsIDocument* targetDocument = target->OwnerDoc();
+      if (targetDocument != lastTargetDocument) {
+        lastSimilarOrigin = CheckSimilarOrigin(root, target);
+        lastTargetDocument = targetDocument;
+      }
+      isInSimilarOriginBrowsingContext = lastSimilarOrigin ?
         BrowsingContextInfo::SimilarOriginBrowsingContext :
         BrowsingContextInfo::DifferentOriginBrowsingContext;
     }
@@ -419,7 +458,7 @@ DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time
         nsLayoutUtils::TransformFrameRectToAncestor(
           targetFrame,
           intersectionRect.value(),
-          nsLayoutUtils::GetContainingBlockForClientRect(rootFrame)
+          rootContainingBlock
       );
       intersectionRect = EdgeInclusiveIntersection(
         intersectionRectRelativeToRoot,
@@ -436,6 +475,21 @@ DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time
       }
     }
 
+    IntersectionGeometry* geometry = geometries.AppendElement();
+    geometry->mTarget = target;
+    geometry->mTargetRect = targetRect;
+    geometry->mRootIntersectionRect = rootIntersectionRect;
+    geometry->mIntersectionRect = intersectionRect;
+    geometry->mDifferentOriginBrowsingContext =
+      isInSimilarOriginBrowsingContext ==
+        BrowsingContextInfo::DifferentOriginBrowsingContext;
+  }
+
+  // Second pass: pure arithmetic on the gathered geometry.
+  for (IntersectionGeometry& geometry : geometries) {
+    const nsRect& targetRect = geometry.mTargetRect;
+    const Maybe<nsRect>& intersectionRect = geometry.mIntersectionRect;
+
     int64_t targetArea =
       (int64_t) targetRect.Width() * (int64_t) targetRect.Height();
     int64_t intersectionArea = !intersectionRect ? 0 :
@@ -467,12 +521,11 @@ DOMIntersectionObserver::Update(nsIDocument* aDocument, DOMHighResTimeStamp time
       threshold = 0;
     }
 
-    if (target->UpdateIntersectionObservation(this, threshold)) {
+    if (geometry.mTarget->UpdateIntersectionObservation(this, threshold)) {
       QueueIntersectionObserverEntry(
-        target, time,
-        isInSimilarOriginBrowsingContext ==
-          BrowsingContextInfo::DifferentOriginBrowsingContext ?
-          Nothing() : Some(rootIntersectionRect),
+        geometry.mTarget, time,
+        geometry.mDifferentOriginBrowsingContext ?
+          Nothing() : Some(geometry.mRootIntersectionRect),
         targetRect, intersectionRect, intersectionRatio
       );
     }
@@ -6,14 +6,26 @@
 
 #include "TimeoutBudgetManager.h"
 
+#include "mozilla/Logging.h"
 #include "mozilla/dom/Timeout.h"
 
 namespace mozilla {
 namespace dom {
 
+static LazyLogModule gBudgetLog("TimeoutBudget");
+
 // Time between sampling timeout execution time.
 const uint32_t kTelemetryPeriodMS = 1000;
 
+// The amount of accumulated background execution past which an origin is
+// considered a chronic offender.  The per-origin penalty grows linearly
+// with the accumulated time, starting from this threshold.
+const double kChronicBackgroundExecutionMS = 50;
+
+// The largest factor by which an origin's budget regeneration can be
+// slowed down, to avoid starving an origin forever.
+const double kMaxOriginPenalty = 8;
+
 /* static */ TimeoutBudgetManager&
 TimeoutBudgetManager::Get()
 {
@@ -36,6 +48,7 @@ TimeoutBudgetManager::StopRecording()
 TimeDuration
 TimeoutBudgetManager::RecordExecution(const TimeStamp& aNow,
                                       const Timeout* aTimeout,
+                                      const nsACString& aOrigin,
                                       bool aIsBackground)
 {
   if (!mStart) {
@@ -46,6 +59,15 @@ TimeoutBudgetManager::RecordExecution(const TimeStamp& aNow,
 
   TimeDuration duration = aNow - mStart;
 
+  if (!aOrigin.IsEmpty()) {
+    OriginData* data = mOriginData.LookupOrAdd(aOrigin);
+    if (aIsBackground) {
+      data->mBackgroundExecution += duration;
+    } else {
+      data->mForegroundExecution += duration;
+    }
+  }
+
   if (aIsBackground) {
     if (aTimeout->mIsTracking) {
       mTelemetryData.mBackgroundTracking += duration;
@@ -63,6 +85,33 @@ TimeoutBudgetManager::RecordExecution(const TimeStamp& aNow,
   return duration;
 }
 
+void
+TimeoutBudgetManager::RecordWakeup(const nsACString& aOrigin)
+{
+  if (aOrigin.IsEmpty()) {
+    return;
+  }
+
+  mOriginData.LookupOrAdd(aOrigin)->mWakeups++;
+}
+
+double
+TimeoutBudgetManager::GetOriginPenalty(const nsACString& aOrigin)
+{
+  if (aOrigin.IsEmpty()) {
+    return 1.0;
+  }
+
+  OriginData* data = mOriginData.Get(aOrigin);
+  if (!data) {
+    return 1.0;
+  }
+
+  double penalty = 1.0 + data->mBackgroundExecution.ToMilliseconds() /
+                           kChronicBackgroundExecutionMS;
+  return std::min(penalty, kMaxOriginPenalty);
+}
+
 void
 TimeoutBudgetManager::Accumulate(Telemetry::HistogramID aId,
                                  const TimeDuration& aSample)
@@ -89,6 +138,27 @@ TimeoutBudgetManager::MaybeCollectTelemetry(const TimeStamp& aNow)
   Accumulate(Telemetry::TIMEOUT_EXECUTION_BG_MS,
              mTelemetryData.mBackgroundNonTracking);
 
+  for (auto iter = mOriginData.Iter(); !iter.Done(); iter.Next()) {
+    OriginData* data = iter.Data();
+
+    MOZ_LOG(gBudgetLog, LogLevel::Debug,
+            ("Origin %s: %u wakeups, fg %.1fms, bg %.1fms, penalty %.2f\n",
+             PromiseFlatCString(iter.Key()).get(),
+             data->mWakeups,
+             data->mForegroundExecution.ToMilliseconds(),
+             data->mBackgroundExecution.ToMilliseconds(),
+             GetOriginPenalty(iter.Key())));
+
+    // Reset the per-period counters and decay the chronic-offender signal
+    // so that origins that stop misbehaving recover.
+    data->mWakeups = 0;
+    data->mForegroundExecution = TimeDuration();
+    data->mBackgroundExecution = data->mBackgroundExecution.MultDouble(0.5);
+    if (data->mBackgroundExecution.ToMilliseconds() < 1.0) {
+      iter.Remove();
+    }
+  }
+
   mTelemetryData = TelemetryData();
   mLastCollection = aNow;
 }
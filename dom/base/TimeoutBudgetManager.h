@@ -9,6 +9,8 @@
 
 #include "mozilla/Telemetry.h"
 #include "mozilla/TimeStamp.h"
+#include "nsClassHashtable.h"
+#include "nsString.h"
 
 namespace mozilla {
 namespace dom {
@@ -23,7 +25,18 @@ public:
   void StopRecording();
   TimeDuration RecordExecution(const TimeStamp& aNow,
                                const Timeout* aTimeout,
+                               const nsACString& aOrigin,
                                bool aIsBackground);
+  // Called once per timer wakeup that ran timeouts for aOrigin, so that
+  // wakeup storms can be attributed to the origins causing them.  The
+  // counters are reported through the "TimeoutBudget" log module and reset
+  // on every telemetry collection.
+  void RecordWakeup(const nsACString& aOrigin);
+  // Returns a factor >= 1 by which aOrigin's budget regeneration rate
+  // should be divided.  Origins that chronically burn background execution
+  // time regenerate their budgets more slowly than the plain backgrounded
+  // clamping would allow, and so get throttled harder.
+  double GetOriginPenalty(const nsACString& aOrigin);
   void MaybeCollectTelemetry(const TimeStamp& aNow);
 private:
   TimeoutBudgetManager() : mLastCollection(TimeStamp::Now()) {}
@@ -35,9 +48,18 @@ private:
     TimeDuration mBackgroundNonTracking;
   };
 
+  struct OriginData
+  {
+    OriginData() : mWakeups(0) {}
+    TimeDuration mForegroundExecution;
+    TimeDuration mBackgroundExecution;
+    uint32_t mWakeups;
+  };
+
   void Accumulate(Telemetry::HistogramID aId, const TimeDuration& aSample);
 
   TelemetryData mTelemetryData;
+  nsClassHashtable<nsCStringHashKey, OriginData> mOriginData;
   TimeStamp mStart;
   TimeStamp mLastCollection;
 };
@@ -12,6 +12,7 @@
 #include "mozilla/TimeStamp.h"
 #include "nsIDocShell.h"
 #include "nsINamed.h"
+#include "nsIPrincipal.h"
 #include "nsITimeoutHandler.h"
 #include "mozilla/dom/TabGroup.h"
 #include "OrderedTimeoutIterator.h"
@@ -312,7 +313,7 @@ TimeoutManager::RecordExecution(Timeout* aRunningTimeout,
     // If we're running a timeout callback, record any execution until
     // now.
     TimeDuration duration = budgetManager.RecordExecution(
-      now, aRunningTimeout, mWindow.IsBackgroundInternal());
+      now, aRunningTimeout, Origin(), mWindow.IsBackgroundInternal());
     budgetManager.MaybeCollectTelemetry(now);
 
     UpdateBudget(now, duration);
@@ -344,6 +345,12 @@ TimeoutManager::UpdateBudget(const TimeStamp& aNow, const TimeDuration& aDuratio
   bool isBackground = mWindow.IsBackgroundInternal();
   if (BudgetThrottlingEnabled(isBackground)) {
     double factor = GetRegenerationFactor(isBackground);
+    if (isBackground) {
+      // Origins that chronically burn background execution time regenerate
+      // their budget more slowly, which throttles them harder than the
+      // plain backgrounded clamping does.
+      factor /= TimeoutBudgetManager::Get().GetOriginPenalty(Origin());
+    }
     TimeDuration regenerated = (aNow - mLastBudgetUpdate).MultDouble(factor);
     // Clamp the budget to the range of minimum and maximum allowed budget.
     mExecutionBudget = TimeDuration::Max(
@@ -700,6 +707,12 @@ TimeoutManager::RunTimeout(const TimeStamp& aNow, const TimeStamp& aTargetDeadli
     return;
   }
 
+  if (!mWindow.IsChromeWindow()) {
+    // Attribute this wakeup to the window's origin so that wakeup storms
+    // show up in the TimeoutBudget log.
+    TimeoutBudgetManager::Get().RecordWakeup(Origin());
+  }
+
   // Limit the overall time spent in RunTimeout() to reduce jank.
   uint32_t totalTimeLimitMS = std::max(1u, gMaxConsecutiveCallbacksMilliseconds);
   const TimeDuration totalTimeLimit =
@@ -1029,9 +1042,44 @@ TimeoutManager::ClearAllTimeouts()
   mTrackingTimeouts.Clear();
 }
 
+// static
+uint32_t
+TimeoutManager::Timeouts::InsertionHintIndex(const TimeDuration& aInterval)
+{
+  // Buckets cover delays of up to 8ms, 64ms, 512ms, ~4s, ~33s and beyond.
+  double ms = aInterval.ToMilliseconds();
+  uint32_t index = 0;
+  for (double limit = 8.0;
+       index < kInsertionHintCount - 1 && ms > limit;
+       limit *= 8.0) {
+    ++index;
+  }
+  return index;
+}
+
 void
 TimeoutManager::Timeouts::Insert(Timeout* aTimeout, SortBy aSortBy)
 {
+  uint32_t hintIndex = InsertionHintIndex(aTimeout->mInterval);
+
+  // Try to resume the search from the last timeout inserted with a similar
+  // delay.  This is only safe when sorting by When() -- frozen windows sort
+  // by time remaining -- and when no timeouts are currently firing, since
+  // new timeouts must not be inserted before a Timeout with a valid
+  // FiringId.
+  Timeout* hint = mInsertionHints[hintIndex];
+  if (aSortBy == SortBy::TimeWhen && !mManager.IsFiring() &&
+      hint && hint->isInList() && hint->When() <= aTimeout->When()) {
+    Timeout* prevSibling = hint;
+    while (prevSibling->getNext() &&
+           prevSibling->getNext()->When() <= aTimeout->When()) {
+      prevSibling = prevSibling->getNext();
+    }
+    prevSibling->setNext(aTimeout);
+    aTimeout->mFiringId = InvalidFiringId;
+    mInsertionHints[hintIndex] = aTimeout;
+    return;
+  }
 
   // Start at mLastTimeout and go backwards.  Stop if we see a Timeout with a
   // valid FiringId since those timers are currently being processed by
@@ -1059,6 +1107,19 @@ TimeoutManager::Timeouts::Insert(Timeout* aTimeout, SortBy aSortBy)
   }
 
   aTimeout->mFiringId = InvalidFiringId;
+  mInsertionHints[hintIndex] = aTimeout;
+}
+
+const nsACString&
+TimeoutManager::Origin()
+{
+  if (mOrigin.IsEmpty()) {
+    nsIPrincipal* principal = mWindow.GetPrincipal();
+    if (principal) {
+      principal->GetOrigin(mOrigin);
+    }
+  }
+  return mOrigin;
 }
 
 Timeout*
@@ -136,6 +136,17 @@ private:
   bool
   IsInvalidFiringId(uint32_t aFiringId) const;
 
+  bool
+  IsFiring() const
+  {
+    return !mFiringIdStack.IsEmpty();
+  }
+
+  // The origin of the window this manager belongs to, used to attribute
+  // execution time and wakeups to origins in TimeoutBudgetManager.
+  // Computed lazily; empty for windows without a principal.
+  const nsACString& Origin();
+
   TimeDuration
   MinSchedulingDelay() const;
 
@@ -173,7 +184,13 @@ private:
     Timeout* GetLast() { return mTimeoutList.getLast(); }
     bool IsEmpty() const { return mTimeoutList.isEmpty(); }
     void InsertFront(Timeout* aTimeout) { mTimeoutList.insertFront(aTimeout); }
-    void Clear() { mTimeoutList.clear(); }
+    void Clear()
+    {
+      mTimeoutList.clear();
+      for (uint32_t i = 0; i < kInsertionHintCount; ++i) {
+        mInsertionHints[i] = nullptr;
+      }
+    }
 
     template <class Callable>
     void ForEach(Callable c)
@@ -211,6 +228,18 @@ private:
     // mTimeoutList is generally sorted by mWhen, but new values are always
     // inserted after any Timeouts with a valid FiringId.
     TimeoutList               mTimeoutList;
+
+    // Insertion into mTimeoutList is a backwards walk from the tail, which
+    // degrades badly when thousands of timeouts with mixed delays are
+    // pending.  Pages reuse a small set of distinct delays, though, and a
+    // new timeout nearly always sorts right after the previously inserted
+    // timeout of a similar delay, so remember the most recent insertion per
+    // delay-magnitude bucket and resume the search from there.  This is a
+    // flattened timer wheel: each bucket covers an eightfold longer delay
+    // range than the one before it.
+    static const uint32_t kInsertionHintCount = 6;
+    static uint32_t InsertionHintIndex(const TimeDuration& aInterval);
+    RefPtr<Timeout>           mInsertionHints[kInsertionHintCount];
   };
 
   friend class OrderedTimeoutIterator;
@@ -237,6 +266,7 @@ private:
   nsCOMPtr<nsITimer>          mThrottleTimeoutsTimer;
   mozilla::TimeStamp          mLastBudgetUpdate;
   mozilla::TimeDuration       mExecutionBudget;
+  nsCString                   mOrigin;
 
   bool                        mThrottleTimeouts;
   bool                        mThrottleTrackingTimeouts;
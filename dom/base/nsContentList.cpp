@@ -727,10 +727,22 @@ nsContentList::AttributeChanged(nsIDocument *aDocument, Element* aElement,
 
   if (Match(aElement)) {
     if (mElements.IndexOf(aElement) == mElements.NoIndex) {
-      // We match aElement now, and it's not in our list already.  Just dirty
-      // ourselves; this is simpler than trying to figure out where to insert
-      // aElement.
-      SetDirty();
+      // We match aElement now, and it's not in our list already.  It's a
+      // single element at a known position, so splice it in rather than
+      // dirtying ourselves wholesale.
+      uint32_t count = mElements.Length();
+      if (mState == LIST_LAZY) {
+        if (count == 0) {
+          // No frontier to compare against; play it safe.
+          SetDirty();
+          return;
+        }
+        if (nsContentUtils::PositionIsBefore(mElements[count - 1], aElement)) {
+          // We haven't walked this far yet; PopulateSelf will find it.
+          return;
+        }
+      }
+      mElements.InsertElementAt(FindInsertionIndex(aElement), aElement);
     }
   } else {
     // We no longer match aElement.  Remove it from our list.  If it's
@@ -855,7 +867,9 @@ nsContentList::ContentInserted(nsIDocument *aDocument,
       MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) &&
       nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
       MatchSelf(aChild)) {
-    SetDirty();
+    if (!TryInsertInPlace(aChild)) {
+      SetDirty();
+    }
   }
 
   ASSERT_IN_SYNC;
@@ -874,12 +888,94 @@ nsContentList::ContentRemoved(nsIDocument *aDocument,
       MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) &&
       nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
       MatchSelf(aChild)) {
-    SetDirty();
+    // Something in the removed subtree matched, but that doesn't mean we
+    // have to rebuild the whole list; just drop the cached elements that
+    // lived in it.
+    RemoveElementsInSubtree(aChild);
   }
 
   ASSERT_IN_SYNC;
 }
 
+bool
+nsContentList::TryInsertInPlace(nsIContent* aChild)
+{
+  uint32_t count = mElements.Length();
+
+  if (mState == LIST_LAZY) {
+    if (count == 0) {
+      // We have no frontier to compare against, so we can't tell whether
+      // we've already walked past the insertion point.
+      return false;
+    }
+    if (nsContentUtils::PositionIsBefore(mElements[count - 1], aChild)) {
+      // Everything after our last cached element is territory we haven't
+      // examined yet; a later PopulateSelf will pick the new content up.
+      return true;
+    }
+  }
+
+  // Collect the matching elements of the inserted subtree in tree order.
+  AutoTArray<nsIContent*, 8> matched;
+  if (aChild->IsElement() && Match(aChild->AsElement())) {
+    matched.AppendElement(aChild);
+  }
+  if (mDeep) {
+    for (nsIContent* cur = aChild->GetFirstChild();
+         cur;
+         cur = cur->GetNextNode(aChild)) {
+      if (cur->IsElement() && Match(cur->AsElement())) {
+        matched.AppendElement(cur);
+      }
+    }
+  }
+  NS_ASSERTION(!matched.IsEmpty(),
+               "MatchSelf said something in the subtree matches");
+
+  // The whole subtree belongs right before the first cached element that
+  // comes after aChild.
+  mElements.InsertElementsAt(FindInsertionIndex(aChild),
+                             matched.Elements(), matched.Length());
+  return true;
+}
+
+uint32_t
+nsContentList::FindInsertionIndex(nsIContent* aChild)
+{
+  uint32_t lo = 0, hi = mElements.Length();
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    if (nsContentUtils::PositionIsBefore(mElements[mid], aChild)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+void
+nsContentList::RemoveElementsInSubtree(nsIContent* aChild)
+{
+  uint32_t count = mElements.Length();
+  uint32_t first = 0;
+  while (first < count &&
+         !nsContentUtils::ContentIsDescendantOf(mElements[first], aChild)) {
+    ++first;
+  }
+  if (first == count) {
+    // None of the removed elements had made it into the list; if we're
+    // lazy we may simply never have walked that far.
+    return;
+  }
+  uint32_t end = first + 1;
+  while (end < count &&
+         nsContentUtils::ContentIsDescendantOf(mElements[end], aChild)) {
+    ++end;
+  }
+  mElements.RemoveElementsAt(first, end - first);
+}
+
 bool
 nsContentList::Match(Element *aElement)
 {
@@ -426,6 +426,34 @@ protected:
    */
   bool MatchSelf(nsIContent *aContent);
 
+  /**
+   * Try to splice the matching elements of the subtree rooted at aChild
+   * into mElements instead of throwing the whole list away.  Only called
+   * when MatchSelf(aChild) is true.  An inserted subtree is a contiguous
+   * range in tree order, so its matches belong at a single position in
+   * our list, which we find by binary search.
+   *
+   * @param  aChild the root of the subtree that was just inserted
+   * @return false if the caller needs to SetDirty() after all
+   */
+  bool TryInsertInPlace(nsIContent* aChild);
+
+  /**
+   * Find the index in mElements where aChild belongs in tree order, i.e.
+   * the index of the first cached element that aChild precedes.  Assumes
+   * aChild itself is not in the list.
+   */
+  uint32_t FindInsertionIndex(nsIContent* aChild);
+
+  /**
+   * Drop the cached elements that live in the subtree rooted at aChild,
+   * which has just been removed from the tree.  They form a contiguous
+   * run in mElements, for the same reason as in TryInsertInPlace.
+   *
+   * @param  aChild the root of the subtree that was removed
+   */
+  void RemoveElementsInSubtree(nsIContent* aChild);
+
   /**
    * Populate our list.  Stop once we have at least aNeededLength
    * elements.  At the end of PopulateSelf running, either the last
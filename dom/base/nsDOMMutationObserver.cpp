@@ -40,6 +40,69 @@ uint64_t nsDOMMutationObserver::sCount = 0;
 AutoTArray<AutoTArray<RefPtr<nsDOMMutationObserver>, 4>, 4>*
 nsDOMMutationObserver::sCurrentlyHandlingObservers = nullptr;
 
+// A DOM write burst generates one nsDOMMutationRecord per mutation per
+// observer, and nearly all of them are released together once the observer
+// callbacks have run.  Allocate them from chunked slabs with a free list so
+// a burst costs one malloc per slab instead of one per record, and so the
+// memory is reused across bursts.  JS can keep individual records alive
+// arbitrarily long, so the slabs are only returned to the heap once every
+// record in flight has been released.
+static const size_t kRecordSlabSize = 4096;
+static const size_t kRecordSlotSize =
+  (sizeof(nsDOMMutationRecord) + (sizeof(void*) - 1)) & ~(sizeof(void*) - 1);
+
+// Slabs are linked through their first word, free slots through theirs.
+static void* sRecordSlabs = nullptr;
+static char* sRecordSlabPos = nullptr;
+static char* sRecordSlabEnd = nullptr;
+static void* sFreeRecordSlots = nullptr;
+static uint32_t sOutstandingRecords = 0;
+
+void*
+nsDOMMutationRecord::operator new(size_t aSize) CPP_THROW_NEW
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(aSize <= kRecordSlotSize, "Slot size out of sync?");
+
+  ++sOutstandingRecords;
+  if (sFreeRecordSlots) {
+    void* slot = sFreeRecordSlots;
+    sFreeRecordSlots = *static_cast<void**>(slot);
+    return slot;
+  }
+  if (sRecordSlabPos + kRecordSlotSize > sRecordSlabEnd) {
+    char* slab = static_cast<char*>(moz_xmalloc(kRecordSlabSize));
+    *reinterpret_cast<void**>(slab) = sRecordSlabs;
+    sRecordSlabs = slab;
+    sRecordSlabPos = slab + sizeof(void*);
+    sRecordSlabEnd = slab + kRecordSlabSize;
+  }
+  void* slot = sRecordSlabPos;
+  sRecordSlabPos += kRecordSlotSize;
+  return slot;
+}
+
+void
+nsDOMMutationRecord::operator delete(void* aPtr, size_t aSize)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(sOutstandingRecords, "Freeing a record we didn't allocate?");
+
+  if (--sOutstandingRecords == 0) {
+    // The burst is over; give the memory back.
+    while (sRecordSlabs) {
+      void* next = *static_cast<void**>(sRecordSlabs);
+      free(sRecordSlabs);
+      sRecordSlabs = next;
+    }
+    sRecordSlabPos = sRecordSlabEnd = nullptr;
+    sFreeRecordSlots = nullptr;
+    return;
+  }
+  *static_cast<void**>(aPtr) = sFreeRecordSlots;
+  sFreeRecordSlots = aPtr;
+}
+
 nsINodeList*
 nsDOMMutationRecord::AddedNodes()
 {
@@ -57,6 +57,13 @@ public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
   NS_DECL_CYCLE_COLLECTION_SCRIPT_HOLDER_CLASS(nsDOMMutationRecord)
 
+  // Records are allocated in bursts, one per observed mutation, and nearly
+  // all of them are released together once the observer callbacks have run.
+  // Serve them from chunked slabs instead of the heap; see the allocator in
+  // nsDOMMutationObserver.cpp.
+  void* operator new(size_t aSize) CPP_THROW_NEW;
+  void operator delete(void* aPtr, size_t aSize);
+
   void GetType(mozilla::dom::DOMString& aRetVal) const
   {
     aRetVal.SetOwnedAtom(mType, mozilla::dom::DOMString::eNullNotExpected);
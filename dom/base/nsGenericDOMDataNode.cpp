@@ -338,36 +338,42 @@ nsGenericDOMDataNode::SetTextInternal(uint32_t aOffset, uint32_t aCount,
     // Merging old and new
 
     bool bidi = mText.IsBidi();
-
-    // Allocate new buffer
-    int32_t newLength = textLength - aCount + aLength;
-    // Use nsString and not nsAutoString so that we get a nsStringBuffer which
-    // can be just AddRefed in nsTextFragment.
-    nsString to;
-    to.SetCapacity(newLength);
-
-    // Copy over appropriate data
-    if (aOffset) {
-      mText.AppendTo(to, 0, aOffset);
+    if (aLength && !bidi && (!document || !document->GetBidiEnabled())) {
+      bidi = HasRTLChars(aBuffer, aLength);
     }
-    if (aLength) {
-      to.Append(aBuffer, aLength);
-      if (!bidi && (!document || !document->GetBidiEnabled())) {
-        bidi = HasRTLChars(aBuffer, aLength);
+
+    // If this is marked as "maybe modified frequently", its buffer is grown
+    // exponentially, so first try splicing the new data into the existing
+    // buffer in place. This keeps typing into a large editable text node
+    // from reallocating and copying the whole text on every keystroke.
+    if (!HasFlag(NS_MAYBE_MODIFIED_FREQUENTLY) ||
+        !mText.SpliceInPlace(aOffset, aCount, aBuffer, aLength)) {
+      // Allocate new buffer
+      int32_t newLength = textLength - aCount + aLength;
+      // Use nsString and not nsAutoString so that we get a nsStringBuffer
+      // which can be just AddRefed in nsTextFragment.
+      nsString to;
+      to.SetCapacity(newLength);
+
+      // Copy over appropriate data
+      if (aOffset) {
+        mText.AppendTo(to, 0, aOffset);
+      }
+      if (aLength) {
+        to.Append(aBuffer, aLength);
+      }
+      if (endOffset != textLength) {
+        mText.AppendTo(to, endOffset, textLength - endOffset);
       }
-    }
-    if (endOffset != textLength) {
-      mText.AppendTo(to, endOffset, textLength - endOffset);
-    }
 
-    // If this is marked as "maybe modified frequently", the text should be
-    // stored as char16_t since converting char* to char16_t* is expensive.
-    // Use char16_t also when we have bidi characters.
-    bool use2b = HasFlag(NS_MAYBE_MODIFIED_FREQUENTLY) || bidi;
-    bool ok = mText.SetTo(to, false, use2b);
+      // If this is marked as "maybe modified frequently", the text should be
+      // stored as char16_t since converting char* to char16_t* is expensive.
+      // Use char16_t also when we have bidi characters.
+      bool use2b = HasFlag(NS_MAYBE_MODIFIED_FREQUENTLY) || bidi;
+      bool ok = mText.SetTo(to, false, use2b);
+      NS_ENSURE_TRUE(ok, NS_ERROR_OUT_OF_MEMORY);
+    }
     mText.SetBidi(bidi);
-
-    NS_ENSURE_TRUE(ok, NS_ERROR_OUT_OF_MEMORY);
   }
 
   UnsetFlags(NS_CACHED_TEXT_IS_ONLY_WHITESPACE);
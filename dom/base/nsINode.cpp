@@ -15,6 +15,7 @@
 #include "mozAutoDocUpdate.h"
 #include "mozilla/AsyncEventDispatcher.h"
 #include "mozilla/CORSMode.h"
+#include "mozilla/ClearOnShutdown.h"
 #include "mozilla/EventDispatcher.h"
 #include "mozilla/EventListenerManager.h"
 #include "mozilla/HTMLEditor.h"
@@ -22,6 +23,7 @@
 #include "mozilla/Likely.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ServoBindings.h"
+#include "mozilla/StaticPtr.h"
 #include "mozilla/Telemetry.h"
 #include "mozilla/TextEditor.h"
 #include "mozilla/TimeStamp.h"
@@ -32,6 +34,7 @@
 #include "nsAttrValueOrString.h"
 #include "nsBindingManager.h"
 #include "nsCCUncollectableMarker.h"
+#include "nsClassHashtable.h"
 #include "nsContentCreatorFunctions.h"
 #include "nsContentList.h"
 #include "nsContentUtils.h"
@@ -2718,6 +2721,22 @@ nsINode::ParseServoSelectorList(
   return selectorList;
 }
 
+// A process-wide cache of parsed selector lists backing the per-document
+// SelectorCache.  The per-document cache expires entries after a few
+// generations and dies with its document, so the handful of selectors a
+// framework sends through querySelector get re-parsed for every document
+// (and for every short-lived iframe).  Selector parsing doesn't depend on
+// the document -- quirks mode affects matching, not parsing, and the
+// document URI passed to the parser is only used for error reporting -- so
+// parsed lists can be shared across documents by cloning.
+typedef nsClassHashtable<nsStringHashKey, nsCSSSelectorList>
+  SharedSelectorCache;
+static StaticAutoPtr<SharedSelectorCache> sSharedSelectorCache;
+
+// Past this many entries the shared table is dropped wholesale; selector
+// strings that diverse are likely data-driven and not worth remembering.
+static const uint32_t kSharedSelectorCacheLimit = 1024;
+
 nsCSSSelectorList*
 nsINode::ParseSelectorList(const nsAString& aSelectorString,
                            ErrorResult& aRv)
@@ -2743,6 +2762,19 @@ nsINode::ParseSelectorList(const nsAString& aSelectorString,
     }
   }
 
+  if (!sSharedSelectorCache) {
+    sSharedSelectorCache = new SharedSelectorCache();
+    ClearOnShutdown(&sSharedSelectorCache);
+  }
+
+  if (nsCSSSelectorList* shared = sSharedSelectorCache->Get(aSelectorString)) {
+    // Another document already parsed this selector; hand this document a
+    // clone so that the per-document cache still owns its entry.
+    nsCSSSelectorList* selectorList = shared->Clone();
+    cache.CacheList(aSelectorString, UniquePtr<nsCSSSelectorList>(selectorList));
+    return selectorList;
+  }
+
   nsCSSParser parser(doc->CSSLoader());
 
   nsCSSSelectorList* selectorList = nullptr;
@@ -2783,6 +2815,10 @@ nsINode::ParseSelectorList(const nsAString& aSelectorString,
   if (selectorList) {
     NS_ASSERTION(selectorList->mSelectors,
                  "How can we not have any selectors?");
+    if (sSharedSelectorCache->Count() >= kSharedSelectorCacheLimit) {
+      sSharedSelectorCache->Clear();
+    }
+    sSharedSelectorCache->Put(aSelectorString, selectorList->Clone());
     cache.CacheList(aSelectorString, UniquePtr<nsCSSSelectorList>(selectorList));
   } else {
     // This is the "only pseudo-element selectors" case, which is
@@ -2855,6 +2891,40 @@ FindMatchingElementsWithId(const nsAString& aId, nsINode* aRoot,
   }
 }
 
+// Returns the lone selector of aSelectorList when the list consists of a
+// single compound selector with no combinators, pseudo-classes, attribute
+// selectors, negations or namespace -- the "#id", ".class" and "tag" shapes
+// that dominate querySelector traffic -- and null otherwise.
+static nsCSSSelector*
+GetTrivialSelector(nsCSSSelectorList* aSelectorList)
+{
+  if (aSelectorList->mNext) {
+    return nullptr;
+  }
+  nsCSSSelector* selector = aSelectorList->mSelectors;
+  if (selector->mNext ||
+      selector->mNegations ||
+      selector->mPseudoClassList ||
+      selector->mAttrList ||
+      selector->mNameSpace != kNameSpaceID_Unknown) {
+    return nullptr;
+  }
+  return selector;
+}
+
+template<class Collector, class T>
+inline static void
+AppendCollectedElements(Collector& aResults, T& aList)
+{
+  const uint32_t len = aResults.Length();
+  if (len) {
+    aList.SetCapacity(len);
+    for (uint32_t i = 0; i < len; ++i) {
+      aList.AppendElement(aResults.ElementAt(i));
+    }
+  }
+}
+
 // Actually find elements matching aSelectorList (which must not be
 // null) and which are descendants of aRoot and put them in aList.  If
 // onlyFirstMatch, then stop once the first one is found.
@@ -2865,6 +2935,77 @@ FindMatchingElements(nsINode* aRoot, nsCSSSelectorList* aSelectorList, T &aList,
 {
   nsIDocument* doc = aRoot->OwnerDoc();
 
+  // Dispatch the trivial selector shapes to direct tree walks before
+  // setting up the full rule-processor machinery.  ID and class matching
+  // is case-insensitive in quirks mode, so those shapes stay on the
+  // general path there.
+  if (nsCSSSelector* selector = GetTrivialSelector(aSelectorList)) {
+    const bool caseSensitive =
+      doc->GetCompatibilityMode() != eCompatibility_NavQuirks;
+
+    if (!selector->mLowercaseTag && !selector->mClassList &&
+        selector->mIDList && !selector->mIDList->mNext &&
+        caseSensitive && aRoot->IsInUncomposedDoc()) {
+      // "#id": the document's id table has the candidates, and with no
+      // other components there's nothing further to match against.
+      FindMatchingElementsWithId<onlyFirstMatch, T>(
+        nsDependentAtomString(selector->mIDList->mAtom), aRoot, nullptr,
+        aList);
+      return;
+    }
+
+    if (!selector->mLowercaseTag && !selector->mIDList &&
+        selector->mClassList && !selector->mClassList->mNext &&
+        caseSensitive) {
+      // ".class"
+      nsAtom* classAtom = selector->mClassList->mAtom;
+      Collector results;
+      for (nsIContent* cur = aRoot->GetFirstChild();
+           cur;
+           cur = cur->GetNextNode(aRoot)) {
+        if (!cur->IsElement()) {
+          continue;
+        }
+        const nsAttrValue* classes = cur->AsElement()->GetClasses();
+        if (classes && classes->Contains(classAtom, eCaseMatters)) {
+          if (onlyFirstMatch) {
+            aList.AppendElement(cur->AsElement());
+            return;
+          }
+          results.AppendElement(cur->AsElement());
+        }
+      }
+      AppendCollectedElements(results, aList);
+      return;
+    }
+
+    if (selector->mCasedTag && !selector->mIDList && !selector->mClassList) {
+      // "tag": match the way nsCSSRuleProcessor does -- the lowercased tag
+      // for HTML elements in HTML documents, the cased tag otherwise.
+      const bool isHTMLDoc = doc->IsHTMLDocument();
+      Collector results;
+      for (nsIContent* cur = aRoot->GetFirstChild();
+           cur;
+           cur = cur->GetNextNode(aRoot)) {
+        if (!cur->IsElement()) {
+          continue;
+        }
+        Element* element = cur->AsElement();
+        nsAtom* tag = (isHTMLDoc && element->IsHTMLElement())
+                        ? selector->mLowercaseTag : selector->mCasedTag;
+        if (element->NodeInfo()->NameAtom() == tag) {
+          if (onlyFirstMatch) {
+            aList.AppendElement(element);
+            return;
+          }
+          results.AppendElement(element);
+        }
+      }
+      AppendCollectedElements(results, aList);
+      return;
+    }
+  }
+
   TreeMatchContext matchingContext(false, nsRuleWalker::eRelevantLinkUnvisited,
                                    doc, TreeMatchContext::eNeverMatchVisited);
   AddScopeElements(matchingContext, aRoot);
@@ -2906,13 +3047,7 @@ FindMatchingElements(nsINode* aRoot, nsCSSSelectorList* aSelectorList, T &aList,
     }
   }
 
-  const uint32_t len = results.Length();
-  if (len) {
-    aList.SetCapacity(len);
-    for (uint32_t i = 0; i < len; ++i) {
-      aList.AppendElement(results.ElementAt(i));
-    }
-  }
+  AppendCollectedElements(results, aList);
 }
 
 struct ElementHolder {
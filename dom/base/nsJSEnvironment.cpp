@@ -55,6 +55,7 @@
 #include "nsGlobalWindow.h"
 #include "nsScriptNameSpaceManager.h"
 #include "mozilla/AutoRestore.h"
+#include "mozilla/IntegerPrintfMacros.h"
 #include "mozilla/MainThreadIdlePeriod.h"
 #include "mozilla/StaticPtr.h"
 #include "mozilla/dom/DOMException.h"
@@ -86,6 +87,7 @@
 #include "mozilla/CycleCollectedJSContext.h"
 #include "nsCycleCollectionNoteRootCallback.h"
 #include "GeckoProfiler.h"
+#include "ProfilerCounters.h"
 #include "mozilla/IdleTaskRunner.h"
 #include "nsIDocShell.h"
 #include "nsIPresShell.h"
@@ -222,6 +224,108 @@ static bool sIsCompactingOnUserInactive = false;
 
 static TimeDuration sGCUnnotifiedTotalTime;
 
+static bool
+ShouldTriggerCC(uint32_t aSuspected);
+
+// A single object owning the scheduling decisions for how an idle window is
+// split between GC slices, cycle collection slices and forgetSkippable.
+// Previously the inter-slice GC runner and the CC runners each consumed
+// whatever deadline their own IdleTaskRunner handed them, so a GC slice could
+// swallow an entire idle window moments before the CC gave up waiting and
+// collected synchronously. The idle-driven collector callbacks in this file
+// now register their idle window here, ask the scheduler for their budgets,
+// and give leftover idle time to the other collector. Every decision is
+// recorded as a profiler marker so the interleaving shows up in profiles.
+class CCGCScheduler
+{
+public:
+  // Scopes ownership of the idle window an IdleTaskRunner callback was
+  // handed. A null deadline means the callback fired without idle time.
+  class MOZ_RAII AutoIdleWindow
+  {
+  public:
+    AutoIdleWindow(CCGCScheduler& aScheduler, TimeStamp aDeadline)
+      : mScheduler(aScheduler)
+    {
+      mScheduler.mIdleDeadline = aDeadline;
+    }
+
+    ~AutoIdleWindow()
+    {
+      mScheduler.mIdleDeadline = TimeStamp();
+    }
+
+  private:
+    CCGCScheduler& mScheduler;
+  };
+
+  TimeStamp IdleDeadline() const { return mIdleDeadline; }
+
+  // Milliseconds left in the current idle window, or 0 when there is none.
+  int64_t RemainingIdleMs() const
+  {
+    if (mIdleDeadline.IsNull()) {
+      return 0;
+    }
+    int64_t remaining =
+      int64_t((mIdleDeadline - TimeStamp::Now()).ToMilliseconds());
+    return std::max(remaining, int64_t(0));
+  }
+
+  // Budget in milliseconds for a GC slice fired from the inter-slice GC
+  // runner.
+  int64_t ComputeInterSliceGCBudget() const
+  {
+    // We use longer budgets when the CC has been locked out but the CC has
+    // tried to run since that means we may have significant amount garbage
+    // to collect and better to GC in several longer slices than in a very
+    // long one.
+    int64_t budget = mIdleDeadline.IsNull() ?
+      int64_t(sActiveIntersliceGCBudget * 2) : RemainingIdleMs();
+    if (sCCLockedOut && sCCLockedOutTime) {
+      int64_t lockedTime = PR_Now() - sCCLockedOutTime;
+      int32_t maxSliceGCBudget = sActiveIntersliceGCBudget * 10;
+      double percentOfLockedTime =
+        std::min((double)lockedTime / NS_MAX_CC_LOCKEDOUT_TIME, 1.0);
+      budget =
+        static_cast<int64_t>(
+          std::max((double)budget, percentOfLockedTime * maxSliceGCBudget));
+    } else if (!mIdleDeadline.IsNull() &&
+               ShouldTriggerCC(nsCycleCollector_suspectedCount())) {
+      // A cycle collection is due, so leave half of the idle window for
+      // purple buffer cleanup instead of letting the GC slice consume all
+      // of it.
+      budget = std::max(budget / 2, kForgetSkippableSliceDuration);
+    }
+    return budget;
+  }
+
+  // True if enough of the idle window remains after a slice of collector
+  // work to squeeze in something else.
+  bool HasRemainingIdleTime(int64_t aMinMs) const
+  {
+    return RemainingIdleMs() >= aMinMs;
+  }
+
+  // Record a scheduling decision in the profiler timeline.
+  void NoteDecision(const char* aWork, int64_t aBudgetMs) const
+  {
+#ifdef MOZ_GECKO_PROFILER
+    if (profiler_is_active()) {
+      profiler_add_marker(
+        nsPrintfCString("CCGCScheduler: %s (budget %" PRId64 "ms%s)",
+                        aWork, aBudgetMs,
+                        mIdleDeadline.IsNull() ? ", not idle" : "").get());
+    }
+#endif
+  }
+
+private:
+  TimeStamp mIdleDeadline;
+};
+
+static CCGCScheduler sScheduler;
+
 static const char*
 ProcessNameForCollectorLog()
 {
@@ -1592,6 +1696,8 @@ ICCRunnerFired(TimeStamp aDeadline)
     }
   }
 
+  CCGCScheduler::AutoIdleWindow idle(sScheduler, aDeadline);
+  sScheduler.NoteDecision("ICC slice", sScheduler.RemainingIdleMs());
   nsJSContext::RunCycleCollectorSlice(aDeadline);
   return true;
 }
@@ -1783,21 +1889,9 @@ InterSliceGCRunnerFired(TimeStamp aDeadline, void* aData)
 {
   nsJSContext::KillInterSliceGCRunner();
   MOZ_ASSERT(sActiveIntersliceGCBudget > 0);
-  // We use longer budgets when the CC has been locked out but the CC has tried
-  // to run since that means we may have significant amount garbage to collect
-  // and better to GC in several longer slices than in a very long one.
-  int64_t budget = aDeadline.IsNull() ?
-    int64_t(sActiveIntersliceGCBudget * 2) :
-    int64_t((aDeadline - TimeStamp::Now()).ToMilliseconds());
-  if (sCCLockedOut && sCCLockedOutTime) {
-    int64_t lockedTime = PR_Now() - sCCLockedOutTime;
-    int32_t maxSliceGCBudget = sActiveIntersliceGCBudget * 10;
-    double percentOfLockedTime =
-      std::min((double)lockedTime / NS_MAX_CC_LOCKEDOUT_TIME, 1.0);
-    budget =
-      static_cast<int64_t>(
-        std::max((double)budget, percentOfLockedTime * maxSliceGCBudget));
-  }
+  CCGCScheduler::AutoIdleWindow idle(sScheduler, aDeadline);
+  int64_t budget = sScheduler.ComputeInterSliceGCBudget();
+  sScheduler.NoteDecision("GC slice", budget);
 
   TimeStamp startTimeStamp = TimeStamp::Now();
   TimeDuration duration = sGCUnnotifiedTotalTime;
@@ -1830,6 +1924,22 @@ InterSliceGCRunnerFired(TimeStamp aDeadline, void* aData)
       uint32_t(idleDuration.ToSeconds() / duration.ToSeconds() * 100);
     Telemetry::Accumulate(Telemetry::GC_SLICE_DURING_IDLE, percent);
   }
+
+  // If the GC slice left part of the idle window unused and a cycle
+  // collection is due, spend the remainder cleaning the purple buffer
+  // instead of handing the time back. This keeps the forced CC that follows
+  // an incremental GC from starting cold. Skip it while the CC is locked
+  // out, since forgetSkippable is deferred for the same reason the CC is.
+  if (!sShuttingDown && !sCCLockedOut &&
+      sScheduler.HasRemainingIdleTime(kForgetSkippableSliceDuration)) {
+    uint32_t suspected = nsCycleCollector_suspectedCount();
+    if (ShouldTriggerCC(suspected)) {
+      sScheduler.NoteDecision("ForgetSkippable after GC slice",
+                              sScheduler.RemainingIdleMs());
+      FireForgetSkippable(suspected, false, aDeadline);
+    }
+  }
+
   return true;
 }
 
@@ -1876,6 +1986,8 @@ CCRunnerFired(TimeStamp aDeadline)
     return false;
   }
 
+  CCGCScheduler::AutoIdleWindow idle(sScheduler, aDeadline);
+
   static uint32_t ccDelay = NS_CC_DELAY;
   if (sCCLockedOut) {
     ccDelay = NS_CC_DELAY / 3;
@@ -1909,6 +2021,8 @@ CCRunnerFired(TimeStamp aDeadline)
   uint32_t suspected = nsCycleCollector_suspectedCount();
   if (isLateTimerFire && ShouldTriggerCC(suspected)) {
     if (sCCRunnerFireCount == numEarlyTimerFires + 1) {
+      sScheduler.NoteDecision("ForgetSkippable before CC",
+                              sScheduler.RemainingIdleMs());
       FireForgetSkippable(suspected, true, aDeadline);
       didDoWork = true;
       if (ShouldTriggerCC(nsCycleCollector_suspectedCount())) {
@@ -1930,6 +2044,7 @@ CCRunnerFired(TimeStamp aDeadline)
       // We are in the final timer fire and still meet the conditions for
       // triggering a CC. Let RunCycleCollectorSlice finish the current IGC, if
       // any because that will allow us to include the GC time in the CC pause.
+      sScheduler.NoteDecision("CC slice", sScheduler.RemainingIdleMs());
       nsJSContext::RunCycleCollectorSlice(aDeadline);
       didDoWork = true;
     }
@@ -1937,6 +2052,7 @@ CCRunnerFired(TimeStamp aDeadline)
              (sCleanupsSinceLastGC < NS_MAJOR_FORGET_SKIPPABLE_CALLS)) {
       // Only do a forget skippable if there are more than a few new objects
       // or we're doing the initial forget skippables.
+      sScheduler.NoteDecision("ForgetSkippable", sScheduler.RemainingIdleMs());
       FireForgetSkippable(suspected, false, aDeadline);
       didDoWork = true;
   }
@@ -2366,6 +2482,11 @@ DOMGCSliceCallback(JSContext* aCx, JS::GCProgress aProgress, const JS::GCDescrip
       sGCUnnotifiedTotalTime +=
         aDesc.lastSliceEnd(aCx) - aDesc.lastSliceStart(aCx);
 
+      PROFILER_COUNTER_ADD(ProfilerCounterID::GCSlices, 1);
+      PROFILER_COUNTER_ADD(ProfilerCounterID::GCSliceTotalMs,
+                           int64_t((aDesc.lastSliceEnd(aCx) -
+                                    aDesc.lastSliceStart(aCx)).ToMilliseconds()));
+
       // Schedule another GC slice if the GC has more work to do.
       nsJSContext::KillInterSliceGCRunner();
       if (!sShuttingDown && !aDesc.isComplete_) {
@@ -18,6 +18,7 @@
 #include "nsUnicharUtils.h"
 #include "nsUTF8Utils.h"
 #include "mozilla/CheckedInt.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/SSE.h"
 #include "nsTextFragmentImpl.h"
@@ -329,6 +330,27 @@ nsTextFragment::CopyTo(char16_t *aDest, int32_t aOffset, int32_t aCount)
   }
 }
 
+/**
+ * Computes the buffer size to request when a fragment that is expected to
+ * keep growing needs more room. The policy matches nsTSubstring: the
+ * allocation (including the nsStringBuffer header) is kept a power of two
+ * up to 8 MiB and grows in 1.125x steps rounded up to 1 MiB above that, so
+ * that repeated appends and splices into the same fragment are amortized
+ * O(1).
+ */
+static size_t
+TextFragmentGrowthSize(size_t aSize)
+{
+  static const size_t slowGrowthThreshold = 8 * 1024 * 1024;
+  if (aSize >= slowGrowthThreshold) {
+    const size_t MiB = size_t(1) << 20;
+    size_t size = aSize + (aSize >> 3) + sizeof(nsStringBuffer);
+    return MiB * ((size + MiB - 1) / MiB) - sizeof(nsStringBuffer);
+  }
+  return mozilla::RoundUpPow2(aSize + sizeof(nsStringBuffer)) -
+         sizeof(nsStringBuffer);
+}
+
 bool
 nsTextFragment::Append(const char16_t* aBuffer, uint32_t aLength,
                        bool aUpdateBidi, bool aForce2b)
@@ -358,15 +380,22 @@ nsTextFragment::Append(const char16_t* aBuffer, uint32_t aLength,
     nsStringBuffer* buff = nullptr;
     nsStringBuffer* bufferToRelease = nullptr;
     if (m2b->IsReadonly()) {
-      buff = nsStringBuffer::Alloc(size).take();
+      buff = nsStringBuffer::Alloc(
+        aForce2b ? TextFragmentGrowthSize(size) : size).take();
       if (!buff) {
         return false;
       }
       bufferToRelease = m2b;
       memcpy(static_cast<char16_t*>(buff->Data()), m2b->Data(),
              mState.mLength * sizeof(char16_t));
+    } else if (size <= m2b->StorageSize()) {
+      // The existing buffer already has room; don't touch the allocator.
+      // This is the common case for text nodes that are modified
+      // frequently, since their buffers are grown exponentially.
+      buff = m2b;
     } else {
-      buff = nsStringBuffer::Realloc(m2b, size);
+      buff = nsStringBuffer::Realloc(
+        m2b, aForce2b ? TextFragmentGrowthSize(size) : size);
       if (!buff) {
         return false;
       }
@@ -459,6 +488,43 @@ nsTextFragment::Append(const char16_t* aBuffer, uint32_t aLength,
   return true;
 }
 
+bool
+nsTextFragment::SpliceInPlace(uint32_t aOffset, uint32_t aCount,
+                              const char16_t* aBuffer, uint32_t aLength)
+{
+  MOZ_ASSERT(aOffset + aCount <= mState.mLength, "bad splice bounds");
+  NS_PRECONDITION(aBuffer || !aLength,
+                  "Null buffer passed to SpliceInPlace!");
+
+  if (!mState.mIs2b || m2b->IsReadonly()) {
+    return false;
+  }
+
+  uint32_t newLength = mState.mLength - aCount + aLength;
+  if (NS_MAX_TEXT_FRAGMENT_LENGTH - (mState.mLength - aCount) < aLength) {
+    return false;  // Would be overflown if we'd keep handling.
+  }
+
+  size_t size = (size_t(newLength) + 1) * sizeof(char16_t);
+  if (size > m2b->StorageSize()) {
+    return false;
+  }
+
+  char16_t* data = static_cast<char16_t*>(m2b->Data());
+  uint32_t tailLength = mState.mLength - aOffset - aCount;
+  if (tailLength && aCount != aLength) {
+    memmove(data + aOffset + aLength, data + aOffset + aCount,
+            tailLength * sizeof(char16_t));
+  }
+  if (aLength) {
+    memcpy(data + aOffset, aBuffer, aLength * sizeof(char16_t));
+  }
+  mState.mLength = newLength;
+  data[newLength] = char16_t(0);
+
+  return true;
+}
+
 /* virtual */ size_t
 nsTextFragment::SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
 {
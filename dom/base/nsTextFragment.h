@@ -146,6 +146,18 @@ public:
   bool Append(const char16_t* aBuffer, uint32_t aLength, bool aUpdateBidi,
               bool aForce2b);
 
+  /**
+   * Replace the aCount characters starting at aOffset with the aLength
+   * characters of aBuffer, reusing the existing buffer, if this fragment
+   * holds uniquely owned 2-byte data with enough storage for the result.
+   * Returns false without modifying the fragment when the splice can't be
+   * done in place; the caller is expected to rebuild the text instead.
+   * Doesn't update the Bidi flag; checking aBuffer and calling SetBidi is
+   * the caller's responsibility.
+   */
+  bool SpliceInPlace(uint32_t aOffset, uint32_t aCount,
+                     const char16_t* aBuffer, uint32_t aLength);
+
   /**
    * Append the contents of this string fragment to aString
    */
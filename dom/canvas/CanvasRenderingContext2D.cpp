@@ -95,13 +95,16 @@
 #include "mozilla/ipc/PDocumentRendererParent.h"
 #include "mozilla/layers/PersistentBufferProvider.h"
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/Monitor.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/ServoBindings.h"
+#include "mozilla/StaticPtr.h"
 #include "mozilla/Telemetry.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/UniquePtr.h"
 #include "mozilla/Unused.h"
 #include "nsCCUncollectableMarker.h"
+#include "nsThreadUtils.h"
 #include "nsWrapperCacheInlines.h"
 #include "mozilla/dom/CanvasRenderingContext2DBinding.h"
 #include "mozilla/dom/CanvasPath.h"
@@ -1083,7 +1086,103 @@ DrawTarget* CanvasRenderingContext2D::sErrorTarget = nullptr;
 static bool sMaxContextsInitialized = false;
 static int32_t sMaxContexts = 0;
 
+// Drawing commands recorded by a deferred-rendering canvas are rasterized on
+// this thread. It is shared by all 2D contexts and torn down when the last
+// of them goes away.
+static StaticRefPtr<nsIThread> sCanvasReplayThread;
 
+static nsIThread*
+GetCanvasReplayThread()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sCanvasReplayThread) {
+    nsCOMPtr<nsIThread> thread;
+    if (NS_FAILED(NS_NewNamedThread("Canvas2DReplay", getter_AddRefs(thread)))) {
+      return nullptr;
+    }
+    sCanvasReplayThread = thread.forget();
+  }
+  return sCanvasReplayThread;
+}
+
+/**
+ * Counts the captures a context has handed to the canvas replay thread, so
+ * that the main thread can wait until the raster target is up to date before
+ * reading its pixels or returning it to the buffer provider.
+ */
+class CanvasReplaySync final
+{
+public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(CanvasReplaySync)
+
+  CanvasReplaySync()
+    : mMonitor("CanvasReplaySync")
+    , mPendingReplays(0)
+  {
+  }
+
+  void ReplayQueued()
+  {
+    MonitorAutoLock lock(mMonitor);
+    mPendingReplays++;
+  }
+
+  void ReplayDone()
+  {
+    MonitorAutoLock lock(mMonitor);
+    if (--mPendingReplays == 0) {
+      lock.NotifyAll();
+    }
+  }
+
+  void WaitForReplays()
+  {
+    MonitorAutoLock lock(mMonitor);
+    while (mPendingReplays) {
+      lock.Wait();
+    }
+  }
+
+private:
+  ~CanvasReplaySync() {}
+
+  Monitor mMonitor;
+  uint32_t mPendingReplays;
+};
+
+class CanvasReplayTask final : public Runnable
+{
+public:
+  CanvasReplayTask(DrawTargetCapture* aCommands,
+                   DrawTarget* aRasterTarget,
+                   CanvasReplaySync* aSync)
+    : Runnable("CanvasReplayTask")
+    , mCommands(aCommands)
+    , mRasterTarget(aRasterTarget)
+    , mSync(aSync)
+  {
+  }
+
+  NS_IMETHOD Run() override
+  {
+    mRasterTarget->DrawCapturedDT(mCommands, Matrix());
+    // Drop our target reference before notifying so that the main thread
+    // keeps the last one. The capture is deliberately released here, off the
+    // main thread; it can hold a lot of command storage.
+    mRasterTarget = nullptr;
+    mCommands = nullptr;
+    mSync->ReplayDone();
+    return NS_OK;
+  }
+
+private:
+  RefPtr<DrawTargetCapture> mCommands;
+  RefPtr<DrawTarget> mRasterTarget;
+  RefPtr<CanvasReplaySync> mSync;
+};
+
+// How many draw calls to batch up before handing them to the replay thread.
+static const uint32_t kDeferredFlushDrawCount = 100;
 
 CanvasRenderingContext2D::CanvasRenderingContext2D(layers::LayersBackend aCompositorBackend)
   : mRenderingMode(RenderingMode::OpenGLBackendMode)
@@ -1101,6 +1200,7 @@ CanvasRenderingContext2D::CanvasRenderingContext2D(layers::LayersBackend aCompos
   , mIsCapturedFrameInvalid(false)
   , mPathTransformWillUpdate(false)
   , mInvalidateCount(0)
+  , mDeferredDrawCount(0)
 {
   if (!sMaxContextsInitialized) {
     sMaxContexts = gfxPrefs::CanvasAzureAcceleratedLimit();
@@ -1133,6 +1233,12 @@ CanvasRenderingContext2D::~CanvasRenderingContext2D()
   sNumLivingContexts--;
   if (!sNumLivingContexts) {
     NS_IF_RELEASE(sErrorTarget);
+    if (sCanvasReplayThread) {
+      // Reset() above drained our own replays; this waits for any that other
+      // contexts left behind before the thread goes away.
+      sCanvasReplayThread->Shutdown();
+      sCanvasReplayThread = nullptr;
+    }
   }
   RemoveDemotableContext(this);
 }
@@ -1289,6 +1395,8 @@ CanvasRenderingContext2D::Redraw()
 {
   mIsCapturedFrameInvalid = true;
 
+  MaybeFlushDeferredCommands();
+
   if (mIsEntireFrameInvalid) {
     return NS_OK;
   }
@@ -1312,6 +1420,8 @@ CanvasRenderingContext2D::Redraw(const gfx::Rect& aR)
 {
   mIsCapturedFrameInvalid = true;
 
+  MaybeFlushDeferredCommands();
+
   ++mInvalidateCount;
 
   if (mIsEntireFrameInvalid) {
@@ -1353,6 +1463,7 @@ CanvasRenderingContext2D::RedrawUser(const gfxRect& aR)
 
   if (mIsEntireFrameInvalid) {
     ++mInvalidateCount;
+    MaybeFlushDeferredCommands();
     return;
   }
 
@@ -1616,6 +1727,114 @@ CanvasRenderingContext2D::RestoreClipsAndTransformToTarget()
   }
 }
 
+void
+CanvasRenderingContext2D::MaybeDeferDrawing()
+{
+  MOZ_ASSERT(!mRasterTarget);
+
+  if (!gfxPrefs::CanvasDeferredRendering()) {
+    return;
+  }
+
+  // SkiaGL targets have to be used from the thread their GL context belongs
+  // to, and providers that preserve their drawing state keep clips pushed on
+  // the raster target across frames, where a fresh capture can't pick them
+  // up. Both keep drawing directly.
+  if (mIsSkiaGL || !IsTargetValid() ||
+      !mBufferProvider || mBufferProvider->PreservesDrawingState()) {
+    return;
+  }
+
+  if (!GetCanvasReplayThread()) {
+    return;
+  }
+
+  RefPtr<DrawTarget> capture =
+    Factory::CreateCaptureDrawTarget(mTarget->GetBackendType(), GetSize(),
+                                     mTarget->GetFormat());
+  if (!capture) {
+    return;
+  }
+
+  if (!mReplaySync) {
+    mReplaySync = new CanvasReplaySync();
+  }
+
+  mRasterTarget = mTarget.forget();
+  mTarget = capture.forget();
+  mDeferredDrawCount = 0;
+}
+
+void
+CanvasRenderingContext2D::MaybeFlushDeferredCommands()
+{
+  if (!mRasterTarget) {
+    return;
+  }
+
+  if (++mDeferredDrawCount < kDeferredFlushDrawCount) {
+    return;
+  }
+
+  // Splitting the command stream is only safe while no clips are active: a
+  // fresh capture can't re-push clips that already live on the raster target
+  // without unbalancing them when it is replayed. The same goes for the
+  // canvas-sized clip that RestoreClipsAndTransformToTarget pushes onto
+  // cairo targets.
+  if (mRasterTarget->GetBackendType() == gfx::BackendType::CAIRO) {
+    return;
+  }
+  for (const auto& style : mStyleStack) {
+    for (const auto& clipOrTransform : style.clipsAndTransforms) {
+      if (clipOrTransform.IsClip()) {
+        return;
+      }
+    }
+  }
+
+  RefPtr<DrawTarget> capture =
+    Factory::CreateCaptureDrawTarget(mRasterTarget->GetBackendType(), GetSize(),
+                                     mRasterTarget->GetFormat());
+  if (!capture) {
+    return;
+  }
+  capture->SetTransform(mTarget->GetTransform());
+
+  RefPtr<DrawTarget> commands = mTarget.forget();
+  mTarget = capture.forget();
+  mDeferredDrawCount = 0;
+
+  mReplaySync->ReplayQueued();
+  RefPtr<Runnable> task =
+    new CanvasReplayTask(static_cast<DrawTargetCapture*>(commands.get()),
+                         mRasterTarget, mReplaySync);
+  if (NS_FAILED(GetCanvasReplayThread()->Dispatch(task.forget(),
+                                                  NS_DISPATCH_NORMAL))) {
+    // The thread is going away (shutdown); rasterize in place instead.
+    mReplaySync->ReplayDone();
+    mReplaySync->WaitForReplays();
+    mRasterTarget->DrawCapturedDT(
+      static_cast<DrawTargetCapture*>(commands.get()), Matrix());
+  }
+}
+
+void
+CanvasRenderingContext2D::FinishDeferredCommands()
+{
+  if (!mRasterTarget) {
+    return;
+  }
+
+  RefPtr<DrawTarget> commands = mTarget.forget();
+  mTarget = mRasterTarget.forget();
+
+  // Wait for the chunks that are already queued, then rasterize the tail of
+  // the command stream in place; that's cheaper than another dispatch.
+  mReplaySync->WaitForReplays();
+  mTarget->DrawCapturedDT(static_cast<DrawTargetCapture*>(commands.get()),
+                          Matrix());
+}
+
 CanvasRenderingContext2D::RenderingMode
 CanvasRenderingContext2D::EnsureTarget(const gfx::Rect* aCoveredRect,
                                        RenderingMode aRenderingMode)
@@ -1635,6 +1854,10 @@ CanvasRenderingContext2D::EnsureTarget(const gfx::Rect* aCoveredRect,
     return mRenderingMode;
   }
 
+  // Switching modes with a live target copies the current content over to
+  // the new target; make sure recorded commands have landed in it first.
+  FinishDeferredCommands();
+
   // Check that the dimensions are sane
   if (mWidth > gfxPrefs::MaxCanvasSize() ||
       mHeight > gfxPrefs::MaxCanvasSize() ||
@@ -1672,6 +1895,10 @@ CanvasRenderingContext2D::EnsureTarget(const gfx::Rect* aCoveredRect,
   if (mBufferProvider && mode == mRenderingMode) {
     mTarget = mBufferProvider->BorrowDrawTarget(persistedRect);
 
+    if (mTarget) {
+      MaybeDeferDrawing();
+    }
+
     if (mTarget && !mBufferProvider->PreservesDrawingState()) {
       RestoreClipsAndTransformToTarget();
     }
@@ -1729,6 +1956,8 @@ CanvasRenderingContext2D::EnsureTarget(const gfx::Rect* aCoveredRect,
 
   RegisterAllocation();
 
+  MaybeDeferDrawing();
+
   RestoreClipsAndTransformToTarget();
 
   // Force a full layer transaction since we didn't have a layer before
@@ -1772,6 +2001,8 @@ CanvasRenderingContext2D::SetErrorState()
 
   mTarget = sErrorTarget;
   mBufferProvider = nullptr;
+  // Any replays still in flight keep their own reference to the old target.
+  mRasterTarget = nullptr;
 
   // clear transforms, clips, etc.
   SetInitialState();
@@ -1991,6 +2222,10 @@ CanvasRenderingContext2D::ReturnTarget(bool aForceReset)
       mTarget->SetTransform(Matrix());
     }
 
+    // The buffer provider's consumer expects all of the commands we recorded
+    // to have been rasterized by the time it gets the target back.
+    FinishDeferredCommands();
+
     mBufferProvider->ReturnDrawTarget(mTarget.forget());
   }
 }
@@ -2082,6 +2317,7 @@ CanvasRenderingContext2D::GetImageBuffer(int32_t* aFormat)
 
   RefPtr<SourceSurface> snapshot;
   if (mTarget) {
+    FinishDeferredCommands();
     snapshot = mTarget->Snapshot();
   } else if (mBufferProvider) {
     snapshot = mBufferProvider->BorrowSnapshot();
@@ -2090,6 +2326,7 @@ CanvasRenderingContext2D::GetImageBuffer(int32_t* aFormat)
     if (!IsTargetValid()) {
       return nullptr;
     }
+    FinishDeferredCommands();
     snapshot = mTarget->Snapshot();
   }
 
@@ -5792,6 +6029,7 @@ CanvasRenderingContext2D::GetImageDataArray(JSContext* aCx,
     if (!IsTargetValid()) {
       return NS_ERROR_FAILURE;
     }
+    FinishDeferredCommands();
     snapshot = mTarget->Snapshot();
   }
 
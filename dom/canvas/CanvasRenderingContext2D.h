@@ -56,6 +56,7 @@ template<typename T> class Optional;
 struct CanvasBidiProcessor;
 class CanvasRenderingContext2DUserData;
 class CanvasDrawObserver;
+class CanvasReplaySync;
 class CanvasShutdownObserver;
 
 /**
@@ -654,6 +655,29 @@ protected:
 
   void RestoreClipsAndTransformToTarget();
 
+  /**
+   * If deferred rendering is enabled, interpose a DrawTargetCapture between
+   * the canvas and the draw target that EnsureTarget just acquired. Drawing
+   * commands are then recorded and rasterized on the canvas replay thread
+   * instead of on the main thread.
+   */
+  void MaybeDeferDrawing();
+
+  /**
+   * Hand the commands recorded so far to the replay thread and continue
+   * recording into a fresh capture. Only splits the command stream when it
+   * is safe to do so (i.e. when no clips are active).
+   */
+  void MaybeFlushDeferredCommands();
+
+  /**
+   * Make sure all recorded commands have been rasterized into the raster
+   * target and go back to drawing to it directly. Must be called before
+   * reading the target's pixels or handing it back to the buffer provider.
+   * EnsureTarget will switch back to recording on the next frame.
+   */
+  void FinishDeferredCommands();
+
   bool TrySkiaGLTarget(RefPtr<gfx::DrawTarget>& aOutDT,
                        RefPtr<layers::PersistentBufferProvider>& aOutProvider);
 
@@ -786,6 +810,20 @@ protected:
 
   RefPtr<mozilla::layers::PersistentBufferProvider> mBufferProvider;
 
+  // When deferred rendering is active, mTarget is a DrawTargetCapture that
+  // records our drawing commands and mRasterTarget is the draw target that
+  // the canvas replay thread rasterizes them into. Null while drawing
+  // directly to mTarget.
+  RefPtr<mozilla::gfx::DrawTarget> mRasterTarget;
+
+  // Tracks the replays this context has queued on the canvas replay thread.
+  // Created lazily by MaybeDeferDrawing.
+  RefPtr<CanvasReplaySync> mReplaySync;
+
+  // Number of draw calls recorded since the last time we handed commands to
+  // the replay thread.
+  uint32_t mDeferredDrawCount;
+
   uint32_t SkiaGLTex() const;
 
   // This observes our draw calls at the beginning of the canvas
@@ -7,6 +7,7 @@
 
 #include "GLBlitHelper.h"
 #include "GLContext.h"
+#include "gfxPrefs.h"
 #include "mozilla/dom/Element.h"
 #include "mozilla/dom/HTMLCanvasElement.h"
 #include "mozilla/RefPtr.h"
@@ -395,6 +396,42 @@ TexUnpackBlob::ConvertIfNeeded(WebGLContext* webgl, const char* funcName,
     return true;
 }
 
+// Stage a client-memory upload through a scratch PBO so that the driver's
+// copy out of it can overlap subsequent rendering, instead of glTexImage
+// blocking on a synchronous read of client memory. Returns false if staging
+// isn't worthwhile or possible here; the caller then uploads straight from
+// client memory.
+static bool
+StageForAsyncUpload(gl::GLContext* gl, WebGLContext* webgl, const uint8_t* data,
+                    size_t byteCount)
+{
+    if (!gfxPrefs::WebGLPBOUploads())
+        return false;
+
+    // Small uploads are cheaper to hand over directly than to stage.
+    const size_t kMinBytesForStaging = 64 * 1024;
+    if (byteCount < kMinBytesForStaging)
+        return false;
+
+    const bool hasPBOs = !gl->IsGLES() ||
+                         gl->Version() >= 300 ||
+                         gl->IsExtensionSupported(gl::GLContext::ARB_pixel_buffer_object);
+    if (!hasPBOs)
+        return false;
+
+    if (!webgl->mStreamUploadPBO) {
+        gl->fGenBuffers(1, &webgl->mStreamUploadPBO);
+    }
+
+    gl->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER, webgl->mStreamUploadPBO);
+    // BufferData with STREAM_DRAW orphans the previous storage, so we never
+    // wait on an upload that is still in flight, and it hands the client copy
+    // to the driver in a single call.
+    gl->fBufferData(LOCAL_GL_PIXEL_UNPACK_BUFFER, byteCount, data,
+                    LOCAL_GL_STREAM_DRAW);
+    return true;
+}
+
 static GLenum
 DoTexOrSubImage(bool isSubImage, gl::GLContext* gl, TexImageTarget target, GLint level,
                 const DriverUnpackInfo* dui, GLint xOffset, GLint yOffset, GLint zOffset,
@@ -445,6 +482,7 @@ TexUnpackBytes::TexOrSubImage(bool isSubImage, bool needsRespec, const char* fun
     const auto bytesPerPixel = webgl::BytesPerPixel(pi);
 
     const uint8_t* uploadPtr = mPtr;
+    size_t uploadBytes = mAvailBytes;
     UniqueBuffer tempBuffer;
 
     do {
@@ -481,6 +519,9 @@ TexUnpackBytes::TexOrSubImage(bool isSubImage, bool needsRespec, const char* fun
         {
             return false;
         }
+        if (tempBuffer.get()) {
+            uploadBytes = size_t(stride) * rowCount;
+        }
     } while (false);
 
     //////
@@ -500,15 +541,23 @@ TexUnpackBytes::TexOrSubImage(bool isSubImage, bool needsRespec, const char* fun
     }
 
     if (!useParanoidHandling) {
+        bool stagedUpload = false;
         if (webgl->mBoundPixelUnpackBuffer) {
             gl->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER,
                             webgl->mBoundPixelUnpackBuffer->mGLName);
+        } else if (mIsClientData && uploadPtr) {
+            stagedUpload = StageForAsyncUpload(gl, webgl, uploadPtr, uploadBytes);
+            if (stagedUpload) {
+                // The staged copy starts at offset 0 of the scratch PBO, so
+                // all the unpack state applies to it unchanged.
+                uploadPtr = nullptr;
+            }
         }
 
         *out_error = DoTexOrSubImage(isSubImage, gl, target, level, dui, xOffset, yOffset,
                                      zOffset, mWidth, mHeight, mDepth, uploadPtr);
 
-        if (webgl->mBoundPixelUnpackBuffer) {
+        if (webgl->mBoundPixelUnpackBuffer || stagedUpload) {
             gl->fBindBuffer(LOCAL_GL_PIXEL_UNPACK_BUFFER, 0);
         }
         return true;
@@ -116,6 +116,7 @@ WebGLContext::WebGLContext()
     , mMaxFetchedInstances(0)
     , mBypassShaderValidation(false)
     , mEmptyTFO(0)
+    , mStreamUploadPBO(0)
     , mContextLossHandler(this)
     , mNeedsFakeNoAlpha(false)
     , mNeedsFakeNoDepth(false)
@@ -265,6 +266,11 @@ WebGLContext::DestroyResourcesAndContext()
         mEmptyTFO = 0;
     }
 
+    if (mStreamUploadPBO) {
+        gl->fDeleteBuffers(1, &mStreamUploadPBO);
+        mStreamUploadPBO = 0;
+    }
+
     //////
 
     mFakeBlack_2D_0000       = nullptr;
@@ -1916,6 +1916,12 @@ protected:
 protected:
     GLuint mEmptyTFO;
 
+    // Scratch PBO used to stage client-memory texture uploads so the driver
+    // can copy them to the GPU asynchronously. Its storage is orphaned on
+    // every upload, which lets the driver cycle through backing allocations
+    // internally instead of stalling on one that is still in flight.
+    GLuint mStreamUploadPBO;
+
     // Generic Vertex Attributes
     // Though CURRENT_VERTEX_ATTRIB is listed under "Vertex Shader State" in the spec
     // state tables, this isn't vertex shader /object/ state. This array is merely state
@@ -130,6 +130,7 @@ EventListenerManagerBase::EventListenerManagerBase()
   , mMayHaveKeyEventListener(false)
   , mMayHaveInputOrCompositionEventListener(false)
   , mMayHaveSelectionChangeEventListener(false)
+  , mMayHaveMouseMoveEventListener(false)
   , mClearingListeners(false)
   , mIsMainThreadELM(NS_IsMainThread())
 {
@@ -313,6 +314,11 @@ EventListenerManager::AddEventListenerInternal(
   if (aFlags.mCapture) {
     mMayHaveCapturingListeners = true;
   }
+  // All-events listeners have to keep getting the pointer movement stream
+  // too; see the fast path in HandleEvent.
+  if (aAllEvents || IsMouseMoveFamilyEvent(aEventMessage)) {
+    mMayHaveMouseMoveEventListener = true;
+  }
 
   if (aEventMessage == eAfterPaint) {
     mMayHavePaintEventListener = true;
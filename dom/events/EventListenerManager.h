@@ -166,9 +166,10 @@ protected:
   uint16_t mMayHaveKeyEventListener : 1;
   uint16_t mMayHaveInputOrCompositionEventListener : 1;
   uint16_t mMayHaveSelectionChangeEventListener : 1;
+  uint16_t mMayHaveMouseMoveEventListener : 1;
   uint16_t mClearingListeners : 1;
   uint16_t mIsMainThreadELM : 1;
-  // uint16_t mUnused : 4;
+  // uint16_t mUnused : 3;
 };
 
 /*
@@ -366,6 +367,16 @@ public:
       return;
     }
 
+    // Mouse and pointer move events are dispatched for every pointer
+    // movement, through the whole event target chain, and most targets on
+    // that chain listen only for other things.  mNoListenerForEvent below
+    // caches a single message, so the interleaved move/over/out stream
+    // thrashes it; check the aggregated bit before scanning mListeners.
+    if (!mMayHaveMouseMoveEventListener &&
+        IsMouseMoveFamilyEvent(aEvent->mMessage)) {
+      return;
+    }
+
     // Check if we already know that there is no event listener for the event.
     if (mNoListenerForEvent == aEvent->mMessage &&
         (mNoListenerForEvent != eUnidentifiedEvent ||
@@ -444,6 +455,32 @@ public:
   bool MayHavePointerEnterLeaveEventListener() { return mMayHavePointerEnterLeaveEventListener; }
   bool MayHaveSelectionChangeEventListener() { return mMayHaveSelectionChangeEventListener; }
 
+  /**
+   * Returns true if there may be a listener for one of the events which are
+   * dispatched on every pointer movement (mousemove, pointermove and the
+   * over/out pairs), false if there definitely isn't.
+   */
+  bool MayHaveMouseMoveEventListener() { return mMayHaveMouseMoveEventListener; }
+
+  /**
+   * Returns true for the events which are dispatched on every pointer
+   * movement and which mMayHaveMouseMoveEventListener covers.
+   */
+  static bool IsMouseMoveFamilyEvent(EventMessage aMessage)
+  {
+    switch (aMessage) {
+      case eMouseMove:
+      case eMouseOver:
+      case eMouseOut:
+      case ePointerMove:
+      case ePointerOver:
+      case ePointerOut:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   /**
    * Returns true if there may be a key event listener (keydown, keypress,
    * or keyup) registered, or false if there definitely isn't.
@@ -21,6 +21,7 @@
 #include "nsStreamUtils.h"
 #include "nsStringStream.h"
 #include "nsProxyRelease.h"
+#include "nsThreadUtils.h"
 
 #include "mozilla/ErrorResult.h"
 #include "mozilla/dom/BindingDeclarations.h"
@@ -468,7 +469,12 @@ FetchRequest(nsIGlobalObject* aGlobal, const RequestOrUSVString& aInput,
 
     RefPtr<MainThreadFetchRunnable> run =
       new MainThreadFetchRunnable(resolver, r);
-    worker->DispatchToMainThread(run.forget());
+    // Nothing leaves the network until this runnable creates and opens the
+    // channel, so run it ahead of normal main thread events rather than
+    // queueing behind them.
+    nsCOMPtr<nsIRunnable> prioritized =
+      new PrioritizableRunnable(run.forget(), nsIRunnablePriority::PRIORITY_HIGH);
+    worker->DispatchToMainThread(prioritized.forget());
   }
 
   return p.forget();
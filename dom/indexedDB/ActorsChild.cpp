@@ -3752,7 +3752,93 @@ BackgroundCursorChild::SendContinueInternal(const CursorRequestParams& aParams)
 
   mTransaction->OnNewRequest();
 
-  MOZ_ALWAYS_TRUE(PBackgroundIDBCursorChild::SendContinue(aParams));
+  CursorRequestParams params = aParams;
+
+  // Try to serve the request from records the parent preloaded past the
+  // one that was requested (see Cursor::MaxExtraRecords() in
+  // ActorsParent.cpp). The records arrived in iteration order, so the
+  // front of the cache is always the cursor's next position.
+  switch (params.type()) {
+    case CursorRequestParams::TContinueParams: {
+      const Key& key = params.get_ContinueParams().key();
+      if (!key.IsUnset()) {
+        // Drop preloaded records that precede the target key. If the
+        // target lies beyond all of them it also lies beyond the
+        // parent's position and the request must go to the parent.
+        while (!mCachedResponses.IsEmpty()) {
+          const Key& cachedKey = mCachedResponses[0].mKey;
+
+          bool reachedTarget;
+          if (mDirection == IDBCursor::NEXT ||
+              mDirection == IDBCursor::NEXT_UNIQUE) {
+            reachedTarget = cachedKey >= key;
+          } else {
+            reachedTarget = cachedKey <= key;
+          }
+          if (reachedTarget) {
+            break;
+          }
+
+          mCachedResponses.RemoveElementAt(0);
+        }
+      }
+      break;
+    }
+
+    case CursorRequestParams::TAdvanceParams: {
+      // Each preloaded record consumes one step of the advance; whatever
+      // is left once the cache runs out is advanced by the parent from
+      // its own position, which matches the last preloaded record.
+      uint32_t& count = params.get_AdvanceParams().count();
+      while (count > 1 && !mCachedResponses.IsEmpty()) {
+        mCachedResponses.RemoveElementAt(0);
+        count--;
+      }
+      break;
+    }
+
+    case CursorRequestParams::TContinuePrimaryKeyParams:
+      // Only index cursors use this and they are never preloaded.
+      MOZ_ASSERT(mCachedResponses.IsEmpty());
+      break;
+
+    default:
+      MOZ_CRASH("Should never get here!");
+  }
+
+  if (!mCachedResponses.IsEmpty()) {
+    nsCOMPtr<nsIRunnable> continueRunnable = new DelayedActionRunnable(
+      this, &BackgroundCursorChild::CompleteContinueRequestFromCache);
+    MOZ_ALWAYS_SUCCEEDS(this->GetActorEventTarget()->
+      Dispatch(continueRunnable.forget(), NS_DISPATCH_NORMAL));
+    return;
+  }
+
+  MOZ_ALWAYS_TRUE(PBackgroundIDBCursorChild::SendContinue(params));
+}
+
+void
+BackgroundCursorChild::CompleteContinueRequestFromCache()
+{
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(mRequest);
+  MOZ_ASSERT(mTransaction);
+  MOZ_ASSERT(mCursor);
+  MOZ_ASSERT(mStrongCursor);
+  MOZ_ASSERT(!mCachedResponses.IsEmpty());
+
+  RefPtr<IDBCursor> cursor;
+  mStrongCursor.swap(cursor);
+
+  CachedResponse response = Move(mCachedResponses[0]);
+  mCachedResponses.RemoveElementAt(0);
+
+  mCursor->Reset(Move(response.mKey), Move(response.mCloneInfo));
+
+  ResultHelper helper(mRequest, mTransaction, mCursor);
+  DispatchSuccessEvent(&helper);
+
+  mTransaction->OnRequestFinished(/* aActorDestroyedNormally */ true);
 }
 
 void
@@ -3824,12 +3910,19 @@ BackgroundCursorChild::HandleResponse(
   MOZ_ASSERT(!mStrongRequest);
   MOZ_ASSERT(!mStrongCursor);
 
-  MOZ_ASSERT(aResponses.Length() == 1);
+  MOZ_ASSERT(!aResponses.IsEmpty());
+  MOZ_ASSERT(mCachedResponses.IsEmpty());
 
   // XXX Fix this somehow...
   auto& responses =
     const_cast<nsTArray<ObjectStoreCursorResponse>&>(aResponses);
 
+  // The first response is the record that was requested; the rest were
+  // preloaded ahead of the next continue()s and are cached until they are
+  // consumed by SendContinueInternal().
+  RefPtr<IDBCursor> newCursor;
+  bool isFirst = true;
+
   for (ObjectStoreCursorResponse& response : responses) {
     StructuredCloneReadInfo cloneReadInfo(Move(response.cloneInfo()));
     cloneReadInfo.mDatabase = mTransaction->Database();
@@ -3839,15 +3932,19 @@ BackgroundCursorChild::HandleResponse(
                                     nullptr,
                                     cloneReadInfo.mFiles);
 
-    RefPtr<IDBCursor> newCursor;
-
-    if (mCursor) {
-      mCursor->Reset(Move(response.key()), Move(cloneReadInfo));
+    if (isFirst) {
+      if (mCursor) {
+        mCursor->Reset(Move(response.key()), Move(cloneReadInfo));
+      } else {
+        newCursor = IDBCursor::Create(this,
+                                      Move(response.key()),
+                                      Move(cloneReadInfo));
+        mCursor = newCursor;
+      }
+      isFirst = false;
     } else {
-      newCursor = IDBCursor::Create(this,
-                                    Move(response.key()),
-                                    Move(cloneReadInfo));
-      mCursor = newCursor;
+      mCachedResponses.AppendElement(
+        CachedResponse(Move(response.key()), Move(cloneReadInfo)));
     }
   }
 
@@ -8,8 +8,10 @@
 #define mozilla_dom_indexeddb_actorschild_h__
 
 #include "IDBTransaction.h"
+#include "IndexedDatabase.h"
 #include "js/RootingAPI.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/Move.h"
 #include "mozilla/dom/indexedDB/PBackgroundIDBCursorChild.h"
 #include "mozilla/dom/indexedDB/PBackgroundIDBDatabaseChild.h"
 #include "mozilla/dom/indexedDB/PBackgroundIDBDatabaseRequestChild.h"
@@ -750,6 +752,25 @@ class BackgroundCursorChild final
 
   class DelayedActionRunnable;
 
+  // A record the parent sent ahead of the one that was requested, kept
+  // until a continue()/advance() can be served from it without a round
+  // trip. See CursorOpBase::PopulateExtraResponses in ActorsParent.cpp.
+  struct CachedResponse
+  {
+    CachedResponse(Key&& aKey, StructuredCloneReadInfo&& aCloneInfo)
+      : mKey(Move(aKey))
+      , mCloneInfo(Move(aCloneInfo))
+    { }
+
+    CachedResponse(CachedResponse&& aOther) = default;
+
+    CachedResponse&
+    operator=(CachedResponse&& aOther) = default;
+
+    Key mKey;
+    StructuredCloneReadInfo mCloneInfo;
+  };
+
   IDBRequest* mRequest;
   IDBTransaction* mTransaction;
   IDBObjectStore* mObjectStore;
@@ -760,6 +781,11 @@ class BackgroundCursorChild final
   RefPtr<IDBRequest> mStrongRequest;
   RefPtr<IDBCursor> mStrongCursor;
 
+  // Records preloaded by the parent past the last one requested, in
+  // iteration order; the front of the array is always the cursor's next
+  // position.
+  nsTArray<CachedResponse> mCachedResponses;
+
   Direction mDirection;
 
   NS_DECL_OWNINGTHREAD
@@ -822,6 +848,9 @@ private:
   // BackgroundVersionChangeTransactionChild.
   ~BackgroundCursorChild();
 
+  void
+  CompleteContinueRequestFromCache();
+
   void
   HandleResponse(nsresult aResponse);
 
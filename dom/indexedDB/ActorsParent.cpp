@@ -238,6 +238,13 @@ const uint32_t kConnectionIdleCloseMS = 10 * 1000; // 10 seconds
 // The length of time that idle threads will stay alive before being shut down.
 const uint32_t kConnectionThreadIdleMS = 30 * 1000; // 30 seconds
 
+// The number of records a cursor operation may send ahead of the one that was
+// requested so that continue() can be served from the child's cache without a
+// round trip, and a rough cap on how much structured clone data the extra
+// records may add to a single response message.
+const uint32_t kMaxExtraCursorRecords = 64;
+const uint32_t kMaxExtraCursorRecordsSize = 4 * 1024 * 1024; // 4 MiB
+
 #define SAVEPOINT_CLAUSE "SAVEPOINT sp;"
 
 const uint32_t kFileCopyBufferSize = 32768;
@@ -8744,6 +8751,21 @@ private:
   IsLocaleAware() const {
     return !mLocale.IsEmpty();
   }
+
+  // The number of records cursor operations may send beyond the requested
+  // one, so that the child can serve continue() from its cache without a
+  // round trip. Only object store value cursors in read-only transactions
+  // preload: such transactions cannot mutate the object store
+  // mid-iteration, so the extra records can never go stale.
+  uint32_t
+  MaxExtraRecords() const
+  {
+    if (mType == OpenCursorParams::TObjectStoreOpenCursorParams &&
+        mTransaction->GetMode() == IDBTransaction::READ_ONLY) {
+      return kMaxExtraCursorRecords;
+    }
+    return 0;
+  }
 };
 
 class Cursor::CursorOpBase
@@ -8783,6 +8805,10 @@ protected:
   nsresult
   PopulateResponseFromStatement(DatabaseConnection::CachedStatement& aStmt,
                                 bool aInitializeResponse);
+
+  nsresult
+  PopulateExtraResponses(DatabaseConnection::CachedStatement& aStmt,
+                         uint32_t aMaxExtraCount);
 };
 
 class Cursor::OpenOp final
@@ -26413,7 +26439,11 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(DatabaseConnection* aConnection)
     auto iter = cloneData.Iter();
     cloneData.ReadBytes(iter, flatCloneData.BeginWriting(), cloneDataSize);
 
-    // Compress the bytes before adding into the database.
+    // Compress the bytes before adding into the database. Snappy's match
+    // scan is wasted work for payloads that don't compress (media data and
+    // the like), so sniff a small prefix first; if that doesn't shrink,
+    // store the payload as a single snappy literal element instead, which
+    // encodes it nearly verbatim and decompresses with a plain copy.
     const char* uncompressed = flatCloneData.BeginReading();
     size_t uncompressedLength = cloneDataSize;
 
@@ -26425,8 +26455,51 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(DatabaseConnection* aConnection)
       return NS_ERROR_OUT_OF_MEMORY;
     }
 
-    snappy::RawCompress(uncompressed, uncompressedLength, compressed.get(),
-                        &compressedLength);
+    static const size_t kCompressibilitySampleSize = 4096;
+
+    bool sampleCompressible = true;
+    if (uncompressedLength > kCompressibilitySampleSize) {
+      // The sample is compressed into the full-size output buffer, which
+      // is always large enough for it. Require the sample to shrink by at
+      // least 1/16th before compressing the whole payload.
+      size_t sampleCompressedLength;
+      snappy::RawCompress(uncompressed, kCompressibilitySampleSize,
+                          compressed.get(), &sampleCompressedLength);
+      sampleCompressible =
+        sampleCompressedLength <
+          kCompressibilitySampleSize - (kCompressibilitySampleSize / 16);
+    }
+
+    if (sampleCompressible) {
+      snappy::RawCompress(uncompressed, uncompressedLength, compressed.get(),
+                          &compressedLength);
+    } else {
+      // Frame the payload as the varint-encoded uncompressed length
+      // followed by one literal element spanning the whole payload. This
+      // is a valid snappy stream, so readers decode it like any other
+      // record.
+      char* out = compressed.get();
+      size_t offset = 0;
+
+      uint32_t lengthVarint = uint32_t(uncompressedLength);
+      while (lengthVarint >= 0x80) {
+        out[offset++] = char(lengthVarint | 0x80);
+        lengthVarint >>= 7;
+      }
+      out[offset++] = char(lengthVarint);
+
+      // A literal element with an explicit 4-byte length, holding the
+      // payload length minus one, little-endian.
+      const uint32_t literalLength = uint32_t(uncompressedLength) - 1;
+      out[offset++] = char(0xFC);
+      out[offset++] = char(literalLength);
+      out[offset++] = char(literalLength >> 8);
+      out[offset++] = char(literalLength >> 16);
+      out[offset++] = char(literalLength >> 24);
+
+      memcpy(out + offset, uncompressed, uncompressedLength);
+      compressedLength = offset + uncompressedLength;
+    }
 
     uint8_t* dataBuffer = reinterpret_cast<uint8_t*>(compressed.release());
     size_t dataBufferLength = compressedLength;
@@ -27830,7 +27903,11 @@ CursorOpBase::PopulateResponseFromStatement(
     bool aInitializeResponse)
 {
   Transaction()->AssertIsOnConnectionThread();
-  MOZ_ASSERT(mResponse.type() == CursorResponse::T__None);
+  MOZ_ASSERT_IF(aInitializeResponse,
+                mResponse.type() == CursorResponse::T__None);
+  MOZ_ASSERT_IF(!aInitializeResponse,
+                mResponse.type() ==
+                  CursorResponse::TArrayOfObjectStoreCursorResponse);
   MOZ_ASSERT_IF(mFiles.IsEmpty(), aInitializeResponse);
 
   nsresult rv = mCursor->mKey.SetFromStatement(aStmt, 0);
@@ -27941,6 +28018,47 @@ CursorOpBase::PopulateResponseFromStatement(
   return NS_OK;
 }
 
+nsresult
+Cursor::
+CursorOpBase::PopulateExtraResponses(DatabaseConnection::CachedStatement& aStmt,
+                                     uint32_t aMaxExtraCount)
+{
+  Transaction()->AssertIsOnConnectionThread();
+  MOZ_ASSERT(mCursor);
+  MOZ_ASSERT(mCursor->mType == OpenCursorParams::TObjectStoreOpenCursorParams);
+  MOZ_ASSERT(mResponse.type() ==
+               CursorResponse::TArrayOfObjectStoreCursorResponse);
+
+  uint32_t extraSize = 0;
+
+  for (uint32_t count = 0; count < aMaxExtraCount; count++) {
+    bool hasResult;
+    nsresult rv = aStmt->ExecuteStep(&hasResult);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+
+    if (!hasResult) {
+      // The cursor reached the end of the range; the child learns that
+      // from the empty response to its next continue() as usual.
+      break;
+    }
+
+    rv = PopulateResponseFromStatement(aStmt, false);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+
+    extraSize += mResponse.get_ArrayOfObjectStoreCursorResponse()
+                   .LastElement().cloneInfo().data().data.Size();
+    if (extraSize >= kMaxExtraCursorRecordsSize) {
+      break;
+    }
+  }
+
+  return NS_OK;
+}
+
 void
 Cursor::
 OpenOp::GetRangeKeyInfo(bool aLowerBound, Key* aKey, bool* aOpen)
@@ -28026,6 +28144,11 @@ OpenOp::DoObjectStoreDatabaseWork(DatabaseConnection* aConnection)
       MOZ_CRASH("Should never get here!");
   }
 
+  const uint32_t maxExtraCount = mCursor->MaxExtraRecords();
+
+  nsAutoCString limitString;
+  limitString.AppendInt(1 + maxExtraCount);
+
   // Note: Changing the number or order of SELECT columns in the query will
   // require changes to CursorOpBase::PopulateResponseFromStatement.
   nsCString firstQuery =
@@ -28033,7 +28156,7 @@ OpenOp::DoObjectStoreDatabaseWork(DatabaseConnection* aConnection)
     keyRangeClause +
     directionClause +
     openLimit +
-    NS_LITERAL_CSTRING("1");
+    limitString;
 
   DatabaseConnection::CachedStatement stmt;
   nsresult rv = aConnection->GetCachedStatement(firstQuery, &stmt);
@@ -28070,6 +28193,13 @@ OpenOp::DoObjectStoreDatabaseWork(DatabaseConnection* aConnection)
     return rv;
   }
 
+  if (maxExtraCount) {
+    rv = PopulateExtraResponses(stmt, maxExtraCount);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+  }
+
   // Now we need to make the query to get the next match.
   keyRangeClause.Truncate();
   nsAutoCString continueToKeyRangeClause;
@@ -28914,9 +29044,13 @@ ContinueOp::DoDatabaseWork(DatabaseConnection* aConnection)
     hasContinuePrimaryKey ? mCursor->mContinuePrimaryKeyQuery :
     hasContinueKey ? mCursor->mContinueToQuery : mCursor->mContinueQuery;
 
+  // Any extra records are fetched through the same statement, so they have
+  // to fit within its LIMIT.
+  const uint32_t maxExtraCount = mCursor->MaxExtraRecords();
+
   MOZ_ASSERT(advanceCount > 0);
   nsAutoCString countString;
-  countString.AppendInt(advanceCount);
+  countString.AppendInt(advanceCount + maxExtraCount);
 
   nsCString query = continueQuery + countString;
 
@@ -28997,6 +29131,13 @@ ContinueOp::DoDatabaseWork(DatabaseConnection* aConnection)
     return rv;
   }
 
+  if (maxExtraCount) {
+    rv = PopulateExtraResponses(stmt, maxExtraCount);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+  }
+
   return NS_OK;
 }
 
@@ -126,6 +126,7 @@
 #include "nsDebugImpl.h"
 #include "nsHashPropertyBag.h"
 #include "nsLayoutStylesheetCache.h"
+#include "nsLayoutUtils.h"
 #include "nsThreadManager.h"
 #include "nsAnonymousTemporaryFile.h"
 #include "nsISpellChecker.h"
@@ -574,7 +575,8 @@ mozilla::ipc::IPCResult
 ContentChild::RecvSetXPCOMProcessAttributes(const XPCOMInitData& aXPCOMInit,
                                             const StructuredCloneData& aInitialData,
                                             nsTArray<LookAndFeelInt>&& aLookAndFeelIntCache,
-                                            nsTArray<FontFamilyListEntry>&& aFontFamilyList)
+                                            nsTArray<FontFamilyListEntry>&& aFontFamilyList,
+                                            nsTArray<nsCString>&& aFontPatternList)
 {
   if (!sShutdownCanary) {
     return IPC_OK();
@@ -582,6 +584,7 @@ ContentChild::RecvSetXPCOMProcessAttributes(const XPCOMInitData& aXPCOMInit,
 
   mLookAndFeelCache = Move(aLookAndFeelIntCache);
   mFontFamilies = Move(aFontFamilyList);
+  mFontPatterns = Move(aFontPatternList);
   gfx::gfxVars::SetValuesForInitialize(aXPCOMInit.gfxNonDefaultVarUpdates());
   InitXPCOM(aXPCOMInit, aInitialData);
   InitGraphicsDeviceData(aXPCOMInit.contentDeviceData());
@@ -1158,6 +1161,12 @@ ContentChild::InitXPCOM(const XPCOMInitData& aXPCOMInit,
                         const mozilla::dom::ipc::StructuredCloneData& aInitialData)
 {
   SET_PREF_PHASE(pref_initPhase::BEGIN_ALL_PREFS);
+  if (aXPCOMInit.prefMapSize()) {
+    // The parent shared its pref table as a read-only snapshot; prefs get
+    // faulted into our hashtable lazily as they're looked up.
+    Preferences::SetSharedPrefMap(aXPCOMInit.prefMapHandle(),
+                                  aXPCOMInit.prefMapSize());
+  }
   for (unsigned int i = 0; i < aXPCOMInit.prefs().Length(); i++) {
     Preferences::SetPreference(aXPCOMInit.prefs().ElementAt(i));
   }
@@ -1240,6 +1249,17 @@ ContentChild::InitXPCOM(const XPCOMInitData& aXPCOMInit,
 
   // Set the dynamic scalar definitions for this process.
   TelemetryIPC::AddDynamicScalarDefinitions(aXPCOMInit.dynamicScalarDefs());
+
+  // Warm up the UA style sheet cache once we're otherwise idle, so that the
+  // first document's style set construction doesn't have to parse the sheets.
+  // A preallocated process sits idle until its first tab opens, which makes
+  // this effectively free there.
+  NS_IdleDispatchToCurrentThread(
+    NS_NewRunnableFunction("nsLayoutStylesheetCache::Preload", [] {
+      nsLayoutStylesheetCache::Preload(nsLayoutUtils::StyloEnabled()
+                                         ? StyleBackendType::Servo
+                                         : StyleBackendType::Gecko);
+    }));
 }
 
 mozilla::ipc::IPCResult
@@ -2618,7 +2638,27 @@ ContentChild::RecvFlushMemory(const nsString& reason)
   nsCOMPtr<nsIObserverService> os =
     mozilla::services::GetObserverService();
   if (os) {
-    os->NotifyObservers(nullptr, "memory-pressure", reason.get());
+    // The parent broadcasts memory pressure to every content process, which
+    // makes them all dump their caches at once and then all refill them at
+    // once. If this process is comfortably under its resident budget it
+    // isn't the one responsible for the pressure, so soften a "low-memory"
+    // stop-the-world signal into an ongoing trim and leave the aggressive
+    // minimize to the processes that are actually over budget. A budget of
+    // 0 (the default) keeps the old broadcast behavior.
+    nsAutoString data(reason);
+    uint32_t budgetMB =
+      Preferences::GetUint("memory.pressure.rss_budget_mb", 0);
+    if (budgetMB && data.EqualsLiteral("low-memory")) {
+      nsCOMPtr<nsIMemoryReporterManager> mgr =
+        do_GetService("@mozilla.org/memory-reporter-manager;1");
+      int64_t resident = 0;
+      if (mgr && NS_SUCCEEDED(mgr->GetResidentFast(&resident)) &&
+          resident > 0 &&
+          uint64_t(resident) < uint64_t(budgetMB) * 1024 * 1024) {
+        data.AssignLiteral("low-memory-ongoing");
+      }
+    }
+    os->NotifyObservers(nullptr, "memory-pressure", data.get());
   }
   return IPC_OK();
 }
@@ -603,7 +603,8 @@ public:
   RecvSetXPCOMProcessAttributes(const XPCOMInitData& aXPCOMInit,
                                 const StructuredCloneData& aInitialData,
                                 nsTArray<LookAndFeelInt>&& aLookAndFeelIntCache,
-                                nsTArray<FontFamilyListEntry>&& aFontFamilyList) override;
+                                nsTArray<FontFamilyListEntry>&& aFontFamilyList,
+                                nsTArray<nsCString>&& aFontPatternList) override;
 
   virtual mozilla::ipc::IPCResult
   RecvProvideAnonymousTemporaryFile(const uint64_t& aID, const FileDescOrError& aFD) override;
@@ -648,6 +649,13 @@ public:
     return mFontFamilies;
   }
 
+  // Get a reference to the serialized fontconfig pattern list passed from
+  // the chrome process, for use during gfx initialization.
+  InfallibleTArray<nsCString>&
+  SystemFontPatternList() {
+    return mFontPatterns;
+  }
+
   // PURLClassifierChild
   virtual PURLClassifierChild*
   AllocPURLClassifierChild(const Principal& aPrincipal,
@@ -743,6 +751,10 @@ private:
   // parent process and used to initialize gfx in the child. Currently used
   // only on MacOSX.
   InfallibleTArray<mozilla::dom::FontFamilyListEntry> mFontFamilies;
+  // Temporary storage for the serialized system font patterns, passed from
+  // the parent process and used to initialize gfx in the child. Currently
+  // used only on platforms using fontconfig.
+  InfallibleTArray<nsCString> mFontPatterns;
   // Temporary storage for nsXPLookAndFeel flags.
   nsTArray<LookAndFeelInt> mLookAndFeelCache;
 
@@ -67,6 +67,7 @@
 #include "mozilla/ipc/BackgroundParent.h"
 #include "mozilla/ipc/FileDescriptorUtils.h"
 #include "mozilla/ipc/PChildToParentStreamParent.h"
+#include "mozilla/ipc/SharedMemoryBasic.h"
 #include "mozilla/ipc/TestShellParent.h"
 #include "mozilla/ipc/IPCStreamUtils.h"
 #include "mozilla/intl/LocaleService.h"
@@ -2160,7 +2161,15 @@ ContentParent::InitInternal(ProcessPriority aInitialPriority,
 
   XPCOMInitData xpcomInit;
 
-  Preferences::GetPreferences(&xpcomInit.prefs());
+  // Prefer handing the child a shared-memory snapshot of the pref table over
+  // serializing every pref; fall back to the array if sharing fails.
+  xpcomInit.prefMapHandle() = SharedMemoryBasic::NULLHandle();
+  xpcomInit.prefMapSize() = 0;
+  if (!Preferences::GetSharedPrefMapHandle(OtherPid(),
+                                           &xpcomInit.prefMapHandle(),
+                                           &xpcomInit.prefMapSize())) {
+    Preferences::GetPreferences(&xpcomInit.prefs());
+  }
   nsCOMPtr<nsIIOService> io(do_GetIOService());
   MOZ_ASSERT(io, "No IO service?");
   DebugOnly<nsresult> rv = io->GetOffline(&xpcomInit.isOffline());
@@ -2229,6 +2238,9 @@ ContentParent::InitInternal(ProcessPriority aInitialPriority,
   // This is only implemented (returns a non-empty list) by MacOSX at present.
   nsTArray<FontFamilyListEntry> fontFamilies;
   gfxPlatform::GetPlatform()->GetSystemFontFamilyList(&fontFamilies);
+  // And this only by platforms using fontconfig.
+  nsTArray<nsCString> fontPatterns;
+  gfxPlatform::GetPlatform()->GetSystemFontPatternList(&fontPatterns);
   nsTArray<LookAndFeelInt> lnfCache = LookAndFeel::GetIntCache();
 
   // Content processes have no permission to access profile directory, so we
@@ -2271,7 +2283,7 @@ ContentParent::InitInternal(ProcessPriority aInitialPriority,
   screenManager.CopyScreensToRemote(this);
 
   Unused << SendSetXPCOMProcessAttributes(xpcomInit, initialData, lnfCache,
-                                          fontFamilies);
+                                          fontFamilies, fontPatterns);
 
   if (aSendRegisteredChrome) {
     nsCOMPtr<nsIChromeRegistry> registrySvc = nsChromeRegistry::GetService();
@@ -3507,15 +3519,17 @@ ContentParent::RecvPSpeechSynthesisConstructor(PSpeechSynthesisParent* aActor)
 }
 
 mozilla::ipc::IPCResult
-ContentParent::RecvStartVisitedQuery(const URIParams& aURI)
+ContentParent::RecvStartVisitedQueries(nsTArray<URIParams>&& aURIs)
 {
-  nsCOMPtr<nsIURI> newURI = DeserializeURI(aURI);
-  if (!newURI) {
-  return IPC_FAIL_NO_REASON(this);
-  }
   nsCOMPtr<IHistory> history = services::GetHistoryService();
-  if (history) {
-  history->RegisterVisitedCallback(newURI, nullptr);
+  for (const URIParams& params : aURIs) {
+    nsCOMPtr<nsIURI> newURI = DeserializeURI(params);
+    if (!newURI) {
+      return IPC_FAIL_NO_REASON(this);
+    }
+    if (history) {
+      history->RegisterVisitedCallback(newURI, nullptr);
+    }
   }
   return IPC_OK();
 }
@@ -984,7 +984,7 @@ private:
 
   virtual mozilla::ipc::IPCResult RecvGetShowPasswordSetting(bool* showPassword) override;
 
-  virtual mozilla::ipc::IPCResult RecvStartVisitedQuery(const URIParams& uri) override;
+  virtual mozilla::ipc::IPCResult RecvStartVisitedQueries(nsTArray<URIParams>&& uris) override;
 
   virtual mozilla::ipc::IPCResult RecvVisitURI(const URIParams& uri,
                                                const OptionalURIParams& referrer,
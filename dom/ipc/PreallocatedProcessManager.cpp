@@ -147,8 +147,12 @@ PreallocatedProcessManagerImpl::Observe(nsISupports* aSubject,
 void
 PreallocatedProcessManagerImpl::RereadPrefs()
 {
+  // Keeping a warm spare is on by default whenever e10s is: a preallocated
+  // process has already paid for exec, XPCOM startup, and pref delivery by
+  // the time a new tab asks for it, which takes process launch off the
+  // new-tab critical path.
   if (mozilla::BrowserTabsRemoteAutostart() &&
-      Preferences::GetBool("dom.ipc.processPrelaunch.enabled")) {
+      Preferences::GetBool("dom.ipc.processPrelaunch.enabled", true)) {
     Enable();
   } else {
     Disable();
@@ -0,0 +1,66 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioSampleFormat.h"
+
+#include "mozilla/SSE.h"
+#include "mozilla/arm.h"
+
+#ifdef USE_SSE2
+#include "AudioSampleFormatSSE2.h"
+#endif
+
+#ifdef BUILD_ARM_NEON
+#include "AudioSampleFormatNEON.h"
+#endif
+
+namespace mozilla {
+
+void
+ConvertAudioSamples(const int16_t* aFrom, float* aTo, int aCount)
+{
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    ConvertAudioSamples_SSE(aFrom, aTo, aCount);
+    return;
+  }
+#endif
+
+#ifdef BUILD_ARM_NEON
+  if (mozilla::supports_neon()) {
+    ConvertAudioSamples_NEON(aFrom, aTo, aCount);
+    return;
+  }
+#endif
+
+  for (int i = 0; i < aCount; ++i) {
+    aTo[i] = AudioSampleToFloat(aFrom[i]);
+  }
+}
+
+void
+ConvertAudioSamples(const float* aFrom, int16_t* aTo, int aCount)
+{
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    ConvertAudioSamples_SSE(aFrom, aTo, aCount);
+    return;
+  }
+#endif
+
+#ifdef BUILD_ARM_NEON
+  if (mozilla::supports_neon()) {
+    ConvertAudioSamples_NEON(aFrom, aTo, aCount);
+    return;
+  }
+#endif
+
+  for (int i = 0; i < aCount; ++i) {
+    aTo[i] = FloatToAudioSample<int16_t>(aFrom[i]);
+  }
+}
+
+} // namespace mozilla
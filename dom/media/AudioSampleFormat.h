@@ -191,6 +191,12 @@ ConvertAudioSamples(const float* aFrom, float* aTo, int aCount)
 {
   memcpy(aTo, aFrom, sizeof(*aTo)*aCount);
 }
+// The int16_t <-> float conversions are out of line so that they can
+// dispatch to SIMD kernels at runtime; see AudioSampleFormat.cpp.
+void
+ConvertAudioSamples(const int16_t* aFrom, float* aTo, int aCount);
+void
+ConvertAudioSamples(const float* aFrom, int16_t* aTo, int aCount);
 
 // Sample buffer conversion with scale
 
@@ -0,0 +1,48 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioSampleFormatNEON.h"
+#include "AudioSampleFormat.h"
+#include <arm_neon.h>
+
+namespace mozilla {
+
+void
+ConvertAudioSamples_NEON(const int16_t* aFrom, float* aTo, int aCount)
+{
+  const float32x4_t scale = vmovq_n_f32(1.0f / 32768.0f);
+
+  int i = 0;
+  for (; i + 8 <= aCount; i += 8) {
+    int16x8_t in = vld1q_s16(&aFrom[i]);
+    int32x4_t lo = vmovl_s16(vget_low_s16(in));
+    int32x4_t hi = vmovl_s16(vget_high_s16(in));
+    vst1q_f32(&aTo[i], vmulq_f32(vcvtq_f32_s32(lo), scale));
+    vst1q_f32(&aTo[i + 4], vmulq_f32(vcvtq_f32_s32(hi), scale));
+  }
+  for (; i < aCount; ++i) {
+    aTo[i] = AudioSampleToFloat(aFrom[i]);
+  }
+}
+
+void
+ConvertAudioSamples_NEON(const float* aFrom, int16_t* aTo, int aCount)
+{
+  const float32x4_t scale = vmovq_n_f32(32768.0f);
+
+  int i = 0;
+  for (; i + 8 <= aCount; i += 8) {
+    // vcvtq truncates towards zero and saturates, and vqmovn narrows with
+    // saturation, together matching the scalar clamp-and-cast.
+    int32x4_t lo = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&aFrom[i]), scale));
+    int32x4_t hi = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&aFrom[i + 4]), scale));
+    vst1q_s16(&aTo[i], vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+  }
+  for (; i < aCount; ++i) {
+    aTo[i] = FloatToAudioSample<int16_t>(aFrom[i]);
+  }
+}
+
+} // namespace mozilla
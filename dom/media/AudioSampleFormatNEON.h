@@ -0,0 +1,14 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+namespace mozilla {
+void
+ConvertAudioSamples_NEON(const int16_t* aFrom, float* aTo, int aCount);
+
+void
+ConvertAudioSamples_NEON(const float* aFrom, int16_t* aTo, int aCount);
+} // namespace mozilla
@@ -0,0 +1,57 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioSampleFormatSSE2.h"
+#include "AudioSampleFormat.h"
+#include <emmintrin.h>
+
+namespace mozilla {
+
+void
+ConvertAudioSamples_SSE(const int16_t* aFrom, float* aTo, int aCount)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+
+  int i = 0;
+  for (; i + 8 <= aCount; i += 8) {
+    __m128i in =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(&aFrom[i]));
+    // Sign-extend the 16 bits values to 32 bits by unpacking against
+    // themselves and shifting the high halves back down.
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+    _mm_storeu_ps(&aTo[i], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(&aTo[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  for (; i < aCount; ++i) {
+    aTo[i] = AudioSampleToFloat(aFrom[i]);
+  }
+}
+
+void
+ConvertAudioSamples_SSE(const float* aFrom, int16_t* aTo, int aCount)
+{
+  const __m128 scale = _mm_set1_ps(32768.0f);
+  const __m128 vmin = _mm_set1_ps(-32768.0f);
+  const __m128 vmax = _mm_set1_ps(32767.0f);
+
+  int i = 0;
+  for (; i + 8 <= aCount; i += 8) {
+    __m128 lo = _mm_mul_ps(_mm_loadu_ps(&aFrom[i]), scale);
+    __m128 hi = _mm_mul_ps(_mm_loadu_ps(&aFrom[i + 4]), scale);
+    // The operand order makes min/max return the bound for NaN inputs,
+    // matching the scalar std::min/std::max clamp.
+    lo = _mm_max_ps(_mm_min_ps(lo, vmax), vmin);
+    hi = _mm_max_ps(_mm_min_ps(hi, vmax), vmin);
+    // cvttps truncates towards zero like the scalar int16_t cast.
+    __m128i out = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&aTo[i]), out);
+  }
+  for (; i < aCount; ++i) {
+    aTo[i] = FloatToAudioSample<int16_t>(aFrom[i]);
+  }
+}
+
+} // namespace mozilla
@@ -39,6 +39,12 @@ public:
   // cache size allows.
   virtual void ThrottleReadahead(bool bThrottle) {}
 
+  // Hint that the reader is likely to seek to aOffset soon, e.g. a chapter
+  // boundary, so the cache can retain data around that offset. Pass -1 to
+  // clear the hint. The default implementation does nothing as not all
+  // resources are backed by a cache.
+  virtual void NotifyUpcomingSeekTarget(int64_t aOffset) {}
+
   // This is the client's estimate of the playback rate assuming
   // the media plays continuously. The cache can't guess this itself
   // because it doesn't know when the decoder was paused, buffering, etc.
@@ -48,10 +48,12 @@ VP9Benchmark::IsVP9DecodeFast()
 #if defined(MOZ_WIDGET_ANDROID) || defined(MOZ_APPLEMEDIA)
   return false;
 #else
-  bool hasPref = Preferences::HasUserValue(sBenchmarkFpsPref);
-  uint32_t hadRecentUpdate = Preferences::GetUint(sBenchmarkFpsVersionCheck, 0U);
+  NS_NAMED_LITERAL_CSTRING(codecName, "vp9");
+  Maybe<BenchmarkResult> storedResult = Benchmark::GetStoredResult(codecName);
 
-  if (!sHasRunTest && (!hasPref || hadRecentUpdate != sBenchmarkVersionID)) {
+  if (!sHasRunTest &&
+      (!storedResult ||
+       !Benchmark::IsStoredResultCurrent(codecName, sBenchmarkVersionID))) {
     sHasRunTest = true;
 
     RefPtr<WebMDemuxer> demuxer = new WebMDemuxer(
@@ -67,31 +69,33 @@ VP9Benchmark::IsVP9DecodeFast()
                     });
     estimiser->Run()->Then(
       SystemGroup::AbstractMainThreadFor(TaskCategory::Other), __func__,
-      [](uint32_t aDecodeFps) {
+      [](const BenchmarkResult& aResult) {
         if (XRE_IsContentProcess()) {
           dom::ContentChild* contentChild = dom::ContentChild::GetSingleton();
           if (contentChild) {
             contentChild->SendNotifyBenchmarkResult(NS_LITERAL_STRING("VP9"),
-                                                    aDecodeFps);
+                                                    aResult.mDecodeFps);
           }
         } else {
-          Preferences::SetUint(sBenchmarkFpsPref, aDecodeFps);
-          Preferences::SetUint(sBenchmarkFpsVersionCheck, sBenchmarkVersionID);
+          Benchmark::StoreResult(NS_LITERAL_CSTRING("vp9"), aResult,
+                                 sBenchmarkVersionID);
         }
-        Telemetry::Accumulate(Telemetry::HistogramID::VIDEO_VP9_BENCHMARK_FPS, aDecodeFps);
+        Telemetry::Accumulate(Telemetry::HistogramID::VIDEO_VP9_BENCHMARK_FPS,
+                              aResult.mDecodeFps);
       },
       []() { });
   }
 
-  if (!hasPref) {
+  // A stale result is refreshed by the run above, but still answers the
+  // current query, as it did before the benchmark was updated.
+  if (!storedResult) {
     return false;
   }
 
-  uint32_t decodeFps = Preferences::GetUint(sBenchmarkFpsPref);
   uint32_t threshold =
     Preferences::GetUint("media.benchmark.vp9.threshold", 150);
 
-  return decodeFps >= threshold;
+  return storedResult->mDecodeFps >= threshold;
 #endif
 }
 
@@ -123,11 +127,65 @@ Benchmark::Run()
 }
 
 void
-Benchmark::ReturnResult(uint32_t aDecodeFps)
+Benchmark::ReturnResult(const BenchmarkResult& aResult)
 {
   MOZ_ASSERT(OnThread());
 
-  mPromise.ResolveIfExists(aDecodeFps, __func__);
+  mPromise.ResolveIfExists(aResult, __func__);
+}
+
+static nsCString
+BenchmarkPrefName(const nsACString& aCodecName, const char* aLeaf)
+{
+  nsCString pref(NS_LITERAL_CSTRING("media.benchmark."));
+  pref.Append(aCodecName);
+  pref.Append('.');
+  pref.Append(aLeaf);
+  return pref;
+}
+
+/* static */ void
+Benchmark::StoreResult(const nsACString& aCodecName,
+                       const BenchmarkResult& aResult,
+                       uint32_t aVersionID)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  Preferences::SetUint(BenchmarkPrefName(aCodecName, "fps").get(),
+                       aResult.mDecodeFps);
+  Preferences::SetUint(
+    BenchmarkPrefName(aCodecName, "first-frame-latency-ms").get(),
+    aResult.mFirstFrameLatencyMs);
+  Preferences::SetUint(BenchmarkPrefName(aCodecName, "versioncheck").get(),
+                       aVersionID);
+}
+
+/* static */ Maybe<BenchmarkResult>
+Benchmark::GetStoredResult(const nsACString& aCodecName)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  nsCString fpsPref = BenchmarkPrefName(aCodecName, "fps");
+  if (!Preferences::HasUserValue(fpsPref.get())) {
+    return Nothing();
+  }
+  BenchmarkResult result;
+  result.mDecodeFps = Preferences::GetUint(fpsPref.get());
+  result.mFirstFrameLatencyMs = Preferences::GetUint(
+    BenchmarkPrefName(aCodecName, "first-frame-latency-ms").get());
+  return Some(result);
+}
+
+/* static */ bool
+Benchmark::IsStoredResultCurrent(const nsACString& aCodecName,
+                                 uint32_t aVersionID)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  return Preferences::GetUint(
+           BenchmarkPrefName(aCodecName, "versioncheck").get(), 0U) ==
+         aVersionID;
 }
 
 void
@@ -285,6 +343,9 @@ BenchmarkPlayback::Output(const MediaDataDecoder::DecodedData& aResults)
 {
   MOZ_ASSERT(OnThread());
   RefPtr<Benchmark> ref(mMainThreadState);
+  if (!mFirstFrameLatency && aResults.Length() && mFirstSampleTime) {
+    mFirstFrameLatency = Some(TimeStamp::Now() - mFirstSampleTime.ref());
+  }
   mFrameCount += aResults.Length();
   if (!mDecodeStartTime && mFrameCount >= ref->mParameters.mStartupFrame) {
     mDecodeStartTime = Some(TimeStamp::Now());
@@ -295,11 +356,14 @@ BenchmarkPlayback::Output(const MediaDataDecoder::DecodedData& aResults)
   if (!mFinished &&
       (((frames == ref->mParameters.mFramesToMeasure) && frames > 0) ||
        elapsedTime >= ref->mParameters.mTimeout || mDrained)) {
-    uint32_t decodeFps = frames / elapsedTime.ToSeconds();
+    BenchmarkResult result;
+    result.mDecodeFps = frames / elapsedTime.ToSeconds();
+    result.mFirstFrameLatencyMs =
+      uint32_t(mFirstFrameLatency.refOr(TimeDuration()).ToMilliseconds());
     MainThreadShutdown();
     ref->Dispatch(
-      NS_NewRunnableFunction("BenchmarkPlayback::Output", [ref, decodeFps]() {
-        ref->ReturnResult(decodeFps);
+      NS_NewRunnableFunction("BenchmarkPlayback::Output", [ref, result]() {
+        ref->ReturnResult(result);
       }));
   }
 }
@@ -312,6 +376,9 @@ BenchmarkPlayback::InputExhausted()
     return;
   }
   RefPtr<Benchmark> ref(mMainThreadState);
+  if (!mFirstSampleTime) {
+    mFirstSampleTime = Some(TimeStamp::Now());
+  }
   mDecoder->Decode(mSamples[mSampleIndex])
     ->Then(Thread(), __func__,
            [ref, this](const MediaDataDecoder::DecodedData& aResults) {
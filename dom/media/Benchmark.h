@@ -14,12 +14,26 @@
 #include "mozilla/RefPtr.h"
 #include "mozilla/TimeStamp.h"
 #include "nsCOMPtr.h"
+#include "nsString.h"
 
 namespace mozilla {
 
 class TaskQueue;
 class Benchmark;
 
+/**
+ * The outcome of a decode benchmark run.
+ */
+struct BenchmarkResult
+{
+  // Average decode rate, in frames per second, measured from
+  // Parameters::mStartupFrame onwards.
+  uint32_t mDecodeFps = 0;
+  // Time between the first sample being handed to the decoder and the first
+  // decoded frame being output, in milliseconds.
+  uint32_t mFirstFrameLatencyMs = 0;
+};
+
 class BenchmarkPlayback : public QueueObject
 {
   friend class Benchmark;
@@ -43,6 +57,10 @@ class BenchmarkPlayback : public QueueObject
   nsTArray<RefPtr<MediaRawData>> mSamples;
   size_t mSampleIndex;
   Maybe<TimeStamp> mDecodeStartTime;
+  // When the first sample was handed to the decoder.
+  Maybe<TimeStamp> mFirstSampleTime;
+  // Time taken by the decoder to output its first frame.
+  Maybe<TimeDuration> mFirstFrameLatency;
   uint32_t mFrameCount;
   bool mFinished;
   bool mDrained;
@@ -81,7 +99,8 @@ public:
     const TimeDuration mTimeout;
   };
 
-  typedef MozPromise<uint32_t, bool, /* IsExclusive = */ true> BenchmarkPromise;
+  typedef MozPromise<BenchmarkResult, bool, /* IsExclusive = */ true>
+    BenchmarkPromise;
 
   explicit Benchmark(MediaDataDemuxer* aDemuxer,
                      const Parameters& aParameters = Parameters());
@@ -89,10 +108,26 @@ public:
 
   static void Init();
 
+  /**
+   * Benchmark results are persisted in preferences under
+   * media.benchmark.<codec>.* so that playback code can consult past
+   * measurements at startup instead of re-running a benchmark. aVersionID
+   * identifies the revision of the benchmark that produced a result; a
+   * stored result is stale once the benchmark changes enough to bump it.
+   * Main thread only. Content processes cannot store results directly and
+   * relay them to the parent via PContent::NotifyBenchmarkResult.
+   */
+  static void StoreResult(const nsACString& aCodecName,
+                          const BenchmarkResult& aResult,
+                          uint32_t aVersionID);
+  static Maybe<BenchmarkResult> GetStoredResult(const nsACString& aCodecName);
+  static bool IsStoredResultCurrent(const nsACString& aCodecName,
+                                    uint32_t aVersionID);
+
 private:
   friend class BenchmarkPlayback;
   virtual ~Benchmark();
-  void ReturnResult(uint32_t aDecodeFps);
+  void ReturnResult(const BenchmarkResult& aResult);
   void Dispose();
   const Parameters mParameters;
   RefPtr<Benchmark> mKeepAliveUntilComplete;
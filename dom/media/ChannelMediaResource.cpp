@@ -653,6 +653,12 @@ ChannelMediaResource::ThrottleReadahead(bool bThrottle)
   mCacheStream.ThrottleReadahead(bThrottle);
 }
 
+void
+ChannelMediaResource::NotifyUpcomingSeekTarget(int64_t aOffset)
+{
+  mCacheStream.NotifyUpcomingSeekTarget(aOffset);
+}
+
 int64_t ChannelMediaResource::Tell()
 {
   return mCacheStream.Tell();
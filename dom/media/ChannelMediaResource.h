@@ -112,6 +112,8 @@ public:
 
   void ThrottleReadahead(bool bThrottle) override;
 
+  void NotifyUpcomingSeekTarget(int64_t aOffset) override;
+
   // Main thread
   nsresult Open(nsIStreamListener** aStreamListener) override;
   nsresult Close() override;
@@ -52,6 +52,16 @@ static const int64_t SEEK_VS_READ_THRESHOLD = 1 * 1024 * 1024;
 // they don't monopolize the cache.
 static const double NONSEEKABLE_READAHEAD_MAX = 0.5;
 
+// A seek further than this much playback time (at the observed playback
+// rate) counts as a "distant" seek. Each distant seek observed on a stream
+// halves its readahead window, since readahead data is mostly wasted on a
+// reader that skips around, and each DISTANT_SEEK_DECAY_BLOCKS cached blocks
+// consumed sequentially undoes one halving.
+static const int64_t DISTANT_SEEK_THRESHOLD_SECONDS = 1;
+static const uint32_t DISTANT_SEEK_DECAY_BLOCKS = 32;
+// The most halvings a stream's readahead window can accumulate.
+static const uint32_t DISTANT_SEEK_COUNT_MAX = 3;
+
 // Data N seconds before the current playback position is given the same priority
 // as data REPLAY_PENALTY_FACTOR*N seconds ahead of the current playback
 // position. REPLAY_PENALTY_FACTOR is greater than 1 to reflect that
@@ -1139,6 +1149,21 @@ MediaCache::PredictNextUse(TimeStamp aNow, int32_t aBlock)
       NS_ERROR("Invalid class for predicting next use");
       return TimeDuration(0);
     }
+    // A pending seek-target hint makes data blocks at and after the hinted
+    // offset valuable regardless of their distance from the current read
+    // position: predict their use as if playback were already at the target.
+    if (bo->mStream->mSeekTargetHint >= 0 && bo->mClass != METADATA_BLOCK) {
+      int64_t bytesAheadOfHint =
+        static_cast<int64_t>(bo->mStreamBlock)*BLOCK_SIZE -
+        bo->mStream->mSeekTargetHint;
+      if (bytesAheadOfHint >= 0) {
+        TimeDuration hintPrediction = TimeDuration::FromMilliseconds(
+          std::min<int64_t>(
+            bytesAheadOfHint*1000/bo->mStream->mPlaybackBytesPerSecond,
+            INT32_MAX));
+        prediction = std::min(prediction, hintPrediction);
+      }
+    }
     if (i == 0 || prediction < result) {
       result = prediction;
     }
@@ -1391,8 +1416,13 @@ MediaCache::Update()
           LOG("Stream %p avoiding wakeup since more data is not needed", stream);
           enableReading = false;
         } else if (stream->mThrottleReadahead &&
-                   predictedNewDataUse.ToSeconds() > readaheadLimit) {
-          // Don't read ahead more than this much
+                   predictedNewDataUse.ToSeconds() >
+                     (readaheadLimit >>
+                      std::min(stream->mDistantSeekCount,
+                               DISTANT_SEEK_COUNT_MAX))) {
+          // Don't read ahead more than this much. Streams whose reader has
+          // recently been seeking around get a smaller window, since their
+          // readahead is likely to be wasted.
           LOG("Stream %p throttling to avoid reading ahead too far", stream);
           enableReading = false;
         } else if (freeBlockCount > 0) {
@@ -2397,6 +2427,18 @@ MediaCacheStream::Seek(int32_t aWhence, int64_t aOffset)
   }
   mStreamOffset = newOffset;
 
+  if (mSeekTargetHint >= 0 &&
+      std::abs(newOffset - mSeekTargetHint) < BLOCK_SIZE) {
+    // The hinted seek has arrived.
+    mSeekTargetHint = -1;
+  }
+  if (std::abs(newOffset - oldOffset) >
+      int64_t(mPlaybackBytesPerSecond) * DISTANT_SEEK_THRESHOLD_SECONDS &&
+      mDistantSeekCount < DISTANT_SEEK_COUNT_MAX) {
+    ++mDistantSeekCount;
+  }
+  mBlocksUsedSinceLastSeek = 0;
+
   LOG("Stream %p Seek to %" PRId64, this, mStreamOffset);
   mMediaCache->NoteSeek(this, oldOffset);
 
@@ -2416,6 +2458,27 @@ MediaCacheStream::ThrottleReadahead(bool bThrottle)
   }
 }
 
+void
+MediaCacheStream::NotifyUpcomingSeekTarget(int64_t aOffset)
+{
+  ReentrantMonitorAutoEnter mon(mMediaCache->GetReentrantMonitor());
+  if (mClosed) {
+    return;
+  }
+  LOG("Stream %p hinting upcoming seek to %" PRId64, this, aOffset);
+  mSeekTargetHint = aOffset;
+  mMediaCache->QueueUpdate();
+}
+
+void
+MediaCacheStream::GetBlockReadCounts(uint32_t* aCacheHits,
+                                     uint32_t* aCacheMisses)
+{
+  ReentrantMonitorAutoEnter mon(mMediaCache->GetReentrantMonitor());
+  *aCacheHits = mCacheHitCount;
+  *aCacheMisses = mCacheMissCount;
+}
+
 int64_t
 MediaCacheStream::Tell()
 {
@@ -2437,6 +2500,9 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
   auto streamOffset = mStreamOffset;
 
   uint32_t count = 0;
+  // The last stream block counted as a cache miss, so a block that needs
+  // several waits for its data is only counted once.
+  int32_t lastBlockMissed = -1;
   // Read one block (or part of a block) at a time
   while (count < aCount) {
     int32_t streamBlock = OffsetToBlockIndex(streamOffset);
@@ -2496,12 +2562,17 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
         if (mCurrentMode == MODE_METADATA) {
           streamWithPartialBlock->mMetadataInPartialBlockBuffer = true;
         }
+        ++mCacheHitCount;
         streamOffset += bytes;
         count = bytes;
         break;
       }
 
       // No data has been read yet, so block
+      if (streamBlock != lastBlockMissed) {
+        ++mCacheMissCount;
+        lastBlockMissed = streamBlock;
+      }
       mon.Wait();
       if (mClosed) {
         // We may have successfully read some data, but let's just throw
@@ -2513,6 +2584,17 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
 
     mMediaCache->NoteBlockUsage(
       this, cacheBlock, streamOffset, mCurrentMode, TimeStamp::Now());
+    if (streamBlock != lastBlockMissed) {
+      ++mCacheHitCount;
+    }
+    if (++mBlocksUsedSinceLastSeek >= DISTANT_SEEK_DECAY_BLOCKS) {
+      // The reader has settled into sequential playback; let its readahead
+      // window grow back.
+      if (mDistantSeekCount > 0) {
+        --mDistantSeekCount;
+      }
+      mBlocksUsedSinceLastSeek = 0;
+    }
 
     int64_t offset = cacheBlock*BLOCK_SIZE + offsetInStreamBlock;
     int32_t bytes;
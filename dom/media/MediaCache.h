@@ -351,6 +351,19 @@ public:
 
   void ThrottleReadahead(bool bThrottle);
 
+  // Hint that the reader is likely to seek to aOffset soon, e.g. a chapter
+  // boundary the player expects the user to jump to. Cached blocks at and
+  // after the hinted offset are predicted to be needed soon, so they are
+  // retained in preference to other overflowing data. Pass -1 to clear the
+  // hint; it also clears automatically once a seek lands within a block of
+  // the target. Can be called on any thread.
+  void NotifyUpcomingSeekTarget(int64_t aOffset);
+
+  // The number of block reads served from cached data and the number that
+  // had to block waiting for the channel, since this stream was created.
+  // Exposed for tuning the cache heuristics. Can be called on any thread.
+  void GetBlockReadCounts(uint32_t* aCacheHits, uint32_t* aCacheMisses);
+
   size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const;
 
   // Update mPrincipal for all streams of the same resource given that data has
@@ -503,6 +516,22 @@ private:
 
   bool mThrottleReadahead = false;
 
+  // Offset the reader expects to seek to soon, or -1 if no hint is active.
+  // See NotifyUpcomingSeekTarget().
+  int64_t mSeekTargetHint = -1;
+  // The number of distant seeks observed on this stream. Grows in Seek()
+  // and decays again after sustained sequential reading; MediaCache::Update()
+  // shrinks the readahead window of streams with a high count, since their
+  // readahead is mostly wasted.
+  uint32_t mDistantSeekCount = 0;
+  // Cached blocks consumed since the last seek, used to decay
+  // mDistantSeekCount.
+  uint32_t mBlocksUsedSinceLastSeek = 0;
+  // The number of block reads served from cached data, and the number that
+  // had to block waiting for data from the channel.
+  uint32_t mCacheHitCount = 0;
+  uint32_t mCacheMissCount = 0;
+
   // Data received for the block containing mChannelOffset. Data needs
   // to wait here so we can write back a complete block. The first
   // mChannelOffset%BLOCK_SIZE bytes have been filled in with good data,
@@ -1669,7 +1669,10 @@ MediaFormatReader::DoDemuxVideo()
 {
   using SamplesPromise = MediaTrackDemuxer::SamplesPromise;
 
-  auto p = mVideo.mTrackDemuxer->GetSamples(1);
+  // Pull a batch of samples per demuxer call to amortize the trip to the
+  // demuxer's task queue; demuxers may still return fewer samples.
+  auto p = mVideo.mTrackDemuxer->GetSamples(
+    std::max<int32_t>(1, MediaPrefs::MFRDemuxBatchSize()));
 
   if (mVideo.mFirstDemuxedSampleTime.isNothing()) {
     RefPtr<MediaFormatReader> self = this;
@@ -1745,7 +1748,8 @@ MediaFormatReader::DoDemuxAudio()
 {
   using SamplesPromise = MediaTrackDemuxer::SamplesPromise;
 
-  auto p = mAudio.mTrackDemuxer->GetSamples(1);
+  auto p = mAudio.mTrackDemuxer->GetSamples(
+    std::max<int32_t>(1, MediaPrefs::MFRDemuxBatchSize()));
 
   if (mAudio.mFirstDemuxedSampleTime.isNothing()) {
     RefPtr<MediaFormatReader> self = this;
@@ -1868,7 +1872,9 @@ bool
 MediaFormatReader::NeedInput(DecoderData& aDecoder)
 {
   // The decoder will not be fed a new raw sample until the current decoding
-  // requests has completed.
+  // request has completed, but we can keep demuxing ahead while it runs so
+  // that the next sample is ready the moment the decoder becomes free,
+  // bounded by media.decoder.demux-queue-depth.
   return
     (aDecoder.HasPromise() || aDecoder.mTimeThreshold.isSome()) &&
     !aDecoder.HasPendingDrain() &&
@@ -1876,7 +1882,8 @@ MediaFormatReader::NeedInput(DecoderData& aDecoder)
     !aDecoder.mDemuxRequest.Exists() &&
     !aDecoder.mOutput.Length() &&
     !aDecoder.HasInternalSeekPending() &&
-    !aDecoder.mDecodeRequest.Exists();
+    (!aDecoder.mDecodeRequest.Exists() ||
+     aDecoder.mQueuedSamples.Length() < MediaPrefs::MFRDemuxQueueDepth());
 }
 
 void
@@ -1985,8 +1992,8 @@ MediaFormatReader::RequestDemuxSamples(TrackType aTrack)
   auto& decoder = GetDecoderData(aTrack);
   MOZ_ASSERT(!decoder.mDemuxRequest.Exists());
 
-  if (!decoder.mQueuedSamples.IsEmpty()) {
-    // No need to demux new samples.
+  if (!decoder.mQueuedSamples.IsEmpty() && !decoder.mDecodeRequest.Exists()) {
+    // No need to demux new samples; the queued ones are about to be consumed.
     return;
   }
 
@@ -2047,6 +2054,12 @@ MediaFormatReader::HandleDemuxedSamples(
     return;
   }
 
+  if (decoder.mDecodeRequest.Exists()) {
+    // The decoder is busy; the queued samples will be fed once the current
+    // decode completes.
+    return;
+  }
+
   if (decoder.mQueuedSamples.IsEmpty()) {
     return;
   }
@@ -13,7 +13,9 @@
 #include "nsIObserver.h"
 #include "nsPrintfCString.h"
 #include "nsServiceManagerUtils.h"
+#include "nsThreadUtils.h"
 #include "prerror.h"
+#include "prsystem.h"
 #include "mozilla/Logging.h"
 #include "mozilla/Attributes.h"
 #include "TrackUnionStream.h"
@@ -21,6 +23,7 @@
 #include "AudioCaptureStream.h"
 #include "AudioNodeStream.h"
 #include "AudioNodeExternalInputStream.h"
+#include "MediaPrefs.h"
 #include "MediaStreamListener.h"
 #include "MediaStreamVideoSink.h"
 #include "mozilla/dom/BaseAudioContextBinding.h"
@@ -761,6 +764,75 @@ MediaStreamGraphImpl::UpdateStreamOrder()
   }
 
   MOZ_ASSERT(orderedStreamCount == mFirstCycleBreaker);
+
+  UpdateProcessingGroups();
+}
+
+void
+MediaStreamGraphImpl::UpdateProcessingGroups()
+{
+  // Union-find over the ordered streams, with MediaStream::mProcessingGroup
+  // temporarily holding the index in mStreams of the stream's parent in its
+  // component tree. A stream whose slot holds its own index is a root.
+  mHasAudioNodeStream = false;
+  for (uint32_t i = 0; i < mStreams.Length(); ++i) {
+    mStreams[i]->mProcessingGroup = i;
+    if (mStreams[i]->AsAudioNodeStream()) {
+      mHasAudioNodeStream = true;
+    }
+  }
+
+  auto findRoot = [this](MediaStream* aStream) {
+    uint32_t i = aStream->mProcessingGroup;
+    while (mStreams[i]->mProcessingGroup != i) {
+      // Path halving keeps the trees shallow.
+      uint32_t parent = mStreams[i]->mProcessingGroup;
+      mStreams[i]->mProcessingGroup = mStreams[parent]->mProcessingGroup;
+      i = mStreams[i]->mProcessingGroup;
+    }
+    return i;
+  };
+
+  // Every input port joins its source and destination streams into the same
+  // component. Unioning through SourceMediaStreams as well means that two
+  // consumers of the same source always land in the same group, so streams
+  // in different groups share no track data at all.
+  for (MediaStream* stream : mStreams) {
+    ProcessedMediaStream* ps = stream->AsProcessedStream();
+    if (!ps) {
+      continue;
+    }
+    for (MediaInputPort* port : ps->mInputs) {
+      if (port->mSource->IsSuspended()) {
+        // Suspended sources are not in mStreams and produce no data.
+        continue;
+      }
+      uint32_t from = findRoot(port->mSource);
+      uint32_t to = findRoot(ps);
+      if (from != to) {
+        // Union by index so that each component's root is its earliest
+        // stream in processing order.
+        mStreams[std::max(from, to)]->mProcessingGroup = std::min(from, to);
+      }
+    }
+  }
+
+  // Resolve every stream's root before relabelling, since relabelling
+  // overloads mProcessingGroup with group numbers.
+  AutoTArray<uint32_t, 32> roots;
+  roots.SetCapacity(mStreams.Length());
+  for (MediaStream* stream : mStreams) {
+    roots.AppendElement(findRoot(stream));
+  }
+
+  mProcessingGroupCount = 0;
+  for (uint32_t i = 0; i < mStreams.Length(); ++i) {
+    // Roots precede the other members of their component, so the root's
+    // group number is already assigned when its members are relabelled.
+    mStreams[i]->mProcessingGroup = (roots[i] == i)
+                                    ? mProcessingGroupCount++
+                                    : mStreams[roots[i]]->mProcessingGroup;
+  }
 }
 
 void
@@ -1243,6 +1315,76 @@ MediaStreamGraphImpl::ProduceDataForStreamsBlockByBlock(uint32_t aStreamIndex,
                "Something went wrong with rounding to block boundaries");
 }
 
+void
+MediaStreamGraphImpl::ProcessStreamGroup(uint32_t aGroup)
+{
+  for (MediaStream* stream : mStreams) {
+    if (stream->mProcessingGroup != aGroup) {
+      continue;
+    }
+    ProcessedMediaStream* ps = stream->AsProcessedStream();
+    if (ps) {
+      ps->ProcessInput(mProcessedTime, mStateComputedTime,
+                       ProcessedMediaStream::ALLOW_FINISH);
+      NS_ASSERTION(stream->mTracks.GetEnd() >=
+                   GraphTimeToStreamTimeWithBlocking(stream, mStateComputedTime),
+                   "Stream did not produce enough data");
+    }
+  }
+}
+
+void
+MediaStreamGraphImpl::ProduceDataInParallel()
+{
+  MOZ_ASSERT(!mHasAudioNodeStream);
+  MOZ_ASSERT(mProcessingGroupCount > 1);
+
+  if (!mProcessingPool) {
+    uint32_t threads =
+      std::max<int32_t>(PR_GetNumberOfProcessors() - 1, 1);
+    mProcessingPool =
+      SharedThreadPool::Get(NS_LITERAL_CSTRING("MSG Processing"), threads);
+    if (!mProcessingPool) {
+      for (uint32_t group = 0; group < mProcessingGroupCount; ++group) {
+        ProcessStreamGroup(group);
+      }
+      return;
+    }
+  }
+
+  // The graph thread processes the first group itself while the pool
+  // processes the others, then waits on the barrier so that the playback and
+  // mixing phase only ever sees fully produced streams.
+  Monitor barrier("MSG processing barrier");
+  uint32_t pendingGroups = mProcessingGroupCount - 1;
+
+  for (uint32_t group = 1; group < mProcessingGroupCount; ++group) {
+    nsCOMPtr<nsIRunnable> runnable = NS_NewRunnableFunction(
+      "MediaStreamGraphImpl::ProcessStreamGroup",
+      [this, group, &barrier, &pendingGroups]() {
+        ProcessStreamGroup(group);
+        MonitorAutoLock lock(barrier);
+        if (--pendingGroups == 0) {
+          barrier.Notify();
+        }
+      });
+    if (NS_FAILED(mProcessingPool->Dispatch(runnable.forget(),
+                                            NS_DISPATCH_NORMAL))) {
+      // The pool is shutting down; process this group on the graph thread.
+      ProcessStreamGroup(group);
+      MonitorAutoLock lock(barrier);
+      --pendingGroups;
+    }
+  }
+
+  ProcessStreamGroup(0);
+
+  MonitorAutoLock lock(barrier);
+  while (pendingGroups) {
+    barrier.Wait();
+  }
+}
+
 bool
 MediaStreamGraphImpl::AllFinishedStreamsNotified()
 {
@@ -1357,6 +1499,17 @@ MediaStreamGraphImpl::Process()
 
   mMixer.StartMixing();
 
+  // When the graph consists of several connected components and contains no
+  // AudioNodeStreams, the components share no state and can optionally be
+  // processed concurrently on a thread pool. Playback and mixing below still
+  // happen on the graph thread, after all production has completed.
+  if (MediaPrefs::MSGParallelProcessing() &&
+      !mHasAudioNodeStream &&
+      mProcessingGroupCount > 1) {
+    ProduceDataInParallel();
+    doneAllProducing = true;
+  }
+
   // Figure out what each stream wants to do
   for (uint32_t i = 0; i < mStreams.Length(); ++i) {
     MediaStream* stream = mStreams[i];
@@ -1901,6 +2054,7 @@ MediaStream::MediaStream()
   : mTracksStartTime(0)
   , mStartBlocking(GRAPH_TIME_MAX)
   , mSuspendedCount(0)
+  , mProcessingGroup(0)
   , mFinished(false)
   , mNotifiedFinished(false)
   , mNotifiedBlocked(false)
@@ -621,6 +621,15 @@ protected:
    */
   int32_t mSuspendedCount;
 
+  /**
+   * The connected component of the graph that this stream belongs to,
+   * assigned by MediaStreamGraphImpl::UpdateStreamOrder(). Streams with
+   * different group numbers are joined by no input ports, directly or
+   * indirectly, and so can be processed independently of each other.
+   * Graph thread only.
+   */
+  uint32_t mProcessingGroup;
+
   /**
    * When true, this means the stream will be finished once all
    * buffered data has been consumed.
@@ -13,6 +13,7 @@
 #include "Latency.h"
 #include "mozilla/Monitor.h"
 #include "mozilla/Services.h"
+#include "mozilla/SharedThreadPool.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/UniquePtr.h"
 #include "mozilla/WeakPtr.h"
@@ -334,6 +335,31 @@ public:
    */
   void UpdateStreamOrder();
 
+  /**
+   * Partition mStreams into connected components, assigning
+   * MediaStream::mProcessingGroup on every stream. Called by
+   * UpdateStreamOrder() after the processing order has been recomputed.
+   */
+  void UpdateProcessingGroups();
+
+  /**
+   * Run ProcessInput() on every processed stream in the connected component
+   * aGroup, in processing order.
+   */
+  void ProcessStreamGroup(uint32_t aGroup);
+
+  /**
+   * Run ProcessInput() for all processed streams, farming out all connected
+   * components of the graph but the first to a thread pool and joining them
+   * before returning, so that the playback and mixing phase sees fully
+   * produced data. Requires mProcessingGroupCount > 1 and must not be used
+   * when the graph contains AudioNodeStreams; those are processed block by
+   * block across the whole graph and may queue control messages during
+   * processing, neither of which is compatible with processing off the graph
+   * thread.
+   */
+  void ProduceDataInParallel();
+
   /**
    * Returns smallest value of t such that t is a multiple of
    * WEBAUDIO_BLOCK_SIZE and t > aTime.
@@ -597,6 +623,23 @@ public:
    * cycles.
    */
   uint32_t mFirstCycleBreaker;
+  /**
+   * Number of distinct values taken by MediaStream::mProcessingGroup across
+   * mStreams, as assigned by UpdateProcessingGroups().
+   */
+  uint32_t mProcessingGroupCount = 0;
+  /**
+   * True if any stream in mStreams is an AudioNodeStream. Maintained by
+   * UpdateProcessingGroups().
+   */
+  bool mHasAudioNodeStream = false;
+  /**
+   * Thread pool used by ProduceDataInParallel() to process independent parts
+   * of the graph concurrently when
+   * media.mediastreamgraph.parallel-processing.enabled is set. Created on
+   * demand on the graph thread.
+   */
+  RefPtr<SharedThreadPool> mProcessingPool;
   /**
    * Blocking decisions have been computed up to this time.
    * Between each iteration, this is the same as mProcessedTime.
@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioSampleFormat.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace mozilla;
+
+// Ensure the (possibly SIMD) buffer conversions match the scalar per-sample
+// conversions, including the unvectorized tail of odd-length buffers.
+
+TEST(AudioSampleFormat, Int16ToFloat)
+{
+  std::vector<int16_t> input;
+  for (int i = -32768; i <= 32767; i += 7) {
+    input.push_back(int16_t(i));
+  }
+
+  std::vector<float> output(input.size());
+  ConvertAudioSamples(input.data(), output.data(), int(input.size()));
+
+  for (size_t i = 0; i < input.size(); i++) {
+    EXPECT_EQ(output[i], AudioSampleToFloat(input[i]));
+  }
+}
+
+TEST(AudioSampleFormat, FloatToInt16)
+{
+  std::vector<float> input;
+  // Include out-of-range values that must clamp.
+  for (float v = -1.5f; v <= 1.5f; v += 0.000321f) {
+    input.push_back(v);
+  }
+
+  std::vector<int16_t> output(input.size());
+  ConvertAudioSamples(input.data(), output.data(), int(input.size()));
+
+  for (size_t i = 0; i < input.size(); i++) {
+    EXPECT_EQ(output[i], FloatToAudioSample<int16_t>(input[i]));
+  }
+}
@@ -30,7 +30,10 @@ public:
     mBenchmark->Run()->Then(
       // Non DocGroup-version of AbstractThread::MainThread() is fine for testing.
       AbstractThread::MainThread(), __func__,
-      [&](uint32_t aDecodeFps) { result = aDecodeFps; done = true; },
+      [&](const BenchmarkResult& aResult) {
+        result = aResult.mDecodeFps;
+        done = true;
+      },
       [&]() { done = true; });
 
     // Wait until benchmark completes.
@@ -317,15 +317,19 @@ StorageDBChild::RecvOriginsHavingData(nsTArray<nsCString>&& aOrigins)
 }
 
 mozilla::ipc::IPCResult
-StorageDBChild::RecvLoadItem(const nsCString& aOriginSuffix,
-                             const nsCString& aOriginNoSuffix,
-                             const nsString& aKey,
-                             const nsString& aValue)
+StorageDBChild::RecvLoadItems(const nsCString& aOriginSuffix,
+                              const nsCString& aOriginNoSuffix,
+                              nsTArray<nsString>&& aKeys,
+                              nsTArray<nsString>&& aValues)
 {
+  MOZ_ASSERT(aKeys.Length() == aValues.Length());
+
   LocalStorageCache* aCache =
     mManager->GetCache(aOriginSuffix, aOriginNoSuffix);
   if (aCache) {
-    aCache->LoadItem(aKey, aValue);
+    for (uint32_t i = 0; i < aKeys.Length(); ++i) {
+      aCache->LoadItem(aKeys[i], aValues[i]);
+    }
   }
 
   return IPC_OK();
@@ -900,7 +904,7 @@ class LoadRunnable : public Runnable
 {
 public:
   enum TaskType {
-    loadItem,
+    loadItems,
     loadDone
   };
 
@@ -908,15 +912,15 @@ public:
                TaskType aType,
                const nsACString& aOriginSuffix,
                const nsACString& aOriginNoSuffix,
-               const nsAString& aKey = EmptyString(),
-               const nsAString& aValue = EmptyString())
+               nsTArray<nsString>&& aKeys,
+               nsTArray<nsString>&& aValues)
     : Runnable("dom::LoadRunnable")
     , mParent(aParent)
     , mType(aType)
     , mSuffix(aOriginSuffix)
     , mOrigin(aOriginNoSuffix)
-    , mKey(aKey)
-    , mValue(aValue)
+    , mKeys(Move(aKeys))
+    , mValues(Move(aValues))
   { }
 
   LoadRunnable(StorageDBParent* aParent,
@@ -936,8 +940,8 @@ private:
   RefPtr<StorageDBParent> mParent;
   TaskType mType;
   nsCString mSuffix, mOrigin;
-  nsString mKey;
-  nsString mValue;
+  nsTArray<nsString> mKeys;
+  nsTArray<nsString> mValues;
   nsresult mRv;
 
   NS_IMETHOD Run() override
@@ -948,8 +952,9 @@ private:
 
     switch (mType)
     {
-    case loadItem:
-      mozilla::Unused << mParent->SendLoadItem(mSuffix, mOrigin, mKey, mValue);
+    case loadItems:
+      mozilla::Unused << mParent->SendLoadItems(mSuffix, mOrigin, mKeys,
+                                                mValues);
       break;
     case loadDone:
       mozilla::Unused << mParent->SendLoadDone(mSuffix, mOrigin, mRv);
@@ -966,6 +971,13 @@ private:
 
 // StorageDBParent::CacheParentBridge
 
+// Number of items and number of characters (keys plus values) we accumulate
+// before flushing a LoadItems message to the child. The counts trade fewer
+// messages against the latency of the first items reaching the child and the
+// size of a single message on the channel.
+static const uint32_t kLoadItemsMaxCount = 64;
+static const uint32_t kLoadItemsMaxChars = 128 * 1024;
+
 const nsCString
 StorageDBParent::CacheParentBridge::Origin() const
 {
@@ -982,14 +994,35 @@ StorageDBParent::CacheParentBridge::LoadItem(const nsAString& aKey,
 
   ++mLoadedCount;
 
+  mPendingKeys.AppendElement(aKey);
+  mPendingValues.AppendElement(aValue);
+  mPendingChars += aKey.Length() + aValue.Length();
+
+  if (mPendingKeys.Length() >= kLoadItemsMaxCount ||
+      mPendingChars >= kLoadItemsMaxChars) {
+    FlushItems();
+  }
+
+  return true;
+}
+
+void
+StorageDBParent::CacheParentBridge::FlushItems()
+{
+  if (mPendingKeys.IsEmpty()) {
+    return;
+  }
+
   RefPtr<LoadRunnable> r =
-    new LoadRunnable(mParent, LoadRunnable::loadItem, mOriginSuffix,
-                     mOriginNoSuffix, aKey, aValue);
+    new LoadRunnable(mParent, LoadRunnable::loadItems, mOriginSuffix,
+                     mOriginNoSuffix, Move(mPendingKeys), Move(mPendingValues));
+
+  mPendingKeys.Clear();
+  mPendingValues.Clear();
+  mPendingChars = 0;
 
   MOZ_ALWAYS_SUCCEEDS(
     mOwningEventTarget->Dispatch(r, NS_DISPATCH_NORMAL));
-
-  return true;
 }
 
 void
@@ -1000,6 +1033,8 @@ StorageDBParent::CacheParentBridge::LoadDone(nsresult aRv)
     return;
   }
 
+  FlushItems();
+
   mLoaded = true;
 
   RefPtr<LoadRunnable> r =
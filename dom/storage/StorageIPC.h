@@ -96,10 +96,10 @@ private:
   mozilla::ipc::IPCResult RecvObserve(const nsCString& aTopic,
                                       const nsString& aOriginAttributesPattern,
                                       const nsCString& aOriginScope);
-  mozilla::ipc::IPCResult RecvLoadItem(const nsCString& aOriginSuffix,
-                                       const nsCString& aOriginNoSuffix,
-                                       const nsString& aKey,
-                                       const nsString& aValue);
+  mozilla::ipc::IPCResult RecvLoadItems(const nsCString& aOriginSuffix,
+                                        const nsCString& aOriginNoSuffix,
+                                        nsTArray<nsString>&& aKeys,
+                                        nsTArray<nsString>&& aValues);
   mozilla::ipc::IPCResult RecvLoadDone(const nsCString& aOriginSuffix,
                                        const nsCString& aOriginNoSuffix,
                                        const nsresult& aRv);
@@ -163,7 +163,7 @@ public:
       : mOwningEventTarget(GetCurrentThreadSerialEventTarget())
       , mParent(aParentDB)
       , mOriginSuffix(aOriginSuffix), mOriginNoSuffix(aOriginNoSuffix)
-      , mLoaded(false), mLoadedCount(0) {}
+      , mLoaded(false), mLoadedCount(0), mPendingChars(0) {}
     virtual ~CacheParentBridge() {}
 
     // LocalStorageCacheBridge
@@ -188,11 +188,22 @@ public:
     void
     Destroy();
 
+    // Sends the accumulated items to the child in a single LoadItems
+    // message. Called on the database thread.
+    void
+    FlushItems();
+
     nsCOMPtr<nsISerialEventTarget> mOwningEventTarget;
     RefPtr<StorageDBParent> mParent;
     nsCString mOriginSuffix, mOriginNoSuffix;
     bool mLoaded;
     uint32_t mLoadedCount;
+
+    // Items accumulated on the database thread and flushed to the child in
+    // batches, so a large origin doesn't turn into one IPC message per key.
+    nsTArray<nsString> mPendingKeys;
+    nsTArray<nsString> mPendingValues;
+    uint32_t mPendingChars;
   };
 
   // Fake usage class receiving async callbacks from DB thread
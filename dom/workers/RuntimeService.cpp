@@ -1867,9 +1867,46 @@ RuntimeService::ScheduleWorker(WorkerPrivate* aWorkerPrivate)
     return false;
   }
 
+  // The idle pool is now likely empty.  Idle threads are normally only
+  // replenished when a worker finishes, so pages that spawn short-lived
+  // workers back to back would pay thread creation on every spawn.
+  // Pre-warm a thread for the next worker, off the current spawn path.
+  nsCOMPtr<nsIRunnable> prewarmRunnable =
+    NewRunnableMethod("RuntimeService::PrewarmIdleThread",
+                      this,
+                      &RuntimeService::PrewarmIdleThread);
+  NS_DispatchToMainThread(prewarmRunnable.forget());
+
   return true;
 }
 
+void
+RuntimeService::PrewarmIdleThread()
+{
+  AssertIsOnMainThread();
+
+  if (mShuttingDown) {
+    return;
+  }
+
+  {
+    MutexAutoLock lock(mMutex);
+    if (!mIdleThreadArray.IsEmpty()) {
+      return;
+    }
+  }
+
+  const WorkerThreadFriendKey friendKey;
+  RefPtr<WorkerThread> thread = WorkerThread::Create(friendKey);
+  if (!thread) {
+    return;
+  }
+
+  // The pre-warmed thread goes through the regular idle pool, so it expires
+  // like any other idle thread if no worker shows up to claim it.
+  NoteIdleThread(thread);
+}
+
 // static
 void
 RuntimeService::ShutdownIdleThreads(nsITimer* aTimer, void* /* aClosure */)
@@ -265,6 +265,9 @@ private:
   bool
   ScheduleWorker(WorkerPrivate* aWorkerPrivate);
 
+  void
+  PrewarmIdleThread();
+
   static void
   ShutdownIdleThreads(nsITimer* aTimer, void* aClosure);
 
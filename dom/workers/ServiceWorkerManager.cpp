@@ -2867,6 +2867,27 @@ ServiceWorkerManager::IsAvailable(nsIPrincipal* aPrincipal,
   return registration && registration->GetActive();
 }
 
+void
+ServiceWorkerManager::WarmUpServiceWorker(nsIPrincipal* aPrincipal,
+                                          nsIURI* aURI)
+{
+  MOZ_ASSERT(aPrincipal);
+  MOZ_ASSERT(aURI);
+
+  RefPtr<ServiceWorkerRegistrationInfo> registration =
+    GetServiceWorkerRegistrationInfo(aPrincipal, aURI);
+  if (!registration) {
+    return;
+  }
+
+  ServiceWorkerInfo* active = registration->GetActive();
+  if (!active) {
+    return;
+  }
+
+  active->WorkerPrivate()->SpeculativelyLaunchWorker();
+}
+
 bool
 ServiceWorkerManager::IsControlled(nsIDocument* aDoc, ErrorResult& aRv)
 {
@@ -128,6 +128,12 @@ public:
   bool
   IsAvailable(nsIPrincipal* aPrincipal, nsIURI* aURI);
 
+  // Speculatively launch the active worker of the registration matching
+  // aURI, if any. Called once we have decided to intercept a navigation so
+  // worker startup can proceed while the channel is being set up.
+  void
+  WarmUpServiceWorker(nsIPrincipal* aPrincipal, nsIURI* aURI);
+
   bool
   IsControlled(nsIDocument* aDocument, ErrorResult& aRv);
 
@@ -1894,6 +1894,22 @@ ServiceWorkerPrivate::SpawnWorkerIfNeeded(WakeUpReason aWhy,
   return NS_OK;
 }
 
+void
+ServiceWorkerPrivate::SpeculativelyLaunchWorker()
+{
+  AssertIsOnMainThread();
+
+  // Don't renew the keep alive token for a worker that is already running;
+  // an idle worker should still be terminated on schedule if the expected
+  // event never arrives.
+  if (mWorkerPrivate) {
+    return;
+  }
+
+  Unused << NS_WARN_IF(NS_FAILED(SpawnWorkerIfNeeded(SpeculativeLaunch,
+                                                     nullptr)));
+}
+
 void
 ServiceWorkerPrivate::StoreISupports(nsISupports* aSupports)
 {
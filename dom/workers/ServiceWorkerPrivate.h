@@ -162,6 +162,14 @@ public:
   void
   SetHandlesFetch(bool aValue);
 
+  // Spawns the worker thread ahead of an expected event so that worker
+  // startup overlaps with the rest of the interception machinery instead
+  // of serializing behind it. This is a no-op if the worker is already
+  // running. A speculatively launched worker that never receives an event
+  // is reaped by the normal idle timeout.
+  void
+  SpeculativelyLaunchWorker();
+
 private:
   enum WakeUpReason {
     FetchEvent = 0,
@@ -171,7 +179,8 @@ private:
     NotificationClickEvent,
     NotificationCloseEvent,
     LifeCycleEvent,
-    AttachEvent
+    AttachEvent,
+    SpeculativeLaunch
   };
 
   // Timer callbacks
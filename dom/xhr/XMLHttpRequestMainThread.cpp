@@ -4063,9 +4063,12 @@ ArrayBufferBuilder::setCapacity(uint32_t aNewCap)
     return false;
   }
 
-  if (aNewCap > mCapacity) {
-    memset(newdata + mCapacity, 0, aNewCap - mCapacity);
-  }
+  // Bytes between mLength and mCapacity are never exposed: getArrayBuffer()
+  // shrinks the buffer to mLength before handing it to the JS engine, and
+  // append() only ever writes at mLength.  So there's no need to zero the
+  // newly grown region here; doing so would touch every page of a large
+  // Content-Length preallocation just to have the network data overwrite
+  // them again.
 
   mDataPtr = newdata;
   mCapacity = aNewCap;
@@ -43,6 +43,7 @@ RemoteSpellcheckEngineChild::RecvNotifyOfCurrentDictionary(
   MozPromiseHolder<GenericPromise>* promiseHolder =
     reinterpret_cast<MozPromiseHolder<GenericPromise>*>(aId);
   mOwner->mCurrentDictionary = aDictionary;
+  mOwner->mCheckResultCache.Clear();
   if (aDictionary.IsEmpty()) {
     promiseHolder->RejectIfExists(NS_ERROR_NOT_AVAILABLE, __func__);
   } else {
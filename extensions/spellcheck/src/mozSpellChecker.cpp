@@ -130,6 +130,16 @@ mozSpellChecker::CheckWord(const nsAString &aWord, bool *aIsMisspelled, nsTArray
   nsresult result;
   bool correct;
 
+  // Correct words, and misspelled words when no suggestions were asked for,
+  // can be answered from the cache without consulting the engine (or, in
+  // content processes, the parent) again.
+  bool cachedMisspelled;
+  if (mCheckResultCache.Get(aWord, &cachedMisspelled) &&
+      (!cachedMisspelled || !aSuggestions)) {
+    *aIsMisspelled = cachedMisspelled;
+    return NS_OK;
+  }
+
   if (XRE_IsContentProcess()) {
     nsString wordwrapped = nsString(aWord);
     bool rv;
@@ -138,6 +148,9 @@ mozSpellChecker::CheckWord(const nsAString &aWord, bool *aIsMisspelled, nsTArray
     } else {
       rv = mEngine->SendCheck(wordwrapped, aIsMisspelled);
     }
+    if (rv) {
+      CacheCheckResult(aWord, *aIsMisspelled);
+    }
     return rv ? NS_OK : NS_ERROR_NOT_AVAILABLE;
   }
 
@@ -164,9 +177,19 @@ mozSpellChecker::CheckWord(const nsAString &aWord, bool *aIsMisspelled, nsTArray
     }
     *aIsMisspelled = true;
   }
+  CacheCheckResult(aWord, *aIsMisspelled);
   return NS_OK;
 }
 
+void
+mozSpellChecker::CacheCheckResult(const nsAString &aWord, bool aIsMisspelled)
+{
+  if (mCheckResultCache.Count() >= kMaxCheckResultCacheEntries) {
+    mCheckResultCache.Clear();
+  }
+  mCheckResultCache.Put(aWord, aIsMisspelled);
+}
+
 NS_IMETHODIMP
 mozSpellChecker::Replace(const nsAString &aOldWord, const nsAString &aNewWord, bool aAllOccurrences)
 {
@@ -261,6 +284,7 @@ mozSpellChecker::Replace(const nsAString &aOldWord, const nsAString &aNewWord, b
 NS_IMETHODIMP
 mozSpellChecker::IgnoreAll(const nsAString &aWord)
 {
+  mCheckResultCache.Remove(aWord);
   if(mPersonalDictionary){
     mPersonalDictionary->IgnoreWord(PromiseFlatString(aWord).get());
   }
@@ -274,6 +298,7 @@ mozSpellChecker::AddWordToPersonalDictionary(const nsAString &aWord)
   char16_t empty=0;
   if (!mPersonalDictionary)
     return NS_ERROR_NULL_POINTER;
+  mCheckResultCache.Remove(aWord);
   res = mPersonalDictionary->AddWord(PromiseFlatString(aWord).get(),&empty);
   return res;
 }
@@ -285,6 +310,7 @@ mozSpellChecker::RemoveWordFromPersonalDictionary(const nsAString &aWord)
   char16_t empty=0;
   if (!mPersonalDictionary)
     return NS_ERROR_NULL_POINTER;
+  mCheckResultCache.Remove(aWord);
   res = mPersonalDictionary->RemoveWord(PromiseFlatString(aWord).get(),&empty);
   return res;
 }
@@ -377,6 +403,8 @@ mozSpellChecker::GetCurrentDictionary(nsAString &aDictionary)
 NS_IMETHODIMP
 mozSpellChecker::SetCurrentDictionary(const nsAString &aDictionary)
 {
+  mCheckResultCache.Clear();
+
   if (XRE_IsContentProcess()) {
     nsString wrappedDict = nsString(aDictionary);
     bool isSuccess;
@@ -14,6 +14,7 @@
 #include "mozIPersonalDictionary.h"
 #include "mozISpellCheckingEngine.h"
 #include "nsClassHashtable.h"
+#include "nsDataHashtable.h"
 #include "nsTArray.h"
 #include "mozISpellI18NUtil.h"
 #include "nsCycleCollectionParticipant.h"
@@ -72,6 +73,15 @@ protected:
 
   nsresult GetEngineList(nsCOMArray<mozISpellCheckingEngine> *aDictionaryList);
 
+  void CacheCheckResult(const nsAString &aWord, bool aIsMisspelled);
+
+  // Cache of recent check results so that re-checking edited text doesn't
+  // redo the affix analysis (or, in content processes, a sync IPC round
+  // trip) for every word. Invalidated whenever the current dictionary or
+  // the personal dictionary changes.
+  nsDataHashtable<nsStringHashKey, bool> mCheckResultCache;
+  static const uint32_t kMaxCheckResultCacheEntries = 1024;
+
   mozilla::RemoteSpellcheckEngineChild *mEngine;
 
   friend class mozilla::RemoteSpellcheckEngineChild;
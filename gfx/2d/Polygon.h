@@ -65,21 +65,25 @@ ClipPointsAtInfinity(const nsTArray<Point4DTyped<Units>>& aPoints)
 
 /**
  * Calculates the distances between the points in |aPoints| and the plane
- * defined by |aPlaneNormal| and |aPlanePoint|.
+ * defined by |aPlaneNormal| and |aPlanePoint|, and stores them in
+ * |aDistances|. The array is cleared but its storage is retained, so a
+ * caller classifying many polygons can reuse one buffer.
  */
 template<class Units>
-nsTArray<float>
+void
 CalculatePointPlaneDistances(const nsTArray<Point4DTyped<Units>>& aPoints,
                              const Point4DTyped<Units>& aPlaneNormal,
                              const Point4DTyped<Units>& aPlanePoint,
-                             size_t& aPos, size_t& aNeg)
+                             size_t& aPos, size_t& aNeg,
+                             nsTArray<float>& aDistances)
 {
   // Point classification might produce incorrect results due to numerical
   // inaccuracies. Using an epsilon value makes the splitting plane "thicker".
   const float epsilon = 0.05f;
 
   aPos = aNeg = 0;
-  nsTArray<float> distances(aPoints.Length());
+  aDistances.ClearAndRetainStorage();
+  aDistances.SetCapacity(aPoints.Length());
 
   for (const Point4DTyped<Units>& point : aPoints) {
     float dot = (point - aPlanePoint).DotProduct(aPlaneNormal);
@@ -93,10 +97,8 @@ CalculatePointPlaneDistances(const nsTArray<Point4DTyped<Units>>& aPoints,
       dot = 0.0f;
     }
 
-    distances.AppendElement(dot);
+    aDistances.AppendElement(dot);
   }
-
-  return distances;
 }
 
 /**
@@ -232,6 +234,7 @@ public:
     nsTArray<Point4DType> clippedPoints(mPoints);
 
     size_t pos, neg;
+    nsTArray<float> distances;
     nsTArray<Point4DType> backPoints(4), frontPoints(4);
 
     // Iterate over all the edges of the clipping polygon |aPolygon| and clip
@@ -246,8 +249,8 @@ public:
 
       // Calculate the distances between the points of the polygon and the
       // plane defined by |aPolygon|.
-      const nsTArray<float> distances =
-        CalculatePointPlaneDistances(clippedPoints, normal, p1, pos, neg);
+      CalculatePointPlaneDistances(clippedPoints, normal, p1, pos, neg,
+                                   distances);
 
       backPoints.ClearAndRetainStorage();
       frontPoints.ClearAndRetainStorage();
@@ -45,14 +45,13 @@ BSPTree::BuildDrawOrder(BSPTreeNode* aNode,
 
 void
 BSPTree::BuildTree(BSPTreeNode* aRoot,
-                   std::list<LayerPolygon>& aLayers)
+                   LayerList& aLayers)
 {
-  MOZ_ASSERT(!aLayers.empty());
+  MOZ_ASSERT(!aLayers.IsEmpty());
 
-  aRoot->layers.push_back(Move(aLayers.front()));
-  aLayers.pop_front();
+  aRoot->layers.AppendElement(Move(aLayers[0]));
 
-  if (aLayers.empty()) {
+  if (aLayers.Length() == 1) {
     return;
   }
 
@@ -62,54 +61,55 @@ BSPTree::BuildTree(BSPTreeNode* aRoot,
   const gfx::Point4D& planeNormal = plane.GetNormal();
   const gfx::Point4D& planePoint = plane.GetPoints()[0];
 
-  std::list<LayerPolygon> backLayers, frontLayers;
-  for (LayerPolygon& layerPolygon : aLayers) {
+  LayerList backLayers, frontLayers;
+  for (size_t i = 1; i < aLayers.Length(); ++i) {
+    LayerPolygon& layerPolygon = aLayers[i];
     const nsTArray<gfx::Point4D>& geometry = layerPolygon.geometry->GetPoints();
 
     // Calculate the plane-point distances for the polygon classification.
     size_t pos = 0, neg = 0;
-    nsTArray<float> distances =
-      CalculatePointPlaneDistances(geometry, planeNormal, planePoint, pos, neg);
+    CalculatePointPlaneDistances(geometry, planeNormal, planePoint,
+                                 pos, neg, mDistances);
 
     // Back polygon
     if (pos == 0 && neg > 0) {
-      backLayers.push_back(Move(layerPolygon));
+      backLayers.AppendElement(Move(layerPolygon));
     }
     // Front polygon
     else if (pos > 0 && neg == 0) {
-      frontLayers.push_back(Move(layerPolygon));
+      frontLayers.AppendElement(Move(layerPolygon));
     }
     // Coplanar polygon
     else if (pos == 0 && neg == 0) {
-      aRoot->layers.push_back(Move(layerPolygon));
+      aRoot->layers.AppendElement(Move(layerPolygon));
     }
     // Polygon intersects with the splitting plane.
     else if (pos > 0 && neg > 0) {
       nsTArray<gfx::Point4D> backPoints, frontPoints;
       // Clip the polygon against the plane. We reuse the previously calculated
       // distances to find the plane-edge intersections.
-      ClipPointsWithPlane(geometry, planeNormal, distances,
+      ClipPointsWithPlane(geometry, planeNormal, mDistances,
                           backPoints, frontPoints);
 
       const gfx::Point4D& normal = layerPolygon.geometry->GetNormal();
       Layer* layer = layerPolygon.layer;
 
       if (backPoints.Length() >= 3) {
-        backLayers.emplace_back(layer, Move(backPoints), normal);
+        backLayers.AppendElement(LayerPolygon(layer, Move(backPoints), normal));
       }
 
       if (frontPoints.Length() >= 3) {
-        frontLayers.emplace_back(layer, Move(frontPoints), normal);
+        frontLayers.AppendElement(LayerPolygon(layer, Move(frontPoints), normal));
       }
     }
   }
 
-  if (!backLayers.empty()) {
+  if (!backLayers.IsEmpty()) {
     aRoot->back = new (mPool) BSPTreeNode(mListPointers);
     BuildTree(aRoot->back, backLayers);
   }
 
-  if (!frontLayers.empty()) {
+  if (!frontLayers.IsEmpty()) {
     aRoot->front = new (mPool) BSPTreeNode(mListPointers);
     BuildTree(aRoot->front, frontLayers);
   }
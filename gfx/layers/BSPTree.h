@@ -12,8 +12,6 @@
 #include "mozilla/UniquePtr.h"
 #include "nsTArray.h"
 
-#include <list>
-
 namespace mozilla {
 namespace layers {
 
@@ -52,8 +50,10 @@ typedef mozilla::ArenaAllocator<4096, 8> BSPTreeArena;
 
 /**
  * Aliases the container type used to store layers within BSPTreeNodes.
+ * Polygons move cheaply, so a flat array avoids the per-element heap
+ * allocations a linked list would make during tree building.
  */
-typedef std::list<LayerPolygon> LayerList;
+typedef nsTArray<LayerPolygon> LayerList;
 
 /**
  * Represents a node in a BSP tree. The node contains at least one layer with
@@ -70,9 +70,9 @@ struct BSPTreeNode {
 
   const gfx::Polygon& First() const
   {
-    MOZ_ASSERT(!layers.empty());
-    MOZ_ASSERT(layers.front().geometry);
-    return *layers.front().geometry;
+    MOZ_ASSERT(!layers.IsEmpty());
+    MOZ_ASSERT(layers[0].geometry);
+    return *layers[0].geometry;
   }
 
   static void* operator new(size_t aSize, BSPTreeArena& mPool)
@@ -99,9 +99,9 @@ public:
   /**
    * The constructor modifies layers in the given list.
    */
-  explicit BSPTree(std::list<LayerPolygon>& aLayers)
+  explicit BSPTree(LayerList& aLayers)
   {
-    MOZ_ASSERT(!aLayers.empty());
+    MOZ_ASSERT(!aLayers.IsEmpty());
 
     mRoot = new (mPool) BSPTreeNode(mListPointers);
     BuildTree(mRoot, aLayers);
@@ -130,6 +130,13 @@ private:
   BSPTreeNode* mRoot;
   nsTArray<LayerList*> mListPointers;
 
+  /**
+   * Scratch buffer for the plane-point distances computed while classifying
+   * polygons, reused across the whole build so that classification doesn't
+   * heap-allocate per polygon per split.
+   */
+  nsTArray<float> mDistances;
+
   /**
    * BuildDrawOrder and BuildTree are called recursively. The depth of the
    * recursion depends on the amount of polygons and their intersections.
@@ -138,7 +145,7 @@ private:
                       nsTArray<LayerPolygon>& aLayers) const;
 
   void BuildTree(BSPTreeNode* aRoot,
-                 std::list<LayerPolygon>& aLayers);
+                 LayerList& aLayers);
 };
 
 } // namespace layers
@@ -55,12 +55,13 @@ ImageFactory::CreatePlanarYCbCrImage(const gfx::IntSize& aScaleHint, BufferRecyc
   return new RecyclingPlanarYCbCrImage(aRecycleBin);
 }
 
+// An upper bound on the number of buffers kept around per size, enough to
+// cover the frames in flight between the decoder and the compositor. It
+// matches MAX_POOLED_VIDEO_COUNT used for pooled TextureClients.
+static const uint32_t kMaxRecycledBuffersPerSize = 5;
+
 BufferRecycleBin::BufferRecycleBin()
   : mLock("mozilla.layers.BufferRecycleBin.mLock")
-  // This member is only valid when the bin is not empty and will be properly
-  // initialized in RecycleBuffer, but initializing it here avoids static analysis
-  // noise.
-  , mRecycledBufferSize(0)
 {
 }
 
@@ -69,11 +70,11 @@ BufferRecycleBin::RecycleBuffer(UniquePtr<uint8_t[]> aBuffer, uint32_t aSize)
 {
   MutexAutoLock lock(mLock);
 
-  if (!mRecycledBuffers.IsEmpty() && aSize != mRecycledBufferSize) {
-    mRecycledBuffers.Clear();
+  nsTArray<UniquePtr<uint8_t[]>>* pool = mRecycledBuffers.LookupOrAdd(aSize);
+  if (pool->Length() >= kMaxRecycledBuffersPerSize) {
+    return;
   }
-  mRecycledBufferSize = aSize;
-  mRecycledBuffers.AppendElement(Move(aBuffer));
+  pool->AppendElement(Move(aBuffer));
 }
 
 UniquePtr<uint8_t[]>
@@ -81,12 +82,14 @@ BufferRecycleBin::GetBuffer(uint32_t aSize)
 {
   MutexAutoLock lock(mLock);
 
-  if (mRecycledBuffers.IsEmpty() || mRecycledBufferSize != aSize)
+  nsTArray<UniquePtr<uint8_t[]>>* pool = mRecycledBuffers.Get(aSize);
+  if (!pool || pool->IsEmpty()) {
     return MakeUnique<uint8_t[]>(aSize);
+  }
 
-  uint32_t last = mRecycledBuffers.Length() - 1;
-  UniquePtr<uint8_t[]> result = Move(mRecycledBuffers[last]);
-  mRecycledBuffers.RemoveElementAt(last);
+  uint32_t last = pool->Length() - 1;
+  UniquePtr<uint8_t[]> result = Move((*pool)[last]);
+  pool->RemoveElementAt(last);
   return result;
 }
 
@@ -94,10 +97,7 @@ void
 BufferRecycleBin::ClearRecycledBuffers()
 {
   MutexAutoLock lock(mLock);
-  if (!mRecycledBuffers.IsEmpty()) {
-    mRecycledBuffers.Clear();
-  }
-  mRecycledBufferSize = 0;
+  mRecycledBuffers.Clear();
 }
 
 ImageContainerListener::ImageContainerListener(ImageContainer* aImageContainer)
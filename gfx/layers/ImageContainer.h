@@ -29,6 +29,7 @@
 #include "mozilla/WeakPtr.h"
 #include "nsThreadUtils.h"
 #include "mozilla/gfx/2D.h"
+#include "nsClassHashtable.h"
 #include "nsDataHashtable.h"
 #include "mozilla/EnumeratedArray.h"
 #include "mozilla/UniquePtr.h"
@@ -292,15 +293,19 @@ private:
   {
   }
 
-  // This protects mRecycledBuffers, mRecycledBufferSize, mRecycledTextures
+  // This protects mRecycledBuffers, mRecycledTextures
   // and mRecycledTextureSizes
   Mutex mLock;
 
-  // We should probably do something to prune this list on a timer so we don't
-  // eat excess memory while video is paused...
-  nsTArray<mozilla::UniquePtr<uint8_t[]>> mRecycledBuffers;
-  // This is only valid if mRecycledBuffers is non-empty
-  uint32_t mRecycledBufferSize;
+  // Buffers eligible for recycling, keyed by their size so that a resolution
+  // change (e.g. a quality switch in adaptive streaming) does not throw away
+  // every pooled buffer. Each per-size pool is bounded; see
+  // kMaxRecycledBuffersPerSize in ImageContainer.cpp.
+  //
+  // We should probably do something to prune these pools on a timer so we
+  // don't eat excess memory while video is paused...
+  nsClassHashtable<nsUint32HashKey, nsTArray<mozilla::UniquePtr<uint8_t[]>>>
+    mRecycledBuffers;
 };
 
 /**
@@ -1098,7 +1098,8 @@ ContainerLayer::Collect3DContextLeaves(nsTArray<Layer*>& aToSort)
 static nsTArray<LayerPolygon>
 SortLayersWithBSPTree(nsTArray<Layer*>& aArray)
 {
-  std::list<LayerPolygon> inputLayers;
+  LayerList inputLayers;
+  inputLayers.SetCapacity(aArray.Length());
 
   // Build a list of polygons to be sorted.
   for (Layer* layer : aArray) {
@@ -1123,11 +1124,11 @@ SortLayersWithBSPTree(nsTArray<Layer*>& aArray)
     polygon.TransformToScreenSpace(transform);
 
     if (polygon.GetPoints().Length() >= 3) {
-      inputLayers.push_back(LayerPolygon(layer, Move(polygon)));
+      inputLayers.AppendElement(LayerPolygon(layer, Move(polygon)));
     }
   }
 
-  if (inputLayers.empty()) {
+  if (inputLayers.IsEmpty()) {
     return nsTArray<LayerPolygon>();
   }
 
@@ -12,8 +12,15 @@
 #include "mozilla/layers/ShadowLayers.h"
 #include "mozilla/layers/SyncObject.h"
 #include "mozilla/gfx/2D.h"
+#include "mozilla/Monitor.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/SyncRunnable.h"
+#include "nsComponentManagerUtils.h"
+#include "nsIThreadPool.h"
+#include "nsXPCOMCIDInternal.h"
+#include "prsystem.h"
+
+#include <algorithm>
 
 namespace mozilla {
 namespace layers {
@@ -23,6 +30,10 @@ using namespace gfx;
 StaticAutoPtr<PaintThread> PaintThread::sSingleton;
 StaticRefPtr<nsIThread> PaintThread::sThread;
 PlatformThreadId PaintThread::sThreadId;
+StaticRefPtr<nsIThreadPool> PaintThread::sTilePool;
+
+// Size of the tiles that TryAsyncPaintTiled shards a full-target paint into.
+static const int32_t kTilePaintSize = 512;
 
 // RAII make sure we clean up and restore our draw targets
 // when we paint async.
@@ -93,6 +104,18 @@ PaintThread::Init()
     NewRunnableMethod("PaintThread::InitOnPaintThread",
                       this, &PaintThread::InitOnPaintThread);
   SyncRunnable::DispatchToThread(sThread, paintInitTask);
+
+  if (gfxPrefs::LayersOMTPTiling()) {
+    nsCOMPtr<nsIThreadPool> pool = do_CreateInstance(NS_THREADPOOL_CONTRACTID);
+    if (pool) {
+      pool->SetName(NS_LITERAL_CSTRING("TilePaint"));
+      // Leave a core for the paint thread itself; more than a handful of
+      // workers doesn't help for the tile counts a window produces.
+      int32_t procs = PR_GetNumberOfProcessors();
+      pool->SetThreadLimit(std::max(1, std::min(procs - 1, 4)));
+      sTilePool = pool;
+    }
+  }
   return true;
 }
 
@@ -123,6 +146,12 @@ PaintThread::Shutdown()
   sThread->Dispatch(NewRunnableFunction(DestroyPaintThread, Move(pt)));
   sThread->Shutdown();
   sThread = nullptr;
+
+  // The paint thread is gone, so no tile task can be in flight.
+  if (sTilePool) {
+    sTilePool->Shutdown();
+    sTilePool = nullptr;
+  }
 }
 
 void
@@ -196,7 +225,9 @@ PaintThread::AsyncPaintContents(CompositorBridgeChild* aBridge,
   }
 
   // Draw all the things into the actual dest target.
-  target->DrawCapturedDT(capture, Matrix());
+  if (!TryAsyncPaintTiled(aState)) {
+    target->DrawCapturedDT(capture, Matrix());
+  }
   if (!mDrawTargetsToFlush.Contains(target)) {
     mDrawTargetsToFlush.AppendElement(target);
   }
@@ -209,6 +240,104 @@ PaintThread::AsyncPaintContents(CompositorBridgeChild* aBridge,
   }
 }
 
+bool
+PaintThread::TryAsyncPaintTiled(CapturedPaintState* aState)
+{
+  MOZ_ASSERT(IsOnPaintThread());
+
+  if (!sTilePool) {
+    return false;
+  }
+
+  // Component alpha paints replay the same capture onto two targets with
+  // different blending; keep those on the simple path.
+  if (aState->mTargetOnWhite) {
+    return false;
+  }
+
+  DrawTarget* target = aState->mTarget;
+  IntSize size = target->GetSize();
+  if (size.width <= kTilePaintSize && size.height <= kTilePaintSize) {
+    return false;
+  }
+
+  // Tiles are composited back with CopySurface, which replaces the
+  // destination pixels, so tiling is only correct when the paint redraws
+  // the whole buffer. That's also the case that's actually raster-bound;
+  // partial invalidations replay quickly on this thread.
+  if (aState->mRegionToDraw.GetNumRects() != 1 ||
+      aState->mRegionToDraw.GetBounds().Size() != size) {
+    return false;
+  }
+
+  DrawTargetCapture* capture = aState->mCapture;
+
+  struct Tile {
+    RefPtr<DrawTarget> mTarget;
+    IntPoint mOrigin;
+  };
+  AutoTArray<Tile, 16> tiles;
+  for (int32_t y = 0; y < size.height; y += kTilePaintSize) {
+    for (int32_t x = 0; x < size.width; x += kTilePaintSize) {
+      IntSize tileSize(std::min(kTilePaintSize, size.width - x),
+                       std::min(kTilePaintSize, size.height - y));
+      RefPtr<DrawTarget> dt =
+        target->CreateSimilarDrawTarget(tileSize, target->GetFormat());
+      if (!dt) {
+        return false;
+      }
+      tiles.AppendElement(Tile { dt, IntPoint(x, y) });
+    }
+  }
+
+  Monitor monitor("PaintThread::TryAsyncPaintTiled");
+  uint32_t pendingTiles = tiles.Length();
+
+  for (Tile& tile : tiles) {
+    DrawTarget* dt = tile.mTarget;
+    IntPoint origin = tile.mOrigin;
+    RefPtr<Runnable> task = NS_NewRunnableFunction("PaintThread::PaintTile",
+      [dt, origin, capture, &monitor, &pendingTiles]() -> void
+    {
+      // Shift device space so this tile's slice of the buffer lands at the
+      // tile's origin, mirroring what AutoCapturedPaintSetup does for the
+      // untiled path.
+      Matrix tileShift = Matrix::Translation(-origin.x, -origin.y);
+      dt->SetTransform(capture->GetTransform() * tileShift);
+      dt->SetPermitSubpixelAA(capture->GetPermitSubpixelAA());
+      dt->DrawCapturedDT(capture, tileShift);
+      dt->Flush();
+
+      MonitorAutoLock lock(monitor);
+      if (--pendingTiles == 0) {
+        lock.Notify();
+      }
+    });
+    sTilePool->Dispatch(task.forget(), nsIEventTarget::DISPATCH_NORMAL);
+  }
+
+  // Join before compositing; the capture and the tile list live on this
+  // stack frame, so we can't return until every tile is done.
+  {
+    MonitorAutoLock lock(monitor);
+    while (pendingTiles) {
+      lock.Wait();
+    }
+  }
+
+  for (Tile& tile : tiles) {
+    RefPtr<SourceSurface> snapshot = tile.mTarget->Snapshot();
+    if (!snapshot) {
+      return false;
+    }
+    target->CopySurface(snapshot,
+                        IntRect(IntPoint(), snapshot->GetSize()),
+                        tile.mOrigin);
+  }
+
+  return true;
+}
+
 void
 PaintThread::EndLayer()
 {
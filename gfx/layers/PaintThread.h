@@ -14,6 +14,8 @@
 #include "mozilla/layers/TextureClient.h"
 #include "nsThreadUtils.h"
 
+class nsIThreadPool;
+
 namespace mozilla {
 namespace gfx {
 class DrawTarget;
@@ -102,6 +104,13 @@ private:
   void AsyncPaintContents(CompositorBridgeChild* aBridge,
                           CapturedPaintState* aState,
                           PrepDrawTargetForPaintingCallback aCallback);
+
+  // Shards a full-target paint into tiles rasterized in parallel on the
+  // tile pool, joins, and composites them into the destination target.
+  // Returns false if the paint isn't eligible for tiling (or the pool is
+  // disabled), in which case the caller replays the capture directly.
+  bool TryAsyncPaintTiled(CapturedPaintState* aState);
+
   void AsyncEndLayer();
   void AsyncEndLayerTransaction(CompositorBridgeChild* aBridge,
                                 SyncObjectClient* aSyncObject);
@@ -110,6 +119,11 @@ private:
   static StaticRefPtr<nsIThread> sThread;
   static PlatformThreadId sThreadId;
 
+  // Workers used by TryAsyncPaintTiled; null unless layers.omtp.tiling
+  // is enabled. Tile tasks only run while the paint thread blocks in
+  // TryAsyncPaintTiled, so the pool is idle whenever the paint thread is.
+  static StaticRefPtr<nsIThreadPool> sTilePool;
+
   // This shouldn't be very many elements, so a list should be fine.
   // Should only be accessed on the paint thread.
   nsTArray<RefPtr<gfx::DrawTarget>> mDrawTargetsToFlush;
@@ -545,6 +545,52 @@ ClientTiledPaintedLayer::RenderLayer()
   }
   TILING_LOG("TILING %p: Low-precision invalid region %s\n", this, Stringify(lowPrecisionInvalidRegion).c_str());
 
+  // On a fast fling the scroll offset can jump so far that nothing in the
+  // high-precision buffer is valid any more, and the compositor is guaranteed
+  // to checkerboard until the first high-precision tiles arrive. If we have a
+  // low-precision buffer, fill it for the critical area first: at the reduced
+  // resolution that costs a fraction of a single high-precision tile, and the
+  // compositor will upsample it wherever high-precision tiles are still
+  // missing.
+  if (mContentClient->GetLowPrecisionTiledBuffer() &&
+      !mPaintData.mFirstPaint &&
+      mPaintData.mLowPrecisionPaintCount == 0 &&
+      GetValidRegion().IsEmpty() &&
+      UseProgressiveDraw()) {
+    nsIntRegion speculativeRegion = lowPrecisionInvalidRegion;
+    if (mPaintData.mCriticalDisplayPort) {
+      speculativeRegion.AndWith(mPaintData.mCriticalDisplayPort->ToUnknownRect());
+    }
+
+    // If the frame resolution or format have changed, invalidate the buffer
+    if (mContentClient->GetLowPrecisionTiledBuffer()->GetFrameResolution() != mPaintData.mResolution ||
+        mContentClient->GetLowPrecisionTiledBuffer()->HasFormatChanged()) {
+      mLowPrecisionValidRegion.SetEmpty();
+      mContentClient->GetLowPrecisionTiledBuffer()->ResetPaintedAndValidState();
+      mContentClient->GetLowPrecisionTiledBuffer()->SetFrameResolution(mPaintData.mResolution);
+    }
+    speculativeRegion.SubOut(mLowPrecisionValidRegion);
+
+    if (!speculativeRegion.IsEmpty()) {
+      TILING_LOG("TILING %p: Speculative low-precision paint of region %s\n", this, Stringify(speculativeRegion).c_str());
+
+      mLowPrecisionValidRegion.OrWith(speculativeRegion);
+      mContentClient->GetLowPrecisionTiledBuffer()->PaintThebes(
+        mLowPrecisionValidRegion, speculativeRegion, speculativeRegion,
+        callback, data);
+
+      ClientManager()->Hold(this);
+      mContentClient->UpdatedBuffer(TiledContentClient::LOW_PRECISION_TILED_BUFFER);
+
+      // Don't mix high-precision painting into the same transaction; request
+      // a repeat transaction so the high-precision tiles start immediately
+      // after this update has been forwarded.
+      ClientManager()->SetRepeatTransaction();
+      mPaintData.mPaintFinished = false;
+      return;
+    }
+  }
+
   bool updatedHighPrecision = RenderHighPrecision(invalidRegion,
                                                   neededRegion,
                                                   callback, data);
@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "Diagnostics.h"
+#include "TextureResidencyManager.h"
 #include "mozilla/layers/LayersMessages.h"
 #include "nsPrintfCString.h"
 
@@ -96,10 +97,18 @@ Diagnostics::GetFrameOverlayString(const GPUStats& aStats)
     mSendMs.Average(),
     mUpdateMs.Average());
 
-  return std::string(line1.get()) + "\n" +
-         std::string(line2.get()) + "\n" +
-         std::string(line3.get()) + "\n" +
-         std::string(line4.get());
+  std::string result = std::string(line1.get()) + "\n" +
+                       std::string(line2.get()) + "\n" +
+                       std::string(line3.get()) + "\n" +
+                       std::string(line4.get());
+
+  // Only reported when a texture residency budget is configured.
+  std::string residency = TextureResidencyManager::Get()->GetReportString();
+  if (!residency.empty()) {
+    result += "\n" + residency;
+  }
+
+  return result;
 }
 
 } // namespace layers
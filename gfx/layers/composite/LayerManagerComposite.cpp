@@ -51,6 +51,7 @@
 #include "nsDebug.h"                    // for NS_WARNING, NS_RUNTIMEABORT, etc
 #include "nsISupportsImpl.h"            // for Layer::AddRef, etc
 #include "nsPoint.h"                    // for nsIntPoint
+#include "nsPrintfCString.h"            // for nsPrintfCString
 #include "nsRect.h"                     // for mozilla::gfx::IntRect
 #include "nsRegion.h"                   // for nsIntRegion, etc
 #if defined(MOZ_WIDGET_ANDROID)
@@ -242,8 +243,9 @@ void
 LayerManagerComposite::PostProcessLayers(nsIntRegion& aOpaqueRegion)
 {
   LayerIntRegion visible;
+  mCulledRegion.SetEmpty();
   LayerComposite* rootComposite = static_cast<LayerComposite*>(mRoot->AsHostLayer());
-  PostProcessLayers(mRoot, aOpaqueRegion, visible,
+  PostProcessLayers(mRoot, aOpaqueRegion, visible, mCulledRegion,
                     ViewAs<RenderTargetPixel>(rootComposite->GetShadowClipRect(),
                                               PixelCastJustification::RenderTargetIsParentLayerForRoot),
                     Nothing());
@@ -266,6 +268,7 @@ void
 LayerManagerComposite::PostProcessLayers(Layer* aLayer,
                                          nsIntRegion& aOpaqueRegion,
                                          LayerIntRegion& aVisibleRegion,
+                                         LayerIntRegion& aCulledRegion,
                                          const Maybe<RenderTargetIntRect>& aRenderTargetClip,
                                          const Maybe<ParentLayerIntRect>& aClipFromAncestors)
 {
@@ -337,7 +340,7 @@ LayerManagerComposite::PostProcessLayers(Layer* aLayer,
         renderTargetClip = IntersectMaybeRects(renderTargetClip, Some(clip));
       }
 
-      PostProcessLayers(child, opaqueRegion, aVisibleRegion,
+      PostProcessLayers(child, opaqueRegion, aVisibleRegion, aCulledRegion,
                         renderTargetClip, ancestorClipForChildren);
     }
     return;
@@ -369,12 +372,14 @@ LayerManagerComposite::PostProcessLayers(Layer* aLayer,
   //  - They recalculate their visible regions, taking ancestorClipForChildren
   //    into account, and accumulate them into descendantsVisibleRegion.
   LayerIntRegion descendantsVisibleRegion;
+  LayerIntRegion descendantsCulledRegion;
 
   bool hasPreserve3DChild = false;
   for (Layer* child = aLayer->GetLastChild(); child; child = child->GetPrevSibling()) {
     MOZ_ASSERT(aLayer->AsContainerLayer()->UseIntermediateSurface());
     LayerComposite* childComposite = static_cast<LayerComposite*>(child->AsHostLayer());
     PostProcessLayers(child, localOpaque, descendantsVisibleRegion,
+                      descendantsCulledRegion,
                       ViewAs<RenderTargetPixel>(childComposite->GetShadowClipRect(),
                                                 PixelCastJustification::RenderTargetIsParentLayerForRoot),
                       ancestorClipForChildren);
@@ -392,6 +397,14 @@ LayerManagerComposite::PostProcessLayers(Layer* aLayer,
     visible = descendantsVisibleRegion;
   }
 
+  // When the debug overlay wants it, record what the subtraction below is
+  // about to remove, so the culled area can be visualized after the pass.
+  LayerIntRegion culled;
+  if (gfxPrefs::DrawCulledArea() && !obscured.IsEmpty()) {
+    culled = visible;
+    culled.AndWith(LayerIntRegion::FromUnknownRegion(obscured));
+  }
+
   // Subtract any areas that we know to be opaque.
   if (!obscured.IsEmpty()) {
     visible.SubOut(LayerIntRegion::FromUnknownRegion(obscured));
@@ -403,6 +416,21 @@ LayerManagerComposite::PostProcessLayers(Layer* aLayer,
   }
   composite->SetShadowVisibleRegion(visible);
 
+  if (gfxPrefs::DrawCulledArea()) {
+    // Accumulate the culled region into our parent's space the same way the
+    // visible region is accumulated below, folding in our descendants'
+    // contributions. Areas removed by the clip weren't a culling win, so
+    // intersect with it.
+    culled.OrWith(descendantsCulledRegion);
+    if (insideClip) {
+      culled.AndWith(*insideClip);
+    }
+    ParentLayerIntRegion culledParentSpace = TransformBy(
+        ViewAs<LayerToParentLayerMatrix4x4>(transform), culled);
+    aCulledRegion.OrWith(ViewAs<LayerPixel>(culledParentSpace,
+        PixelCastJustification::MovingDownToChildren));
+  }
+
   // Transform the newly calculated visible region into our parent's space,
   // apply our clip to it (if any), and accumulate it into |aVisibleRegion|
   // for the caller to use.
@@ -682,6 +710,34 @@ LayerManagerComposite::RenderDebugOverlay(const IntRect& aBounds)
     }
   }
 
+  if (gfxPrefs::DrawCulledArea() && !mCulledRegion.IsEmpty()) {
+    // Tint the areas that the occlusion pass in PostProcessLayers removed
+    // from layers' visible regions, and report them as a share of the
+    // screen, so fill-rate savings are visible at a glance.
+    EffectChain effects;
+    effects.mPrimaryEffect = new EffectSolidColor(gfx::Color(0, 1, 0, 1));
+    uint64_t culledPixels = 0;
+    for (auto iter = mCulledRegion.RectIter(); !iter.Done(); iter.Next()) {
+      IntRect rect = iter.Get().ToUnknownRect();
+      culledPixels += uint64_t(rect.Width()) * rect.Height();
+      mCompositor->DrawQuad(Rect(rect), aBounds, effects, 0.25f,
+                            gfx::Matrix4x4());
+    }
+    uint64_t screenPixels = uint64_t(aBounds.Width()) * aBounds.Height();
+    if (screenPixels) {
+      nsPrintfCString culledText("Culled %d%%",
+          int32_t(culledPixels * 100 / screenPixels));
+      mTextRenderer->RenderText(
+        mCompositor,
+        culledText.get(),
+        IntPoint(2, aBounds.Height() - 30),
+        Matrix4x4(),
+        24,
+        600,
+        TextRenderer::FontType::FixedWidth);
+    }
+  }
+
   if (drawFrameColorBars) {
     gfx::IntRect sideRect(0, 0, 10, aBounds.Height());
 
@@ -334,6 +334,10 @@ public:
    *     Each layer accumulates into |aVisibleRegion| its post-transform
    *     (including async transforms) visible region.
    *
+   *   - When the culled-area debug overlay is enabled, each layer accumulates
+   *     into |aCulledRegion| the post-transform area that occlusion culling
+   *     removed from its visible region.
+   *
    *   - aRenderTargetClip is the exact clip required for aLayer, in the coordinates
    *     of the nearest render target (the same as GetEffectiveTransform).
    *
@@ -345,6 +349,7 @@ public:
   void PostProcessLayers(Layer* aLayer,
                          nsIntRegion& aOpaqueRegion,
                          LayerIntRegion& aVisibleRegion,
+                         LayerIntRegion& aCulledRegion,
                          const Maybe<RenderTargetIntRect>& aRenderTargetClip,
                          const Maybe<ParentLayerIntRect>& aClipFromAncestors);
 
@@ -495,6 +500,13 @@ private:
 
   nsIntRegion mInvalidRegion;
 
+  /**
+   * Region removed from layers' visible regions by occlusion culling in the
+   * last PostProcessLayers pass, in root layer space. Only tracked when the
+   * layers.draw-culled debug overlay is enabled.
+   */
+  LayerIntRegion mCulledRegion;
+
   typedef nsClassHashtable<nsGenericHashKey<ScrollableLayerGuid>,
                            CSSIntRegion> VisibleRegions;
   VisibleRegions mVisibleRegions;
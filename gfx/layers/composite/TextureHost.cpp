@@ -7,6 +7,7 @@
 
 #include "CompositableHost.h"           // for CompositableHost
 #include "LayerScope.h"
+#include "TextureResidencyManager.h"
 #include "LayersLogging.h"              // for AppendToString
 #include "mozilla/gfx/2D.h"             // for DataSourceSurface, Factory
 #include "mozilla/gfx/gfxVars.h"
@@ -483,7 +484,9 @@ BufferTextureHost::BufferTextureHost(const BufferDescriptor& aDesc,
 }
 
 BufferTextureHost::~BufferTextureHost()
-{}
+{
+  TextureResidencyManager::Get()->OnDeviceDataFreed(this);
+}
 
 void
 BufferTextureHost::UpdatedInternal(const nsIntRegion* aRegion)
@@ -512,6 +515,7 @@ BufferTextureHost::SetTextureSourceProvider(TextureSourceProvider* aProvider)
     mFirstSource->SetOwner(nullptr);
   }
   if (mFirstSource) {
+    TextureResidencyManager::Get()->OnDeviceDataFreed(this);
     mFirstSource = nullptr;
     mNeedsFullUpdate = true;
   }
@@ -525,6 +529,8 @@ BufferTextureHost::DeallocateDeviceData()
     return;
   }
 
+  TextureResidencyManager::Get()->OnDeviceDataFreed(this);
+
   if (!mFirstSource || !mFirstSource->IsOwnedBy(this)) {
     mFirstSource = nullptr;
     return;
@@ -539,6 +545,19 @@ BufferTextureHost::DeallocateDeviceData()
   }
 }
 
+bool
+BufferTextureHost::CanEvictDeviceData() const
+{
+  // Only evict textures whose content is retained in the shared buffer (so
+  // the next Lock() will simply upload it again), and whose source is not
+  // currently bound to a compositable or locked for compositing.
+  return mHasIntermediateBuffer &&
+         !mLocked &&
+         mFirstSource &&
+         mFirstSource->IsOwnedBy(this) &&
+         mFirstSource->NumCompositableRefs() == 0;
+}
+
 bool
 BufferTextureHost::Lock()
 {
@@ -547,6 +566,9 @@ BufferTextureHost::Lock()
       return false;
   }
   mLocked = !!mFirstSource;
+  if (mLocked && gfxPrefs::TextureResidencyBudgetMB() > 0) {
+    TextureResidencyManager::Get()->OnTextureComposited(this);
+  }
   return mLocked;
 }
 
@@ -926,9 +948,34 @@ BufferTextureHost::MaybeUpload(nsIntRegion *aRegion)
 
   // If upload returns true we know mFirstSource is not null
   mFirstSource->SetUpdateSerial(mUpdateSerial);
+
+  // Only textures with an intermediate buffer actually consumed device
+  // memory here; without one the source just wraps the shared buffer.
+  if (mHasIntermediateBuffer && gfxPrefs::TextureResidencyBudgetMB() > 0) {
+    TextureResidencyManager::Get()->OnTextureUploaded(this,
+                                                      EstimatedDeviceMemory());
+  }
   return true;
 }
 
+size_t
+BufferTextureHost::EstimatedDeviceMemory() const
+{
+  if (mFormat == gfx::SurfaceFormat::YUV) {
+    if (mProvider && !mProvider->SupportsEffect(EffectTypes::YCBCR)) {
+      // Uploaded as a single RGB texture (see Upload).
+      return ImageDataSerializer::ComputeRGBBufferSize(
+        mSize, gfx::SurfaceFormat::B8G8R8X8);
+    }
+    const YCbCrDescriptor& desc = mDescriptor.get_YCbCrDescriptor();
+    size_t bytesPerTexel = desc.bitDepth() > 8 ? 2 : 1;
+    return (size_t(desc.ySize().width) * desc.ySize().height +
+            2 * size_t(desc.cbCrSize().width) * desc.cbCrSize().height) *
+           bytesPerTexel;
+  }
+  return ImageDataSerializer::ComputeRGBBufferSize(mSize, mFormat);
+}
+
 bool
 BufferTextureHost::Upload(nsIntRegion *aRegion)
 {
@@ -498,6 +498,15 @@ public:
    */
   virtual void DeallocateDeviceData() {}
 
+  /**
+   * Returns true if the TextureResidencyManager may call
+   * DeallocateDeviceData on this texture to relieve device memory pressure.
+   * This requires that the device data can be re-created from retained
+   * content (so eviction is only a performance cost), and that the texture
+   * is not currently bound to a compositable.
+   */
+  virtual bool CanEvictDeviceData() const { return false; }
+
   /**
    * Should be overridden in order to deallocate the data that is shared with
    * the content side, such as shared memory.
@@ -724,6 +733,8 @@ public:
 
   virtual void DeallocateDeviceData() override;
 
+  virtual bool CanEvictDeviceData() const override;
+
   virtual void SetTextureSourceProvider(TextureSourceProvider* aProvider) override;
 
   /**
@@ -770,6 +781,10 @@ protected:
   bool MaybeUpload(nsIntRegion *aRegion);
   bool EnsureWrappingTextureSource();
 
+  // Estimate of the device memory consumed by the uploaded texture sources,
+  // for residency tracking.
+  size_t EstimatedDeviceMemory() const;
+
   virtual void UpdatedInternal(const nsIntRegion* aRegion = nullptr) override;
 
   BufferDescriptor mDescriptor;
@@ -0,0 +1,175 @@
+/* -*- Mode: C++; tab-width: 20; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "TextureResidencyManager.h"
+
+#include <inttypes.h>
+
+#include "TextureHost.h"
+#include "gfxPrefs.h"
+#include "mozilla/StaticMutex.h"
+#include "nsPrintfCString.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+namespace layers {
+
+static StaticMutex sInstanceLock;
+// Deliberately leaked; the manager lives for the duration of the compositor
+// process.
+static TextureResidencyManager* sInstance;
+
+/* static */ TextureResidencyManager*
+TextureResidencyManager::Get()
+{
+  StaticMutexAutoLock lock(sInstanceLock);
+  if (!sInstance) {
+    sInstance = new TextureResidencyManager();
+  }
+  return sInstance;
+}
+
+TextureResidencyManager::TextureResidencyManager()
+  : mLock("TextureResidencyManager")
+{
+}
+
+/* static */ size_t
+TextureResidencyManager::BudgetBytes()
+{
+  int32_t budgetMB = gfxPrefs::TextureResidencyBudgetMB();
+  if (budgetMB <= 0) {
+    return 0;
+  }
+  return size_t(budgetMB) * 1024 * 1024;
+}
+
+void
+TextureResidencyManager::OnTextureUploaded(TextureHost* aTexture, size_t aBytes)
+{
+  {
+    MutexAutoLock lock(mLock);
+
+    if (mEvicted.Contains(aTexture)) {
+      mEvicted.RemoveEntry(aTexture);
+      mStats.mReuploadsAfterEviction++;
+    }
+
+    Entry* entry = mEntries.Get(aTexture);
+    if (entry) {
+      // Re-upload of a tracked texture; refresh its size and LRU position.
+      mStats.mResidentBytes -= entry->mBytes;
+      entry->mBytes = aBytes;
+      entry->remove();
+    } else {
+      entry = new Entry(aTexture, aBytes);
+      mEntries.Put(aTexture, entry);
+    }
+    mLRU.insertBack(entry);
+
+    mStats.mResidentBytes += aBytes;
+    if (mStats.mResidentBytes > mStats.mPeakResidentBytes) {
+      mStats.mPeakResidentBytes = mStats.mResidentBytes;
+    }
+  }
+
+  EvictIfOverBudget();
+}
+
+void
+TextureResidencyManager::OnTextureComposited(TextureHost* aTexture)
+{
+  MutexAutoLock lock(mLock);
+  Entry* entry = mEntries.Get(aTexture);
+  if (!entry) {
+    return;
+  }
+  entry->remove();
+  mLRU.insertBack(entry);
+}
+
+void
+TextureResidencyManager::OnDeviceDataFreed(TextureHost* aTexture)
+{
+  MutexAutoLock lock(mLock);
+  mEvicted.RemoveEntry(aTexture);
+  Entry* entry = mEntries.Get(aTexture);
+  if (!entry) {
+    return;
+  }
+  mStats.mResidentBytes -= entry->mBytes;
+  mEntries.Remove(aTexture);
+  entry->remove();
+  delete entry;
+}
+
+void
+TextureResidencyManager::EvictIfOverBudget()
+{
+  size_t budget = BudgetBytes();
+  if (!budget) {
+    return;
+  }
+
+  // Pick the eviction candidates under the lock, but release their device
+  // data outside of it since DeallocateDeviceData calls back into
+  // OnDeviceDataFreed.
+  AutoTArray<RefPtr<TextureHost>, 8> candidates;
+  {
+    MutexAutoLock lock(mLock);
+    if (mStats.mResidentBytes <= budget) {
+      return;
+    }
+    mStats.mEvictionPasses++;
+
+    size_t wouldFree = 0;
+    for (Entry* entry = mLRU.getFirst(); entry; entry = entry->getNext()) {
+      if (mStats.mResidentBytes - wouldFree <= budget) {
+        break;
+      }
+      if (!entry->mTexture->CanEvictDeviceData()) {
+        // Pinned: currently bound to a compositable, or not re-uploadable.
+        continue;
+      }
+      candidates.AppendElement(entry->mTexture);
+      wouldFree += entry->mBytes;
+      mEvicted.PutEntry(entry->mTexture);
+      mStats.mEvictedTextures++;
+      mStats.mEvictedBytes += entry->mBytes;
+    }
+  }
+
+  for (auto& texture : candidates) {
+    texture->DeallocateDeviceData();
+  }
+}
+
+TextureResidencyManager::Stats
+TextureResidencyManager::GetStats()
+{
+  MutexAutoLock lock(mLock);
+  return mStats;
+}
+
+std::string
+TextureResidencyManager::GetReportString()
+{
+  if (!BudgetBytes()) {
+    return std::string();
+  }
+
+  Stats stats = GetStats();
+  nsPrintfCString line("[VRAM] Resident: %0.1fMB (peak %0.1fMB) "
+                       "Evicted: %" PRIu64 " (%0.1fMB) Re-uploads: %" PRIu64,
+                       float(stats.mResidentBytes) / (1024.0f * 1024.0f),
+                       float(stats.mPeakResidentBytes) / (1024.0f * 1024.0f),
+                       stats.mEvictedTextures,
+                       float(stats.mEvictedBytes) / (1024.0f * 1024.0f),
+                       stats.mReuploadsAfterEviction);
+  return std::string(line.get());
+}
+
+} // namespace layers
+} // namespace mozilla
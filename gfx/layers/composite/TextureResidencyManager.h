@@ -0,0 +1,126 @@
+/* -*- Mode: C++; tab-width: 20; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_gfx_layers_composite_TextureResidencyManager_h
+#define mozilla_gfx_layers_composite_TextureResidencyManager_h
+
+#include <string>
+
+#include "mozilla/LinkedList.h"
+#include "mozilla/Mutex.h"
+#include "mozilla/RefPtr.h"
+#include "nsDataHashtable.h"
+#include "nsTHashtable.h"
+
+namespace mozilla {
+namespace layers {
+
+class TextureHost;
+
+/**
+ * Tracks the device texture memory uploaded by TextureHosts in the compositor
+ * process, and proactively evicts the least recently composited textures when
+ * a configurable budget (layers.texture-residency.budget-mb) is exceeded.
+ *
+ * Without this, the only backpressure on device memory is the driver's own
+ * eviction, which on low-VRAM devices tends to show up as multi-second
+ * stalls or device resets with no warning. Evicting here instead means we
+ * drop textures we can cheaply re-upload (texture hosts that keep their
+ * content in a shared buffer), and we keep counters of the resulting churn
+ * so the cost is visible in the diagnostics overlay.
+ *
+ * Textures whose source is currently bound to a compositable (i.e. in use by
+ * a visible layer) are pinned and never evicted; see
+ * TextureHost::CanEvictDeviceData.
+ *
+ * Upload, composition and eviction all happen on the compositor thread; the
+ * lock only guards against stats being read from other threads.
+ */
+class TextureResidencyManager final
+{
+public:
+  static TextureResidencyManager* Get();
+
+  /**
+   * Called after aTexture uploaded its content to device memory. Registers
+   * or refreshes the texture in the LRU and may trigger an eviction pass.
+   */
+  void OnTextureUploaded(TextureHost* aTexture, size_t aBytes);
+
+  /**
+   * Called when aTexture is locked for composition. Moves the texture to
+   * the front of the LRU.
+   */
+  void OnTextureComposited(TextureHost* aTexture);
+
+  /**
+   * Called when aTexture's device data is released for any reason. Safe to
+   * call for textures that were never tracked.
+   */
+  void OnDeviceDataFreed(TextureHost* aTexture);
+
+  struct Stats
+  {
+    Stats()
+      : mResidentBytes(0)
+      , mPeakResidentBytes(0)
+      , mEvictionPasses(0)
+      , mEvictedTextures(0)
+      , mEvictedBytes(0)
+      , mReuploadsAfterEviction(0)
+    {}
+
+    size_t mResidentBytes;
+    size_t mPeakResidentBytes;
+    uint64_t mEvictionPasses;
+    uint64_t mEvictedTextures;
+    uint64_t mEvictedBytes;
+    // Number of times an evicted texture had to be uploaded again. High
+    // values relative to mEvictedTextures mean the budget is too tight.
+    uint64_t mReuploadsAfterEviction;
+  };
+
+  Stats GetStats();
+
+  /**
+   * Returns a one-line residency summary for the diagnostics overlay, or an
+   * empty string if no budget is configured.
+   */
+  std::string GetReportString();
+
+private:
+  TextureResidencyManager();
+
+  struct Entry : public LinkedListElement<Entry>
+  {
+    Entry(TextureHost* aTexture, size_t aBytes)
+      : mTexture(aTexture)
+      , mBytes(aBytes)
+    {}
+
+    // Raw pointer; the TextureHost unregisters itself before dying.
+    TextureHost* mTexture;
+    size_t mBytes;
+  };
+
+  // Returns the budget in bytes, or 0 if eviction is disabled.
+  static size_t BudgetBytes();
+
+  void EvictIfOverBudget();
+
+  Mutex mLock;
+  // LRU order: the front of the list is the least recently used texture.
+  LinkedList<Entry> mLRU;
+  nsDataHashtable<nsPtrHashKey<TextureHost>, Entry*> mEntries;
+  // Textures we evicted and haven't seen re-uploaded or destroyed yet, for
+  // the churn counter.
+  nsTHashtable<nsPtrHashKey<TextureHost>> mEvicted;
+  Stats mStats;
+};
+
+} // namespace layers
+} // namespace mozilla
+
+#endif // mozilla_gfx_layers_composite_TextureResidencyManager_h
@@ -10,6 +10,11 @@
 
 bool nsRegion::Contains(const nsRegion& aRgn) const
 {
+  // A region can only contain another region if it contains the other
+  // region's bounds, so we can reject most mismatches with two rects.
+  if (!GetBounds().Contains(aRgn.GetBounds())) {
+    return false;
+  }
   // XXX this could be made faster by iterating over
   // both regions at the same time some how
   for (auto iter = aRgn.RectIter(); !iter.Done(); iter.Next()) {
@@ -22,13 +27,14 @@ bool nsRegion::Contains(const nsRegion& aRgn) const
 
 bool nsRegion::Intersects(const nsRect& aRect) const
 {
-  // XXX this could be made faster by using pixman_region32_contains_rect
-  for (auto iter = RectIter(); !iter.Done(); iter.Next()) {
-    if (iter.Get().Intersects(aRect)) {
-      return true;
-    }
+  if (aRect.IsEmpty()) {
+    return false;
   }
-  return false;
+  // pixman_region32_contains_rectangle trivially rejects against the region
+  // extents and then bails out of the band walk as soon as any overlap is
+  // found, unlike iterating over our rects and intersecting each one.
+  pixman_box32_t box = RectToBox(aRect);
+  return pixman_region32_contains_rectangle(Impl(), &box) != PIXMAN_REGION_OUT;
 }
 
 void nsRegion::Inflate(const nsMargin& aMargin)
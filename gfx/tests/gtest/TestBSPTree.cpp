@@ -10,7 +10,6 @@
 #include "PolygonTestUtils.h"
 
 #include <deque>
-#include <list>
 
 using namespace mozilla::gfx;
 using namespace mozilla::layers;
@@ -21,9 +20,9 @@ namespace {
 static void RunTest(std::deque<MozPolygon> aPolygons,
                     std::deque<MozPolygon> aExpected)
 {
-  std::list<LayerPolygon> layers;
+  LayerList layers;
   for (MozPolygon& polygon : aPolygons) {
-    layers.push_back(LayerPolygon(nullptr, Move(polygon)));
+    layers.AppendElement(LayerPolygon(nullptr, Move(polygon)));
   }
 
   const BSPTree tree(layers);
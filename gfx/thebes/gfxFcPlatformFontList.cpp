@@ -12,6 +12,7 @@
 #include "gfxFT2Utils.h"
 #include "gfxPlatform.h"
 #include "mozilla/ArrayUtils.h"
+#include "mozilla/dom/ContentChild.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/TimeStamp.h"
@@ -22,6 +23,7 @@
 #include "nsDirectoryServiceDefs.h"
 #include "nsAppDirectoryServiceDefs.h"
 #include "nsCharSeparatedTokenizer.h"
+#include "nsXULAppAPI.h"
 
 #include "mozilla/gfx/HelpersCairo.h"
 
@@ -1360,6 +1362,24 @@ gfxFcPlatformFontList::AddFontSetFamilies(FcFontSet* aFontSet, bool aAppFonts)
     }
 }
 
+void
+gfxFcPlatformFontList::GetSystemFontPatternList(
+    InfallibleTArray<nsCString>* aPatterns)
+{
+    FcFontSet* systemFonts = FcConfigGetFonts(nullptr, FcSetSystem);
+    if (!systemFonts) {
+        return;
+    }
+    for (int f = 0; f < systemFonts->nfont; f++) {
+        char* s = (char*)FcNameUnparse(systemFonts->fonts[f]);
+        if (!s) {
+            continue;
+        }
+        aPatterns->AppendElement(nsCString(s));
+        free(s);
+    }
+}
+
 nsresult
 gfxFcPlatformFontList::InitFontListForPlatform()
 {
@@ -1368,6 +1388,40 @@ gfxFcPlatformFontList::InitFontListForPlatform()
     mLocalNames.Clear();
     mFcSubstituteCache.Clear();
 
+    if (XRE_IsContentProcess()) {
+        // Content processes use the font list passed down from the chrome
+        // process via SetXPCOMProcessAttributes rather than enumerating
+        // fontconfig themselves, which saves several ms of startup time.
+        auto& patterns =
+            mozilla::dom::ContentChild::GetSingleton()->SystemFontPatternList();
+        if (!patterns.IsEmpty()) {
+            nsAutoRef<FcFontSet> systemFonts(FcFontSetCreate());
+            for (const nsCString& s : patterns) {
+                FcPattern* pattern = FcNameParse(ToFcChar8Ptr(s.get()));
+                if (!pattern) {
+                    continue;
+                }
+                // FcFontSetAdd adopts the pattern reference.
+                if (!FcFontSetAdd(systemFonts, pattern)) {
+                    FcPatternDestroy(pattern);
+                }
+            }
+            // The families and mLocalNames hold their own references to the
+            // patterns, so the set itself need not be kept alive.
+            AddFontSetFamilies(systemFonts, /* aAppFonts = */ false);
+            mAlwaysUseFontconfigGenerics = PrefFontListsUseOnlyGenerics();
+
+#ifdef MOZ_BUNDLED_FONTS
+            ActivateBundledFonts();
+            FcFontSet* appFonts = FcConfigGetFonts(nullptr, FcSetApplication);
+            AddFontSetFamilies(appFonts, /* aAppFonts = */ true);
+#endif
+
+            mOtherFamilyNamesInitialized = true;
+            return NS_OK;
+        }
+    }
+
     // iterate over available fonts
     FcFontSet* systemFonts = FcConfigGetFonts(nullptr, FcSetSystem);
     AddFontSetFamilies(systemFonts, /* aAppFonts = */ false);
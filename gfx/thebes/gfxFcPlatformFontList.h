@@ -254,6 +254,11 @@ public:
                      const nsACString& aGenericFamily,
                      nsTArray<nsString>& aListOfFonts) override;
 
+    // Append a serialized (FcNameUnparse'd) pattern for each system font
+    // to aPatterns; called in the chrome process to ship the font list to
+    // content processes so they can skip the fontconfig enumeration.
+    void GetSystemFontPatternList(InfallibleTArray<nsCString>* aPatterns);
+
 
     gfxFontEntry*
     LookupLocalFont(const nsAString& aFontName, uint16_t aWeight,
@@ -2564,6 +2564,22 @@ gfxFont::AgeCachedWords()
     }
 }
 
+bool
+gfxFont::EvictStaleCachedWords()
+{
+    bool evictedAny = false;
+    if (mWordCache) {
+        for (auto it = mWordCache->Iter(); !it.Done(); it.Next()) {
+            CacheHashEntry *entry = it.Get();
+            if (!entry->mShapedWord || entry->mShapedWord->GetAge() > 0) {
+                it.Remove();
+                evictedAny = true;
+            }
+        }
+    }
+    return evictedAny;
+}
+
 void
 gfxFont::NotifyGlyphsChanged()
 {
@@ -2610,14 +2626,6 @@ gfxFont::GetShapedWord(DrawTarget *aDrawTarget,
                        RoundingFlags aRounding,
                        gfxTextPerfMetrics *aTextPerf GFX_MAYBE_UNUSED)
 {
-    // if the cache is getting too big, flush it and start over
-    uint32_t wordCacheMaxEntries =
-        gfxPlatform::GetPlatform()->WordCacheMaxEntries();
-    if (mWordCache->Count() > wordCacheMaxEntries) {
-        NS_WARNING("flushing shaped-word cache");
-        ClearCachedWords();
-    }
-
     // if there's a cached entry for this word, just return it
     CacheHashKey key(aText, aLength, aHash,
                      aRunScript,
@@ -2633,6 +2641,7 @@ gfxFont::GetShapedWord(DrawTarget *aDrawTarget,
 
     if (sw) {
         sw->ResetAge();
+        Telemetry::Accumulate(Telemetry::WORD_CACHE_HIT, true);
 #ifndef RELEASE_OR_BETA
         if (aTextPerf) {
             aTextPerf->current.wordCacheHit++;
@@ -2641,6 +2650,7 @@ gfxFont::GetShapedWord(DrawTarget *aDrawTarget,
         return sw;
     }
 
+    Telemetry::Accumulate(Telemetry::WORD_CACHE_HIT, false);
 #ifndef RELEASE_OR_BETA
     if (aTextPerf) {
         aTextPerf->current.wordCacheMiss++;
@@ -3004,6 +3014,20 @@ gfxFont::SplitAndInitTextRun(DrawTarget *aDrawTarget,
 
     InitWordCache();
 
+    // If the cache is getting too big, drop the words that haven't been
+    // looked up since the last expiration-timer tick; only flush everything
+    // if that frees nothing, i.e. the whole working set is hot. Doing this
+    // once per run rather than per word keeps cached gfxShapedWord pointers
+    // stable for the duration of the loop below.
+    uint32_t wordCacheMaxEntries =
+        gfxPlatform::GetPlatform()->WordCacheMaxEntries();
+    if (mWordCache->Count() > wordCacheMaxEntries) {
+        if (!EvictStaleCachedWords()) {
+            NS_WARNING("flushing shaped-word cache");
+            ClearCachedWords();
+        }
+    }
+
     // the only flags we care about for ShapedWord construction/caching
     gfx::ShapedTextFlags flags = aTextRun->GetFlags();
     flags &= (gfx::ShapedTextFlags::TEXT_IS_RTL |
@@ -3019,6 +3043,14 @@ gfxFont::SplitAndInitTextRun(DrawTarget *aDrawTarget,
     bool wordIs8Bit = true;
     int32_t appUnitsPerDevUnit = aTextRun->GetAppUnitsPerDevUnit();
 
+    // The shaped word for the most recent boundary space that couldn't use
+    // the simple-glyph shortcut (e.g. no-break space), so that runs with
+    // many such spaces don't repeat the word-cache lookup per occurrence.
+    // Safe to hold across the loop because the cache is only evicted above,
+    // before any lookups.
+    gfxShapedWord* cachedBoundaryWord = nullptr;
+    T cachedBoundaryChar = 0;
+
     T nextCh = aString[0];
     for (uint32_t i = 0; i <= aRunLength; ++i) {
         T ch = nextCh;
@@ -3097,12 +3129,23 @@ gfxFont::SplitAndInitTextRun(DrawTarget *aDrawTarget,
                 // Avoid tautological-constant-out-of-range-compare in 8-bit:
                 DebugOnly<char16_t> boundary16 = boundary;
                 NS_ASSERTION(boundary16 < 256, "unexpected boundary!");
-                gfxShapedWord *sw =
-                    GetShapedWord(aDrawTarget, &boundary, 1,
-                                  gfxShapedWord::HashMix(0, boundary),
-                                  aRunScript, aVertical, appUnitsPerDevUnit,
-                                  flags | gfx::ShapedTextFlags::TEXT_IS_8BIT,
-                                  rounding, tp);
+                gfxShapedWord *sw;
+                if (boundary == cachedBoundaryChar) {
+                    sw = cachedBoundaryWord;
+                    sw->ResetAge();
+                } else {
+                    sw = GetShapedWord(aDrawTarget, &boundary, 1,
+                                       gfxShapedWord::HashMix(0, boundary),
+                                       aRunScript, aVertical,
+                                       appUnitsPerDevUnit,
+                                       flags |
+                                           gfx::ShapedTextFlags::TEXT_IS_8BIT,
+                                       rounding, tp);
+                    if (sw) {
+                        cachedBoundaryWord = sw;
+                        cachedBoundaryChar = boundary;
+                    }
+                }
                 if (sw) {
                     aTextRun->CopyGlyphDataFrom(sw, aRunStart + i);
                 } else {
@@ -1335,6 +1335,9 @@ public:
     uint32_t IncrementAge() {
         return ++mAgeCounter;
     }
+    uint32_t GetAge() const {
+        return mAgeCounter;
+    }
 
     // Helper used when hashing a word for the shaped-word caches
     static uint32_t HashMix(uint32_t aHash, char16_t aCh)
@@ -1854,6 +1857,11 @@ public:
     // so that they'll expire after a sufficient period of non-use
     void AgeCachedWords();
 
+    // Discard cached words that have not been looked up since the last
+    // age increment; called when the cache overflows, so that the hot
+    // working set survives. Returns true if anything was evicted.
+    bool EvictStaleCachedWords();
+
     // Discard all cached word records; called on memory-pressure notification.
     void ClearCachedWords() {
         if (mWordCache) {
@@ -345,6 +345,16 @@ public:
       InfallibleTArray<mozilla::dom::FontFamilyListEntry>* aFontFamilies)
     { }
 
+    /**
+     * Fill aPatterns with serialized (FcNameUnparse'd) patterns for the
+     * system fonts, used to pass the font list from chrome to content
+     * processes so that children need not enumerate fontconfig themselves.
+     * Implemented only on platforms that use fontconfig.
+     */
+    virtual void GetSystemFontPatternList(
+      InfallibleTArray<nsCString>* aPatterns)
+    { }
+
     /**
      * Rebuilds the any cached system font lists
      */
@@ -199,6 +199,13 @@ gfxPlatformGtk::UpdateFontList()
     return NS_OK;
 }
 
+void
+gfxPlatformGtk::GetSystemFontPatternList(InfallibleTArray<nsCString>* aPatterns)
+{
+    gfxFcPlatformFontList::PlatformFontList()->
+        GetSystemFontPatternList(aPatterns);
+}
+
 // xxx - this is ubuntu centric, need to go through other distros and flesh
 // out a more general list
 static const char kFontDejaVuSans[] = "DejaVu Sans";
@@ -41,6 +41,9 @@ public:
 
     virtual nsresult UpdateFontList() override;
 
+    virtual void
+    GetSystemFontPatternList(InfallibleTArray<nsCString>* aPatterns) override;
+
     virtual void
     GetCommonFallbackFonts(uint32_t aCh, uint32_t aNextCh,
                            Script aRunScript,
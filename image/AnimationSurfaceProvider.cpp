@@ -8,6 +8,7 @@
 #include "gfxPrefs.h"
 #include "nsProxyRelease.h"
 
+#include "DecodePool.h"
 #include "Decoder.h"
 
 using namespace mozilla::gfx;
@@ -110,6 +111,14 @@ AnimationSurfaceProvider::LogicalSizeInBytes() const
   return 3 * size.width * size.height * sizeof(uint32_t);
 }
 
+void
+AnimationSurfaceProvider::BumpDecodingPriority()
+{
+  // This is a no-op if our decoding task is no longer waiting in the decode
+  // pool's low-priority queue.
+  DecodePool::Singleton()->BumpPriority(this);
+}
+
 void
 AnimationSurfaceProvider::AddSizeOfExcludingThis(MallocSizeOf aMallocSizeOf,
                                                  size_t& aHeapSizeOut,
@@ -45,6 +45,7 @@ public:
 
   bool IsFinished() const override;
   size_t LogicalSizeInBytes() const override;
+  void BumpDecodingPriority() override;
   void AddSizeOfExcludingThis(MallocSizeOf aMallocSizeOf,
                               size_t& aHeapSizeOut,
                               size_t& aNonHeapSizeOut,
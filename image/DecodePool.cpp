@@ -103,6 +103,21 @@ public:
     mMonitor.Notify();
   }
 
+  /// Moves a queued task to the high-priority queue, if it's still waiting
+  /// in the low-priority queue. Does nothing otherwise.
+  void BumpPriority(IDecodingTask* aTask)
+  {
+    MOZ_ASSERT(aTask);
+
+    MonitorAutoLock lock(mMonitor);
+
+    if (mLowPriorityQueue.RemoveElement(aTask)) {
+      // No need to notify; the queues were already non-empty, so any idle
+      // worker has already been woken up.
+      mHighPriorityQueue.AppendElement(aTask);
+    }
+  }
+
   /// Pops a new work item, blocking if necessary.
   Work PopWork()
   {
@@ -313,6 +328,13 @@ DecodePool::AsyncRun(IDecodingTask* aTask)
   mImpl->PushWork(aTask);
 }
 
+void
+DecodePool::BumpPriority(IDecodingTask* aTask)
+{
+  MOZ_ASSERT(aTask);
+  mImpl->BumpPriority(aTask);
+}
+
 bool
 DecodePool::SyncRunIfPreferred(IDecodingTask* aTask, const nsCString& aURI)
 {
@@ -58,6 +58,14 @@ public:
   /// Ask the DecodePool to run @aTask asynchronously and return immediately.
   void AsyncRun(IDecodingTask* aTask);
 
+  /**
+   * Move @aTask to the high-priority queue if it's still waiting in the
+   * low-priority queue, so decodes for surfaces that something is actively
+   * trying to draw don't wait behind decodes for offscreen images. Does
+   * nothing if @aTask isn't queued (e.g. it's already running or done).
+   */
+  void BumpPriority(IDecodingTask* aTask);
+
   /**
    * Run @aTask synchronously if the task would prefer it. It's up to the task
    * itself to make this decision; @see IDecodingTask::ShouldPreferSyncRun(). If
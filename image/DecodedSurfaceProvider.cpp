@@ -8,6 +8,7 @@
 #include "gfxPrefs.h"
 #include "nsProxyRelease.h"
 
+#include "DecodePool.h"
 #include "Decoder.h"
 
 using namespace mozilla::gfx;
@@ -125,6 +126,14 @@ DecodedSurfaceProvider::LogicalSizeInBytes() const
   return size.width * size.height * sizeof(uint32_t);
 }
 
+void
+DecodedSurfaceProvider::BumpDecodingPriority()
+{
+  // This is a no-op if our decoding task is no longer waiting in the decode
+  // pool's low-priority queue.
+  DecodePool::Singleton()->BumpPriority(this);
+}
+
 void
 DecodedSurfaceProvider::Run()
 {
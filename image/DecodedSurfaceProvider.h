@@ -40,6 +40,7 @@ public:
 public:
   bool IsFinished() const override;
   size_t LogicalSizeInBytes() const override;
+  void BumpDecodingPriority() override;
 
 protected:
   DrawableFrameRef DrawableRef(size_t aFrame) override;
@@ -17,6 +17,7 @@
 #include "nsBMPDecoder.h"
 #include "nsICODecoder.h"
 #include "nsIconDecoder.h"
+#include "nsSurfaceDecoder.h"
 
 namespace mozilla {
 
@@ -65,6 +66,10 @@ DecoderFactory::GetDecoderType(const char* aMimeType)
   // Icon
   } else if (!strcmp(aMimeType, IMAGE_ICON_MS)) {
     type = DecoderType::ICON;
+
+  // Serialized surface (alternate data from the HTTP cache)
+  } else if (!strcmp(aMimeType, IMAGE_MOZ_SURFACE)) {
+    type = DecoderType::SURFACE;
   }
 
   return type;
@@ -100,6 +105,9 @@ DecoderFactory::GetDecoder(DecoderType aType,
     case DecoderType::ICON:
       decoder = new nsIconDecoder(aImage);
       break;
+    case DecoderType::SURFACE:
+      decoder = new nsSurfaceDecoder(aImage);
+      break;
     default:
       MOZ_ASSERT_UNREACHABLE("Unknown decoder type");
   }
@@ -37,6 +37,7 @@ enum class DecoderType
   BMP,
   ICO,
   ICON,
+  SURFACE,
   UNKNOWN
 };
 
@@ -563,6 +563,32 @@ FrameAnimator::CollectSizeOfCompositingSurfaces(
                                        aCounters,
                                        aMallocSizeOf);
   }
+
+  if (mRecycledFrame) {
+    DoCollectSizeOfCompositingSurfaces(mRecycledFrame,
+                                       SurfaceMemoryCounterType::COMPOSITING_PREV,
+                                       aCounters,
+                                       aMallocSizeOf);
+  }
+}
+
+RawAccessFrameRef
+FrameAnimator::AcquireCompositingFrame()
+{
+  // Reuse the buffer we retired the last time DoBlend() was done with a
+  // compositing surface. Without this, animations which use
+  // DisposalMethod::RESTORE_PREVIOUS keep allocating and freeing a full-size
+  // frame for as long as they run.
+  if (mRecycledFrame) {
+    return Move(mRecycledFrame);
+  }
+
+  RefPtr<imgFrame> newFrame = new imgFrame;
+  if (NS_FAILED(newFrame->InitForAnimator(mSize, SurfaceFormat::B8G8R8A8))) {
+    return RawAccessFrameRef();
+  }
+
+  return newFrame->RawAccessRef();
 }
 
 RawAccessFrameRef
@@ -685,14 +711,12 @@ FrameAnimator::DoBlend(DrawableSurface& aFrames,
 
   // Create the Compositing Frame
   if (!mCompositingFrame) {
-    RefPtr<imgFrame> newFrame = new imgFrame;
-    nsresult rv = newFrame->InitForAnimator(mSize,
-                                            SurfaceFormat::B8G8R8A8);
-    if (NS_FAILED(rv)) {
-      mCompositingFrame.reset();
+    mCompositingFrame = AcquireCompositingFrame();
+    if (!mCompositingFrame) {
       return false;
     }
-    mCompositingFrame = newFrame->RawAccessRef();
+    // Whether freshly allocated or recycled, the buffer could have anything
+    // in it.
     needToBlankComposite = true;
   } else if (int32_t(aNextFrameIndex) != mLastCompositedFrameIndex+1) {
 
@@ -763,10 +787,12 @@ FrameAnimator::DoBlend(DrawableSurface& aFrames,
                          compositingFrameData.mRawData,
                          compositingFrameData.mRect);
 
-          // destroy only if we don't need it for this frame's disposal
+          // Retire it if we don't need it for this frame's disposal, but keep
+          // the buffer around so the next RESTORE_PREVIOUS frame doesn't have
+          // to allocate a new one.
           if (nextFrameData.mDisposalMethod !=
               DisposalMethod::RESTORE_PREVIOUS) {
-            mCompositingPrevFrame.reset();
+            mRecycledFrame = Move(mCompositingPrevFrame);
           }
         } else {
           ClearFrame(compositingFrameData.mRawData,
@@ -826,15 +852,10 @@ FrameAnimator::DoBlend(DrawableSurface& aFrames,
     // It would be better if we just stored the area that nextFrame is going to
     // overwrite.
     if (!mCompositingPrevFrame) {
-      RefPtr<imgFrame> newFrame = new imgFrame;
-      nsresult rv = newFrame->InitForAnimator(mSize,
-                                              SurfaceFormat::B8G8R8A8);
-      if (NS_FAILED(rv)) {
-        mCompositingPrevFrame.reset();
+      mCompositingPrevFrame = AcquireCompositingFrame();
+      if (!mCompositingPrevFrame) {
         return false;
       }
-
-      mCompositingPrevFrame = newFrame->RawAccessRef();
     }
 
     AnimationData compositingPrevFrameData =
@@ -357,6 +357,13 @@ private: // methods
                uint32_t aPrevFrameIndex,
                uint32_t aNextFrameIndex);
 
+  /**
+   * Returns a full-size BGRA frame to composite into, either by recycling a
+   * previously retired compositing buffer or by allocating a new one. Returns
+   * an empty ref on allocation failure.
+   */
+  RawAccessFrameRef AcquireCompositingFrame();
+
   /** Clears an area of <aFrame> with transparent black.
    *
    * @param aFrameData Target Frame data
@@ -422,6 +429,14 @@ private: // data
    */
   RawAccessFrameRef mCompositingPrevFrame;
 
+  /** a retired compositing buffer waiting to be reused
+   *
+   * When we are done with mCompositingPrevFrame we stash the buffer here
+   * instead of freeing it, so long-running animations don't reallocate a
+   * full-size frame on every RESTORE_PREVIOUS disposal.
+   */
+  RawAccessFrameRef mRecycledFrame;
+
   //! Track the last composited frame for Optimizations (See DoComposite code)
   int32_t mLastCompositedFrameIndex;
 };
@@ -76,6 +76,13 @@ public:
                                 aNonHeapSizeOut, aSharedHandlesOut);
   }
 
+  /// If this provider has a decoding task which hasn't run yet, raise that
+  /// task's priority in the decode pool. Called by the surface cache when a
+  /// lookup finds this provider's surface still pending, which means
+  /// something is trying to draw it right now. The default implementation
+  /// does nothing, which is appropriate for providers that don't decode.
+  virtual void BumpDecodingPriority() { }
+
   /// @return the availability state of this ISurfaceProvider, which indicates
   /// whether DrawableRef() could successfully return a surface. Should only be
   /// called from SurfaceCache code as it relies on SurfaceCache for
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include "mozilla/Assertions.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/Compression.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Likely.h"
 #include "mozilla/Move.h"
@@ -20,8 +21,10 @@
 #include "mozilla/StaticMutex.h"
 #include "mozilla/StaticPtr.h"
 #include "mozilla/Tuple.h"
+#include "mozilla/UniquePtrExtensions.h"
 #include "nsIMemoryReporter.h"
 #include "gfx2DGlue.h"
+#include "gfxDrawable.h"
 #include "gfxPlatform.h"
 #include "gfxPrefs.h"
 #include "imgFrame.h"
@@ -164,6 +167,8 @@ public:
   void SetCannotSubstitute() { mProvider->Availability().SetCannotSubstitute(); }
   bool CannotSubstitute() const { return mProvider->Availability().CannotSubstitute(); }
 
+  void BumpDecodingPriority() { mProvider->BumpDecodingPriority(); }
+
   bool IsPlaceholder() const { return mProvider->Availability().IsPlaceholder(); }
   bool IsDecoded() const { return !IsPlaceholder() && mProvider->IsFinished(); }
 
@@ -223,6 +228,157 @@ private:
   bool                              mIsLocked;
 };
 
+/**
+ * A CompressedSurface holds an LZ4-compressed copy of the pixel data of a
+ * surface that was evicted from the cache. Decompressing one is far cheaper
+ * than re-decoding the original image, so we keep recently evicted surfaces in
+ * compressed form, under a separate budget, as a middle tier between the
+ * uncompressed cache and a full re-decode. A 32bpp surface typically
+ * compresses to a fraction of its decoded size.
+ */
+class CompressedSurface
+{
+  ~CompressedSurface() { }
+public:
+  MOZ_DECLARE_REFCOUNTED_TYPENAME(CompressedSurface)
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(CompressedSurface)
+
+  /**
+   * Compress the pixel data of @aSurface. Returns nullptr if the surface is
+   * not a finished static surface, if its pixel data is no longer available
+   * (e.g. a purged volatile buffer), or if compression fails. Failure is not
+   * an error; the caller simply discards the surface as it would have anyway.
+   */
+  static already_AddRefed<CompressedSurface>
+  Create(NotNull<CachedSurface*> aSurface)
+  {
+    if (aSurface->IsPlaceholder() || !aSurface->IsDecoded() ||
+        aSurface->GetSurfaceKey().Playback() != PlaybackType::eStatic) {
+      // Only finished static surfaces have pixel data we can snapshot.
+      return nullptr;
+    }
+
+    DrawableSurface drawableSurface = aSurface->GetDrawableSurface();
+    if (!drawableSurface) {
+      return nullptr;
+    }
+
+    RefPtr<SourceSurface> sourceSurface = drawableSurface->GetSourceSurface();
+    if (!sourceSurface) {
+      return nullptr;
+    }
+
+    RefPtr<DataSourceSurface> dataSurface = sourceSurface->GetDataSurface();
+    if (!dataSurface) {
+      return nullptr;
+    }
+
+    DataSourceSurface::ScopedMap map(dataSurface, DataSourceSurface::READ);
+    if (!map.IsMapped()) {
+      return nullptr;
+    }
+
+    const size_t uncompressedSize =
+      size_t(map.GetStride()) * dataSurface->GetSize().height;
+    UniquePtr<char[]> worstCase = MakeUniqueFallible<char[]>(
+      Compression::LZ4::maxCompressedSize(uncompressedSize));
+    if (!worstCase) {
+      return nullptr;
+    }
+
+    size_t compressedSize =
+      Compression::LZ4::compress(reinterpret_cast<const char*>(map.GetData()),
+                                 uncompressedSize, worstCase.get());
+    if (compressedSize == 0) {
+      return nullptr;
+    }
+
+    // Copy into a buffer of exactly the right size; the worst-case buffer may
+    // be substantially larger than the compressed output.
+    UniquePtr<char[]> data = MakeUniqueFallible<char[]>(compressedSize);
+    if (!data) {
+      return nullptr;
+    }
+    memcpy(data.get(), worstCase.get(), compressedSize);
+
+    RefPtr<CompressedSurface> compressed =
+      new CompressedSurface(aSurface->GetImageKey(), aSurface->GetSurfaceKey(),
+                            dataSurface->GetSize(), dataSurface->GetFormat(),
+                            map.GetStride(), Move(data), compressedSize,
+                            uncompressedSize);
+    return compressed.forget();
+  }
+
+  /**
+   * Decompress into a new imgFrame. Returns nullptr on failure, in which case
+   * the caller will have to fall back to a full re-decode.
+   */
+  already_AddRefed<imgFrame> Decompress() const
+  {
+    RefPtr<DataSourceSurface> surface =
+      Factory::CreateDataSourceSurfaceWithStride(mSize, mFormat, mStride);
+    if (!surface) {
+      return nullptr;
+    }
+
+    {
+      DataSourceSurface::ScopedMap map(surface, DataSourceSurface::WRITE);
+      if (!map.IsMapped() ||
+          !Compression::LZ4::decompress(mData.get(),
+                                        reinterpret_cast<char*>(map.GetData()),
+                                        mUncompressedSize)) {
+        return nullptr;
+      }
+    }
+
+    // Draw the decompressed pixels into a new imgFrame, the same way
+    // VectorImage caches rasterizations. This marks the frame finished.
+    RefPtr<gfxDrawable> drawable = new gfxSurfaceDrawable(surface, mSize);
+    RefPtr<imgFrame> frame = new imgFrame;
+    nsresult rv =
+      frame->InitWithDrawable(drawable, mSize, mFormat,
+                              SamplingFilter::POINT, imgIContainer::FLAG_NONE,
+                              gfxPlatform::GetPlatform()->GetSoftwareBackend());
+    if (NS_FAILED(rv)) {
+      return nullptr;
+    }
+
+    return frame.forget();
+  }
+
+  ImageKey GetImageKey() const { return mImageKey; }
+  const SurfaceKey& GetSurfaceKey() const { return mSurfaceKey; }
+  size_t SizeInBytes() const { return mCompressedSize; }
+
+private:
+  CompressedSurface(const ImageKey aImageKey,
+                    const SurfaceKey& aSurfaceKey,
+                    const IntSize& aSize,
+                    SurfaceFormat aFormat,
+                    int32_t aStride,
+                    UniquePtr<char[]> aData,
+                    size_t aCompressedSize,
+                    size_t aUncompressedSize)
+    : mImageKey(aImageKey)
+    , mSurfaceKey(aSurfaceKey)
+    , mSize(aSize)
+    , mFormat(aFormat)
+    , mStride(aStride)
+    , mData(Move(aData))
+    , mCompressedSize(aCompressedSize)
+    , mUncompressedSize(aUncompressedSize)
+  { }
+
+  const ImageKey      mImageKey;
+  const SurfaceKey    mSurfaceKey;
+  const IntSize       mSize;
+  const SurfaceFormat mFormat;
+  const int32_t       mStride;
+  UniquePtr<char[]>   mData;
+  const size_t        mCompressedSize;
+  const size_t        mUncompressedSize;
+};
+
 static int64_t
 AreaOfIntSize(const IntSize& aSize) {
   return static_cast<int64_t>(aSize.width) * static_cast<int64_t>(aSize.height);
@@ -400,6 +556,9 @@ public:
         }
       } else if (exactMatch != bestMatch) {
         // The exact match is still decoding, but we found a substitute.
+        // Raise the pending decode's priority, since the caller is going to
+        // draw the substitute and will want the real thing soon.
+        exactMatch->BumpDecodingPriority();
         matchType = MatchType::SUBSTITUTE_BECAUSE_PENDING;
       } else {
         const IntSize& bestMatchSize = bestMatch->GetSurfaceKey().Size();
@@ -415,6 +574,7 @@ public:
       if (exactMatch) {
         // We found an "exact match"; it must have been a placeholder.
         MOZ_ASSERT(exactMatch->IsPlaceholder());
+        exactMatch->BumpDecodingPriority();
         matchType = MatchType::PENDING;
       } else {
         // We couldn't find an exact match *or* a substitute.
@@ -694,7 +854,8 @@ public:
 
   SurfaceCacheImpl(uint32_t aSurfaceCacheExpirationTimeMS,
                    uint32_t aSurfaceCacheDiscardFactor,
-                   uint32_t aSurfaceCacheSize)
+                   uint32_t aSurfaceCacheSize,
+                   uint32_t aCompressedCacheSize)
     : mExpirationTracker(aSurfaceCacheExpirationTimeMS)
     , mMemoryPressureObserver(new MemoryPressureObserver)
     , mDiscardFactor(aSurfaceCacheDiscardFactor)
@@ -702,6 +863,8 @@ public:
     , mAvailableCost(aSurfaceCacheSize)
     , mLockedCost(0)
     , mOverflowCount(0)
+    , mCompressedMaxCost(aCompressedCacheSize)
+    , mCompressedCost(0)
   {
     nsCOMPtr<nsIObserverService> os = services::GetObserverService();
     if (os) {
@@ -759,7 +922,8 @@ public:
     while (cost > mAvailableCost) {
       MOZ_ASSERT(!mCosts.IsEmpty(),
                  "Removed everything and it still won't fit");
-      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true, aAutoLock);
+      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true, aAutoLock,
+             /* aForEviction */ true);
     }
 
     // Locate the appropriate per-image cache. If there's not an existing cache
@@ -809,13 +973,21 @@ public:
 
   void Remove(NotNull<CachedSurface*> aSurface,
               bool aStopTracking,
-              const StaticMutexAutoLock& aAutoLock)
+              const StaticMutexAutoLock& aAutoLock,
+              bool aForEviction = false)
   {
     ImageKey imageKey = aSurface->GetImageKey();
 
     RefPtr<ImageSurfaceCache> cache = GetImageCache(imageKey);
     MOZ_ASSERT(cache, "Shouldn't try to remove a surface with no image cache");
 
+    // If we're evicting this surface to reclaim memory, try to keep a
+    // compressed copy of its pixels so that a later lookup can rehydrate it
+    // instead of triggering a full re-decode.
+    if (aForEviction) {
+      MaybeCompress(aSurface);
+    }
+
     // If the surface was not a placeholder, tell its image that we discarded it.
     if (!aSurface->IsPlaceholder()) {
       static_cast<Image*>(imageKey)->OnSurfaceDiscarded(aSurface->GetSurfaceKey());
@@ -898,18 +1070,29 @@ public:
                       bool aMarkUsed = true)
   {
     RefPtr<ImageSurfaceCache> cache = GetImageCache(aImageKey);
-    if (!cache) {
-      // No cached surfaces for this image.
-      return LookupResult(MatchType::NOT_FOUND);
-    }
-
-    RefPtr<CachedSurface> surface = cache->Lookup(aSurfaceKey, aMarkUsed);
+    RefPtr<CachedSurface> surface =
+      cache ? cache->Lookup(aSurfaceKey, aMarkUsed) : nullptr;
     if (!surface) {
-      // Lookup in the per-image cache missed.
+      // Lookup in the per-image cache missed, but we may still hold a
+      // compressed copy of this surface, which is far cheaper to rehydrate
+      // than to re-decode. Skip this for bookkeeping lookups (!aMarkUsed),
+      // which don't need pixel data.
+      if (aMarkUsed) {
+        DrawableSurface rehydrated =
+          RehydrateCompressedSurface(aImageKey, aSurfaceKey, aAutoLock);
+        if (rehydrated) {
+          return LookupResult(Move(rehydrated), MatchType::EXACT);
+        }
+      }
       return LookupResult(MatchType::NOT_FOUND);
     }
 
     if (surface->IsPlaceholder()) {
+      if (aMarkUsed) {
+        // Something is trying to draw this surface right now; make sure its
+        // decode isn't stuck behind decodes for offscreen images.
+        surface->BumpDecodingPriority();
+      }
       return LookupResult(MatchType::PENDING);
     }
 
@@ -1083,6 +1266,15 @@ public:
     // This implicitly unlocks the image if it was locked.
     mImageCaches.Remove(aImageKey);
 
+    // Drop any compressed copies of this image's surfaces as well; the image
+    // key will no longer be valid.
+    for (int32_t i = mCompressedSurfaces.Length() - 1; i >= 0; --i) {
+      if (mCompressedSurfaces[i]->GetImageKey() == aImageKey) {
+        mCompressedCost -= mCompressedSurfaces[i]->SizeInBytes();
+        mCompressedSurfaces.RemoveElementAt(i);
+      }
+    }
+
     // Since we did not actually remove any of the surfaces from the cache
     // itself, only stopped tracking them, we should free it outside the lock.
     return cache.forget();
@@ -1112,6 +1304,11 @@ public:
     while (!mCosts.IsEmpty()) {
       Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true, aAutoLock);
     }
+
+    // The compressed tier exists only to avoid re-decodes; when we're asked
+    // to discard everything, free it too.
+    mCompressedSurfaces.Clear();
+    mCompressedCost = 0;
   }
 
   void DiscardForMemoryPressure(const StaticMutexAutoLock& aAutoLock)
@@ -1133,10 +1330,14 @@ public:
       return;
     }
 
-    // Discard surfaces until we've reduced our cost to our target cost.
+    // Discard surfaces until we've reduced our cost to our target cost. Note
+    // that we compress the evicted surfaces: a compressed copy is a fraction
+    // of the decoded size, and rehydrating it later is much cheaper than the
+    // full re-decode these evictions would otherwise force.
     while (mAvailableCost < targetCost) {
       MOZ_ASSERT(!mCosts.IsEmpty(), "Removed everything and still not done");
-      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true, aAutoLock);
+      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true, aAutoLock,
+             /* aForEviction */ true);
     }
   }
 
@@ -1182,6 +1383,12 @@ public:
       KIND_OTHER, UNITS_BYTES, mLockedCost,
 "Estimated memory used by locked surfaces in the imagelib surface cache.");
 
+    MOZ_COLLECT_REPORT(
+      "imagelib-surface-cache-compressed",
+      KIND_OTHER, UNITS_BYTES, mCompressedCost,
+"Estimated memory used by compressed copies of surfaces evicted from the "
+"imagelib surface cache.");
+
     MOZ_COLLECT_REPORT(
       "imagelib-surface-cache-overflow-count",
       KIND_OTHER, UNITS_COUNT, mOverflowCount,
@@ -1289,6 +1496,88 @@ private:
     }
   }
 
+  // Attempt to store a compressed copy of a surface we're evicting. Failure
+  // here is not an error; the surface is simply discarded as it would have
+  // been anyway. Note that compression happens with the cache lock held; LZ4
+  // is fast enough (and evictions rare enough) that this is preferable to the
+  // complexity of handing the pixels off to another thread.
+  void MaybeCompress(NotNull<CachedSurface*> aSurface)
+  {
+    if (mCompressedMaxCost == 0) {
+      return;  // The compressed tier is disabled.
+    }
+
+    RefPtr<CompressedSurface> compressed = CompressedSurface::Create(aSurface);
+    if (!compressed) {
+      return;
+    }
+
+    const Cost cost = compressed->SizeInBytes();
+    if (cost > mCompressedMaxCost) {
+      return;
+    }
+
+    // Replace any stale compressed copy of the same surface. (This can happen
+    // if the surface was re-decoded and is now being evicted again.)
+    RefPtr<CompressedSurface> stale =
+      TakeCompressedSurface(aSurface->GetImageKey(), aSurface->GetSurfaceKey());
+
+    // Make room, discarding the least recently inserted entries first.
+    while (mCompressedCost + cost > mCompressedMaxCost) {
+      MOZ_ASSERT(!mCompressedSurfaces.IsEmpty(),
+                 "Removed everything and it still won't fit");
+      mCompressedCost -= mCompressedSurfaces[0]->SizeInBytes();
+      mCompressedSurfaces.RemoveElementAt(0);
+    }
+
+    mCompressedSurfaces.AppendElement(compressed.forget());
+    mCompressedCost += cost;
+  }
+
+  already_AddRefed<CompressedSurface>
+  TakeCompressedSurface(const ImageKey aImageKey, const SurfaceKey& aSurfaceKey)
+  {
+    for (uint32_t i = 0; i < mCompressedSurfaces.Length(); ++i) {
+      if (mCompressedSurfaces[i]->GetImageKey() == aImageKey &&
+          mCompressedSurfaces[i]->GetSurfaceKey() == aSurfaceKey) {
+        RefPtr<CompressedSurface> compressed = Move(mCompressedSurfaces[i]);
+        mCompressedSurfaces.RemoveElementAt(i);
+        mCompressedCost -= compressed->SizeInBytes();
+        return compressed.forget();
+      }
+    }
+    return nullptr;
+  }
+
+  // Attempt to satisfy a lookup miss from the compressed tier. On success the
+  // rehydrated surface is reinserted into the cache so that subsequent
+  // lookups find it without decompressing again.
+  DrawableSurface
+  RehydrateCompressedSurface(const ImageKey aImageKey,
+                             const SurfaceKey& aSurfaceKey,
+                             const StaticMutexAutoLock& aAutoLock)
+  {
+    RefPtr<CompressedSurface> compressed =
+      TakeCompressedSurface(aImageKey, aSurfaceKey);
+    if (!compressed) {
+      return DrawableSurface();
+    }
+
+    RefPtr<imgFrame> frame = compressed->Decompress();
+    if (!frame) {
+      return DrawableSurface();
+    }
+
+    // Reinsert the rehydrated surface. Even if Insert() fails, the caller can
+    // still draw |frame|; we just lose the benefit of caching it.
+    NotNull<RefPtr<ISurfaceProvider>> provider =
+      WrapNotNull(new SimpleSurfaceProvider(aImageKey, aSurfaceKey,
+                                            WrapNotNull(frame.get())));
+    Insert(provider, /* aSetAvailable = */ false, aAutoLock);
+
+    return DrawableSurface(frame->DrawableRef());
+  }
+
   void RemoveEntry(const ImageKey    aImageKey,
                    const SurfaceKey& aSurfaceKey,
                    const StaticMutexAutoLock& aAutoLock)
@@ -1324,7 +1613,8 @@ private:
     void NotifyExpiredLocked(CachedSurface* aSurface,
                              const StaticMutexAutoLock& aAutoLock) override
     {
-      sInstance->Remove(WrapNotNull(aSurface), /* aStopTracking */ true, aAutoLock);
+      sInstance->Remove(WrapNotNull(aSurface), /* aStopTracking */ true,
+                        aAutoLock, /* aForEviction */ true);
     }
 
     void NotifyHandlerEndLocked(const StaticMutexAutoLock& aAutoLock) override
@@ -1380,6 +1670,12 @@ private:
   Cost                                    mAvailableCost;
   Cost                                    mLockedCost;
   size_t                                  mOverflowCount;
+
+  // Compressed copies of evicted surfaces, oldest first, and the budget they
+  // are held under. A zero budget disables the compressed tier entirely.
+  nsTArray<RefPtr<CompressedSurface>>     mCompressedSurfaces;
+  const Cost                              mCompressedMaxCost;
+  Cost                                    mCompressedCost;
 };
 
 NS_IMPL_ISUPPORTS(SurfaceCacheImpl, nsIMemoryReporter)
@@ -1436,12 +1732,22 @@ SurfaceCache::Initialize()
   uint32_t finalSurfaceCacheSizeBytes =
     min(surfaceCacheSizeBytes, uint64_t(UINT32_MAX));
 
+  // Maximum size of the compressed surface tier, in kilobytes. When nonzero,
+  // surfaces evicted from the cache have their pixel data recompressed with
+  // LZ4 and retained under this separate budget, so that a later lookup can
+  // rehydrate them instead of re-decoding the image. Zero disables the tier.
+  uint64_t compressedMaxSizeKB =
+    gfxPrefs::ImageMemSurfaceCacheCompressedMaxSizeKB();
+  uint32_t compressedCacheSizeBytes =
+    min(compressedMaxSizeKB * 1024, uint64_t(UINT32_MAX));
+
   // Create the surface cache singleton with the requested settings.  Note that
   // the size is a limit that the cache may not grow beyond, but we do not
   // actually allocate any storage for surfaces at this time.
   sInstance = new SurfaceCacheImpl(surfaceCacheExpirationTimeMS,
                                    surfaceCacheDiscardFactor,
-                                   finalSurfaceCacheSizeBytes);
+                                   finalSurfaceCacheSizeBytes,
+                                   compressedCacheSizeBytes);
   sInstance->InitMemoryReporter();
 }
 
@@ -23,6 +23,7 @@
 #include "jerror.h"
 
 #include "gfxPlatform.h"
+#include "gfxPrefs.h"
 #include "mozilla/EndianUtils.h"
 #include "mozilla/Telemetry.h"
 
@@ -484,12 +485,32 @@ nsJPEGDecoder::ReadJPEGData(const char* aData, size_t aLength)
               (status != JPEG_REACHED_EOI))
             scan--;
 
+          // Rendering an output pass costs a full-image decompress, color
+          // conversion and (possibly) downscale, so re-rendering for every
+          // scan that arrives makes large progressive JPEGs O(scans * pixels)
+          // to decode. Once we've displayed a pass, throttle further
+          // intermediate passes to one per
+          // image.jpeg.progressive.min-pass-interval-ms and just accumulate
+          // coefficients in between. The final pass (input complete) is never
+          // skipped.
+          if ((status != JPEG_REACHED_EOI) &&
+              (mInfo.output_scan_number > 0) &&
+              !mLastProgressivePass.IsNull() &&
+              (TimeStamp::Now() - mLastProgressivePass).ToMilliseconds() <
+                gfxPrefs::ImageJpegProgressiveMinPassIntervalMS()) {
+            MOZ_LOG(sJPEGDecoderAccountingLog, LogLevel::Debug,
+                   ("} (throttling progressive pass %d)", scan));
+            return Transition::ContinueUnbuffered(State::JPEG_DATA); // I/O suspension
+          }
+
           if (!jpeg_start_output(&mInfo, scan)) {
             MOZ_LOG(sJPEGDecoderAccountingLog, LogLevel::Debug,
                    ("} (I/O suspension after jpeg_start_output() -"
                     " PROGRESSIVE)"));
             return Transition::ContinueUnbuffered(State::JPEG_DATA); // I/O suspension
           }
+
+          mLastProgressivePass = TimeStamp::Now();
         }
 
         if (mInfo.output_scanline == 0xffffff) {
@@ -15,6 +15,7 @@
 
 #include "Decoder.h"
 
+#include "mozilla/TimeStamp.h"
 #include "nsIInputStream.h"
 #include "nsIPipe.h"
 #include "qcms.h"
@@ -110,6 +111,11 @@ public:
   const Decoder::DecodeStyle mDecodeStyle;
 
   uint32_t mCMSMode;
+
+  // The time at which we last began outputting a progressive pass, used to
+  // limit how often intermediate passes are rendered while data is still
+  // arriving. Null until the first pass begins.
+  TimeStamp mLastProgressivePass;
 };
 
 } // namespace image
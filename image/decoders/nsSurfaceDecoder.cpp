@@ -0,0 +1,283 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsSurfaceDecoder.h"
+#include "RasterImage.h"
+#include "SurfacePipeFactory.h"
+#include "mozilla/Compression.h"
+#include "mozilla/UniquePtrExtensions.h"
+#include "nsIOutputStream.h"
+
+using namespace mozilla::gfx;
+
+namespace mozilla {
+namespace image {
+
+// 'MzSf', stored in platform endianness like the rest of the blob.
+static const uint32_t SURFACE_BLOB_MAGIC = 0x4D7A5366;
+static const uint32_t SURFACE_BLOB_VERSION = 1;
+
+// Magic, version, width, height and format, four bytes each.
+static const uint32_t SURFACE_BLOB_HEADER_SIZE = 20;
+
+// The length field which precedes each compressed row.
+static const uint32_t SURFACE_BLOB_ROW_LENGTH_SIZE = 4;
+
+nsSurfaceDecoder::nsSurfaceDecoder(RasterImage* aImage)
+ : Decoder(aImage)
+ , mLexer(Transition::To(State::HEADER, SURFACE_BLOB_HEADER_SIZE),
+          Transition::TerminateSuccess())
+ , mFormat(SurfaceFormat::UNKNOWN)  // set by ReadHeader()
+ , mBytesPerRow()                   // set by ReadHeader()
+{
+  // Nothing to do
+}
+
+nsSurfaceDecoder::~nsSurfaceDecoder()
+{ }
+
+LexerResult
+nsSurfaceDecoder::DoDecode(SourceBufferIterator& aIterator, IResumable* aOnResume)
+{
+  MOZ_ASSERT(!HasError(), "Shouldn't call DoDecode after error!");
+
+  return mLexer.Lex(aIterator, aOnResume,
+                    [=](State aState, const char* aData, size_t aLength) {
+    switch (aState) {
+      case State::HEADER:
+        return ReadHeader(aData);
+      case State::ROW_LENGTH:
+        return ReadRowLength(aData);
+      case State::ROW:
+        return ReadRow(aData, aLength);
+      case State::FINISH:
+        return Finish();
+      default:
+        MOZ_CRASH("Unknown State");
+    }
+  });
+}
+
+LexerTransition<nsSurfaceDecoder::State>
+nsSurfaceDecoder::ReadHeader(const char* aData)
+{
+  uint32_t magic, version, format;
+  int32_t width, height;
+  memcpy(&magic,   aData + 0,  4);
+  memcpy(&version, aData + 4,  4);
+  memcpy(&width,   aData + 8,  4);
+  memcpy(&height,  aData + 12, 4);
+  memcpy(&format,  aData + 16, 4);
+
+  // Only we ever write these blobs, but a truncated or corrupted cache entry
+  // still has to fail cleanly, so validate everything.
+  if (magic != SURFACE_BLOB_MAGIC || version != SURFACE_BLOB_VERSION) {
+    return Transition::TerminateFailure();
+  }
+  if (width <= 0 || height <= 0 || width > 65535 || height > 65535) {
+    return Transition::TerminateFailure();
+  }
+  if (format != uint32_t(SurfaceFormat::B8G8R8A8) &&
+      format != uint32_t(SurfaceFormat::B8G8R8X8)) {
+    return Transition::TerminateFailure();
+  }
+
+  mFormat = SurfaceFormat(format);
+
+  // The pixels are 32bpp, so we expect 4 bytes of data per pixel.
+  mBytesPerRow = uint32_t(width) * 4;
+
+  // Post our size to the superclass.
+  PostSize(width, height);
+
+  if (format == uint32_t(SurfaceFormat::B8G8R8A8)) {
+    PostHasTransparency();
+  }
+
+  // If we're doing a metadata decode, we're done.
+  if (IsMetadataDecode()) {
+    return Transition::TerminateSuccess();
+  }
+
+  MOZ_ASSERT(!mImageData, "Already have a buffer allocated?");
+  Maybe<SurfacePipe> pipe =
+    SurfacePipeFactory::CreateSurfacePipe(this, 0, Size(), OutputSize(),
+                                          FullFrame(), mFormat,
+                                          SurfacePipeFlags());
+  if (!pipe) {
+    return Transition::TerminateFailure();
+  }
+
+  mPipe = Move(*pipe);
+
+  MOZ_ASSERT(mImageData, "Should have a buffer now");
+
+  mRowBuffer = MakeUniqueFallible<char[]>(mBytesPerRow);
+  if (!mRowBuffer) {
+    return Transition::TerminateFailure();
+  }
+
+  return Transition::To(State::ROW_LENGTH, SURFACE_BLOB_ROW_LENGTH_SIZE);
+}
+
+LexerTransition<nsSurfaceDecoder::State>
+nsSurfaceDecoder::ReadRowLength(const char* aData)
+{
+  uint32_t compressedLength;
+  memcpy(&compressedLength, aData, 4);
+
+  if (compressedLength == 0 ||
+      compressedLength > Compression::LZ4::maxCompressedSize(mBytesPerRow)) {
+    return Transition::TerminateFailure();
+  }
+
+  return Transition::To(State::ROW, compressedLength);
+}
+
+LexerTransition<nsSurfaceDecoder::State>
+nsSurfaceDecoder::ReadRow(const char* aData, size_t aLength)
+{
+  // Use the bounds-checked decompressor; a malformed row must not be able to
+  // write outside the row buffer.
+  size_t decompressedLength = 0;
+  if (!Compression::LZ4::decompress(aData, aLength, mRowBuffer.get(),
+                                    mBytesPerRow, &decompressedLength) ||
+      decompressedLength != mBytesPerRow) {
+    return Transition::TerminateFailure();
+  }
+
+  const char* rowPtr = mRowBuffer.get();
+  size_t remaining = mBytesPerRow;
+
+  auto result = mPipe.WritePixels<uint32_t>([&]() -> NextPixel<uint32_t> {
+    if (remaining == 0) {
+      return AsVariant(WriteState::NEED_MORE_DATA);  // Done with this row.
+    }
+
+    uint32_t pixel;
+    memcpy(&pixel, rowPtr, 4);
+    rowPtr += 4;
+    remaining -= 4;
+
+    return AsVariant(pixel);
+  });
+
+  MOZ_ASSERT(result != WriteState::FAILURE);
+
+  Maybe<SurfaceInvalidRect> invalidRect = mPipe.TakeInvalidRect();
+  if (invalidRect) {
+    PostInvalidation(invalidRect->mInputSpaceRect,
+                     Some(invalidRect->mOutputSpaceRect));
+  }
+
+  return result == WriteState::FINISHED
+       ? Transition::To(State::FINISH, 0)
+       : Transition::To(State::ROW_LENGTH, SURFACE_BLOB_ROW_LENGTH_SIZE);
+}
+
+LexerTransition<nsSurfaceDecoder::State>
+nsSurfaceDecoder::Finish()
+{
+  PostFrameStop(mFormat == SurfaceFormat::B8G8R8A8 ? Opacity::SOME_TRANSPARENCY
+                                                   : Opacity::FULLY_OPAQUE);
+  PostDecodeDone();
+
+  return Transition::TerminateSuccess();
+}
+
+static nsresult
+WriteAll(nsIOutputStream* aStream, const char* aData, uint32_t aLength)
+{
+  while (aLength > 0) {
+    uint32_t written = 0;
+    nsresult rv = aStream->Write(aData, aLength, &written);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+    if (written == 0) {
+      return NS_ERROR_FAILURE;
+    }
+    aData += written;
+    aLength -= written;
+  }
+
+  return NS_OK;
+}
+
+/* static */ nsresult
+nsSurfaceDecoder::WriteSurfaceBlob(DataSourceSurface* aSurface,
+                                   nsIOutputStream* aStream)
+{
+  MOZ_ASSERT(aSurface);
+  MOZ_ASSERT(aStream);
+
+  SurfaceFormat format = aSurface->GetFormat();
+  if (format != SurfaceFormat::B8G8R8A8 && format != SurfaceFormat::B8G8R8X8) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  IntSize size = aSurface->GetSize();
+  if (size.width <= 0 || size.height <= 0 ||
+      size.width > 65535 || size.height > 65535) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  DataSourceSurface::ScopedMap map(aSurface, DataSourceSurface::READ);
+  if (!map.IsMapped()) {
+    return NS_ERROR_FAILURE;
+  }
+
+  const uint32_t bytesPerRow = uint32_t(size.width) * 4;
+  UniquePtr<char[]> compressed =
+    MakeUniqueFallible<char[]>(Compression::LZ4::maxCompressedSize(bytesPerRow));
+  if (!compressed) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  char header[SURFACE_BLOB_HEADER_SIZE];
+  uint32_t magic = SURFACE_BLOB_MAGIC;
+  uint32_t version = SURFACE_BLOB_VERSION;
+  int32_t width = size.width;
+  int32_t height = size.height;
+  uint32_t formatField = uint32_t(format);
+  memcpy(header + 0,  &magic,       4);
+  memcpy(header + 4,  &version,     4);
+  memcpy(header + 8,  &width,       4);
+  memcpy(header + 12, &height,      4);
+  memcpy(header + 16, &formatField, 4);
+
+  nsresult rv = WriteAll(aStream, header, sizeof(header));
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  for (int32_t row = 0; row < height; ++row) {
+    const char* source = reinterpret_cast<const char*>(map.GetData()) +
+                         row * map.GetStride();
+    size_t compressedLength =
+      Compression::LZ4::compress(source, bytesPerRow, compressed.get());
+    if (compressedLength == 0) {
+      return NS_ERROR_FAILURE;
+    }
+
+    uint32_t lengthField = uint32_t(compressedLength);
+    rv = WriteAll(aStream, reinterpret_cast<const char*>(&lengthField),
+                  SURFACE_BLOB_ROW_LENGTH_SIZE);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
+    rv = WriteAll(aStream, compressed.get(), lengthField);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+  }
+
+  return NS_OK;
+}
+
+} // namespace image
+} // namespace mozilla
@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_image_decoders_nsSurfaceDecoder_h
+#define mozilla_image_decoders_nsSurfaceDecoder_h
+
+#include "Decoder.h"
+#include "StreamingLexer.h"
+#include "SurfacePipe.h"
+#include "mozilla/UniquePtr.h"
+#include "mozilla/gfx/2D.h"
+
+class nsIOutputStream;
+
+namespace mozilla {
+namespace image {
+
+class RasterImage;
+
+////////////////////////////////////////////////////////////////////////////////
+// The surface decoder rehydrates decoded surfaces which we previously
+// serialized into the HTTP cache as alternate data, so that revisits of an
+// image can skip the real (JPEG, PNG, ...) decoder entirely. We define our own
+// little format for these blobs; nobody on the network ever speaks it, and the
+// decoder is only reachable when the cache tells us it served our own
+// alternate data. The blob layout is:
+//
+// A fixed-size header containing a magic number, a version, the surface's
+// width and height, and its gfx::SurfaceFormat. After the header come
+// |height| row records, top-to-bottom; each record is a 32-bit compressed
+// length followed by that many bytes of LZ4 data which decompress to exactly
+// |width| * 4 bytes of pixels in the stated format. All integers are in
+// platform endianness, since the blob never leaves the local cache.
+//
+// Compressing row-by-row keeps both sides streaming: the writer never holds
+// more than one compressed row, and we can feed each row through the
+// SurfacePipe (including downscale-during-decode) as it arrives.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class nsSurfaceDecoder : public Decoder
+{
+public:
+  virtual ~nsSurfaceDecoder();
+
+  LexerResult DoDecode(SourceBufferIterator& aIterator,
+                       IResumable* aOnResume) override;
+
+  /**
+   * Serializes @aSurface to @aStream in the format this decoder reads. Safe to
+   * call on any thread. Returns an error if the surface's format cannot be
+   * represented or if writing to the stream fails; the stream is not closed
+   * in either case.
+   */
+  static nsresult WriteSurfaceBlob(gfx::DataSourceSurface* aSurface,
+                                   nsIOutputStream* aStream);
+
+private:
+  friend class DecoderFactory;
+
+  // Decoders should only be instantiated via DecoderFactory.
+  explicit nsSurfaceDecoder(RasterImage* aImage);
+
+  enum class State {
+    HEADER,
+    ROW_LENGTH,
+    ROW,
+    FINISH
+  };
+
+  LexerTransition<State> ReadHeader(const char* aData);
+  LexerTransition<State> ReadRowLength(const char* aData);
+  LexerTransition<State> ReadRow(const char* aData, size_t aLength);
+  LexerTransition<State> Finish();
+
+  StreamingLexer<State> mLexer;
+  SurfacePipe mPipe;
+  UniquePtr<char[]> mRowBuffer;
+  gfx::SurfaceFormat mFormat;
+  uint32_t mBytesPerRow;
+};
+
+} // namespace image
+} // namespace mozilla
+
+#endif // mozilla_image_decoders_nsSurfaceDecoder_h
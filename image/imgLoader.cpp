@@ -857,6 +857,18 @@ NewImageChannel(nsIChannel** aResult,
     MOZ_ASSERT(NS_SUCCEEDED(rv));
     rv = newHttpChannel->SetReferrerWithPolicy(aReferringURI, aReferrerPolicy);
     MOZ_ASSERT(NS_SUCCEEDED(rv));
+
+    // If we previously serialized this image's decoded surface into the HTTP
+    // cache as alternate data, ask for that representation instead of the
+    // original encoded bytes so we can skip the decoder on a cache hit.
+    if (gfxPrefs::ImageCacheSurfaceAltDataEnabled()) {
+      nsCOMPtr<nsICacheInfoChannel> cacheChannel =
+        do_QueryInterface(newHttpChannel);
+      if (cacheChannel) {
+        cacheChannel->PreferAlternativeDataType(
+          NS_LITERAL_CSTRING(IMAGE_MOZ_SURFACE));
+      }
+    }
   }
 
   // Image channels are loaded by default with reduced priority.
@@ -15,12 +15,15 @@
 #include "Image.h"
 #include "MultipartImage.h"
 #include "RasterImage.h"
+#include "nsSurfaceDecoder.h"
+#include "gfxPrefs.h"
 
 #include "nsIChannel.h"
 #include "nsICacheInfoChannel.h"
 #include "nsIDocument.h"
 #include "nsIThreadRetargetableRequest.h"
 #include "nsIInputStream.h"
+#include "nsIOutputStream.h"
 #include "nsIMultiPartChannel.h"
 #include "nsIHttpChannel.h"
 #include "nsIApplicationCache.h"
@@ -38,6 +41,7 @@
 #include "imgIRequest.h"
 
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Unused.h"
 
 using namespace mozilla;
 using namespace mozilla::image;
@@ -69,6 +73,7 @@ imgRequest::imgRequest(imgLoader* aLoader, const ImageCacheKey& aCacheKey)
  , mDecodeRequested(false)
  , mNewPartPending(false)
  , mHadInsecureRedirect(false)
+ , mReceivedSurfaceAltData(false)
 {
   LOG_FUNC(gImgLog, "imgRequest::imgRequest()");
 }
@@ -819,6 +824,23 @@ imgRequest::OnStartRequest(nsIRequest* aRequest, nsISupports* ctxt)
         return rv;
       }
     }
+
+    // Check whether the HTTP cache served us a previously serialized surface
+    // as alternate data, and if it didn't, hold on to the cache info channel
+    // in case we want to write one out after this image's first decode.
+    if (gfxPrefs::ImageCacheSurfaceAltDataEnabled() && !multiPartChannel) {
+      nsCOMPtr<nsICacheInfoChannel> cacheChannel = do_QueryInterface(channel);
+      if (cacheChannel) {
+        nsAutoCString altDataType;
+        cacheChannel->GetAlternativeDataType(altDataType);
+        if (altDataType.EqualsLiteral(IMAGE_MOZ_SURFACE)) {
+          MutexAutoLock lock(mMutex);
+          mReceivedSurfaceAltData = true;
+        } else if (altDataType.IsEmpty()) {
+          mCacheInfoChannel = cacheChannel;
+        }
+      }
+    }
   }
 
   SetCacheValidation(mCacheEntry, aRequest);
@@ -900,6 +922,12 @@ imgRequest::OnStopRequest(nsIRequest* aRequest,
     status = NS_OK; // fake happy face
   }
 
+  // Only a load that completed cleanly is a candidate for serializing its
+  // decoded surface into the cache entry.
+  if (NS_FAILED(status) || isPartial || !lastPart) {
+    mCacheInfoChannel = nullptr;
+  }
+
   // Tell the image that it has all of the source data. Note that this can
   // trigger a failure, since the image might be waiting for more non-optional
   // data and this is the point where we break the news that it's not coming.
@@ -990,11 +1018,18 @@ struct NewPartResult final
 static NewPartResult
 PrepareForNewPart(nsIRequest* aRequest, nsIInputStream* aInStr, uint32_t aCount,
                   ImageURL* aURI, bool aIsMultipart, image::Image* aExistingImage,
-                  ProgressTracker* aProgressTracker, uint32_t aInnerWindowId)
+                  ProgressTracker* aProgressTracker, uint32_t aInnerWindowId,
+                  bool aUsingSurfaceAltData)
 {
   NewPartResult result(aExistingImage);
 
-  if (aInStr) {
+  if (aUsingSurfaceAltData) {
+    // The channel is delivering a serialized surface we previously wrote into
+    // the HTTP cache, not the bytes the server sent, so the content type comes
+    // from us. Don't sniff: the surface decoder must only ever be reachable
+    // via the cache's alternate data, never from network-supplied bytes.
+    result.mContentType.AssignLiteral(IMAGE_MOZ_SURFACE);
+  } else if (aInStr) {
     mimetype_closure closure;
     closure.newType = &result.mContentType;
 
@@ -1139,6 +1174,7 @@ imgRequest::OnDataAvailable(nsIRequest* aRequest, nsISupports* aContext,
   RefPtr<ProgressTracker> progressTracker;
   bool isMultipart = false;
   bool newPartPending = false;
+  bool usingSurfaceAltData = false;
 
   // Retrieve and update our state.
   {
@@ -1149,6 +1185,7 @@ imgRequest::OnDataAvailable(nsIRequest* aRequest, nsISupports* aContext,
     isMultipart = mIsMultiPartChannel;
     newPartPending = mNewPartPending;
     mNewPartPending = false;
+    usingSurfaceAltData = mReceivedSurfaceAltData;
   }
 
   // If this is a new part, we need to sniff its content type and create an
@@ -1156,7 +1193,8 @@ imgRequest::OnDataAvailable(nsIRequest* aRequest, nsISupports* aContext,
   if (newPartPending) {
     NewPartResult result = PrepareForNewPart(aRequest, aInStr, aCount, mURI,
                                              isMultipart, image,
-                                             progressTracker, mInnerWindowId);
+                                             progressTracker, mInnerWindowId,
+                                             usingSurfaceAltData);
     bool succeeded = result.mSucceeded;
 
     if (result.mImage) {
@@ -1240,6 +1278,68 @@ imgRequest::SetProperties(const nsACString& aContentType,
   }
 }
 
+void
+imgRequest::OnDecodeComplete()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (mWroteSurfaceAltData || !mCacheInfoChannel) {
+    return;
+  }
+
+  // One attempt per request, whether or not it succeeds. Several proxies may
+  // deliver the same DECODE_COMPLETE notification.
+  mWroteSurfaceAltData = true;
+  nsCOMPtr<nsICacheInfoChannel> cacheChannel = mCacheInfoChannel.forget();
+
+  RefPtr<Image> image = GetImage();
+  if (!image || image->HasError() ||
+      image->GetType() != imgIContainer::TYPE_RASTER) {
+    return;
+  }
+
+  bool animated = false;
+  if (NS_FAILED(image->GetAnimated(&animated)) || animated) {
+    return;
+  }
+
+  int32_t width = 0;
+  int32_t height = 0;
+  image->GetWidth(&width);
+  image->GetHeight(&height);
+
+  RefPtr<gfx::SourceSurface> surface =
+    image->GetFrame(imgIContainer::FRAME_FIRST, imgIContainer::FLAG_NONE);
+  if (!surface || surface->GetSize() != gfx::IntSize(width, height)) {
+    // The decode that just finished was for a downscaled size. A revisit may
+    // want a different size, so only native-size surfaces are worth keeping.
+    return;
+  }
+
+  RefPtr<gfx::DataSourceSurface> dataSurface = surface->GetDataSurface();
+  if (!dataSurface) {
+    return;
+  }
+
+  nsCOMPtr<nsIOutputStream> stream;
+  nsresult rv = cacheChannel->OpenAlternativeOutputStream(
+    NS_LITERAL_CSTRING(IMAGE_MOZ_SURFACE), getter_AddRefs(stream));
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  // Compressing the surface isn't cheap, so serialize it on the DecodePool's
+  // IO thread. If writing fails the cache just keeps the original bytes.
+  nsCOMPtr<nsIEventTarget> target = DecodePool::Singleton()->GetIOEventTarget();
+  nsCOMPtr<nsIRunnable> runnable =
+    NS_NewRunnableFunction("imgRequest::OnDecodeComplete",
+                           [dataSurface, stream]() -> void {
+    Unused << nsSurfaceDecoder::WriteSurfaceBlob(dataSurface, stream);
+    stream->Close();
+  });
+  target->Dispatch(runnable.forget(), NS_DISPATCH_NORMAL);
+}
+
 static nsresult
 sniff_mimetype_callback(nsIInputStream* in,
                         void* data,
@@ -27,6 +27,7 @@ class imgLoader;
 class imgRequestProxy;
 class imgCacheEntry;
 class nsIApplicationCache;
+class nsICacheInfoChannel;
 class nsIProperties;
 class nsIRequest;
 class nsITimedChannel;
@@ -208,6 +209,11 @@ public:
   void SetProperties(const nsACString& aContentType,
                      const nsACString& aContentDisposition);
 
+  // Called on the main thread, via our proxies, when the image's first full
+  // decode finishes. If the surface alt-data pref is enabled, this is where
+  // we serialize the decoded surface into the HTTP cache entry.
+  void OnDecodeComplete();
+
   nsIProperties* Properties() const { return mProperties; }
 
   bool HasConsumers() const;
@@ -250,6 +256,11 @@ private:
   nsCOMPtr<nsIInterfaceRequestor> mPrevChannelSink;
   nsCOMPtr<nsIApplicationCache> mApplicationCache;
 
+  // Non-null between OnStartRequest and OnDecodeComplete if the channel's
+  // cache entry is a candidate for storing the decoded surface as alternate
+  // data. Main thread only.
+  nsCOMPtr<nsICacheInfoChannel> mCacheInfoChannel;
+
   nsCOMPtr<nsITimedChannel> mTimedChannel;
 
   nsCString mContentType;
@@ -285,6 +296,10 @@ private:
   // The categories of prioritization strategy that have been requested.
   uint32_t mBoostCategoriesRequested = 0;
 
+  // Whether OnDecodeComplete() has already attempted to serialize a surface
+  // for this request. Main thread only.
+  bool mWroteSurfaceAltData = false;
+
   mutable mozilla::Mutex mMutex;
 
   // Member variables protected by mMutex. Note that *all* flags in our bitfield
@@ -298,6 +313,9 @@ private:
   bool mDecodeRequested : 1;
   bool mNewPartPending : 1;
   bool mHadInsecureRedirect : 1;
+  // Whether the channel served us a serialized surface from the HTTP cache
+  // instead of the original encoded image.
+  bool mReceivedSurfaceAltData : 1;
 };
 
 #endif // mozilla_image_imgRequest_h
@@ -961,6 +961,12 @@ imgRequestProxy::Notify(int32_t aType, const mozilla::gfx::IntRect* aRect)
     return;
   }
 
+  if (aType == imgINotificationObserver::DECODE_COMPLETE && GetOwner()) {
+    // Give our owner a chance to serialize the decoded surface into the
+    // HTTP cache entry as alternate data.
+    GetOwner()->OnDecodeComplete();
+  }
+
   // Make sure the listener stays alive while we notify.
   nsCOMPtr<imgINotificationObserver> listener(mListener);
 
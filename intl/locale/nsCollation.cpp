@@ -68,20 +68,27 @@ nsCollation::EnsureCollator(const int32_t newStrength)
   if (mHasCollator && (mLastStrength == newStrength))
     return NS_OK;
 
-  nsresult res;
-  res = CleanUpCollator();
-  NS_ENSURE_SUCCESS(res, res);
-
-  UErrorCode status;
-  status = U_ZERO_ERROR;
-  mCollatorICU = ucol_open(mLocale.get(), &status);
-  NS_ENSURE_TRUE(U_SUCCESS(status), NS_ERROR_FAILURE);
+  UErrorCode status = U_ZERO_ERROR;
+  if (!mHasCollator) {
+    mCollatorICU = ucol_open(mLocale.get(), &status);
+    if (U_FAILURE(status)) {
+      // The locale requested at Initialize() turned out not to be usable;
+      // fall back to the application locale.
+      status = U_ZERO_ERROR;
+      mozilla::LocaleService::GetInstance()->GetAppLocaleAsLangTag(mLocale);
+      mCollatorICU = ucol_open(mLocale.get(), &status);
+      NS_ENSURE_TRUE(U_SUCCESS(status), NS_ERROR_FAILURE);
+    }
+    mHasCollator = true;
+  }
 
   UCollationStrength strength;
   UColAttributeValue caseLevel;
-  res = ConvertStrength(newStrength, &strength, &caseLevel);
+  nsresult res = ConvertStrength(newStrength, &strength, &caseLevel);
   NS_ENSURE_SUCCESS(res, res);
 
+  // A strength change only touches attributes of the open collator, so
+  // reuse it rather than reopening it and reloading the collation data.
   status = U_ZERO_ERROR;
   ucol_setAttribute(mCollatorICU, UCOL_STRENGTH, strength, &status);
   NS_ENSURE_TRUE(U_SUCCESS(status), NS_ERROR_FAILURE);
@@ -118,20 +125,12 @@ nsCollation::Initialize(const nsACString& locale)
 {
   NS_ENSURE_TRUE((!mInit), NS_ERROR_ALREADY_INITIALIZED);
 
-  // Check whether locale parameter is valid.  If no, use application locale
-  UErrorCode status = U_ZERO_ERROR;
-  UCollator* collator = ucol_open(PromiseFlatCString(locale).get(), &status);
-  if (U_SUCCESS(status)) {
-    mLocale = locale;
-  } else {
-    status = U_ZERO_ERROR;
-    mozilla::LocaleService::GetInstance()->GetAppLocaleAsLangTag(mLocale);
-    collator = ucol_open(mLocale.get(), &status);
-    if (NS_WARN_IF(U_FAILURE(status))) {
-      return NS_ERROR_UNEXPECTED;
-    }
-  }
-  ucol_close(collator);
+  // Just record the requested locale here; it is validated, with fallback
+  // to the application locale, when the collator is first opened by
+  // EnsureCollator(). Opening a throwaway collator to validate the locale
+  // up front would page in ICU collation data in processes that create a
+  // collation object but never collate anything.
+  mLocale = locale;
 
   mInit = true;
   return NS_OK;
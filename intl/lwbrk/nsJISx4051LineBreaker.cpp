@@ -8,10 +8,16 @@
 #include "nsJISx4051LineBreaker.h"
 
 #include "jisx4051class.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/SSE.h"
 #include "nsComplexBreaker.h"
 #include "nsTArray.h"
 #include "nsUnicodeProperties.h"
 
+#ifdef MOZILLA_PRESUME_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace mozilla::unicode;
 
 /*
@@ -582,6 +588,104 @@ GetPairConservative(int8_t c1, int8_t c2)
   return (0 == ((gPairConservative[c1] >> c2) & 0x0001));
 }
 
+// ASCII letters, digits and plain spaces dominate the text we break for
+// Western locales, and they form a closed system under the pair tables:
+// they never need contextual analysis, they map to CLASS_CHARACTER,
+// CLASS_NUMERIC and CLASS_BREAKABLE respectively, and for every pair
+// drawn from those three classes gPair and gPairConservative agree, with
+// a break allowed exactly where a space meets either neighbor. So inside
+// a run of such characters the break opportunities can be computed with
+// a simple space test instead of the per-character lookup chains.
+
+static inline bool
+IS_SIMPLE_BREAK_CHAR(char32_t u)
+{
+  return u == U_SPACE ||
+         IS_ASCII_DIGIT(u) ||
+         (0x0041 <= u && u <= 0x005a) ||  // A-Z
+         (0x0061 <= u && u <= 0x007a);    // a-z
+}
+
+// Returns the end of the run of simple characters starting at aPos, i.e.
+// the index of the first character at or after aPos that needs the full
+// classifier (or aLength if there is none).
+static uint32_t
+FindSimpleRunEnd(const uint8_t* aChars, uint32_t aPos, uint32_t aLength)
+{
+  uint32_t pos = aPos;
+
+#ifdef MOZILLA_PRESUME_SSE2
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i digitLo = _mm_set1_epi8('0' - 1);
+  const __m128i digitHi = _mm_set1_epi8('9' + 1);
+  const __m128i letterLo = _mm_set1_epi8('a' - 1);
+  const __m128i letterHi = _mm_set1_epi8('z' + 1);
+  const __m128i caseBit = _mm_set1_epi8(0x20);
+  while (pos + 16 <= aLength) {
+    __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aChars + pos));
+    // Bytes >= 0x80 are negative in the signed comparisons below, so they
+    // fall outside both ranges and correctly terminate the run.
+    __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chunk, digitLo),
+                                   _mm_cmplt_epi8(chunk, digitHi));
+    __m128i lowered = _mm_or_si128(chunk, caseBit);
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(lowered, letterLo),
+                                    _mm_cmplt_epi8(lowered, letterHi));
+    __m128i simple = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                  _mm_or_si128(digits, letters));
+    uint32_t mask = uint32_t(_mm_movemask_epi8(simple)) ^ 0xFFFF;
+    if (mask) {
+      return pos + mozilla::CountTrailingZeroes32(mask);
+    }
+    pos += 16;
+  }
+#endif
+
+  while (pos < aLength && IS_SIMPLE_BREAK_CHAR(aChars[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
+static uint32_t
+FindSimpleRunEnd(const char16_t* aChars, uint32_t aPos, uint32_t aLength)
+{
+  uint32_t pos = aPos;
+
+#ifdef MOZILLA_PRESUME_SSE2
+  const __m128i space = _mm_set1_epi16(' ');
+  const __m128i digitLo = _mm_set1_epi16('0' - 1);
+  const __m128i digitHi = _mm_set1_epi16('9' + 1);
+  const __m128i letterLo = _mm_set1_epi16('a' - 1);
+  const __m128i letterHi = _mm_set1_epi16('z' + 1);
+  const __m128i caseBit = _mm_set1_epi16(0x20);
+  while (pos + 8 <= aLength) {
+    __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aChars + pos));
+    // Code units above 0x7A, including surrogates, fall outside both
+    // ranges and correctly terminate the run.
+    __m128i digits = _mm_and_si128(_mm_cmpgt_epi16(chunk, digitLo),
+                                   _mm_cmplt_epi16(chunk, digitHi));
+    __m128i lowered = _mm_or_si128(chunk, caseBit);
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi16(lowered, letterLo),
+                                    _mm_cmplt_epi16(lowered, letterHi));
+    __m128i simple = _mm_or_si128(_mm_cmpeq_epi16(chunk, space),
+                                  _mm_or_si128(digits, letters));
+    uint32_t mask = uint32_t(_mm_movemask_epi8(simple)) ^ 0xFFFF;
+    if (mask) {
+      // Two mask bits per code unit.
+      return pos + (mozilla::CountTrailingZeroes32(mask) >> 1);
+    }
+    pos += 8;
+  }
+#endif
+
+  while (pos < aLength && IS_SIMPLE_BREAK_CHAR(aChars[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
 nsJISx4051LineBreaker::nsJISx4051LineBreaker()
 {
 }
@@ -638,6 +742,10 @@ public:
     ++mIndex;
   }
 
+  void AdvanceIndexBy(uint32_t aCount) {
+    mIndex += aCount;
+  }
+
   void NotifyBreakBefore() { mLastBreakIndex = mIndex; }
 
 // A word of western language should not be broken. But even if the word has
@@ -784,6 +892,47 @@ private:
   bool mHasPreviousBackslash;  // True if we have seen a U_BACKSLASH
 };
 
+// Computes break opportunities for aChars in (aRunStart, aRunEnd), where
+// aChars[aRunStart] has already been classified by the caller and every
+// character of the run satisfies IS_SIMPLE_BREAK_CHAR. Returns the class
+// of the last character of the run, which becomes the caller's lastClass.
+template<typename CharT>
+static int8_t
+ClassifySimpleRun(const CharT* aChars, uint32_t aRunStart, uint32_t aRunEnd,
+                  uint8_t aWordBreak, uint8_t* aBreakBefore,
+                  ContextState& aState)
+{
+  uint32_t lastBreak = aRunStart;
+  bool prevIsSpace = aChars[aRunStart] == U_SPACE;
+  for (uint32_t i = aRunStart + 1; i < aRunEnd; ++i) {
+    bool isSpace = aChars[i] == U_SPACE;
+    bool allowBreak;
+    if (aWordBreak == nsILineBreaker::kWordBreak_Normal) {
+      allowBreak = prevIsSpace || isSpace;
+    } else {
+      allowBreak = (aWordBreak == nsILineBreaker::kWordBreak_BreakAll);
+    }
+    aBreakBefore[i] = allowBreak;
+    if (allowBreak) {
+      lastBreak = i;
+    }
+    prevIsSpace = isSpace;
+  }
+
+  // Leave the ContextState bookkeeping exactly as the per-character loop
+  // would have: the last non-hyphen character seen is the last character
+  // of the run, and the last break index is the last position we set.
+  aState.NotifyNonHyphenCharacter(aChars[aRunEnd - 1]);
+  if (lastBreak > aRunStart) {
+    aState.AdvanceIndexBy(lastBreak - aRunStart);
+    aState.NotifyBreakBefore();
+    aState.AdvanceIndexBy(aRunEnd - 1 - lastBreak);
+  } else {
+    aState.AdvanceIndexBy(aRunEnd - 1 - aRunStart);
+  }
+  return GetClass(aChars[aRunEnd - 1]);
+}
+
 static int8_t
 ContextualAnalysis(char32_t prev, char32_t cur, char32_t next,
                    ContextState &aState)
@@ -997,6 +1146,20 @@ nsJISx4051LineBreaker::GetJISx4051Breaks(const char16_t* aChars, uint32_t aLengt
     if (allowBreak)
       state.NotifyBreakBefore();
     lastClass = cl;
+
+    // One-shot classification of runs of ASCII letters, digits and spaces;
+    // see IS_SIMPLE_BREAK_CHAR above. ch cannot be CLASS_COMPLEX or a
+    // surrogate pair if it qualifies, so skipping ahead here does not
+    // bypass the blocks below.
+    if (IS_SIMPLE_BREAK_CHAR(ch)) {
+      uint32_t runEnd = FindSimpleRunEnd(aChars, cur + 1, aLength);
+      if (runEnd > cur + 1) {
+        lastClass = ClassifySimpleRun(aChars, cur, runEnd, aWordBreak,
+                                      aBreakBefore, state);
+        cur = runEnd - 1;
+      }
+    }
+
     if (CLASS_COMPLEX == cl) {
       uint32_t end = cur + chLen;
 
@@ -1075,5 +1238,16 @@ nsJISx4051LineBreaker::GetJISx4051Breaks(const uint8_t* aChars, uint32_t aLength
     if (allowBreak)
       state.NotifyBreakBefore();
     lastClass = cl;
+
+    // One-shot classification of runs of ASCII letters, digits and spaces;
+    // see IS_SIMPLE_BREAK_CHAR above.
+    if (IS_SIMPLE_BREAK_CHAR(ch)) {
+      uint32_t runEnd = FindSimpleRunEnd(aChars, cur + 1, aLength);
+      if (runEnd > cur + 1) {
+        lastClass = ClassifySimpleRun(aChars, cur, runEnd, aWordBreak,
+                                      aBreakBefore, state);
+        cur = runEnd - 1;
+      }
+    }
   }
 }
@@ -384,6 +384,13 @@ bool Pickle::ReadString(PickleIterator* iter, std::string* result) const {
   if (!ReadLength(iter, &len))
     return false;
 
+  // Assign straight out of the message buffer when the bytes sit in one
+  // segment there, instead of staging them through a scratch copy.
+  if (const char* data = ReadBytesZeroCopy(iter, len)) {
+    result->assign(data, len);
+    return true;
+  }
+
   auto chars = mozilla::MakeUnique<char[]>(len);
   if (!ReadBytesInto(iter, chars.get(), len)) {
     return false;
@@ -403,6 +410,13 @@ bool Pickle::ReadWString(PickleIterator* iter, std::wstring* result) const {
   if (len > INT_MAX / static_cast<int>(sizeof(wchar_t)))
     return false;
 
+  // The payload is always aligned at least as strictly as wchar_t, so a
+  // contiguous run can be consumed in place.
+  if (const char* data = ReadBytesZeroCopy(iter, len * sizeof(wchar_t))) {
+    result->assign(reinterpret_cast<const wchar_t*>(data), len);
+    return true;
+  }
+
   auto chars = mozilla::MakeUnique<wchar_t[]>(len);
   if (!ReadBytesInto(iter, chars.get(), len * sizeof(wchar_t))) {
     return false;
@@ -450,6 +464,25 @@ bool Pickle::ReadBytesInto(PickleIterator* iter, void* data, uint32_t length) co
   return iter->iter_.AdvanceAcrossSegments(buffers_, AlignInt(length) - length);
 }
 
+const char* Pickle::ReadBytesZeroCopy(PickleIterator* iter, uint32_t length) const {
+  if (length == 0 || AlignInt(length) < length) {
+    return nullptr;
+  }
+
+  const char* data = buffers_.ReadBytesZeroCopy(iter->iter_, length);
+  if (!data) {
+    return nullptr;
+  }
+
+  if (!iter->iter_.AdvanceAcrossSegments(buffers_, AlignInt(length) - length)) {
+    // The message is truncated inside the padding; any further read will
+    // fail, so the caller's fallback path can only fail too.
+    return nullptr;
+  }
+
+  return data;
+}
+
 #ifdef MOZ_PICKLE_SENTINEL_CHECKING
 bool Pickle::ReadSentinel(PickleIterator* iter, uint32_t sentinel) const {
   uint32_t found;
@@ -109,6 +109,12 @@ class Pickle {
   MOZ_MUST_USE bool ReadString(PickleIterator* iter, std::string* result) const;
   MOZ_MUST_USE bool ReadWString(PickleIterator* iter, std::wstring* result) const;
   MOZ_MUST_USE bool ReadBytesInto(PickleIterator* iter, void* data, uint32_t length) const;
+  // Returns a pointer to the next |length| payload bytes when they sit
+  // contiguously in one underlying buffer segment, advancing *iter past
+  // them; returns null otherwise, in which case the caller should fall back
+  // to ReadBytesInto. The view aliases the message buffer, so it is only
+  // for callers that consume the bytes before the message goes away.
+  const char* ReadBytesZeroCopy(PickleIterator* iter, uint32_t length) const;
   MOZ_MUST_USE bool ExtractBuffers(PickleIterator* iter, size_t length, BufferList* buffers,
                                    uint32_t alignment = sizeof(memberAlignmentType)) const;
 
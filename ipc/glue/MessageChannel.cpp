@@ -22,6 +22,7 @@
 #include "nsDebug.h"
 #include "nsISupportsImpl.h"
 #include "nsContentUtils.h"
+#include "ProfilerCounters.h"
 #include <math.h>
 
 #ifdef MOZ_TASK_TRACER
@@ -135,6 +136,12 @@ static const uint32_t kMinTelemetryIPCWriteLatencyMs = 1;
 // (IPC_SYNC_MAIN_LATENCY_MS and IPC_SYNC_RECEIVE_MS).
 static const uint32_t kMinTelemetrySyncIPCLatencyMs = 1;
 
+// When a MessageTask runs it drains further pending async messages headed
+// for the same event target at the same priority, so a burst of small
+// messages costs one event-loop task instead of one apiece. This budget
+// bounds how long a single task may monopolize the event loop that way.
+static const double kMaxMessageBatchDurationMs = 1.0;
+
 const int32_t MessageChannel::kNoTimeout = INT32_MIN;
 
 // static
@@ -912,6 +919,10 @@ MessageChannel::Send(Message* aMsg)
 void
 MessageChannel::SendMessageToLink(Message* aMsg)
 {
+    // Counts messages handed to the link layer, including ones that are
+    // postponed and flushed later.
+    PROFILER_COUNTER_ADD(ProfilerCounterID::IpcMessagesSent, 1);
+
     if (mIsPostponingSends) {
         UniquePtr<Message> msg(aMsg);
         mPostponedSends.push_back(Move(msg));
@@ -1145,6 +1156,8 @@ MessageChannel::OnMessageReceivedFromLink(Message&& aMsg)
     AssertLinkThread();
     mMonitor->AssertCurrentThreadOwns();
 
+    PROFILER_COUNTER_ADD(ProfilerCounterID::IpcMessagesReceived, 1);
+
     if (MaybeInterceptSpecialIOMessage(aMsg))
         return;
 
@@ -1925,7 +1938,61 @@ MessageChannel::MessageTask::Run()
         return NS_OK;
     }
 
+    // Capture what we need for batching below before RunMessage() moves the
+    // message out of this task.
+    uint32_t priority = Msg().priority();
+    bool mayBatch = !Msg().is_sync() && !Msg().is_interrupt();
+    nsCOMPtr<nsIEventTarget> eventTarget =
+        mChannel->mListener->GetMessageEventTarget(Msg());
+
     mChannel->RunMessage(*this);
+
+    if (!mayBatch) {
+        return NS_OK;
+    }
+
+    // Bursty protocols queue up many small messages at once. Drain further
+    // pending async messages headed for the same event target at the same
+    // priority here, up to a small time budget, instead of paying a full
+    // event-loop round trip for each one. The tasks already posted for the
+    // messages we run become no-ops once their message leaves the pending
+    // list. Messages of other priorities keep their own tasks, so
+    // input-priority traffic still preempts through the prioritized event
+    // queue.
+    TimeStamp batchStart = TimeStamp::Now();
+    while (mChannel && mChannel->Connected()) {
+        RefPtr<MessageTask> next;
+        for (MessageTask* task : mChannel->mPending) {
+            Message& msg = task->Msg();
+            if (msg.priority() != priority ||
+                mChannel->mListener->GetMessageEventTarget(msg) != eventTarget) {
+                // Other priorities and other event targets are already
+                // scheduled independently of us; leave them to their own
+                // tasks.
+                continue;
+            }
+            if (msg.is_sync() || msg.is_interrupt() ||
+                !mChannel->ShouldRunMessage(msg)) {
+                // Delivery for a given target and priority is in-order, so
+                // stop at the first message we can't run here rather than
+                // reorder around it.
+                break;
+            }
+            next = task;
+            break;
+        }
+        if (!next) {
+            break;
+        }
+
+        mChannel->RunMessage(*next);
+
+        if ((TimeStamp::Now() - batchStart).ToMilliseconds() >=
+            kMaxMessageBatchDurationMs) {
+            break;
+        }
+    }
+
     return NS_OK;
 }
 
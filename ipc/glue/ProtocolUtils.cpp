@@ -593,6 +593,7 @@ IToplevelProtocol::IToplevelProtocol(ProtocolId aProtoId, Side aSide)
    mOtherPid(mozilla::ipc::kInvalidProcessId),
    mLastRouteId(aSide == ParentSide ? kFreedActorId : kNullActorId),
    mLastShmemId(aSide == ParentSide ? kFreedActorId : kNullActorId),
+   mShmemPoolBytes(0),
    mEventTargetMutex("ProtocolEventTargetMutex")
 {
 }
@@ -720,12 +721,44 @@ IToplevelProtocol::Unregister(int32_t aId)
   mEventTargetMap.RemoveIfPresent(aId);
 }
 
+// Limits on the shmem segments parked for reuse, per top-level actor.
+// gfx and media allocate same-sized segments at frame rate, so exact-size
+// reuse is the common case; the byte cap keeps a burst of large segments
+// from staying committed in both processes indefinitely.
+static const size_t kShmemPoolMaxSegments = 16;
+static const size_t kShmemPoolMaxBytes = 32 * 1024 * 1024;
+
 Shmem::SharedMemory*
 IToplevelProtocol::CreateSharedMemory(size_t aSize,
                                       Shmem::SharedMemory::SharedMemoryType aType,
                                       bool aUnsafe,
                                       Shmem::id_t* aId)
 {
+  for (size_t i = 0; i < mShmemPool.Length(); i++) {
+    const PooledShmemSegment& entry = mShmemPool[i];
+    if (entry.mSize != aSize) {
+      continue;
+    }
+#ifdef DEBUG
+    // Only debug builds bake the unsafe flag into the segment, so only
+    // they have to match on it.
+    if (entry.mUnsafe != aUnsafe) {
+      continue;
+    }
+#endif
+    Shmem::SharedMemory* pooledSegment = LookupSharedMemory(entry.mId);
+    MOZ_ASSERT(pooledSegment, "pooled segment not in the shmem map?");
+    if (pooledSegment->Type() != aType) {
+      continue;
+    }
+    // The segment is still mapped and registered under this id on both
+    // sides of the channel, so reuse is purely local bookkeeping.
+    *aId = entry.mId;
+    mShmemPoolBytes -= entry.mSize;
+    mShmemPool.RemoveElementAt(i);
+    return pooledSegment;
+  }
+
   RefPtr<Shmem::SharedMemory> segment(
     Shmem::Alloc(Shmem::IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead(), aSize, aType, aUnsafe));
   if (!segment) {
@@ -770,6 +803,27 @@ IToplevelProtocol::DestroySharedMemory(Shmem& shmem)
     return false;
   }
 
+  size_t nBytes = shmem.Size<char>();
+  if (GetIPCChannel()->CanSend() &&
+      mShmemPool.Length() < kShmemPoolMaxSegments &&
+      mShmemPoolBytes + nBytes <= kShmemPoolMaxBytes) {
+    // Park the segment for reuse instead of tearing it down.  Skipping
+    // the ShmemDestroyed message leaves it mapped and registered on both
+    // sides, so handing it back out later costs no segment creation,
+    // descriptor transfer, or mapping work.
+    PooledShmemSegment* entry = mShmemPool.AppendElement();
+    entry->mId = aId;
+    entry->mSize = nBytes;
+#ifdef DEBUG
+    entry->mUnsafe = Shmem::IsUnsafe(
+      Shmem::IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead(), segment);
+#else
+    entry->mUnsafe = false;
+#endif
+    mShmemPoolBytes += nBytes;
+    return true;
+  }
+
   Message* descriptor = shmem.UnshareFrom(
     Shmem::IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead(), OtherPid(), MSG_ROUTING_CONTROL);
 
@@ -791,6 +845,11 @@ IToplevelProtocol::DeallocShmems()
     Shmem::Dealloc(Shmem::IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead(), cit->second);
   }
   mShmemMap.Clear();
+
+  // Pooled segments live in mShmemMap and were just deallocated with the
+  // rest; drop the now-stale pool entries.
+  mShmemPool.Clear();
+  mShmemPoolBytes = 0;
 }
 
 bool
@@ -817,6 +876,15 @@ IToplevelProtocol::ShmemDestroyed(const Message& aMsg)
 
   Shmem::SharedMemory* rawmem = LookupSharedMemory(id);
   if (rawmem) {
+    // The peer shouldn't destroy a segment we parked for reuse, but
+    // ShmemDestroyed is unchecked; never leave a stale id in the pool.
+    for (size_t i = 0; i < mShmemPool.Length(); i++) {
+      if (mShmemPool[i].mId == id) {
+        mShmemPoolBytes -= mShmemPool[i].mSize;
+        mShmemPool.RemoveElementAt(i);
+        break;
+      }
+    }
     mShmemMap.Remove(id);
     Shmem::Dealloc(Shmem::IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead(), rawmem);
   }
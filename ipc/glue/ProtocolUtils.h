@@ -30,6 +30,7 @@
 #include "mozilla/UniquePtr.h"
 #include "MainThreadUtils.h"
 #include "nsILabelableRunnable.h"
+#include "nsTArray.h"
 
 #if defined(ANDROID) && defined(DEBUG)
 #include <android/log.h>
@@ -430,6 +431,18 @@ protected:
     GetActorEventTargetInternal(IProtocol* aActor);
 
   private:
+    // A shmem segment that was deallocated while the channel could still
+    // send is parked here instead of being torn down.  It stays mapped
+    // and registered in mShmemMap on both sides, so a later
+    // CreateSharedMemory() of the same size can hand it back out without
+    // creating, sharing, or mapping a new segment.
+    struct PooledShmemSegment
+    {
+        Shmem::id_t mId;
+        size_t mSize;
+        bool mUnsafe;
+    };
+
     ProtocolId mProtocolId;
     UniquePtr<Transport> mTrans;
     base::ProcessId mOtherPid;
@@ -437,6 +450,8 @@ protected:
     int32_t mLastRouteId;
     IDMap<Shmem::SharedMemory*> mShmemMap;
     Shmem::id_t mLastShmemId;
+    nsTArray<PooledShmemSegment> mShmemPool;
+    size_t mShmemPoolBytes;
     bool mIsMainThreadProtocol;
 
     Mutex mEventTargetMutex;
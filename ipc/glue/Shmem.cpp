@@ -417,6 +417,24 @@ Shmem::Dealloc(IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead,
   DestroySegment(aSegment);
 }
 
+// static
+bool
+Shmem::IsUnsafe(IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead,
+                SharedMemory* aSegment)
+{
+  size_t pageSize = SharedMemory::SystemPageSize();
+  Header* header = GetHeader(aSegment);
+
+  // The header lives in the front sentinel, which has no access rights
+  // while the segment is owned by this process; open it up just long
+  // enough to read the flag.
+  aSegment->Protect(reinterpret_cast<char*>(header), pageSize, RightsRead);
+  bool unsafe = !!header->mUnsafe;
+  aSegment->Protect(reinterpret_cast<char*>(header), pageSize, RightsNone);
+
+  return unsafe;
+}
+
 
 #else  // !defined(DEBUG)
 
@@ -231,6 +231,16 @@ public:
   Dealloc(IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead,
           SharedMemory* aSegment);
 
+#if defined(DEBUG)
+  // Return whether |aSegment| was allocated as an "unsafe" Shmem.  Debug
+  // builds bake this flag into the segment header and enforce different
+  // protection for the two kinds, so the IPDL segment pool may only hand
+  // a retained segment back out for a request of the same kind.
+  static bool
+  IsUnsafe(IHadBetterBeIPDLCodeCallingThis_OtherwiseIAmADoodyhead,
+           SharedMemory* aSegment);
+#endif
+
 private:
   template<typename T>
   void AssertAligned() const
@@ -169,6 +169,35 @@ typedef bool (*TransferStructuredCloneOp)(JSContext* cx,
 typedef void (*FreeTransferStructuredCloneOp)(uint32_t tag, JS::TransferableOwnership ownership,
                                               void* content, uint64_t extraData, void* closure);
 
+/**
+ * Called when an ArrayBuffer is transferred with DifferentProcess scope,
+ * before the engine falls back to serializing the contents into the clone
+ * buffer. This gives the application a chance to move the contents out of
+ * band instead -- for example into shared memory whose handle is shipped
+ * alongside the clone buffer -- so that transferring a large buffer across
+ * processes does not copy its payload.
+ *
+ * To take over the transfer, set *tag to an application tag (greater than
+ * 0xFFFF0201, the value of the internal SCTAG_TRANSFER_MAP_PENDING_ENTRY),
+ * fill in the remaining outputs as for TransferStructuredCloneOp, and return
+ * true; the engine then detaches the buffer and the tag is later presented
+ * to the ReadTransferStructuredCloneOp on the receiving side. To decline,
+ * leave *tag untouched and return true; the contents are then copied into
+ * the clone buffer as usual. Return false on error/exception.
+ *
+ * Since a DifferentProcess clone buffer must not contain pointers, *content
+ * should be null and any handle or identifier for the out-of-band payload
+ * belongs in *extraData.
+ */
+typedef bool (*TransferArrayBufferStructuredCloneOp)(JSContext* cx,
+                                                     JS::Handle<JSObject*> arrayBuffer,
+                                                     void* closure,
+                                                     // Output:
+                                                     uint32_t* tag,
+                                                     JS::TransferableOwnership* ownership,
+                                                     void** content,
+                                                     uint64_t* extraData);
+
 // The maximum supported structured-clone serialization format version.
 // Increment this when anything at all changes in the serialization format.
 // (Note that this does not need to be bumped for Transferable-only changes,
@@ -182,6 +211,9 @@ struct JSStructuredCloneCallbacks {
     ReadTransferStructuredCloneOp readTransfer;
     TransferStructuredCloneOp writeTransfer;
     FreeTransferStructuredCloneOp freeTransfer;
+    // Optional; may be null, in which case transferred ArrayBuffers crossing
+    // a process boundary have their contents copied into the clone buffer.
+    TransferArrayBufferStructuredCloneOp writeArrayBufferTransfer;
 };
 
 enum OwnTransferablePolicy {
@@ -7,6 +7,7 @@
 #ifndef builtin_AtomicsObject_h
 #define builtin_AtomicsObject_h
 
+#include "mozilla/Atomics.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/TimeStamp.h"
 
@@ -137,7 +138,22 @@ public:
     // Current futex state for this runtime.  When not in a wait this
     // is Idle; when in a wait it is Waiting or the reason the futex
     // is about to wake up.
-    FutexState state_;
+    //
+    // The state is atomic so that a thread in wait() can spin on it for a
+    // short while without holding the futex lock before going to sleep on
+    // cond_; all transitions are still made with the futex lock held.
+    mozilla::Atomic<FutexState> state_;
+
+    // True while the thread is blocked on cond_, false while it is spinning
+    // on state_ (in which case a waker may elide notifying cond_, since the
+    // spinning thread will observe the state_ store by itself). Guarded by
+    // the futex lock.
+    bool sleeping_;
+
+    // How many iterations to spin on state_ before blocking on cond_,
+    // adapted in wait() to how quickly recent wakeups have arrived. Zero on
+    // single-core systems, where spinning can only waste the waker's cycles.
+    uint32_t spinCount_;
 
     // Shared futex lock for all runtimes.  We can perhaps do better,
     // but any lock will need to be per-domain (consider SharedWorker)
@@ -0,0 +1,79 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Allocation and GC benchmarks: nursery churn from short-lived objects,
+// tenured graph building and dropping, and object graphs with weak-ish
+// connectivity (many edges) to exercise marking.
+
+var sink = 0;
+
+function makeTree(depth) {
+    if (depth == 0)
+        return { left: null, right: null, value: 1 };
+    return { left: makeTree(depth - 1), right: makeTree(depth - 1), value: depth };
+}
+
+function treeSum(node) {
+    if (!node)
+        return 0;
+    return node.value + treeSum(node.left) + treeSum(node.right);
+}
+
+var benchmarks = [
+    {
+        name: "nursery-objects",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 2000000; i++) {
+                var o = { a: i, b: i + 1 };
+                total += o.a + o.b;
+            }
+            sink = total;
+        },
+    },
+    {
+        name: "nursery-arrays",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 1000000; i++) {
+                var a = [i, i + 1, i + 2];
+                total += a[0] + a[2];
+            }
+            sink = total;
+        },
+    },
+    {
+        name: "tenured-tree",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 20; i++) {
+                var tree = makeTree(14);
+                total += treeSum(tree);
+            }
+            sink = total;
+        },
+    },
+    {
+        name: "retained-graph",
+        fn: function () {
+            // Build a densely connected graph, keep it alive across
+            // allocation churn, then drop it.
+            var nodes = [];
+            for (var i = 0; i < 50000; i++)
+                nodes.push({ id: i, edges: [] });
+            for (var i = 0; i < nodes.length; i++) {
+                for (var j = 1; j <= 4; j++)
+                    nodes[i].edges.push(nodes[(i * j + 17) % nodes.length]);
+            }
+            var total = 0;
+            for (var i = 0; i < 500000; i++) {
+                var o = { v: i };
+                total += o.v;
+            }
+            sink = total + nodes[nodes.length - 1].id;
+            nodes = null;
+        },
+    },
+];
@@ -0,0 +1,62 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// JSON benchmarks: stringification and parsing of a synthesized record
+// set, resembling the API payloads that dominate real-world JSON use.
+
+var sink = 0;
+
+function makeRecords(count) {
+    var records = [];
+    for (var i = 0; i < count; i++) {
+        records.push({
+            id: i,
+            name: "record-" + i,
+            active: (i & 1) == 0,
+            score: i * 0.75,
+            tags: ["alpha", "beta", "gamma"].slice(0, (i % 3) + 1),
+            nested: {
+                created: 1500000000000 + i,
+                flags: { read: true, write: (i & 3) == 0 },
+            },
+        });
+    }
+    return records;
+}
+
+var records = makeRecords(5000);
+var serialized = JSON.stringify(records);
+
+var benchmarks = [
+    {
+        name: "stringify-records",
+        fn: function () {
+            for (var i = 0; i < 50; i++)
+                sink = JSON.stringify(records).length;
+        },
+    },
+    {
+        name: "parse-records",
+        fn: function () {
+            for (var i = 0; i < 50; i++)
+                sink = JSON.parse(serialized).length;
+        },
+    },
+    {
+        name: "stringify-indented",
+        fn: function () {
+            for (var i = 0; i < 20; i++)
+                sink = JSON.stringify(records, null, 2).length;
+        },
+    },
+    {
+        name: "parse-numbers",
+        fn: function () {
+            var numbers = "[" + new Array(10000).join("123.456,") + "0]";
+            for (var i = 0; i < 100; i++)
+                sink = JSON.parse(numbers).length;
+        },
+    },
+];
@@ -0,0 +1,84 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Property access benchmarks: monomorphic, polymorphic and megamorphic
+// gets and sets, prototype chain walks, and dense element access.
+
+var sink = 0;
+
+function makeShapes(count) {
+    // Build |count| objects with distinct shapes but a common |x| property.
+    var objs = [];
+    for (var i = 0; i < count; i++) {
+        var o = { x: i };
+        o["prop" + i] = i;
+        objs.push(o);
+    }
+    return objs;
+}
+
+var monoObj = { x: 1, y: 2 };
+var polyObjs = makeShapes(4);
+var megaObjs = makeShapes(64);
+var protoObj = Object.create(Object.create(Object.create({ deep: 7 })));
+var denseArray = [];
+for (var i = 0; i < 1024; i++)
+    denseArray.push(i);
+
+var benchmarks = [
+    {
+        name: "get-monomorphic",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 2000000; i++)
+                total += monoObj.x + monoObj.y;
+            sink = total;
+        },
+    },
+    {
+        name: "get-polymorphic",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 2000000; i++)
+                total += polyObjs[i & 3].x;
+            sink = total;
+        },
+    },
+    {
+        name: "get-megamorphic",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 1000000; i++)
+                total += megaObjs[i & 63].x;
+            sink = total;
+        },
+    },
+    {
+        name: "get-protochain",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 2000000; i++)
+                total += protoObj.deep;
+            sink = total;
+        },
+    },
+    {
+        name: "set-monomorphic",
+        fn: function () {
+            for (var i = 0; i < 2000000; i++)
+                monoObj.x = i;
+            sink = monoObj.x;
+        },
+    },
+    {
+        name: "element-dense",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 2000000; i++)
+                total += denseArray[i & 1023];
+            sink = total;
+        },
+    },
+];
@@ -0,0 +1,81 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Regular expression benchmarks: anchored and unanchored matching,
+// global search, capture groups and replace, over a synthesized log-like
+// corpus.
+
+var sink = 0;
+
+function makeCorpus(lines) {
+    var out = [];
+    for (var i = 0; i < lines; i++) {
+        out.push("2017-11-" + (10 + (i % 20)) + "T12:34:" + (i % 60) +
+                 " level=" + (i % 5 == 0 ? "error" : "info") +
+                 " module=mod" + (i % 17) + " message=\"request " + i + " done\"");
+    }
+    return out.join("\n");
+}
+
+var corpus = makeCorpus(5000);
+var lines = corpus.split("\n");
+
+var benchmarks = [
+    {
+        name: "test-anchored",
+        fn: function () {
+            var re = /^2017-11-1\d/;
+            var count = 0;
+            for (var i = 0; i < 50; i++) {
+                for (var j = 0; j < lines.length; j++) {
+                    if (re.test(lines[j]))
+                        count++;
+                }
+            }
+            sink = count;
+        },
+    },
+    {
+        name: "match-captures",
+        fn: function () {
+            var re = /level=(\w+) module=(\w+)/;
+            var count = 0;
+            for (var i = 0; i < 50; i++) {
+                for (var j = 0; j < lines.length; j++) {
+                    var m = lines[j].match(re);
+                    if (m)
+                        count += m[1].length + m[2].length;
+                }
+            }
+            sink = count;
+        },
+    },
+    {
+        name: "search-global",
+        fn: function () {
+            var re = /error/g;
+            var count = 0;
+            for (var i = 0; i < 200; i++)
+                count += corpus.match(re).length;
+            sink = count;
+        },
+    },
+    {
+        name: "replace-global",
+        fn: function () {
+            var re = /module=mod(\d+)/g;
+            for (var i = 0; i < 50; i++)
+                sink = corpus.replace(re, "module=m$1").length;
+        },
+    },
+    {
+        name: "split-regexp",
+        fn: function () {
+            var re = /\s+/;
+            for (var i = 0; i < 50; i++)
+                sink = corpus.split(re).length;
+        },
+    },
+];
@@ -0,0 +1,87 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// String benchmarks: rope building and flattening, character scans,
+// searching, splitting/joining and case conversion, over both latin1 and
+// two-byte strings.
+
+var sink = 0;
+
+function makeString(n, twoByte) {
+    var chunk = twoByte ? "abcdefghሴ" : "abcdefghij";
+    var s = "";
+    while (s.length < n)
+        s += chunk;
+    return s;
+}
+
+var latin1 = makeString(65536, false);
+var twoByte = makeString(65536, true);
+var words = latin1.split("a");
+
+var benchmarks = [
+    {
+        name: "concat-flatten",
+        fn: function () {
+            for (var i = 0; i < 200; i++) {
+                var s = "";
+                for (var j = 0; j < 2000; j++)
+                    s += "xy";
+                // Force the rope flat.
+                sink = s.charCodeAt(s.length - 1);
+            }
+        },
+    },
+    {
+        name: "charcodeat-scan",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 50; i++) {
+                for (var j = 0; j < latin1.length; j++)
+                    total += latin1.charCodeAt(j);
+            }
+            sink = total;
+        },
+    },
+    {
+        name: "indexof-latin1",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 20000; i++)
+                total += latin1.indexOf("ghij", i & 1023);
+            sink = total;
+        },
+    },
+    {
+        name: "indexof-twobyte",
+        fn: function () {
+            var total = 0;
+            for (var i = 0; i < 20000; i++)
+                total += twoByte.indexOf("ghሴ", i & 1023);
+            sink = total;
+        },
+    },
+    {
+        name: "split-join",
+        fn: function () {
+            for (var i = 0; i < 200; i++)
+                sink = latin1.split("ab").join("ba").length;
+        },
+    },
+    {
+        name: "touppercase",
+        fn: function () {
+            for (var i = 0; i < 200; i++)
+                sink = latin1.toUpperCase().length;
+        },
+    },
+    {
+        name: "join-words",
+        fn: function () {
+            for (var i = 0; i < 500; i++)
+                sink = words.join(",").length;
+        },
+    },
+];
@@ -0,0 +1,48 @@
+/* -*- Mode: javascript; tab-width: 8; indent-tabs-mode: nil; js-indent-level: 4 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// In-shell driver loaded by jsbench.py:
+//
+//   js driver.js <benchmark.js>
+//
+// The benchmark file must define a global |benchmarks| array of
+// { name, fn } entries. Each fn is warmed up and then run several times;
+// the best in-process time per benchmark is printed as a JSON array on
+// the last line of output. Cross-process repetition and statistics are
+// the runner's job.
+
+if (scriptArgs.length != 1)
+    throw new Error("usage: js driver.js <benchmark.js>");
+
+load(scriptArgs[0]);
+
+if (typeof benchmarks == "undefined" || !Array.isArray(benchmarks))
+    throw new Error(scriptArgs[0] + " did not define a benchmarks array");
+
+var WARMUP_RUNS = 3;
+var TIMED_RUNS = 5;
+
+var results = [];
+for (var i = 0; i < benchmarks.length; i++) {
+    var bench = benchmarks[i];
+
+    for (var j = 0; j < WARMUP_RUNS; j++)
+        bench.fn();
+
+    // Report the fastest run: the minimum is the least noisy statistic
+    // for CPU-bound work, as interference only ever adds time.
+    var best = Infinity;
+    for (var j = 0; j < TIMED_RUNS; j++) {
+        var t0 = dateNow();
+        bench.fn();
+        var elapsed = dateNow() - t0;
+        if (elapsed < best)
+            best = elapsed;
+    }
+
+    results.push({ name: bench.name, ms: best });
+}
+
+print(JSON.stringify(results));
@@ -0,0 +1,167 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+"""Run the in-tree JS engine microbenchmarks against a js shell.
+
+Each benchmark file in benchmarks/ is run in a fresh shell process for a
+number of repetitions; per-benchmark statistics are reported and can be
+written to a JSON file. A previously written file can be passed back as a
+baseline, in which case significant regressions are reported and reflected
+in the exit status, which makes the runner usable as a bisection predicate:
+
+    jsbench.py --shell dist/bin/js --output base.json   # on the good rev
+    jsbench.py --shell dist/bin/js --baseline base.json # on the suspect rev
+"""
+
+from __future__ import division, print_function
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DRIVER = os.path.join(HERE, 'driver.js')
+BENCHMARK_DIR = os.path.join(HERE, 'benchmarks')
+
+
+def discover_benchmarks(patterns):
+    files = sorted(f for f in os.listdir(BENCHMARK_DIR) if f.endswith('.js'))
+    if patterns:
+        files = [f for f in files
+                 if any(p in f for p in patterns)]
+    return [os.path.join(BENCHMARK_DIR, f) for f in files]
+
+
+def run_shell(shell, shell_args, bench_file):
+    cmd = [shell] + shell_args + [DRIVER, bench_file]
+    output = subprocess.check_output(cmd, stderr=subprocess.STDOUT)
+    if not isinstance(output, str):
+        output = output.decode('utf-8')
+    # The results are the last line of output; benchmarks may print
+    # diagnostics above it.
+    last_line = output.strip().splitlines()[-1]
+    return json.loads(last_line)
+
+
+def summarize(samples):
+    mean = sum(samples) / len(samples)
+    if len(samples) > 1:
+        variance = sum((s - mean) ** 2 for s in samples) / (len(samples) - 1)
+    else:
+        variance = 0.0
+    return {
+        'min': min(samples),
+        'mean': mean,
+        'stddev': math.sqrt(variance),
+        'samples': samples,
+    }
+
+
+def compare(results, baseline, threshold):
+    regressions = []
+    improvements = []
+    for name in sorted(results):
+        if name not in baseline:
+            continue
+        # Compare the minima: the least noisy statistic for CPU-bound work.
+        old = baseline[name]['min']
+        new = results[name]['min']
+        if old <= 0:
+            continue
+        delta = (new - old) / old * 100
+        line = '%-40s %10.2fms -> %10.2fms  %+6.1f%%' % (name, old, new, delta)
+        if delta > threshold:
+            regressions.append(line)
+        elif delta < -threshold:
+            improvements.append(line)
+        else:
+            print(line)
+    for line in improvements:
+        print(line + '  IMPROVED')
+    for line in regressions:
+        print(line + '  REGRESSED')
+    return regressions
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--shell', required=True,
+                        help='Path to the js shell to benchmark.')
+    parser.add_argument('--shell-arg', action='append', default=[],
+                        dest='shell_args', metavar='ARG',
+                        help='Extra argument to pass to the shell; may be '
+                             'given multiple times.')
+    parser.add_argument('--benchmarks', nargs='*', metavar='PATTERN',
+                        help='Only run benchmark files whose name contains '
+                             'one of the given substrings.')
+    parser.add_argument('--reps', type=int, default=10,
+                        help='Shell invocations per benchmark file '
+                             '(default: %(default)s).')
+    parser.add_argument('--output', metavar='FILE',
+                        help='Write results as JSON to FILE.')
+    parser.add_argument('--baseline', metavar='FILE',
+                        help='Compare against results previously written '
+                             'with --output.')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='Regression threshold as a percentage '
+                             '(default: %(default)s).')
+    parser.add_argument('--list', action='store_true',
+                        help='List benchmark files and exit.')
+    args = parser.parse_args(argv)
+
+    bench_files = discover_benchmarks(args.benchmarks)
+    if args.list:
+        for f in bench_files:
+            print(os.path.basename(f))
+        return 0
+    if not bench_files:
+        print('No benchmarks matched.', file=sys.stderr)
+        return 1
+
+    samples = {}
+    for bench_file in bench_files:
+        print('Running %s (%d reps)...'
+              % (os.path.basename(bench_file), args.reps))
+        for rep in range(args.reps):
+            for entry in run_shell(args.shell, args.shell_args, bench_file):
+                samples.setdefault(entry['name'], []).append(entry['ms'])
+
+    results = dict((name, summarize(s)) for name, s in samples.items())
+
+    for name in sorted(results):
+        r = results[name]
+        print('%-40s min %10.2fms  mean %10.2fms  stddev %8.2fms'
+              % (name, r['min'], r['mean'], r['stddev']))
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({
+                'meta': {
+                    'shell': args.shell,
+                    'shell_args': args.shell_args,
+                    'reps': args.reps,
+                    'timestamp': int(time.time()),
+                },
+                'results': results,
+            }, f, indent=2, sort_keys=True)
+        print('Wrote %s' % args.output)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)['results']
+        regressions = compare(results, baseline, args.threshold)
+        if regressions:
+            print('%d benchmark(s) regressed more than %.1f%%.'
+                  % (len(regressions), args.threshold), file=sys.stderr)
+            return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
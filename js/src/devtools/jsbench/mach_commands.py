@@ -0,0 +1,43 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+from __future__ import absolute_import, unicode_literals
+
+import os
+import sys
+
+from mach.decorators import (
+    CommandArgument,
+    CommandProvider,
+    Command,
+)
+
+from mozbuild.base import MachCommandBase
+
+
+@CommandProvider
+class JSBenchProvider(MachCommandBase):
+    @Command('jsbench', category='testing',
+             description='Run the in-tree JS engine microbenchmarks against '
+                         'the js shell.')
+    @CommandArgument('--shell', default=None,
+                     help='Path to the js shell; defaults to the shell in the '
+                          'object directory.')
+    @CommandArgument('args', nargs='...',
+                     help='Extra arguments forwarded to jsbench.py (see '
+                          'jsbench.py --help).')
+    def jsbench(self, shell, args):
+        import subprocess
+
+        if not shell:
+            shell = os.path.join(self.topobjdir, 'dist', 'bin', 'js')
+        if not os.path.exists(shell):
+            print('js shell not found at %s; build it or pass --shell'
+                  % shell)
+            return 1
+
+        runner = os.path.join(self.topsrcdir, 'js', 'src', 'devtools',
+                              'jsbench', 'jsbench.py')
+        return subprocess.call(
+            [sys.executable, runner, '--shell', shell] + args)
@@ -6,13 +6,122 @@
 
 #include "ds/LifoAlloc.h"
 
+#include "mozilla/Atomics.h"
 #include "mozilla/MathAlgorithms.h"
 
 using namespace js;
 
+using mozilla::FloorLog2;
 using mozilla::RoundUpPow2;
 using mozilla::tl::BitSize;
 
+namespace {
+
+// Process-wide pool of memory blocks recently released by ~BumpChunk.
+//
+// Parser and JIT compilations allocate and free chunks of the same few
+// power-of-2 sizes at a high rate, in particular on helper threads, and
+// without a pool every one of those chunks round-trips through the system
+// allocator. Keeping the hottest blocks here lets the next compilation reuse
+// pages which are likely still mapped and in cache.
+//
+// Each size class is a lock-free stack of free blocks. A popping thread
+// claims the entire list with exchange() and pushes back the blocks it does
+// not consume, which side-steps the ABA problem of a classical lock-free pop.
+class BumpChunkPool
+{
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Size classes cover the power-of-2 block sizes from 1 KiB
+    // (1 << MinSizeClassLog) to 64 KiB, which spans the default chunk sizes
+    // used by LifoAlloc consumers. Anything else goes straight back to
+    // js_free. With at most MaxFreeBlocksPerClass blocks per class, the pool
+    // retains 2 MiB in the worst case.
+    static const size_t MinSizeClassLog = 10;
+    static const size_t NumSizeClasses = 7;
+    static const uint32_t MaxFreeBlocksPerClass = 16;
+
+    mozilla::Atomic<FreeBlock*> freeLists_[NumSizeClasses];
+
+    // Block counts are approximate: racing threads can overshoot
+    // MaxFreeBlocksPerClass by a few blocks, which only makes the pool
+    // marginally larger than the bound.
+    mozilla::Atomic<uint32_t> freeCounts_[NumSizeClasses];
+
+    static bool sizeClass(size_t size, size_t* classOut) {
+        MOZ_ASSERT(RoundUpPow2(size) == size);
+        size_t log = FloorLog2(size);
+        if (log < MinSizeClassLog || log >= MinSizeClassLog + NumSizeClasses)
+            return false;
+        *classOut = log - MinSizeClassLog;
+        return true;
+    }
+
+    void pushList(size_t aClass, FreeBlock* first, FreeBlock* last) {
+        for (;;) {
+            FreeBlock* head = freeLists_[aClass];
+            last->next = head;
+            if (freeLists_[aClass].compareExchange(head, first))
+                return;
+        }
+    }
+
+  public:
+    // Take a recycled block of exactly |size| bytes out of the pool, or
+    // return nullptr if none is cached.
+    void* tryAcquire(size_t size) {
+        size_t c;
+        if (!sizeClass(size, &c))
+            return nullptr;
+        FreeBlock* list = freeLists_[c].exchange(nullptr);
+        if (!list)
+            return nullptr;
+        freeCounts_[c]--;
+        FreeBlock* rest = list->next;
+        if (rest) {
+            FreeBlock* last = rest;
+            while (last->next)
+                last = last->next;
+            pushList(c, rest, last);
+        }
+        return list;
+    }
+
+    // Keep the given block of |size| bytes for reuse. Returns false if the
+    // block is not cached, in which case the caller frees it.
+    bool recycle(void* block, size_t size) {
+        size_t c;
+        if (!sizeClass(size, &c))
+            return false;
+        if (freeCounts_[c] >= MaxFreeBlocksPerClass)
+            return false;
+        freeCounts_[c]++;
+        FreeBlock* node = static_cast<FreeBlock*>(block);
+        pushList(c, node, node);
+        return true;
+    }
+
+    // Hand every cached block back to the system allocator.
+    void purge() {
+        for (size_t c = 0; c < NumSizeClasses; c++) {
+            FreeBlock* list = freeLists_[c].exchange(nullptr);
+            while (list) {
+                FreeBlock* next = list->next;
+                freeCounts_[c]--;
+                js_free(list);
+                list = next;
+            }
+        }
+    }
+};
+
+static BumpChunkPool chunkPool;
+
+} // namespace
+
 namespace js {
 namespace detail {
 
@@ -22,9 +131,18 @@ BumpChunk::newWithCapacity(size_t size)
 {
     MOZ_ASSERT(RoundUpPow2(size) == size);
     MOZ_ASSERT(size >= sizeof(BumpChunk));
-    void* mem = js_malloc(size);
-    if (!mem)
-        return nullptr;
+    void* mem = chunkPool.tryAcquire(size);
+    if (!mem) {
+        mem = js_malloc(size);
+        if (!mem) {
+            // Memory pressure: hand back everything the pool holds and retry
+            // once before reporting OOM.
+            LifoAlloc::purgeRecycledChunks();
+            mem = js_malloc(size);
+            if (!mem)
+                return nullptr;
+        }
+    }
 
     UniquePtr<BumpChunk> result(new (mem) BumpChunk(size));
 
@@ -35,6 +153,16 @@ BumpChunk::newWithCapacity(size_t size)
     return result;
 }
 
+/* static */
+void
+BumpChunk::delete_(BumpChunk* chunk)
+{
+    size_t size = chunk->computedSizeOfIncludingThis();
+    chunk->~BumpChunk();
+    if (!chunkPool.recycle(chunk, size))
+        js_free(chunk);
+}
+
 bool
 BumpChunk::canAlloc(size_t n)
 {
@@ -47,6 +175,20 @@ BumpChunk::canAlloc(size_t n)
 } // namespace detail
 } // namespace js
 
+void
+JS::DeletePolicy<detail::BumpChunk>::operator()(const detail::BumpChunk* aChunk)
+{
+    if (aChunk)
+        detail::BumpChunk::delete_(const_cast<detail::BumpChunk*>(aChunk));
+}
+
+/* static */
+void
+LifoAlloc::purgeRecycledChunks()
+{
+    chunkPool.purge();
+}
+
 void
 LifoAlloc::freeAll()
 {
@@ -204,6 +204,28 @@ AlignPtr(uint8_t* orig) {
     return result;
 }
 
+class BumpChunk;
+
+} // namespace detail
+} // namespace js
+
+namespace JS {
+
+// BumpChunk memory is recycled through a process-wide pool of recently freed
+// chunks (see LifoAlloc.cpp), so destruction has to go through
+// BumpChunk::delete_ instead of the plain js_delete performed by the primary
+// template.
+template <>
+struct DeletePolicy<js::detail::BumpChunk>
+{
+    void operator()(const js::detail::BumpChunk* aChunk);
+};
+
+} // namespace JS
+
+namespace js {
+namespace detail {
+
 // A Chunk represent a single memory allocation made with the system
 // allocator. As the owner of the memory, it is responsible for the allocation
 // and the deallocation.
@@ -316,6 +338,12 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk>
     // argument includes the space needed for the header of the chunk.
     static UniquePtr<BumpChunk> newWithCapacity(size_t size);
 
+    // Destroy a chunk created with newWithCapacity. The memory is either kept
+    // in a process-wide pool for reuse by a later chunk of the same size, or
+    // handed back to the system allocator. This is only called through
+    // JS::DeletePolicy<BumpChunk>.
+    static void delete_(BumpChunk* chunk);
+
     // Report allocation.
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
         return mallocSizeOf(this);
@@ -542,6 +570,11 @@ class LifoAlloc
     // Frees all held memory.
     void freeAll();
 
+    // Hand the memory held by the process-wide pool of recycled BumpChunks
+    // back to the system allocator. Called when memory is more useful
+    // elsewhere, such as during shrinking GCs.
+    static void purgeRecycledChunks();
+
     static const unsigned HUGE_ALLOCATION = 50 * 1024 * 1024;
     void freeAllIfHugeAndUnused() {
         if (markCount == 0 && curSize_ > HUGE_ALLOCATION)
@@ -152,6 +152,36 @@ js::Allocate(JSContext* cx)
 FOR_EACH_NONOBJECT_ALLOCKIND(DECL_ALLOCATOR_INSTANCES)
 #undef DECL_ALLOCATOR_INSTANCES
 
+template <typename StringT, AllowGC allowGC /* = CanGC */>
+StringT*
+js::AllocateString(JSContext* cx, InitialHeap heap)
+{
+    static_assert(mozilla::IsConvertible<StringT*, JSString*>::value, "must be JSString derived");
+
+    AllocKind kind = MapTypeToFinalizeKind<StringT>::kind;
+    size_t thingSize = sizeof(StringT);
+    MOZ_ASSERT(thingSize == Arena::thingSize(kind));
+
+    if (!cx->helperThread()) {
+        if (!cx->runtime()->gc.checkAllocatorState<allowGC>(cx, kind))
+            return nullptr;
+
+        // Minor GC cannot relocate string cells yet, so |heap| only expresses
+        // a preference and DefaultHeap requests fall through to the tenured
+        // heap below. Once the nursery advertises string support, this is
+        // where nursery allocation will happen.
+        MOZ_ASSERT(!cx->nursery().canAllocateStrings());
+    }
+
+    return GCRuntime::tryNewTenuredThing<StringT, allowGC>(cx, kind, thingSize);
+}
+template JSString* js::AllocateString<JSString, NoGC>(JSContext* cx, gc::InitialHeap heap);
+template JSString* js::AllocateString<JSString, CanGC>(JSContext* cx, gc::InitialHeap heap);
+template JSFatInlineString* js::AllocateString<JSFatInlineString, NoGC>(JSContext* cx,
+                                                                        gc::InitialHeap heap);
+template JSFatInlineString* js::AllocateString<JSFatInlineString, CanGC>(JSContext* cx,
+                                                                         gc::InitialHeap heap);
+
 template <typename T, AllowGC allowGC>
 /* static */ T*
 GCRuntime::tryNewTenuredThing(JSContext* cx, AllocKind kind, size_t thingSize)
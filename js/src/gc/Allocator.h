@@ -30,6 +30,15 @@ JSObject*
 Allocate(JSContext* cx, gc::AllocKind kind, size_t nDynamicSlots, gc::InitialHeap heap,
          const Class* clasp);
 
+// Allocate a new string. Use this rather than the plain signature above so
+// that the allocation site can express an initial heap preference: DefaultHeap
+// allocations will come from the nursery once it is able to relocate string
+// cells (see Nursery::canAllocateStrings). Atoms and external strings are
+// always tenured and must keep using Allocate.
+template <typename StringT, AllowGC allowGC = CanGC>
+StringT*
+AllocateString(JSContext* cx, gc::InitialHeap heap);
+
 } // namespace js
 
 #endif // gc_Allocator_h
@@ -1063,8 +1063,10 @@ class GCRuntime
     void maybeDoCycleCollection();
     void markCompartments();
     IncrementalProgress drainMarkStack(SliceBudget& sliceBudget, gcstats::PhaseKind phase);
-    template <class CompartmentIterT> void markWeakReferences(gcstats::PhaseKind phase);
-    void markWeakReferencesInCurrentGroup(gcstats::PhaseKind phase);
+    template <class CompartmentIterT> void markWeakReferences(gcstats::PhaseKind phase,
+                                                              bool keepWeakMarkingMode = false);
+    void markWeakReferencesInCurrentGroup(gcstats::PhaseKind phase,
+                                          bool keepWeakMarkingMode = false);
     template <class ZoneIterT, class CompartmentIterT> void markGrayReferences(gcstats::PhaseKind phase);
     void markBufferedGrayRoots(JS::Zone* zone);
     void markGrayReferencesInCurrentGroup(gcstats::PhaseKind phase);
@@ -151,6 +151,16 @@ class Nursery
     void disable();
     bool isEnabled() const { return numChunks() != 0; }
 
+    /*
+     * Whether string cells may be allocated in the nursery. This is still
+     * false: minor GC does not know how to relocate strings and the store
+     * buffers do not record JSString* edges from the tenured heap. String
+     * allocation sites already funnel through js::AllocateString with an
+     * initial heap preference, so they pick up nursery allocation
+     * automatically once those pieces are in place and this returns true.
+     */
+    bool canAllocateStrings() const { return false; }
+
     /* Return true if no allocations have been made since the last collection. */
     bool isEmpty() const;
 
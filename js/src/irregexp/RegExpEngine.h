@@ -71,9 +71,10 @@ struct RegExpCode
 {
     jit::JitCode* jitCode;
     uint8_t* byteCode;
+    size_t byteCodeLength;
 
     RegExpCode()
-      : jitCode(nullptr), byteCode(nullptr)
+      : jitCode(nullptr), byteCode(nullptr), byteCodeLength(0)
     {}
 
     bool empty() {
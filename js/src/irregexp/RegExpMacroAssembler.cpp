@@ -131,6 +131,7 @@ InterpretedRegExpMacroAssembler::GenerateCode(JSContext* cx, bool match_only)
 
     RegExpCode res;
     res.byteCode = buffer_;
+    res.byteCodeLength = size_t(pc_);
     buffer_ = nullptr;
     return res;
 }
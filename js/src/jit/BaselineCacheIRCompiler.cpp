@@ -172,6 +172,10 @@ BaselineCacheIRCompiler::compile()
     masm.setSecondScratchReg(BaselineSecondScratchReg);
 #endif
 
+    // When IC stats are enabled, count how often this stub is entered.
+    if (JitOptions.enableICStats)
+        masm.add32(Imm32(1), Address(ICStubReg, ICStub::offsetOfEnteredCount()));
+
     do {
         switch (reader.readOp()) {
 #define DEFINE_OP(op)                   \
@@ -10,8 +10,11 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryReporting.h"
 
+#include "jsfriendapi.h"
+
 #include "jit/BaselineCompiler.h"
 #include "jit/BaselineIC.h"
+#include "jit/CacheIRCompiler.h"
 #include "jit/CompileInfo.h"
 #include "jit/IonControlFlow.h"
 #include "jit/JitCommon.h"
@@ -326,6 +329,14 @@ CanEnterBaselineJIT(JSContext* cx, HandleScript script, InterpreterFrame* osrFra
     if (script->incWarmUpCounter() <= JitOptions.baselineWarmUpThreshold)
         return Method_Skipped;
 
+    // Scripts which only run once (module and global code, run-once lambdas)
+    // gain nothing from method-entry compilation: their straight-line code
+    // executes once either way, and compiling it costs time and jitcode
+    // memory. Hot loops inside such scripts still tier up through OSR at loop
+    // edges, which passes an |osrFrame|.
+    if (!osrFrame && script->treatAsRunOnce())
+        return Method_Skipped;
+
     // Frames can be marked as debuggee frames independently of its underlying
     // script being a debuggee script, e.g., when performing
     // Debugger.Frame.prototype.eval.
@@ -1266,3 +1277,72 @@ jit::MarkActiveBaselineScripts(Zone* zone)
         }
     }
 }
+
+static uint32_t
+NumShapesGuarded(ICStub* stub)
+{
+    const CacheIRStubInfo* stubInfo;
+    switch (stub->kind()) {
+      case ICStub::CacheIR_Regular:
+        stubInfo = stub->toCacheIR_Regular()->stubInfo();
+        break;
+      case ICStub::CacheIR_Monitored:
+        stubInfo = stub->toCacheIR_Monitored()->stubInfo();
+        break;
+      case ICStub::CacheIR_Updated:
+        stubInfo = stub->toCacheIR_Updated()->stubInfo();
+        break;
+      default:
+        // Old-style stubs do not describe their guards.
+        return 0;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; stubInfo->fieldType(i) != StubField::Type::Limit; i++) {
+        if (stubInfo->fieldType(i) == StubField::Type::Shape)
+            count++;
+    }
+    return count;
+}
+
+bool
+js::EnumerateICSiteStats(JSContext* cx, HandleScript script, ICSiteStatsCallback callback,
+                         void* data)
+{
+    if (!script->hasBaselineScript())
+        return true;
+
+    BaselineScript* baseline = script->baselineScript();
+    for (size_t i = 0; i < baseline->numICEntries(); i++) {
+        BaselineICEntry& entry = baseline->icEntry(i);
+        if (!entry.isForOp() || !entry.hasStub())
+            continue;
+
+        ICFallbackStub* fallback = entry.fallbackStub();
+
+        Vector<const char*, 8, SystemAllocPolicy> stubKinds;
+        Vector<uint32_t, 8, SystemAllocPolicy> stubShapeCounts;
+        uint32_t hitCount = 0;
+        for (ICStub* stub = entry.firstStub(); stub != fallback; stub = stub->next()) {
+            hitCount += stub->enteredCount();
+            if (!stubKinds.append(ICStub::KindString(stub->kind())) ||
+                !stubShapeCounts.append(NumShapesGuarded(stub)))
+            {
+                ReportOutOfMemory(cx);
+                return false;
+            }
+        }
+
+        ICSiteStats stats;
+        stats.pcOffset = entry.pcOffset();
+        stats.op = CodeName[*script->offsetToPC(entry.pcOffset())];
+        stats.mode = uint8_t(fallback->state().mode());
+        stats.fallbackCount = fallback->enteredCount();
+        stats.hitCount = hitCount;
+        stats.stubKinds = stubKinds.begin();
+        stats.stubShapeCounts = stubShapeCounts.begin();
+        stats.numStubs = stubKinds.length();
+        callback(data, stats);
+    }
+    return true;
+}
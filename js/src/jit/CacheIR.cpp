@@ -9,6 +9,8 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/FloatingPoint.h"
 
+#include "jsfriendapi.h"
+
 #include "jit/BaselineCacheIRCompiler.h"
 #include "jit/BaselineIC.h"
 #include "jit/CacheIRSpewer.h"
@@ -727,6 +729,60 @@ EmitCallGetterResult(CacheIRWriter& writer, JSObject* obj, JSObject* holder,
     EmitCallGetterResult(writer, obj, holder, shape, objId, objId, mode);
 }
 
+static bool
+CanAttachDOMGetterSlotLoad(JSContext* cx, JSObject* obj, Shape* shape)
+{
+    // A DOM getter whose jitinfo says its result always lives in a reserved
+    // slot of the instance object can be turned into a direct slot load,
+    // bypassing the getter call entirely. This matches what IonBuilder does
+    // with MGetDOMMember for known DOM types.
+    if (!obj->isNative())
+        return false;
+
+    JSFunction& getter = shape->getterValue().toObject().as<JSFunction>();
+    if (!getter.isNative() || !getter.jitInfo())
+        return false;
+
+    const JSJitInfo* jitInfo = getter.jitInfo();
+    if (jitInfo->type() != JSJitInfo::Getter || !jitInfo->isAlwaysInSlot)
+        return false;
+
+    // The jitinfo's slot index is a reserved slot index, which only matches
+    // a fixed slot offset on non-proxy instances.
+    if (jitInfo->slotIndex >= obj->as<NativeObject>().numFixedSlots())
+        return false;
+
+    // Ensure the receiver really is an instance of the class this getter
+    // expects, so that its shape guard pins down the slot layout.
+    const DOMCallbacks* callbacks = GetDOMCallbacks(cx);
+    if (!callbacks)
+        return false;
+
+    return callbacks->instanceClassMatchesProto(obj->getClass(), jitInfo->protoID,
+                                                jitInfo->depth);
+}
+
+static void
+EmitDOMGetterSlotResult(CacheIRWriter& writer, JSObject* obj, JSObject* holder,
+                        Shape* shape, ObjOperandId objId)
+{
+    // Guard the receiver and holder the same way we would for a getter call.
+    Maybe<ObjOperandId> expandoId;
+    TestMatchingReceiver(writer, obj, objId, &expandoId);
+
+    if (obj != holder) {
+        GeneratePrototypeGuards(writer, obj, holder, objId);
+
+        // Guard on the holder's shape so the getter itself is unchanged.
+        ObjOperandId holderId = writer.loadObject(holder);
+        writer.guardShape(holderId, holder->as<NativeObject>().lastProperty());
+    }
+
+    size_t slot = shape->getterValue().toObject().as<JSFunction>().jitInfo()->slotIndex;
+    writer.loadFixedSlotResult(objId, NativeObject::getFixedSlotOffset(slot));
+    writer.typeMonitorResult();
+}
+
 void
 GetPropIRGenerator::attachMegamorphicNativeSlot(ObjOperandId objId, jsid id, bool handleMissing)
 {
@@ -782,8 +838,19 @@ GetPropIRGenerator::tryAttachNative(HandleObject obj, ObjOperandId objId, Handle
         trackAttached("NativeSlot");
         return true;
       case CanAttachCallGetter: {
-        // |super.prop| accesses use a |this| value that differs from lookup object
         MOZ_ASSERT(!idempotent());
+
+        if (!isSuper() && mode_ == ICState::Mode::Specialized &&
+            CanAttachDOMGetterSlotLoad(cx_, obj, shape))
+        {
+            maybeEmitIdGuard(id);
+            EmitDOMGetterSlotResult(writer, obj, holder, shape, objId);
+
+            trackAttached("DOMGetterSlot");
+            return true;
+        }
+
+        // |super.prop| accesses use a |this| value that differs from lookup object
         ObjOperandId receiverId = isSuper() ? writer.guardIsObject(getSuperReceiverValueId())
                                             : objId;
         maybeEmitIdGuard(id);
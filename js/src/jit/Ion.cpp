@@ -2184,6 +2184,16 @@ IonCompile(JSContext* cx, JSScript* script,
 
     SpewBeginFunction(builder, builderScript);
 
+    // MIR construction must happen on the active thread, even though the rest
+    // of the pipeline runs on a helper thread: IonBuilder reads heap type
+    // sets, shapes and baseline IC chains directly and relies on
+    // AutoEnterAnalysis plus the paused mutator to keep them stable, and the
+    // MIR it emits may embed nursery pointers. Moving this off thread would
+    // mean snapshotting all of that input up front and discarding the build
+    // whenever the snapshot is invalidated; with the current constraint-based
+    // type system the snapshot would be most of the TI heap. Large scripts
+    // instead have their warm-up threshold scaled by size (see
+    // OptimizationInfo::compilerWarmUpThreshold) to keep this stall rare.
     AbortReasonOr<Ok> buildResult = Ok();
     {
         AutoEnterAnalysis enter(cx);
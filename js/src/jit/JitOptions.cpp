@@ -126,6 +126,10 @@ DefaultJitOptions::DefaultJitOptions()
     // Toggles whether CacheIR stubs are used.
     SET_DEFAULT(disableCacheIR, false);
 
+    // Toggles whether IC stubs count how often they are entered, for the
+    // per-script IC stats exposed through js::EnumerateICSiteStats.
+    SET_DEFAULT(enableICStats, false);
+
     // Toggles whether shared stubs are used in Ionmonkey.
     SET_DEFAULT(disableSharedStubs, false);
 
@@ -64,6 +64,7 @@ struct DefaultJitOptions
     bool disableRecoverIns;
     bool disableScalarReplacement;
     bool disableCacheIR;
+    bool enableICStats;
     bool disableSharedStubs;
     bool disableSincos;
     bool disableSink;
@@ -513,6 +513,10 @@ ICStubCompiler::getStubCode()
     masm.setSecondScratchReg(BaselineSecondScratchReg);
 #endif
 
+    // When IC stats are enabled, count how often this stub is entered.
+    if (JitOptions.enableICStats)
+        masm.add32(Imm32(1), Address(ICStubReg, ICStub::offsetOfEnteredCount()));
+
     if (!generateStubCode(masm))
         return nullptr;
     Linker linker(masm);
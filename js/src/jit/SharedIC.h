@@ -560,12 +560,18 @@ class ICStub
     Trait trait_ : 3;
     Kind kind_ : 13;
 
+    // Number of times this stub's code has been entered. Only maintained when
+    // JitOptions.enableICStats is set, since the increment is emitted into
+    // the stub code.
+    uint32_t enteredCount_;
+
     inline ICStub(Kind kind, JitCode* stubCode)
       : stubCode_(stubCode->raw()),
         next_(nullptr),
         extra_(0),
         trait_(Regular),
-        kind_(kind)
+        kind_(kind),
+        enteredCount_(0)
     {
         MOZ_ASSERT(stubCode != nullptr);
     }
@@ -575,7 +581,8 @@ class ICStub
         next_(nullptr),
         extra_(0),
         trait_(trait),
-        kind_(kind)
+        kind_(kind),
+        enteredCount_(0)
     {
         MOZ_ASSERT(stubCode != nullptr);
     }
@@ -712,6 +719,14 @@ class ICStub
         return offsetof(ICStub, extra_);
     }
 
+    uint32_t enteredCount() const {
+        return enteredCount_;
+    }
+
+    static inline size_t offsetOfEnteredCount() {
+        return offsetof(ICStub, enteredCount_);
+    }
+
     static bool NonCacheIRStubMakesGCCalls(Kind kind);
     bool makesGCCalls() const;
 
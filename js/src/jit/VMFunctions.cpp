@@ -1600,11 +1600,35 @@ GetNativeDataProperty(JSContext* cx, NativeObject* obj, jsid id, Value* vp)
 
     MOZ_ASSERT(JSID_IS_ATOM(id) || JSID_IS_SYMBOL(id));
 
+    // Consult the megamorphic lookup cache first: a hit has verified the
+    // shape of every object between the receiver and the holder, so the
+    // slot can be read directly without searching any shape lineage.
+    MegamorphicCache& cache = cx->caches().megamorphicCache;
+    {
+        NativeObject* holder;
+        uint32_t slot;
+        if (cache.lookup(obj, id, &holder, &slot)) {
+            *vp = holder->getSlot(slot);
+            return true;
+        }
+    }
+
+    Shape* receiverShape = obj->lastProperty();
+    Shape* protoShapes[MegamorphicCache::MaxHops];
+    uint8_t numHops = 0;
+
+    // Dictionary shapes are mutated in place, so lookups involving them
+    // cannot be cached.
+    bool cacheable = !receiverShape->inDictionary();
+
     while (true) {
         if (Shape* shape = obj->lastProperty()->search(cx, id)) {
             if (!shape->isDataProperty())
                 return false;
 
+            if (cacheable && numHops <= MegamorphicCache::MaxHops)
+                cache.fill(receiverShape, id, numHops, protoShapes, shape->slot());
+
             *vp = obj->getSlot(shape->slot());
             return true;
         }
@@ -1627,6 +1651,13 @@ GetNativeDataProperty(JSContext* cx, NativeObject* obj, jsid id, Value* vp)
         if (!proto->isNative())
             return false;
         obj = &proto->as<NativeObject>();
+
+        if (numHops < MegamorphicCache::MaxHops) {
+            protoShapes[numHops] = obj->lastProperty();
+            if (protoShapes[numHops]->inDictionary())
+                cacheable = false;
+        }
+        numHops++;
     }
 }
 
@@ -0,0 +1,158 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ *
+ * Tests for the radix sort fast paths taken by Array.prototype.sort with a
+ * recognized numeric comparator. The numeric sorts switch from MergeSort to
+ * radix sort at 128 elements, so lengths on both sides of that threshold are
+ * covered throughout.
+ */
+
+#include "jsapi-tests/tests.h"
+
+static const char testArraySortRadix_helpers[] =
+    "function makeInts(len) {\n"
+    "    var a = [], s = 987654321 >>> 0;\n"
+    "    for (var i = 0; i < len; i++) {\n"
+    "        s = (Math.imul(s, 1103515245) + 12345) >>> 0;\n"
+    "        a.push((s >> 8) - (1 << 22));\n"
+    "    }\n"
+    "    return a;\n"
+    "}\n"
+    "function isSorted(a, desc) {\n"
+    "    for (var i = 1; i < a.length; i++) {\n"
+    "        if (desc ? a[i - 1] < a[i] : a[i - 1] > a[i])\n"
+    "            return false;\n"
+    "    }\n"
+    "    return true;\n"
+    "}\n"
+    "function sameCounts(a, b) {\n"
+    "    if (a.length != b.length)\n"
+    "        return false;\n"
+    "    function counts(arr) {\n"
+    "        var m = new Map();\n"
+    "        for (var v of arr)\n"
+    "            m.set(v, (m.get(v) || 0) + 1);\n"
+    "        return m;\n"
+    "    }\n"
+    "    var ma = counts(a), mb = counts(b);\n"
+    "    if (ma.size != mb.size)\n"
+    "        return false;\n"
+    "    for (var [v, n] of ma) {\n"
+    "        if (mb.get(v) != n)\n"
+    "            return false;\n"
+    "    }\n"
+    "    return true;\n"
+    "}\n";
+
+BEGIN_TEST(testArraySortRadix_int32)
+{
+    EXEC(testArraySortRadix_helpers);
+
+    // All-int32 arrays, ascending and descending, at lengths straddling the
+    // radix threshold and well past it.
+    JS::RootedValue v(cx);
+    EVAL("var ok = true;\n"
+         "for (var len of [2, 127, 128, 129, 500]) {\n"
+         "    var a = makeInts(len);\n"
+         "    var asc = a.slice().sort(function(x, y) { return x - y; });\n"
+         "    var desc = a.slice().sort(function(x, y) { return y - x; });\n"
+         "    ok = ok && isSorted(asc, false) && sameCounts(a, asc);\n"
+         "    ok = ok && isSorted(desc, true) && sameCounts(a, desc);\n"
+         "}\n"
+         "ok;\n",
+         &v);
+    CHECK(v.isTrue());
+
+    // Extreme values must survive the sign-bit flip the int32 key mapping
+    // performs.
+    EVAL("var a = makeInts(130);\n"
+         "a[0] = -2147483648; a[1] = 2147483647; a[2] = 0;\n"
+         "var s = a.slice().sort(function(x, y) { return x - y; });\n"
+         "s[0] == -2147483648 && s[s.length - 1] == 2147483647 &&\n"
+         "    isSorted(s, false) && sameCounts(a, s);\n",
+         &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testArraySortRadix_int32)
+
+BEGIN_TEST(testArraySortRadix_doubles)
+{
+    EXEC(testArraySortRadix_helpers);
+
+    // General numeric arrays take the keyed radix path; include fractions
+    // and infinities.
+    JS::RootedValue v(cx);
+    EVAL("var ok = true;\n"
+         "for (var len of [127, 128, 300]) {\n"
+         "    var a = makeInts(len).map(function(x) { return x / 256; });\n"
+         "    a[5] = Infinity;\n"
+         "    a[6] = -Infinity;\n"
+         "    var asc = a.slice().sort(function(x, y) { return x - y; });\n"
+         "    var desc = a.slice().sort(function(x, y) { return y - x; });\n"
+         "    ok = ok && isSorted(asc, false) && sameCounts(a, asc);\n"
+         "    ok = ok && isSorted(desc, true) && sameCounts(a, desc);\n"
+         "    ok = ok && asc[0] == -Infinity && asc[asc.length - 1] == Infinity;\n"
+         "}\n"
+         "ok;\n",
+         &v);
+    CHECK(v.isTrue());
+
+    // The sort is stable, and +0/-0 compare equal under a numeric
+    // comparator, so the zeros' original relative order must survive on
+    // both sides of the threshold.
+    EVAL("var ok = true;\n"
+         "for (var len of [127, 128, 250]) {\n"
+         "    var a = [], zeros = 0;\n"
+         "    for (var i = 0; i < len; i++) {\n"
+         "        if (i % 3 == 1)\n"
+         "            a.push(++zeros % 2 ? 0 : -0);\n"
+         "        else\n"
+         "            a.push((i * 7919) % 101 - 50 + 0.5);\n"
+         "    }\n"
+         "    function zeroPattern(arr) {\n"
+         "        var p = [];\n"
+         "        for (var v of arr) {\n"
+         "            if (v === 0)\n"
+         "                p.push(Object.is(v, -0));\n"
+         "        }\n"
+         "        return p;\n"
+         "    }\n"
+         "    var s = a.slice().sort(function(x, y) { return x - y; });\n"
+         "    ok = ok && isSorted(s, false) &&\n"
+         "         String(zeroPattern(s)) == String(zeroPattern(a));\n"
+         "}\n"
+         "ok;\n",
+         &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testArraySortRadix_doubles)
+
+BEGIN_TEST(testArraySortRadix_nan)
+{
+    EXEC(testArraySortRadix_helpers);
+
+    // NaN maps to the maximal sort key, so an ascending numeric sort leaves
+    // every NaN at the end with the non-NaN prefix sorted and nothing lost.
+    JS::RootedValue v(cx);
+    EVAL("var a = [];\n"
+         "for (var i = 0; i < 200; i++)\n"
+         "    a.push(i % 5 == 2 ? NaN : (i * 1.5) % 97 - 40);\n"
+         "var s = a.slice().sort(function(x, y) { return x - y; });\n"
+         "var nans = a.filter(Number.isNaN).length;\n"
+         "var ok = s.length == a.length &&\n"
+         "         s.filter(Number.isNaN).length == nans;\n"
+         "for (var i = 0; i < s.length - nans; i++)\n"
+         "    ok = ok && !Number.isNaN(s[i]);\n"
+         "for (var i = s.length - nans; i < s.length; i++)\n"
+         "    ok = ok && Number.isNaN(s[i]);\n"
+         "ok && isSorted(s.slice(0, s.length - nans), false);\n",
+         &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testArraySortRadix_nan)
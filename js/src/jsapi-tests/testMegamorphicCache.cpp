@@ -0,0 +1,144 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ *
+ * Tests for the megamorphic property lookup cache: a hit is only valid
+ * while every shape on the path from the receiver to the holder is
+ * unchanged, and the whole table is purged by GC since entries hold
+ * unbarriered Shape pointers.
+ */
+
+#include "jscntxt.h"
+#include "jscntxtinlines.h"
+
+#include "jsapi-tests/tests.h"
+#include "vm/NativeObject.h"
+
+using namespace js;
+
+BEGIN_TEST(testMegamorphicCache_invalidation)
+{
+    EXEC("var proto = { prop: 42 };\n"
+         "var obj = Object.create(proto);\n"
+         "obj.own = 7;\n");
+
+    JS::RootedValue objVal(cx), protoVal(cx);
+    EVAL("obj", &objVal);
+    EVAL("proto", &protoVal);
+
+    JS::RootedString str(cx, JS_AtomizeString(cx, "prop"));
+    CHECK(str);
+    JS::RootedId id(cx);
+    CHECK(JS_StringToId(cx, str, &id));
+
+    MegamorphicCache& cache = cx->caches().megamorphicCache;
+    NativeObject* obj = &objVal.toObject().as<NativeObject>();
+    NativeObject* proto = &protoVal.toObject().as<NativeObject>();
+
+    // {prop: 42} puts the property in the object's first slot; check that
+    // assumption before caching the slot number below.
+    CHECK(proto->getSlot(0).isInt32(42));
+
+    NativeObject* holder;
+    uint32_t slot;
+
+    // Nothing has been cached for (obj, "prop") yet.
+    CHECK(!cache.lookup(obj, id, &holder, &slot));
+
+    // Fill the cache the way GetNativeDataProperty does for a lookup that
+    // found "prop" one proto hop away, and check that it hits.
+    {
+        Shape* protoShapes[1] = { proto->lastProperty() };
+        cache.fill(obj->lastProperty(), id, 1, protoShapes, 0);
+    }
+    CHECK(cache.lookup(obj, id, &holder, &slot));
+    CHECK(holder == proto);
+    CHECK_EQUAL(slot, uint32_t(0));
+    CHECK(holder->getSlot(slot).isInt32(42));
+
+    // Changing the shape of an object on the path to the holder must
+    // invalidate the entry.
+    EXEC("proto.extra = 1;");
+    obj = &objVal.toObject().as<NativeObject>();
+    proto = &protoVal.toObject().as<NativeObject>();
+    CHECK(!cache.lookup(obj, id, &holder, &slot));
+
+    // Refill against the new proto shape; a receiver shape change must then
+    // miss, since entries are keyed on the receiver's shape.
+    {
+        Shape* protoShapes[1] = { proto->lastProperty() };
+        cache.fill(obj->lastProperty(), id, 1, protoShapes, 0);
+    }
+    CHECK(cache.lookup(obj, id, &holder, &slot));
+    EXEC("obj.more = 2;");
+    obj = &objVal.toObject().as<NativeObject>();
+    proto = &protoVal.toObject().as<NativeObject>();
+    CHECK(!cache.lookup(obj, id, &holder, &slot));
+
+    // purge() empties the table.
+    {
+        Shape* protoShapes[1] = { proto->lastProperty() };
+        cache.fill(obj->lastProperty(), id, 1, protoShapes, 0);
+    }
+    CHECK(cache.lookup(obj, id, &holder, &slot));
+    cache.purge();
+    CHECK(!cache.lookup(obj, id, &holder, &slot));
+
+    return true;
+}
+END_TEST(testMegamorphicCache_invalidation)
+
+BEGIN_TEST(testMegamorphicCache_gc)
+{
+    EXEC("var proto = { prop: 42 };\n"
+         "var obj = Object.create(proto);\n");
+
+    JS::RootedValue objVal(cx), protoVal(cx);
+    EVAL("obj", &objVal);
+    EVAL("proto", &protoVal);
+
+    JS::RootedString str(cx, JS_AtomizeString(cx, "prop"));
+    CHECK(str);
+    JS::RootedId id(cx);
+    CHECK(JS_StringToId(cx, str, &id));
+
+    MegamorphicCache& cache = cx->caches().megamorphicCache;
+    NativeObject* obj = &objVal.toObject().as<NativeObject>();
+    NativeObject* proto = &protoVal.toObject().as<NativeObject>();
+    CHECK(proto->getSlot(0).isInt32(42));
+
+    NativeObject* holder;
+    uint32_t slot;
+    {
+        Shape* protoShapes[1] = { proto->lastProperty() };
+        cache.fill(obj->lastProperty(), id, 1, protoShapes, 0);
+    }
+    CHECK(cache.lookup(obj, id, &holder, &slot));
+
+    // A shrinking GC both purges the runtime (which clears the cache) and
+    // compacts where supported; the stale unbarriered shapes must be gone.
+    JS::PrepareForFullGC(cx);
+    JS::GCForReason(cx, GC_SHRINK, JS::gcreason::API);
+
+    obj = &objVal.toObject().as<NativeObject>();
+    proto = &protoVal.toObject().as<NativeObject>();
+    CHECK(!cache.lookup(obj, id, &holder, &slot));
+
+    // The property is still readable, and the cache can be refilled against
+    // the post-GC shapes.
+    JS::RootedValue v(cx);
+    EVAL("obj.prop", &v);
+    CHECK(v.isInt32(42));
+
+    obj = &objVal.toObject().as<NativeObject>();
+    proto = &protoVal.toObject().as<NativeObject>();
+    {
+        Shape* protoShapes[1] = { proto->lastProperty() };
+        cache.fill(obj->lastProperty(), id, 1, protoShapes, 0);
+    }
+    CHECK(cache.lookup(obj, id, &holder, &slot));
+    CHECK(holder == proto);
+    CHECK(holder->getSlot(slot).isInt32(42));
+
+    return true;
+}
+END_TEST(testMegamorphicCache_gc)
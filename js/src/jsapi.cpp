@@ -646,7 +646,8 @@ JS::ContextOptionsRef(JSContext* cx)
 }
 
 JS_PUBLIC_API(bool)
-JS::InitSelfHostedCode(JSContext* cx)
+JS::InitSelfHostedCode(JSContext* cx, const mozilla::Range<uint8_t>& xdrCache,
+                       SelfHostedWriter xdrWriter)
 {
     MOZ_RELEASE_ASSERT(!cx->runtime()->hasInitializedSelfHosting(),
                        "JS::InitSelfHostedCode() called more than once");
@@ -659,7 +660,7 @@ JS::InitSelfHostedCode(JSContext* cx)
     if (!rt->initializeAtoms(cx))
         return false;
 
-    if (!rt->initSelfHosting(cx))
+    if (!rt->initSelfHosting(cx, xdrCache, xdrWriter))
         return false;
 
     if (!rt->parentRuntime && !rt->transformToPermanentAtoms(cx))
@@ -3942,6 +3943,7 @@ JS::TransitiveCompileOptions::copyPODTransitiveOptions(const TransitiveCompileOp
     utf8 = rhs.utf8;
     selfHostingMode = rhs.selfHostingMode;
     canLazilyParse = rhs.canLazilyParse;
+    eagerDelazification = rhs.eagerDelazification;
     strictOption = rhs.strictOption;
     extraWarningsOption = rhs.extraWarningsOption;
     forEachStatementOption = rhs.forEachStatementOption;
@@ -7619,6 +7621,12 @@ JS::SetAsmJSCacheOps(JSContext* cx, const JS::AsmJSCacheOps* ops)
     cx->runtime()->asmJSCacheOps = *ops;
 }
 
+JS_PUBLIC_API(void)
+JS::SetWasmCacheOps(JSContext* cx, const JS::WasmCacheOps* ops)
+{
+    cx->runtime()->wasmCacheOps = *ops;
+}
+
 bool
 JS::IsWasmModuleObject(HandleObject obj)
 {
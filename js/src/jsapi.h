@@ -1343,13 +1343,34 @@ class JS_PUBLIC_API(ContextOptions) {
 JS_PUBLIC_API(ContextOptions&)
 ContextOptionsRef(JSContext* cx);
 
+/**
+ * Callback used to give the embedding a chance to persist an XDR encoding of
+ * the freshly compiled self-hosted code. See InitSelfHostedCode.
+ */
+typedef bool
+(* SelfHostedWriter)(JSContext* cx, mozilla::Vector<uint8_t>& buffer /* TranscodeBuffer& */);
+
 /**
  * Initialize the runtime's self-hosted code. Embeddings should call this
  * exactly once per runtime/context, before the first JS_NewGlobalObject
  * call.
+ *
+ * When |xdrCache| is non-empty, the self-hosted code is decoded from the
+ * given XDR image instead of being compiled from its source, which is
+ * substantially faster. The image must have been produced by the same build
+ * (the XDR machinery checks this); on mismatch the source is compiled as
+ * usual. Worker runtimes share their parent runtime's self-hosting
+ * compartment and ignore both arguments.
+ *
+ * When |xdrWriter| is non-null and the code was compiled from source, the
+ * writer is invoked with the encoded image so that the embedding can cache
+ * it, e.g. for other processes of the same build to pass as |xdrCache|.
  */
 JS_PUBLIC_API(bool)
-InitSelfHostedCode(JSContext* cx);
+InitSelfHostedCode(JSContext* cx,
+                   const mozilla::Range<uint8_t>& xdrCache /* TranscodeRange */
+                       = mozilla::Range<uint8_t>(),
+                   SelfHostedWriter xdrWriter = nullptr);
 
 /**
  * Asserts (in debug and release builds) that `obj` belongs to the current
@@ -4015,6 +4036,7 @@ class JS_FRIEND_API(TransitiveCompileOptions)
         utf8(false),
         selfHostingMode(false),
         canLazilyParse(true),
+        eagerDelazification(false),
         strictOption(false),
         extraWarningsOption(false),
         forEachStatementOption(false),
@@ -4052,6 +4074,14 @@ class JS_FRIEND_API(TransitiveCompileOptions)
     bool utf8;
     bool selfHostingMode;
     bool canLazilyParse;
+
+    // When an off-thread parse produces lazy inner functions, compile them
+    // eagerly on the helper thread, in source order, before the result is
+    // handed back. First calls then never pay for delazification on the
+    // active thread, at the cost of a longer-running parse task. Only
+    // meaningful when canLazilyParse is also true.
+    bool eagerDelazification;
+
     bool strictOption;
     bool extraWarningsOption;
     bool forEachStatementOption;
@@ -4204,6 +4234,7 @@ class JS_FRIEND_API(OwningCompileOptions) : public ReadOnlyCompileOptions
     OwningCompileOptions& setNoScriptRval(bool nsr) { noScriptRval = nsr; return *this; }
     OwningCompileOptions& setSelfHostingMode(bool shm) { selfHostingMode = shm; return *this; }
     OwningCompileOptions& setCanLazilyParse(bool clp) { canLazilyParse = clp; return *this; }
+    OwningCompileOptions& setEagerDelazification(bool ed) { eagerDelazification = ed; return *this; }
     OwningCompileOptions& setSourceIsLazy(bool l) { sourceIsLazy = l; return *this; }
     OwningCompileOptions& setIntroductionType(const char* t) { introductionType = t; return *this; }
     bool setIntroductionInfo(JSContext* cx, const char* introducerFn, const char* intro,
@@ -4301,6 +4332,7 @@ class MOZ_STACK_CLASS JS_FRIEND_API(CompileOptions) final : public ReadOnlyCompi
     CompileOptions& setNoScriptRval(bool nsr) { noScriptRval = nsr; return *this; }
     CompileOptions& setSelfHostingMode(bool shm) { selfHostingMode = shm; return *this; }
     CompileOptions& setCanLazilyParse(bool clp) { canLazilyParse = clp; return *this; }
+    CompileOptions& setEagerDelazification(bool ed) { eagerDelazification = ed; return *this; }
     CompileOptions& setSourceIsLazy(bool l) { sourceIsLazy = l; return *this; }
     CompileOptions& setIntroductionType(const char* t) { introductionType = t; return *this; }
     CompileOptions& setIntroductionInfo(const char* introducerFn, const char* intro,
@@ -6483,6 +6515,41 @@ struct AsmJSCacheOps
 extern JS_PUBLIC_API(void)
 SetAsmJSCacheOps(JSContext* cx, const AsmJSCacheOps* callbacks);
 
+/*
+ * Analogous callbacks for wasm modules. Where the asm.js cache is keyed by a
+ * source character range, a wasm cache entry is keyed by the module's raw
+ * bytecode: the embedding is expected to hash [bytecodeBegin, bytecodeLimit)
+ * to find or create its entry. The serialized machine code stored in an entry
+ * begins with the module's Assumptions (cpu-id and the buildId below), which
+ * the JS engine checks on read, so a stale entry is simply a cache miss and
+ * the embedding need not invalidate entries across updates itself.
+ *
+ * Due to tiering, the entry for a module is not written until the optimized
+ * tier has finished compiling, which happens on a background thread. All of
+ * these callbacks must therefore be safe to call from any thread.
+ */
+typedef bool
+(* OpenWasmCacheEntryForReadOp)(const uint8_t* bytecodeBegin, const uint8_t* bytecodeLimit,
+                                size_t* size, const uint8_t** memory, intptr_t* handle);
+typedef void
+(* CloseWasmCacheEntryForReadOp)(size_t size, const uint8_t* memory, intptr_t handle);
+typedef bool
+(* OpenWasmCacheEntryForWriteOp)(const uint8_t* bytecodeBegin, const uint8_t* bytecodeLimit,
+                                 size_t size, uint8_t** memory, intptr_t* handle);
+typedef void
+(* CloseWasmCacheEntryForWriteOp)(size_t size, uint8_t* memory, intptr_t handle);
+
+struct WasmCacheOps
+{
+    OpenWasmCacheEntryForReadOp openEntryForRead;
+    CloseWasmCacheEntryForReadOp closeEntryForRead;
+    OpenWasmCacheEntryForWriteOp openEntryForWrite;
+    CloseWasmCacheEntryForWriteOp closeEntryForWrite;
+};
+
+extern JS_PUBLIC_API(void)
+SetWasmCacheOps(JSContext* cx, const WasmCacheOps* callbacks);
+
 /**
  * Return the buildId (represented as a sequence of characters) associated with
  * the currently-executing build. If the JS engine is embedded such that a
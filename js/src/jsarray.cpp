@@ -7,6 +7,7 @@
 #include "jsarrayinlines.h"
 
 #include "mozilla/ArrayUtils.h"
+#include "mozilla/Casting.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/FloatingPoint.h"
@@ -1890,28 +1891,133 @@ MatchNumericComparator(JSContext* cx, JSObject* obj)
     return Match_None;
 }
 
-template <typename K, typename C>
-static inline bool
-MergeSortByKey(K keys, size_t len, K scratch, C comparator, MutableHandle<GCVector<Value>> vec)
+/*
+ * Threshold at which the numeric sorts below switch from MergeSort to a
+ * radix sort. Each radix pass walks a 256-entry count table regardless of
+ * input size, so short arrays are better off in the comparison sort.
+ */
+static const size_t RadixSortThreshold = 128;
+
+/*
+ * Stable LSD radix sort over |len| elements, eight bits per pass, least
+ * significant byte first. |key| maps an element to a uint64 whose unsigned
+ * order is the desired element order and |keyBytes| bounds how many of its
+ * bytes are significant. Passes in which every key shares the same byte are
+ * skipped, so e.g. int32 data spanning a small range only pays for the
+ * passes it needs.
+ *
+ * |elems| and |scratch| must each hold |len| elements. Returns a pointer to
+ * whichever of the two buffers ends up holding the sorted result.
+ */
+template <typename Elem, typename KeyFn>
+static Elem*
+RadixSort(Elem* elems, Elem* scratch, size_t len, size_t keyBytes, KeyFn key)
 {
-    MOZ_ASSERT(vec.length() >= len);
+    Elem* from = elems;
+    Elem* to = scratch;
 
-    /* Sort keys. */
-    if (!MergeSort(keys, len, scratch, comparator))
+    for (size_t shift = 0; shift < keyBytes * 8; shift += 8) {
+        size_t counts[256] = {};
+        for (size_t i = 0; i < len; i++)
+            counts[(key(from[i]) >> shift) & 0xFF]++;
+
+        if (counts[(key(from[0]) >> shift) & 0xFF] == len)
+            continue;
+
+        size_t total = 0;
+        for (size_t i = 0; i < 256; i++) {
+            size_t c = counts[i];
+            counts[i] = total;
+            total += c;
+        }
+
+        for (size_t i = 0; i < len; i++)
+            to[counts[(key(from[i]) >> shift) & 0xFF]++] = from[i];
+
+        Elem* tmp = from;
+        from = to;
+        to = tmp;
+    }
+
+    return from;
+}
+
+/*
+ * Sort |n| int32 Values of |vec| with a radix sort. Equal ints are
+ * indistinguishable, so no payload needs to be carried through the sort and
+ * the raw keys can simply be boxed back into |vec| afterwards (reversed for
+ * a descending sort). The sign bit is flipped so that unsigned byte order
+ * matches signed order.
+ */
+static bool
+SortInt32Radix(JSContext* cx, MutableHandle<GCVector<Value>> vec, size_t n, bool descending)
+{
+    MOZ_ASSERT(vec.length() >= n);
+
+    Vector<uint32_t, 0, TempAllocPolicy> keys(cx);
+    if (!keys.resize(2 * n))
         return false;
 
-    /*
-     * Reorder vec by keys in-place, going element by element.  When an out-of-
-     * place element is encountered, move that element to its proper position,
-     * displacing whatever element was at *that* point to its proper position,
-     * and so on until an element must be moved to the current position.
-     *
-     * At each outer iteration all elements up to |i| are sorted.  If
-     * necessary each inner iteration moves some number of unsorted elements
-     * (including |i|) directly to sorted position.  Thus on completion |*vec|
-     * is sorted, and out-of-position elements have moved once.  Complexity is
-     * Θ(len) + O(len) == O(2*len), with each element visited at most twice.
-     */
+    for (size_t i = 0; i < n; i++)
+        keys[i] = uint32_t(vec[i].toInt32()) ^ 0x80000000U;
+
+    uint32_t* sorted = RadixSort(keys.begin(), keys.begin() + n, n, sizeof(uint32_t),
+                                 [](uint32_t k) -> uint64_t { return k; });
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t k = sorted[descending ? n - 1 - i : i];
+        vec[i].set(Int32Value(int32_t(k ^ 0x80000000U)));
+    }
+    return true;
+}
+
+/*
+ * A sort key paired with the index of the Value it was derived from, for
+ * reordering the Values once the keys are sorted (see ReorderBySortedKeys).
+ */
+struct RadixElement
+{
+    uint64_t key;
+    size_t elementIndex;
+};
+
+/*
+ * Map a double onto a uint64 whose unsigned order is the numeric order:
+ * positive numbers get the sign bit set, negative numbers are inverted so
+ * that more-negative values order first. The two zeroes are folded together
+ * and every NaN maps to a single maximal key, so that - radix sorts being
+ * stable - elements a numeric comparator cannot distinguish keep their
+ * original order, just as they do in the MergeSort path.
+ */
+static inline uint64_t
+NumericSortKey(double d)
+{
+    if (IsNaN(d))
+        return UINT64_MAX;
+    if (d == 0)
+        d = +0.0;
+    uint64_t u = mozilla::BitwiseCast<uint64_t>(d);
+    if (u >> 63)
+        return ~u;
+    return u | (uint64_t(1) << 63);
+}
+
+/*
+ * Reorder vec by keys in-place, going element by element.  When an out-of-
+ * place element is encountered, move that element to its proper position,
+ * displacing whatever element was at *that* point to its proper position,
+ * and so on until an element must be moved to the current position.
+ *
+ * At each outer iteration all elements up to |i| are sorted.  If
+ * necessary each inner iteration moves some number of unsorted elements
+ * (including |i|) directly to sorted position.  Thus on completion |*vec|
+ * is sorted, and out-of-position elements have moved once.  Complexity is
+ * Θ(len) + O(len) == O(2*len), with each element visited at most twice.
+ */
+template <typename K>
+static inline void
+ReorderBySortedKeys(K keys, size_t len, MutableHandle<GCVector<Value>> vec)
+{
     for (size_t i = 0; i < len; i++) {
         size_t j = keys[i].elementIndex;
         if (i == j)
@@ -1931,7 +2037,19 @@ MergeSortByKey(K keys, size_t len, K scratch, C comparator, MutableHandle<GCVect
         // the assertion vacuous, so don't bother, even in debug builds.
         vec[i].set(tv);
     }
+}
+
+template <typename K, typename C>
+static inline bool
+MergeSortByKey(K keys, size_t len, K scratch, C comparator, MutableHandle<GCVector<Value>> vec)
+{
+    MOZ_ASSERT(vec.length() >= len);
+
+    /* Sort keys. */
+    if (!MergeSort(keys, len, scratch, comparator))
+        return false;
 
+    ReorderBySortedKeys(keys, len, vec);
     return true;
 }
 
@@ -2001,6 +2119,28 @@ SortNumerically(JSContext* cx, MutableHandle<GCVector<Value>> vec, size_t len,
         numElements[i] = { dv, i };
     }
 
+    /* For long arrays, sort by radix on order-preserving integer keys. */
+    if (len >= RadixSortThreshold) {
+        Vector<RadixElement, 0, TempAllocPolicy> radixElements(cx);
+
+        /* RadixSort uses the upper half as scratch space. */
+        if (!radixElements.resize(2 * len))
+            return false;
+
+        bool descending = comp == Match_RightMinusLeft;
+        for (size_t i = 0; i < len; i++) {
+            uint64_t key = NumericSortKey(numElements[i].dv);
+            radixElements[i] = { descending ? ~key : key, i };
+        }
+
+        RadixElement* sorted =
+            RadixSort(radixElements.begin(), radixElements.begin() + len, len,
+                      sizeof(uint64_t),
+                      [](const RadixElement& e) { return e.key; });
+        ReorderBySortedKeys(sorted, len, vec);
+        return true;
+    }
+
     /* Sort Values in vec numerically. */
     return MergeSortByKey(numElements.begin(), len, numElements.begin() + len,
                           SortComparatorNumerics[comp], vec);
@@ -2200,9 +2340,14 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
             }
         } else {
             if (allInts) {
-                JS_ALWAYS_TRUE(vec.resize(n * 2));
-                if (!MergeSort(vec.begin(), n, vec.begin() + n, SortComparatorInt32s[comp]))
-                    return false;
+                if (n >= RadixSortThreshold) {
+                    if (!SortInt32Radix(cx, &vec, n, comp == Match_RightMinusLeft))
+                        return false;
+                } else {
+                    JS_ALWAYS_TRUE(vec.resize(n * 2));
+                    if (!MergeSort(vec.begin(), n, vec.begin() + n, SortComparatorInt32s[comp]))
+                        return false;
+                }
             } else {
                 if (!SortNumerically(cx, &vec, n, comp))
                     return false;
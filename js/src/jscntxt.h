@@ -159,6 +159,7 @@ struct JSContext : public JS::RootingContext,
     js::WellKnownSymbols& wellKnownSymbols() { return *runtime_->wellKnownSymbols; }
     JS::BuildIdOp buildIdOp() { return runtime_->buildIdOp; }
     const JS::AsmJSCacheOps& asmJSCacheOps() { return runtime_->asmJSCacheOps; }
+    const JS::WasmCacheOps& wasmCacheOps() { return runtime_->wasmCacheOps; }
     js::PropertyName* emptyString() { return runtime_->emptyString; }
     js::FreeOp* defaultFreeOp() { return runtime_->defaultFreeOp(); }
     void* stackLimitAddress(JS::StackKind kind) { return &nativeStackLimit[kind]; }
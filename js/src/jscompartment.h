@@ -256,6 +256,16 @@ class WrapperMap
 
     OuterMap map;
 
+    // Cache of the inner map used by the last lookup or put. Bulk wrapping
+    // into one target compartment (e.g. cross-compartment messaging between
+    // two frames) hits the same inner map over and over, so remembering it
+    // skips the outer hash lookup. The pointer is into the outer map's
+    // table, so it must be invalidated whenever the outer map can rehash or
+    // remove entries. A null cachedInnerMap marks the cache as invalid;
+    // cachedCompartment may legitimately be null (the string inner map).
+    mutable JSCompartment* cachedCompartment = nullptr;
+    mutable InnerMap* cachedInnerMap = nullptr;
+
   public:
     class Enum
     {
@@ -366,12 +376,19 @@ class WrapperMap
     }
 
     Ptr lookup(const CrossCompartmentKey& k) const {
-        auto op = map.lookup(const_cast<CrossCompartmentKey&>(k).compartment());
-        if (op) {
-            auto ip = op->value().lookup(k);
-            if (ip)
-                return Ptr(ip, op->value());
+        JSCompartment* c = const_cast<CrossCompartmentKey&>(k).compartment();
+        InnerMap* inner = cachedInnerMap;
+        if (!inner || cachedCompartment != c) {
+            auto op = map.lookup(c);
+            if (!op)
+                return Ptr();
+            inner = &op->value();
+            cachedCompartment = c;
+            cachedInnerMap = inner;
         }
+        auto ip = inner->lookup(k);
+        if (ip)
+            return Ptr(ip, *inner);
         return Ptr();
     }
 
@@ -383,12 +400,18 @@ class WrapperMap
     MOZ_MUST_USE bool put(const CrossCompartmentKey& k, const JS::Value& v) {
         JSCompartment* c = const_cast<CrossCompartmentKey&>(k).compartment();
         MOZ_ASSERT(k.is<JSString*>() == !c);
+        if (cachedInnerMap && cachedCompartment == c)
+            return cachedInnerMap->put(k, v);
         auto p = map.lookupForAdd(c);
         if (!p) {
+            // Adding an entry can rehash the outer map.
+            cachedInnerMap = nullptr;
             InnerMap m;
             if (!m.init(InitialInnerMapSize) || !map.add(p, c, mozilla::Move(m)))
                 return false;
         }
+        cachedCompartment = c;
+        cachedInnerMap = &p->value();
         return p->value().put(k, v);
     }
 
@@ -418,6 +441,7 @@ class WrapperMap
     }
 
     void sweepAfterMinorGC(JSTracer* trc) {
+        cachedInnerMap = nullptr;
         for (OuterMap::Enum e(map); !e.empty(); e.popFront()) {
             InnerMap& m = e.front().value();
             m.sweepAfterMinorGC(trc);
@@ -427,6 +451,7 @@ class WrapperMap
     }
 
     void sweep() {
+        cachedInnerMap = nullptr;
         for (OuterMap::Enum e(map); !e.empty(); e.popFront()) {
             InnerMap& m = e.front().value();
             m.sweep();
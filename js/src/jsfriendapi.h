@@ -2935,6 +2935,46 @@ GetJSMEnvironmentOfScriptedCaller(JSContext* cx);
 extern JS_FRIEND_API(bool)
 IsJSMEnvironment(JSObject* obj);
 
+// Per-IC-site statistics, reported by EnumerateICSiteStats below. The stubKinds
+// and stubShapeCounts arrays are parallel and only valid for the duration of
+// the callback.
+struct ICSiteStats
+{
+    // Bytecode offset of the IC site within its script.
+    uint32_t pcOffset;
+
+    // Name of the bytecode op at the site.
+    const char* op;
+
+    // Current state of the IC: 0 = specialized, 1 = megamorphic, 2 = generic.
+    uint8_t mode;
+
+    // Number of times execution fell back to the generic path (a miss or an
+    // operation no attached stub could handle).
+    uint32_t fallbackCount;
+
+    // Number of times an attached optimized stub was entered (a hit).
+    uint32_t hitCount;
+
+    // Kind name of each attached optimized stub, and the number of shapes the
+    // stub guards on (zero for stubs that guard on something else).
+    const char* const* stubKinds;
+    const uint32_t* stubShapeCounts;
+    size_t numStubs;
+};
+
+typedef void
+(*ICSiteStatsCallback)(void* data, const ICSiteStats& stats);
+
+// Invoke |callback| for every baseline IC site of |script|. The hitCount and
+// fallbackCount fields are only maintained when the runtime runs with the
+// JIT_OPTION_enableICStats environment option set; without it they report
+// zero, while the attached-stub information is always accurate. Returns false
+// on out-of-memory.
+extern JS_FRIEND_API(bool)
+EnumerateICSiteStats(JSContext* cx, JS::HandleScript script, ICSiteStatsCallback callback,
+                     void* data);
+
 
 #if defined(XP_WIN) && defined(_WIN64)
 // Parameters use void* types to avoid #including windows.h. The return value of
@@ -3378,28 +3378,28 @@ js::gc::BackgroundDecommitTask::run()
     }
 }
 
-void
-GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
+/*
+ * Sweep all background-finalizable things in one zone. We must finalize thing
+ * kinds in the order specified by BackgroundFinalizePhases; this only
+ * constrains sweeping within the zone, as background finalizers do not touch
+ * cells in other zones, so distinct zones can be swept concurrently.
+ */
+static void
+SweepBackgroundThingsInZone(Zone* zone, FreeOp* fop, Arena** emptyArenas)
 {
-    freeBlocks.freeAll();
-
-    if (zones.isEmpty())
-        return;
-
-    // We must finalize thing kinds in the order specified by BackgroundFinalizePhases.
-    Arena* emptyArenas = nullptr;
-    FreeOp fop(nullptr);
     for (unsigned phase = 0 ; phase < ArrayLength(BackgroundFinalizePhases) ; ++phase) {
-        for (Zone* zone = zones.front(); zone; zone = zone->nextZone()) {
-            for (auto kind : BackgroundFinalizePhases[phase].kinds) {
-                Arena* arenas = zone->arenas.arenaListsToSweep(kind);
-                MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
-                if (arenas)
-                    ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas);
-            }
+        for (auto kind : BackgroundFinalizePhases[phase].kinds) {
+            Arena* arenas = zone->arenas.getFirstArenaToSweep(kind);
+            MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
+            if (arenas)
+                ArenaLists::backgroundFinalize(fop, arenas, emptyArenas);
         }
     }
+}
 
+static void
+ReleaseSweptEmptyArenas(JSRuntime* rt, Arena* emptyArenas)
+{
     AutoLockGC lock(rt);
 
     // Release swept arenas, dropping and reaquiring the lock every so often to
@@ -3416,6 +3416,104 @@ GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
             lock.lock();
         }
     }
+}
+
+/*
+ * Work queue shared by the parallel background sweep tasks below. Each unit
+ * of work is a whole zone, claimed through an atomic cursor. Sweeping a zone
+ * to completion before moving on lets each zone's empty arenas be released as
+ * soon as that zone is done, rather than when the whole queue is, so the
+ * mutator can reuse them without waiting for the other zones.
+ */
+struct BackgroundSweepWorkQueue
+{
+    Vector<Zone*, 0, SystemAllocPolicy> zones;
+    mozilla::Atomic<size_t> nextZone;
+
+    BackgroundSweepWorkQueue() : nextZone(0) {}
+};
+
+static void
+SweepZonesFromWorkQueue(JSRuntime* rt, BackgroundSweepWorkQueue& queue)
+{
+    FreeOp fop(nullptr);
+    while (true) {
+        size_t i = queue.nextZone++;
+        if (i >= queue.zones.length())
+            break;
+
+        Arena* emptyArenas = nullptr;
+        SweepBackgroundThingsInZone(queue.zones[i], &fop, &emptyArenas);
+        ReleaseSweptEmptyArenas(rt, emptyArenas);
+    }
+}
+
+class ParallelSweepZoneTask : public GCParallelTask
+{
+    BackgroundSweepWorkQueue& queue;
+
+    ParallelSweepZoneTask(const ParallelSweepZoneTask&) = delete;
+
+  public:
+    ParallelSweepZoneTask(JSRuntime* rt, BackgroundSweepWorkQueue& q)
+      : GCParallelTask(rt), queue(q)
+    {}
+
+    ParallelSweepZoneTask(ParallelSweepZoneTask&& other)
+      : GCParallelTask(Move(other)), queue(other.queue)
+    {}
+
+    void run() override {
+        AutoSetThreadIsSweeping threadIsSweeping;
+        SweepZonesFromWorkQueue(runtime(), queue);
+    }
+};
+
+void
+GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
+{
+    freeBlocks.freeAll();
+
+    if (zones.isEmpty())
+        return;
+
+    // Sweep zones in parallel across the GC helper threads when there are
+    // several of each. The calling thread claims zones from the queue too, so
+    // failing to queue a zone or start a task just means less parallelism,
+    // and a pool with no spare threads cannot deadlock the caller.
+    BackgroundSweepWorkQueue queue;
+    bool queued = true;
+    for (Zone* zone = zones.front(); zone; zone = zone->nextZone()) {
+        if (!queue.zones.append(zone)) {
+            queued = false;
+            break;
+        }
+    }
+
+    if (queued) {
+        size_t sweeperCount = Min(HelperThreadState().maxGCParallelThreads(),
+                                  queue.zones.length());
+        Vector<ParallelSweepZoneTask, 0, SystemAllocPolicy> tasks;
+        for (size_t i = 1; i < sweeperCount; i++) {
+            if (!tasks.emplaceBack(rt, queue))
+                break;
+        }
+
+        for (ParallelSweepZoneTask& task : tasks)
+            mozilla::Unused << task.start();
+
+        SweepZonesFromWorkQueue(rt, queue);
+
+        for (ParallelSweepZoneTask& task : tasks)
+            task.join();
+    } else {
+        // OOM while building the queue: sweep everything on this thread.
+        Arena* emptyArenas = nullptr;
+        FreeOp fop(nullptr);
+        for (Zone* zone = zones.front(); zone; zone = zone->nextZone())
+            SweepBackgroundThingsInZone(zone, &fop, &emptyArenas);
+        ReleaseSweptEmptyArenas(rt, emptyArenas);
+    }
 
     while (!zones.isEmpty())
         zones.removeFront();
@@ -3871,6 +3969,7 @@ GCRuntime::purgeRuntime(AutoLockForExclusiveAccess& lock)
     rt->caches().gsnCache.purge();
     rt->caches().envCoordinateNameCache.purge();
     rt->caches().newObjectCache.purge();
+    rt->caches().megamorphicCache.purge();
     rt->caches().uncompressedSourceCache.purge();
     if (rt->caches().evalCache.initialized())
         rt->caches().evalCache.clear();
@@ -4161,6 +4260,115 @@ UnmarkCollectedZones(JSRuntime* rt)
     }
 }
 
+/*
+ * Work queue shared by the parallel unmark tasks below. Each unit of work is
+ * the arena list for one alloc kind in one collected zone; the lists' lengths
+ * vary wildly, so tasks claim units one at a time through an atomic cursor
+ * rather than being handed fixed slices up front. Every arena covers a
+ * disjoint range of mark bitmap words, so distinct arena lists can be
+ * unmarked concurrently.
+ */
+struct UnmarkWorkQueue
+{
+    Vector<Arena*, 0, SystemAllocPolicy> arenaLists;
+    Vector<Zone*, 0, SystemAllocPolicy> zones;
+    mozilla::Atomic<size_t> nextArenaList;
+    mozilla::Atomic<size_t> nextZone;
+
+    UnmarkWorkQueue() : nextArenaList(0), nextZone(0) {}
+};
+
+class ParallelUnmarkTask : public GCParallelTask
+{
+    UnmarkWorkQueue& queue;
+
+    ParallelUnmarkTask(const ParallelUnmarkTask&) = delete;
+
+  public:
+    ParallelUnmarkTask(JSRuntime* rt, UnmarkWorkQueue& q)
+      : GCParallelTask(rt), queue(q)
+    {}
+
+    ParallelUnmarkTask(ParallelUnmarkTask&& other)
+      : GCParallelTask(Move(other)), queue(other.queue)
+    {}
+
+    void run() override {
+        while (true) {
+            size_t i = queue.nextArenaList++;
+            if (i >= queue.arenaLists.length())
+                break;
+            for (Arena* arena = queue.arenaLists[i]; arena; arena = arena->next)
+                arena->unmarkAll();
+        }
+
+        while (true) {
+            size_t i = queue.nextZone++;
+            if (i >= queue.zones.length())
+                break;
+            WeakMapBase::unmarkZone(queue.zones[i]);
+        }
+    }
+};
+
+static bool
+PrepareParallelUnmark(JSRuntime* rt, UnmarkWorkQueue* queue,
+                      Vector<ParallelUnmarkTask, 0, SystemAllocPolicy>* tasks)
+{
+    MOZ_ASSERT(queue->arenaLists.empty() && queue->zones.empty());
+    MOZ_ASSERT(tasks->empty());
+
+    for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
+        if (!queue->zones.append(zone.get()))
+            return false;
+        for (auto kind : AllAllocKinds()) {
+            /* The background finalization must have stopped at this point. */
+            MOZ_ASSERT(zone->arenas.doneBackgroundFinalize(kind));
+            Arena* head = zone->arenas.getFirstArena(kind);
+            if (head && !queue->arenaLists.append(head))
+                return false;
+        }
+    }
+
+    /*
+     * All tasks must be in place before any of them is started: appending
+     * after a start may move the vector's storage out from under a running
+     * task.
+     */
+    size_t taskCount = Min(HelperThreadState().maxGCParallelThreads(),
+                           queue->arenaLists.length());
+    for (size_t i = 0; i < taskCount; i++) {
+        if (!tasks->emplaceBack(rt, *queue))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Join the parallel unmark tasks at the end of their enclosing scope. The
+ * tasks run while the helper thread lock is dropped, so this must be declared
+ * before the AutoUnlockHelperThreadState whose destructor re-takes the lock.
+ */
+class MOZ_RAII AutoJoinParallelUnmarkTasks
+{
+    GCRuntime& gc_;
+    Vector<ParallelUnmarkTask, 0, SystemAllocPolicy>& tasks_;
+    AutoLockHelperThreadState& lock_;
+
+  public:
+    AutoJoinParallelUnmarkTasks(GCRuntime& gc,
+                                Vector<ParallelUnmarkTask, 0, SystemAllocPolicy>& tasks,
+                                AutoLockHelperThreadState& lock)
+      : gc_(gc), tasks_(tasks), lock_(lock)
+    {}
+
+    ~AutoJoinParallelUnmarkTasks() {
+        for (ParallelUnmarkTask& task : tasks_)
+            gc_.joinTask(task, gcstats::PhaseKind::UNMARK, lock_);
+    }
+};
+
 static void
 BufferGrayRoots(JSRuntime* rt)
 {
@@ -4196,11 +4404,23 @@ GCRuntime::beginMarkPhase(JS::gcreason::Reason reason, AutoLockForExclusiveAcces
 
         /*
          * Clear all mark state for the zones we are collecting. This is linear
-         * in the size of the heap we are collecting and so can be slow. Do this
-         * in parallel with the rest of this block.
+         * in the size of the heap we are collecting and so can be slow. Spread
+         * the work over as many helper threads as are available, in parallel
+         * with the rest of this block.
          */
-        AutoRunParallelTask
-            unmarkCollectedZones(rt, UnmarkCollectedZones, gcstats::PhaseKind::UNMARK, helperLock);
+        UnmarkWorkQueue unmarkQueue;
+        Vector<ParallelUnmarkTask, 0, SystemAllocPolicy> unmarkTasks;
+        Maybe<AutoRunParallelTask> unmarkCollectedZones;
+        AutoJoinParallelUnmarkTasks joinUnmarkTasks(*this, unmarkTasks, helperLock);
+        if (PrepareParallelUnmark(rt, &unmarkQueue, &unmarkTasks)) {
+            for (ParallelUnmarkTask& task : unmarkTasks)
+                startTask(task, gcstats::PhaseKind::UNMARK, helperLock);
+        } else {
+            /* If we ran out of memory, unmark on a single helper thread. */
+            unmarkTasks.clearAndFree();
+            unmarkCollectedZones.emplace(rt, UnmarkCollectedZones, gcstats::PhaseKind::UNMARK,
+                                         helperLock);
+        }
 
         /*
          * Buffer gray roots for incremental collections. This is linear in the
@@ -4230,6 +4450,7 @@ GCRuntime::beginMarkPhase(JS::gcreason::Reason reason, AutoLockForExclusiveAcces
         if (invocationKind == GC_SHRINK) {
             RelazifyFunctionsForShrinkingGC(rt);
             PurgeShapeTablesForShrinkingGC(rt);
+            LifoAlloc::purgeRecycledChunks();
         }
 
         /*
@@ -4359,13 +4580,17 @@ GCRuntime::updateMallocCountersOnGC()
 
 template <class ZoneIterT>
 void
-GCRuntime::markWeakReferences(gcstats::PhaseKind phase)
+GCRuntime::markWeakReferences(gcstats::PhaseKind phase, bool keepWeakMarkingMode)
 {
     MOZ_ASSERT(marker.isDrained());
 
     gcstats::AutoPhase ap1(stats(), phase);
 
-    marker.enterWeakMarkingMode();
+    // If a previous pass for this sweep group kept weak marking mode on, the
+    // weak keys table has already tracked every key marked since then, so
+    // there is no need to scan the weakmaps again.
+    if (!marker.isWeakMarkingTracer())
+        marker.enterWeakMarkingMode();
 
     // TODO bug 1167452: Make weak marking incremental
     auto unlimited = SliceBudget::unlimited();
@@ -4392,13 +4617,19 @@ GCRuntime::markWeakReferences(gcstats::PhaseKind phase)
     }
     MOZ_ASSERT(marker.isDrained());
 
-    marker.leaveWeakMarkingMode();
+    // Leaving weak marking mode clears the weak keys table. The black weak
+    // pass of a sweep group stays in the mode instead, so that keys marked
+    // during the gray marking that follows trigger marking of their ephemeron
+    // values as they are discovered, and the gray weak pass above need not
+    // rescan the weakmaps to find them.
+    if (!keepWeakMarkingMode)
+        marker.leaveWeakMarkingMode();
 }
 
 void
-GCRuntime::markWeakReferencesInCurrentGroup(gcstats::PhaseKind phase)
+GCRuntime::markWeakReferencesInCurrentGroup(gcstats::PhaseKind phase, bool keepWeakMarkingMode)
 {
-    markWeakReferences<GCSweepGroupIter>(phase);
+    markWeakReferences<GCSweepGroupIter>(phase, keepWeakMarkingMode);
 }
 
 template <class ZoneIterT, class CompartmentIterT>
@@ -5173,8 +5404,15 @@ GCRuntime::endMarkingSweepGroup()
      * whose referents are not marked. This can occur when gray cells become
      * black by the action of UnmarkGray.
      */
+    /*
+     * Stay in weak marking mode after marking the black weak references, so
+     * that the weak keys table keeps tracking keys marked during the gray
+     * marking below and the gray weak pass does not have to rescan the
+     * weakmaps from scratch.
+     */
     MarkIncomingCrossCompartmentPointers(rt, MarkColor::Black);
-    markWeakReferencesInCurrentGroup(gcstats::PhaseKind::SWEEP_MARK_WEAK);
+    markWeakReferencesInCurrentGroup(gcstats::PhaseKind::SWEEP_MARK_WEAK,
+                                     /* keepWeakMarkingMode = */ true);
 
     /*
      * Change state of current group to MarkGray to restrict marking to this
@@ -6464,6 +6702,7 @@ GCRuntime::compactPhase(JS::gcreason::Reason reason, SliceBudget& sliceBudget,
 
     // Clear caches that can contain cell pointers.
     rt->caches().newObjectCache.purge();
+    rt->caches().megamorphicCache.purge();
     if (rt->caches().evalCache.initialized())
         rt->caches().evalCache.clear();
 
@@ -13,6 +13,15 @@
 #include <stdio.h>
 #include <string.h>
 
+/*
+ * SSE2 is part of the x64 baseline, so the character kernels below can use it
+ * unconditionally there; on x86 it depends on the compiler's target settings.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_HAS_SSE2_STRING_KERNELS 1
+# include <emmintrin.h>
+#endif
+
 #include "jsutil.h"
 #include "NamespaceImports.h"
 
@@ -240,6 +249,38 @@ EqualChars(const Char1* s1, const Char2* s2, size_t len)
     return true;
 }
 
+inline bool
+EqualChars(const JS::Latin1Char* s1, const char16_t* s2, size_t len)
+{
+    size_t i = 0;
+#ifdef JS_HAS_SSE2_STRING_KERNELS
+    /* Compare sixteen code units per iteration, widening the Latin1 side. */
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16) {
+        __m128i narrow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + i));
+        __m128i eqlo =
+            _mm_cmpeq_epi16(_mm_unpacklo_epi8(narrow, zero),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i)));
+        __m128i eqhi =
+            _mm_cmpeq_epi16(_mm_unpackhi_epi8(narrow, zero),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i + 8)));
+        if (_mm_movemask_epi8(_mm_and_si128(eqlo, eqhi)) != 0xFFFF)
+            return false;
+    }
+#endif
+    for (; i < len; i++) {
+        if (s1[i] != s2[i])
+            return false;
+    }
+    return true;
+}
+
+inline bool
+EqualChars(const char16_t* s1, const JS::Latin1Char* s2, size_t len)
+{
+    return EqualChars(s2, s1, len);
+}
+
 /*
  * Computes |str|'s substring for the range [beginInt, beginInt + lengthInt).
  * Negative, overlarge, swapped, etc. |beginInt| and |lengthInt| are forbidden
@@ -260,18 +301,56 @@ InflateString(JSContext* cx, const char* bytes, size_t length);
  * Inflate bytes to JS chars in an existing buffer. 'dst' must be large
  * enough for 'srclen' char16_t code units. The buffer is NOT null-terminated.
  */
+inline void
+CopyAndInflateChars(char16_t* dst, const JS::Latin1Char* src, size_t srclen)
+{
+    size_t i = 0;
+#ifdef JS_HAS_SSE2_STRING_KERNELS
+    /* Widen sixteen code units per iteration by interleaving with zeroes. */
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= srclen; i += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_unpacklo_epi8(chars, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8),
+                         _mm_unpackhi_epi8(chars, zero));
+    }
+#endif
+    for (; i < srclen; i++)
+        dst[i] = src[i];
+}
+
 inline void
 CopyAndInflateChars(char16_t* dst, const char* src, size_t srclen)
 {
-    for (size_t i = 0; i < srclen; i++)
-        dst[i] = (unsigned char) src[i];
+    CopyAndInflateChars(dst, reinterpret_cast<const JS::Latin1Char*>(src), srclen);
 }
 
+/*
+ * Deflate JS chars into a Latin1 buffer. Every code unit must be in the
+ * Latin1 range. 'dst' must be large enough for 'srclen' code units. The
+ * buffer is NOT null-terminated.
+ */
 inline void
-CopyAndInflateChars(char16_t* dst, const JS::Latin1Char* src, size_t srclen)
+CopyAndDeflateChars(JS::Latin1Char* dst, const char16_t* src, size_t srclen)
 {
+#ifdef DEBUG
     for (size_t i = 0; i < srclen; i++)
-        dst[i] = src[i];
+        MOZ_ASSERT(src[i] <= 0xFF);
+#endif
+    size_t i = 0;
+#ifdef JS_HAS_SSE2_STRING_KERNELS
+    /* Narrow sixteen code units per iteration; all are in [0, 0xFF], so the
+     * saturation in _mm_packus_epi16 never kicks in. */
+    for (; i + 16 <= srclen; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < srclen; i++)
+        dst[i] = JS::Latin1Char(src[i]);
 }
 
 /*
@@ -319,6 +319,7 @@ static uint32_t gZealFrequency = 0;
 static bool printTiming = false;
 static const char* jsCacheDir = nullptr;
 static const char* jsCacheAsmJSPath = nullptr;
+static const char* jsCacheWasmPath = nullptr;
 static RCFile* gErrFile = nullptr;
 static RCFile* gOutFile = nullptr;
 static bool reportWarnings = true;
@@ -7534,14 +7535,13 @@ class ScopedFileDesc
 static const uint32_t asmJSCacheCookie = 0xabbadaba;
 
 static bool
-ShellOpenAsmJSCacheEntryForRead(HandleObject global, const char16_t* begin, const char16_t* limit,
-                                size_t* serializedSizeOut, const uint8_t** memoryOut,
-                                intptr_t* handleOut)
+ShellOpenCacheEntryForRead(const char* path, size_t* serializedSizeOut, const uint8_t** memoryOut,
+                           intptr_t* handleOut)
 {
-    if (!jsCachingEnabled || !jsCacheAsmJSPath)
+    if (!jsCachingEnabled || !path)
         return false;
 
-    ScopedFileDesc fd(open(jsCacheAsmJSPath, O_RDWR), ScopedFileDesc::READ_LOCK);
+    ScopedFileDesc fd(open(path, O_RDWR), ScopedFileDesc::READ_LOCK);
     if (fd == -1)
         return false;
 
@@ -7587,7 +7587,7 @@ ShellOpenAsmJSCacheEntryForRead(HandleObject global, const char16_t* begin, cons
 }
 
 static void
-ShellCloseAsmJSCacheEntryForRead(size_t serializedSize, const uint8_t* memory, intptr_t handle)
+ShellCloseCacheEntryForRead(size_t serializedSize, const uint8_t* memory, intptr_t handle)
 {
     // Undo the cookie adjustment done when opening the file.
     memory -= sizeof(uint32_t);
@@ -7606,11 +7606,10 @@ ShellCloseAsmJSCacheEntryForRead(size_t serializedSize, const uint8_t* memory, i
 }
 
 static JS::AsmJSCacheResult
-ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
-                                 const char16_t* end, size_t serializedSize,
-                                 uint8_t** memoryOut, intptr_t* handleOut)
+ShellOpenCacheEntryForWrite(const char* path, size_t serializedSize,
+                            uint8_t** memoryOut, intptr_t* handleOut)
 {
-    if (!jsCachingEnabled || !jsCacheAsmJSPath)
+    if (!jsCachingEnabled || !path)
         return JS::AsmJSCache_Disabled_ShellFlags;
 
     // Create the cache directory if it doesn't already exist.
@@ -7628,7 +7627,7 @@ ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
 #endif
     }
 
-    ScopedFileDesc fd(open(jsCacheAsmJSPath, O_CREAT|O_RDWR, 0660), ScopedFileDesc::WRITE_LOCK);
+    ScopedFileDesc fd(open(path, O_CREAT|O_RDWR, 0660), ScopedFileDesc::WRITE_LOCK);
     if (fd == -1)
         return JS::AsmJSCache_InternalError;
 
@@ -7678,7 +7677,7 @@ ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
 }
 
 static void
-ShellCloseAsmJSCacheEntryForWrite(size_t serializedSize, uint8_t* memory, intptr_t handle)
+ShellCloseCacheEntryForWrite(size_t serializedSize, uint8_t* memory, intptr_t handle)
 {
     // Undo the cookie adjustment done when opening the file.
     memory -= sizeof(uint32_t);
@@ -7723,11 +7722,55 @@ ShellBuildId(JS::BuildIdCharVector* buildId)
     return buildId->append(buildid, sizeof(buildid));
 }
 
+static bool
+ShellOpenAsmJSCacheEntryForRead(HandleObject global, const char16_t* begin, const char16_t* limit,
+                                size_t* serializedSizeOut, const uint8_t** memoryOut,
+                                intptr_t* handleOut)
+{
+    return ShellOpenCacheEntryForRead(jsCacheAsmJSPath, serializedSizeOut, memoryOut, handleOut);
+}
+
+static JS::AsmJSCacheResult
+ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
+                                 const char16_t* end, size_t serializedSize,
+                                 uint8_t** memoryOut, intptr_t* handleOut)
+{
+    return ShellOpenCacheEntryForWrite(jsCacheAsmJSPath, serializedSize, memoryOut, handleOut);
+}
+
+// Like the asm.js cache, the shell's wasm cache is a single file keyed by
+// nothing: the last stored module wins. The engine rejects a mismatched entry
+// via the Assumptions serialized into it, so a collision is only ever wrong
+// in the benign direction of a cache miss.
+
+static bool
+ShellOpenWasmCacheEntryForRead(const uint8_t* bytecodeBegin, const uint8_t* bytecodeLimit,
+                               size_t* serializedSizeOut, const uint8_t** memoryOut,
+                               intptr_t* handleOut)
+{
+    return ShellOpenCacheEntryForRead(jsCacheWasmPath, serializedSizeOut, memoryOut, handleOut);
+}
+
+static bool
+ShellOpenWasmCacheEntryForWrite(const uint8_t* bytecodeBegin, const uint8_t* bytecodeLimit,
+                                size_t serializedSize, uint8_t** memoryOut, intptr_t* handleOut)
+{
+    return ShellOpenCacheEntryForWrite(jsCacheWasmPath, serializedSize, memoryOut, handleOut) ==
+           JS::AsmJSCache_Success;
+}
+
 static const JS::AsmJSCacheOps asmJSCacheOps = {
     ShellOpenAsmJSCacheEntryForRead,
-    ShellCloseAsmJSCacheEntryForRead,
+    ShellCloseCacheEntryForRead,
     ShellOpenAsmJSCacheEntryForWrite,
-    ShellCloseAsmJSCacheEntryForWrite
+    ShellCloseCacheEntryForWrite
+};
+
+static const JS::WasmCacheOps wasmCacheOps = {
+    ShellOpenWasmCacheEntryForRead,
+    ShellCloseCacheEntryForRead,
+    ShellOpenWasmCacheEntryForWrite,
+    ShellCloseCacheEntryForWrite
 };
 
 static bool
@@ -8248,6 +8291,7 @@ SetContextOptions(JSContext* cx, const OptionParser& op)
         if (!jsCacheDir)
             return false;
         jsCacheAsmJSPath = JS_smprintf("%s/asmjs.cache", jsCacheDir).release();
+        jsCacheWasmPath = JS_smprintf("%s/wasm.cache", jsCacheDir).release();
     }
 
 #ifdef DEBUG
@@ -8701,6 +8745,7 @@ main(int argc, char** argv, char** envp)
     JS_AddInterruptCallback(cx, ShellInterruptCallback);
     JS::SetBuildIdOp(cx, ShellBuildId);
     JS::SetAsmJSCacheOps(cx, &asmJSCacheOps);
+    JS::SetWasmCacheOps(cx, &wasmCacheOps);
 
     JS_SetNativeStackQuota(cx, gMaxStackSize);
 
@@ -43,8 +43,11 @@
 #include "gc/Memory.h"
 #include "js/Conversions.h"
 #include "js/MemoryMetrics.h"
+#include "threading/LockGuard.h"
+#include "threading/Mutex.h"
 #include "vm/GlobalObject.h"
 #include "vm/Interpreter.h"
+#include "vm/MutexIDs.h"
 #include "vm/SharedArrayObject.h"
 #include "vm/WrapperObject.h"
 #include "wasm/WasmSignalHandlers.h"
@@ -311,6 +314,121 @@ AllocateArrayBufferContents(JSContext* cx, uint32_t nbytes)
     return ArrayBufferObject::BufferContents::create<ArrayBufferObject::PLAIN>(p);
 }
 
+// Buffers at least this large are backed directly by anonymous page mappings
+// (BufferKind::LARGE_MMAPPED) instead of the malloc heap, so that releasing
+// one reliably returns the physical pages to the OS instead of leaving them
+// stranded in malloc's free lists.
+static const size_t LargeBufferMinSize = 1024 * 1024;
+
+// A small cache of recently released large-buffer mappings. Entries have had
+// their pages marked unused, so they consume address space but (on platforms
+// supporting decommit) no physical memory; reusing one saves the map/unmap
+// syscalls and the attendant TLB shootdowns on hot allocate/free cycles.
+class LargeBufferContentsPool
+{
+    static const size_t MaxEntries = 8;
+#ifdef JS_64BIT
+    static const size_t MaxPooledBytes = 256 * 1024 * 1024;
+#else
+    // Virtual address space is scarce on 32-bit; keep the cache small.
+    static const size_t MaxPooledBytes = 32 * 1024 * 1024;
+#endif
+
+    struct Entry {
+        void* base;
+        size_t nbytes;  // Page-rounded size of the mapping.
+        bool zeroed;    // Whether the pages read back as zeroes.
+    };
+
+    Mutex lock_;
+    Entry entries_[MaxEntries];
+    size_t numEntries_;
+    size_t pooledBytes_;
+
+  public:
+    LargeBufferContentsPool()
+      : lock_(mutexid::ArrayBufferLargeContentsPool),
+        numEntries_(0),
+        pooledBytes_(0)
+    {}
+
+    // Return a zero-filled mapping of exactly |nbytes| (page-rounded) bytes,
+    // or nullptr if no cached mapping of that size exists.
+    void* acquire(size_t nbytes) {
+        void* base = nullptr;
+        bool zeroed = false;
+        {
+            LockGuard<Mutex> guard(lock_);
+            for (size_t i = 0; i < numEntries_; i++) {
+                if (entries_[i].nbytes != nbytes)
+                    continue;
+                base = entries_[i].base;
+                zeroed = entries_[i].zeroed;
+                entries_[i] = entries_[--numEntries_];
+                pooledBytes_ -= nbytes;
+                break;
+            }
+        }
+        if (!base)
+            return nullptr;
+
+        gc::MarkPagesInUse(base, nbytes);
+        if (!zeroed)
+            memset(base, 0, nbytes);
+        return base;
+    }
+
+    // Take ownership of a mapping, returning false if the caller must unmap
+    // it instead.
+    bool release(void* base, size_t nbytes) {
+        // Only retain mappings whose pages we managed to hand back to the OS;
+        // otherwise a full cache would pin up to MaxPooledBytes of RSS.
+        if (!gc::MarkPagesUnused(base, nbytes))
+            return false;
+
+#ifdef XP_LINUX
+        // MADV_DONTNEED guarantees that the next access to these pages sees
+        // zero-filled memory.
+        bool zeroed = true;
+#else
+        // MEM_RESET on Windows and madvise on the other Unices may preserve
+        // the old contents, so acquire() must clear reused mappings.
+        bool zeroed = false;
+#endif
+
+        LockGuard<Mutex> guard(lock_);
+        if (numEntries_ == MaxEntries || pooledBytes_ + nbytes > MaxPooledBytes)
+            return false;
+        entries_[numEntries_++] = Entry { base, nbytes, zeroed };
+        pooledBytes_ += nbytes;
+        return true;
+    }
+};
+
+static LargeBufferContentsPool largeBufferContentsPool;
+
+static ArrayBufferObject::BufferContents
+AllocateLargeBufferContents(size_t nbytes)
+{
+    MOZ_ASSERT(nbytes >= LargeBufferMinSize);
+
+    size_t roundedSize = JS_ROUNDUP(nbytes, gc::SystemPageSize());
+    void* p = largeBufferContentsPool.acquire(roundedSize);
+    if (!p) {
+        // Fresh anonymous mappings are zero-filled by the OS.
+        p = gc::MapAlignedPages(roundedSize, gc::SystemPageSize());
+    }
+    return ArrayBufferObject::BufferContents::create<ArrayBufferObject::LARGE_MMAPPED>(p);
+}
+
+static void
+ReleaseLargeBufferContents(void* data, size_t nbytes)
+{
+    size_t roundedSize = JS_ROUNDUP(nbytes, gc::SystemPageSize());
+    if (!largeBufferContentsPool.release(data, roundedSize))
+        gc::UnmapPages(data, roundedSize);
+}
+
 static void
 NoteViewBufferWasDetached(ArrayBufferViewObject* view,
                           ArrayBufferObject::BufferContents newContents,
@@ -329,6 +447,17 @@ ArrayBufferObject::detach(JSContext* cx, Handle<ArrayBufferObject*> buffer,
     assertSameCompartment(cx, buffer);
     MOZ_ASSERT(!buffer->isPreparedForAsmJS());
 
+    // Large mmapped contents cannot be stolen (see hasStealableContents), so
+    // callers that would otherwise keep the old data around pass it back in
+    // unchanged. Release it eagerly instead: a detached buffer's data can
+    // never be accessed again, and releasing hands the pages straight back to
+    // the OS rather than waiting for the buffer to be finalized.
+    if (buffer->isLargeMmapped() && buffer->ownsData() &&
+        newContents.data() == buffer->dataPointer())
+    {
+        newContents = BufferContents::createPlain(nullptr);
+    }
+
     // When detaching buffers where we don't know all views, the new data must
     // match the old data. All missing views are typed objects, which do not
     // expect their data to ever change.
@@ -864,8 +993,9 @@ ArrayBufferObject::releaseData(FreeOp* fop)
       case WASM:
         WasmArrayRawBuffer::Release(dataPointer());
         break;
-      case KIND_MASK:
-        MOZ_CRASH("bad bufferKind()");
+      case LARGE_MMAPPED:
+        ReleaseLargeBufferContents(dataPointer(), byteLength());
+        break;
     }
 }
 
@@ -1072,9 +1202,18 @@ ArrayBufferObject::create(JSContext* cx, uint32_t nbytes, BufferContents content
             nslots = reservedSlots + newSlots;
             contents = BufferContents::createPlain(nullptr);
         } else {
-            contents = AllocateArrayBufferContents(cx, nbytes);
-            if (!contents)
-                return nullptr;
+            if (nbytes >= LargeBufferMinSize) {
+                contents = AllocateLargeBufferContents(nbytes);
+                if (contents)
+                    cx->updateMallocCounter(JS_ROUNDUP(nbytes, js::gc::SystemPageSize()));
+            }
+            if (!contents) {
+                // Either the buffer is small or mapping pages failed; fall
+                // back to the malloc heap.
+                contents = AllocateArrayBufferContents(cx, nbytes);
+                if (!contents)
+                    return nullptr;
+            }
             allocated = true;
         }
     }
@@ -1086,8 +1225,12 @@ ArrayBufferObject::create(JSContext* cx, uint32_t nbytes, BufferContents content
     Rooted<ArrayBufferObject*> obj(cx,
         NewObjectWithClassProto<ArrayBufferObject>(cx, proto, allocKind, newKind));
     if (!obj) {
-        if (allocated)
-            js_free(contents.data());
+        if (allocated) {
+            if (contents.kind() == LARGE_MMAPPED)
+                ReleaseLargeBufferContents(contents.data(), nbytes);
+            else
+                js_free(contents.data());
+        }
         return nullptr;
     }
 
@@ -1210,8 +1353,9 @@ ArrayBufferObject::addSizeOfExcludingThis(JSObject* obj, mozilla::MallocSizeOf m
         MOZ_ASSERT(buffer.wasmMappedSize() >= buffer.byteLength());
         info->wasmGuardPages += buffer.wasmMappedSize() - buffer.byteLength();
         break;
-      case KIND_MASK:
-        MOZ_CRASH("bad bufferKind()");
+      case LARGE_MMAPPED:
+        info->objectsNonHeapElementsNormal += buffer.byteLength();
+        break;
     }
 }
 
@@ -157,6 +157,11 @@ class ArrayBufferObject : public ArrayBufferObjectMaybeShared
         WASM                = 1,
         MAPPED              = 2,
 
+        // Data allocated directly from the OS as anonymous pages rather than
+        // from the malloc heap. Used for large (>= 1 MiB) buffers so that
+        // releasing one reliably hands the physical pages back to the OS.
+        LARGE_MMAPPED       = 3,
+
         KIND_MASK           = 0x3
     };
 
@@ -269,8 +274,11 @@ class ArrayBufferObject : public ArrayBufferObjectMaybeShared
                                         bool hasStealableContents);
 
     bool hasStealableContents() const {
-        // Inline elements strictly adhere to the corresponding buffer.
-        return ownsData() && !isPreparedForAsmJS() && !isWasm();
+        // Inline elements strictly adhere to the corresponding buffer. Large
+        // mmapped contents cannot be stolen either: everything downstream of
+        // stealing (structured clone, embedder APIs) expects a pointer it can
+        // hand to js_free.
+        return ownsData() && !isPreparedForAsmJS() && !isWasm() && !isLargeMmapped();
     }
 
     static void addSizeOfExcludingThis(JSObject* obj, mozilla::MallocSizeOf mallocSizeOf,
@@ -326,6 +334,7 @@ class ArrayBufferObject : public ArrayBufferObjectMaybeShared
     bool isPlain() const { return bufferKind() == PLAIN; }
     bool isWasm() const { return bufferKind() == WASM; }
     bool isMapped() const { return bufferKind() == MAPPED; }
+    bool isLargeMmapped() const { return bufferKind() == LARGE_MMAPPED; }
     bool isDetached() const { return flags() & DETACHED; }
     bool isPreparedForAsmJS() const { return flags() & FOR_ASMJS; }
 
@@ -244,6 +244,111 @@ class NewObjectCache
     }
 };
 
+/*
+ * Cache for megamorphic property lookups. Once a property access site has
+ * seen more shapes than an IC chain can hold, it falls back to a generic
+ * stub which calls into GetNativeDataProperty and walks the proto chain,
+ * searching every shape lineage on the way. This cache maps a (receiver
+ * shape, id) pair to the number of proto hops to the holder and the slot the
+ * property lives in, so repeated megamorphic lookups cost a hash probe and a
+ * shape check per hop instead of a full walk.
+ *
+ * A hit is only trusted after re-checking the shape of every object on the
+ * path to the holder: equal shapes imply equal lineages, so the cached slot
+ * is valid no matter how the objects themselves have been shuffled around.
+ * Dictionary mode shapes are mutated in place and are therefore never
+ * cached. Entries hold unbarriered Shape and atom pointers, so the cache
+ * must be purged whenever the GC may invalidate them (see
+ * GCRuntime::purgeRuntime and the compacting GC).
+ */
+class MegamorphicCache
+{
+  public:
+    /* The maximum number of proto hops a cached lookup may cover. */
+    static const uint8_t MaxHops = 4;
+
+  private:
+    struct Entry
+    {
+        /* The receiver object's shape and the property key. */
+        Shape* shape;
+        jsid id;
+
+        /*
+         * Shapes of the prototypes walked to reach the holder; index |i| is
+         * the shape of the object |i + 1| hops from the receiver. Only the
+         * first |numHops| entries are meaningful.
+         */
+        Shape* protoShapes[MaxHops];
+
+        uint32_t slot;
+        uint8_t numHops;
+    };
+
+    static const size_t NumEntries = 512;
+    Entry entries_[NumEntries];
+
+    static Entry& entryFor(Entry* entries, Shape* shape, jsid id) {
+        uintptr_t hash = uintptr_t(shape) ^ (uintptr_t(shape) >> 13) ^ JSID_BITS(id);
+        static_assert((NumEntries & (NumEntries - 1)) == 0,
+                      "NumEntries must be a power of two");
+        return entries[(hash ^ (hash >> 20)) & (NumEntries - 1)];
+    }
+
+  public:
+    MegamorphicCache() { purge(); }
+
+    void purge() { mozilla::PodZero(entries_, NumEntries); }
+
+    /*
+     * Look up a cached data property lookup for |obj| and |id|. On a hit the
+     * holder and slot have been verified against the current proto chain and
+     * the property may be read directly.
+     */
+    MOZ_ALWAYS_INLINE bool lookup(NativeObject* obj, jsid id,
+                                  NativeObject** holderOut, uint32_t* slotOut)
+    {
+        Entry& entry = entryFor(entries_, obj->lastProperty(), id);
+        if (entry.shape != obj->lastProperty() || entry.id != id)
+            return false;
+
+        NativeObject* holder = obj;
+        for (uint8_t i = 0; i < entry.numHops; i++) {
+            JSObject* proto = holder->staticPrototype();
+            if (MOZ_UNLIKELY(!proto || !proto->isNative()))
+                return false;
+            holder = &proto->as<NativeObject>();
+            if (holder->lastProperty() != entry.protoShapes[i])
+                return false;
+        }
+
+        *holderOut = holder;
+        *slotOut = entry.slot;
+        return true;
+    }
+
+    /*
+     * Record a successful data property lookup. |protoShapes| holds the
+     * shapes of the |numHops| prototypes walked from the receiver to the
+     * holder; the caller must not cache lookups involving dictionary shapes.
+     */
+    void fill(Shape* receiverShape, jsid id, uint8_t numHops, Shape* const* protoShapes,
+              uint32_t slot)
+    {
+        MOZ_ASSERT(numHops <= MaxHops);
+        MOZ_ASSERT(!receiverShape->inDictionary());
+        Entry& entry = entryFor(entries_, receiverShape, id);
+        entry.shape = receiverShape;
+        entry.id = id;
+        for (uint8_t i = 0; i < numHops; i++) {
+            MOZ_ASSERT(!protoShapes[i]->inDictionary());
+            entry.protoShapes[i] = protoShapes[i];
+        }
+        entry.slot = slot;
+        entry.numHops = numHops;
+    }
+};
+
 class RuntimeCaches
 {
     UniquePtr<js::MathCache> mathCache_;
@@ -254,6 +359,7 @@ class RuntimeCaches
     js::GSNCache gsnCache;
     js::EnvironmentCoordinateNameCache envCoordinateNameCache;
     js::NewObjectCache newObjectCache;
+    js::MegamorphicCache megamorphicCache;
     js::UncompressedSourceCache uncompressedSourceCache;
     js::EvalCache evalCache;
     LazyScriptCache lazyScriptCache;
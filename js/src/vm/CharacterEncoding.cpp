@@ -6,6 +6,7 @@
 
 #include "js/CharacterEncoding.h"
 
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Range.h"
 #include "mozilla/Sprintf.h"
 
@@ -14,6 +15,7 @@
 
 #include "jscntxt.h"
 #include "jsprf.h"
+#include "jsstr.h"
 
 using namespace js;
 
@@ -250,6 +252,41 @@ ReportTooBigCharacter(JSContext* cx, uint32_t v)
                                       JSMSG_UTF8_CHAR_TOO_LARGE, buffer);
 }
 
+/*
+ * Return the length of the leading all-ASCII run of |s|, checking sixteen
+ * bytes per iteration where SSE2 is available. UTF-8 text is mostly ASCII in
+ * practice, so the inflation loop below leans on this to skip the per-byte
+ * decoding for whole runs at a time.
+ */
+static MOZ_ALWAYS_INLINE size_t
+AsciiRunLength(const uint8_t* s, size_t len)
+{
+    size_t i = 0;
+#ifdef JS_HAS_SSE2_STRING_KERNELS
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        int mask = _mm_movemask_epi8(chunk);
+        if (mask)
+            return i + mozilla::CountTrailingZeroes32(mask);
+    }
+#endif
+    while (i < len && !(s[i] & 0x80))
+        i++;
+    return i;
+}
+
+static MOZ_ALWAYS_INLINE void
+CopyAsciiRun(Latin1Char* dst, const uint8_t* src, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+static MOZ_ALWAYS_INLINE void
+CopyAsciiRun(char16_t* dst, const uint8_t* src, size_t len)
+{
+    CopyAndInflateChars(dst, reinterpret_cast<const Latin1Char*>(src), len);
+}
+
 enum InflateUTF8Action {
     CountAndReportInvalids,
     CountAndIgnoreInvalids,
@@ -284,9 +321,15 @@ InflateUTF8StringToBuffer(ContextT* cx, const UTF8Chars src, CharT* dst, size_t*
     for (uint32_t i = 0; i < srclen; i++, j++) {
         uint32_t v = uint32_t(src[i]);
         if (!(v & 0x80)) {
-            // ASCII code unit.  Simple copy.
+            // ASCII code unit, and usually the first of a run.  Handle the
+            // whole run at once.
+            size_t runLength = AsciiRunLength(reinterpret_cast<const uint8_t*>(&src[i]),
+                                              srclen - i);
+            MOZ_ASSERT(runLength >= 1);
             if (Action == Copy)
-                dst[j] = CharT(v);
+                CopyAsciiRun(dst + j, reinterpret_cast<const uint8_t*>(&src[i]), runLength);
+            i += runLength - 1;
+            j += runLength - 1;
 
         } else {
             // Non-ASCII code unit.  Determine its length in bytes (n).
@@ -407,10 +450,8 @@ InflateUTF8StringHelper(ContextT* cx, const UTF8Chars src, size_t* outlen)
     }
 
     if (encoding == JS::SmallestEncoding::ASCII) {
-        size_t srclen = src.length();
-        MOZ_ASSERT(*outlen == srclen);
-        for (uint32_t i = 0; i < srclen; i++)
-            dst[i] = CharT(src[i]);
+        MOZ_ASSERT(*outlen == src.length());
+        CopyAsciiRun(dst, reinterpret_cast<const uint8_t*>(src.begin().get()), src.length());
     } else {
         MOZ_ALWAYS_TRUE((InflateUTF8StringToBuffer<Copy, CharT>(cx, src, dst, outlen, &encoding)));
     }
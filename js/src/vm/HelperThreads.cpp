@@ -487,6 +487,107 @@ ParseTask::trace(JSTracer* trc)
     sourceObjects.trace(trc);
 }
 
+// Push the lazy inner functions of |script| onto |stack| in reverse order, so
+// that popping them off visits them in source order.
+static bool
+PushLazyInnerFunctions(JSScript* script, MutableHandle<FunctionVector> stack)
+{
+    if (!script->hasObjects())
+        return true;
+
+    ObjectArray* objects = script->objects();
+    for (size_t i = objects->length; i > 0; i--) {
+        JSObject* obj = objects->vector[i - 1];
+        if (!obj->is<JSFunction>())
+            continue;
+        JSFunction* fun = &obj->as<JSFunction>();
+        if (!fun->isInterpretedLazy())
+            continue;
+        LazyScript* lazy = fun->lazyScriptOrNull();
+        if (!lazy || lazy->maybeScript() || !lazy->scriptSource()->hasSourceData())
+            continue;
+        if (!stack.append(fun))
+            return false;
+    }
+    return true;
+}
+
+// The off thread analogue of the source-compiling path of
+// JSFunction::createScriptForLazilyInterpretedFunction. The lazy script cache
+// and the XDR encoder are skipped here: both live on the runtime and are not
+// safe to touch from a helper thread.
+static bool
+DelazifyInnerFunction(JSContext* cx, HandleFunction fun)
+{
+    Rooted<LazyScript*> lazy(cx, fun->lazyScript());
+    MOZ_ASSERT(fun == lazy->functionNonDelazifying());
+    MOZ_ASSERT(!lazy->maybeScript());
+
+    // The source of a script being parsed off thread is not compressed until
+    // the task finishes on the active thread, so this takes the uncompressed
+    // path in ScriptSource::chars and does not touch the runtime's
+    // UncompressedSourceCache.
+    size_t lazyLength = lazy->end() - lazy->begin();
+    UncompressedSourceCache::AutoHoldEntry holder;
+    ScriptSource::PinnedChars chars(cx, lazy->scriptSource(), holder,
+                                    lazy->begin(), lazyLength);
+    if (!chars.get())
+        return false;
+
+    if (!frontend::CompileLazyFunction(cx, lazy, chars.get(), lazyLength)) {
+        // The frontend may have linked the function and the non-lazy
+        // script together during bytecode compilation. Reset it now on
+        // error.
+        fun->initLazyScript(lazy);
+        if (lazy->hasScript())
+            lazy->resetScript();
+        return false;
+    }
+
+    // Remember the compiled script on the lazy script itself, in case
+    // there are clones of the function still pointing to the lazy script.
+    if (!lazy->maybeScript())
+        lazy->initScript(fun->nonLazyScript());
+
+    return true;
+}
+
+void
+ParseTask::eagerlyDelazify(JSContext* cx, JSScript* script)
+{
+    if (!options.eagerDelazification || !script)
+        return;
+
+    size_t priorErrors = errors.length();
+
+    Rooted<FunctionVector> stack(cx, FunctionVector(cx));
+    RootedFunction fun(cx);
+
+    bool ok = PushLazyInnerFunctions(script, &stack);
+    while (ok && !stack.empty()) {
+        fun = stack.popCopy();
+        ok = DelazifyInnerFunction(cx, fun);
+        if (ok) {
+            // Visit nested functions before later siblings so that the
+            // overall compilation order stays the source order.
+            ok = PushLazyInnerFunctions(fun->nonLazyScript(), &stack);
+        }
+    }
+
+    if (!ok) {
+        // Leaving functions lazy is always valid, so discard anything the
+        // failed compilation reported. The syntax parser already validated
+        // the inner functions during the top level parse, so failures here
+        // are resource exhaustion, not errors the caller must hear about.
+        while (errors.length() > priorErrors) {
+            js_delete(errors.back());
+            errors.popBack();
+        }
+        overRecursed = false;
+        outOfMemory = false;
+    }
+}
+
 ScriptParseTask::ScriptParseTask(JSContext* cx, JSObject* parseGlobal,
                                  const char16_t* chars, size_t length,
                                  JS::OffThreadCompileCallback callback, void* callbackData)
@@ -509,6 +610,8 @@ ScriptParseTask::parse(JSContext* cx)
         scripts.infallibleAppend(script);
     if (sourceObject)
         sourceObjects.infallibleAppend(sourceObject);
+
+    eagerlyDelazify(cx, script);
 }
 
 ModuleParseTask::ModuleParseTask(JSContext* cx, JSObject* parseGlobal,
@@ -531,6 +634,8 @@ ModuleParseTask::parse(JSContext* cx)
         scripts.infallibleAppend(module->script());
         if (sourceObject)
             sourceObjects.infallibleAppend(sourceObject);
+
+        eagerlyDelazify(cx, module->script());
     }
 }
 
@@ -1160,7 +1265,11 @@ GlobalHelperThreadState::maxIonCompilationThreads() const
 {
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_ION))
         return 1;
-    return threadCount;
+
+    // Ion compilation is speculative tier-up work, so don't let it spill
+    // onto the excess threads, which exist to keep work the active thread
+    // is blocked on from queueing behind long-running compilations.
+    return cpuCount;
 }
 
 size_t
@@ -2229,19 +2338,27 @@ HelperThread::threadLoop()
             // lists).  Unlocking the HelperThreadState between task selection
             // and execution is not well-defined.
 
+            // GC tasks are ranked above everything else because the active
+            // thread may be paused waiting for them. Next come the tasks
+            // that content is typically blocked on during page load: script
+            // parses, tier-1 wasm compiles and promise tasks (which may
+            // themselves be wasm compilations). Speculative work -- Ion
+            // tier-up and tier-2 wasm -- ranks below those, so that a burst
+            // of it cannot starve a parse the page cannot proceed without.
+
             if (HelperThreadState().canStartGCParallelTask(lock)) {
                 task = js::THREAD_TYPE_GCPARALLEL;
             } else if (HelperThreadState().canStartGCHelperTask(lock)) {
                 task = js::THREAD_TYPE_GCHELPER;
-            } else if (HelperThreadState().canStartIonCompile(lock)) {
-                task = js::THREAD_TYPE_ION;
+            } else if (HelperThreadState().canStartParseTask(lock)) {
+                task = js::THREAD_TYPE_PARSE;
             } else if (HelperThreadState().canStartWasmCompile(lock, wasm::CompileMode::Tier1)) {
                 task = js::THREAD_TYPE_WASM;
                 tier = wasm::CompileMode::Tier1;
             } else if (HelperThreadState().canStartPromiseHelperTask(lock)) {
                 task = js::THREAD_TYPE_PROMISE_TASK;
-            } else if (HelperThreadState().canStartParseTask(lock)) {
-                task = js::THREAD_TYPE_PARSE;
+            } else if (HelperThreadState().canStartIonCompile(lock)) {
+                task = js::THREAD_TYPE_ION;
             } else if (HelperThreadState().canStartCompressionTask(lock)) {
                 task = js::THREAD_TYPE_COMPRESS;
             } else if (HelperThreadState().canStartIonFreeTask(lock)) {
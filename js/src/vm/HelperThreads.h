@@ -677,6 +677,13 @@ struct ParseTask
     virtual void parse(JSContext* cx) = 0;
     bool finish(JSContext* cx);
 
+    // If the compile options request eager delazification, compile the lazy
+    // inner functions of |script| in source order while still on the helper
+    // thread. Failure is not fatal: remaining functions are left lazy and any
+    // error state produced here is rolled back so it cannot taint the
+    // successfully parsed top level script.
+    void eagerlyDelazify(JSContext* cx, JSScript* script);
+
     bool runtimeMatches(JSRuntime* rt) {
         return parseGlobal->runtimeFromAnyThread() == rt;
     }
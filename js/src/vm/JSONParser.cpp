@@ -11,6 +11,7 @@
 #include "mozilla/Sprintf.h"
 
 #include <ctype.h>
+#include <string.h>
 
 #include "jsarray.h"
 #include "jscompartment.h"
@@ -106,6 +107,67 @@ JSONParserBase::errorReturn()
     return errorHandling == NoError;
 }
 
+namespace {
+
+/* Bit patterns replicating a value into each CharT-sized lane of a uint64_t. */
+template <size_t CharSize> struct StringScanLanes;
+
+template <> struct StringScanLanes<1> {
+    static const uint64_t Ones = 0x0101010101010101ULL;
+    static const uint64_t HighBits = 0x8080808080808080ULL;
+};
+
+template <> struct StringScanLanes<2> {
+    static const uint64_t Ones = 0x0001000100010001ULL;
+    static const uint64_t HighBits = 0x8000800080008000ULL;
+};
+
+} // namespace
+
+/*
+ * Advance |current| to the next character which cannot appear plain inside a
+ * JSON string literal -- the closing '"', a '\\' starting an escape or a
+ * control character -- or to |end| if the rest of the input is plain. The
+ * bulk of the input is scanned a 64-bit word at a time, testing every lane
+ * for the three interesting character classes with branchless carry tricks,
+ * which is much cheaper than three comparisons per character when skipping
+ * over long string bodies.
+ */
+template <typename CharT>
+static MOZ_ALWAYS_INLINE void
+SkipPlainStringChars(RangedPtr<const CharT>& current, RangedPtr<const CharT> end)
+{
+    typedef StringScanLanes<sizeof(CharT)> Lanes;
+    const uint64_t ones = Lanes::Ones;
+    const uint64_t high = Lanes::HighBits;
+    const size_t charsPerWord = sizeof(uint64_t) / sizeof(CharT);
+
+    while (size_t(end - current) >= charsPerWord) {
+        uint64_t word;
+        memcpy(&word, current.get(), sizeof(word));
+
+        /*
+         * A lane equals |c| iff (word ^ splat(c)) has a zero lane, and a zero
+         * lane is detected with the usual borrow trick; likewise a lane is a
+         * control character iff it is unsigned-less-than 0x20. Cross-lane
+         * borrows only occur when some lane already matched, so the combined
+         * mask is exact as a "stop here" signal.
+         */
+        uint64_t quote = word ^ (ones * CharT('"'));
+        uint64_t slash = word ^ (ones * CharT('\\'));
+        uint64_t interesting = ((quote - ones) & ~quote) |
+                               ((slash - ones) & ~slash) |
+                               ((word - ones * 0x20) & ~word);
+        if (interesting & high)
+            break;
+
+        current += charsPerWord;
+    }
+
+    while (current < end && *current != '"' && *current != '\\' && *current > 0x001F)
+        current++;
+}
+
 template <typename CharT>
 template <JSONParserBase::StringType ST>
 JSONParserBase::Token
@@ -129,7 +191,8 @@ JSONParser<CharT>::readString()
      * string directly from the source text.
      */
     CharPtr start = current;
-    for (; current < end; current++) {
+    SkipPlainStringChars(current, end);
+    if (current < end) {
         if (*current == '"') {
             size_t length = current - start;
             current++;
@@ -141,10 +204,7 @@ JSONParser<CharT>::readString()
             return stringToken(str);
         }
 
-        if (*current == '\\')
-            break;
-
-        if (*current <= 0x001F) {
+        if (*current != '\\') {
             error("bad control character in string literal");
             return token(Error);
         }
@@ -231,10 +291,7 @@ JSONParser<CharT>::readString()
             return token(OOM);
 
         start = current;
-        for (; current < end; current++) {
-            if (*current == '"' || *current == '\\' || *current <= 0x001F)
-                break;
-        }
+        SkipPlainStringChars(current, end);
     } while (current < end);
 
     error("unterminated string");
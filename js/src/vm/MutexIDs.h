@@ -45,6 +45,8 @@
   _(OffThreadPromiseState,       500) \
   _(WasmModuleTieringLock,       500) \
   _(WasmCompileTaskState,        500) \
+  _(ArrayBufferLargeContentsPool, 500) \
+  _(RegExpBytecodeCache,         500) \
                                       \
   _(TraceLoggerGraphState,       600) \
   _(VTuneLock,                   600)
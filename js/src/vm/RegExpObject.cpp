@@ -8,6 +8,7 @@
 
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/PodOperations.h"
+#include "mozilla/Unused.h"
 
 #include "jshashutil.h"
 #include "jsstr.h"
@@ -21,7 +22,12 @@
 #include "irregexp/RegExpBytecode.h"
 #endif
 #include "irregexp/RegExpParser.h"
+#include "jit/ProcessExecutableMemory.h"
+#include "js/UniquePtr.h"
+#include "threading/LockGuard.h"
+#include "threading/Mutex.h"
 #include "vm/MatchPairs.h"
+#include "vm/MutexIDs.h"
 #include "vm/RegExpStatics.h"
 #include "vm/StringBuffer.h"
 #include "vm/TraceLogging.h"
@@ -933,10 +939,163 @@ js::StringHasRegExpMetaChars(JSLinearString* str)
     return HasRegExpMetaChars(str->twoByteChars(nogc), str->length());
 }
 
+/*
+ * A process-wide cache of irregexp bytecode, keyed by pattern, flags,
+ * compilation mode and input character width. Identical patterns are
+ * routinely compiled over and over by different zones (the same validation
+ * regexps in dozens of same-origin iframes, say). Jitcode cannot be shared
+ * between them because it is tied to its zone, but irregexp bytecode is
+ * position independent, so compiling a pattern once and handing out copies of
+ * the bytes is safe.
+ */
+class RegExpBytecodeCache
+{
+    static const size_t MaxEntries = 512;
+    static const size_t MaxByteCodeLength = 32 * 1024;
+
+    struct Entry
+    {
+        JS::UniqueTwoByteChars pattern;
+        size_t patternLength;
+        RegExpFlag flags;
+        RegExpShared::CompilationMode mode;
+        bool latin1;
+        size_t parenCount;
+        UniquePtr<uint8_t[], JS::FreePolicy> byteCode;
+        size_t byteCodeLength;
+    };
+
+    struct Lookup
+    {
+        JSAtom* pattern;
+        RegExpFlag flags;
+        RegExpShared::CompilationMode mode;
+        bool latin1;
+
+        Lookup(JSAtom* pattern, RegExpFlag flags, RegExpShared::CompilationMode mode, bool latin1)
+          : pattern(pattern), flags(flags), mode(mode), latin1(latin1)
+        {}
+    };
+
+    struct Hasher
+    {
+        using Lookup = RegExpBytecodeCache::Lookup;
+
+        static HashNumber hash(const Lookup& l) {
+            // Hash the pattern by code unit so that latin1 and two-byte atoms
+            // spelling the same pattern hash alike.
+            AutoCheckCannotGC nogc;
+            HashNumber h = 0;
+            if (l.pattern->hasLatin1Chars()) {
+                const Latin1Char* chars = l.pattern->latin1Chars(nogc);
+                for (size_t i = 0; i < l.pattern->length(); i++)
+                    h = mozilla::AddToHash(h, chars[i]);
+            } else {
+                const char16_t* chars = l.pattern->twoByteChars(nogc);
+                for (size_t i = 0; i < l.pattern->length(); i++)
+                    h = mozilla::AddToHash(h, chars[i]);
+            }
+            return mozilla::AddToHash(h, l.flags, unsigned(l.mode), l.latin1);
+        }
+        static bool match(const UniquePtr<Entry>& e, const Lookup& l) {
+            if (e->flags != l.flags || e->mode != l.mode || e->latin1 != l.latin1 ||
+                e->patternLength != l.pattern->length())
+            {
+                return false;
+            }
+            AutoCheckCannotGC nogc;
+            if (l.pattern->hasLatin1Chars())
+                return EqualChars(l.pattern->latin1Chars(nogc), e->pattern.get(), e->patternLength);
+            return EqualChars(l.pattern->twoByteChars(nogc), e->pattern.get(), e->patternLength);
+        }
+    };
+
+    using Set = HashSet<UniquePtr<Entry>, Hasher, SystemAllocPolicy>;
+
+    Mutex lock_;
+    Set set_;
+
+  public:
+    RegExpBytecodeCache()
+      : lock_(mutexid::RegExpBytecodeCache)
+    {}
+
+    // On a hit, return a fresh copy of the cached bytecode (owned by the
+    // caller) and fill in *parenCount. Returns nullptr on a miss, or if no
+    // memory is available for the copy.
+    uint8_t* lookup(JSAtom* pattern, RegExpFlag flags, RegExpShared::CompilationMode mode,
+                    bool latin1, size_t* parenCount)
+    {
+        LockGuard<Mutex> guard(lock_);
+        if (!set_.initialized())
+            return nullptr;
+        Set::Ptr p = set_.lookup(Lookup(pattern, flags, mode, latin1));
+        if (!p)
+            return nullptr;
+
+        const UniquePtr<Entry>& entry = *p;
+        uint8_t* copy = js_pod_malloc<uint8_t>(entry->byteCodeLength);
+        if (!copy)
+            return nullptr;
+        memcpy(copy, entry->byteCode.get(), entry->byteCodeLength);
+        *parenCount = entry->parenCount;
+        return copy;
+    }
+
+    // Add a compiled pattern to the cache. Best effort: on OOM, or once the
+    // cache fills up, the bytecode simply stays per-zone.
+    void add(JSAtom* pattern, RegExpFlag flags, RegExpShared::CompilationMode mode, bool latin1,
+             size_t parenCount, const uint8_t* byteCode, size_t byteCodeLength)
+    {
+        if (byteCodeLength > MaxByteCodeLength)
+            return;
+
+        JS::UniqueTwoByteChars patternCopy(js_pod_malloc<char16_t>(pattern->length()));
+        if (!patternCopy)
+            return;
+        {
+            AutoCheckCannotGC nogc;
+            if (pattern->hasLatin1Chars())
+                CopyAndInflateChars(patternCopy.get(), pattern->latin1Chars(nogc), pattern->length());
+            else
+                PodCopy(patternCopy.get(), pattern->twoByteChars(nogc), pattern->length());
+        }
+
+        UniquePtr<uint8_t[], JS::FreePolicy> byteCodeCopy(js_pod_malloc<uint8_t>(byteCodeLength));
+        if (!byteCodeCopy)
+            return;
+        memcpy(byteCodeCopy.get(), byteCode, byteCodeLength);
+
+        auto entry = MakeUnique<Entry>();
+        if (!entry)
+            return;
+        entry->pattern = Move(patternCopy);
+        entry->patternLength = pattern->length();
+        entry->flags = flags;
+        entry->mode = mode;
+        entry->latin1 = latin1;
+        entry->parenCount = parenCount;
+        entry->byteCode = Move(byteCodeCopy);
+        entry->byteCodeLength = byteCodeLength;
+
+        LockGuard<Mutex> guard(lock_);
+        if (!set_.initialized() && !set_.init(64))
+            return;
+        if (set_.count() >= MaxEntries)
+            return;
+        Set::AddPtr p = set_.lookupForAdd(Lookup(pattern, flags, mode, latin1));
+        if (p)
+            return;
+        mozilla::Unused << set_.add(p, Move(entry));
+    }
+};
+
+static RegExpBytecodeCache regExpBytecodeCache;
+
 /* RegExpShared */
 
 RegExpShared::RegExpShared(JSAtom* source, RegExpFlag flags)
-  : source(source), flags(flags), canStringMatch(false), parenCount(0)
+  : source(source), flags(flags), canStringMatch(false), parenCount(0), warmUpCount(0)
 {}
 
 void
@@ -987,6 +1146,19 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
     if (!re->ignoreCase() && !StringHasRegExpMetaChars(pattern))
         re->canStringMatch = true;
 
+    // When only bytecode is wanted, check the process-wide cache first:
+    // another zone may well have compiled this pattern already.
+    if (force == ForceByteCode) {
+        size_t parenCount;
+        if (uint8_t* byteCode = regExpBytecodeCache.lookup(pattern, re->getFlags(), mode,
+                                                           input->hasLatin1Chars(), &parenCount))
+        {
+            re->parenCount = parenCount;
+            re->compilation(mode, input->hasLatin1Chars()).byteCode = byteCode;
+            return true;
+        }
+    }
+
     CompileOptions options(cx);
     frontend::TokenStream dummyTokenStream(cx, options, nullptr, 0, nullptr);
 
@@ -1032,7 +1204,14 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
         compilation.jitCode = code.jitCode;
     } else if (code.byteCode) {
         MOZ_ASSERT(tables.empty(), "RegExpInterpreter does not use data tables");
-        compilation.byteCode = code.byteCode;
+        if (compilation.byteCode) {
+            // A jit tier-up attempt fell back to bytecode we already have.
+            js_free(code.byteCode);
+        } else {
+            compilation.byteCode = code.byteCode;
+            regExpBytecodeCache.add(pattern, re->getFlags(), mode, input->hasLatin1Chars(),
+                                    re->parenCount, code.byteCode, code.byteCodeLength);
+        }
     }
 
     return true;
@@ -1048,6 +1227,25 @@ RegExpShared::compileIfNecessary(JSContext* cx, MutableHandleRegExpShared re,
     return compile(cx, re, input, mode, force);
 }
 
+// Number of times a regexp must run before jitcode is generated for it, so
+// that one-shot patterns never pay for codegen. This matches the baseline
+// compiler's warm-up threshold for scripts.
+static const uint32_t RegExpTierUpThreshold = 10;
+
+// Keep these conditions in sync with the assembler selection in
+// irregexp::CompilePattern.
+static bool
+RegExpJitCompilationAvailable(JSContext* cx, HandleRegExpShared re)
+{
+#ifdef JS_CODEGEN_NONE
+    return false;
+#else
+    return cx->options().nativeRegExp() &&
+           jit::CanLikelyAllocateMoreExecutableMemory() &&
+           re->getSource()->length() < 32 * 1024;
+#endif
+}
+
 /* static */ RegExpRunStatus
 RegExpShared::execute(JSContext* cx, MutableHandleRegExpShared re, HandleLinearString input,
                       size_t start, MatchPairs* matches, size_t* endIndex)
@@ -1058,9 +1256,22 @@ RegExpShared::execute(JSContext* cx, MutableHandleRegExpShared re, HandleLinearS
 
     CompilationMode mode = matches ? Normal : MatchOnly;
 
-    /* Compile the code at point-of-use. */
-    if (!compileIfNecessary(cx, re, input, mode, DontForceByteCode))
-        return RegExpRunStatus_Error;
+    /*
+     * Compile the code at point-of-use. A new regexp starts out in bytecode,
+     * which is cheap to produce (and may simply be copied out of the
+     * process-wide bytecode cache); jitcode is only generated once the regexp
+     * has run often enough to suggest the translation will pay for itself.
+     */
+    re->incWarmUpCount();
+    if (re->getWarmUpCount() <= RegExpTierUpThreshold ||
+        !RegExpJitCompilationAvailable(cx, re))
+    {
+        if (!compileIfNecessary(cx, re, input, mode, ForceByteCode))
+            return RegExpRunStatus_Error;
+    } else if (!re->compilation(mode, input->hasLatin1Chars()).jitCode) {
+        if (!compile(cx, re, input, mode, DontForceByteCode))
+            return RegExpRunStatus_Error;
+    }
 
     /*
      * Ensure sufficient memory for output vector.
@@ -121,6 +121,7 @@ class RegExpShared : public gc::TenuredCell
     RegExpFlag         flags;
     bool               canStringMatch;
     size_t             parenCount;
+    uint32_t           warmUpCount;
 
     RegExpCompilation  compilationArray[4];
 
@@ -181,6 +182,14 @@ class RegExpShared : public gc::TenuredCell
 
     JSAtom* getSource() const           { return source; }
     RegExpFlag getFlags() const         { return flags; }
+
+    // Number of times this regexp has been executed, used to decide when it
+    // is worth tiering up from bytecode to jitcode.
+    uint32_t getWarmUpCount() const     { return warmUpCount; }
+    void incWarmUpCount() {
+        if (warmUpCount != UINT32_MAX)
+            warmUpCount++;
+    }
     bool ignoreCase() const             { return flags & IgnoreCaseFlag; }
     bool global() const                 { return flags & GlobalFlag; }
     bool multiline() const              { return flags & MultilineFlag; }
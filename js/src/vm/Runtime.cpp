@@ -185,6 +185,7 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
     /* Initialize infallibly first, so we can goto bad and JS_DestroyRuntime. */
 
     PodZero(&asmJSCacheOps);
+    PodZero(&wasmCacheOps);
     lcovOutput().init();
 }
 
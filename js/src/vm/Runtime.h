@@ -545,6 +545,9 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
     /* AsmJSCache callbacks are runtime-wide. */
     js::UnprotectedData<JS::AsmJSCacheOps> asmJSCacheOps;
 
+    /* Wasm compiled-module cache callbacks are runtime-wide. */
+    js::UnprotectedData<JS::WasmCacheOps> wasmCacheOps;
+
   private:
     js::UnprotectedData<const JSPrincipals*> trustedPrincipals_;
   public:
@@ -703,7 +706,9 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
         return selfHostingGlobal_;
     }
 
-    bool initSelfHosting(JSContext* cx);
+    bool initSelfHosting(JSContext* cx,
+                         const mozilla::Range<uint8_t>& xdrCache = mozilla::Range<uint8_t>(),
+                         JS::SelfHostedWriter xdrWriter = nullptr);
     void finishSelfHosting();
     void traceSelfHostingGlobal(JSTracer* trc);
     bool isSelfHostingGlobal(JSObject* global) {
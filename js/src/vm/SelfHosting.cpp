@@ -2855,7 +2855,8 @@ VerifyGlobalNames(JSContext* cx, Handle<GlobalObject*> shg)
 }
 
 bool
-JSRuntime::initSelfHosting(JSContext* cx)
+JSRuntime::initSelfHosting(JSContext* cx, const mozilla::Range<uint8_t>& xdrCache,
+                           JS::SelfHostedWriter xdrWriter)
 {
     MOZ_ASSERT(!selfHostingGlobal_);
 
@@ -2889,20 +2890,54 @@ JSRuntime::initSelfHosting(JSContext* cx)
     CompileOptions options(cx);
     FillSelfHostingCompileOptions(options);
 
-    RootedValue rv(cx);
+    RootedScript script(cx);
 
-    uint32_t srcLen = GetRawScriptsSize();
+    /*
+     * Try to decode a cached XDR image of the self-hosted code first:
+     * decoding is substantially cheaper than compiling. The XDR machinery
+     * rejects images produced by a different build, in which case we fall
+     * back to compiling from source below.
+     */
+    if (xdrCache.length() > 0) {
+        JS::TranscodeResult result = JS::DecodeScript(cx, xdrCache, &script);
+        if (result == JS::TranscodeResult_Throw)
+            return false;
+        if (result != JS::TranscodeResult_Ok)
+            script = nullptr;
+    }
 
-    const unsigned char* compressed = compressedSources;
-    uint32_t compressedLen = GetCompressedSize();
-    ScopedJSFreePtr<char> src(selfHostingGlobal_->zone()->pod_malloc<char>(srcLen));
-    if (!src || !DecompressString(compressed, compressedLen,
-                                  reinterpret_cast<unsigned char*>(src.get()), srcLen))
-    {
-        return false;
+    if (!script) {
+        uint32_t srcLen = GetRawScriptsSize();
+
+        const unsigned char* compressed = compressedSources;
+        uint32_t compressedLen = GetCompressedSize();
+        ScopedJSFreePtr<char> src(selfHostingGlobal_->zone()->pod_malloc<char>(srcLen));
+        if (!src || !DecompressString(compressed, compressedLen,
+                                      reinterpret_cast<unsigned char*>(src.get()), srcLen))
+        {
+            return false;
+        }
+
+        if (!Compile(cx, options, src, srcLen, &script))
+            return false;
+
+        /*
+         * Give the embedding a chance to cache an XDR image of the fresh
+         * compilation, so that future processes of the same build can skip
+         * the compile entirely.
+         */
+        if (xdrWriter) {
+            JS::TranscodeBuffer buffer;
+            JS::TranscodeResult result = JS::EncodeScript(cx, buffer, script);
+            if (result == JS::TranscodeResult_Throw)
+                return false;
+            if (result == JS::TranscodeResult_Ok && !xdrWriter(cx, buffer))
+                return false;
+        }
     }
 
-    if (!Evaluate(cx, options, src, srcLen, &rv))
+    RootedValue rv(cx);
+    if (!JS_ExecuteScript(cx, script, &rv))
         return false;
 
     if (!VerifyGlobalNames(cx, shg))
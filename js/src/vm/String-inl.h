@@ -126,7 +126,7 @@ JSRope::new_(JSContext* cx,
 {
     if (!validateLength(cx, length))
         return nullptr;
-    JSRope* str = static_cast<JSRope*>(js::Allocate<JSString, allowGC>(cx));
+    JSRope* str = static_cast<JSRope*>(js::AllocateString<JSString, allowGC>(cx, js::gc::DefaultHeap));
     if (!str)
         return nullptr;
     str->init(cx, left, right, length);
@@ -186,7 +186,8 @@ JSDependentString::new_(JSContext* cx, JSLinearString* baseArg, size_t start,
     if (baseArg->isExternal() && !baseArg->ensureFlat(cx))
         return nullptr;
 
-    JSDependentString* str = static_cast<JSDependentString*>(js::Allocate<JSString, js::NoGC>(cx));
+    JSDependentString* str =
+        static_cast<JSDependentString*>(js::AllocateString<JSString, js::NoGC>(cx, js::gc::DefaultHeap));
     if (str) {
         str->init(cx, baseArg, start, length);
         return str;
@@ -194,7 +195,7 @@ JSDependentString::new_(JSContext* cx, JSLinearString* baseArg, size_t start,
 
     js::RootedLinearString base(cx, baseArg);
 
-    str = static_cast<JSDependentString*>(js::Allocate<JSString>(cx));
+    str = static_cast<JSDependentString*>(js::AllocateString<JSString>(cx, js::gc::DefaultHeap));
     if (!str)
         return nullptr;
     str->init(cx, base, start, length);
@@ -230,7 +231,7 @@ JSFlatString::new_(JSContext* cx, const CharT* chars, size_t length)
     if (cx->compartment()->isAtomsCompartment())
         str = js::Allocate<js::NormalAtom, allowGC>(cx);
     else
-        str = static_cast<JSFlatString*>(js::Allocate<JSString, allowGC>(cx));
+        str = static_cast<JSFlatString*>(js::AllocateString<JSString, allowGC>(cx, js::gc::DefaultHeap));
     if (!str)
         return nullptr;
 
@@ -260,7 +261,7 @@ JSThinInlineString::new_(JSContext* cx)
     if (cx->compartment()->isAtomsCompartment())
         return (JSThinInlineString*)(js::Allocate<js::NormalAtom, allowGC>(cx));
 
-    return static_cast<JSThinInlineString*>(js::Allocate<JSString, allowGC>(cx));
+    return static_cast<JSThinInlineString*>(js::AllocateString<JSString, allowGC>(cx, js::gc::DefaultHeap));
 }
 
 template <js::AllowGC allowGC>
@@ -270,7 +271,7 @@ JSFatInlineString::new_(JSContext* cx)
     if (cx->compartment()->isAtomsCompartment())
         return (JSFatInlineString*)(js::Allocate<js::FatInlineAtom, allowGC>(cx));
 
-    return js::Allocate<JSFatInlineString, allowGC>(cx);
+    return js::AllocateString<JSFatInlineString, allowGC>(cx, js::gc::DefaultHeap);
 }
 
 template<>
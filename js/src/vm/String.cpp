@@ -375,12 +375,7 @@ CopyChars(Latin1Char* dest, const JSLinearString& str)
          * the chars are stored as TwoByte, we know they must be in the Latin1
          * range, so we can safely deflate here.
          */
-        size_t len = str.length();
-        const char16_t* chars = str.twoByteChars(nogc);
-        for (size_t i = 0; i < len; i++) {
-            MOZ_ASSERT(chars[i] <= JSString::MAX_LATIN1_CHAR);
-            dest[i] = chars[i];
-        }
+        CopyAndDeflateChars(dest, str.twoByteChars(nogc), str.length());
     }
 }
 
@@ -1642,23 +1642,46 @@ JSStructuredCloneWriter::transferOwnership()
             }
 
             if (scope == JS::StructuredCloneScope::DifferentProcess) {
-                // Write Transferred ArrayBuffers in DifferentProcess scope at
-                // the end of the clone buffer, and store the offset within the
-                // buffer to where the ArrayBuffer was written. Note that this
-                // will invalidate the current position iterator.
-
-                size_t pointOffset = out.offset(point);
-                tag = SCTAG_TRANSFER_MAP_STORED_ARRAY_BUFFER;
-                ownership = JS::SCTAG_TMO_UNOWNED;
-                content = nullptr;
-                extraData = out.tell() - pointOffset; // Offset from tag to current end of buffer
-                if (!writeArrayBuffer(arrayBuffer))
-                    return false;
+                // Let the application transfer the contents out of band, e.g.
+                // as a shared memory handle, rather than copying them into
+                // the clone buffer. The hook declines by leaving the tag
+                // untouched.
+                bool handled = false;
+                if (callbacks && callbacks->writeArrayBufferTransfer) {
+                    RootedObject bufferObj(cx, arrayBuffer);
+                    tag = 0;
+                    if (!callbacks->writeArrayBufferTransfer(cx, bufferObj, closure,
+                                                             &tag, &ownership, &content,
+                                                             &extraData))
+                    {
+                        return false;
+                    }
+                    if (tag) {
+                        MOZ_ASSERT(tag > SCTAG_TRANSFER_MAP_PENDING_ENTRY);
+                        handled = true;
+                    }
+                }
+
+                if (!handled) {
+                    // Write Transferred ArrayBuffers in DifferentProcess scope
+                    // at the end of the clone buffer, and store the offset
+                    // within the buffer to where the ArrayBuffer was written.
+                    // Note that this will invalidate the current position
+                    // iterator.
+
+                    size_t pointOffset = out.offset(point);
+                    tag = SCTAG_TRANSFER_MAP_STORED_ARRAY_BUFFER;
+                    ownership = JS::SCTAG_TMO_UNOWNED;
+                    content = nullptr;
+                    extraData = out.tell() - pointOffset; // Offset from tag to current end of buffer
+                    if (!writeArrayBuffer(arrayBuffer))
+                        return false;
 
-                // Must refresh the point iterator after its collection has
-                // been modified.
-                point = out.iter();
-                point += pointOffset;
+                    // Must refresh the point iterator after its collection has
+                    // been modified.
+                    point = out.iter();
+                    point += pointOffset;
+                }
 
                 if (!JS_DetachArrayBuffer(cx, arrayBuffer))
                     return false;
@@ -315,6 +315,10 @@ enum class Op
     I64Extend32S                         = 0xc4,
 #endif
 
+    // The SIMD proposal encodes its operators behind this prefix. We decode
+    // the two-byte form so that such modules fail validation with a precise
+    // "unrecognized opcode" error rather than desynchronizing the decoder.
+    SimdPrefix                           = 0xfd,
     AtomicPrefix                         = 0xfe,
     MozPrefix                            = 0xff,
 
@@ -324,7 +328,7 @@ enum class Op
 inline bool
 IsPrefixByte(uint8_t b)
 {
-    return b >= uint8_t(Op::AtomicPrefix);
+    return b >= uint8_t(Op::SimdPrefix);
 }
 
 enum class MozOp
@@ -97,9 +97,74 @@ CompileArgs::initFromContext(JSContext* cx, ScriptedCaller&& scriptedCaller)
     debugEnabled = cx->compartment()->debuggerObservesAsmJS();
 
     this->scriptedCaller = Move(scriptedCaller);
+    cacheOps = &cx->wasmCacheOps();
     return assumptions.initBuildIdFromContext(cx);
 }
 
+// Look up the module's bytecode in the embedding's compiled-module cache. The
+// cached machine code starts with the serialized Assumptions of the build that
+// wrote it, so a cpu or build mismatch is simply a miss. Debugged code is
+// never cached (see Module::compiledSerializedSize), so a compilation that
+// needs debug support must not consult the cache.
+
+static SharedModule
+LookupModuleInCache(const ShareableBytes& bytecode, const CompileArgs& args)
+{
+    const JS::WasmCacheOps* ops = args.cacheOps;
+    if (!ops || !ops->openEntryForRead)
+        return nullptr;
+
+    if (args.debugEnabled)
+        return nullptr;
+
+    size_t serializedSize;
+    const uint8_t* memory;
+    intptr_t handle;
+    if (!ops->openEntryForRead(bytecode.begin(), bytecode.end(), &serializedSize, &memory,
+                               &handle))
+    {
+        return nullptr;
+    }
+
+    SharedModule module;
+    if (Module::assumptionsMatch(args.assumptions, memory, serializedSize))
+        module = Module::deserialize(bytecode.begin(), bytecode.length(), memory, serializedSize);
+
+    ops->closeEntryForRead(serializedSize, memory, handle);
+    return module;
+}
+
+// Store a fully-compiled module in the embedding's cache. Failure to store is
+// not an error, just a missed opportunity for the next compilation. May be
+// called from a helper thread after tier-2 compilation finishes.
+
+static void
+StoreModuleInCache(const Module& module, const CompileArgs& args)
+{
+    const JS::WasmCacheOps* ops = args.cacheOps;
+    if (!ops || !ops->openEntryForWrite)
+        return;
+
+    MOZ_ASSERT(module.compilationComplete());
+
+    size_t serializedSize = module.compiledSerializedSize();
+    if (!serializedSize)
+        return;
+
+    const ShareableBytes& bytecode = module.bytecode();
+
+    uint8_t* memory;
+    intptr_t handle;
+    if (!ops->openEntryForWrite(bytecode.begin(), bytecode.end(), serializedSize, &memory,
+                                &handle))
+    {
+        return;
+    }
+
+    module.compiledSerialize(memory, serializedSize);
+    ops->closeEntryForWrite(serializedSize, memory, handle);
+}
+
 // Classify the current system as one of a set of recognizable classes.  This
 // really needs to get our tier-1 systems right.
 //
@@ -387,6 +452,9 @@ wasm::CompileInitialTier(const ShareableBytes& bytecode, const CompileArgs& args
 {
     MOZ_RELEASE_ASSERT(wasm::HaveSignalHandlers());
 
+    if (SharedModule module = LookupModuleInCache(bytecode, args))
+        return module;
+
     bool baselineEnabled = BaselineCanCompile() && args.baselineEnabled;
     bool debugEnabled = BaselineCanCompile() && args.debugEnabled;
     bool ionEnabled = args.ionEnabled || !baselineEnabled;
@@ -423,7 +491,14 @@ wasm::CompileInitialTier(const ShareableBytes& bytecode, const CompileArgs& args
     if (!DecodeModuleTail(d, &env))
         return nullptr;
 
-    return mg.finishModule(bytecode);
+    SharedModule module = mg.finishModule(bytecode);
+
+    // A tiered compilation is cached when tier 2 finishes, below. A module
+    // compiled directly with Ion is already as good as it will get.
+    if (module && mode == CompileMode::Once && tier == Tier::Ion)
+        StoreModuleInCache(*module, args);
+
+    return module;
 }
 
 bool
@@ -448,5 +523,11 @@ wasm::CompileTier2(Module& module, const CompileArgs& args, Atomic<bool>* cancel
     if (!DecodeModuleTail(d, &env))
         return false;
 
-    return mg.finishTier2(module);
+    if (!mg.finishTier2(module))
+        return false;
+
+    // Now that the Ion code is committed, persist the module so the next
+    // compilation of these bytes skips both tiers entirely.
+    StoreModuleInCache(module, args);
+    return true;
 }
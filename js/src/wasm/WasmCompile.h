@@ -21,6 +21,10 @@
 
 #include "wasm/WasmModule.h"
 
+namespace JS {
+struct WasmCacheOps;
+} // namespace JS
+
 namespace js {
 namespace wasm {
 
@@ -43,12 +47,17 @@ struct CompileArgs : ShareableBase<CompileArgs>
     bool debugEnabled;
     bool ionEnabled;
 
+    // The embedding's compiled-module cache callbacks, if any. These are
+    // runtime-wide and outlive any compilation, so a raw pointer suffices.
+    const JS::WasmCacheOps* cacheOps;
+
     CompileArgs(Assumptions&& assumptions, ScriptedCaller&& scriptedCaller)
       : assumptions(Move(assumptions)),
         scriptedCaller(Move(scriptedCaller)),
         baselineEnabled(false),
         debugEnabled(false),
-        ionEnabled(false)
+        ionEnabled(false),
+        cacheOps(nullptr)
     {}
 
     // If CompileArgs is constructed without arguments, initFromContext() must
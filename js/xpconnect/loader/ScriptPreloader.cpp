@@ -850,6 +850,15 @@ ScriptPreloader::WaitForCachedScript(JSContext* cx, CachedScript* script)
 
             script->mReadyToExecute = true;
         } else {
+            // If the script is too large to decode on the main thread, but
+            // hasn't been included in a decode batch yet, move it to the
+            // front of the pending queue so that it's picked up by the next
+            // batch, rather than waiting for every batch queued ahead of it.
+            if (!script->mReadyToExecute && script->isInList()) {
+                script->remove();
+                mPendingScripts.insertFront(script);
+            }
+
             while (!script->mReadyToExecute) {
                 mal.Wait();
 
@@ -151,6 +151,7 @@
 #include "mozilla/layers/CompositorBridgeChild.h"
 #include "ClientLayerManager.h"
 #include "GeckoProfiler.h"
+#include "ProfilerCounters.h"
 #include "gfxPlatform.h"
 #include "Layers.h"
 #include "LayerTreeInvalidation.h"
@@ -6277,6 +6278,8 @@ PresShell::Paint(nsView*         aViewToPaint,
   nsCString uriString = uri ? uri->GetSpecOrDefault() : NS_LITERAL_CSTRING("N/A");
   AUTO_PROFILER_LABEL_DYNAMIC("PresShell::Paint", GRAPHICS, uriString.get());
 
+  PROFILER_COUNTER_ADD(ProfilerCounterID::Paints, 1);
+
   Maybe<js::AutoAssertNoContentJS> nojs;
 
   // On Android, Flash can call into content JS during painting, so we can't
@@ -9071,6 +9074,16 @@ PresShell::DoVerifyReflow()
 // used with Telemetry metrics
 #define NS_LONG_REFLOW_TIME_MS    5000
 
+static uint32_t
+FrameTreeDepth(nsIFrame* aFrame)
+{
+  uint32_t depth = 0;
+  for (nsIFrame* f = aFrame->GetParent(); f; f = f->GetParent()) {
+    ++depth;
+  }
+  return depth;
+}
+
 bool
 PresShell::ProcessReflowCommands(bool aInterruptible)
 {
@@ -9103,7 +9116,21 @@ PresShell::ProcessReflowCommands(bool aInterruptible)
 
       do {
         // Send an incremental reflow notification to the target frame.
-        int32_t idx = mDirtyRoots.Length() - 1;
+        // Pick the shallowest dirty root: reflowing an ancestor root
+        // cleans the dirty bits of any dirty roots nested inside it, so
+        // the NS_SUBTREE_DIRTY check below can skip them instead of
+        // reflowing the same subtree a second time. Pages made of many
+        // independent widgets routinely queue nested roots in arbitrary
+        // order.
+        uint32_t idx = mDirtyRoots.Length() - 1;
+        uint32_t shallowestDepth = FrameTreeDepth(mDirtyRoots[idx]);
+        for (uint32_t i = idx; i-- > 0; ) {
+          uint32_t depth = FrameTreeDepth(mDirtyRoots[i]);
+          if (depth < shallowestDepth) {
+            shallowestDepth = depth;
+            idx = i;
+          }
+        }
         nsIFrame *target = mDirtyRoots[idx];
         mDirtyRoots.RemoveElementAt(idx);
 
@@ -21,6 +21,7 @@
 #include "nsIDocumentViewerPrint.h"
 #include "mozilla/dom/BeforeUnloadEvent.h"
 #include "nsIDocument.h"
+#include "nsPresArena.h"
 #include "nsPresContext.h"
 #include "nsIPresShell.h"
 #include "mozilla/StyleSetHandle.h"
@@ -678,6 +679,10 @@ nsDocumentViewer::InitPresentationStuff(bool aDoInitialReflow)
   NS_ASSERTION(!mPresShell,
                "Someone should have destroyed the presshell!");
 
+  // Stock the shared pool of arena pages before the new pres shell starts
+  // constructing frames out of it.
+  nsPresArena::PrewarmPagePool();
+
   // Create the style set...
   StyleSetHandle styleSet = CreateStyleSet(mDocument);
 
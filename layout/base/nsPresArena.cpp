@@ -10,7 +10,11 @@
 #include "nsPresArena.h"
 
 #include "mozilla/Poison.h"
+#include "mozilla/Services.h"
+#include "nsCOMPtr.h"
 #include "nsDebug.h"
+#include "nsIObserver.h"
+#include "nsIObserverService.h"
 #include "nsPrintfCString.h"
 #include "GeckoStyleContext.h"
 #include "FrameLayerBuilder.h"
@@ -20,9 +24,149 @@
 #include "nsWindowSizes.h"
 
 #include <inttypes.h>
+#include <string.h>
 
 using namespace mozilla;
 
+// All pres shell arenas allocate pages of the same size, and whole sets of
+// pages are freed at once when a document's frame tree goes away.  Rather
+// than returning each page to the malloc heap only to fault it back in
+// moments later when the next document starts constructing frames, we keep
+// a small process-wide pool of free pages shared by every arena.
+namespace {
+
+// Free pages are linked through their first word while they sit in the pool.
+struct PagePoolEntry
+{
+  PagePoolEntry* mNext;
+};
+
+} // namespace
+
+// Must match the chunk size of nsPresArena::mPool.  Over-sized chunks for
+// large allocations bypass the pool entirely.
+static const size_t kPagePoolPageSize = 8192;
+
+// Upper bound on pooled memory: 32 pages is 256 KiB per process.
+static const size_t kPagePoolMaxPages = 32;
+
+// How far PrewarmPagePool() fills the pool.  Half the cap, so a pre-warm
+// doesn't crowd out pages recycled from a presentation being torn down.
+static const size_t kPagePoolPrewarmPages = 16;
+
+static PagePoolEntry* sPagePool = nullptr;
+static size_t sPagePoolCount = 0;
+
+// Set at xpcom-shutdown; afterwards pages go straight back to the heap so
+// arenas destroyed during shutdown don't leave pages behind in the pool.
+static bool sPagePoolClosed = false;
+
+static bool sPagePoolObserverRegistered = false;
+
+static void
+DrainPagePool()
+{
+  while (sPagePool) {
+    PagePoolEntry* page = sPagePool;
+    sPagePool = page->mNext;
+    free(page);
+  }
+  sPagePoolCount = 0;
+}
+
+namespace {
+
+class PagePoolObserver final : public nsIObserver
+{
+public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_NSIOBSERVER
+
+private:
+  ~PagePoolObserver() {}
+};
+
+NS_IMPL_ISUPPORTS(PagePoolObserver, nsIObserver)
+
+NS_IMETHODIMP
+PagePoolObserver::Observe(nsISupports* aSubject, const char* aTopic,
+                          const char16_t* aData)
+{
+  // Give the pages back on memory pressure; they'll be replenished as soon
+  // as a pres shell goes away.  At shutdown, close the pool for good.
+  if (!strcmp(aTopic, NS_XPCOM_SHUTDOWN_OBSERVER_ID)) {
+    sPagePoolClosed = true;
+  }
+  DrainPagePool();
+  return NS_OK;
+}
+
+} // namespace
+
+static void
+EnsurePagePoolObserver()
+{
+  if (sPagePoolObserverRegistered) {
+    return;
+  }
+  nsCOMPtr<nsIObserverService> obs = services::GetObserverService();
+  if (!obs) {
+    return;
+  }
+  nsCOMPtr<nsIObserver> observer = new PagePoolObserver();
+  obs->AddObserver(observer, "memory-pressure", false);
+  obs->AddObserver(observer, NS_XPCOM_SHUTDOWN_OBSERVER_ID, false);
+  sPagePoolObserverRegistered = true;
+}
+
+/* static */ void*
+nsPresArena::PagePoolPolicy::AllocateChunk(size_t aSize)
+{
+  if (aSize == kPagePoolPageSize && sPagePool) {
+    PagePoolEntry* page = sPagePool;
+    sPagePool = page->mNext;
+    sPagePoolCount--;
+    MOZ_MAKE_MEM_UNDEFINED(page, aSize);
+    return page;
+  }
+  return malloc(aSize);
+}
+
+/* static */ void
+nsPresArena::PagePoolPolicy::FreeChunk(void* aPtr, size_t aSize)
+{
+  if (aSize == kPagePoolPageSize && sPagePoolCount < kPagePoolMaxPages &&
+      !sPagePoolClosed) {
+    EnsurePagePoolObserver();
+    MOZ_MAKE_MEM_UNDEFINED(aPtr, aSize);
+    PagePoolEntry* page = static_cast<PagePoolEntry*>(aPtr);
+    page->mNext = sPagePool;
+    sPagePool = page;
+    sPagePoolCount++;
+    return;
+  }
+  free(aPtr);
+}
+
+/* static */ void
+nsPresArena::PrewarmPagePool()
+{
+  if (sPagePoolClosed) {
+    return;
+  }
+  EnsurePagePoolObserver();
+  while (sPagePoolCount < kPagePoolPrewarmPages) {
+    void* p = malloc(kPagePoolPageSize);
+    if (!p) {
+      break;
+    }
+    PagePoolEntry* page = static_cast<PagePoolEntry*>(p);
+    page->mNext = sPagePool;
+    sPagePool = page;
+    sPagePoolCount++;
+  }
+}
+
 nsPresArena::nsPresArena()
 {
 }
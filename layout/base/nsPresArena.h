@@ -100,6 +100,14 @@ public:
    */
   void AddSizeOfExcludingThis(nsWindowSizes& aWindowSizes) const;
 
+  /**
+   * Fill the process-wide pool of recycled arena pages ahead of time, so
+   * that the arenas of pres shells created shortly afterwards can draw on
+   * it instead of hitting the malloc heap during frame construction.
+   * Called when a new presentation is about to be set up.
+   */
+  static void PrewarmPagePool();
+
 private:
   void* Allocate(uint32_t aCode, size_t aSize);
   void Free(uint32_t aCode, void* aPtr);
@@ -124,8 +132,20 @@ private:
     { return mEntries.ShallowSizeOfExcludingThis(aMallocSizeOf); }
   };
 
+  /**
+   * Chunk allocation policy that routes standard-sized arena pages through
+   * a small process-wide pool shared by all pres shell arenas, so that
+   * pages freed when one document's frame tree is torn down can be reused
+   * by the next document's without going back to the malloc heap.
+   */
+  struct PagePoolPolicy
+  {
+    static void* AllocateChunk(size_t aSize);
+    static void FreeChunk(void* aPtr, size_t aSize);
+  };
+
   FreeList mFreeLists[mozilla::eArenaObjectID_COUNT];
-  mozilla::ArenaAllocator<8192, 8> mPool;
+  mozilla::ArenaAllocator<8192, 8, PagePoolPolicy> mPool;
   nsDataHashtable<nsPtrHashKey<void>, mozilla::ArenaObjectID> mArenaRefPtrs;
 };
 
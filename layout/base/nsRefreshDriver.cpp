@@ -1756,6 +1756,23 @@ struct RunnableWithDelay
 
 static AutoTArray<RunnableWithDelay, 8>* sPendingIdleRunnables = nullptr;
 
+// Budget, in milliseconds, that a tick may spend before the remaining
+// deferrable observer buckets are pushed to the next tick. 0 disables tick
+// budget scheduling.
+static int32_t sTickBudgetMillis = 0;
+static bool sTickBudgetPrefCached = false;
+
+#ifdef MOZ_GECKO_PROFILER
+// Static marker strings identifying which bucket overran the tick budget,
+// indexed like mObservers.
+static const char* const kTickDeferMarkers[] = {
+  "RefreshDriver budget: deferring event observers",
+  "RefreshDriver budget: deferring style observers",
+  "RefreshDriver budget: deferring layout observers",
+  "RefreshDriver budget: deferring display observers",
+};
+#endif
+
 void
 nsRefreshDriver::DispatchIdleRunnableAfterTick(nsIRunnable* aRunnable,
                                                uint32_t aDelay)
@@ -1788,6 +1805,50 @@ nsRefreshDriver::CancelIdleRunnable(nsIRunnable* aRunnable)
   }
 }
 
+bool
+nsRefreshDriver::ShouldDeferObserverBucket(uint32_t aObserverIndex) const
+{
+  if (sTickBudgetMillis <= 0) {
+    return false;
+  }
+
+  // Nothing to defer.
+  bool hasWork = !mObservers[aObserverIndex].IsEmpty();
+  if (aObserverIndex == 1) {
+    hasWork = hasWork || !mStyleFlushObservers.IsEmpty();
+  } else if (aObserverIndex == 2) {
+    hasWork = hasWork || !mLayoutFlushObservers.IsEmpty();
+  }
+  if (!hasWork) {
+    return false;
+  }
+
+  TimeDuration predicted =
+    (TimeStamp::Now() - mTickStart) + mObserverAverageTime[aObserverIndex];
+  if (predicted.ToMilliseconds() <= double(sTickBudgetMillis)) {
+    return false;
+  }
+
+#ifdef MOZ_GECKO_PROFILER
+  if (profiler_is_active()) {
+    profiler_add_marker(kTickDeferMarkers[aObserverIndex]);
+  }
+#endif
+
+  return true;
+}
+
+void
+nsRefreshDriver::UpdateObserverAverageTime(uint32_t aObserverIndex,
+                                           TimeDuration aDuration)
+{
+  // Exponential moving average over roughly the last four ticks: stable
+  // enough to ignore one-off spikes, quick enough to track real changes in
+  // observer cost.
+  TimeDuration& average = mObserverAverageTime[aObserverIndex];
+  average += (aDuration - average) / int64_t(4);
+}
+
 void
 nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 {
@@ -1802,6 +1863,12 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
   AUTO_PROFILER_LABEL("nsRefreshDriver::Tick", GRAPHICS);
 
+  if (!sTickBudgetPrefCached) {
+    sTickBudgetPrefCached = true;
+    Preferences::AddIntVarCache(&sTickBudgetMillis,
+                                "layout.refresh_driver.tick-budget-ms", 0);
+  }
+
   // We're either frozen or we were disconnected (likely in the middle
   // of a tick iteration).  Just do nothing here, since our
   // prescontext went away.
@@ -1881,6 +1948,17 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
    * null.  If this happens, we must stop notifying observers.
    */
   for (uint32_t i = 0; i < ArrayLength(mObservers); ++i) {
+    // Event and style observers always run: deferring them would stall frame
+    // request callbacks and animations, which is worse than missing a vsync.
+    // Layout and display observers keep their registrations when they are
+    // skipped, so they can be pushed to the next tick when this one is
+    // predicted to overrun its budget.
+    if (i >= 2 && ShouldDeferObserverBucket(i)) {
+      break;
+    }
+
+    TimeStamp bucketStart = TimeStamp::Now();
+
     ObserverArray::EndLimitedIterator etor(mObservers[i]);
     while (etor.HasMore()) {
       RefPtr<nsARefreshObserver> obs = etor.GetNext();
@@ -1978,6 +2056,8 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
       StopTimer();
       return;
     }
+
+    UpdateObserverAverageTime(i, TimeStamp::Now() - bucketStart);
   }
 
   // Recompute approximate frame visibility if it's necessary and enough time
@@ -2011,8 +2091,16 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
   /*
    * Perform notification to imgIRequests subscribed to listen
    * for refresh events.
+   *
+   * If we're throttled (e.g. a background tab), don't advance image
+   * animations at all rather than advancing them at the throttled rate.
+   * FrameAnimator advances by timestamp, so when we become visible again the
+   * animation catches up to where it should be in a single tick.
    */
 
+  const bool tickImageAnimations =
+    !mThrottled || !gfxPrefs::ImageAnimatedSuspendWhenThrottled();
+
   for (auto iter = mStartTable.Iter(); !iter.Done(); iter.Next()) {
     const uint32_t& delay = iter.Key();
     ImageStartData* data = iter.UserData();
@@ -2042,7 +2130,7 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
     }
   }
 
-  if (mRequests.Count()) {
+  if (tickImageAnimations && mRequests.Count()) {
     // RequestRefresh may run scripts, so it's not safe to directly call it
     // while using a hashtable enumerator to enumerate mRequests in case
     // script modifies the hashtable. Instead, we build a (local) array of
@@ -402,6 +402,19 @@ private:
   uint32_t ObserverCount() const;
   uint32_t ImageRequestCount() const;
   ObserverArray& ArrayFor(mozilla::FlushType aFlushType);
+
+  /**
+   * Returns true if running the given observer bucket now would likely push
+   * this tick past its budget (layout.refresh_driver.tick-budget-ms) and the
+   * bucket can safely be pushed to the next tick instead.
+   */
+  bool ShouldDeferObserverBucket(uint32_t aObserverIndex) const;
+
+  /**
+   * Fold a measured runtime for an observer bucket into its running average.
+   */
+  void UpdateObserverAverageTime(uint32_t aObserverIndex,
+                                 mozilla::TimeDuration aDuration);
   // Trigger a refresh immediately, if haven't been disconnected or frozen.
   void DoRefresh();
 
@@ -484,6 +497,10 @@ private:
 
   // separate arrays for each flush type we support
   ObserverArray mObservers[4];
+  // Running average of how long the corresponding mObservers bucket
+  // (including the style or layout flushes that run with it) took on recent
+  // ticks. Used to predict whether a bucket still fits in the tick budget.
+  mozilla::TimeDuration mObserverAverageTime[4];
   RequestTable mRequests;
   ImageStartTable mStartTable;
   AutoTArray<nsCOMPtr<nsIRunnable>, 16> mEarlyRunners;
@@ -187,6 +187,17 @@ NS_DECLARE_FRAME_PROPERTY_DELETABLE(TabWidthProperty, TabWidthStore)
 
 NS_DECLARE_FRAME_PROPERTY_WITHOUT_DTOR(OffsetToFrameProperty, nsTextFrame)
 
+// An array of all the continuations of a text frame, in chain order, stored
+// on the primary frame. Built lazily by GetChildFrameContainingOffset when a
+// chain turns out to be long enough that walking it linearly hurts, so that
+// offset lookups can binary-search for a starting frame instead.
+NS_DECLARE_FRAME_PROPERTY_DELETABLE(ContinuationIndexProperty,
+                                    nsTArray<nsTextFrame*>)
+
+// Chains shorter than this are cheap to walk linearly, so we only build a
+// continuation index once a lookup has had to take more steps than this.
+static const int32_t kContinuationIndexThreshold = 100;
+
 NS_DECLARE_FRAME_PROPERTY_RELEASABLE(UninflatedTextRunProperty, gfxTextRun)
 
 NS_DECLARE_FRAME_PROPERTY_SMALL_VALUE(FontSizeInflationProperty, float)
@@ -4411,6 +4422,19 @@ nsTextFrame::ClearFrameOffsetCache()
     }
     RemoveStateBits(TEXT_IN_OFFSET_CACHE);
   }
+
+  // Destroying any continuation also invalidates the continuation index on
+  // the primary frame, since the index holds a pointer to every frame that
+  // was in the chain when it was built. The primary frame's own index dies
+  // with its property table; and if an earlier frame in the chain was
+  // destroyed before us our prev pointer has already been cleared, in which
+  // case the index is already gone.
+  if (GetPrevContinuation()) {
+    nsIFrame* primaryFrame = mContent->GetPrimaryFrame();
+    if (primaryFrame) {
+      primaryFrame->DeleteProperty(ContinuationIndexProperty());
+    }
+  }
 }
 
 void
@@ -7887,9 +7911,35 @@ nsTextFrame::GetChildFrameContainingOffset(int32_t   aContentOffset,
     f->RemoveStateBits(TEXT_IN_OFFSET_CACHE);
   }
 
+  // For huge text nodes the continuation chain can run to tens of thousands
+  // of frames, making the linear walks below O(n) per caret placement or
+  // selection extension. If a continuation index has been built, binary
+  // search it for the last frame starting at or before aContentOffset and
+  // walk from there instead. The index is in chain order and content offsets
+  // never decrease along the chain, so it stays sorted even when offsets are
+  // adjusted after it is built; continuations created since then are simply
+  // absent from it and are found by the walk below.
+  nsTArray<nsTextFrame*>* index = GetProperty(ContinuationIndexProperty());
+  if (index) {
+    size_t low = 0;
+    size_t high = index->Length();
+    while (high - low > 1) {
+      size_t mid = low + (high - low) / 2;
+      if ((*index)[mid]->GetContentOffset() <= aContentOffset) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    f = (*index)[low];
+    offset = f->GetContentOffset();
+  }
+
+  int32_t steps = 0;
   if ((aContentOffset >= offset) &&
       (aHint || aContentOffset != offset)) {
     while (true) {
+      ++steps;
       nsTextFrame* next = f->GetNextContinuation();
       if (!next || aContentOffset < next->GetContentOffset())
         break;
@@ -7906,6 +7956,7 @@ nsTextFrame::GetChildFrameContainingOffset(int32_t   aContentOffset,
     }
   } else {
     while (true) {
+      ++steps;
       nsTextFrame* prev = f->GetPrevContinuation();
       if (!prev || aContentOffset > f->GetContentOffset())
         break;
@@ -7922,6 +7973,16 @@ nsTextFrame::GetChildFrameContainingOffset(int32_t   aContentOffset,
     }
   }
 
+  // If we had to walk a long way, index the chain so the next lookup can
+  // seek directly.
+  if (!index && steps > kContinuationIndexThreshold) {
+    index = new nsTArray<nsTextFrame*>();
+    for (nsTextFrame* t = this; t; t = t->GetNextContinuation()) {
+      index->AppendElement(t);
+    }
+    SetProperty(ContinuationIndexProperty(), index);
+  }
+
   *aOutOffset = aContentOffset - f->GetContentOffset();
   *aOutFrame = f;
 
@@ -25,6 +25,7 @@
 #include "nsCSSRendering.h"
 #include "nsISelectionController.h"
 #include "nsIPresShell.h"
+#include "nsThreadUtils.h"
 #include "nsRegion.h"
 #include "nsStyleStructInlines.h"
 #include "nsStyleTransformMatrix.h"
@@ -1391,6 +1392,66 @@ nsDisplayListBuilder::MarkPreserve3DFramesForDisplayList(nsIFrame* aDirtyFrame)
   }
 }
 
+/* Chunks retained across display list builds; see nsDisplayListBuilder::Arena.
+ * Display lists are built and destroyed on the main thread, so the cache
+ * needs no locking; any off-main-thread builder just bypasses it. The cap
+ * bounds the retained memory to kMaxCachedArenaChunks * 4KiB. */
+static const size_t kMaxCachedArenaChunks = 32;
+static void* gCachedArenaChunks[kMaxCachedArenaChunks];
+static size_t gNumCachedArenaChunks = 0;
+
+nsDisplayListBuilder::Arena::Chunk*
+nsDisplayListBuilder::Arena::AllocateChunk(size_t aSize)
+{
+  void* p;
+  if (aSize == kChunkSize && gNumCachedArenaChunks && NS_IsMainThread()) {
+    p = gCachedArenaChunks[--gNumCachedArenaChunks];
+  } else {
+    p = malloc(aSize);
+    if (!p) {
+      NS_ABORT_OOM(aSize);
+    }
+  }
+  Chunk* chunk = static_cast<Chunk*>(p);
+  chunk->mNext = mChunks;
+  chunk->mSize = aSize;
+  mChunks = chunk;
+  return chunk;
+}
+
+void*
+nsDisplayListBuilder::Arena::AllocateSlow(size_t aSize)
+{
+  if (aSize > kChunkSize - kChunkHeaderSize) {
+    // Oversized allocation; give it a chunk of its own and leave the
+    // current bump range untouched.
+    Chunk* chunk = AllocateChunk(kChunkHeaderSize + aSize);
+    return reinterpret_cast<char*>(chunk) + kChunkHeaderSize;
+  }
+
+  Chunk* chunk = AllocateChunk(kChunkSize);
+  char* p = reinterpret_cast<char*>(chunk) + kChunkHeaderSize;
+  mOffset = uintptr_t(p) + aSize;
+  mEnd = uintptr_t(chunk) + kChunkSize;
+  return p;
+}
+
+nsDisplayListBuilder::Arena::~Arena()
+{
+  const bool cache = NS_IsMainThread();
+  Chunk* chunk = mChunks;
+  while (chunk) {
+    Chunk* next = chunk->mNext;
+    if (cache && chunk->mSize == kChunkSize &&
+        gNumCachedArenaChunks < kMaxCachedArenaChunks) {
+      gCachedArenaChunks[gNumCachedArenaChunks++] = chunk;
+    } else {
+      free(chunk);
+    }
+    chunk = next;
+  }
+}
+
 void*
 nsDisplayListBuilder::Allocate(size_t aSize, DisplayItemType aType)
 {
@@ -251,6 +251,22 @@ nsLayoutStylesheetCache::DesignModeSheet()
   return mDesignModeSheet;
 }
 
+/* static */ void
+nsLayoutStylesheetCache::Preload(StyleBackendType aType)
+{
+  // Load the lazily-created UA sheets that an ordinary content document's
+  // style set will need (see nsDocumentViewer::CreateStyleSet); creating the
+  // cache itself loads the rest.  This lets an idle process -- a preallocated
+  // one in particular -- pay the sheet parsing cost before its first
+  // navigation rather than during it.  The sheets not touched here are rare
+  // enough that loading them eagerly would just waste memory.
+  nsLayoutStylesheetCache* cache = For(aType);
+  cache->UASheet();
+  cache->FormsSheet();
+  cache->NumberControlSheet();
+  cache->ScrollbarsSheet();
+}
+
 void
 nsLayoutStylesheetCache::Shutdown()
 {
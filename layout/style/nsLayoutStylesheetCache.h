@@ -74,6 +74,13 @@ class nsLayoutStylesheetCache final
   mozilla::StyleSheet* ContentEditableSheet();
   mozilla::StyleSheet* DesignModeSheet();
 
+  /**
+   * Eagerly loads the UA sheets a typical content document will need, so an
+   * idle content process can front-load the parsing cost before its first
+   * navigation.
+   */
+  static void Preload(mozilla::StyleBackendType aType);
+
   static void InvalidatePreferenceSheets();
 
   static void Shutdown();
@@ -31,6 +31,22 @@ using namespace mozilla::dom;
 using namespace mozilla::gfx;
 using namespace mozilla::image;
 
+/**
+ * The output of a filter whose result doesn't depend on any rendered input
+ * (e.g. a pure feFlood/feTurbulence chain), cached on the filtered frame so
+ * that repaints of static filtered content can reuse it. The cached surface
+ * is only valid for an identical FilterDescription and filter space rect;
+ * any attribute change produces a different description and replaces it.
+ */
+struct CachedFilterOutput {
+  FilterDescription mDescription;
+  nsIntRect mFilterRect;
+  RefPtr<mozilla::gfx::SourceSurface> mOutput;
+};
+
+NS_DECLARE_FRAME_PROPERTY_DELETABLE(CachedFilterOutputProperty,
+                                    CachedFilterOutput)
+
 FilterDescription
 nsFilterInstance::GetFilterDescription(nsIContent* aFilteredElement,
                                        const nsTArray<nsStyleFilter>& aFilterChain,
@@ -513,9 +529,59 @@ nsFilterInstance::Render(gfxContext* aCtx, imgDrawingParams& aImgParams)
 
   ComputeNeededBoxes();
 
+  // A filter that doesn't consume any rendered input (a pure feFlood or
+  // feTurbulence chain, say) produces the same output for a given description
+  // and filter space rect on every paint, so its result can be kept on the
+  // filtered frame and reused until the description changes.
+  const Rect renderRect(IntRect(IntPoint(), filterRect.Size()));
+  const bool cacheable = mSourceGraphic.mNeededBounds.IsEmpty() &&
+                         mFillPaint.mNeededBounds.IsEmpty() &&
+                         mStrokePaint.mNeededBounds.IsEmpty() &&
+                         mInputImages.IsEmpty() &&
+                         Factory::ReasonableSurfaceSize(filterRect.Size());
+  if (cacheable) {
+    CachedFilterOutput* cached =
+      mTargetFrame->GetProperty(CachedFilterOutputProperty());
+    if (cached && cached->mOutput &&
+        cached->mFilterRect.IsEqualEdges(filterRect) &&
+        cached->mDescription == mFilterDescription) {
+      aCtx->GetDrawTarget()->DrawSurface(cached->mOutput, renderRect,
+                                         renderRect);
+      return;
+    }
+  }
+
   BuildSourceImage(aImgParams);
   BuildSourcePaints(aImgParams);
 
+  if (cacheable) {
+    RefPtr<DrawTarget> offscreenDT =
+      gfxPlatform::GetPlatform()->CreateOffscreenContentDrawTarget(
+        filterRect.Size(), SurfaceFormat::B8G8R8A8);
+    if (offscreenDT && offscreenDT->IsValid()) {
+      FilterSupport::RenderFilterDescription(
+        offscreenDT, mFilterDescription, IntRectToRect(filterRect),
+        mSourceGraphic.mSourceSurface, mSourceGraphic.mSurfaceRect,
+        mFillPaint.mSourceSurface, mFillPaint.mSurfaceRect,
+        mStrokePaint.mSourceSurface, mStrokePaint.mSurfaceRect,
+        mInputImages, Point(0, 0));
+
+      RefPtr<SourceSurface> output = offscreenDT->Snapshot();
+      if (output) {
+        CachedFilterOutput* cached = new CachedFilterOutput();
+        cached->mDescription = mFilterDescription;
+        cached->mFilterRect = filterRect;
+        cached->mOutput = output;
+        mTargetFrame->SetProperty(CachedFilterOutputProperty(), cached);
+
+        aCtx->GetDrawTarget()->DrawSurface(output, renderRect, renderRect);
+        return;
+      }
+    }
+    // Couldn't create or snapshot the offscreen surface; fall through and
+    // render straight into the destination without caching.
+  }
+
   FilterSupport::RenderFilterDescription(
     aCtx->GetDrawTarget(), mFilterDescription, IntRectToRect(filterRect),
     mSourceGraphic.mSourceSurface, mSourceGraphic.mSurfaceRect,
@@ -49,6 +49,8 @@ nsTableCellFrame::nsTableCellFrame(nsStyleContext* aContext,
 {
   mColIndex = 0;
   mPriorAvailISize = 0;
+  mCachedMinISize = NS_INTRINSIC_WIDTH_UNKNOWN;
+  mCachedPrefISize = NS_INTRINSIC_WIDTH_UNKNOWN;
 
   SetContentEmpty(false);
   SetHasPctOverBSize(false);
@@ -779,9 +781,17 @@ nsTableCellFrame::GetMinISize(gfxContext *aRenderingContext)
   nscoord result = 0;
   DISPLAY_MIN_WIDTH(this, result);
 
-  nsIFrame *inner = mFrames.FirstChild();
-  result = nsLayoutUtils::IntrinsicForContainer(aRenderingContext, inner,
-                                                    nsLayoutUtils::MIN_ISIZE);
+  // The table's layout strategy asks every cell for its intrinsic inline
+  // sizes whenever any of them changes, so cache the measurement; the
+  // cache is invalidated by MarkIntrinsicISizesDirty, which the pres shell
+  // calls on this frame whenever something inside the cell changes.
+  if (mCachedMinISize == NS_INTRINSIC_WIDTH_UNKNOWN) {
+    nsIFrame *inner = mFrames.FirstChild();
+    mCachedMinISize =
+      nsLayoutUtils::IntrinsicForContainer(aRenderingContext, inner,
+                                           nsLayoutUtils::MIN_ISIZE);
+  }
+  result = mCachedMinISize;
   return result;
 }
 
@@ -791,12 +801,24 @@ nsTableCellFrame::GetPrefISize(gfxContext *aRenderingContext)
   nscoord result = 0;
   DISPLAY_PREF_WIDTH(this, result);
 
-  nsIFrame *inner = mFrames.FirstChild();
-  result = nsLayoutUtils::IntrinsicForContainer(aRenderingContext, inner,
-                                                nsLayoutUtils::PREF_ISIZE);
+  if (mCachedPrefISize == NS_INTRINSIC_WIDTH_UNKNOWN) {
+    nsIFrame *inner = mFrames.FirstChild();
+    mCachedPrefISize =
+      nsLayoutUtils::IntrinsicForContainer(aRenderingContext, inner,
+                                           nsLayoutUtils::PREF_ISIZE);
+  }
+  result = mCachedPrefISize;
   return result;
 }
 
+/* virtual */ void
+nsTableCellFrame::MarkIntrinsicISizesDirty()
+{
+  mCachedMinISize = NS_INTRINSIC_WIDTH_UNKNOWN;
+  mCachedPrefISize = NS_INTRINSIC_WIDTH_UNKNOWN;
+  nsContainerFrame::MarkIntrinsicISizesDirty();
+}
+
 /* virtual */ nsIFrame::IntrinsicISizeOffsetData
 nsTableCellFrame::IntrinsicISizeOffsets()
 {
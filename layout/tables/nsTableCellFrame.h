@@ -113,6 +113,7 @@ public:
 
   virtual nscoord GetMinISize(gfxContext *aRenderingContext) override;
   virtual nscoord GetPrefISize(gfxContext *aRenderingContext) override;
+  virtual void MarkIntrinsicISizesDirty() override;
   virtual IntrinsicISizeOffsetData IntrinsicISizeOffsets() override;
 
   virtual void Reflow(nsPresContext*      aPresContext,
@@ -251,6 +252,12 @@ protected:
 
   nscoord      mPriorAvailISize;      // the avail isize during the last reflow
   mozilla::LogicalSize mDesiredSize;  // the last desired inline and block size
+
+  // Cached intrinsic inline sizes (NS_INTRINSIC_WIDTH_UNKNOWN when dirty),
+  // so that recomputing a large table's column measurements only descends
+  // into the cells whose contents actually changed.
+  nscoord      mCachedMinISize;
+  nscoord      mCachedPrefISize;
 };
 
 inline nscoord nsTableCellFrame::GetPriorAvailISize()
@@ -286,6 +286,28 @@ void SampleIterator::Seek(Microseconds aTime)
   size_t syncSample = 0;
   mCurrentMoof = 0;
   mCurrentSample = 0;
+
+  // Skip over the already-parsed moofs that lie entirely before the target
+  // time at moof granularity rather than walking every sample from the start
+  // of the file; only the last sync sample of each such moof can be the seek
+  // point. Long fragmented recordings have hundreds of thousands of samples,
+  // so the per-sample walk below is only run from the target moof onwards.
+  if (mIndex->mMoofParser) {
+    const nsTArray<Moof>& moofs = mIndex->mMoofParser->Moofs();
+    while (mCurrentMoof < moofs.Length() &&
+           moofs[mCurrentMoof].mTimeRange.end <= aTime) {
+      const FallibleTArray<Sample>& samples = moofs[mCurrentMoof].mIndex;
+      for (size_t i = samples.Length(); i > 0; i--) {
+        if (samples[i - 1].mSync) {
+          syncMoof = mCurrentMoof;
+          syncSample = i - 1;
+          break;
+        }
+      }
+      mCurrentMoof++;
+    }
+  }
+
   Sample* sample;
   while (!!(sample = Get())) {
     if (sample->mCompositionRange.start > aTime) {
@@ -118,6 +118,16 @@ MALLOC_DECL(moz_create_arena, arena_id_t)
  * Dispose of the given arena. Subsequent uses of the arena will fail.
  */
 MALLOC_DECL(moz_dispose_arena, void, arena_id_t)
+
+/*
+ * Set the maximum number of dirty pages the given arena may retain before
+ * it starts purging them back to the operating system, in pages. Arenas
+ * created with moz_create_arena start with a conservative limit; a
+ * subsystem that churns through memory in bursts can raise it to keep its
+ * pages around, and one that mostly sits idle can lower it. Takes effect
+ * immediately: if the arena is already over the new limit, it is purged.
+ */
+MALLOC_DECL(moz_set_arena_max_dirty, void, arena_id_t, size_t)
 #  endif
 
 #  if MALLOC_FUNCS & MALLOC_FUNCS_ARENA_ALLOC
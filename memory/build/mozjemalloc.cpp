@@ -334,6 +334,23 @@ void *_mmap(void *addr, size_t length, int prot, int flags,
 /* Maximum number of dirty pages per arena. */
 #define	DIRTY_MAX_DEFAULT	(1U << 8)
 
+/*
+ * Maximum number of dirty pages to purge in one trip through
+ * arena_t::Purge() when it is invoked from the deallocation path.  Purging
+ * is synchronous on whichever thread happened to free last, so releasing
+ * the backlog in small increments amortizes the madvise/decommit cost over
+ * many frees instead of stalling one of them for the whole storm.
+ */
+#define	PURGE_INCREMENT_MAX	(1U << 4)
+
+/*
+ * If the number of dirty pages reaches this multiple of mMaxDirty, give up
+ * on incremental purging and drain down to the usual target in one go, so
+ * that a burst of frees with no follow-up traffic cannot pin an unbounded
+ * backlog of dirty pages.
+ */
+#define	PURGE_EXCESS_FACTOR	4
+
 /*
  * Maximum size of L1 cache line.  This is used to avoid cache line aliasing,
  * so over-estimates are okay (up to a point), but under-estimates will
@@ -1138,10 +1155,25 @@ static MOZ_THREAD_LOCAL(arena_t*) thread_arena;
 static mozilla::detail::ThreadLocal<arena_t*, mozilla::detail::ThreadLocalKeyStorage> thread_arena;
 #endif
 
-// The main arena, which all threads default to until jemalloc_thread_local_arena
+// The number of main arenas that threads are spread across.  Threads that
+// haven't opted into a private arena via jemalloc_thread_local_arena are
+// assigned one of these round-robin on their first allocation, which bounds
+// how many threads can contend on any single arena lock.  A handful is
+// enough to take the pressure off without multiplying chunk-level
+// fragmentation.
+static const unsigned kNumMainArenas = 4;
+
+// The main arenas, which threads default to until jemalloc_thread_local_arena
 // is called.
+static arena_t *gMainArenas[kNumMainArenas];
+
+// The first main arena, which also backs paths that can't be attributed to a
+// particular thread, such as the arena creation fallback.
 static arena_t *gMainArena;
 
+// Round-robin cursor into gMainArenas; protected by arenas_lock.
+static unsigned gMainArenaCursor;
+
 /*******************************/
 /*
  * Runtime configuration options.
@@ -2311,7 +2343,12 @@ thread_local_arena(bool enabled)
      * with `false`, except maybe at shutdown. */
     arena = arenas_extend();
   } else {
-    arena = gMainArena;
+    /* Spread threads round-robin across the main arenas so that no single
+     * arena lock serializes every thread that didn't ask for a private
+     * arena. */
+    malloc_spin_lock(&arenas_lock);
+    arena = gMainArenas[gMainArenaCursor++ % kNumMainArenas];
+    malloc_spin_unlock(&arenas_lock);
   }
   thread_arena.set(arena);
   return arena;
@@ -2775,13 +2812,27 @@ arena_t::Purge(bool aAll)
 #endif
   MOZ_DIAGNOSTIC_ASSERT(aAll || (mNumDirty > mMaxDirty));
 
+  /*
+   * On the deallocation path, only release a bounded increment per trip;
+   * the threshold stays tripped, so subsequent frees keep draining the
+   * backlog without any single one of them eating a purge storm.  Fall
+   * back to a full drain if we are far enough behind the budget that
+   * waiting for more frees could pin the dirty pages indefinitely;
+   * jemalloc_free_dirty_pages() likewise drains everything via aAll.
+   */
+  size_t dirty_target = dirty_max >> 1;
+  if (!aAll && mNumDirty < mMaxDirty * PURGE_EXCESS_FACTOR &&
+      mNumDirty > dirty_target + PURGE_INCREMENT_MAX) {
+    dirty_target = mNumDirty - PURGE_INCREMENT_MAX;
+  }
+
   /*
    * Iterate downward through chunks until enough dirty memory has been
    * purged.  Terminate as soon as possible in order to minimize the
    * number of system calls, even if a chunk has only been partially
    * purged.
    */
-  while (mNumDirty > (dirty_max >> 1)) {
+  while (mNumDirty > dirty_target) {
 #ifdef MALLOC_DOUBLE_PURGE
     bool madvised = false;
 #endif
@@ -2826,7 +2877,7 @@ arena_t::Purge(bool aAll)
         madvised = true;
 #  endif
 #endif
-        if (mNumDirty <= (dirty_max >> 1)) {
+        if (mNumDirty <= dirty_target) {
           break;
         }
       }
@@ -4476,20 +4527,24 @@ MALLOC_OUT:
   malloc_spin_init(&arenas_lock);
 
   /*
-   * Initialize one arena here.
+   * Initialize the main arenas here.
    */
   gArenaTree.Init();
-  arenas_extend();
-  gMainArena = gArenaTree.First();
-  if (!gMainArena) {
+  for (unsigned i = 0; i < kNumMainArenas; i++) {
+    arena_t* arena = arenas_extend();
+    if (!arena) {
 #ifndef XP_WIN
-    malloc_mutex_unlock(&init_lock);
+      malloc_mutex_unlock(&init_lock);
 #endif
-    return true;
+      return true;
+    }
+    /* arena_t::Init() sets this to a lower value for thread local arenas;
+     * split the default budget evenly so the main arenas together retain
+     * the same dirty page limit a single main arena used to have. */
+    arena->mMaxDirty = opt_dirty_max / kNumMainArenas;
+    gMainArenas[i] = arena;
   }
-  /* arena_t::Init() sets this to a lower value for thread local arenas;
-   * reset to the default value for the main arena. */
-  gMainArena->mMaxDirty = opt_dirty_max;
+  gMainArena = gMainArenas[0];
 
   /*
    * Assign the initial arena to the initial thread.
@@ -5001,7 +5056,6 @@ arena_t::GetById(arena_id_t aArenaId)
   return result;
 }
 
-#ifdef NIGHTLY_BUILD
 template<> inline arena_id_t
 MozJemalloc::moz_create_arena()
 {
@@ -5021,6 +5075,18 @@ MozJemalloc::moz_dispose_arena(arena_id_t aArenaId)
   malloc_spin_unlock(&arenas_lock);
 }
 
+template<> inline void
+MozJemalloc::moz_set_arena_max_dirty(arena_id_t aArenaId, size_t aMaxDirty)
+{
+  arena_t* arena = arena_t::GetById(aArenaId);
+  malloc_spin_lock(&arena->mLock);
+  arena->mMaxDirty = aMaxDirty;
+  if (arena->mNumDirty > arena->mMaxDirty) {
+    arena->Purge(false);
+  }
+  malloc_spin_unlock(&arena->mLock);
+}
+
 #define MALLOC_DECL(name, return_type, ...) \
   template<> inline return_type \
   MozJemalloc::moz_arena_ ## name(arena_id_t aArenaId, ARGS_HELPER(TYPED_ARGS, ##__VA_ARGS__)) \
@@ -5031,19 +5097,6 @@ MozJemalloc::moz_dispose_arena(arena_id_t aArenaId)
 #define MALLOC_FUNCS MALLOC_FUNCS_MALLOC_BASE
 #include "malloc_decls.h"
 
-#else
-
-#define MALLOC_DECL(name, return_type, ...) \
-  template<> inline return_type \
-  MozJemalloc::name(ARGS_HELPER(TYPED_ARGS, ##__VA_ARGS__)) \
-  { \
-    return DummyArenaAllocator<MozJemalloc>::name(ARGS_HELPER(ARGS, ##__VA_ARGS__)); \
-  }
-#define MALLOC_FUNCS MALLOC_FUNCS_ARENA
-#include "malloc_decls.h"
-
-#endif
-
 /*
  * End non-standard functions.
  */
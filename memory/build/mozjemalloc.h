@@ -63,6 +63,8 @@ struct DummyArenaAllocator {
 
   static void moz_dispose_arena(arena_id_t) { }
 
+  static void moz_set_arena_max_dirty(arena_id_t, size_t) { }
+
 #define MALLOC_DECL(name, return_type, ...) \
   static return_type \
   moz_arena_ ## name(arena_id_t, ARGS_HELPER(TYPED_ARGS, ##__VA_ARGS__)) \
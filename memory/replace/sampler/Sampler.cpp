@@ -0,0 +1,439 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+#include <cstdlib>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <pthread.h>
+#endif
+
+#include "replace_malloc.h"
+#include "FdPrintf.h"
+
+#include "base/lock.h"
+#include "mozilla/StackWalk.h"
+
+/* Unlike DMD, which tracks every live block and is too slow to ship
+ * enabled, this library samples allocations with a probability
+ * proportional to their size (an allocation of `size` bytes is picked
+ * with probability 1 - exp(-size / mean)), walks the stack for the
+ * sampled ones only, and streams events to a file descriptor. A
+ * sampled block is remembered so that its death is reported too, which
+ * lets a reader maintain per-callsite live-byte estimates: scale each
+ * sample by 1 / (1 - exp(-size / mean)) using the mean logged at
+ * startup. Between samples the overhead is a counter decrement. */
+
+static const malloc_table_t* sFuncs = nullptr;
+static intptr_t sFd = 0;
+static bool sStdoutOrStderr = false;
+
+static Lock sLock;
+
+/* Mean of the exponential distribution the sampling intervals are drawn
+ * from, in bytes; configured with MALLOC_SAMPLE_INTERVAL. */
+static size_t sMeanInterval = 512 * 1024;
+
+/* Bytes of allocation left before the next sample; protected by sLock. */
+static size_t sBytesUntilSample;
+
+static uint64_t sRngState;
+
+static void
+prefork() {
+  sLock.Acquire();
+}
+
+static void
+postfork() {
+  sLock.Release();
+}
+
+static size_t
+GetPid()
+{
+  return size_t(getpid());
+}
+
+static size_t
+GetTid()
+{
+#if defined(_WIN32)
+  return size_t(GetCurrentThreadId());
+#else
+  return size_t(pthread_self());
+#endif
+}
+
+#ifdef ANDROID
+/* See mozglue/android/APKOpen.cpp */
+extern "C" MOZ_EXPORT __attribute__((weak))
+void* __dso_handle;
+
+/* Android doesn't have pthread_atfork defined in pthread.h */
+extern "C" MOZ_EXPORT
+int pthread_atfork(void (*)(void), void (*)(void), void (*)(void));
+#endif
+
+static uint64_t
+XorShift()
+{
+  uint64_t x = sRngState;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  sRngState = x;
+  return x;
+}
+
+/* Draw the next sampling interval from an exponential distribution with
+ * mean sMeanInterval, which makes the sampling a Poisson process over
+ * allocated bytes: the decision is memoryless, so allocation patterns
+ * can't alias with the sampling period. */
+static size_t
+NextSampleInterval()
+{
+  /* 53 high bits give a uniform double in [0, 1). */
+  double u = double(XorShift() >> 11) * (1.0 / 9007199254740992.0);
+  double interval = -std::log(1.0 - u) * double(sMeanInterval);
+  if (interval < 1.0) {
+    return 1;
+  }
+  return size_t(interval);
+}
+
+/* An open-addressed table of the sampled blocks that are still alive, so
+ * that replace_free knows which (rare) pointers deserve an event. Uses
+ * the stock allocator via sFuncs; protected by sLock. */
+static const void* const kTombstone = reinterpret_cast<const void*>(1);
+
+struct LiveEntry
+{
+  const void* mPtr;
+  size_t mSize;
+};
+
+static LiveEntry* sLiveTable = nullptr;
+static size_t sLiveCapacity = 0; /* Always a power of two. */
+static size_t sLiveOccupied = 0; /* Live entries plus tombstones. */
+
+static size_t
+LiveHash(const void* aPtr)
+{
+  return (uintptr_t(aPtr) >> 3) * 0x9E3779B97F4A7C15ULL;
+}
+
+static bool
+LiveTableInsert(const void* aPtr, size_t aSize)
+{
+  if (sLiveOccupied * 4 >= sLiveCapacity * 3) {
+    size_t newCapacity = sLiveCapacity ? sLiveCapacity * 2 : 1024;
+    LiveEntry* newTable =
+        (LiveEntry*)sFuncs->calloc(newCapacity, sizeof(LiveEntry));
+    if (!newTable) {
+      return false;
+    }
+    /* Rehashing drops the tombstones. */
+    size_t occupied = 0;
+    for (size_t i = 0; i < sLiveCapacity; i++) {
+      const LiveEntry& entry = sLiveTable[i];
+      if (!entry.mPtr || entry.mPtr == kTombstone) {
+        continue;
+      }
+      size_t j = LiveHash(entry.mPtr) & (newCapacity - 1);
+      while (newTable[j].mPtr) {
+        j = (j + 1) & (newCapacity - 1);
+      }
+      newTable[j] = entry;
+      occupied++;
+    }
+    sFuncs->free(sLiveTable);
+    sLiveTable = newTable;
+    sLiveCapacity = newCapacity;
+    sLiveOccupied = occupied;
+  }
+
+  size_t i = LiveHash(aPtr) & (sLiveCapacity - 1);
+  while (sLiveTable[i].mPtr && sLiveTable[i].mPtr != kTombstone) {
+    i = (i + 1) & (sLiveCapacity - 1);
+  }
+  if (sLiveTable[i].mPtr != kTombstone) {
+    sLiveOccupied++;
+  }
+  sLiveTable[i].mPtr = aPtr;
+  sLiveTable[i].mSize = aSize;
+  return true;
+}
+
+static bool
+LiveTableRemove(const void* aPtr, size_t* aSize)
+{
+  if (!sLiveCapacity) {
+    return false;
+  }
+  size_t i = LiveHash(aPtr) & (sLiveCapacity - 1);
+  while (sLiveTable[i].mPtr) {
+    if (sLiveTable[i].mPtr == aPtr) {
+      *aSize = sLiveTable[i].mSize;
+      sLiveTable[i].mPtr = kTombstone;
+      return true;
+    }
+    i = (i + 1) & (sLiveCapacity - 1);
+  }
+  return false;
+}
+
+static const size_t kMaxFrames = 24;
+
+struct SampleStack
+{
+  size_t mLength;
+  void* mPcs[kMaxFrames];
+};
+
+static void
+StackWalkCallback(uint32_t aFrameNumber, void* aPc, void* aSp, void* aClosure)
+{
+  SampleStack* stack = (SampleStack*)aClosure;
+  if (stack->mLength < kMaxFrames) {
+    stack->mPcs[stack->mLength++] = aPc;
+  }
+}
+
+static void
+MaybeSample(const void* aPtr, size_t aSize)
+{
+  {
+    AutoLock lock(sLock);
+    if (!sFd) {
+      return;
+    }
+    if (aSize < sBytesUntilSample) {
+      sBytesUntilSample -= aSize;
+      return;
+    }
+    sBytesUntilSample = NextSampleInterval();
+  }
+
+  /* Walk the stack without holding sLock: on Windows the walker can take
+   * the shared library loader's lock, which another thread may hold while
+   * allocating. See the equivalent comment in DMD's StackTrace::Get(). */
+  SampleStack stack;
+  stack.mLength = 0;
+  MozStackWalk(StackWalkCallback, /* aSkipFrames */ 2, kMaxFrames, &stack);
+
+  AutoLock lock(sLock);
+  if (!LiveTableInsert(aPtr, aSize)) {
+    /* Couldn't remember the block, so its death would go unreported;
+     * drop the sample rather than bias the reader's live accounting. */
+    return;
+  }
+  FdPrintf(sFd, "%zu %zu sample(%p,%zu)", GetPid(), GetTid(), aPtr, aSize);
+  for (size_t i = 0; i < stack.mLength; i++) {
+    FdPrintf(sFd, " %p", stack.mPcs[i]);
+  }
+  FdPrintf(sFd, "\n");
+}
+
+static void
+MaybeUnsample(const void* aPtr)
+{
+  AutoLock lock(sLock);
+  size_t size;
+  if (sFd && LiveTableRemove(aPtr, &size)) {
+    FdPrintf(sFd, "%zu %zu unsample(%p,%zu)\n", GetPid(), GetTid(), aPtr,
+             size);
+  }
+}
+
+class SamplerBridge : public ReplaceMallocBridge
+{
+  virtual void InitDebugFd(mozilla::DebugFdRegistry& aRegistry) override {
+    if (!sStdoutOrStderr) {
+      aRegistry.RegisterHandle(sFd);
+    }
+  }
+};
+
+void
+replace_init(const malloc_table_t* aTable)
+{
+  sFuncs = aTable;
+
+#ifndef _WIN32
+  /* See the comment in logalloc's replace_init for why the real allocator
+   * needs poking before we register our own atfork handlers. */
+  sFuncs->malloc(-1);
+  pthread_atfork(prefork, postfork, postfork);
+#endif
+
+  char* interval = getenv("MALLOC_SAMPLE_INTERVAL");
+  if (interval && *interval) {
+    size_t mean = 0;
+    const char* c = interval;
+    while (*c >= '0' && *c <= '9') {
+      mean = mean * 10 + (*c - '0');
+      c++;
+    }
+    if (!*c && mean) {
+      sMeanInterval = mean;
+    }
+  }
+
+  sRngState = uint64_t(GetPid()) * 0x9E3779B97F4A7C15ULL | 1;
+  sBytesUntilSample = NextSampleInterval();
+
+  /* Initialize output file descriptor from the MALLOC_SAMPLE_LOG
+   * environment variable. Numbers up to 9999 are considered as a preopened
+   * file descriptor number. Other values are considered as a file name. */
+  char* log = getenv("MALLOC_SAMPLE_LOG");
+  if (log && *log) {
+    int fd = 0;
+    const char *fd_num = log;
+    while (*fd_num) {
+      /* Reject non digits. */
+      if (*fd_num < '0' || *fd_num > '9') {
+        fd = -1;
+        break;
+      }
+      fd = fd * 10 + (*fd_num - '0');
+      /* Reject values >= 10000. */
+      if (fd >= 10000) {
+        fd = -1;
+        break;
+      }
+      fd_num++;
+    }
+    if (fd == 1 || fd == 2) {
+      sStdoutOrStderr = true;
+    }
+#ifdef _WIN32
+    // See comment in FdPrintf.h as to why CreateFile is used.
+    HANDLE handle;
+    if (fd > 0) {
+      handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    } else {
+      handle = CreateFileA(log, FILE_APPEND_DATA, FILE_SHARE_READ |
+                           FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    if (handle != INVALID_HANDLE_VALUE) {
+      sFd = reinterpret_cast<intptr_t>(handle);
+    }
+#else
+    if (fd == -1) {
+      fd = open(log, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    }
+    if (fd > 0) {
+      sFd = fd;
+    }
+#endif
+  }
+
+  if (sFd) {
+    /* Record the sampling mean so readers can unbias the samples. */
+    FdPrintf(sFd, "%zu %zu sampler(mean=%zu)\n", GetPid(), GetTid(),
+             sMeanInterval);
+  }
+}
+
+ReplaceMallocBridge*
+replace_get_bridge()
+{
+  static SamplerBridge bridge;
+  return &bridge;
+}
+
+void*
+replace_malloc(size_t aSize)
+{
+  void* ptr = sFuncs->malloc(aSize);
+  if (ptr) {
+    MaybeSample(ptr, aSize);
+  }
+  return ptr;
+}
+
+int
+replace_posix_memalign(void** aPtr, size_t aAlignment, size_t aSize)
+{
+  int ret = sFuncs->posix_memalign(aPtr, aAlignment, aSize);
+  if (ret == 0) {
+    MaybeSample(*aPtr, aSize);
+  }
+  return ret;
+}
+
+void*
+replace_aligned_alloc(size_t aAlignment, size_t aSize)
+{
+  void* ptr = sFuncs->aligned_alloc(aAlignment, aSize);
+  if (ptr) {
+    MaybeSample(ptr, aSize);
+  }
+  return ptr;
+}
+
+void*
+replace_calloc(size_t aNum, size_t aSize)
+{
+  void* ptr = sFuncs->calloc(aNum, aSize);
+  if (ptr) {
+    /* A successful calloc means aNum * aSize didn't overflow. */
+    MaybeSample(ptr, aNum * aSize);
+  }
+  return ptr;
+}
+
+void*
+replace_realloc(void* aPtr, size_t aSize)
+{
+  void* new_ptr = sFuncs->realloc(aPtr, aSize);
+  if (new_ptr || !aSize) {
+    if (aPtr) {
+      MaybeUnsample(aPtr);
+    }
+    if (new_ptr) {
+      MaybeSample(new_ptr, aSize);
+    }
+  }
+  return new_ptr;
+}
+
+void
+replace_free(void* aPtr)
+{
+  if (aPtr) {
+    MaybeUnsample(aPtr);
+  }
+  sFuncs->free(aPtr);
+}
+
+void*
+replace_memalign(size_t aAlignment, size_t aSize)
+{
+  void* ptr = sFuncs->memalign(aAlignment, aSize);
+  if (ptr) {
+    MaybeSample(ptr, aSize);
+  }
+  return ptr;
+}
+
+void*
+replace_valloc(size_t aSize)
+{
+  void* ptr = sFuncs->valloc(aSize);
+  if (ptr) {
+    MaybeSample(ptr, aSize);
+  }
+  return ptr;
+}
@@ -306,6 +306,14 @@ class BufferList : private AllocPolicy
   // data before aSize.
   inline bool ReadBytes(IterImpl& aIter, char* aData, size_t aSize) const;
 
+  // Returns a pointer to the first byte of the range [aIter, aIter + aSize)
+  // if that range is contiguous within a single segment, and advances aIter
+  // past it. Otherwise returns null and leaves aIter untouched. This lets
+  // callers that would otherwise ReadBytes into a scratch buffer consume
+  // the data in place when it happens to sit in one segment. The pointer is
+  // valid for as long as the underlying segment is.
+  inline const char* ReadBytesZeroCopy(IterImpl& aIter, size_t aSize) const;
+
   // Return a new BufferList that shares storage with this BufferList. The new
   // BufferList is read-only. It allows iteration over aSize bytes starting at
   // aIter. Borrow can fail, in which case *aSuccess will be false upon
@@ -449,6 +457,21 @@ BufferList<AllocPolicy>::ReadBytes(IterImpl& aIter, char* aData, size_t aSize) c
   return true;
 }
 
+template<typename AllocPolicy>
+const char*
+BufferList<AllocPolicy>::ReadBytesZeroCopy(IterImpl& aIter, size_t aSize) const
+{
+  MOZ_ASSERT(aSize);
+
+  if (!aIter.HasRoomFor(aSize)) {
+    return nullptr;
+  }
+
+  const char* data = aIter.Data();
+  aIter.Advance(*this, aSize);
+  return data;
+}
+
 template<typename AllocPolicy> template<typename BorrowingAllocPolicy>
 BufferList<BorrowingAllocPolicy>
 BufferList<AllocPolicy>::Borrow(IterImpl& aIter, size_t aSize, bool* aSuccess,
@@ -509,31 +532,48 @@ BufferList<AllocPolicy>::Extract(IterImpl& aIter, size_t aSize, bool* aSuccess)
 
   IterImpl iter = aIter;
   size_t size = aSize;
-  size_t toCopy = std::min(size, aIter.RemainingInSegment());
+
+  // If the range starts in the middle of a segment, the partial head has to
+  // be copied. When it starts on a segment boundary there is nothing to
+  // copy; whole leading segments are spliced into the result below instead.
+  size_t toCopy = aIter.mData == mSegments[aIter.mSegment].Start()
+                  ? 0
+                  : std::min(size, aIter.RemainingInSegment());
   MOZ_ASSERT(toCopy % kSegmentAlignment == 0);
 
   BufferList result(0, toCopy, mStandardCapacity);
   BufferList error(0, 0, mStandardCapacity);
 
   // Copy the head
-  if (!result.WriteBytes(aIter.mData, toCopy)) {
-    *aSuccess = false;
-    return error;
+  if (toCopy) {
+    if (!result.WriteBytes(aIter.mData, toCopy)) {
+      *aSuccess = false;
+      return error;
+    }
+    iter.Advance(*this, toCopy);
+    size -= toCopy;
   }
-  iter.Advance(*this, toCopy);
-  size -= toCopy;
 
   // Move segments to result
+  size_t headSegments = result.mSegments.length();
   auto resultGuard = MakeScopeExit([&] {
     *aSuccess = false;
-    result.mSegments.erase(result.mSegments.begin()+1, result.mSegments.end());
+    result.mSegments.erase(result.mSegments.begin() + headSegments,
+                           result.mSegments.end());
   });
 
   size_t movedSize = 0;
   uintptr_t toRemoveStart = iter.mSegment;
   uintptr_t toRemoveEnd = iter.mSegment;
+
+  // A segment can be moved wholesale if the remaining range extends past its
+  // end, or covers it exactly and a later segment exists for aIter to land
+  // in afterwards (the last segment always stays put so that aIter remains
+  // valid when the range ends flush with the BufferList).
   while (!iter.Done() &&
-         !iter.HasRoomFor(size)) {
+         (!iter.HasRoomFor(size) ||
+          (size && size == iter.RemainingInSegment() &&
+           iter.mSegment + 1 < mSegments.length()))) {
     if (!result.mSegments.append(Segment(mSegments[iter.mSegment].mData,
                                          mSegments[iter.mSegment].mSize,
                                          mSegments[iter.mSegment].mCapacity))) {
@@ -252,5 +252,39 @@ int main(void)
   MOZ_RELEASE_ASSERT(iter.AdvanceAcrossSegments(bl2, kExtractSize));
   MOZ_RELEASE_ASSERT(iter.Done());
 
+  // Extracting at a segment boundary should splice the segments into the
+  // result rather than copy them.
+
+  BufferList bl5(0, kSmallCapacity, kSmallCapacity);
+  bl5.WriteBytes(toWrite, kSmallWrite);
+  bl5.WriteBytes(toWrite, kSmallWrite);
+
+  iter = bl5.Iter();
+  iter.Advance(bl5, kSmallCapacity);
+  char* spliceData = iter.Data();
+
+  BufferList bl6 = bl5.Extract(iter, kSmallCapacity * 2, &success);
+  MOZ_RELEASE_ASSERT(success);
+  MOZ_RELEASE_ASSERT(bl6.Size() == kSmallCapacity * 2);
+  MOZ_RELEASE_ASSERT(bl5.Size() == kSmallWrite * 2 - kSmallCapacity * 2);
+
+  // The storage must have moved by pointer, not by copy.
+  MOZ_RELEASE_ASSERT(bl6.Start() == spliceData);
+
+  MOZ_RELEASE_ASSERT(iter.AdvanceAcrossSegments(bl5, kSmallCapacity));
+  MOZ_RELEASE_ASSERT(iter.Done());
+
+  // Zero-copy reads of ranges contiguous within one segment.
+
+  iter = bl6.Iter();
+  MOZ_RELEASE_ASSERT(bl6.ReadBytesZeroCopy(iter, kSmallCapacity) == spliceData);
+
+  // This range crosses a segment boundary, so it cannot be handed out as a
+  // contiguous pointer and the iterator must not move.
+  MOZ_RELEASE_ASSERT(!bl6.ReadBytesZeroCopy(iter, kSmallCapacity + 1));
+
+  MOZ_RELEASE_ASSERT(bl6.ReadBytesZeroCopy(iter, kSmallCapacity));
+  MOZ_RELEASE_ASSERT(iter.Done());
+
   return 0;
 }
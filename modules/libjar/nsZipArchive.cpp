@@ -74,6 +74,8 @@ static const uint16_t kSyntheticDate = (1 + (1 << 5) + (0 << 9));
 static uint16_t xtoint(const uint8_t *ii);
 static uint32_t xtolong(const uint8_t *ll);
 static uint32_t HashName(const char* aName, uint16_t nameLen);
+static void MaybeReadAhead(const uint8_t *aStart, uint32_t aLength,
+                           PRFileDesc *aFd);
 #ifdef XP_UNIX
 static nsresult ResolveSymlink(const char *path);
 #endif
@@ -354,8 +356,18 @@ nsresult nsZipArchive::OpenArchive(nsZipHandle *aZipHandle, PRFileDesc *aFd)
 {
   mFd = aZipHandle;
 
-  //-- get table of contents for archive
-  nsresult rv = BuildFileList(aFd);
+  //-- get table of contents for archive; a valid index sidecar saves us
+  //-- the central directory scan
+  nsresult rv = NS_ERROR_FAILURE;
+  nsCOMPtr<nsIFile> sidecar;
+  if (NS_SUCCEEDED(GetIndexSidecarFile(getter_AddRefs(sidecar)))) {
+    rv = ReadIndexSidecar(sidecar);
+  }
+  if (NS_SUCCEEDED(rv)) {
+    MaybeReadAhead(mFd->mFileData, mFd->mLen, aFd);
+  } else {
+    rv = BuildFileList(aFd);
+  }
   if (NS_SUCCEEDED(rv)) {
     if (aZipHandle->mFile)
       aZipHandle->mFile.GetURIString(mURI);
@@ -668,6 +680,36 @@ nsZipItem* nsZipArchive::CreateZipItem()
   return (nsZipItem*)mArena.Allocate(sizeof(nsZipItem));
 }
 
+//---------------------------------------------
+//  MaybeReadAhead
+//
+//  The first four bytes of an optimized jar (bug 559961) hold the length
+//  of the data worth reading ahead. No-op for other archives.
+//---------------------------------------------
+static void MaybeReadAhead(const uint8_t *aStart, uint32_t aLength,
+                           PRFileDesc *aFd)
+{
+MOZ_WIN_MEM_TRY_BEGIN
+  if (aLength <= ZIPCENTRAL_SIZE || xtolong(aStart + 4) != CENTRALSIG)
+    return;
+
+  uint32_t readaheadLength = xtolong(aStart);
+  if (!readaheadLength || readaheadLength > aLength)
+    return;
+
+#if defined(XP_SOLARIS)
+  posix_madvise(const_cast<uint8_t*>(aStart), readaheadLength, POSIX_MADV_WILLNEED);
+#elif defined(XP_UNIX)
+  madvise(const_cast<uint8_t*>(aStart), readaheadLength, MADV_WILLNEED);
+#elif defined(XP_WIN)
+  if (aFd) {
+    HANDLE hFile = (HANDLE) PR_FileDesc2NativeHandle(aFd);
+    mozilla::ReadAhead(hFile, 0, readaheadLength);
+  }
+#endif
+MOZ_WIN_MEM_TRY_CATCH(return)
+}
+
 //---------------------------------------------
 //  nsZipArchive::BuildFileList
 //---------------------------------------------
@@ -681,19 +723,7 @@ MOZ_WIN_MEM_TRY_BEGIN
   uint32_t centralOffset = 4;
   if (mFd->mLen > ZIPCENTRAL_SIZE && xtolong(startp + centralOffset) == CENTRALSIG) {
     // Success means optimized jar layout from bug 559961 is in effect
-    uint32_t readaheadLength = xtolong(startp);
-    if (readaheadLength) {
-#if defined(XP_SOLARIS)
-      posix_madvise(const_cast<uint8_t*>(startp), readaheadLength, POSIX_MADV_WILLNEED);
-#elif defined(XP_UNIX)
-      madvise(const_cast<uint8_t*>(startp), readaheadLength, MADV_WILLNEED);
-#elif defined(XP_WIN)
-      if (aFd) {
-        HANDLE hFile = (HANDLE) PR_FileDesc2NativeHandle(aFd);
-        mozilla::ReadAhead(hFile, 0, readaheadLength);
-      }
-#endif
-    }
+    MaybeReadAhead(startp, mFd->mLen, aFd);
   } else {
     for (buf = endp - ZIPEND_SIZE; buf > startp; buf--)
       {
@@ -789,6 +819,149 @@ MOZ_WIN_MEM_TRY_CATCH(return NS_ERROR_FAILURE)
   return NS_OK;
 }
 
+/*
+ * The index sidecar ("<archive>.idx", generated at build time by
+ * config/optimize_jar_layout.py) persists the parsed central directory, so
+ * opening the archive doesn't need to scan it. All fields little-endian:
+ *
+ *   uint32 magic ('JIDX')
+ *   uint32 length of the archive data
+ *   uint32 crc32 of the trailing kIndexTailCRCLength bytes of the archive
+ *   uint32 archive comment offset (0 if none)
+ *   uint32 archive comment length
+ *   uint32 entry count
+ *   then per entry: uint32 central record offset, uint16 name length,
+ *   uint16 hash bucket (HashName of the entry name)
+ *
+ * The length and tail crc32 (covering the end-of-central-directory record)
+ * tie a sidecar to the exact archive it was generated from; a mismatch
+ * makes us fall back to scanning.
+ */
+static const uint32_t kIndexSidecarMagic = 0x5844494a; /* 'JIDX' */
+static const uint32_t kIndexSidecarHeaderSize = 6 * sizeof(uint32_t);
+static const uint32_t kIndexSidecarEntrySize = 8;
+static const uint32_t kIndexTailCRCLength = 4096;
+
+//---------------------------------------------
+//  nsZipArchive::GetIndexSidecarFile
+//---------------------------------------------
+nsresult nsZipArchive::GetIndexSidecarFile(nsIFile **aResult)
+{
+  *aResult = nullptr;
+
+  // Only plain file-backed archives have a sidecar; memory-backed handles
+  // and archives nested in other archives don't.
+  if (!mFd || !mFd->mFile || mFd->mFile.IsZip())
+    return NS_ERROR_NOT_AVAILABLE;
+
+  nsCOMPtr<nsIFile> base = mFd->mFile.GetBaseFile();
+  if (!base)
+    return NS_ERROR_NOT_AVAILABLE;
+
+  nsCOMPtr<nsIFile> sidecar;
+  nsresult rv = base->Clone(getter_AddRefs(sidecar));
+  if (NS_FAILED(rv))
+    return rv;
+
+  nsAutoCString leafName;
+  rv = sidecar->GetNativeLeafName(leafName);
+  if (NS_FAILED(rv))
+    return rv;
+  leafName.AppendLiteral(".idx");
+  rv = sidecar->SetNativeLeafName(leafName);
+  if (NS_FAILED(rv))
+    return rv;
+
+  sidecar.forget(aResult);
+  return NS_OK;
+}
+
+//---------------------------------------------
+//  nsZipArchive::ReadIndexSidecar
+//---------------------------------------------
+nsresult nsZipArchive::ReadIndexSidecar(nsIFile *aSidecarFile)
+{
+  mozilla::AutoFDClose fd;
+  nsresult rv = aSidecarFile->OpenNSPRFileDesc(PR_RDONLY, 0000, &fd.rwget());
+  if (NS_FAILED(rv))
+    return rv;
+
+  int64_t size = PR_Available64(fd);
+  if (size < int64_t(kIndexSidecarHeaderSize) ||
+      size > int64_t(kIndexSidecarHeaderSize) +
+             int64_t(mFd->mLen / ZIPCENTRAL_SIZE) * kIndexSidecarEntrySize)
+    return NS_ERROR_FAILURE;
+
+  auto sidecar = MakeUnique<uint8_t[]>(size_t(size));
+  if (PR_Read(fd, sidecar.get(), int32_t(size)) != int32_t(size))
+    return NS_ERROR_FAILURE;
+
+  const uint8_t* buf = sidecar.get();
+  if (xtolong(buf) != kIndexSidecarMagic)
+    return NS_ERROR_FAILURE;
+  if (xtolong(buf + 4) != mFd->mLen)
+    return NS_ERROR_FAILURE; // stale: archive was rewritten
+
+MOZ_WIN_MEM_TRY_BEGIN
+  uint32_t tailLength =
+    mFd->mLen < kIndexTailCRCLength ? mFd->mLen : kIndexTailCRCLength;
+  uint32_t tailCRC = crc32(crc32(0L, Z_NULL, 0),
+                           mFd->mFileData + (mFd->mLen - tailLength),
+                           tailLength);
+  if (xtolong(buf + 8) != tailCRC)
+    return NS_ERROR_FAILURE; // stale
+MOZ_WIN_MEM_TRY_CATCH(return NS_ERROR_FAILURE)
+
+  uint32_t commentOffset = xtolong(buf + 12);
+  uint32_t commentLen = xtolong(buf + 16);
+  uint32_t entryCount = xtolong(buf + 20);
+
+  if (uint64_t(size) != kIndexSidecarHeaderSize +
+                        uint64_t(entryCount) * kIndexSidecarEntrySize)
+    return NS_ERROR_FAILURE;
+
+  buf += kIndexSidecarHeaderSize;
+  for (uint32_t i = 0; i < entryCount; i++) {
+    uint32_t central = xtolong(buf);
+    uint16_t namelen = xtoint(buf + 4);
+    uint16_t bucket = xtoint(buf + 6);
+    buf += kIndexSidecarEntrySize;
+
+    if (bucket >= ZIP_TABSIZE ||
+        namelen < 1 || namelen > kMaxNameLength ||
+        central > mFd->mLen ||
+        mFd->mLen - central < uint32_t(ZIPCENTRAL_SIZE) + namelen) {
+      // Malformed sidecar; throw away whatever we built so the caller can
+      // fall back to a clean central directory scan.
+      mArena.Clear();
+      memset(mFiles, 0, sizeof(mFiles));
+      return NS_ERROR_FAILURE;
+    }
+
+    nsZipItem* item = CreateZipItem();
+    if (!item) {
+      mArena.Clear();
+      memset(mFiles, 0, sizeof(mFiles));
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+
+    item->central = (const ZipCentral*)(mFd->mFileData + central);
+    item->nameLength = namelen;
+    item->isSynthetic = false;
+
+    item->next = mFiles[bucket];
+    mFiles[bucket] = item;
+  }
+
+  if (commentLen && commentOffset <= mFd->mLen &&
+      mFd->mLen - commentOffset >= commentLen) {
+    mCommentPtr = (const char *)mFd->mFileData + commentOffset;
+    mCommentLen = uint16_t(commentLen);
+  }
+
+  return NS_OK;
+}
+
 //---------------------------------------------
 //  nsZipArchive::BuildSynthetics
 //---------------------------------------------
@@ -240,6 +240,20 @@ private:
   nsresult          BuildFileList(PRFileDesc *aFd = nullptr);
   nsresult          BuildSynthetics();
 
+  /**
+   * Returns the index sidecar file ("<archive>.idx") for the opened
+   * archive, or an error when the archive isn't backed by a plain file.
+   */
+  nsresult          GetIndexSidecarFile(nsIFile **aResult);
+
+  /**
+   * Populates mFiles from the index sidecar written at build time by
+   * config/optimize_jar_layout.py, skipping the central directory scan.
+   * Fails (and leaves the archive untouched) when the sidecar is missing,
+   * malformed or stale; the caller then falls back to BuildFileList.
+   */
+  nsresult          ReadIndexSidecar(nsIFile *aSidecarFile);
+
   nsZipArchive& operator=(const nsZipArchive& rhs) = delete;
   nsZipArchive(const nsZipArchive& rhs) = delete;
 };
@@ -15,6 +15,7 @@
 #include "mozilla/ResultExtensions.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/ServoStyleSet.h"
+#include "mozilla/StaticPtr.h"
 #include "mozilla/SyncRunnable.h"
 #include "mozilla/Telemetry.h"
 #include "mozilla/UniquePtrExtensions.h"
@@ -51,6 +52,7 @@
 #include "prefapi.h"
 #include "prefapi_private_data.h"
 #include "prefread.h"
+#include "SharedPrefMap.h"
 
 using namespace mozilla;
 
@@ -175,6 +177,12 @@ bool Preferences::sShutdown = false;
 // This globally enables or disables OMT pref writing, both sync and async.
 static int32_t sAllowOMTPrefWrite = -1;
 
+// The pref table snapshot most recently shared with a content process, and
+// the pref table generation it was built from. Rebuilt lazily when a content
+// process launches after prefs have changed.
+static StaticAutoPtr<SharedPrefMap> gSharedPrefMapSnapshot;
+static uint32_t gSharedPrefMapGeneration;
+
 class ValueObserverHashKey : public PLDHashEntryHdr
 {
 public:
@@ -761,6 +769,8 @@ Preferences::~Preferences()
 
   sPreferences = nullptr;
 
+  gSharedPrefMapSnapshot = nullptr;
+
   PREF_Cleanup();
 }
 
@@ -1090,6 +1100,40 @@ Preferences::GetPreferences(InfallibleTArray<PrefSetting>* aPrefs)
   }
 }
 
+/* static */ bool
+Preferences::GetSharedPrefMapHandle(base::ProcessId aProcessId,
+                                    ipc::SharedMemoryBasic::Handle* aHandle,
+                                    uint32_t* aSize)
+{
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  if (!gSharedPrefMapSnapshot ||
+      gSharedPrefMapGeneration != pref_GetPrefTableGeneration()) {
+    uint32_t generation = pref_GetPrefTableGeneration();
+    gSharedPrefMapSnapshot = SharedPrefMap::Create(gHashTable).release();
+    if (!gSharedPrefMapSnapshot) {
+      return false;
+    }
+    gSharedPrefMapGeneration = generation;
+  }
+
+  return gSharedPrefMapSnapshot->ShareToProcess(aProcessId, aHandle, aSize);
+}
+
+/* static */ void
+Preferences::SetSharedPrefMap(const ipc::SharedMemoryBasic::Handle& aHandle,
+                              uint32_t aSize)
+{
+  MOZ_ASSERT(XRE_IsContentProcess());
+
+  UniquePtr<SharedPrefMap> map = SharedPrefMap::Create(aHandle, aSize);
+  if (NS_WARN_IF(!map)) {
+    return;
+  }
+
+  pref_SetSharedPrefMap(Move(map));
+}
+
 #ifdef DEBUG
 void
 Preferences::SetInitPhase(pref_initPhase phase)
@@ -12,6 +12,7 @@
 #endif
 
 #include "mozilla/Atomics.h"
+#include "mozilla/ipc/SharedMemoryBasic.h"
 #include "mozilla/MemoryReporting.h"
 #include "nsCOMPtr.h"
 #include "nsIObserver.h"
@@ -327,6 +328,20 @@ public:
 
   static void SetInitPreferences(nsTArray<PrefSetting>* aPrefs);
 
+  // Shares a read-only shared-memory snapshot of the pref table with a
+  // content process, rebuilding it first if any pref has changed since it
+  // was last built (see SharedPrefMap.h). Returns false if the snapshot
+  // couldn't be built or shared, in which case the caller should fall back
+  // to GetPreferences(). Parent process only.
+  static bool GetSharedPrefMapHandle(base::ProcessId aProcessId,
+                                     ipc::SharedMemoryBasic::Handle* aHandle,
+                                     uint32_t* aSize);
+
+  // Maps the snapshot shared by the parent process and installs it as the
+  // fallback for pref lookups. Content process only.
+  static void SetSharedPrefMap(const ipc::SharedMemoryBasic::Handle& aHandle,
+                               uint32_t aSize);
+
 #ifdef DEBUG
   static void SetInitPhase(pref_initPhase phase);
   static pref_initPhase InitPhase();
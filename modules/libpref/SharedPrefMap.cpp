@@ -0,0 +1,237 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "SharedPrefMap.h"
+
+#include <string.h>
+
+#include "mozilla/BinarySearch.h"
+#include "nsTArray.h"
+#include "prefapi_private_data.h"
+
+namespace mozilla {
+
+namespace {
+
+// Orders PrefHashEntry pointers by preference name, for the sorted entry
+// table.
+class PrefNameComparator
+{
+public:
+  bool Equals(const PrefHashEntry* aA, const PrefHashEntry* aB) const
+  {
+    return strcmp(aA->mKey, aB->mKey) == 0;
+  }
+
+  bool LessThan(const PrefHashEntry* aA, const PrefHashEntry* aB) const
+  {
+    return strcmp(aA->mKey, aB->mKey) < 0;
+  }
+};
+
+} // namespace
+
+/* static */ UniquePtr<SharedPrefMap>
+SharedPrefMap::Create(PLDHashTable* aTable)
+{
+  nsTArray<PrefHashEntry*> prefs(aTable->EntryCount());
+  for (auto iter = aTable->Iter(); !iter.Done(); iter.Next()) {
+    auto entry = static_cast<PrefHashEntry*>(iter.Get());
+    if (pref_EntryHasAdvisablySizedValues(entry)) {
+      prefs.AppendElement(entry);
+    }
+  }
+  prefs.Sort(PrefNameComparator());
+
+  // Lay out the segment: header, sorted entry table, then the string block
+  // holding names and string values.
+  size_t stringSize = 0;
+  bool hasLockedPrefs = false;
+  for (PrefHashEntry* pref : prefs) {
+    stringSize += strlen(pref->mKey) + 1;
+    if (pref->mPrefFlags.IsTypeString()) {
+      if (pref->mPrefFlags.HasDefault()) {
+        stringSize += strlen(pref->mDefaultPref.mStringVal) + 1;
+      }
+      if (pref->mPrefFlags.HasUserValue()) {
+        stringSize += strlen(pref->mUserPref.mStringVal) + 1;
+      }
+    }
+    if (pref->mPrefFlags.IsLocked()) {
+      hasLockedPrefs = true;
+    }
+  }
+
+  size_t size =
+    sizeof(Header) + prefs.Length() * sizeof(Entry) + stringSize;
+
+  RefPtr<ipc::SharedMemoryBasic> mem = new ipc::SharedMemoryBasic();
+  if (!mem->Create(size) || !mem->Map(size)) {
+    return nullptr;
+  }
+
+  auto base = static_cast<char*>(mem->memory());
+  auto header = reinterpret_cast<Header*>(base);
+  header->mMagic = kMagic;
+  header->mFlags = hasLockedPrefs ? kHeaderHasLockedPrefs : 0;
+  header->mEntryCount = prefs.Length();
+  header->mSize = size;
+
+  auto entries = reinterpret_cast<Entry*>(base + sizeof(Header));
+  uint32_t stringOffset =
+    sizeof(Header) + prefs.Length() * sizeof(Entry);
+
+  auto appendString = [&](const char* aString) {
+    uint32_t offset = stringOffset;
+    size_t len = strlen(aString) + 1;
+    memcpy(base + offset, aString, len);
+    stringOffset += len;
+    return offset;
+  };
+
+  for (size_t i = 0; i < prefs.Length(); i++) {
+    PrefHashEntry* pref = prefs[i];
+    Entry& entry = entries[i];
+
+    entry.mNameOffset = appendString(pref->mKey);
+
+    entry.mFlags = uint32_t(pref->mPrefFlags.GetPrefType());
+    if (pref->mPrefFlags.HasDefault()) {
+      entry.mFlags |= kEntryHasDefault;
+    }
+    if (pref->mPrefFlags.HasStickyDefault()) {
+      entry.mFlags |= kEntryHasStickyDefault;
+    }
+    if (pref->mPrefFlags.HasUserValue()) {
+      entry.mFlags |= kEntryHasUserValue;
+    }
+    if (pref->mPrefFlags.IsLocked()) {
+      entry.mFlags |= kEntryLocked;
+    }
+
+    entry.mDefaultValue = 0;
+    entry.mUserValue = 0;
+    if (pref->mPrefFlags.IsTypeString()) {
+      if (pref->mPrefFlags.HasDefault()) {
+        entry.mDefaultValue = appendString(pref->mDefaultPref.mStringVal);
+      }
+      if (pref->mPrefFlags.HasUserValue()) {
+        entry.mUserValue = appendString(pref->mUserPref.mStringVal);
+      }
+    } else {
+      if (pref->mPrefFlags.HasDefault()) {
+        entry.mDefaultValue = uint32_t(pref->mDefaultPref.mIntVal);
+      }
+      if (pref->mPrefFlags.HasUserValue()) {
+        entry.mUserValue = uint32_t(pref->mUserPref.mIntVal);
+      }
+    }
+  }
+
+  MOZ_ASSERT(stringOffset == size, "string block size mismatch");
+
+  return UniquePtr<SharedPrefMap>(new SharedPrefMap(mem.forget()));
+}
+
+/* static */ UniquePtr<SharedPrefMap>
+SharedPrefMap::Create(const ipc::SharedMemoryBasic::Handle& aHandle,
+                      size_t aSize)
+{
+  if (aSize < sizeof(Header)) {
+    return nullptr;
+  }
+
+  RefPtr<ipc::SharedMemoryBasic> mem = new ipc::SharedMemoryBasic();
+  if (!mem->SetHandle(aHandle, ipc::SharedMemory::RightsReadOnly) ||
+      !mem->Map(aSize)) {
+    return nullptr;
+  }
+
+  // The parent process is trusted, so only sanity-check the header.
+  auto header = static_cast<const Header*>(mem->memory());
+  if (header->mMagic != kMagic || header->mSize != aSize ||
+      sizeof(Header) + header->mEntryCount * sizeof(Entry) > aSize) {
+    return nullptr;
+  }
+
+  return UniquePtr<SharedPrefMap>(new SharedPrefMap(mem.forget()));
+}
+
+uint32_t
+SharedPrefMap::EntryCount() const
+{
+  return GetHeader()->mEntryCount;
+}
+
+bool
+SharedPrefMap::HasLockedPrefs() const
+{
+  return GetHeader()->mFlags & kHeaderHasLockedPrefs;
+}
+
+void
+SharedPrefMap::FillPref(const Entry& aEntry, Pref* aResult) const
+{
+  aResult->mName = EntryName(aEntry);
+  aResult->mType = PrefType(aEntry.mFlags & kEntryTypeMask);
+  aResult->mHasDefault = aEntry.mFlags & kEntryHasDefault;
+  aResult->mHasStickyDefault = aEntry.mFlags & kEntryHasStickyDefault;
+  aResult->mHasUserValue = aEntry.mFlags & kEntryHasUserValue;
+  aResult->mLocked = aEntry.mFlags & kEntryLocked;
+
+  if (aResult->mType == PrefType::String) {
+    aResult->mDefaultValue.mStringVal =
+      aResult->mHasDefault ? const_cast<char*>(Base() + aEntry.mDefaultValue)
+                           : nullptr;
+    aResult->mUserValue.mStringVal =
+      aResult->mHasUserValue ? const_cast<char*>(Base() + aEntry.mUserValue)
+                             : nullptr;
+  } else {
+    aResult->mDefaultValue.mIntVal = int32_t(aEntry.mDefaultValue);
+    aResult->mUserValue.mIntVal = int32_t(aEntry.mUserValue);
+  }
+}
+
+bool
+SharedPrefMap::Get(const char* aName, Pref* aResult) const
+{
+  const Entry* entries = Entries();
+
+  size_t index;
+  bool found = BinarySearchIf(
+    entries,
+    0,
+    EntryCount(),
+    [=](const Entry& aEntry) { return strcmp(aName, EntryName(aEntry)); },
+    &index);
+  if (!found) {
+    return false;
+  }
+
+  FillPref(entries[index], aResult);
+  return true;
+}
+
+void
+SharedPrefMap::GetAt(uint32_t aIndex, Pref* aResult) const
+{
+  MOZ_ASSERT(aIndex < EntryCount());
+  FillPref(Entries()[aIndex], aResult);
+}
+
+bool
+SharedPrefMap::ShareToProcess(base::ProcessId aProcessId,
+                              ipc::SharedMemoryBasic::Handle* aHandle,
+                              uint32_t* aSize) const
+{
+  if (!mMem->ShareToProcess(aProcessId, aHandle)) {
+    return false;
+  }
+  *aSize = GetHeader()->mSize;
+  return true;
+}
+
+} // namespace mozilla
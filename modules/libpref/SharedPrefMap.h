@@ -0,0 +1,153 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SharedPrefMap_h
+#define SharedPrefMap_h
+
+#include "mozilla/AlreadyAddRefed.h"
+#include "mozilla/RefPtr.h"
+#include "mozilla/UniquePtr.h"
+#include "mozilla/ipc/SharedMemoryBasic.h"
+#include "prefapi.h"
+
+class PLDHashTable;
+
+namespace mozilla {
+
+/**
+ * An immutable snapshot of the preference hashtable, stored in a single
+ * shared memory segment.
+ *
+ * The parent process serializes its hashtable into a segment with
+ * Create(PLDHashTable*) and hands each content process a handle to it, so
+ * that the ~10k preferences present at child startup are mapped instead of
+ * being shipped over IPC and copied into a per-process hashtable. Content
+ * processes open the segment with Create(Handle, size) and consult it
+ * directly on hashtable misses; only preferences that are subsequently
+ * written, updated by the parent, or returned by lookup are materialized
+ * into the child's hashtable (see pref_HashTableLookup).
+ *
+ * The segment layout is:
+ *
+ *   Header  - magic, flags, entry count, total size
+ *   Entry[] - sorted by preference name, so lookup is a binary search;
+ *             each entry holds the name offset, the type and value flags,
+ *             and the default and user values. Int and bool values are
+ *             stored inline; string values are offsets into the string
+ *             block.
+ *   strings - NUL-terminated names and string values
+ *
+ * All offsets are relative to the start of the segment. Once shared, the
+ * segment is never modified; preferences that change in the parent after
+ * the snapshot was built are delivered through the usual IPC paths.
+ */
+class SharedPrefMap
+{
+public:
+  // A view of one snapshot entry. Name and string values point into the
+  // mapping and must be copied if they need to outlive it.
+  struct Pref
+  {
+    const char* mName;
+    PrefType mType;
+    bool mHasDefault;
+    bool mHasStickyDefault;
+    bool mHasUserValue;
+    bool mLocked;
+    PrefValue mDefaultValue;
+    PrefValue mUserValue;
+  };
+
+  // Builds a snapshot of aTable in the parent process. Entries with
+  // unadvisably large string values are omitted, as they are from the
+  // PrefSetting arrays this replaces. Returns null on failure.
+  static UniquePtr<SharedPrefMap> Create(PLDHashTable* aTable);
+
+  // Maps an existing snapshot in a content process. Returns null if the
+  // handle cannot be mapped or the contents are malformed.
+  static UniquePtr<SharedPrefMap> Create(
+    const ipc::SharedMemoryBasic::Handle& aHandle, size_t aSize);
+
+  uint32_t EntryCount() const;
+
+  // Looks up aName and fills aResult. Returns false if not present.
+  bool Get(const char* aName, Pref* aResult) const;
+
+  // Fills aResult with the entry at aIndex, for full enumeration.
+  void GetAt(uint32_t aIndex, Pref* aResult) const;
+
+  // True if any snapshot entry is locked, so the child can prime the
+  // gIsAnyPrefLocked fast path.
+  bool HasLockedPrefs() const;
+
+  // Duplicates the segment's handle into aProcessId, for transport in
+  // XPCOMInitData.
+  bool ShareToProcess(base::ProcessId aProcessId,
+                      ipc::SharedMemoryBasic::Handle* aHandle,
+                      uint32_t* aSize) const;
+
+private:
+  struct Header
+  {
+    uint32_t mMagic;
+    uint32_t mFlags;
+    uint32_t mEntryCount;
+    uint32_t mSize;
+  };
+
+  struct Entry
+  {
+    uint32_t mNameOffset;
+    uint32_t mFlags;
+    uint32_t mDefaultValue;
+    uint32_t mUserValue;
+  };
+
+  static const uint32_t kMagic = 0x70726566; // 'pref'
+
+  // Header flags.
+  static const uint32_t kHeaderHasLockedPrefs = 1 << 0;
+
+  // Entry flags. The low two bits hold the PrefType.
+  static const uint32_t kEntryTypeMask = 0x3;
+  static const uint32_t kEntryHasDefault = 1 << 2;
+  static const uint32_t kEntryHasStickyDefault = 1 << 3;
+  static const uint32_t kEntryHasUserValue = 1 << 4;
+  static const uint32_t kEntryLocked = 1 << 5;
+
+  explicit SharedPrefMap(already_AddRefed<ipc::SharedMemoryBasic> aMem)
+    : mMem(aMem)
+  {
+  }
+
+  const char* Base() const
+  {
+    return static_cast<const char*>(mMem->memory());
+  }
+
+  const Header* GetHeader() const
+  {
+    return reinterpret_cast<const Header*>(Base());
+  }
+
+  const Entry* Entries() const
+  {
+    return reinterpret_cast<const Entry*>(Base() + sizeof(Header));
+  }
+
+  const char* EntryName(const Entry& aEntry) const
+  {
+    return Base() + aEntry.mNameOffset;
+  }
+
+  void FillPref(const Entry& aEntry, Pref* aResult) const;
+
+  RefPtr<ipc::SharedMemoryBasic> mMem;
+};
+
+} // namespace mozilla
+
+#endif // SharedPrefMap_h
@@ -753,6 +753,10 @@ nsPrefBranch::GetChildList(const char* aStartingAt,
   // This will contain a list of all the pref name strings. Allocated on the
   // stack for speed.
 
+  // The walk below only sees the hashtable, so pull in any prefs that still
+  // only exist in the shared snapshot first.
+  pref_EnsureSnapshotPrefsAdded();
+
   const PrefName& parent = GetPrefName(aStartingAt);
   size_t parentLen = parent.Length();
   for (auto iter = gHashTable->Iter(); !iter.Done(); iter.Next()) {
@@ -15,6 +15,9 @@
 #include "mozilla/Logging.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ServoStyleSet.h"
+#include "mozilla/StaticMutex.h"
+#include "mozilla/StaticPtr.h"
+#include "SharedPrefMap.h"
 #include "nsCRT.h"
 #include "nsPrintfCString.h"
 #include "nsQuickSort.h"
@@ -91,6 +94,19 @@ static CallbackNode* gLastPriorityNode = nullptr;
 
 static bool gIsAnyPrefLocked = false;
 
+// In content processes, an immutable snapshot of the parent's pref table,
+// consulted when a pref has no hashtable entry. See SharedPrefMap.h.
+static StaticAutoPtr<SharedPrefMap> gSharedPrefMap;
+
+// Orders materializing snapshot prefs into the hashtable. Off-main-thread
+// lookups only happen during the Servo traversal, which blocks the main
+// thread, so this only has to order traversal threads against each other.
+static StaticMutex gSharedPrefMapLock;
+
+// Bumped whenever the hashtable's contents change, so the parent process can
+// tell when a previously built snapshot has gone stale.
+static uint32_t gPrefTableGeneration = 0;
+
 // These are only used during the call to pref_DoCallback.
 static bool gCallbacksInProgress = false;
 static bool gShouldCleanupDeadNodes = false;
@@ -199,6 +215,7 @@ PREF_CleanupPrefs()
     gHashTable = nullptr;
     gPrefNameArena.Clear();
   }
+  gSharedPrefMap = nullptr;
 }
 
 // Note that this appends to aResult, and does not assign!
@@ -589,6 +606,9 @@ PREF_DeleteBranch(const char* aBranchName)
     branch_dot += '.';
   }
 
+  // Deleting a branch must cover prefs that only exist in the snapshot.
+  pref_EnsureSnapshotPrefsAdded();
+
   // Delete a branch. Used for deleting mime types.
   const char* to_delete = branch_dot.get();
   MOZ_ASSERT(to_delete);
@@ -605,6 +625,7 @@ PREF_DeleteBranch(const char* aBranchName)
     }
   }
 
+  gPrefTableGeneration++;
   MakeDirtyCallback();
   return NS_OK;
 }
@@ -623,6 +644,7 @@ PREF_ClearUserPref(const char* aPrefName)
     if (!pref->mPrefFlags.HasDefault()) {
       gHashTable->RemoveEntry(pref);
     }
+    gPrefTableGeneration++;
 
     pref_DoCallback(aPrefName);
     MakeDirtyCallback();
@@ -639,6 +661,9 @@ PREF_ClearAllUserPrefs()
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+  // The snapshot can hold user values this process hasn't looked at yet.
+  pref_EnsureSnapshotPrefsAdded();
+
   std::vector<std::string> prefStrings;
   for (auto iter = gHashTable->Iter(); !iter.Done(); iter.Next()) {
     auto pref = static_cast<PrefHashEntry*>(iter.Get());
@@ -657,6 +682,10 @@ PREF_ClearAllUserPrefs()
     pref_DoCallback(prefString.c_str());
   }
 
+  if (!prefStrings.empty()) {
+    gPrefTableGeneration++;
+  }
+
   MakeDirtyCallback();
   return NS_OK;
 }
@@ -677,10 +706,12 @@ PREF_LockPref(const char* aKey, bool aLockIt)
     if (!pref->mPrefFlags.IsLocked()) {
       pref->mPrefFlags.SetLocked(true);
       gIsAnyPrefLocked = true;
+      gPrefTableGeneration++;
       pref_DoCallback(aKey);
     }
   } else if (pref->mPrefFlags.IsLocked()) {
     pref->mPrefFlags.SetLocked(false);
+    gPrefTableGeneration++;
     pref_DoCallback(aKey);
   }
 
@@ -744,6 +775,119 @@ pref_SetValue(PrefValue* aExistingValue,
   return aFlags;
 }
 
+// Overwrites an entry's flags and values with a snapshot pref's. The entry's
+// current flags must still describe its current values, so that existing
+// string values get freed.
+static void
+pref_FillEntryFromSnapshot(PrefHashEntry* aPref,
+                           const SharedPrefMap::Pref& aSnapshotPref)
+{
+  if (aSnapshotPref.mHasDefault) {
+    aPref->mPrefFlags = pref_SetValue(&aPref->mDefaultPref,
+                                      aPref->mPrefFlags,
+                                      aSnapshotPref.mDefaultValue,
+                                      aSnapshotPref.mType)
+                          .SetHasDefault(true);
+  }
+  aPref->mPrefFlags.SetHasStickyDefault(aSnapshotPref.mHasStickyDefault);
+
+  if (aSnapshotPref.mHasUserValue) {
+    aPref->mPrefFlags = pref_SetValue(&aPref->mUserPref,
+                                      aPref->mPrefFlags,
+                                      aSnapshotPref.mUserValue,
+                                      aSnapshotPref.mType)
+                          .SetHasUserValue(true);
+  } else if (aPref->mPrefFlags.HasUserValue()) {
+    if (aPref->mPrefFlags.IsTypeString() && aPref->mUserPref.mStringVal) {
+      PL_strfree(aPref->mUserPref.mStringVal);
+      aPref->mUserPref.mStringVal = nullptr;
+    }
+    aPref->mPrefFlags.SetHasUserValue(false);
+  }
+
+  aPref->mPrefFlags.SetLocked(aSnapshotPref.mLocked);
+}
+
+// Creates a hashtable entry for a pref that so far only exists in the shared
+// snapshot, copying its type, flags and values. Returns null if the snapshot
+// doesn't contain the pref either. No callbacks fire and the prefs file isn't
+// dirtied, since this mirrors parent state rather than changing anything.
+static PrefHashEntry*
+pref_MaterializeSnapshotPref(const char* aKey)
+{
+  SharedPrefMap::Pref snapshotPref;
+  if (!gSharedPrefMap->Get(aKey, &snapshotPref)) {
+    return nullptr;
+  }
+
+  auto pref = static_cast<PrefHashEntry*>(gHashTable->Add(aKey, fallible));
+  if (!pref) {
+    return nullptr;
+  }
+  MOZ_ASSERT(!pref->mKey, "materializing a pref that already has an entry");
+
+  pref->mPrefFlags.Reset().SetPrefType(snapshotPref.mType);
+  pref->mKey = ArenaStrdup(aKey, gPrefNameArena);
+  memset(&pref->mDefaultPref, 0, sizeof(pref->mDefaultPref));
+  memset(&pref->mUserPref, 0, sizeof(pref->mUserPref));
+
+  pref_FillEntryFromSnapshot(pref, snapshotPref);
+  return pref;
+}
+
+void
+pref_SetSharedPrefMap(UniquePtr<SharedPrefMap> aMap)
+{
+  MOZ_ASSERT(XRE_IsContentProcess());
+  MOZ_ASSERT(!gSharedPrefMap, "shared pref snapshot already installed");
+
+  gSharedPrefMap = aMap.release();
+
+  // The early prefs arrived on the command line with their effective value
+  // collapsed into the default slot. Replace those entries with the
+  // snapshot's full default/user split, the way applying the serialized
+  // pref array used to.
+  if (gHashTable) {
+    for (auto iter = gHashTable->Iter(); !iter.Done(); iter.Next()) {
+      auto pref = static_cast<PrefHashEntry*>(iter.Get());
+      SharedPrefMap::Pref snapshotPref;
+      if (gSharedPrefMap->Get(pref->mKey, &snapshotPref)) {
+        pref_FillEntryFromSnapshot(pref, snapshotPref);
+      }
+    }
+  }
+
+  // Locked prefs are looked up lazily like any others, so prime the
+  // "anything at all is locked" fast path here.
+  if (gSharedPrefMap->HasLockedPrefs()) {
+    gIsAnyPrefLocked = true;
+  }
+}
+
+void
+pref_EnsureSnapshotPrefsAdded()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!gSharedPrefMap || !gHashTable) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < gSharedPrefMap->EntryCount(); i++) {
+    SharedPrefMap::Pref snapshotPref;
+    gSharedPrefMap->GetAt(i, &snapshotPref);
+    if (!gHashTable->Search(snapshotPref.mName)) {
+      pref_MaterializeSnapshotPref(snapshotPref.mName);
+    }
+  }
+}
+
+uint32_t
+pref_GetPrefTableGeneration()
+{
+  return gPrefTableGeneration;
+}
+
 #ifdef DEBUG
 static pref_initPhase gPhase = START;
 
@@ -805,7 +949,18 @@ pref_HashTableLookup(const char* aKey)
   }
 #endif
 
-  return static_cast<PrefHashEntry*>(gHashTable->Search(aKey));
+  auto result = static_cast<PrefHashEntry*>(gHashTable->Search(aKey));
+  if (!result && gSharedPrefMap) {
+    // Prefs that this process has never touched have no hashtable entry;
+    // fault them in from the snapshot on first use.
+    StaticMutexAutoLock lock(gSharedPrefMapLock);
+    result = static_cast<PrefHashEntry*>(gHashTable->Search(aKey));
+    if (!result) {
+      result = pref_MaterializeSnapshotPref(aKey);
+    }
+  }
+
+  return result;
 }
 
 nsresult
@@ -820,6 +975,12 @@ pref_HashPref(const char* aKey,
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
+  if (gSharedPrefMap && !gHashTable->Search(aKey)) {
+    // Materialize any snapshot entry first, so that setting a pref doesn't
+    // discard the default value the snapshot holds for it.
+    pref_MaterializeSnapshotPref(aKey);
+  }
+
   auto pref = static_cast<PrefHashEntry*>(gHashTable->Add(aKey, fallible));
   if (!pref) {
     return NS_ERROR_OUT_OF_MEMORY;
@@ -832,6 +993,7 @@ pref_HashPref(const char* aKey,
     pref->mKey = ArenaStrdup(aKey, gPrefNameArena);
     memset(&pref->mDefaultPref, 0, sizeof(pref->mDefaultPref));
     memset(&pref->mUserPref, 0, sizeof(pref->mUserPref));
+    gPrefTableGeneration++;
 
   } else if (pref->mPrefFlags.HasDefault() &&
              !pref->mPrefFlags.IsPrefType(aType)) {
@@ -853,6 +1015,7 @@ pref_HashPref(const char* aKey,
         pref->mPrefFlags =
           pref_SetValue(&pref->mDefaultPref, pref->mPrefFlags, aValue, aType)
             .SetHasDefault(true);
+        gPrefTableGeneration++;
         if (aFlags & kPrefStickyDefault) {
           pref->mPrefFlags.SetHasStickyDefault(true);
         }
@@ -874,6 +1037,7 @@ pref_HashPref(const char* aKey,
       if (pref->mPrefFlags.HasUserValue()) {
         // XXX should we free a user-set string value if there is one?
         pref->mPrefFlags.SetHasUserValue(false);
+        gPrefTableGeneration++;
         if (!pref->mPrefFlags.IsLocked()) {
           MakeDirtyCallback();
           valueChanged = true;
@@ -885,6 +1049,7 @@ pref_HashPref(const char* aKey,
       pref->mPrefFlags =
         pref_SetValue(&pref->mUserPref, pref->mPrefFlags, aValue, aType)
           .SetHasUserValue(true);
+      gPrefTableGeneration++;
       if (!pref->mPrefFlags.IsLocked()) {
         MakeDirtyCallback();
         valueChanged = true;
@@ -16,6 +16,7 @@
 extern PLDHashTable* gHashTable;
 
 namespace mozilla {
+class SharedPrefMap;
 namespace dom {
 class PrefSetting;
 } // namespace dom
@@ -43,6 +44,21 @@ pref_SetWatchingPref(bool aWatching);
 PrefHashEntry*
 pref_HashTableLookup(const char* aKey);
 
+// Installs the parent process's shared pref snapshot in a content process.
+// Must be called before any prefs it covers are looked up.
+void
+pref_SetSharedPrefMap(mozilla::UniquePtr<mozilla::SharedPrefMap> aMap);
+
+// Materializes every snapshot pref into the hashtable, for callers that
+// enumerate gHashTable directly. A no-op without a snapshot installed.
+void
+pref_EnsureSnapshotPrefsAdded();
+
+// Returns a counter that's bumped whenever the hashtable changes, used by the
+// parent process to detect stale snapshots.
+uint32_t
+pref_GetPrefTableGeneration();
+
 bool
 pref_EntryHasAdvisablySizedValues(PrefHashEntry* aHashEntry);
 
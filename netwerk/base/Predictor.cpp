@@ -14,6 +14,7 @@
 #include "nsICancelable.h"
 #include "nsIChannel.h"
 #include "nsContentUtils.h"
+#include "nsHashKeys.h"
 #include "nsIDNSService.h"
 #include "nsIDocument.h"
 #include "nsIFile.h"
@@ -34,6 +35,7 @@
 #include "nsServiceManagerUtils.h"
 #include "nsStreamUtils.h"
 #include "nsString.h"
+#include "nsTHashtable.h"
 #include "nsThreadUtils.h"
 #include "mozilla/Logging.h"
 
@@ -1091,7 +1093,11 @@ Predictor::PredictForPageload(nsICacheEntry *entry, nsIURI *targetURI,
   nsCOMPtr<nsIURI> redirectURI;
   if (WouldRedirect(entry, loadCount, lastLoad, globalDegradation,
                     getter_AddRefs(redirectURI))) {
-    mPreconnects.AppendElement(redirectURI);
+    Preconnect *preconnect = mPreconnects.AppendElement();
+    preconnect->mUri = redirectURI;
+    // A likely redirect target is as close to a sure thing as predictions
+    // get, so make sure it's connected before any subresource origin.
+    preconnect->mConfidence = 100;
     Predictor::Reason reason;
     reason.mPredict = nsINetworkPredictor::PREDICT_LOAD;
     RefPtr<Predictor::Action> redirectAction =
@@ -1374,7 +1380,9 @@ Predictor::SetupPrediction(int32_t confidence, uint32_t flags, const nsCString &
     rv = NS_NewURI(getter_AddRefs(preconnectURI), uri, nullptr, nullptr,
                    mIOService);
     if (NS_SUCCEEDED(rv)) {
-      mPreconnects.AppendElement(preconnectURI);
+      Preconnect *preconnect = mPreconnects.AppendElement();
+      preconnect->mUri = preconnectURI;
+      preconnect->mConfidence = confidence;
     }
   } else if (confidence >= mPreresolveMinConfidence) {
     nsCOMPtr<nsIURI> preresolveURI;
@@ -1461,11 +1469,18 @@ Predictor::RunPredictions(nsIURI *referrer,
   bool predicted = false;
   uint32_t len, i;
 
-  nsTArray<nsCOMPtr<nsIURI>> prefetches, preconnects, preresolves;
+  nsTArray<nsCOMPtr<nsIURI>> prefetches, preresolves;
+  nsTArray<Preconnect> preconnects;
   prefetches.SwapElements(mPrefetches);
   preconnects.SwapElements(mPreconnects);
   preresolves.SwapElements(mPreresolves);
 
+  // Connect the most confidently predicted origins first. Once the parallel
+  // speculative connect limit is reached the remaining connects degrade to a
+  // DNS lookup, so the order decides which origins get the full TCP and TLS
+  // handshake warmed up and parked in the idle pool.
+  preconnects.Sort(PreconnectSorter());
+
   Telemetry::AutoCounter<Telemetry::PREDICTOR_TOTAL_PREDICTIONS> totalPredictions;
   Telemetry::AutoCounter<Telemetry::PREDICTOR_TOTAL_PREFETCHES> totalPrefetches;
   Telemetry::AutoCounter<Telemetry::PREDICTOR_TOTAL_PRECONNECTS> totalPreconnects;
@@ -1483,15 +1498,25 @@ Predictor::RunPredictions(nsIURI *referrer,
     }
   }
 
+  // Several predicted subresources frequently share an origin, and one
+  // speculative connect per origin is enough to warm it up. Skipping the
+  // duplicates leaves the speculative connect slots to the other origins.
+  nsTHashtable<nsCStringHashKey> preconnectedOrigins;
+
   len = preconnects.Length();
   for (i = 0; i < len; ++i) {
     PREDICTOR_LOG(("    doing preconnect"));
-    nsCOMPtr<nsIURI> uri = preconnects[i];
+    nsCOMPtr<nsIURI> uri = preconnects[i].mUri;
     ++totalPredictions;
     ++totalPreconnects;
-    nsCOMPtr<nsIPrincipal> principal =
-      BasePrincipal::CreateCodebasePrincipal(uri, originAttributes);
-    mSpeculativeService->SpeculativeConnect2(uri, principal, this);
+    nsAutoCString origin;
+    if (NS_SUCCEEDED(nsContentUtils::GetASCIIOrigin(uri, origin)) &&
+        !preconnectedOrigins.Contains(origin)) {
+      preconnectedOrigins.PutEntry(origin);
+      nsCOMPtr<nsIPrincipal> principal =
+        BasePrincipal::CreateCodebasePrincipal(uri, originAttributes);
+      mSpeculativeService->SpeculativeConnect2(uri, principal, this);
+    }
     predicted = true;
     if (verifier) {
       PREDICTOR_LOG(("    sending preconnect verification"));
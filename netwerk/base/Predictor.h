@@ -478,8 +478,31 @@ private:
 
   RefPtr<DNSListener> mDNSListener;
 
+  // A speculative connect candidate, remembered together with the confidence
+  // its prediction was made with. Preconnects run in descending confidence
+  // order, so when more origins are predicted than the parallel speculative
+  // connect limit allows, the most likely ones get the full TCP and TLS
+  // handshake and the rest degrade to a DNS warm-up.
+  struct Preconnect {
+    nsCOMPtr<nsIURI> mUri;
+    int32_t mConfidence;
+  };
+
+  class PreconnectSorter {
+  public:
+    bool Equals(const Preconnect &a, const Preconnect &b) const
+    {
+      return a.mConfidence == b.mConfidence;
+    }
+    bool LessThan(const Preconnect &a, const Preconnect &b) const
+    {
+      // Descending order of confidence.
+      return a.mConfidence > b.mConfidence;
+    }
+  };
+
   nsTArray<nsCOMPtr<nsIURI>> mPrefetches;
-  nsTArray<nsCOMPtr<nsIURI>> mPreconnects;
+  nsTArray<Preconnect> mPreconnects;
   nsTArray<nsCOMPtr<nsIURI>> mPreresolves;
 
   bool mDoingTests;
@@ -19,6 +19,7 @@
 #include "nsFileStreams.h"
 #include "nsIFile.h"
 #include "nsReadLine.h"
+#include "nsStreamUtils.h"
 #include "nsIClassInfoImpl.h"
 #include "mozilla/ipc/InputStreamUtils.h"
 #include "mozilla/Unused.h"
@@ -690,6 +691,209 @@ nsFileInputStream::Clone(nsIInputStream** aResult)
                                       mBehaviorFlags);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// nsMemoryMappedInputStream
+
+NS_IMPL_ISUPPORTS(nsMemoryMappedInputStream,
+                  nsIInputStream,
+                  nsIMemoryMappedInputStream,
+                  nsISeekableStream)
+
+nsresult
+nsMemoryMappedInputStream::Create(nsISupports *aOuter, REFNSIID aIID,
+                                  void **aResult)
+{
+    NS_ENSURE_NO_AGGREGATION(aOuter);
+
+    nsMemoryMappedInputStream* stream = new nsMemoryMappedInputStream();
+    NS_ADDREF(stream);
+    nsresult rv = stream->QueryInterface(aIID, aResult);
+    NS_RELEASE(stream);
+    return rv;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Init(nsIFile* aFile)
+{
+    NS_ENSURE_ARG(aFile);
+    NS_ENSURE_TRUE(!mFD, NS_ERROR_ALREADY_INITIALIZED);
+
+    nsresult rv = aFile->OpenNSPRFileDesc(PR_RDONLY, 0, &mFD);
+    if (NS_FAILED(rv)) {
+        return rv;
+    }
+
+    PRFileInfo64 info;
+    if (PR_GetOpenFileInfo64(mFD, &info) == PR_FAILURE) {
+        Close();
+        return NS_BASE_STREAM_OSERROR;
+    }
+
+    // PR_MemMap() addresses the mapping with a 32-bit length.
+    if (uint64_t(info.size) > UINT32_MAX) {
+        Close();
+        return NS_ERROR_FILE_TOO_BIG;
+    }
+
+    mSize = uint64_t(info.size);
+    mPos = 0;
+
+    // A zero length file cannot be mapped, but it makes a perfectly fine
+    // stream; every read just returns end-of-file.
+    if (mSize == 0) {
+        return NS_OK;
+    }
+
+    mFileMap = PR_CreateFileMap(mFD, info.size, PR_PROT_READONLY);
+    if (!mFileMap) {
+        Close();
+        return NS_ERROR_FAILURE;
+    }
+
+    // Bug 525755: PR_MemMap fails when the descriptor points at something
+    // other than a normal file.
+    mBuffer = (char*) PR_MemMap(mFileMap, 0, (uint32_t) mSize);
+    if (!mBuffer) {
+        Close();
+        return NS_ERROR_FAILURE;
+    }
+
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Close()
+{
+    if (mBuffer) {
+        PR_MemUnmap(mBuffer, (uint32_t) mSize);
+        mBuffer = nullptr;
+    }
+    if (mFileMap) {
+        PR_CloseFileMap(mFileMap);
+        mFileMap = nullptr;
+    }
+    if (mFD) {
+        PR_Close(mFD);
+        mFD = nullptr;
+    }
+    mSize = 0;
+    mPos = 0;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Available(uint64_t* aResult)
+{
+    if (!mFD) {
+        return NS_BASE_STREAM_CLOSED;
+    }
+    *aResult = mSize - mPos;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Read(char* aBuf, uint32_t aCount, uint32_t* _retval)
+{
+    return ReadSegments(NS_CopySegmentToBuffer, aBuf, aCount, _retval);
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::ReadSegments(nsWriteSegmentFun aWriter,
+                                        void* aClosure, uint32_t aCount,
+                                        uint32_t* _retval)
+{
+    *_retval = 0;
+
+    if (!mFD) {
+        return NS_BASE_STREAM_CLOSED;
+    }
+
+    // Hand the writer function the mapping directly.  Unlike a file
+    // descriptor based stream, the whole remainder of the file is one
+    // contiguous segment.
+    uint32_t count = uint32_t(std::min<uint64_t>(aCount, mSize - mPos));
+    while (count > 0) {
+        uint32_t written = 0;
+        nsresult rv = aWriter(this, aClosure, mBuffer + mPos, *_retval,
+                              count, &written);
+
+        // As defined in nsIInputStream.idl, writer function errors are not
+        // propagated to the caller of ReadSegments.
+        if (NS_FAILED(rv) || written == 0) {
+            break;
+        }
+
+        mPos += written;
+        *_retval += written;
+        count -= written;
+    }
+
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::IsNonBlocking(bool* _retval)
+{
+    // The mapping is always "available"; reads never block on I/O in the
+    // nsIAsyncInputStream sense even though touching the pages may fault.
+    *_retval = true;
+    return NS_OK;
+}
+
+NS_IMETHODIMP_(char*)
+nsMemoryMappedInputStream::Segment(uint64_t* aLength)
+{
+    *aLength = mSize;
+    return mBuffer;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Seek(int32_t aWhence, int64_t aOffset)
+{
+    if (!mFD) {
+        return NS_BASE_STREAM_CLOSED;
+    }
+
+    int64_t newPos;
+    switch (aWhence) {
+        case NS_SEEK_SET:
+            newPos = aOffset;
+            break;
+        case NS_SEEK_CUR:
+            newPos = int64_t(mPos) + aOffset;
+            break;
+        case NS_SEEK_END:
+            newPos = int64_t(mSize) + aOffset;
+            break;
+        default:
+            return NS_ERROR_INVALID_ARG;
+    }
+
+    if (newPos < 0 || uint64_t(newPos) > mSize) {
+        return NS_ERROR_INVALID_ARG;
+    }
+
+    mPos = uint64_t(newPos);
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::Tell(int64_t* aResult)
+{
+    if (!mFD) {
+        return NS_BASE_STREAM_CLOSED;
+    }
+    *aResult = int64_t(mPos);
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsMemoryMappedInputStream::SetEOF()
+{
+    // The mapping is read-only.
+    return NS_ERROR_NOT_IMPLEMENTED;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // nsFileOutputStream
 
@@ -20,6 +20,7 @@
 #include "nsReadLine.h"
 #include <algorithm>
 
+struct PRFileMap;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -195,6 +196,53 @@ protected:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * An input stream backed by a read-only memory mapping of a local file.
+ * Unlike nsFileInputStream there is no file descriptor read path; the
+ * whole file is mapped at Init() time and ReadSegments() exposes the
+ * mapping to the writer function directly, so no data is copied unless
+ * the consumer itself copies.
+ */
+class nsMemoryMappedInputStream : public nsIMemoryMappedInputStream,
+                                  public nsISeekableStream
+{
+public:
+    NS_DECL_THREADSAFE_ISUPPORTS
+    NS_DECL_NSIINPUTSTREAM
+    NS_DECL_NSIMEMORYMAPPEDINPUTSTREAM
+    NS_DECL_NSISEEKABLESTREAM
+
+    nsMemoryMappedInputStream()
+        : mFD(nullptr), mFileMap(nullptr), mBuffer(nullptr), mSize(0), mPos(0)
+    {}
+
+    static nsresult
+    Create(nsISupports *aOuter, REFNSIID aIID, void **aResult);
+
+protected:
+    virtual ~nsMemoryMappedInputStream()
+    {
+        Close();
+    }
+
+    /**
+     * The file descriptor backing the mapping.  NSPR requires it to stay
+     * open for the lifetime of the map on some platforms, so it is kept
+     * until Close().
+     */
+    PRFileDesc* mFD;
+    PRFileMap* mFileMap;
+    char* mBuffer;
+    uint64_t mSize;
+
+    /**
+     * The current read position inside the mapping.  Always <= mSize.
+     */
+    uint64_t mPos;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class nsFileOutputStream : public nsFileStreamBase,
                            public nsIFileOutputStream
 {
@@ -727,8 +727,13 @@ nsInputStreamPump::CreateBufferedStreamIfNeeded()
     return NS_OK;
   }
 
+  // Match the buffer to the segment size the pump was configured with, so
+  // that consumers of large transfers refill in correspondingly large
+  // chunks instead of 4K at a time; 4096 remains the floor for the
+  // default-configured case.
+  uint32_t bufferSize = std::max<uint32_t>(4096, mSegSize);
   nsresult rv = NS_NewBufferedInputStream(getter_AddRefs(mBufferedStream),
-                                          mAsyncStream, 4096);
+                                          mAsyncStream, bufferSize);
   NS_ENSURE_SUCCESS(rv, rv);
 
   return NS_OK;
@@ -110,6 +110,21 @@ NS_NewLocalFileInputStream(nsIInputStream **result,
     return rv;
 }
 
+nsresult
+NS_NewMemoryMappedInputStream(nsIInputStream **result,
+                              nsIFile         *file)
+{
+    nsresult rv;
+    nsCOMPtr<nsIMemoryMappedInputStream> in =
+        do_CreateInstance(NS_MEMORYMAPPEDINPUTSTREAM_CONTRACTID, &rv);
+    if (NS_SUCCEEDED(rv)) {
+        rv = in->Init(file);
+        if (NS_SUCCEEDED(rv))
+            in.forget(result);
+    }
+    return rv;
+}
+
 nsresult
 NS_NewLocalFileOutputStream(nsIOutputStream **result,
                             nsIFile          *file,
@@ -484,6 +484,14 @@ nsresult NS_NewLocalFileInputStream(nsIInputStream **result,
                                     int32_t          perm          = -1,
                                     int32_t          behaviorFlags = 0);
 
+// Returns an input stream backed by a read-only memory mapping of the
+// file.  The stream can be QI'ed to nsIMemoryMappedInputStream to reach
+// the mapping itself.  Fails for anything that cannot be mapped (e.g.
+// pipes or character devices); callers should fall back to
+// NS_NewLocalFileInputStream in that case.
+nsresult NS_NewMemoryMappedInputStream(nsIInputStream **result,
+                                       nsIFile         *file);
+
 nsresult NS_NewLocalFileOutputStream(nsIOutputStream **result,
                                      nsIFile          *file,
                                      int32_t           ioFlags       = -1,
@@ -447,36 +447,35 @@ nsSocketTransportService::GrowIdleList()
     return true;
 }
 
+/* static */ uint32_t
+nsSocketTransportService::SecondsToNextTimeout(const SocketContext &sock)
+{
+    // mPollTimeout could be less than mElapsedTime if setTimeout
+    // was called with a value smaller than mElapsedTime.
+    return (sock.mElapsedTime < sock.mHandler->mPollTimeout)
+      ? sock.mHandler->mPollTimeout - sock.mElapsedTime
+      : 0;
+}
+
 PRIntervalTime
-nsSocketTransportService::PollTimeout()
+nsSocketTransportService::PollTimeout(uint32_t aSecondsToNextTimeout)
 {
     if (mActiveCount == 0)
         return NS_SOCKET_POLL_TIMEOUT;
 
-    // compute minimum time before any socket timeout expires.
-    uint32_t minR = UINT16_MAX;
-    for (uint32_t i=0; i<mActiveCount; ++i) {
-        const SocketContext &s = mActiveList[i];
-        // mPollTimeout could be less than mElapsedTime if setTimeout
-        // was called with a value smaller than mElapsedTime.
-        uint32_t r = (s.mElapsedTime < s.mHandler->mPollTimeout)
-          ? s.mHandler->mPollTimeout - s.mElapsedTime
-          : 0;
-        if (r < minR)
-            minR = r;
-    }
     // nsASocketHandler defines UINT16_MAX as do not timeout
-    if (minR == UINT16_MAX) {
+    if (aSecondsToNextTimeout == UINT16_MAX) {
         SOCKET_LOG(("poll timeout: none\n"));
         return NS_SOCKET_POLL_TIMEOUT;
     }
-    SOCKET_LOG(("poll timeout: %" PRIu32 "\n", minR));
-    return PR_SecondsToInterval(minR);
+    SOCKET_LOG(("poll timeout: %" PRIu32 "\n", aSecondsToNextTimeout));
+    return PR_SecondsToInterval(aSecondsToNextTimeout);
 }
 
 int32_t
 nsSocketTransportService::Poll(uint32_t *interval,
-                               TimeDuration *pollDuration)
+                               TimeDuration *pollDuration,
+                               uint32_t secondsToNextTimeout)
 {
     PRPollDesc *pollList;
     uint32_t pollCount;
@@ -492,7 +491,8 @@ nsSocketTransportService::Poll(uint32_t *interval,
         mPollList[0].out_flags = 0;
         pollList = mPollList;
         pollCount = mActiveCount + 1;
-        pollTimeout = pendingEvents ? PR_INTERVAL_NO_WAIT : PollTimeout();
+        pollTimeout = pendingEvents ? PR_INTERVAL_NO_WAIT
+                                    : PollTimeout(secondsToNextTimeout);
     }
     else {
         // no pollable event, so busy wait...
@@ -1114,6 +1114,12 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
     // should become active.  take care to check only idle sockets that
     // were idle to begin with ;-)
     //
+    // While walking the lists, compute the minimum time before any socket
+    // timeout expires.  We're touching every active handler here anyway, so
+    // folding this in saves a second walk over the active list per poll
+    // iteration (see PollTimeout).
+    uint32_t secondsToNextTimeout = UINT16_MAX;
+
     count = mIdleCount;
     for (i=mActiveCount-1; i>=0; --i) {
         //---
@@ -1132,6 +1138,9 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
                 // update poll flags
                 mPollList[i+1].in_flags = in_flags;
                 mPollList[i+1].out_flags = 0;
+                uint32_t r = SecondsToNextTimeout(mActiveList[i]);
+                if (r < secondsToNextTimeout)
+                    secondsToNextTimeout = r;
             }
         }
     }
@@ -1144,8 +1153,12 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
         //---
         if (NS_FAILED(mIdleList[i].mHandler->mCondition))
             DetachSocket(mIdleList, &mIdleList[i]);
-        else if (mIdleList[i].mHandler->mPollFlags != 0)
+        else if (mIdleList[i].mHandler->mPollFlags != 0) {
+            uint32_t r = SecondsToNextTimeout(mIdleList[i]);
+            if (r < secondsToNextTimeout)
+                secondsToNextTimeout = r;
             MoveToPollList(&mIdleList[i]);
+        }
     }
 
     SOCKET_LOG(("  calling PR_Poll [active=%u idle=%u]\n", mActiveCount, mIdleCount));
@@ -1167,7 +1180,7 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
 #if defined(XP_WIN)
         StartPolling();
 #endif
-        n = Poll(&pollInterval, pollDuration);
+        n = Poll(&pollInterval, pollDuration, secondsToNextTimeout);
 #if defined(XP_WIN)
         EndPolling();
 #endif
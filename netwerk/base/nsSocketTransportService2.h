@@ -182,6 +182,10 @@ private:
         uint16_t          mElapsedTime;  // time elapsed w/o activity
     };
 
+    // seconds before sock's socket timeout expires, or UINT16_MAX if it
+    // does not time out.
+    static uint32_t SecondsToNextTimeout(const SocketContext &sock);
+
     SocketContext *mActiveList;                   /* mListSize entries */
     SocketContext *mIdleList;                     /* mListSize entries */
     nsIThread     *mRawThread;
@@ -215,11 +219,17 @@ private:
 
     PRPollDesc *mPollList;                        /* mListSize + 1 entries */
 
-    PRIntervalTime PollTimeout();            // computes ideal poll timeout
+    PRIntervalTime PollTimeout(uint32_t aSecondsToNextTimeout);
+                                             // computes ideal poll timeout
+                                             // from the min seconds until a
+                                             // socket timeout expires, as
+                                             // gathered by DoPollIteration's
+                                             // active list walk.
     nsresult       DoPollIteration(TimeDuration *pollDuration);
                                              // perfoms a single poll iteration
     int32_t        Poll(uint32_t *interval,
-                        TimeDuration *pollDuration);
+                        TimeDuration *pollDuration,
+                        uint32_t secondsToNextTimeout);
                                              // calls PR_Poll.  the out param
                                              // interval indicates the poll
                                              // duration in seconds.
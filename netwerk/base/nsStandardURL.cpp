@@ -1043,16 +1043,27 @@ nsStandardURL::BuildNormalizedSpec(const char *spec,
         }
     }
 
+    uint32_t specLen = i;
     if (mDirectory.mLen > 1) {
-        netCoalesceFlags coalesceFlag = NET_COALESCE_NORMAL;
-        if (SegmentIs(buf,mScheme,"ftp")) {
-            coalesceFlag = (netCoalesceFlags) (coalesceFlag
-                                        | NET_COALESCE_ALLOW_RELATIVE_ROOT
-                                        | NET_COALESCE_DOUBLE_SLASH_IS_ROOT);
+        // net_CoalesceDirs() only rewrites the buffer if the filepath holds a
+        // "." (part of a "/./" or "/../" sequence) or a "%" (a "%2E" encoded
+        // dot). Let memchr rule that out cheaply before walking the whole
+        // path character by character and re-measuring the result.
+        const char *filepath = buf + mDirectory.mPos;
+        size_t filepathLen = mFilepath.mPos + mFilepath.mLen - mDirectory.mPos;
+        if (memchr(filepath, '.', filepathLen) ||
+            memchr(filepath, '%', filepathLen)) {
+            netCoalesceFlags coalesceFlag = NET_COALESCE_NORMAL;
+            if (SegmentIs(buf,mScheme,"ftp")) {
+                coalesceFlag = (netCoalesceFlags) (coalesceFlag
+                                            | NET_COALESCE_ALLOW_RELATIVE_ROOT
+                                            | NET_COALESCE_DOUBLE_SLASH_IS_ROOT);
+            }
+            CoalescePath(coalesceFlag, buf + mDirectory.mPos);
+            specLen = strlen(buf);
         }
-        CoalescePath(coalesceFlag, buf + mDirectory.mPos);
     }
-    mSpec.SetLength(strlen(buf));
+    mSpec.SetLength(specLen);
     NS_ASSERTION(mSpec.Length() <= approxLen, "We've overflowed the mSpec buffer!");
     return NS_OK;
 }
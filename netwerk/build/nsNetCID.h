@@ -371,6 +371,16 @@
     {0xbb, 0x4a, 0x03, 0xc0, 0xd3, 0x02, 0x1b, 0xd6} \
 }
 
+#define NS_MEMORYMAPPEDINPUTSTREAM_CONTRACTID \
+    "@mozilla.org/network/memory-mapped-input-stream;1"
+#define NS_MEMORYMAPPEDINPUTSTREAM_CID               \
+{ /* e9516713-d97f-4d94-a5d6-70c2b7871c93 */         \
+    0xe9516713,                                      \
+    0xd97f,                                          \
+    0x4d94,                                          \
+    {0xa5, 0xd6, 0x70, 0xc2, 0xb7, 0x87, 0x1c, 0x93} \
+}
+
 #define NS_LOCALFILEINPUTSTREAM_CONTRACTID \
     "@mozilla.org/network/file-input-stream;1"
 #define NS_LOCALFILEINPUTSTREAM_CID                  \
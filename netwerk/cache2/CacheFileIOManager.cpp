@@ -124,6 +124,7 @@ CacheFileHandle::CacheFileHandle(const SHA1Sum::Hash *aHash, bool aPriority, Pin
   , mPinning(aPinning)
   , mFileSize(-1)
   , mFD(nullptr)
+  , mFDPosition(-1)
 {
   // If we initialize mDoomed in the initialization list, that initialization is
   // not guaranteeded to be atomic.  Whereas this assignment here is guaranteed
@@ -148,6 +149,7 @@ CacheFileHandle::CacheFileHandle(const nsACString &aKey, bool aPriority, Pinning
   , mPinning(aPinning)
   , mFileSize(-1)
   , mFD(nullptr)
+  , mFDPosition(-1)
   , mKey(aKey)
 {
   // See comment above about the initialization of mIsDoomed.
@@ -1995,15 +1997,21 @@ CacheFileIOManager::ReadInternal(CacheFileHandle *aHandle, int64_t aOffset,
     return NS_ERROR_NOT_AVAILABLE;
   }
 
-  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
-  if (offset == -1) {
-    return NS_ERROR_FAILURE;
+  if (aOffset != aHandle->mFDPosition) {
+    aHandle->mFDPosition = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
+    if (aHandle->mFDPosition == -1) {
+      return NS_ERROR_FAILURE;
+    }
   }
 
   int32_t bytesRead = PR_Read(aHandle->mFD, aBuf, aCount);
   if (bytesRead != aCount) {
+    // A short read leaves the offset somewhere in the middle of the
+    // requested range, force a seek before the next operation.
+    aHandle->mFDPosition = -1;
     return NS_ERROR_FAILURE;
   }
+  aHandle->mFDPosition += bytesRead;
 
   return NS_OK;
 }
@@ -2140,18 +2148,26 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
   // Write invalidates the entry by default
   aHandle->mInvalid = true;
 
-  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
-  if (offset == -1) {
-    return NS_ERROR_FAILURE;
+  if (aOffset != aHandle->mFDPosition) {
+    aHandle->mFDPosition = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
+    if (aHandle->mFDPosition == -1) {
+      return NS_ERROR_FAILURE;
+    }
   }
 
   int32_t bytesWritten = PR_Write(aHandle->mFD, aBuf, aCount);
 
-  if (bytesWritten != -1) {
+  if (bytesWritten == -1) {
+    aHandle->mFDPosition = -1;
+  } else {
+    aHandle->mFDPosition += bytesWritten;
+
     uint32_t oldSizeInK = aHandle->FileSizeInK();
     int64_t writeEnd = aOffset + bytesWritten;
 
     if (aTruncate) {
+      // On some platforms TruncFile() seeks, but it seeks to writeEnd which
+      // is where the offset already is after the write above.
       rv = TruncFile(aHandle->mFD, writeEnd);
       NS_ENSURE_SUCCESS(rv, rv);
 
@@ -2682,6 +2698,9 @@ CacheFileIOManager::TruncateSeekSetEOFInternal(CacheFileHandle *aHandle,
   // This operation always invalidates the entry
   aHandle->mInvalid = true;
 
+  // TruncFile() may move the file offset on some platforms.
+  aHandle->mFDPosition = -1;
+
   rv = TruncFile(aHandle->mFD, aTruncatePos);
   NS_ENSURE_SUCCESS(rv, rv);
 
@@ -4116,6 +4135,7 @@ CacheFileIOManager::OpenNSPRHandle(CacheFileHandle *aHandle, bool aCreate)
     NS_ENSURE_SUCCESS(rv, rv);
   }
 
+  aHandle->mFDPosition = 0;
   mHandlesByLastUsed.AppendElement(aHandle);
 
   LOG(("CacheFileIOManager::OpenNSPRHandle END, handle=%p", aHandle));
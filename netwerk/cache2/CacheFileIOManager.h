@@ -126,6 +126,12 @@ private:
   nsCOMPtr<nsIFile>    mFile;
   int64_t              mFileSize;
   PRFileDesc          *mFD;  // if null then the file doesn't exists on the disk
+  // Offset at which the next PR_Read/PR_Write on mFD takes place, or -1 when
+  // unknown. It allows ReadInternal/WriteInternal to elide the explicit seek
+  // when an operation continues at the current offset, which halves the
+  // number of syscalls for sequential chunk access. Accessed only on the IO
+  // thread.
+  int64_t              mFDPosition;
   nsCString            mKey;
 };
 
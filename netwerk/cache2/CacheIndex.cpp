@@ -27,6 +27,11 @@
 #define kMinUnwrittenChanges   300
 #define kMinDumpInterval       20000 // in milliseconds
 #define kMaxBufSize            16384
+// Limit for the read/write buffer used when reading or writing the index
+// file. The buffer is sized to process the whole file in one IO request when
+// possible since every buffer-sized chunk costs a round trip through the IO
+// thread event queue.
+#define kMaxRWBufSize          (4 * 1024 * 1024)
 #define kIndexVersion          0x00000005
 #define kUpdateIndexStartDelay 50000 // in milliseconds
 
@@ -1698,6 +1703,23 @@ CacheIndex::WriteIndexToDisk()
 
   mProcessEntries = mIndexStats.ActiveEntriesCount();
 
+  // Gather the entries to write up front so that WriteRecords() can continue
+  // where it left off instead of iterating the whole hashtable and skipping
+  // already written entries for every buffer-sized chunk, which is quadratic
+  // in the number of entries.
+  MOZ_ASSERT(mProcessEntriesArray.IsEmpty());
+  mProcessEntriesArray.SetCapacity(mProcessEntries);
+  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+    CacheIndexEntry* entry = iter.Get();
+    if (entry->IsRemoved() ||
+        !entry->IsInitialized() ||
+        entry->IsFileEmpty()) {
+      continue;
+    }
+    mProcessEntriesArray.AppendElement(entry);
+  }
+  MOZ_ASSERT(mProcessEntriesArray.Length() == mProcessEntries);
+
   mIndexFileOpener = new FileOpenHelper(this);
   rv = CacheFileIOManager::OpenFile(NS_LITERAL_CSTRING(TEMP_INDEX_NAME),
                                     CacheFileIOManager::SPECIAL_FILE |
@@ -1754,34 +1776,12 @@ CacheIndex::WriteRecords()
   uint32_t hashOffset = mRWBufPos;
 
   char* buf = mRWBuf + mRWBufPos;
-  uint32_t skip = mSkipEntries;
   uint32_t processMax = (mRWBufSize - mRWBufPos) / sizeof(CacheIndexRecord);
   MOZ_ASSERT(processMax != 0 || mProcessEntries == 0); // TODO make sure we can write an empty index
   uint32_t processed = 0;
-#ifdef DEBUG
-  bool hasMore = false;
-#endif
-  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
-    CacheIndexEntry* entry = iter.Get();
-    if (entry->IsRemoved() ||
-        !entry->IsInitialized() ||
-        entry->IsFileEmpty()) {
-      continue;
-    }
-
-    if (skip) {
-      skip--;
-      continue;
-    }
-
-    if (processed == processMax) {
-  #ifdef DEBUG
-      hasMore = true;
-  #endif
-      break;
-    }
-
-    entry->WriteToBuf(buf);
+  while (mSkipEntries + processed < mProcessEntriesArray.Length() &&
+         processed < processMax) {
+    mProcessEntriesArray[mSkipEntries + processed]->WriteToBuf(buf);
     buf += sizeof(CacheIndexRecord);
     processed++;
   }
@@ -1795,8 +1795,6 @@ CacheIndex::WriteRecords()
   mRWHash->Update(mRWBuf + hashOffset, mRWBufPos - hashOffset);
 
   if (mSkipEntries == mProcessEntries) {
-    MOZ_ASSERT(!hasMore);
-
     // We've processed all records
     if (mRWBufPos + sizeof(CacheHash::Hash32_t) > mRWBufSize) {
       // realloc buffer to spare another write cycle
@@ -1806,8 +1804,6 @@ CacheIndex::WriteRecords()
 
     NetworkEndian::writeUint32(mRWBuf + mRWBufPos, mRWHash->GetHash());
     mRWBufPos += sizeof(CacheHash::Hash32_t);
-  } else {
-    MOZ_ASSERT(hasMore);
   }
 
   rv = CacheFileIOManager::Write(mIndexHandle, fileOffset, mRWBuf, mRWBufPos,
@@ -1839,6 +1835,7 @@ CacheIndex::FinishWrite(bool aSucceeded)
   mIndexHandle = nullptr;
   mRWHash = nullptr;
   ReleaseBuffer();
+  mProcessEntriesArray.Clear();
 
   if (aSucceeded) {
     // Opening of the file must not be in progress if writing succeeded.
@@ -3338,13 +3335,24 @@ CacheIndex::AllocBuffer()
     case WRITING:
       mRWBufSize = sizeof(CacheIndexHeader) + sizeof(CacheHash::Hash32_t) +
                    mProcessEntries * sizeof(CacheIndexRecord);
-      if (mRWBufSize > kMaxBufSize) {
-        mRWBufSize = kMaxBufSize;
+      if (mRWBufSize > kMaxRWBufSize) {
+        mRWBufSize = kMaxRWBufSize;
       }
       break;
-    case READING:
-      mRWBufSize = kMaxBufSize;
+    case READING: {
+      MOZ_ASSERT(mIndexHandle);
+      int64_t fileSize = mIndexHandle->FileSize();
+      if (fileSize > kMaxRWBufSize) {
+        mRWBufSize = kMaxRWBufSize;
+      } else if (fileSize < kMaxBufSize) {
+        // The buffer is reused for reading the journal, so never allocate
+        // less than the old chunk size.
+        mRWBufSize = kMaxBufSize;
+      } else {
+        mRWBufSize = static_cast<uint32_t>(fileSize);
+      }
       break;
+    }
     default:
       MOZ_ASSERT(false, "Unexpected state!");
   }
@@ -3824,6 +3832,8 @@ CacheIndex::SizeOfExcludingThisInternal(mozilla::MallocSizeOf mallocSizeOf) cons
 
   // mFrecencyArray items are reported by mIndex/mPendingUpdates
   n += mFrecencyArray.mRecs.ShallowSizeOfExcludingThis(mallocSizeOf);
+  // mProcessEntriesArray items are reported by mIndex
+  n += mProcessEntriesArray.ShallowSizeOfExcludingThis(mallocSizeOf);
   n += mDiskConsumptionObservers.ShallowSizeOfExcludingThis(mallocSizeOf);
 
   return n;
@@ -1063,6 +1063,13 @@ private:
   // in hashtable that are initialized and are not marked as removed when writing
   // begins.
   uint32_t                  mProcessEntries;
+  // Entries that are being written to disk, gathered when writing begins.
+  // The pointers stay valid for the whole time of writing since mIndex is
+  // not modified during the WRITING state (changes go to mPendingUpdates).
+  // This allows WriteRecords() to continue where it left off instead of
+  // iterating the whole hashtable for every buffer-sized chunk. Cleared in
+  // FinishWrite().
+  nsTArray<CacheIndexEntry *> mProcessEntriesArray;
   char                     *mRWBuf;
   uint32_t                  mRWBufSize;
   uint32_t                  mRWBufPos;
@@ -2144,10 +2144,14 @@ nsCookieService::SetCookieStringInternal(nsIURI                 *aHostURI,
   nsCookieKey key(baseDomain, aOriginAttrs);
 
   // check default prefs
+  // CheckPrefs only consults the prior cookie count for third-party
+  // contexts, so don't pay for counting it on first-party loads.
   uint32_t priorCookieCount = 0;
-  nsAutoCString hostFromURI;
-  aHostURI->GetHost(hostFromURI);
-  CountCookiesFromHost(hostFromURI, &priorCookieCount);
+  if (aIsForeign) {
+    nsAutoCString hostFromURI;
+    aHostURI->GetHost(hostFromURI);
+    CountCookiesFromHost(hostFromURI, &priorCookieCount);
+  }
   CookieStatus cookieStatus = CheckPrefs(mPermissionService, mCookieBehavior,
                                          mThirdPartySession, aHostURI, aIsForeign,
                                          aCookieHeader.get(), priorCookieCount, aOriginAttrs);
@@ -3304,8 +3308,12 @@ nsCookieService::GetCookiesForURI(nsIURI *aHostURI,
   }
 
   // check default prefs
+  // CheckPrefs only consults the prior cookie count for third-party
+  // contexts, so don't pay for counting it on first-party loads.
   uint32_t priorCookieCount = 0;
-  CountCookiesFromHost(hostFromURI, &priorCookieCount);
+  if (aIsForeign) {
+    CountCookiesFromHost(hostFromURI, &priorCookieCount);
+  }
   CookieStatus cookieStatus = CheckPrefs(mPermissionService, mCookieBehavior,
                                          mThirdPartySession, aHostURI, aIsForeign,
                                          nullptr, priorCookieCount, aOriginAttrs);
@@ -3345,15 +3353,12 @@ nsCookieService::GetCookiesForURI(nsIURI *aHostURI,
   if (!entry)
     return;
 
-  // iterate the cookies!
+  // iterate the cookies!  do the cheap flag and expiry checks first, so the
+  // string comparisons only run for cookies that could actually be sent.
   const nsCookieEntry::ArrayType &cookies = entry->GetCookies();
   for (nsCookieEntry::IndexType i = 0; i < cookies.Length(); ++i) {
     cookie = cookies[i];
 
-    // check the host, since the base domain lookup is conservative.
-    if (!DomainMatches(cookie, hostFromURI))
-      continue;
-
     // if the cookie is secure and the host scheme isn't, we can't send it
     if (cookie->IsSecure() && !isSecure)
       continue;
@@ -3363,15 +3368,19 @@ nsCookieService::GetCookiesForURI(nsIURI *aHostURI,
     if (cookie->IsHttpOnly() && !aHttpBound)
       continue;
 
-    // if the nsIURI path doesn't match the cookie path, don't send it back
-    if (!PathMatches(cookie, pathFromURI))
-      continue;
-
     // check if the cookie has expired
     if (cookie->Expiry() <= currentTime) {
       continue;
     }
 
+    // check the host, since the base domain lookup is conservative.
+    if (!DomainMatches(cookie, hostFromURI))
+      continue;
+
+    // if the nsIURI path doesn't match the cookie path, don't send it back
+    if (!PathMatches(cookie, pathFromURI))
+      continue;
+
     // all checks passed - add to list and check if lastAccessed stamp needs updating
     aCookieList.AppendElement(cookie);
     if (cookie->IsStale()) {
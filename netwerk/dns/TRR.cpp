@@ -0,0 +1,349 @@
+/* vim:set ts=4 sw=4 sts=4 et cin: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "TRR.h"
+
+#include <algorithm>
+
+#include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Logging.h"
+#include "mozilla/net/DNS.h"
+#include "nsAutoPtr.h"
+#include "nsContentUtils.h"
+#include "nsHostResolver.h"
+#include "nsIHttpChannel.h"
+#include "nsIInputStream.h"
+#include "nsIUploadChannel2.h"
+#include "nsNetUtil.h"
+#include "nsStreamUtils.h"
+#include "nsStringStream.h"
+
+namespace mozilla {
+namespace net {
+
+static LazyLogModule gTRRLog("TRR");
+#undef LOG
+#define LOG(args) MOZ_LOG(gTRRLog, mozilla::LogLevel::Debug, args)
+
+// A DNS message carried over TCP or HTTP can't be larger than this, so
+// anything bigger is a broken or hostile server.
+static const uint32_t kMaxResponseSize = 0xffff;
+
+// Media type from draft-ietf-doh-dns-over-https
+#define DOH_CONTENT_TYPE "application/dns-udpwireformat"
+
+NS_IMPL_ISUPPORTS_INHERITED(TRR, Runnable, nsIStreamListener,
+                            nsIRequestObserver)
+
+TRR::TRR(nsHostResolver *aResolver, nsHostRecord *aRec,
+         const nsACString &aURI, TrrType aType)
+    : Runnable("mozilla::net::TRR")
+    , mHostResolver(aResolver)
+    , mRec(aRec)
+    , mURI(aURI)
+    , mType(aType)
+{
+}
+
+NS_IMETHODIMP
+TRR::Run()
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    nsresult rv = SendHTTPRequest();
+    if (NS_FAILED(rv)) {
+        LOG(("TRR for %s failed to send query: %" PRIx32 "\n",
+             mRec->host, static_cast<uint32_t>(rv)));
+        mHostResolver->CompleteLookupTRR(mRec, rv, nullptr);
+    }
+    return NS_OK;
+}
+
+nsresult
+TRR::SendHTTPRequest()
+{
+    nsAutoCString body;
+    nsresult rv = DohEncode(body);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsIURI> uri;
+    rv = NS_NewURI(getter_AddRefs(uri), mURI);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    // never talk to the resolver in the clear
+    bool isHttps = false;
+    rv = uri->SchemeIs("https", &isHttps);
+    if (NS_FAILED(rv) || !isHttps) {
+        return NS_ERROR_UNEXPECTED;
+    }
+
+    rv = NS_NewChannel(getter_AddRefs(mChannel),
+                       uri,
+                       nsContentUtils::GetSystemPrincipal(),
+                       nsILoadInfo::SEC_ALLOW_CROSS_ORIGIN_DATA_IS_NULL,
+                       nsIContentPolicy::TYPE_OTHER,
+                       nullptr, // aLoadGroup
+                       nullptr, // aCallbacks
+                       nsIRequest::LOAD_ANONYMOUS |
+                       nsIRequest::LOAD_BYPASS_CACHE |
+                       nsIRequest::INHIBIT_CACHING);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsIHttpChannel> httpChannel = do_QueryInterface(mChannel);
+    if (!httpChannel) {
+        return NS_ERROR_UNEXPECTED;
+    }
+
+    rv = httpChannel->SetRequestHeader(NS_LITERAL_CSTRING("Accept"),
+                                       NS_LITERAL_CSTRING(DOH_CONTENT_TYPE),
+                                       false);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsIInputStream> bodyStream;
+    rv = NS_NewCStringInputStream(getter_AddRefs(bodyStream), body);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsIUploadChannel2> uploadChannel = do_QueryInterface(httpChannel);
+    if (!uploadChannel) {
+        return NS_ERROR_UNEXPECTED;
+    }
+    rv = uploadChannel->ExplicitSetUploadStream(
+        bodyStream, NS_LITERAL_CSTRING(DOH_CONTENT_TYPE), body.Length(),
+        NS_LITERAL_CSTRING("POST"), false);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    return httpChannel->AsyncOpen2(this);
+}
+
+nsresult
+TRR::DohEncode(nsCString &aBody) const
+{
+    aBody.Truncate();
+
+    // header - a zero ID (connection oriented transports don't need one to
+    // match responses up), just the RD bit in the flags and one question
+    aBody += '\0';
+    aBody += '\0';     // ID
+    aBody += '\x01';   // |QR|   Opcode  |AA|TC|RD| - recursion desired
+    aBody += '\0';     // |RA|   Z    |   RCODE   |
+    aBody += '\0';
+    aBody += '\x01';   // QDCOUNT == 1
+    for (int i = 0; i < 6; ++i) {
+        aBody += '\0'; // ANCOUNT, NSCOUNT and ARCOUNT are all zero
+    }
+
+    // QNAME - the hostname as a sequence of length prefixed labels
+    nsDependentCString host(mRec->host);
+    int32_t offset = 0;
+    for (;;) {
+        int32_t dot = host.FindChar('.', offset);
+        int32_t labelLen =
+            ((dot == kNotFound) ? static_cast<int32_t>(host.Length()) : dot) -
+            offset;
+        if (labelLen <= 0 || labelLen > 63) {
+            return NS_ERROR_UNEXPECTED;
+        }
+        aBody += static_cast<char>(labelLen);
+        aBody.Append(Substring(host, offset, labelLen));
+        if (dot == kNotFound) {
+            break;
+        }
+        offset = dot + 1;
+        if (offset == static_cast<int32_t>(host.Length())) {
+            break; // trailing dot
+        }
+    }
+    aBody += '\0';     // root label terminates the name
+
+    aBody += '\0';
+    aBody += static_cast<char>(mType);  // QTYPE
+    aBody += '\0';
+    aBody += '\x01';   // QCLASS IN
+
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+TRR::OnStartRequest(nsIRequest *aRequest, nsISupports *aContext)
+{
+    LOG(("TRR::OnStartRequest %p %s\n", this, mRec->host));
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+TRR::OnDataAvailable(nsIRequest *aRequest, nsISupports *aContext,
+                     nsIInputStream *aInputStream, uint64_t aOffset,
+                     uint32_t aCount)
+{
+    if (mResponse.Length() + aCount > kMaxResponseSize) {
+        LOG(("TRR::OnDataAvailable %s answer too large\n", mRec->host));
+        return NS_ERROR_UNEXPECTED;
+    }
+    return NS_ConsumeStream(aInputStream, aCount, mResponse);
+}
+
+NS_IMETHODIMP
+TRR::OnStopRequest(nsIRequest *aRequest, nsISupports *aContext,
+                   nsresult aStatusCode)
+{
+    MOZ_ASSERT(NS_IsMainThread());
+    LOG(("TRR::OnStopRequest %p %s %" PRIx32 "\n", this, mRec->host,
+         static_cast<uint32_t>(aStatusCode)));
+
+    mChannel = nullptr;
+
+    nsresult rv = aStatusCode;
+    AddrInfo *ai = nullptr;
+    if (NS_SUCCEEDED(rv)) {
+        uint32_t httpStatus = 0;
+        nsCOMPtr<nsIHttpChannel> httpChannel = do_QueryInterface(aRequest);
+        if (httpChannel &&
+            NS_SUCCEEDED(httpChannel->GetResponseStatus(&httpStatus)) &&
+            httpStatus == 200) {
+            rv = DohDecode(&ai);
+        } else {
+            rv = NS_ERROR_UNEXPECTED;
+        }
+    }
+
+    mHostResolver->CompleteLookupTRR(mRec, rv, ai);
+    return NS_OK;
+}
+
+nsresult
+TRR::Get16(uint32_t aIndex, uint16_t *aResult) const
+{
+    if (aIndex + 2 > mResponse.Length()) {
+        return NS_ERROR_ILLEGAL_VALUE;
+    }
+    const uint8_t *b =
+        reinterpret_cast<const uint8_t *>(mResponse.BeginReading());
+    *aResult = (uint16_t(b[aIndex]) << 8) | uint16_t(b[aIndex + 1]);
+    return NS_OK;
+}
+
+nsresult
+TRR::Get32(uint32_t aIndex, uint32_t *aResult) const
+{
+    if (aIndex + 4 > mResponse.Length()) {
+        return NS_ERROR_ILLEGAL_VALUE;
+    }
+    const uint8_t *b =
+        reinterpret_cast<const uint8_t *>(mResponse.BeginReading());
+    *aResult = (uint32_t(b[aIndex]) << 24) | (uint32_t(b[aIndex + 1]) << 16) |
+               (uint32_t(b[aIndex + 2]) << 8) | uint32_t(b[aIndex + 3]);
+    return NS_OK;
+}
+
+nsresult
+TRR::DohDecode(AddrInfo **aResult) const
+{
+    *aResult = nullptr;
+
+    const uint8_t *packet =
+        reinterpret_cast<const uint8_t *>(mResponse.BeginReading());
+    uint32_t len = mResponse.Length();
+    if (len < 12) {
+        return NS_ERROR_ILLEGAL_VALUE;
+    }
+
+    uint16_t flags = 0, qdcount = 0, ancount = 0;
+    Get16(2, &flags);
+    Get16(4, &qdcount);
+    Get16(6, &ancount);
+
+    if (flags & 0x000f) { // RCODE != NOERROR
+        LOG(("TRR::DohDecode %s rcode %u\n", mRec->host, flags & 0x000f));
+        return NS_ERROR_UNKNOWN_HOST;
+    }
+
+    // skip the question section; the name in it is never compressed
+    uint32_t index = 12;
+    while (qdcount--) {
+        for (;;) {
+            if (index >= len) {
+                return NS_ERROR_ILLEGAL_VALUE;
+            }
+            uint8_t labelLen = packet[index++];
+            if (!labelLen) {
+                break;
+            }
+            index += labelLen;
+        }
+        index += 4; // QTYPE and QCLASS
+    }
+
+    nsAutoPtr<AddrInfo> ai(new AddrInfo(mRec->host, nullptr));
+    uint32_t minTtl = UINT32_MAX;
+
+    while (ancount--) {
+        // NAME - either a run of labels or (usually) a compression pointer
+        for (;;) {
+            if (index >= len) {
+                return NS_ERROR_ILLEGAL_VALUE;
+            }
+            uint8_t labelLen = packet[index];
+            if ((labelLen & 0xc0) == 0xc0) {
+                index += 2;
+                break;
+            }
+            index++;
+            if (!labelLen) {
+                break;
+            }
+            index += labelLen;
+        }
+
+        uint16_t rrtype = 0, rrclass = 0, rdlength = 0;
+        uint32_t rrttl = 0;
+        nsresult rv = Get16(index, &rrtype);
+        if (NS_FAILED(rv) ||
+            NS_FAILED(Get16(index + 2, &rrclass)) ||
+            NS_FAILED(Get32(index + 4, &rrttl)) ||
+            NS_FAILED(Get16(index + 8, &rdlength))) {
+            return NS_ERROR_ILLEGAL_VALUE;
+        }
+        index += 10;
+        if (index + rdlength > len) {
+            return NS_ERROR_ILLEGAL_VALUE;
+        }
+
+        if (rrclass == 1 /* IN */) {
+            PRNetAddr addr;
+            memset(&addr, 0, sizeof(addr));
+            if (rrtype == TRRTYPE_A && rdlength == 4) {
+                addr.inet.family = PR_AF_INET;
+                memcpy(&addr.inet.ip, packet + index, 4);
+                ai->AddAddress(new NetAddrElement(&addr));
+                minTtl = std::min(minTtl, rrttl);
+            } else if (rrtype == TRRTYPE_AAAA && rdlength == 16) {
+                addr.ipv6.family = PR_AF_INET6;
+                memcpy(&addr.ipv6.ip, packet + index, 16);
+                ai->AddAddress(new NetAddrElement(&addr));
+                minTtl = std::min(minTtl, rrttl);
+            }
+            // anything else in the answer section (CNAMEs etc) is skipped
+        }
+        index += rdlength;
+    }
+
+    if (ai->mAddresses.isEmpty()) {
+        return NS_ERROR_UNKNOWN_HOST;
+    }
+
+    if (minTtl != UINT32_MAX) {
+        ai->ttl = static_cast<uint16_t>(
+            std::min<uint32_t>(minTtl, AddrInfo::NO_TTL_DATA - 1));
+    }
+
+    LOG(("TRR::DohDecode %s got addresses, min ttl %u\n", mRec->host, minTtl));
+    *aResult = ai.forget();
+    return NS_OK;
+}
+
+#undef LOG
+
+} // namespace net
+} // namespace mozilla
@@ -0,0 +1,86 @@
+/* vim:set ts=4 sw=4 sts=4 et cin: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_net_TRR_h
+#define mozilla_net_TRR_h
+
+#include "nsCOMPtr.h"
+#include "nsIStreamListener.h"
+#include "nsString.h"
+#include "nsThreadUtils.h"
+
+class nsHostRecord;
+class nsHostResolver;
+class nsIChannel;
+
+namespace mozilla {
+namespace net {
+
+class AddrInfo;
+
+/**
+ * TRR - "trusted recursive resolver"
+ *
+ * A single DNS-over-HTTPS query: the DNS question in wire format is POSTed
+ * to the resolver URL given by the network.trr.uri pref and the answer
+ * section of the response is turned into an AddrInfo. Queries for the same
+ * server share one persistent HTTP/2 session, which is what makes this
+ * competitive with (and on congested paths faster than) UDP to the local
+ * resolver.
+ *
+ * Instances are created by nsHostResolver on any thread and then run on the
+ * main thread, where the channel must live. The result is handed back
+ * through nsHostResolver::CompleteLookupTRR(), which races it against the
+ * native getaddrinfo() lookup for the same record.
+ */
+class TRR final
+    : public Runnable
+    , public nsIStreamListener
+{
+public:
+    NS_DECL_ISUPPORTS_INHERITED
+    NS_DECL_NSIREQUESTOBSERVER
+    NS_DECL_NSISTREAMLISTENER
+
+    // DNS RR types we know how to query for.
+    enum TrrType {
+        TRRTYPE_A = 1,
+        TRRTYPE_AAAA = 28,
+    };
+
+    TRR(nsHostResolver *aResolver, nsHostRecord *aRec,
+        const nsACString &aURI, TrrType aType);
+
+    // main thread only; opens the channel
+    NS_IMETHOD Run() override;
+
+private:
+    ~TRR() = default;
+
+    nsresult SendHTTPRequest();
+
+    // serialize the DNS question in wire format (RFC 1035 section 4)
+    nsresult DohEncode(nsCString &aBody) const;
+
+    // parse the response message and turn its answer section into an
+    // AddrInfo, which the caller takes ownership of
+    nsresult DohDecode(AddrInfo **aResult) const;
+
+    // bounds checked big-endian readers for DohDecode()
+    nsresult Get16(uint32_t aIndex, uint16_t *aResult) const;
+    nsresult Get32(uint32_t aIndex, uint32_t *aResult) const;
+
+    RefPtr<nsHostResolver> mHostResolver;
+    RefPtr<nsHostRecord>   mRec;
+    nsCString              mURI;
+    TrrType                mType;
+    nsCOMPtr<nsIChannel>   mChannel;
+    nsCString              mResponse;
+};
+
+} // namespace net
+} // namespace mozilla
+
+#endif // mozilla_net_TRR_h
@@ -32,6 +32,14 @@
 #include "nsProxyRelease.h"
 #include "nsIObserverService.h"
 #include "nsINetworkLinkService.h"
+#include "nsIFile.h"
+#include "nsIInputStream.h"
+#include "nsIOutputStream.h"
+#include "nsILineInputStream.h"
+#include "nsISafeOutputStream.h"
+#include "nsNetUtil.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
 
 #include "mozilla/Attributes.h"
 #include "mozilla/net/NeckoCommon.h"
@@ -53,6 +61,18 @@ static const char kPrefDnsLocalDomains[]     = "network.dns.localDomains";
 static const char kPrefDnsForceResolve[]     = "network.dns.forceResolve";
 static const char kPrefDnsOfflineLocalhost[] = "network.dns.offline-localhost";
 static const char kPrefDnsNotifyResolution[] = "network.dns.notifyResolution";
+static const char kPrefDnsPrefetchFromSession[] = "network.dns.prefetchFromPreviousSession";
+
+// Hostnames with a positive, unexpired resolver cache entry at shutdown are
+// written to this file in the profile directory, one per line, and looked up
+// again speculatively at startup so the first navigations of a session don't
+// start with a cold DNS cache.
+#define SESSION_HOSTS_FILENAME "dnsSessionHosts.txt"
+
+// Upper bound on the number of hostnames persisted and warmed up, and on the
+// length of a hostname accepted when reading the file back.
+static const uint32_t kMaxSessionHosts = 100;
+static const uint32_t kMaxSessionHostLen = 253;
 
 //-----------------------------------------------------------------------------
 
@@ -477,6 +497,31 @@ private:
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+// Listener for the session warm-up lookups. The lookups are issued only to
+// populate the resolver cache, so the results are simply dropped.
+class SessionHostListener final : public nsIDNSListener
+{
+    ~SessionHostListener() = default;
+
+public:
+    NS_DECL_THREADSAFE_ISUPPORTS
+
+    NS_IMETHOD OnLookupComplete(nsICancelable *aRequest,
+                                nsIDNSRecord  *aRecord,
+                                nsresult       aStatus) override
+    {
+        return NS_OK;
+    }
+};
+
+NS_IMPL_ISUPPORTS(SessionHostListener, nsIDNSListener)
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
 nsDNSService::nsDNSService()
     : mLock("nsDNSServer.mLock")
     , mDisableIPv6(false)
@@ -485,6 +530,7 @@ nsDNSService::nsDNSService()
     , mNotifyResolution(false)
     , mOfflineLocalhost(false)
     , mForceResolveOn(false)
+    , mPrefetchFromSession(true)
 {
 }
 
@@ -546,6 +592,7 @@ nsDNSService::Init()
     bool     blockDotOnion    = true;
     int      proxyType        = nsIProtocolProxyService::PROXYCONFIG_DIRECT;
     bool     notifyResolution = false;
+    bool     prefetchFromSession = true;
 
     nsCString ipv4OnlyDomains;
     nsCString localDomains;
@@ -574,6 +621,7 @@ nsDNSService::Init()
         // If a manual proxy is in use, disable prefetch implicitly
         prefs->GetIntPref("network.proxy.type", &proxyType);
         prefs->GetBoolPref(kPrefDnsNotifyResolution, &notifyResolution);
+        prefs->GetBoolPref(kPrefDnsPrefetchFromSession, &prefetchFromSession);
 
         if (mFirstTime) {
             mFirstTime = false;
@@ -590,6 +638,12 @@ nsDNSService::Init()
             prefs->AddObserver(kPrefDisablePrefetch, this, false);
             prefs->AddObserver(kPrefBlockDotOnion, this, false);
             prefs->AddObserver(kPrefDnsNotifyResolution, this, false);
+            prefs->AddObserver(kPrefDnsPrefetchFromSession, this, false);
+
+            // The TRR prefs are read by nsHostResolver::Init(); observing
+            // them here makes a change rebuild the resolver.
+            prefs->AddObserver("network.trr.mode", this, false);
+            prefs->AddObserver("network.trr.uri", this, false);
 
             // Monitor these to see if there is a change in proxy configuration
             // If a manual proxy is in use, disable prefetch implicitly
@@ -638,10 +692,15 @@ nsDNSService::Init()
             }
         }
         mNotifyResolution = notifyResolution;
+        mPrefetchFromSession = prefetchFromSession;
     }
 
     RegisterWeakMemoryReporter(this);
 
+    if (NS_SUCCEEDED(rv) && mPrefetchFromSession && !mDisablePrefetch) {
+        PrefetchSessionHosts();
+    }
+
     return rv;
 }
 
@@ -657,6 +716,9 @@ nsDNSService::Shutdown()
         mResolver = nullptr;
     }
     if (res) {
+        if (mPrefetchFromSession && !mDisablePrefetch) {
+            SaveSessionHosts(res);
+        }
         res->Shutdown();
     }
 
@@ -670,6 +732,131 @@ nsDNSService::Shutdown()
     return NS_OK;
 }
 
+void
+nsDNSService::SaveSessionHosts(nsHostResolver *aResolver)
+{
+    nsCOMPtr<nsIFile> file;
+    nsresult rv = NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR,
+                                         getter_AddRefs(file));
+    if (NS_FAILED(rv))
+        return;
+    rv = file->AppendNative(NS_LITERAL_CSTRING(SESSION_HOSTS_FILENAME));
+    if (NS_FAILED(rv))
+        return;
+
+    nsTArray<DNSCacheEntries> entries;
+    aResolver->GetDNSCacheEntries(&entries);
+
+    nsTHashtable<nsCStringHashKey> seen;
+    nsAutoCString output;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < entries.Length() && count < kMaxSessionHosts;
+         ++i) {
+        const nsCString &host = entries[i].hostname;
+        if (host.IsEmpty() || host.Length() > kMaxSessionHostLen ||
+            seen.Contains(host)) {
+            continue;
+        }
+        seen.PutEntry(host);
+        output.Append(host);
+        output.Append('\n');
+        count++;
+    }
+
+    if (count == 0) {
+        // Don't leave a stale list from an earlier session behind.
+        file->Remove(false);
+        return;
+    }
+
+    nsCOMPtr<nsIOutputStream> out;
+    rv = NS_NewSafeLocalFileOutputStream(getter_AddRefs(out), file);
+    if (NS_FAILED(rv))
+        return;
+
+    uint32_t written;
+    rv = out->Write(output.get(), output.Length(), &written);
+    nsCOMPtr<nsISafeOutputStream> safeOut = do_QueryInterface(out);
+    if (NS_SUCCEEDED(rv) && written == output.Length() && safeOut) {
+        safeOut->Finish();
+    } else {
+        out->Close();
+    }
+}
+
+void
+nsDNSService::PrefetchSessionHosts()
+{
+    nsCOMPtr<nsIFile> file;
+    nsresult rv = NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR,
+                                         getter_AddRefs(file));
+    if (NS_FAILED(rv))
+        return;
+    rv = file->AppendNative(NS_LITERAL_CSTRING(SESSION_HOSTS_FILENAME));
+    if (NS_FAILED(rv))
+        return;
+
+    nsCOMPtr<nsIEventTarget> target =
+        do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID);
+    if (!target)
+        return;
+
+    // Read and parse the file off the main thread; the lookups themselves
+    // have to be issued on the main thread.
+    RefPtr<nsDNSService> self = this;
+    nsCOMPtr<nsIFile> hostsFile = file;
+    target->Dispatch(
+        NS_NewRunnableFunction("nsDNSService::PrefetchSessionHosts",
+                               [self, hostsFile]() {
+            nsCOMPtr<nsIInputStream> in;
+            if (NS_FAILED(NS_NewLocalFileInputStream(getter_AddRefs(in),
+                                                     hostsFile))) {
+                return;
+            }
+
+            nsCOMPtr<nsILineInputStream> lines = do_QueryInterface(in);
+            if (!lines)
+                return;
+
+            nsTArray<nsCString> hosts;
+            nsAutoCString line;
+            bool more = true;
+            while (more && hosts.Length() < kMaxSessionHosts) {
+                if (NS_FAILED(lines->ReadLine(line, &more)))
+                    break;
+                if (line.IsEmpty() || line.Length() > kMaxSessionHostLen)
+                    continue;
+                hosts.AppendElement(line);
+            }
+            if (hosts.IsEmpty())
+                return;
+
+            NS_DispatchToMainThread(
+                NS_NewRunnableFunction("nsDNSService::ResolveSessionHosts",
+                                       [self, hosts]() {
+                    self->ResolveSessionHosts(hosts);
+                }));
+        }),
+        NS_DISPATCH_NORMAL);
+}
+
+void
+nsDNSService::ResolveSessionHosts(const nsTArray<nsCString> &aHosts)
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    // The speculative flag makes these lookups respect the prefetch pref and
+    // keeps them from blocking the lookup queue; failures are of no interest.
+    nsCOMPtr<nsIDNSListener> listener = new SessionHostListener();
+    for (uint32_t i = 0; i < aHosts.Length(); ++i) {
+        nsCOMPtr<nsICancelable> cancelable;
+        AsyncResolveNative(aHosts[i],
+                           RESOLVE_SPECULATE | RESOLVE_PRIORITY_LOW,
+                           listener, nullptr, OriginAttributes(),
+                           getter_AddRefs(cancelable));
+    }
+}
+
 bool
 nsDNSService::GetOffline() const
 {
@@ -65,6 +65,19 @@ private:
                              const mozilla::OriginAttributes &aOriginAttributes,
                              nsIDNSRecord **result);
 
+    // Writes the hostnames of the positive, unexpired resolver cache entries
+    // to a file in the profile directory, so the next session can warm its
+    // cache. Only hostnames are stored, never addresses; see
+    // PrefetchSessionHosts().
+    void SaveSessionHosts(nsHostResolver *aResolver);
+
+    // Reads the hostname file written by SaveSessionHosts() on a background
+    // thread and issues a speculative, low priority lookup for each entry.
+    // Re-resolving instead of restoring addresses keeps TTLs honest across
+    // sessions.
+    void PrefetchSessionHosts();
+    void ResolveSessionHosts(const nsTArray<nsCString> &aHosts);
+
     RefPtr<nsHostResolver>  mResolver;
     nsCOMPtr<nsIIDNService>   mIDN;
 
@@ -83,6 +96,7 @@ private:
     bool                                      mNotifyResolution;
     bool                                      mOfflineLocalhost;
     bool                                      mForceResolveOn;
+    bool                                      mPrefetchFromSession;
     nsTHashtable<nsCStringHashKey>            mLocalDomains;
 };
 
@@ -27,8 +27,10 @@
 #include "PLDHashTable.h"
 #include "plstr.h"
 #include "nsURLHelper.h"
+#include "nsNetUtil.h"
 #include "nsThreadUtils.h"
 #include "GetAddrInfo.h"
+#include "TRR.h"
 #include "GeckoProfiler.h"
 
 #include "mozilla/HashFunctions.h"
@@ -172,6 +174,8 @@ nsHostRecord::nsHostRecord(const nsHostKey *key)
     , onQueue(false)
     , usingAnyThread(false)
     , mDoomed(false)
+    , mTrrInflight(false)
+    , mTrrSuccess(false)
 #if TTL_AVAILABLE
     , mGetTtl(false)
 #endif
@@ -524,6 +528,9 @@ static void DnsPrefChanged(const char* aPref, void* aClosure)
 }
 #endif
 
+static const char kPrefTrrMode[] = "network.trr.mode";
+static const char kPrefTrrUri[]  = "network.trr.uri";
+
 nsHostResolver::nsHostResolver(uint32_t maxCacheEntries,
                                uint32_t defaultCacheEntryLifetime,
                                uint32_t defaultGracePeriod)
@@ -534,6 +541,7 @@ nsHostResolver::nsHostResolver(uint32_t maxCacheEntries,
     , mIdleThreadCV(mLock, "nsHostResolver.mIdleThreadCV")
     , mDB(&gHostDB_ops, sizeof(nsHostDBEnt), 0)
     , mEvictionQSize(0)
+    , mTrrEnabled(false)
     , mShutdown(true)
     , mNumIdleThreads(0)
     , mThreadCount(0)
@@ -576,6 +584,25 @@ nsHostResolver::Init()
     }
 #endif
 
+    // Read the DNS-over-HTTPS configuration. Mode 1 races every eligible
+    // lookup against a query to the HTTPS resolver and the first answer
+    // wins; anything else leaves TRR off. Pref changes take effect when the
+    // DNS service reinitializes this object.
+    if (Preferences::GetInt(kPrefTrrMode, 0) == 1) {
+        nsAutoCString uri;
+        Preferences::GetCString(kPrefTrrUri, uri);
+        if (StringBeginsWith(uri, NS_LITERAL_CSTRING("https://"))) {
+            nsCOMPtr<nsIURI> trrURI;
+            if (NS_SUCCEEDED(NS_NewURI(getter_AddRefs(trrURI), uri)) &&
+                NS_SUCCEEDED(trrURI->GetAsciiHost(mTrrHost))) {
+                mTrrURI = uri;
+                mTrrEnabled = true;
+                LOG(("nsHostResolver::Init racing lookups against TRR [%s]",
+                     mTrrURI.get()));
+            }
+        }
+    }
+
 #if defined(HAVE_RES_NINIT)
     // We want to make sure the system is using the correct resolver settings,
     // so we force it to reload those settings whenever we startup a subsequent
@@ -1085,6 +1112,8 @@ nsHostResolver::IssueLookup(nsHostRecord *rec)
 
     rv = ConditionallyCreateThread(rec);
 
+    MaybeIssueTrrLookup(rec);
+
     LOG (("  DNS thread counters: total=%d any-live=%d idle=%d pending=%d\n",
           static_cast<uint32_t>(mThreadCount),
           static_cast<uint32_t>(mActiveAnyThreadCount),
@@ -1094,6 +1123,39 @@ nsHostResolver::IssueLookup(nsHostRecord *rec)
     return rv;
 }
 
+// must be called with mLock held
+void
+nsHostResolver::MaybeIssueTrrLookup(nsHostRecord *rec)
+{
+    if (!mTrrEnabled || rec->mTrrInflight) {
+        return;
+    }
+
+    // the lookup of the DoH server's own hostname must stay native, or
+    // we'd recurse into ourselves
+    if (!PL_strcasecmp(rec->host, mTrrHost.get())) {
+        return;
+    }
+
+    if (rec->flags & RES_OFFLINE) {
+        return;
+    }
+
+    // A single query per record: AAAA when the caller explicitly asked for
+    // IPv6, A otherwise. When the native lookup for an AF_UNSPEC record
+    // finishes later with a larger address set it replaces this one.
+    TRR::TrrType type = (rec->af == PR_AF_INET6) ? TRR::TRRTYPE_AAAA
+                                                 : TRR::TRRTYPE_A;
+
+    LOG(("Racing TRR lookup for host [%s%s%s].\n",
+         LOG_HOST(rec->host, rec->netInterface)));
+
+    rec->mTrrInflight = true;
+    rec->mTrrSuccess = false;
+    nsCOMPtr<nsIRunnable> trr = new TRR(this, rec, mTrrURI, type);
+    NS_DispatchToMainThread(trr.forget());
+}
+
 nsresult
 nsHostResolver::ConditionallyRefreshRecord(nsHostRecord *rec, const char *host)
 {
@@ -1303,11 +1365,16 @@ nsHostResolver::OnLookupComplete(nsHostRecord* rec, nsresult status, AddrInfo* n
         MoveCList(rec->callbacks, cbs);
 
         // update record fields.  We might have a rec->addr_info already if a
-        // previous lookup result expired and we're reresolving it..
+        // previous lookup result expired and we're reresolving it or if a
+        // racing TRR query already answered.
         AddrInfo  *old_addr_info;
         {
             MutexAutoLock lock(rec->addr_info_lock);
-            if (different_rrset(rec->addr_info, newRRSet)) {
+            if (rec->mTrrSuccess && !newRRSet) {
+                // the native lookup lost the race to TRR and then failed;
+                // keep the TRR addresses rather than going negative
+                old_addr_info = nullptr;
+            } else if (different_rrset(rec->addr_info, newRRSet)) {
                 LOG(("nsHostResolver record %p new gencnt\n", rec));
                 old_addr_info = rec->addr_info;
                 rec->addr_info = newRRSet;
@@ -1324,6 +1391,7 @@ nsHostResolver::OnLookupComplete(nsHostRecord* rec, nsresult status, AddrInfo* n
         rec->negative = !rec->addr_info;
         PrepareRecordExpiration(rec);
         rec->resolving = false;
+        rec->mTrrSuccess = false;
 
         if (rec->usingAnyThread) {
             mActiveAnyThreadCount--;
@@ -1384,6 +1452,81 @@ nsHostResolver::OnLookupComplete(nsHostRecord* rec, nsresult status, AddrInfo* n
     return LOOKUP_OK;
 }
 
+//
+// CompleteLookupTRR() is the DNS-over-HTTPS counterpart of
+// OnLookupComplete(), called on the main thread when a TRR query finishes.
+// The record's native lookup keeps running either way and does all the
+// queue, eviction and thread bookkeeping when it completes; this function
+// only decides whether the TRR answer gets to notify the callbacks first.
+// takes ownership of AddrInfo parameter
+void
+nsHostResolver::CompleteLookupTRR(nsHostRecord *rec, nsresult status,
+                                  AddrInfo *newRRSet)
+{
+    PRCList cbs;
+    PR_INIT_CLIST(&cbs);
+    {
+        MutexAutoLock lock(mLock);
+
+        rec->mTrrInflight = false;
+
+        if (mShutdown || NS_FAILED(status) || !newRRSet) {
+            // let the native lookup (still running or already finished)
+            // provide the answer
+            LOG(("CompleteLookupTRR: no usable answer for host [%s%s%s].\n",
+                 LOG_HOST(rec->host, rec->netInterface)));
+            delete newRRSet;
+            return;
+        }
+
+        if (!rec->resolving) {
+            // the native side won the race.  the TRR answer is only
+            // interesting if it can replace a negative entry.
+            if (rec->negative) {
+                {
+                    MutexAutoLock lock(rec->addr_info_lock);
+                    rec->addr_info = newRRSet;
+                    rec->addr_info_gencnt++;
+                }
+                rec->negative = false;
+                PrepareRecordExpiration(rec);
+            } else {
+                delete newRRSet;
+            }
+            return;
+        }
+
+        // TRR won the race; notify the waiting callbacks now
+        LOG(("CompleteLookupTRR: TRR won the race for host [%s%s%s].\n",
+             LOG_HOST(rec->host, rec->netInterface)));
+        MoveCList(rec->callbacks, cbs);
+
+        AddrInfo *old_addr_info;
+        {
+            MutexAutoLock lock(rec->addr_info_lock);
+            old_addr_info = rec->addr_info;
+            rec->addr_info = newRRSet;
+            rec->addr_info_gencnt++;
+        }
+        delete old_addr_info;
+
+        rec->negative = false;
+        PrepareRecordExpiration(rec);
+        rec->mTrrSuccess = true;
+    }
+
+    if (!PR_CLIST_IS_EMPTY(&cbs)) {
+        PRCList *node = cbs.next;
+        while (node != &cbs) {
+            nsResolveHostCallback *callback =
+                    static_cast<nsResolveHostCallback *>(node);
+            node = node->next;
+            callback->OnLookupComplete(this, rec, status);
+            // NOTE: callback must not be dereferenced after this point!!
+        }
+    }
+}
+
 void
 nsHostResolver::CancelAsyncRequest(const char             *host,
                                    const OriginAttributes &aOriginAttributes,
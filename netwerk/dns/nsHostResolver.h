@@ -140,6 +140,11 @@ private:
     bool    usingAnyThread; /* true if off queue and contributing to mActiveAnyThreadCount */
     bool    mDoomed; /* explicitly expired */
 
+    bool    mTrrInflight; /* true while a DNS-over-HTTPS query for this record
+                           * is racing the native lookup */
+    bool    mTrrSuccess;  /* true if the DNS-over-HTTPS query won the race and
+                           * already notified the callbacks */
+
 #if TTL_AVAILABLE
     bool    mGetTtl;
 #endif
@@ -302,6 +307,15 @@ public:
      */
     void FlushCache();
 
+    /**
+     * Called by mozilla::net::TRR on the main thread when a DNS-over-HTTPS
+     * query finishes. Races against the native lookup for the same record:
+     * the first answer to arrive fires the callbacks, a later one only
+     * updates the cached address set.  Takes ownership of the AddrInfo.
+     */
+    void CompleteLookupTRR(nsHostRecord *rec, nsresult status,
+                           mozilla::net::AddrInfo *newRRSet);
+
 private:
    explicit nsHostResolver(uint32_t maxCacheEntries,
                            uint32_t defaultCacheEntryLifetime,
@@ -328,6 +342,13 @@ private:
      */
     nsresult ConditionallyRefreshRecord(nsHostRecord *rec, const char *host);
 
+    /**
+     * Fires off a DNS-over-HTTPS query racing the native lookup for |rec|,
+     * if TRR is enabled and the record is eligible.  Must be called while
+     * holding mLock.
+     */
+    void MaybeIssueTrrLookup(nsHostRecord *rec);
+
     static void  MoveQueue(nsHostRecord *aRec, PRCList &aDestQ);
 
     static void ThreadFunc(void *);
@@ -357,6 +378,12 @@ private:
     PRIntervalTime mLongIdleTimeout;
     PRIntervalTime mShortIdleTimeout;
 
+    // DNS-over-HTTPS (TRR) configuration, read from the network.trr.* prefs
+    // in Init() and constant afterwards.
+    bool          mTrrEnabled;
+    nsCString     mTrrURI;
+    nsCString     mTrrHost; // never queried over TRR, to avoid recursion
+
     mozilla::Atomic<bool>     mShutdown;
     mozilla::Atomic<uint32_t> mNumIdleThreads;
     mozilla::Atomic<uint32_t> mThreadCount;
@@ -763,9 +763,18 @@ Http2Decompressor::DecodeHuffmanCharacter(const HuffmanIncomingTable *table,
                                           uint8_t &c, uint32_t &bytesConsumed,
                                           uint8_t &bitsLeft)
 {
-  uint8_t idx = ExtractByte(bitsLeft, bytesConsumed);
+  // Chain through the multi-level tables with a loop instead of recursing.
+  // Every HEADERS frame is decoded on the socket thread, and the call
+  // overhead for the long (chained) codes adds up under header-heavy
+  // sessions.
+  uint8_t idx;
+  for (;;) {
+    idx = ExtractByte(bitsLeft, bytesConsumed);
+
+    if (!table->IndexHasANextTable(idx)) {
+      break;
+    }
 
-  if (table->IndexHasANextTable(idx)) {
     if (bytesConsumed >= mDataLen) {
       if (!bitsLeft || (bytesConsumed > mDataLen)) {
         // TODO - does this get me into trouble in the new world?
@@ -779,7 +788,7 @@ Http2Decompressor::DecodeHuffmanCharacter(const HuffmanIncomingTable *table,
     }
 
     // We're sorry, Mario, but your princess is in another castle
-    return DecodeHuffmanCharacter(table->NextTable(idx), c, bytesConsumed, bitsLeft);
+    table = table->NextTable(idx);
   }
 
   const HuffmanIncomingEntry *entry = table->Entry(idx);
@@ -817,6 +826,11 @@ Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes, nsACString &val)
   nsresult rv;
   uint8_t c;
 
+  // The shortest code is 4 bits, so the decoded string can be at most twice
+  // the length of the input. Reserving that up front keeps the
+  // character-at-a-time Append()s below from reallocating.
+  buf.SetCapacity(2 * bytes);
+
   while (bytesRead < bytes) {
     uint32_t bytesConsumed = 0;
     rv = DecodeHuffmanCharacter(&HuffmanIncomingRoot, c, bytesConsumed,
@@ -475,14 +475,51 @@ Http2Session::QueueStream(Http2Stream *stream)
   mQueuedStreams.Push(stream);
 }
 
+// Removes and returns the highest priority stream (i.e. the lowest gecko
+// priority value) from the queue, nullptr if the queue is empty. FIFO order
+// is kept among streams of equal priority, so this degrades to the old
+// round-robin behavior when everything is equally important.
+static Http2Stream *
+PopHighestPriorityStream(nsDeque &queue)
+{
+  size_t size = queue.GetSize();
+  if (!size) {
+    return nullptr;
+  }
+
+  size_t bestIndex = 0;
+  uint32_t bestPriority =
+    static_cast<Http2Stream *>(queue.ObjectAt(0))->Priority();
+  for (size_t index = 1; index < size; ++index) {
+    Http2Stream *stream = static_cast<Http2Stream *>(queue.ObjectAt(index));
+    if (stream->Priority() < bestPriority) {
+      bestIndex = index;
+      bestPriority = stream->Priority();
+    }
+  }
+
+  Http2Stream *best = nullptr;
+  for (size_t index = 0; index < size; ++index) {
+    Http2Stream *stream = static_cast<Http2Stream *>(queue.PopFront());
+    if (index == bestIndex) {
+      best = stream;
+    } else {
+      queue.Push(stream);
+    }
+  }
+  return best;
+}
+
 void
 Http2Session::ProcessPending()
 {
   MOZ_ASSERT(OnSocketThread(), "not on socket thread");
 
+  // When a concurrency slot opens up, admit the most important queued stream
+  // first rather than whichever stream happened to be queued earliest.
   Http2Stream*stream;
   while (RoomForMoreConcurrent() &&
-         (stream = static_cast<Http2Stream *>(mQueuedStreams.PopFront()))) {
+         (stream = PopHighestPriorityStream(mQueuedStreams))) {
 
     LOG3(("Http2Session::ProcessPending %p stream %p woken from queue.",
           this, stream));
@@ -2743,7 +2780,10 @@ Http2Session::ReadSegmentsAgain(nsAHttpSegmentReader *reader,
 
   LOG3(("Http2Session::ReadSegments %p", this));
 
-  Http2Stream *stream = static_cast<Http2Stream *>(mReadyForWrite.PopFront());
+  // Serve the most important ready stream first, so that under bandwidth
+  // contention high priority responses aren't stuck behind bulk transfers
+  // that merely got into the queue earlier.
+  Http2Stream *stream = PopHighestPriorityStream(mReadyForWrite);
   if (!stream) {
     LOG3(("Http2Session %p could not identify a stream to write; suspending.",
           this));
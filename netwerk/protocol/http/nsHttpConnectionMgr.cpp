@@ -608,6 +608,39 @@ nsHttpConnectionMgr::UpdateRequestTokenBucket(EventTokenBucket *aBucket)
                      0, aBucket);
 }
 
+class KeepWarmOriginList : public ARefBase
+{
+public:
+    explicit KeepWarmOriginList(const nsTArray<nsCString> &aOrigins)
+        : mOrigins(aOrigins)
+    {}
+    NS_INLINE_DECL_THREADSAFE_REFCOUNTING(KeepWarmOriginList)
+
+public: // intentional!
+    nsTArray<nsCString> mOrigins;
+
+private:
+    virtual ~KeepWarmOriginList() {}
+};
+
+void
+nsHttpConnectionMgr::OnMsgUpdateKeepWarmOrigins(int32_t, ARefBase *param)
+{
+    MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+    LOG(("nsHttpConnectionMgr::OnMsgUpdateKeepWarmOrigins\n"));
+    mKeepWarmOrigins = static_cast<KeepWarmOriginList *>(param)->mOrigins;
+}
+
+nsresult
+nsHttpConnectionMgr::UpdateKeepWarmOrigins(const nsTArray<nsCString> &aOrigins)
+{
+    // Called from the main thread when network.http.keep-warm-origins
+    // changes in order to post the new list to the socket thread.
+    RefPtr<KeepWarmOriginList> list = new KeepWarmOriginList(aOrigins);
+    return PostEvent(&nsHttpConnectionMgr::OnMsgUpdateKeepWarmOrigins,
+                     0, list);
+}
+
 nsresult
 nsHttpConnectionMgr::ClearConnectionHistory()
 {
@@ -2536,6 +2569,28 @@ nsHttpConnectionMgr::OnMsgPruneDeadConnections(int32_t, ARefBase *)
                 }
             }
 
+            // If pruning just took a pinned keep-warm origin down to zero
+            // connections, ask the main thread for a new speculative one so
+            // the next transaction doesn't pay connection setup.
+            if (!mKeepWarmOrigins.IsEmpty() &&
+                ent->mIdleConns.IsEmpty() &&
+                ent->mActiveConns.IsEmpty() &&
+                ent->mHalfOpens.IsEmpty() &&
+                ent->mConnInfo->EndToEndSSL() &&
+                !ent->mConnInfo->UsingProxy()) {
+                nsAutoCString key(ent->mConnInfo->GetOrigin());
+                key.Append(':');
+                key.AppendInt(ent->mConnInfo->OriginPort());
+                if (mKeepWarmOrigins.Contains(key)) {
+                    LOG(("  re-warming pinned origin %s\n", key.get()));
+                    NS_DispatchToMainThread(NewRunnableMethod<nsCString>(
+                        "nsHttpHandler::SpeculativeConnectWarmOrigin",
+                        gHttpHandler,
+                        &nsHttpHandler::SpeculativeConnectWarmOrigin,
+                        key));
+                }
+            }
+
             // If time to next expire found is shorter than time to next
             // wake-up, we need to change the time for next wake-up.
             if (timeToNextExpire != UINT32_MAX) {
@@ -172,6 +172,11 @@ public:
     // clears the connection history mCT
     MOZ_MUST_USE nsresult ClearConnectionHistory();
 
+    // called from the main thread to replace the set of origins
+    // ("host:port") the connection manager keeps a warm connection to
+    MOZ_MUST_USE nsresult
+    UpdateKeepWarmOrigins(const nsTArray<nsCString> &aOrigins);
+
     void ReportFailedToProcess(nsIURI *uri);
 
     // Causes a large amount of connection diagnostic information to be
@@ -656,6 +661,7 @@ private:
     void OnMsgVerifyTraffic (int32_t, ARefBase *);
     void OnMsgPruneNoTraffic (int32_t, ARefBase *);
     void OnMsgUpdateCurrentTopLevelOuterContentWindowId (int32_t, ARefBase *);
+    void OnMsgUpdateKeepWarmOrigins (int32_t, ARefBase *);
 
     // Total number of active connections in all of the ConnectionEntry objects
     // that are accessed from mCT connection table.
@@ -669,6 +675,11 @@ private:
     // that are accessed from mCT connection table
     uint32_t mNumHalfOpenConns;
 
+    // Origins ("host:port", https implied) that should be re-warmed with a
+    // speculative connection when pruning leaves them with no connections.
+    // Set via network.http.keep-warm-origins; socket thread only.
+    nsTArray<nsCString> mKeepWarmOrigins;
+
     // Holds time in seconds for next wake-up to prune dead connections.
     uint64_t mTimeOfNextWakeUp;
     // Timer for next pruning of dead connections.
@@ -30,6 +30,7 @@
 #include "nsPrintfCString.h"
 #include "nsCOMPtr.h"
 #include "nsNetCID.h"
+#include "nsNetUtil.h"
 #include "mozilla/Printf.h"
 #include "mozilla/Sprintf.h"
 #include "nsAsyncRedirectVerifyHelper.h"
@@ -600,6 +601,13 @@ nsHttpHandler::InitConnectionMgr()
                         mThrottleResumeFor,
                         mThrottleResumeIn,
                         mThrottleTimeWindow);
+
+    // the initial pref read happens before the connection manager exists, so
+    // hand it the keep-warm list now
+    if (NS_SUCCEEDED(rv) && !mKeepWarmOrigins.IsEmpty()) {
+        Unused << mConnMgr->UpdateKeepWarmOrigins(mKeepWarmOrigins);
+    }
+
     return rv;
 }
 
@@ -1585,6 +1593,42 @@ nsHttpHandler::PrefsChanged(nsIPrefBranch *prefs, const char *pref)
             mParallelSpeculativeConnectLimit = (uint32_t) clamped(val, 0, 1024);
     }
 
+    if (PREF_CHANGED(HTTP_PREF("keep-warm-origins"))) {
+        nsCString warmOrigins;
+        prefs->GetCharPref(HTTP_PREF("keep-warm-origins"),
+                           getter_Copies(warmOrigins));
+        mKeepWarmOrigins.Clear();
+        nsCCharSeparatedTokenizer tokenizer(warmOrigins, ',');
+        while (tokenizer.hasMoreTokens()) {
+            nsAutoCString origin(tokenizer.nextToken());
+            if (StringBeginsWith(origin, NS_LITERAL_CSTRING("https://"))) {
+                origin.Cut(0, 8);
+            }
+            // only bare host[:port] entries - anything with a path (or a
+            // non-https scheme left after the strip above) is ignored
+            if (origin.IsEmpty() || origin.FindChar('/') != kNotFound) {
+                continue;
+            }
+            if (origin.FindChar(':') == kNotFound) {
+                origin.AppendLiteral(":443");
+            }
+            ToLowerCase(origin);
+            mKeepWarmOrigins.AppendElement(origin);
+        }
+        if (mConnMgr) {
+            Unused << mConnMgr->UpdateKeepWarmOrigins(mKeepWarmOrigins);
+        }
+        // warm each origin right away; dispatched so that the initial pref
+        // read during Init() connects only after the handler is fully set up
+        for (const nsCString &origin : mKeepWarmOrigins) {
+            NS_DispatchToMainThread(NewRunnableMethod<nsCString>(
+                "nsHttpHandler::SpeculativeConnectWarmOrigin",
+                this,
+                &nsHttpHandler::SpeculativeConnectWarmOrigin,
+                origin));
+        }
+    }
+
     // Whether or not to block requests for non head js/css items (e.g. media)
     // while those elements load.
     if (PREF_CHANGED(HTTP_PREF("rendering-critical-requests-prioritization"))) {
@@ -2596,6 +2640,27 @@ nsHttpHandler::SpeculativeConnectInternal(nsIURI *aURI,
     return SpeculativeConnect(ci, aCallbacks);
 }
 
+void
+nsHttpHandler::SpeculativeConnectWarmOrigin(const nsACString &aHostPort)
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    // the pref may have changed while this event crossed threads
+    if (!mKeepWarmOrigins.Contains(aHostPort)) {
+        return;
+    }
+
+    nsAutoCString spec(NS_LITERAL_CSTRING("https://"));
+    spec.Append(aHostPort);
+    nsCOMPtr<nsIURI> uri;
+    if (NS_FAILED(NS_NewURI(getter_AddRefs(uri), spec))) {
+        return;
+    }
+
+    LOG(("nsHttpHandler::SpeculativeConnectWarmOrigin %s\n", spec.get()));
+    Unused << SpeculativeConnectInternal(uri, nullptr, nullptr, false);
+}
+
 NS_IMETHODIMP
 nsHttpHandler::SpeculativeConnect(nsIURI *aURI,
                                   nsIInterfaceRequestor *aCallbacks)
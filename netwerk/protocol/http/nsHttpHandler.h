@@ -13,6 +13,7 @@
 
 #include "nsString.h"
 #include "nsCOMPtr.h"
+#include "nsTArray.h"
 #include "nsWeakReference.h"
 
 #include "nsIHttpProtocolHandler.h"
@@ -583,6 +584,11 @@ private:
     // installed as that might randomly popup the certificate choosing window.
     bool           mSpeculativeConnectEnabled;
 
+    // Origins ("host:port", https implied) listed in
+    // network.http.keep-warm-origins. The connection manager re-warms these
+    // with a speculative connection whenever pruning leaves them cold.
+    nsTArray<nsCString> mKeepWarmOrigins;
+
     // For Rate Pacing of HTTP/1 requests through a netwerk/base/EventTokenBucket
     // Active requests <= *MinParallelism are not subject to the rate pacing
     bool           mRequestTokenBucketEnabled;
@@ -682,6 +688,13 @@ private:
 
 public:
     MOZ_MUST_USE nsresult NewChannelId(uint64_t& channelId);
+
+    // Open a speculative connection to a pinned keep-warm origin
+    // ("host:port", https implied). Called on the main thread, typically
+    // dispatched by the connection manager after pruning left the origin
+    // with no connections. A no-op if the pref list no longer names the
+    // origin by the time the event runs.
+    void SpeculativeConnectWarmOrigin(const nsACString &aHostPort);
 };
 
 extern nsHttpHandler *gHttpHandler;
@@ -580,29 +580,31 @@ public:
   NS_DECL_THREADSAFE_ISUPPORTS
 
   CallOnMessageAvailable(WebSocketChannel* aChannel,
-                         nsACString& aData,
-                         int32_t aLen)
+                         nsTArray<WebSocketChannel::PendingMessage>& aMessages)
     : mChannel(aChannel),
-      mListenerMT(aChannel->mListenerMT),
-      mData(aData),
-      mLen(aLen) {}
+      mListenerMT(aChannel->mListenerMT)
+  {
+    mMessages.SwapElements(aMessages);
+  }
 
   NS_IMETHOD Run() override
   {
     MOZ_ASSERT(mChannel->IsOnTargetThread());
 
     if (mListenerMT) {
-      nsresult rv;
-      if (mLen < 0) {
-        rv = mListenerMT->mListener->OnMessageAvailable(mListenerMT->mContext,
-                                                        mData);
-      } else {
-        rv = mListenerMT->mListener->OnBinaryMessageAvailable(mListenerMT->mContext,
-                                                              mData);
-      }
-      if (NS_FAILED(rv)) {
-        LOG(("OnMessageAvailable or OnBinaryMessageAvailable "
-             "failed with 0x%08" PRIx32, static_cast<uint32_t>(rv)));
+      for (uint32_t i = 0; i < mMessages.Length(); ++i) {
+        nsresult rv;
+        if (mMessages[i].mLen < 0) {
+          rv = mListenerMT->mListener->OnMessageAvailable(mListenerMT->mContext,
+                                                          mMessages[i].mData);
+        } else {
+          rv = mListenerMT->mListener->OnBinaryMessageAvailable(mListenerMT->mContext,
+                                                                mMessages[i].mData);
+        }
+        if (NS_FAILED(rv)) {
+          LOG(("OnMessageAvailable or OnBinaryMessageAvailable "
+               "failed with 0x%08" PRIx32, static_cast<uint32_t>(rv)));
+        }
       }
     }
 
@@ -614,8 +616,7 @@ private:
 
   RefPtr<WebSocketChannel> mChannel;
   RefPtr<BaseWebSocketChannel::ListenerAndContextContainer> mListenerMT;
-  nsCString mData;
-  int32_t mLen;
+  nsTArray<WebSocketChannel::PendingMessage> mMessages;
 };
 NS_IMPL_ISUPPORTS(CallOnMessageAvailable, nsIRunnable)
 
@@ -1758,8 +1759,9 @@ WebSocketChannel::ProcessInput(uint8_t *buffer, uint32_t count)
           mService->FrameReceived(mSerial, mInnerWindowID, frame.forget());
         }
 
-        mTargetThread->Dispatch(new CallOnMessageAvailable(this, utf8Data, -1),
-                                NS_DISPATCH_NORMAL);
+        PendingMessage *pending = mPendingMessages.AppendElement();
+        pending->mData = utf8Data;
+        pending->mLen = -1;
         if (mConnectionLogService && !mPrivateBrowsing) {
           mConnectionLogService->NewMsgReceived(mHost, mSerial, count);
           LOG(("Added new msg received for %s", mHost.get()));
@@ -1819,6 +1821,9 @@ WebSocketChannel::ProcessInput(uint8_t *buffer, uint32_t count)
         }
 
         if (mListenerMT) {
+          // Deliver any messages decoded earlier in this input chunk before
+          // the close notification so the listener sees them in order.
+          FlushPendingMessages();
           mTargetThread->Dispatch(new CallOnServerClose(this, mServerCloseCode,
                                                         mServerCloseReason),
                                   NS_DISPATCH_NORMAL);
@@ -1886,9 +1891,9 @@ WebSocketChannel::ProcessInput(uint8_t *buffer, uint32_t count)
           mService->FrameReceived(mSerial, mInnerWindowID, frame.forget());
         }
 
-        mTargetThread->Dispatch(
-          new CallOnMessageAvailable(this, binaryData, binaryData.Length()),
-          NS_DISPATCH_NORMAL);
+        PendingMessage *pending = mPendingMessages.AppendElement();
+        pending->mData = binaryData;
+        pending->mLen = binaryData.Length();
         // To add the header to 'Networking Dashboard' log
         if (mConnectionLogService && !mPrivateBrowsing) {
           mConnectionLogService->NewMsgReceived(mHost, mSerial, count);
@@ -1946,6 +1951,23 @@ WebSocketChannel::ProcessInput(uint8_t *buffer, uint32_t count)
   return NS_OK;
 }
 
+void
+WebSocketChannel::FlushPendingMessages()
+{
+  LOG(("WebSocketChannel::FlushPendingMessages() %p [%zu messages]\n",
+       this, mPendingMessages.Length()));
+  MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+
+  if (mPendingMessages.IsEmpty()) {
+    return;
+  }
+
+  // The runnable swaps the array contents out, leaving mPendingMessages
+  // empty for the next chunk of input.
+  mTargetThread->Dispatch(new CallOnMessageAvailable(this, mPendingMessages),
+                          NS_DISPATCH_NORMAL);
+}
+
 /* static */ void
 WebSocketChannel::ApplyMask(uint32_t mask, uint8_t *data, uint64_t len)
 {
@@ -4006,6 +4028,12 @@ WebSocketChannel::OnInputStreamReady(nsIAsyncInputStream *aStream)
     }
 
     rv = ProcessInput((uint8_t *)buffer, count);
+
+    // Hand the messages decoded from this chunk to the listener in one
+    // dispatch. Even on failure, flush first so anything successfully
+    // decoded is delivered ahead of AbortSession()'s stop notification.
+    FlushPendingMessages();
+
     if (NS_FAILED(rv)) {
       AbortSession(rv);
       return rv;
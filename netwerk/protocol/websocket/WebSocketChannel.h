@@ -25,6 +25,7 @@
 #include "nsCOMPtr.h"
 #include "nsString.h"
 #include "nsDeque.h"
+#include "nsTArray.h"
 #include "mozilla/Atomics.h"
 
 class nsIAsyncVerifyRedirectCallback;
@@ -180,6 +181,7 @@ private:
   MOZ_MUST_USE bool UpdateReadBuffer(uint8_t *buffer, uint32_t count,
                                      uint32_t accumulatedFragments,
                                      uint32_t *available);
+  void FlushPendingMessages();
 
   inline void ResetPingTimer()
   {
@@ -282,6 +284,21 @@ private:
   uint32_t                        mBuffered;
   uint32_t                        mBufferSize;
 
+  // A complete message ProcessInput() has decoded but not yet handed to the
+  // listener. mLen < 0 means text (delivered via OnMessageAvailable()),
+  // otherwise binary - the same convention CallOnMessageAvailable uses.
+  struct PendingMessage
+  {
+    nsCString mData;
+    int32_t   mLen;
+  };
+
+  // Messages accumulated on the socket thread while decoding one chunk of
+  // network input. FlushPendingMessages() delivers them to mTargetThread in a
+  // single runnable, so a burst of small frames costs one dispatch rather
+  // than one per message.
+  nsTArray<PendingMessage>        mPendingMessages;
+
   // These are for the send buffers
   const static int32_t kCopyBreak = 1000;
 
@@ -40,9 +40,11 @@ NS_IMPL_ISUPPORTS(nsHTTPCompressConv,
 nsHTTPCompressConv::nsHTTPCompressConv()
   : mMode(HTTP_COMPRESS_IDENTITY)
   , mOutBuffer(nullptr)
-  , mInpBuffer(nullptr)
   , mOutBufferLen(0)
-  , mInpBufferLen(0)
+  , mZlibRequest(nullptr)
+  , mZlibContext(nullptr)
+  , mZlibSourceOffset(0)
+  , mZlibStatus(NS_OK)
   , mCheckHeaderDone(false)
   , mStreamEnded(false)
   , mStreamInitialized(false)
@@ -65,10 +67,6 @@ nsHTTPCompressConv::nsHTTPCompressConv()
 nsHTTPCompressConv::~nsHTTPCompressConv()
 {
   LOG(("nsHttpCompresssConv %p dtor\n", this));
-  if (mInpBuffer) {
-    free(mInpBuffer);
-  }
-
   if (mOutBuffer) {
     free(mOutBuffer);
   }
@@ -253,6 +251,192 @@ nsHTTPCompressConv::BrotliHandler(nsIInputStream *stream, void *closure, const c
   return self->mBrotli->mStatus;
 }
 
+/* static */ nsresult
+nsHTTPCompressConv::ZlibHandler(nsIInputStream *stream, void *closure, const char *dataIn,
+                                uint32_t, uint32_t aAvail, uint32_t *countRead)
+{
+  MOZ_ASSERT(stream);
+  nsHTTPCompressConv *self = static_cast<nsHTTPCompressConv *>(closure);
+  *countRead = 0;
+  nsresult rv;
+
+  if (self->mStreamEnded) {
+    // A previous segment hit the end of the deflate stream; whatever is left
+    // is metadata or padding of some sort, consume it and throw it out.
+    *countRead = aAvail;
+    return NS_OK;
+  }
+
+  if (self->mOutBufferLen < aAvail * 2) {
+    unsigned char *originalOutBuffer = self->mOutBuffer;
+    if (!(self->mOutBuffer = (unsigned char *) realloc(originalOutBuffer,
+                                                       self->mOutBufferLen = aAvail * 3))) {
+      free(originalOutBuffer);
+      self->mOutBufferLen = 0;
+      self->mZlibStatus = NS_ERROR_OUT_OF_MEMORY;
+      return self->mZlibStatus;
+    }
+  }
+
+  if (self->mMode == HTTP_COMPRESS_DEFLATE) {
+    if (!self->mStreamInitialized) {
+      memset(&self->d_stream, 0, sizeof(self->d_stream));
+
+      if (inflateInit(&self->d_stream) != Z_OK) {
+        self->mZlibStatus = NS_ERROR_FAILURE;
+        return self->mZlibStatus;
+      }
+
+      self->mStreamInitialized = true;
+    }
+    self->d_stream.next_in = (Bytef *) dataIn;
+    self->d_stream.avail_in = (uInt) aAvail;
+
+    self->mDummyStreamInitialised = false;
+    for (;;) {
+      self->d_stream.next_out = self->mOutBuffer;
+      self->d_stream.avail_out = (uInt) self->mOutBufferLen;
+
+      int code = inflate(&self->d_stream, Z_NO_FLUSH);
+      unsigned bytesWritten = (uInt) self->mOutBufferLen - self->d_stream.avail_out;
+
+      if (code == Z_STREAM_END) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+
+        inflateEnd(&self->d_stream);
+        self->mStreamEnded = true;
+        break;
+      } else if (code == Z_OK) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+      } else if (code == Z_BUF_ERROR) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+        break;
+      } else if (code == Z_DATA_ERROR) {
+        // some servers (notably Apache with mod_deflate) don't generate zlib headers
+        // insert a dummy header and try again
+        static char dummy_head[2] =
+          {
+            0x8 + 0x7 * 0x10,
+            (((0x8 + 0x7 * 0x10) * 0x100 + 30) / 31 * 31) & 0xFF,
+          };
+        inflateReset(&self->d_stream);
+        self->d_stream.next_in = (Bytef*) dummy_head;
+        self->d_stream.avail_in = sizeof(dummy_head);
+
+        code = inflate(&self->d_stream, Z_NO_FLUSH);
+        if (code != Z_OK) {
+          self->mZlibStatus = NS_ERROR_FAILURE;
+          return self->mZlibStatus;
+        }
+
+        // stop an endless loop caused by non-deflate data being labelled as deflate
+        if (self->mDummyStreamInitialised) {
+          NS_WARNING("endless loop detected"
+                     " - invalid deflate");
+          self->mZlibStatus = NS_ERROR_INVALID_CONTENT_ENCODING;
+          return self->mZlibStatus;
+        }
+        self->mDummyStreamInitialised = true;
+        // reset stream pointers to our original data
+        self->d_stream.next_in = (Bytef *) dataIn;
+        self->d_stream.avail_in = (uInt) aAvail;
+      } else {
+        self->mZlibStatus = NS_ERROR_INVALID_CONTENT_ENCODING;
+        return self->mZlibStatus;
+      }
+    } /* for */
+  } else {
+    if (!self->mStreamInitialized) {
+      memset(&self->d_stream, 0, sizeof(self->d_stream));
+
+      if (inflateInit2(&self->d_stream, -MAX_WBITS) != Z_OK) {
+        self->mZlibStatus = NS_ERROR_FAILURE;
+        return self->mZlibStatus;
+      }
+
+      self->mStreamInitialized = true;
+    }
+
+    self->d_stream.next_in  = (Bytef *) dataIn;
+    self->d_stream.avail_in = (uInt) aAvail;
+
+    for (;;) {
+      self->d_stream.next_out  = self->mOutBuffer;
+      self->d_stream.avail_out = (uInt) self->mOutBufferLen;
+
+      int code = inflate(&self->d_stream, Z_NO_FLUSH);
+      unsigned bytesWritten = (uInt) self->mOutBufferLen - self->d_stream.avail_out;
+
+      if (code == Z_STREAM_END) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+
+        inflateEnd(&self->d_stream);
+        self->mStreamEnded = true;
+        break;
+      } else if (code == Z_OK) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+      } else if (code == Z_BUF_ERROR) {
+        if (bytesWritten) {
+          rv = self->do_OnDataAvailable(self->mZlibRequest, self->mZlibContext,
+                                        self->mZlibSourceOffset,
+                                        (char *) self->mOutBuffer, bytesWritten);
+          if (NS_FAILED(rv)) {
+            self->mZlibStatus = rv;
+            return rv;
+          }
+        }
+        break;
+      } else {
+        self->mZlibStatus = NS_ERROR_INVALID_CONTENT_ENCODING;
+        return self->mZlibStatus;
+      }
+    } /* for */
+  } /* gzip */
+
+  *countRead = aAvail;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsHTTPCompressConv::OnDataAvailable(nsIRequest* request,
                                     nsISupports *aContext,
@@ -292,170 +476,24 @@ nsHTTPCompressConv::OnDataAvailable(nsIRequest* request,
     MOZ_FALLTHROUGH;
 
   case HTTP_COMPRESS_DEFLATE:
+  {
+    // Inflate straight out of the input stream's segments, the same way the
+    // brotli case below feeds BrotliHandler, rather than copying the
+    // compressed bytes into a side buffer first.
+    mZlibRequest = request;
+    mZlibContext = aContext;
+    mZlibSourceOffset = aSourceOffset;
+    mZlibStatus = NS_OK;
 
-    if (mInpBuffer != nullptr && streamLen > mInpBufferLen) {
-      unsigned char* originalInpBuffer = mInpBuffer;
-      if (!(mInpBuffer = (unsigned char *) realloc(originalInpBuffer, mInpBufferLen = streamLen))) {
-        free(originalInpBuffer);
-      }
-
-      if (mOutBufferLen < streamLen * 2) {
-        unsigned char* originalOutBuffer = mOutBuffer;
-        if (!(mOutBuffer = (unsigned char *) realloc(mOutBuffer, mOutBufferLen = streamLen * 3))) {
-          free(originalOutBuffer);
-        }
-      }
-
-      if (mInpBuffer == nullptr || mOutBuffer == nullptr) {
-        return NS_ERROR_OUT_OF_MEMORY;
-      }
-    }
-
-    if (mInpBuffer == nullptr) {
-      mInpBuffer = (unsigned char *) malloc(mInpBufferLen = streamLen);
-    }
-
-    if (mOutBuffer == nullptr) {
-      mOutBuffer = (unsigned char *) malloc(mOutBufferLen = streamLen * 3);
+    uint32_t countRead;
+    rv = iStr->ReadSegments(ZlibHandler, this, streamLen, &countRead);
+    if (NS_SUCCEEDED(rv)) {
+      rv = mZlibStatus;
     }
-
-    if (mInpBuffer == nullptr || mOutBuffer == nullptr) {
-      return NS_ERROR_OUT_OF_MEMORY;
+    if (NS_FAILED(rv)) {
+      return rv;
     }
-
-    uint32_t unused;
-    iStr->Read((char *)mInpBuffer, streamLen, &unused);
-
-    if (mMode == HTTP_COMPRESS_DEFLATE) {
-      if (!mStreamInitialized) {
-        memset(&d_stream, 0, sizeof (d_stream));
-
-        if (inflateInit(&d_stream) != Z_OK) {
-          return NS_ERROR_FAILURE;
-        }
-
-        mStreamInitialized = true;
-      }
-      d_stream.next_in = mInpBuffer;
-      d_stream.avail_in = (uInt)streamLen;
-
-      mDummyStreamInitialised = false;
-      for (;;) {
-        d_stream.next_out = mOutBuffer;
-        d_stream.avail_out = (uInt)mOutBufferLen;
-
-        int code = inflate(&d_stream, Z_NO_FLUSH);
-        unsigned bytesWritten = (uInt)mOutBufferLen - d_stream.avail_out;
-
-        if (code == Z_STREAM_END) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-
-          inflateEnd(&d_stream);
-          mStreamEnded = true;
-          break;
-        } else if (code == Z_OK) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-        } else if (code == Z_BUF_ERROR) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-          break;
-        } else if (code == Z_DATA_ERROR) {
-          // some servers (notably Apache with mod_deflate) don't generate zlib headers
-          // insert a dummy header and try again
-          static char dummy_head[2] =
-            {
-              0x8 + 0x7 * 0x10,
-              (((0x8 + 0x7 * 0x10) * 0x100 + 30) / 31 * 31) & 0xFF,
-            };
-          inflateReset(&d_stream);
-          d_stream.next_in = (Bytef*) dummy_head;
-          d_stream.avail_in = sizeof(dummy_head);
-
-          code = inflate(&d_stream, Z_NO_FLUSH);
-          if (code != Z_OK) {
-            return NS_ERROR_FAILURE;
-          }
-
-          // stop an endless loop caused by non-deflate data being labelled as deflate
-          if (mDummyStreamInitialised) {
-            NS_WARNING("endless loop detected"
-                       " - invalid deflate");
-            return NS_ERROR_INVALID_CONTENT_ENCODING;
-          }
-          mDummyStreamInitialised = true;
-          // reset stream pointers to our original data
-          d_stream.next_in = mInpBuffer;
-          d_stream.avail_in = (uInt)streamLen;
-        } else {
-          return NS_ERROR_INVALID_CONTENT_ENCODING;
-        }
-      } /* for */
-    } else {
-      if (!mStreamInitialized) {
-        memset(&d_stream, 0, sizeof (d_stream));
-
-        if (inflateInit2(&d_stream, -MAX_WBITS) != Z_OK) {
-          return NS_ERROR_FAILURE;
-        }
-
-        mStreamInitialized = true;
-      }
-
-      d_stream.next_in  = mInpBuffer;
-      d_stream.avail_in = (uInt)streamLen;
-
-      for (;;) {
-        d_stream.next_out  = mOutBuffer;
-        d_stream.avail_out = (uInt)mOutBufferLen;
-
-        int code = inflate (&d_stream, Z_NO_FLUSH);
-        unsigned bytesWritten = (uInt)mOutBufferLen - d_stream.avail_out;
-
-        if (code == Z_STREAM_END) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-
-          inflateEnd(&d_stream);
-          mStreamEnded = true;
-          break;
-        } else if (code == Z_OK) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-        } else if (code == Z_BUF_ERROR) {
-          if (bytesWritten) {
-            rv = do_OnDataAvailable(request, aContext, aSourceOffset, (char *)mOutBuffer, bytesWritten);
-            if (NS_FAILED (rv)) {
-              return rv;
-            }
-          }
-          break;
-        } else {
-          return NS_ERROR_INVALID_CONTENT_ENCODING;
-        }
-      } /* for */
-    } /* gzip */
+  }
     break;
 
   case HTTP_COMPRESS_BROTLI:
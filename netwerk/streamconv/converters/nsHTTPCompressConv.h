@@ -104,10 +104,8 @@ private:
     Atomic<CompressMode, Relaxed> mMode;
 
     unsigned char *mOutBuffer;
-    unsigned char *mInpBuffer;
 
     uint32_t	mOutBufferLen;
-    uint32_t	mInpBufferLen;
 
     nsAutoPtr<BrotliWrapper> mBrotli;
 
@@ -117,6 +115,18 @@ private:
     BrotliHandler(nsIInputStream *stream, void *closure, const char *dataIn,
                   uint32_t, uint32_t avail, uint32_t *countRead);
 
+    static nsresult
+    ZlibHandler(nsIInputStream *stream, void *closure, const char *dataIn,
+                uint32_t, uint32_t avail, uint32_t *countRead);
+
+    // ODA context for ZlibHandler(), only valid while OnDataAvailable() is
+    // feeding ReadSegments(). The brotli path keeps the equivalent state in
+    // BrotliWrapper.
+    nsIRequest  *mZlibRequest;
+    nsISupports *mZlibContext;
+    uint64_t     mZlibSourceOffset;
+    nsresult     mZlibStatus;
+
     nsresult do_OnDataAvailable (nsIRequest *request, nsISupports *aContext,
                                  uint64_t aSourceOffset, const char *buffer,
                                  uint32_t aCount);
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include "nsCOMPtr.h"
+#include "nsDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+#include "nsIFileStreams.h"
+#include "nsISeekableStream.h"
+#include "nsNetUtil.h"
+#include "nsStreamUtils.h"
+#include "nsString.h"
+
+namespace {
+
+// Create a temporary file holding aData and return it via aFileOut.
+void CreateTempFile(const nsACString& aData, nsIFile** aFileOut)
+{
+  nsCOMPtr<nsIFile> file;
+  nsresult rv = NS_GetSpecialDirectory(NS_OS_TEMP_DIR, getter_AddRefs(file));
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  rv = file->AppendNative(NS_LITERAL_CSTRING("mmap-stream-test.tmp"));
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  rv = file->CreateUnique(nsIFile::NORMAL_FILE_TYPE, 0600);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  nsCOMPtr<nsIOutputStream> out;
+  rv = NS_NewLocalFileOutputStream(getter_AddRefs(out), file);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  uint32_t numWritten = 0;
+  rv = out->Write(aData.BeginReading(), aData.Length(), &numWritten);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(aData.Length(), numWritten);
+
+  out->Close();
+  file.forget(aFileOut);
+}
+
+nsCString CreateData(uint32_t aNumBytes)
+{
+  nsCString data;
+  for (uint32_t i = 0; i < aNumBytes; ++i) {
+    data.Append(char(i % 256));
+  }
+  return data;
+}
+
+} // namespace
+
+TEST(TestMemoryMappedInputStream, Read)
+{
+  nsCString data = CreateData(64 * 1024);
+
+  nsCOMPtr<nsIFile> file;
+  CreateTempFile(data, getter_AddRefs(file));
+
+  nsCOMPtr<nsIInputStream> stream;
+  nsresult rv = NS_NewMemoryMappedInputStream(getter_AddRefs(stream), file);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  uint64_t available = 0;
+  rv = stream->Available(&available);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(uint64_t(data.Length()), available);
+
+  nsAutoCString read;
+  rv = NS_ConsumeStream(stream, UINT32_MAX, read);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_TRUE(read.Equals(data));
+
+  file->Remove(false);
+}
+
+TEST(TestMemoryMappedInputStream, SegmentAndSeek)
+{
+  nsCString data = CreateData(4096);
+
+  nsCOMPtr<nsIFile> file;
+  CreateTempFile(data, getter_AddRefs(file));
+
+  nsCOMPtr<nsIInputStream> stream;
+  nsresult rv = NS_NewMemoryMappedInputStream(getter_AddRefs(stream), file);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  // The mapping covers the whole file and is exposed directly.
+  nsCOMPtr<nsIMemoryMappedInputStream> mmapStream = do_QueryInterface(stream);
+  ASSERT_TRUE(mmapStream);
+
+  uint64_t length = 0;
+  char* buffer = mmapStream->Segment(&length);
+  ASSERT_TRUE(buffer);
+  ASSERT_EQ(uint64_t(data.Length()), length);
+  ASSERT_EQ(0, memcmp(buffer, data.BeginReading(), data.Length()));
+
+  nsCOMPtr<nsISeekableStream> seekable = do_QueryInterface(stream);
+  ASSERT_TRUE(seekable);
+
+  rv = seekable->Seek(nsISeekableStream::NS_SEEK_SET, 1024);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  char buf[16];
+  uint32_t numRead = 0;
+  rv = stream->Read(buf, sizeof(buf), &numRead);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(uint32_t(sizeof(buf)), numRead);
+  ASSERT_EQ(0, memcmp(buf, data.BeginReading() + 1024, sizeof(buf)));
+
+  int64_t pos = 0;
+  rv = seekable->Tell(&pos);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(int64_t(1024 + sizeof(buf)), pos);
+
+  // Seeking past the mapping is rejected.
+  rv = seekable->Seek(nsISeekableStream::NS_SEEK_END, 1);
+  ASSERT_EQ(NS_ERROR_INVALID_ARG, rv);
+
+  file->Remove(false);
+}
+
+TEST(TestMemoryMappedInputStream, EmptyFile)
+{
+  nsCOMPtr<nsIFile> file;
+  CreateTempFile(EmptyCString(), getter_AddRefs(file));
+
+  nsCOMPtr<nsIInputStream> stream;
+  nsresult rv = NS_NewMemoryMappedInputStream(getter_AddRefs(stream), file);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  uint64_t available = 42;
+  rv = stream->Available(&available);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(uint64_t(0), available);
+
+  char buf[16];
+  uint32_t numRead = 42;
+  rv = stream->Read(buf, sizeof(buf), &numRead);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(uint32_t(0), numRead);
+
+  file->Remove(false);
+}
@@ -78,6 +78,14 @@ class nsHtml5AtomTable
      */
     nsAtom* GetAtom(const nsAString& aKey);
     
+    /**
+     * Returns the number of dynamic atoms in the table.
+     */
+    uint32_t Count() const
+    {
+      return mTable.Count();
+    }
+
     /**
      * Empties the table.
      */
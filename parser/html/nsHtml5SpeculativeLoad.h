@@ -5,6 +5,7 @@
 #ifndef nsHtml5SpeculativeLoad_h
 #define nsHtml5SpeculativeLoad_h
 
+#include "mozilla/Move.h"
 #include "nsString.h"
 #include "nsContentUtils.h"
 
@@ -161,6 +162,41 @@ class nsHtml5SpeculativeLoad {
       aIntegrity.ToString(mTypeOrCharsetSourceOrDocumentModeOrMetaCSPOrSizesOrIntegrity);
     }
 
+    /**
+     * Speculative load for an @import sheet found by scanning the text of an
+     * inline <style>. Reuses the <link rel=stylesheet> preload path, with no
+     * charset, cross origin, referrer policy or integrity metadata, since
+     * @import rules carry none.
+     */
+    inline void InitImportStyle(nsString&& aUrl)
+    {
+      NS_PRECONDITION(mOpCode == eSpeculativeLoadUninitialized,
+                      "Trying to reinitialize a speculative load!");
+      mOpCode = eSpeculativeLoadStyle;
+      mUrlOrSizes = mozilla::Move(aUrl);
+      mCharsetOrSrcset.SetIsVoid(true);
+      mCrossOriginOrMedia.SetIsVoid(true);
+      mReferrerPolicyOrIntegrity.SetIsVoid(true);
+      mTypeOrCharsetSourceOrDocumentModeOrMetaCSPOrSizesOrIntegrity.SetIsVoid(
+        true);
+    }
+
+    /**
+     * Speculative preconnect for a font URL found inside a @font-face block
+     * when scanning the text of an inline <style>. There is no font preload
+     * machinery to hand the URL to, so warming up the connection is the best
+     * we can do; fonts always load as anonymous CORS fetches, so the
+     * preconnect does, too.
+     */
+    inline void InitFontPreconnect(nsString&& aUrl)
+    {
+      NS_PRECONDITION(mOpCode == eSpeculativeLoadUninitialized,
+                      "Trying to reinitialize a speculative load!");
+      mOpCode = eSpeculativeLoadPreconnect;
+      mUrlOrSizes = mozilla::Move(aUrl);
+      mCrossOriginOrMedia.AssignLiteral("anonymous");
+    }
+
     /**
      * "Speculative" manifest loads aren't truly speculative--if a manifest
      * gets loaded, we are committed to it. There can never be a <script>
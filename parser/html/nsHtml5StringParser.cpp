@@ -123,6 +123,15 @@ nsHtml5StringParser::Tokenize(const nsAString& aSourceBuffer,
   }
   mTokenizer->end();
   mBuilder->Finish();
-  mAtomTable.Clear();
+  // Dynamic parser atoms (data-* style attribute names, custom element
+  // names) would be re-created on the very next fragment parse if the table
+  // were emptied eagerly, and framework-driven innerHTML churn re-encounters
+  // the same names over and over.  Keep the table across parses the way
+  // nsHtml5Parser keeps its own table across buffers, and only empty it once
+  // it has grown enough to suggest data-driven unique names.
+  static const uint32_t kMaxKeptFragmentParserAtoms = 512;
+  if (mAtomTable.Count() > kMaxKeptFragmentParserAtoms) {
+    mAtomTable.Clear();
+  }
   return rv;
 }
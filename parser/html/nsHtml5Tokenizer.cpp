@@ -507,6 +507,7 @@ nsHtml5Tokenizer::stateLoop(int32_t state, char16_t c, int32_t pos, char16_t* bu
               silentLineFeed();
             }
             default: {
+              pos = ScanTextRun(buf, '<', pos, endPos);
               continue;
             }
           }
@@ -922,6 +923,11 @@ nsHtml5Tokenizer::stateLoop(int32_t state, char16_t c, int32_t pos, char16_t* bu
             }
             default: {
               appendStrBuf(c);
+              int32_t start = pos + 1;
+              pos = ScanTextRun(buf, '\"', pos, endPos);
+              if (pos >= start) {
+                appendStrBuf(buf, start, pos - start + 1);
+              }
               continue;
             }
           }
@@ -1651,6 +1657,11 @@ nsHtml5Tokenizer::stateLoop(int32_t state, char16_t c, int32_t pos, char16_t* bu
             }
             default: {
               appendStrBuf(c);
+              int32_t start = pos + 1;
+              pos = ScanTextRun(buf, '\'', pos, endPos);
+              if (pos >= start) {
+                appendStrBuf(buf, start, pos - start + 1);
+              }
               continue;
             }
           }
@@ -2198,6 +2209,7 @@ nsHtml5Tokenizer::stateLoop(int32_t state, char16_t c, int32_t pos, char16_t* bu
               silentLineFeed();
             }
             default: {
+              pos = ScanTextRun(buf, '<', pos, endPos);
               continue;
             }
           }
@@ -3,6 +3,12 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "mozilla/Likely.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/SSE.h"
+
+#ifdef MOZILLA_PRESUME_SSE2
+#include <emmintrin.h>
+#endif
 
 // INT32_MAX is (2^31)-1. Therefore, the highest power-of-two that fits
 // is 2^30. Note that this is counting char16_t units. The underlying
@@ -59,6 +65,52 @@ nsHtml5Tokenizer::EnsureBufferSpace(int32_t aLength)
   return true;
 }
 
+// static
+int32_t
+nsHtml5Tokenizer::ScanTextRun(const char16_t* aBuf,
+                              char16_t aStop,
+                              int32_t aPos,
+                              int32_t aEndPos)
+{
+  // aBuf[aPos] has already been consumed by the caller's switch; start
+  // looking at the next code unit.
+  int32_t pos = aPos + 1;
+
+#ifdef MOZILLA_PRESUME_SSE2
+  const __m128i stop = _mm_set1_epi16(aStop);
+  const __m128i amp = _mm_set1_epi16('&');
+  const __m128i nul = _mm_setzero_si128();
+  const __m128i cr = _mm_set1_epi16('\r');
+  const __m128i lf = _mm_set1_epi16('\n');
+  while (pos + 8 <= aEndPos) {
+    __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aBuf + pos));
+    __m128i hits =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(chunk, stop),
+                                _mm_cmpeq_epi16(chunk, amp)),
+                   _mm_or_si128(_mm_cmpeq_epi16(chunk, nul),
+                                _mm_or_si128(_mm_cmpeq_epi16(chunk, cr),
+                                             _mm_cmpeq_epi16(chunk, lf))));
+    int32_t mask = _mm_movemask_epi8(hits);
+    if (mask) {
+      // Two mask bits per code unit; the first set bit locates the first
+      // special code unit in the chunk.
+      return pos + (mozilla::CountTrailingZeroes32(mask) >> 1) - 1;
+    }
+    pos += 8;
+  }
+#endif
+
+  while (pos < aEndPos) {
+    char16_t c = aBuf[pos];
+    if (c == aStop || c == '&' || c == '\0' || c == '\r' || c == '\n') {
+      break;
+    }
+    ++pos;
+  }
+  return pos - 1;
+}
+
 void
 nsHtml5Tokenizer::StartPlainText()
 {
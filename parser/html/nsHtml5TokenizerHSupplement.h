@@ -17,6 +17,19 @@ inline nsHtml5HtmlAttributes* GetAttributes()
  */
 bool EnsureBufferSpace(int32_t aLength);
 
+/**
+ * Scans ahead from aPos for the next code unit that the data, RCDATA or
+ * quoted attribute value states have to handle specially ('&', '\0', '\r',
+ * '\n' or aStop, which is '<' or the quote character depending on the
+ * state). Returns the index of the last code unit before it (at least aPos),
+ * so the state loops can consume long runs of plain text without taking the
+ * switch for every code unit. Uses SSE2 where the target guarantees it.
+ */
+static int32_t ScanTextRun(const char16_t* aBuf,
+                           char16_t aStop,
+                           int32_t aPos,
+                           int32_t aEndPos);
+
 nsAutoPtr<nsHtml5Highlighter> mViewSource;
 
 /**
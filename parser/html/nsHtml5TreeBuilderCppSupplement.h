@@ -25,6 +25,7 @@ nsHtml5TreeBuilder::nsHtml5TreeBuilder(nsHtml5OplessBuilder* aBuilder)
   , mHandles(nullptr)
   , mHandlesUsed(0)
   , mSpeculativeLoadStage(nullptr)
+  , mSpeculativeStyleElement(nullptr)
   , mBroken(NS_OK)
   , mCurrentHtmlScriptIsAsyncOrDefer(false)
   , mPreventScriptExecution(false)
@@ -50,6 +51,7 @@ nsHtml5TreeBuilder::nsHtml5TreeBuilder(nsAHtml5TreeOpSink* aOpSink,
   , mHandles(new nsIContent*[NS_HTML5_TREE_BUILDER_HANDLE_ARRAY_LENGTH])
   , mHandlesUsed(0)
   , mSpeculativeLoadStage(aStage)
+  , mSpeculativeStyleElement(nullptr)
   , mBroken(NS_OK)
   , mCurrentHtmlScriptIsAsyncOrDefer(false)
   , mPreventScriptExecution(false)
@@ -243,6 +245,11 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace,
           nsHtml5TreeOperation* treeOp = mOpQueue.AppendElement();
           NS_ASSERTION(treeOp, "Tree op allocation failed.");
           treeOp->Init(eTreeOpSetStyleLineNumber, content, tokenizer->getLineNumber());
+
+          // Start accumulating the sheet text so that it can be scanned for
+          // speculative loads when the element is popped.
+          mSpeculativeStyleElement = content;
+          mSpeculativeStyleText.Truncate();
         } else if (nsGkAtoms::html == aName) {
           nsHtml5String url =
             aAttributes->getValue(nsHtml5AttributeName::ATTR_MANIFEST);
@@ -312,6 +319,11 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace,
           NS_ASSERTION(treeOp, "Tree op allocation failed.");
           treeOp->Init(eTreeOpSetStyleLineNumber, content, tokenizer->getLineNumber());
 
+          // Start accumulating the sheet text so that it can be scanned for
+          // speculative loads when the element is popped.
+          mSpeculativeStyleElement = content;
+          mSpeculativeStyleText.Truncate();
+
           nsHtml5String url =
             aAttributes->getValue(nsHtml5AttributeName::ATTR_XLINK_HREF);
           if (url) {
@@ -606,6 +618,15 @@ nsHtml5TreeBuilder::appendCharacters(nsIContentHandle* aParent, char16_t* aBuffe
     return;
   }
 
+  if (mSpeculativeLoadStage && aParent == mSpeculativeStyleElement) {
+    if (!mSpeculativeStyleText.Append(aBuffer, aLength, mozilla::fallible)) {
+      // Styles too large to accumulate just don't get scanned for
+      // speculative loads. Not a parse error.
+      mSpeculativeStyleElement = nullptr;
+      mSpeculativeStyleText.Truncate();
+    }
+  }
+
   char16_t* bufferCopy = new (mozilla::fallible) char16_t[aLength];
   if (!bufferCopy) {
     // Just assigning mBroken instead of generating tree op. The caller
@@ -616,13 +637,242 @@ nsHtml5TreeBuilder::appendCharacters(nsIContentHandle* aParent, char16_t* aBuffe
   }
 
   memcpy(bufferCopy, aBuffer, aLength * sizeof(char16_t));
-  
+
   nsHtml5TreeOperation* treeOp = mOpQueue.AppendElement();
   NS_ASSERTION(treeOp, "Tree op allocation failed.");
   treeOp->Init(eTreeOpAppendText, bufferCopy, aLength,
       deepTreeSurrogateParent ? deepTreeSurrogateParent : aParent);
 }
 
+// Helpers for finding speculatively loadable URLs in inline style text.
+// These don't aspire to be a CSS tokenizer; they only need to recognize
+// URLs that are safe bets, erring on the side of loading nothing.
+
+static bool
+IsStyleWhitespace(char16_t aC)
+{
+  return aC == ' ' || aC == '\t' || aC == '\n' || aC == '\f' || aC == '\r';
+}
+
+static uint32_t
+SkipStyleWhitespace(const nsString& aText, uint32_t aPos)
+{
+  uint32_t len = aText.Length();
+  while (aPos < len && IsStyleWhitespace(aText[aPos])) {
+    ++aPos;
+  }
+  return aPos;
+}
+
+static uint32_t
+SkipStyleWhitespaceAndComments(const nsString& aText, uint32_t aPos)
+{
+  uint32_t len = aText.Length();
+  for (;;) {
+    aPos = SkipStyleWhitespace(aText, aPos);
+    if (aPos + 1 < len && aText[aPos] == '/' && aText[aPos + 1] == '*') {
+      aPos += 2;
+      while (aPos + 1 < len &&
+             !(aText[aPos] == '*' && aText[aPos + 1] == '/')) {
+        ++aPos;
+      }
+      aPos = (aPos + 1 < len) ? aPos + 2 : len;
+      continue;
+    }
+    return aPos;
+  }
+}
+
+/**
+ * Matches an ASCII literal at aPos, lowercasing the text being scanned.
+ */
+static bool
+StyleTextMatchesLowerCase(const nsString& aText,
+                          uint32_t aPos,
+                          const char* aLiteral)
+{
+  uint32_t len = aText.Length();
+  for (; *aLiteral; ++aLiteral, ++aPos) {
+    if (aPos >= len) {
+      return false;
+    }
+    char16_t c = aText[aPos];
+    if (c >= 'A' && c <= 'Z') {
+      c += 0x20;
+    }
+    if (c != static_cast<char16_t>(*aLiteral)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Consumes a CSS string at aPos (the caller has seen the opening quote)
+ * and returns its non-empty value in aUrl, or returns false without
+ * advancing aPos. Strings containing escapes are given up on.
+ */
+static bool
+ScanStyleString(const nsString& aText, uint32_t& aPos, nsString& aUrl)
+{
+  uint32_t len = aText.Length();
+  uint32_t pos = aPos;
+  char16_t quote = aText[pos++];
+  uint32_t start = pos;
+  while (pos < len && aText[pos] != quote) {
+    char16_t c = aText[pos];
+    if (c == '\\' || c == '\n' || c == '\r' || c == '\f') {
+      // Escapes aren't worth handling and an unescaped newline makes the
+      // string invalid anyway.
+      return false;
+    }
+    ++pos;
+  }
+  if (pos == len || pos == start) {
+    return false;
+  }
+  aUrl = Substring(aText, start, pos - start);
+  aPos = pos + 1;
+  return true;
+}
+
+/**
+ * Consumes a url() function at aPos (the caller has matched "url(") and
+ * returns its non-empty value in aUrl, or returns false. Values containing
+ * escapes are given up on.
+ */
+static bool
+ScanStyleUrlFunction(const nsString& aText, uint32_t& aPos, nsString& aUrl)
+{
+  uint32_t len = aText.Length();
+  uint32_t pos = SkipStyleWhitespace(aText, aPos + 4);
+  if (pos < len && (aText[pos] == '"' || aText[pos] == '\'')) {
+    if (!ScanStyleString(aText, pos, aUrl)) {
+      return false;
+    }
+  } else {
+    uint32_t start = pos;
+    while (pos < len && aText[pos] != ')' && !IsStyleWhitespace(aText[pos])) {
+      char16_t c = aText[pos];
+      if (c == '\\' || c == '"' || c == '\'' || c == '(') {
+        return false;
+      }
+      ++pos;
+    }
+    if (pos == start) {
+      return false;
+    }
+    aUrl = Substring(aText, start, pos - start);
+  }
+  pos = SkipStyleWhitespace(aText, pos);
+  if (pos == len || aText[pos] != ')') {
+    return false;
+  }
+  aPos = pos + 1;
+  return true;
+}
+
+void
+nsHtml5TreeBuilder::ScanSpeculativeStyleText()
+{
+  const nsString& text = mSpeculativeStyleText;
+  const uint32_t len = text.Length();
+  uint32_t pos = 0;
+  // @import is only valid before any other rule, so stop looking for
+  // imports once the first block is seen.
+  bool mayImport = true;
+  // Brace depth, and the depth inside an open @font-face block, or -1 when
+  // not inside one. @font-face can appear at the top level or nested in a
+  // grouping rule such as @media.
+  int32_t depth = 0;
+  int32_t fontFaceDepth = -1;
+  bool atFontFace = false; // saw @font-face, waiting for its block to open
+
+  while (pos < len) {
+    char16_t c = text[pos];
+    if (c == '/' && pos + 1 < len && text[pos + 1] == '*') {
+      pos = SkipStyleWhitespaceAndComments(text, pos);
+      continue;
+    }
+    if (c == '"' || c == '\'') {
+      // Skip strings so that braces inside them don't confuse the depth
+      // bookkeeping.
+      nsString ignored;
+      if (!ScanStyleString(text, pos, ignored)) {
+        ++pos;
+      }
+      continue;
+    }
+    if (c == '{') {
+      ++depth;
+      mayImport = false;
+      if (atFontFace) {
+        fontFaceDepth = depth;
+        atFontFace = false;
+      }
+      ++pos;
+      continue;
+    }
+    if (c == '}') {
+      if (depth == fontFaceDepth) {
+        fontFaceDepth = -1;
+      }
+      if (depth) {
+        --depth;
+      }
+      ++pos;
+      continue;
+    }
+    if (c == ';') {
+      atFontFace = false;
+      ++pos;
+      continue;
+    }
+    if (c == '@') {
+      if (mayImport && depth == 0 &&
+          StyleTextMatchesLowerCase(text, pos + 1, "import")) {
+        pos = SkipStyleWhitespaceAndComments(text, pos + 7);
+        nsString url;
+        bool found;
+        if (pos < len && (text[pos] == '"' || text[pos] == '\'')) {
+          found = ScanStyleString(text, pos, url);
+        } else if (StyleTextMatchesLowerCase(text, pos, "url(")) {
+          found = ScanStyleUrlFunction(text, pos, url);
+        } else {
+          found = false;
+        }
+        if (found) {
+          // Only preload imports that apply unconditionally; evaluating a
+          // media query or supports() condition isn't possible here.
+          uint32_t end = SkipStyleWhitespaceAndComments(text, pos);
+          if (end < len && text[end] == ';') {
+            mSpeculativeLoadQueue.AppendElement()->InitImportStyle(
+              mozilla::Move(url));
+          }
+        }
+        continue;
+      }
+      if (StyleTextMatchesLowerCase(text, pos + 1, "font-face")) {
+        atFontFace = true;
+        pos += 10;
+        continue;
+      }
+      ++pos;
+      continue;
+    }
+    if (depth == fontFaceDepth && (c == 'u' || c == 'U') &&
+        StyleTextMatchesLowerCase(text, pos, "url(")) {
+      nsString url;
+      if (ScanStyleUrlFunction(text, pos, url)) {
+        mSpeculativeLoadQueue.AppendElement()->InitFontPreconnect(
+          mozilla::Move(url));
+        continue;
+      }
+    }
+    ++pos;
+  }
+}
+
 void
 nsHtml5TreeBuilder::appendComment(nsIContentHandle* aParent, char16_t* aBuffer, int32_t aStart, int32_t aLength)
 {
@@ -908,6 +1158,13 @@ nsHtml5TreeBuilder::elementPopped(int32_t aNamespace, nsAtom* aName, nsIContentH
   }
   if (aName == nsGkAtoms::style ||
       (aNamespace == kNameSpaceID_XHTML && aName == nsGkAtoms::link)) {
+    if (aElement == mSpeculativeStyleElement) {
+      if (mSpeculativeLoadStage) {
+        ScanSpeculativeStyleText();
+      }
+      mSpeculativeStyleElement = nullptr;
+      mSpeculativeStyleText.Truncate();
+    }
     if (mBuilder) {
       MOZ_ASSERT(!nsContentUtils::IsSafeToRunScript(),
         "Scripts must be blocked.");
@@ -1167,6 +1424,10 @@ nsHtml5TreeBuilder::DropHandles()
   MOZ_ASSERT(!mBuilder, "Must not drop handles with builder.");
   mOldHandles.Clear();
   mHandlesUsed = 0;
+  // A handle that was dropped mustn't be compared against handles that get
+  // allocated later.
+  mSpeculativeStyleElement = nullptr;
+  mSpeculativeStyleText.Truncate();
 }
 
 void
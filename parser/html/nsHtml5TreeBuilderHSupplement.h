@@ -20,6 +20,17 @@
     int32_t                                mHandlesUsed;
     nsTArray<mozilla::UniquePtr<nsIContent*[]>> mOldHandles;
     nsHtml5TreeOpStage*                    mSpeculativeLoadStage;
+    /**
+     * The handle of the <style> element whose text is currently being
+     * accumulated for speculative load scanning, or nullptr if there is no
+     * such element.
+     */
+    nsIContentHandle*                      mSpeculativeStyleElement;
+    /**
+     * The text seen so far of the <style> element that
+     * mSpeculativeStyleElement is a handle to.
+     */
+    nsString                               mSpeculativeStyleText;
     nsresult                               mBroken;
     bool                                   mCurrentHtmlScriptIsAsyncOrDefer;
     bool                                   mPreventScriptExecution;
@@ -75,6 +86,14 @@
 
     void MarkAsBrokenFromPortability(nsresult aRv);
 
+    /**
+     * Scans mSpeculativeStyleText for @import rules that have no media query
+     * and for url() values inside @font-face blocks and queues speculative
+     * loads for what it finds. Only called in the off-the-main-thread tree
+     * builder, when the <style> element the text belongs to is popped.
+     */
+    void ScanSpeculativeStyleText();
+
   public:
 
     explicit nsHtml5TreeBuilder(nsHtml5OplessBuilder* aBuilder);
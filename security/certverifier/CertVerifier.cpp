@@ -16,15 +16,18 @@
 #include "NSSCertDBTrustDomain.h"
 #include "NSSErrorsService.h"
 #include "cert.h"
+#include "mozilla/ArrayUtils.h"
 #include "mozilla/Assertions.h"
 #include "mozilla/Casting.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Unused.h"
 #include "nsNSSComponent.h"
 #include "nsPromiseFlatString.h"
 #include "nsServiceManagerUtils.h"
 #include "pk11pub.h"
 #include "pkix/pkix.h"
 #include "pkix/pkixnss.h"
+#include "prtime.h"
 #include "secmod.h"
 
 using namespace mozilla::ct;
@@ -873,6 +876,209 @@ CertVerifier::VerifyCert(CERTCertificate* cert, SECCertificateUsage usage,
   return Success;
 }
 
+// The number of verified chains kept by VerifiedChainCache. The cache is
+// meant to absorb reconnects to the handful of origins a session talks to
+// repeatedly, not to memoize everything we ever verified.
+static const size_t MAX_VERIFIED_CHAIN_CACHE_ENTRIES = 128;
+
+// static
+uint64_t
+VerifiedChainCache::TimeBucket()
+{
+  // One-hour buckets: a cached verification is reusable until the top of
+  // the hour in which it was created.
+  return static_cast<uint64_t>(PR_Now() / (PR_USEC_PER_SEC * 3600));
+}
+
+VerifiedChainCache::VerifiedChainCache()
+  : mMutex("VerifiedChainCache-mutex")
+{
+}
+
+static UniqueCERTCertList
+DuplicateCertList(const UniqueCERTCertList& certList)
+{
+  UniqueCERTCertList copy(CERT_NewCertList());
+  if (!copy) {
+    return nullptr;
+  }
+  for (CERTCertListNode* node = CERT_LIST_HEAD(certList);
+       !CERT_LIST_END(node, certList); node = CERT_LIST_NEXT(node)) {
+    UniqueCERTCertificate cert(CERT_DupCertificate(node->cert));
+    if (!cert) {
+      return nullptr;
+    }
+    if (CERT_AddCertToListTail(copy.get(), cert.get()) != SECSuccess) {
+      return nullptr;
+    }
+    Unused << cert.release(); // Ownership transferred to the list.
+  }
+  return copy;
+}
+
+bool
+VerifiedChainCache::Get(const SHA384Buffer& aKeyHash,
+                        /*out*/ UniqueCERTCertList& builtChain,
+                        /*out*/ SECOidTag& evOidPolicy)
+{
+  MutexAutoLock lock(mMutex);
+  uint64_t bucket = TimeBucket();
+  for (size_t i = 0; i < mEntries.length(); i++) {
+    if (memcmp(mEntries[i].mKeyHash, aKeyHash, SHA384_LENGTH) == 0) {
+      if (mEntries[i].mBucket != bucket) {
+        mEntries.erase(&mEntries[i]);
+        return false;
+      }
+      UniqueCERTCertList chain(DuplicateCertList(mEntries[i].mChain));
+      if (!chain) {
+        return false;
+      }
+      evOidPolicy = mEntries[i].mEvOidPolicy;
+      builtChain = Move(chain);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+VerifiedChainCache::Put(const SHA384Buffer& aKeyHash,
+                        const UniqueCERTCertList& builtChain,
+                        SECOidTag evOidPolicy)
+{
+  UniqueCERTCertList chain(DuplicateCertList(builtChain));
+  if (!chain) {
+    return;
+  }
+  MutexAutoLock lock(mMutex);
+  uint64_t bucket = TimeBucket();
+  for (size_t i = 0; i < mEntries.length(); i++) {
+    if (memcmp(mEntries[i].mKeyHash, aKeyHash, SHA384_LENGTH) == 0) {
+      mEntries[i].mChain = Move(chain);
+      mEntries[i].mEvOidPolicy = evOidPolicy;
+      mEntries[i].mBucket = bucket;
+      return;
+    }
+  }
+  if (mEntries.length() >= MAX_VERIFIED_CHAIN_CACHE_ENTRIES) {
+    // Evict the oldest entry.
+    mEntries.erase(mEntries.begin());
+  }
+  Entry entry;
+  memcpy(entry.mKeyHash, aKeyHash, SHA384_LENGTH);
+  entry.mChain = Move(chain);
+  entry.mEvOidPolicy = evOidPolicy;
+  entry.mBucket = bucket;
+  Unused << mEntries.append(Move(entry));
+}
+
+void
+VerifiedChainCache::Clear()
+{
+  MutexAutoLock lock(mMutex);
+  mEntries.clear();
+}
+
+static SECStatus
+DigestLengthPrefixed(UniquePK11Context& context, const uint8_t* data,
+                     uint32_t length)
+{
+  uint8_t lengthBytes[4];
+  lengthBytes[0] = length & 255;
+  lengthBytes[1] = (length >> 8) & 255;
+  lengthBytes[2] = (length >> 16) & 255;
+  lengthBytes[3] = (length >> 24) & 255;
+  SECStatus srv = PK11_DigestOp(context.get(), lengthBytes,
+                                MOZ_ARRAY_LENGTH(lengthBytes));
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  if (length == 0) {
+    return SECSuccess;
+  }
+  return PK11_DigestOp(context.get(), data, length);
+}
+
+// Computes the VerifiedChainCache key for a TLS server certificate
+// verification: a SHA-384 digest over every input that determines the
+// outcome. The peer certificate's DER encoding is self-delimiting; every
+// variable-length input after it is length-prefixed, so no two distinct
+// input tuples produce the same digested byte stream. The verifier's own
+// configuration does not need to be part of the key because preference
+// changes replace the CertVerifier instance, and the time bucket keeps
+// entries from outliving the hour of revocation information they were
+// verified against.
+static SECStatus
+HashVerificationKey(const UniqueCERTCertificate& peerCert,
+                    const nsACString& hostname,
+                    CertVerifier::Flags flags,
+                    const SECItem* stapledOCSPResponse,
+                    const SECItem* sctsFromTLS,
+                    const OriginAttributes& originAttributes,
+                    bool wantsEvStatus,
+                    uint64_t timeBucket,
+                    /*out*/ SHA384Buffer& keyHash)
+{
+  UniquePK11Context context(PK11_CreateDigestContext(SEC_OID_SHA384));
+  if (!context) {
+    return SECFailure;
+  }
+  SECStatus srv = PK11_DigestBegin(context.get());
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  srv = PK11_DigestOp(context.get(), peerCert->derCert.data,
+                      peerCert->derCert.len);
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  uint8_t scalars[13];
+  for (size_t i = 0; i < 8; i++) {
+    scalars[i] = (timeBucket >> (8 * i)) & 255;
+  }
+  for (size_t i = 0; i < 4; i++) {
+    scalars[8 + i] = (flags >> (8 * i)) & 255;
+  }
+  scalars[12] = wantsEvStatus ? 1 : 0;
+  srv = PK11_DigestOp(context.get(), scalars, MOZ_ARRAY_LENGTH(scalars));
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  srv = DigestLengthPrefixed(
+    context, BitwiseCast<const uint8_t*, const char*>(hostname.BeginReading()),
+    hostname.Length());
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  srv = DigestLengthPrefixed(context,
+                             stapledOCSPResponse ? stapledOCSPResponse->data
+                                                 : nullptr,
+                             stapledOCSPResponse ? stapledOCSPResponse->len
+                                                 : 0);
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  srv = DigestLengthPrefixed(context, sctsFromTLS ? sctsFromTLS->data : nullptr,
+                             sctsFromTLS ? sctsFromTLS->len : 0);
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  NS_ConvertUTF16toUTF8 firstPartyDomain(originAttributes.mFirstPartyDomain);
+  srv = DigestLengthPrefixed(
+    context,
+    BitwiseCast<const uint8_t*, const char*>(firstPartyDomain.get()),
+    firstPartyDomain.Length());
+  if (srv != SECSuccess) {
+    return srv;
+  }
+  uint32_t outLen = 0;
+  srv = PK11_DigestFinal(context.get(), keyHash, &outLen, SHA384_LENGTH);
+  if (outLen != SHA384_LENGTH) {
+    return SECFailure;
+  }
+  return srv;
+}
+
 Result
 CertVerifier::VerifySSLServerCert(const UniqueCERTCertificate& peerCert,
                      /*optional*/ const SECItem* stapledOCSPResponse,
@@ -903,6 +1109,44 @@ CertVerifier::VerifySSLServerCert(const UniqueCERTCertificate& peerCert,
     return Result::ERROR_BAD_CERT_DOMAIN;
   }
 
+  // Consult the cache of recent successful verifications. Only complete
+  // successes are cached, and the key covers every input the checks below
+  // depend on, so on a hit the chain, hostname and TLS feature checks have
+  // all already passed for identical inputs. The telemetry out-parameters
+  // other than evOidPolicy are left untouched on a hit; they were
+  // accumulated when the entry was created.
+  // Only verifications for (approximately) the current time take part in
+  // the cache; nsIX509CertDB.verifyCertAtTime may ask about arbitrary
+  // times, and those results must not be served to live TLS handshakes or
+  // vice versa.
+  Time latestCacheableTime(Now());
+  Time earliestCacheableTime(Now());
+  bool timeIsNow =
+    latestCacheableTime.AddSeconds(Time::ONE_DAY_IN_SECONDS / 24) == Success &&
+    time <= latestCacheableTime &&
+    earliestCacheableTime.SubtractSeconds(Time::ONE_DAY_IN_SECONDS / 24) ==
+      Success &&
+    earliestCacheableTime <= time;
+  SHA384Buffer keyHash;
+  bool haveKey =
+    timeIsNow &&
+    HashVerificationKey(peerCert, hostname, flags, stapledOCSPResponse,
+                        sctsFromTLS, originAttributes, evOidPolicy != nullptr,
+                        VerifiedChainCache::TimeBucket(), keyHash) ==
+    SECSuccess;
+  if (haveKey) {
+    SECOidTag cachedEvOidPolicy;
+    if (mVerifiedChainCache.Get(keyHash, builtChain, cachedEvOidPolicy)) {
+      if (evOidPolicy) {
+        *evOidPolicy = cachedEvOidPolicy;
+      }
+      if (saveIntermediatesInPermanentDatabase) {
+        SaveIntermediateCerts(builtChain);
+      }
+      return Success;
+    }
+  }
+
   // CreateCertErrorRunnable assumes that CheckCertHostname is only called
   // if VerifyCert succeeded.
   Result rv = VerifyCert(peerCert.get(), certificateUsageSSLServer, time,
@@ -969,6 +1213,11 @@ CertVerifier::VerifySSLServerCert(const UniqueCERTCertificate& peerCert,
     SaveIntermediateCerts(builtChain);
   }
 
+  if (haveKey) {
+    mVerifiedChainCache.Put(keyHash, builtChain,
+                            evOidPolicy ? *evOidPolicy : SEC_OID_UNKNOWN);
+  }
+
   return Success;
 }
 
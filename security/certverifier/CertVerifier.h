@@ -96,6 +96,47 @@ public:
 
 class NSSCertDBTrustDomain;
 
+// A small in-memory cache of recently successful TLS server certificate
+// verifications. Entries are keyed by a SHA-384 digest over every input
+// that determines the verification result and are only valid within the
+// time bucket in which they were created, so newly fetched revocation
+// information and policy updates are picked up promptly; explicit trust
+// changes clear the cache outright. The cache deliberately lives only in
+// memory: persisting verification decisions would let them outlive trust
+// and revocation changes.
+class VerifiedChainCache
+{
+public:
+  VerifiedChainCache();
+
+  // If a still-valid entry for aKeyHash exists, duplicates its chain into
+  // builtChain, sets evOidPolicy, and returns true.
+  bool Get(const SHA384Buffer& aKeyHash,
+   /*out*/ UniqueCERTCertList& builtChain,
+   /*out*/ SECOidTag& evOidPolicy);
+  void Put(const SHA384Buffer& aKeyHash,
+           const UniqueCERTCertList& builtChain,
+           SECOidTag evOidPolicy);
+  void Clear();
+
+  // The coarse timestamp that bounds the lifetime of an entry. It is also
+  // digested into the cache key by the caller.
+  static uint64_t TimeBucket();
+
+private:
+  class Entry
+  {
+  public:
+    SHA384Buffer mKeyHash;
+    UniqueCERTCertList mChain;
+    SECOidTag mEvOidPolicy;
+    uint64_t mBucket;
+  };
+
+  Mutex mMutex;
+  Vector<Entry, 16> mEntries;
+};
+
 class CertVerifier
 {
 public:
@@ -198,6 +239,7 @@ public:
   ~CertVerifier();
 
   void ClearOCSPCache() { mOCSPCache.Clear(); }
+  void ClearVerifiedChainCache() { mVerifiedChainCache.Clear(); }
 
   const OcspDownloadConfig mOCSPDownloadConfig;
   const bool mOCSPStrict;
@@ -213,6 +255,7 @@ public:
 
 private:
   OCSPCache mOCSPCache;
+  VerifiedChainCache mVerifiedChainCache;
 
   // We only have a forward declarations of these classes (see above)
   // so we must allocate dynamically.
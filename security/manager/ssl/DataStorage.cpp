@@ -588,6 +588,12 @@ DataStorage::WaitForReady()
 {
   MOZ_DIAGNOSTIC_ASSERT(mInitCalled, "Waiting before Init() has been called?");
 
+  // Fast path: initialization only happens once, so after it has completed
+  // there's no need to take the monitor on every lookup.
+  if (mReady) {
+    return;
+  }
+
   MonitorAutoLock readyLock(mReadyMonitor);
   while (!mReady) {
     nsresult rv = readyLock.Wait();
@@ -226,7 +226,9 @@ private:
   mozilla::Atomic<bool> mInitCalled; // Indicates that Init() has been called.
 
   Monitor mReadyMonitor; // Do not acquire this at the same time as mMutex.
-  bool mReady; // Indicates that saved data has been read and Get can proceed.
+  // Indicates that saved data has been read and Get can proceed. Atomic so
+  // that WaitForReady can skip the monitor once initialization is done.
+  mozilla::Atomic<bool, mozilla::ReleaseAcquire> mReady;
 
   const nsString mFilename;
 
@@ -221,9 +221,22 @@ ChangeCertTrustWithPossibleAuthentication(const UniqueCERTCertificate& cert,
     PR_SetError(SEC_ERROR_LIBRARY_FAILURE, 0);
     return SECFailure;
   }
+
+  // Previously cached verification results may rest on the old trust
+  // settings.
+  auto clearVerifiedChainCache = []() {
+    RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
+    if (certVerifier) {
+      certVerifier->ClearVerifiedChainCache();
+    }
+  };
+
   // NSS ignores the first argument to CERT_ChangeCertTrust
   SECStatus srv = CERT_ChangeCertTrust(nullptr, cert.get(), &trust);
   if (srv == SECSuccess || PR_GetError() != SEC_ERROR_TOKEN_NOT_LOGGED_IN) {
+    if (srv == SECSuccess) {
+      clearVerifiedChainCache();
+    }
     return srv;
   }
   if (cert->slot) {
@@ -238,7 +251,11 @@ ChangeCertTrustWithPossibleAuthentication(const UniqueCERTCertificate& cert,
   if (srv != SECSuccess) {
     return srv;
   }
-  return CERT_ChangeCertTrust(nullptr, cert.get(), &trust);
+  srv = CERT_ChangeCertTrust(nullptr, cert.get(), &trust);
+  if (srv == SECSuccess) {
+    clearVerifiedChainCache();
+  }
+  return srv;
 }
 
 static nsresult
@@ -1530,5 +1547,6 @@ nsNSSCertificateDB::ClearOCSPCache()
   RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
   NS_ENSURE_TRUE(certVerifier, NS_ERROR_FAILURE);
   certVerifier->ClearOCSPCache();
+  certVerifier->ClearVerifiedChainCache();
   return NS_OK;
 }
@@ -1433,9 +1433,14 @@ nsSiteSecurityService::HostHasHSTSEntry(
   SetStorageKey(aHost, nsISiteSecurityService::HEADER_HSTS, OriginAttributes(),
                 preloadKey);
   nsCString value = mSiteStateStorage->Get(storageKey, storageType);
-  RefPtr<SiteHSTSState> siteState =
-    new SiteHSTSState(aHost, aOriginAttributes, value);
-  if (siteState->mHSTSState != SecurityPropertyUnset) {
+  // Don't allocate and parse a SiteHSTSState for the common case of no
+  // stored data for this host - almost every host we're asked about has
+  // no entry at all.
+  RefPtr<SiteHSTSState> siteState;
+  if (!value.IsEmpty()) {
+    siteState = new SiteHSTSState(aHost, aOriginAttributes, value);
+  }
+  if (siteState && siteState->mHSTSState != SecurityPropertyUnset) {
     SSSLOG(("Found HSTS entry for %s", aHost.get()));
     bool expired = siteState->IsExpired(nsISiteSecurityService::HEADER_HSTS);
     if (!expired) {
@@ -1473,9 +1478,12 @@ nsSiteSecurityService::HostHasHSTSEntry(
       // First, check the dynamic preload list.
       value = mPreloadStateStorage->Get(preloadKey,
                                         mozilla::DataStorage_Persistent);
-      RefPtr<SiteHSTSState> dynamicState =
-        new SiteHSTSState(aHost, aOriginAttributes, value);
-      if (dynamicState->mHSTSState == SecurityPropertyUnset) {
+      RefPtr<SiteHSTSState> dynamicState;
+      if (!value.IsEmpty()) {
+        dynamicState = new SiteHSTSState(aHost, aOriginAttributes, value);
+      }
+      if (!dynamicState ||
+          dynamicState->mHSTSState == SecurityPropertyUnset) {
         SSSLOG(("No dynamic preload - checking for static preload"));
         // Now check the static preload list.
         if (!GetPreloadStatus(aHost)) {
@@ -1490,9 +1498,11 @@ nsSiteSecurityService::HostHasHSTSEntry(
   // Next, look in the dynamic preload list.
   value = mPreloadStateStorage->Get(preloadKey,
                                     mozilla::DataStorage_Persistent);
-  RefPtr<SiteHSTSState> dynamicState =
-    new SiteHSTSState(aHost, aOriginAttributes, value);
-  if (dynamicState->mHSTSState != SecurityPropertyUnset) {
+  RefPtr<SiteHSTSState> dynamicState;
+  if (!value.IsEmpty()) {
+    dynamicState = new SiteHSTSState(aHost, aOriginAttributes, value);
+  }
+  if (dynamicState && dynamicState->mHSTSState != SecurityPropertyUnset) {
     SSSLOG(("Found dynamic preload entry for %s", aHost.get()));
     bool expired = dynamicState->IsExpired(nsISiteSecurityService::HEADER_HSTS);
     if (!expired) {
@@ -1533,8 +1543,8 @@ nsSiteSecurityService::HostHasHSTSEntry(
   bool includeSubdomains = false;
 
   // Finally look in the static preload list.
-  if (siteState->mHSTSState == SecurityPropertyUnset &&
-      dynamicState->mHSTSState == SecurityPropertyUnset &&
+  if ((!siteState || siteState->mHSTSState == SecurityPropertyUnset) &&
+      (!dynamicState || dynamicState->mHSTSState == SecurityPropertyUnset) &&
       GetPreloadStatus(aHost, &includeSubdomains)) {
     SSSLOG(("%s is a preloaded HSTS host", aHost.get()));
     *aResult = aRequireIncludeSubdomains ? includeSubdomains
@@ -6,6 +6,9 @@
 
 #include "prio.h"
 #include "PLDHashTable.h"
+#include "mozilla/Compression.h"
+#include "mozilla/EndianUtils.h"
+#include "mozilla/FileUtils.h"
 #include "mozilla/IOInterposer.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/scache/StartupCache.h"
@@ -22,11 +25,8 @@
 #include "nsIStartupCache.h"
 #include "nsIStorageStream.h"
 #include "nsIStreamBufferAccess.h"
-#include "nsIStringStream.h"
 #include "nsISupports.h"
 #include "nsITimer.h"
-#include "nsIZipWriter.h"
-#include "nsIZipReader.h"
 #include "nsWeakReference.h"
 #include "nsZipArchive.h"
 #include "mozilla/Omnijar.h"
@@ -74,6 +74,30 @@ StartupCache::CollectReports(nsIHandleReportCallback* aHandleReport,
 
 #define STARTUP_CACHE_NAME "startupCache." SC_WORDSIZE "." SC_ENDIAN
 
+/**
+ * The cache file is a flat little-endian format designed to be memory-mapped
+ * and indexed with minimal up-front work:
+ *
+ *   - MAGIC
+ *   - uint32 size of the header block
+ *   - header block: for each entry, a uint32 key length, the key bytes,
+ *     then the uint32 file offset, compressed size and uncompressed size
+ *     of its data
+ *   - data block: the LZ4-compressed data of each entry
+ *
+ * The header is parsed into mCacheEntries when the file is mapped; entry
+ * data is only decompressed when GetBuffer asks for it.
+ */
+static const uint8_t MAGIC[] = "startupCachev001";
+
+static void
+AppendUint32(nsTArray<uint8_t>& aBuffer, uint32_t aValue)
+{
+  uint8_t bytes[sizeof(uint32_t)];
+  LittleEndian::writeUint32(bytes, aValue);
+  aBuffer.AppendElements(bytes, sizeof(bytes));
+}
+
 StartupCache*
 StartupCache::GetSingleton()
 {
@@ -117,7 +141,7 @@ bool StartupCache::gIgnoreDiskCache;
 NS_IMPL_ISUPPORTS(StartupCache, nsIMemoryReporter)
 
 StartupCache::StartupCache()
-  : mArchive(nullptr), mStartupWriteInitiated(false), mWriteThread(nullptr)
+  : mStartupWriteInitiated(false), mWriteThread(nullptr)
 { }
 
 StartupCache::~StartupCache()
@@ -135,7 +159,7 @@ StartupCache::~StartupCache()
   // it on the main thread and block the shutdown we simply wont update
   // the startup cache. Always do this if the file doesn't exist since
   // we use it part of the package step.
-  if (!mArchive) {
+  if (!mCacheData) {
     WriteToDisk();
   }
 
@@ -233,15 +257,67 @@ StartupCache::LoadArchive()
   if (gIgnoreDiskCache)
     return NS_ERROR_FAILURE;
 
+  mCacheData = nullptr;
+  mCacheEntries.Clear();
+
   bool exists;
-  mArchive = nullptr;
   nsresult rv = mFile->Exists(&exists);
   if (NS_FAILED(rv) || !exists)
     return NS_ERROR_FILE_NOT_FOUND;
 
-  mArchive = new nsZipArchive();
-  rv = mArchive->OpenArchive(mFile);
-  return rv;
+  auto map = MakeUnique<loader::AutoMemMap>();
+  if (map->init(mFile).isErr())
+    return NS_ERROR_UNEXPECTED;
+
+  size_t size = map->size();
+  if (size < sizeof(MAGIC) + sizeof(uint32_t))
+    return NS_ERROR_UNEXPECTED;
+
+  const uint8_t* data = map->get<uint8_t>().get();
+  if (memcmp(MAGIC, data, sizeof(MAGIC)))
+    return NS_ERROR_UNEXPECTED;
+  data += sizeof(MAGIC);
+
+  uint32_t headerSize = LittleEndian::readUint32(data);
+  data += sizeof(uint32_t);
+  if (headerSize > size - sizeof(MAGIC) - sizeof(uint32_t))
+    return NS_ERROR_UNEXPECTED;
+
+  const uint8_t* headerEnd = data + headerSize;
+  while (data < headerEnd) {
+    if (size_t(headerEnd - data) < sizeof(uint32_t)) {
+      mCacheEntries.Clear();
+      return NS_ERROR_UNEXPECTED;
+    }
+    uint32_t keyLength = LittleEndian::readUint32(data);
+    data += sizeof(uint32_t);
+
+    if (size_t(headerEnd - data) < keyLength ||
+        size_t(headerEnd - data) - keyLength < 3 * sizeof(uint32_t)) {
+      mCacheEntries.Clear();
+      return NS_ERROR_UNEXPECTED;
+    }
+    nsCString key(reinterpret_cast<const char*>(data), keyLength);
+    data += keyLength;
+
+    MapEntry entry;
+    entry.offset = LittleEndian::readUint32(data);
+    data += sizeof(uint32_t);
+    entry.compressedSize = LittleEndian::readUint32(data);
+    data += sizeof(uint32_t);
+    entry.uncompressedSize = LittleEndian::readUint32(data);
+    data += sizeof(uint32_t);
+
+    if (entry.offset > size || size - entry.offset < entry.compressedSize) {
+      mCacheEntries.Clear();
+      return NS_ERROR_UNEXPECTED;
+    }
+
+    mCacheEntries.Put(key, entry);
+  }
+
+  mCacheData = Move(map);
+  return NS_OK;
 }
 
 namespace {
@@ -286,13 +362,28 @@ StartupCache::GetBuffer(const char* id, UniquePtr<char[]>* outbuf, uint32_t* len
     }
   }
 
-  nsresult rv = GetBufferFromZipArchive(mArchive, true, id, outbuf, length);
-  if (NS_SUCCEEDED(rv))
-    return rv;
+  if (mCacheData) {
+    MapEntry entry;
+    if (mCacheEntries.Get(nsDependentCString(id), &entry)) {
+      const char* compressed = mCacheData->get<char>().get() + entry.offset;
+      auto buf = MakeUnique<char[]>(entry.uncompressedSize);
+      size_t outputSize = 0;
+      if (!Compression::LZ4::decompress(compressed, entry.compressedSize,
+                                        buf.get(), entry.uncompressedSize,
+                                        &outputSize) ||
+          outputSize != entry.uncompressedSize) {
+        NS_WARNING("StartupCache file is corrupt!");
+        return NS_ERROR_FAILURE;
+      }
+      *outbuf = Move(buf);
+      *length = entry.uncompressedSize;
+      return NS_OK;
+    }
+  }
 
   RefPtr<nsZipArchive> omnijar = mozilla::Omnijar::GetReader(mozilla::Omnijar::APP);
   // no need to checksum omnijarred entries
-  rv = GetBufferFromZipArchive(omnijar, false, id, outbuf, length);
+  nsresult rv = GetBufferFromZipArchive(omnijar, false, id, outbuf, length);
   if (NS_SUCCEEDED(rv))
     return rv;
 
@@ -325,10 +416,8 @@ StartupCache::PutBuffer(const char* id, const char* inbuf, uint32_t len)
   }
 
 #ifdef DEBUG
-  if (mArchive) {
-    nsZipItem* zipItem = mArchive->GetItem(id);
-    NS_ASSERTION(zipItem == nullptr, "Existing entry in disk StartupCache.");
-  }
+  NS_ASSERTION(!mCacheEntries.Contains(idStr),
+               "Existing entry in disk StartupCache.");
 #endif
 
   entry = new CacheEntry(Move(data), len);
@@ -340,7 +429,7 @@ StartupCache::PutBuffer(const char* id, const char* inbuf, uint32_t len)
 size_t
 StartupCache::SizeOfMapping()
 {
-    return mArchive ? mArchive->SizeOfMapping() : 0;
+    return mCacheData ? mCacheData->nonHeapSizeOfExcludingThis() : 0;
 }
 
 size_t
@@ -357,43 +446,11 @@ StartupCache::HeapSizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
     }
 
     n += mPendingWrites.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    n += mCacheEntries.ShallowSizeOfExcludingThis(aMallocSizeOf);
 
     return n;
 }
 
-struct CacheWriteHolder
-{
-  nsCOMPtr<nsIZipWriter> writer;
-  nsCOMPtr<nsIStringInputStream> stream;
-  PRTime time;
-};
-
-static void
-CacheCloseHelper(const nsACString& key, const CacheEntry* data,
-                 const CacheWriteHolder* holder)
-{
-  MOZ_ASSERT(data); // assert key was found in mTable.
-
-  nsresult rv;
-  nsIStringInputStream* stream = holder->stream;
-  nsIZipWriter* writer = holder->writer;
-
-  stream->ShareData(data->data.get(), data->size);
-
-#ifdef DEBUG
-  bool hasEntry;
-  rv = writer->HasEntry(key, &hasEntry);
-  NS_ASSERTION(NS_SUCCEEDED(rv) && hasEntry == false,
-               "Existing entry in disk StartupCache.");
-#endif
-  rv = writer->AddEntryStream(key, holder->time, true, stream, false);
-
-  if (NS_FAILED(rv)) {
-    NS_WARNING("cache entry deleted but not written to disk.");
-  }
-}
-
-
 /**
  * WriteToDisk writes the cache out to disk. Callers of WriteToDisk need to call WaitOnWriteThread
  * to make sure there isn't a write happening on another thread
@@ -407,53 +464,134 @@ StartupCache::WriteToDisk()
   if (mTable.Count() == 0)
     return;
 
-  nsCOMPtr<nsIZipWriter> zipW = do_CreateInstance("@mozilla.org/zipwriter;1");
-  if (!zipW)
-    return;
+  struct WriteEntry
+  {
+    nsCString key;
+    // Compressed data, either freshly compressed from mTable or pointing
+    // into the old mapping for entries carried forward unchanged.
+    const char* data;
+    uint32_t compressedSize;
+    uint32_t uncompressedSize;
+  };
 
-  rv = zipW->Open(mFile, PR_RDWR | PR_CREATE_FILE);
-  if (NS_FAILED(rv)) {
-    NS_WARNING("could not open zipfile for write");
-    return;
+  nsTArray<WriteEntry> entries;
+  nsTArray<UniquePtr<char[]>> compressedBuffers;
+
+  for (auto& key : mPendingWrites) {
+    CacheEntry* data = mTable.Get(key);
+    MOZ_ASSERT(data); // assert key was found in mTable.
+
+    auto compressed =
+      MakeUnique<char[]>(Compression::LZ4::maxCompressedSize(data->size));
+    WriteEntry* entry = entries.AppendElement();
+    entry->key = key;
+    entry->data = compressed.get();
+    entry->compressedSize =
+      Compression::LZ4::compress(data->data.get(), data->size,
+                                 compressed.get());
+    entry->uncompressedSize = data->size;
+    compressedBuffers.AppendElement(Move(compressed));
   }
 
-  // If we didn't have an mArchive member, that means that we failed to
-  // open the startup cache for reading.  Therefore, we need to record
-  // the time of creation in a zipfile comment; this has been useful for
-  // Telemetry statistics.
-  PRTime now = PR_Now();
-  if (!mArchive) {
-    nsCString comment;
-    comment.Assign((char *)&now, sizeof(now));
-    zipW->SetComment(comment);
+  // Entries from the old file that weren't rewritten this session are
+  // carried forward; their compressed bytes are copied straight from the
+  // old mapping.
+  if (mCacheData) {
+    for (auto iter = mCacheEntries.Iter(); !iter.Done(); iter.Next()) {
+      if (mTable.Get(iter.Key()))
+        continue;
+      const MapEntry& old = iter.Data();
+      WriteEntry* entry = entries.AppendElement();
+      entry->key = iter.Key();
+      entry->data = mCacheData->get<char>().get() + old.offset;
+      entry->compressedSize = old.compressedSize;
+      entry->uncompressedSize = old.uncompressedSize;
+    }
   }
 
-  nsCOMPtr<nsIStringInputStream> stream
-    = do_CreateInstance("@mozilla.org/io/string-input-stream;1", &rv);
-  if (NS_FAILED(rv)) {
-    NS_WARNING("Couldn't create string input stream.");
-    return;
+  // Lay the file out: magic, header size, header block, then data block.
+  uint32_t headerSize = 0;
+  for (const auto& entry : entries) {
+    headerSize += sizeof(uint32_t) + entry.key.Length() + 3 * sizeof(uint32_t);
   }
 
-  CacheWriteHolder holder;
-  holder.stream = stream;
-  holder.writer = zipW;
-  holder.time = now;
+  uint32_t offset = sizeof(MAGIC) + sizeof(uint32_t) + headerSize;
+  nsTArray<uint8_t> header;
+  header.SetCapacity(headerSize);
+  for (const auto& entry : entries) {
+    AppendUint32(header, entry.key.Length());
+    header.AppendElements(reinterpret_cast<const uint8_t*>(entry.key.get()),
+                          entry.key.Length());
+    AppendUint32(header, offset);
+    AppendUint32(header, entry.compressedSize);
+    AppendUint32(header, entry.uncompressedSize);
+    offset += entry.compressedSize;
+  }
+  MOZ_ASSERT(header.Length() == headerSize);
 
-  for (auto& key : mPendingWrites) {
-    CacheCloseHelper(key, mTable.Get(key), &holder);
+  // Write to a sibling file first, then rename over the old cache so
+  // readers never see a half-written file.
+  nsCOMPtr<nsIFile> tmpFile;
+  rv = mFile->Clone(getter_AddRefs(tmpFile));
+  if (NS_FAILED(rv))
+    return;
+
+  nsAutoCString leafName;
+  mFile->GetNativeLeafName(leafName);
+  rv = tmpFile->SetNativeLeafName(leafName + NS_LITERAL_CSTRING(".tmp"));
+  if (NS_FAILED(rv))
+    return;
+
+  {
+    AutoFDClose fd;
+    rv = tmpFile->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE,
+                                   0644, &fd.rwget());
+    if (NS_FAILED(rv)) {
+      NS_WARNING("could not open cache file for write");
+      return;
+    }
+
+    bool ok =
+      PR_Write(fd, MAGIC, sizeof(MAGIC)) == int32_t(sizeof(MAGIC));
+
+    uint8_t headerSizeBytes[sizeof(uint32_t)];
+    LittleEndian::writeUint32(headerSizeBytes, headerSize);
+    ok = ok && PR_Write(fd, headerSizeBytes, sizeof(headerSizeBytes)) ==
+                 int32_t(sizeof(headerSizeBytes));
+
+    ok = ok && PR_Write(fd, header.Elements(), header.Length()) ==
+                 int32_t(header.Length());
+
+    for (const auto& entry : entries) {
+      ok = ok && PR_Write(fd, entry.data, entry.compressedSize) ==
+                   int32_t(entry.compressedSize);
+    }
+
+    if (!ok) {
+      NS_WARNING("failed to write startupcache file");
+      tmpFile->Remove(false);
+      return;
+    }
   }
+
   mPendingWrites.Clear();
   mTable.Clear();
 
-  // Close the archive so Windows doesn't choke.
-  mArchive = nullptr;
-  zipW->Close();
+  // Release the old mapping before renaming over it; Windows can't replace
+  // a file that is still mapped.
+  mCacheData = nullptr;
+  mCacheEntries.Clear();
+
+  rv = tmpFile->MoveToNative(nullptr, leafName);
+  if (NS_FAILED(rv)) {
+    NS_WARNING("failed to rename startupcache file into place");
+    return;
+  }
 
-  // We succesfully wrote the archive to disk; mark the disk file as trusted
+  // We succesfully wrote the cache to disk; mark the disk file as trusted
   gIgnoreDiskCache = false;
 
-  // Our reader's view of the archive is outdated now, reload it.
+  // Our reader's view of the cache is outdated now, reload it.
   LoadArchive();
 }
 
@@ -463,7 +601,8 @@ StartupCache::InvalidateCache()
   WaitOnWriteThread();
   mPendingWrites.Clear();
   mTable.Clear();
-  mArchive = nullptr;
+  mCacheData = nullptr;
+  mCacheEntries.Clear();
   nsresult rv = mFile->Remove(false);
   if (NS_FAILED(rv) && rv != NS_ERROR_FILE_TARGET_DOES_NOT_EXIST &&
       rv != NS_ERROR_FILE_NOT_FOUND) {
@@ -8,8 +8,8 @@
 
 #include "nsClassHashtable.h"
 #include "nsComponentManagerUtils.h"
+#include "nsDataHashtable.h"
 #include "nsTArray.h"
-#include "nsZipArchive.h"
 #include "nsIStartupCache.h"
 #include "nsITimer.h"
 #include "nsIMemoryReporter.h"
@@ -21,6 +21,7 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/StaticPtr.h"
 #include "mozilla/UniquePtr.h"
+#include "mozilla/loader/AutoMemMap.h"
 
 /**
  * The StartupCache is a persistent cache of simple key-value pairs,
@@ -91,6 +92,15 @@ struct CacheEntry
   }
 };
 
+// Locates an entry's compressed data within the mapped cache file. The
+// offset is absolute, i.e. relative to the start of the file.
+struct MapEntry
+{
+  uint32_t offset;
+  uint32_t compressedSize;
+  uint32_t uncompressedSize;
+};
+
 // We don't want to refcount StartupCache, and ObserverService wants to
 // refcount its listeners, so we'll let it refcount this instead.
 class StartupCacheListener final : public nsIObserver
@@ -156,7 +166,11 @@ private:
 
   nsClassHashtable<nsCStringHashKey, CacheEntry> mTable;
   nsTArray<nsCString> mPendingWrites;
-  RefPtr<nsZipArchive> mArchive;
+  // The memory-mapped cache file, and an index of the entries it contains.
+  // AutoMemMap cannot be re-initialized, so the mapping is recreated from
+  // scratch whenever the file is rewritten.
+  UniquePtr<loader::AutoMemMap> mCacheData;
+  nsDataHashtable<nsCStringHashKey, MapEntry> mCacheEntries;
   nsCOMPtr<nsIFile> mFile;
 
   nsCOMPtr<nsIObserverService> mObserverService;
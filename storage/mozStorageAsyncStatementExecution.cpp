@@ -19,6 +19,8 @@
 #include "mozStorageStatementData.h"
 #include "mozStorageAsyncStatementExecution.h"
 
+#include <algorithm>
+
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Telemetry.h"
 
@@ -29,15 +31,23 @@ namespace storage {
  * The following constants help batch rows into result sets.
  * MAX_MILLISECONDS_BETWEEN_RESULTS was chosen because any user-based task that
  * takes less than 200 milliseconds is considered to feel instantaneous to end
- * users.  MAX_ROWS_PER_RESULT was arbitrarily chosen to reduce the number of
+ * users.  MIN_ROWS_PER_RESULT was arbitrarily chosen to reduce the number of
  * dispatches to calling thread, while also providing reasonably-sized sets of
  * data for consumers.  Both of these constants are used because we assume that
  * consumers are trying to avoid blocking their execution thread for long
  * periods of time, and dispatching many small events to the calling thread will
  * end up blocking it.
+ *
+ * The batch size starts at MIN_ROWS_PER_RESULT and doubles after every
+ * dispatched result set, up to MAX_ROWS_PER_RESULT.  Small queries keep the
+ * low first-result latency, while queries streaming tens of thousands of rows
+ * converge on one event-loop round trip per few thousand rows instead of one
+ * per handful.  MAX_MILLISECONDS_BETWEEN_RESULTS still bounds the wait for a
+ * partially filled batch.
  */
 #define MAX_MILLISECONDS_BETWEEN_RESULTS 75
-#define MAX_ROWS_PER_RESULT 15
+#define MIN_ROWS_PER_RESULT 15
+#define MAX_ROWS_PER_RESULT 4096
 
 ////////////////////////////////////////////////////////////////////////////////
 //// AsyncExecuteStatements
@@ -87,6 +97,7 @@ AsyncExecuteStatements::AsyncExecuteStatements(StatementDataArray &aStatements,
 , mCallback(aCallback)
 , mCallingThread(::do_GetCurrentThread())
 , mMaxWait(TimeDuration::FromMilliseconds(MAX_MILLISECONDS_BETWEEN_RESULTS))
+, mRowsPerResult(MIN_ROWS_PER_RESULT)
 , mIntervalStart(TimeStamp::Now())
 , mState(PENDING)
 , mCancelRequested(false)
@@ -305,12 +316,17 @@ AsyncExecuteStatements::buildAndNotifyResults(sqlite3_stmt *aStatement)
   // calling thread about it.
   TimeStamp now = TimeStamp::Now();
   TimeDuration delta = now - mIntervalStart;
-  if (mResultSet->rows() >= MAX_ROWS_PER_RESULT || delta > mMaxWait) {
+  if (mResultSet->rows() >= mRowsPerResult || delta > mMaxWait) {
     // Notify the caller
     rv = notifyResults();
     if (NS_FAILED(rv))
       return NS_OK; // we'll try again with the next result
 
+    // A statement still producing rows is likely a large query; batch more
+    // of them per dispatch from now on.
+    mRowsPerResult = std::min(mRowsPerResult * 2,
+                              uint32_t(MAX_ROWS_PER_RESULT));
+
     // Reset our start time
     mIntervalStart = now;
   }
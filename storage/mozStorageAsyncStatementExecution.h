@@ -207,6 +207,14 @@ private:
    */
   const TimeDuration mMaxWait;
 
+  /**
+   * The number of rows to accumulate before dispatching a result set.
+   * Starts at MIN_ROWS_PER_RESULT and doubles after every dispatched set,
+   * up to MAX_ROWS_PER_RESULT, so long-running queries pay ever fewer
+   * event-loop round trips.
+   */
+  uint32_t mRowsPerResult;
+
   /**
    * The start time since our last set of results.
    */
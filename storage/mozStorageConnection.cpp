@@ -4,6 +4,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <ctype.h>
 #include <stdio.h>
 
 #include "nsError.h"
@@ -51,6 +52,9 @@
 // Maximum size of the pages cache per connection.
 #define MAX_CACHE_SIZE_KIBIBYTES 2048 // 2 MiB
 
+// Maximum number of read-only clones initializeReadPool will open.
+#define MAX_READ_POOL_SIZE 8
+
 mozilla::LazyLogModule gStorageLog("mozStorage");
 
 // Checks that the protected code is running on the main-thread only if the
@@ -532,6 +536,8 @@ Connection::Connection(Service *aService,
 , sharedDBMutex("Connection::sharedDBMutex")
 , threadOpenedOn(do_GetCurrentThread())
 , mDBConn(nullptr)
+, mNextReadPoolIndex(0)
+, mMmapSize(0)
 , mAsyncExecutionThreadShuttingDown(false)
 , mConnectionClosed(false)
 , mTransactionInProgress(false)
@@ -1042,6 +1048,22 @@ Connection::internalClose(sqlite3 *aNativeConnection)
   if (!aNativeConnection)
     return NS_OK;
 
+  // Report how well this connection's page cache (and any mapping set up
+  // with setMmapSize) served its reads over its lifetime.
+  {
+    int hit = 0, miss = 0, dummy = 0;
+    if (::sqlite3_db_status(aNativeConnection, SQLITE_DBSTATUS_CACHE_HIT,
+                            &hit, &dummy, 0) == SQLITE_OK &&
+        ::sqlite3_db_status(aNativeConnection, SQLITE_DBSTATUS_CACHE_MISS,
+                            &miss, &dummy, 0) == SQLITE_OK &&
+        hit + miss > 0) {
+      Telemetry::Accumulate(Telemetry::MOZ_SQLITE_PAGE_CACHE_HIT_PCT,
+                            static_cast<uint32_t>(
+                              (static_cast<int64_t>(hit) * 100) /
+                              (hit + miss)));
+    }
+  }
+
   int srv = ::sqlite3_close(aNativeConnection);
 
   if (srv == SQLITE_BUSY) {
@@ -1270,6 +1292,8 @@ Connection::Close()
   if (!mDBConn)
     return NS_ERROR_NOT_INITIALIZED;
 
+  closeReadPool();
+
 #ifdef DEBUG
   // Since we're accessing mAsyncExecutionThread, we need to be on the opener thread.
   // We make this check outside of debug code below in setClosedState, but this is
@@ -1341,6 +1365,8 @@ Connection::AsyncClose(mozIStorageCompletionCallback *aCallback)
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+  closeReadPool();
+
   // The two relevant factors at this point are whether we have a database
   // connection and whether we have an async execution thread.  Here's what the
   // states mean and how we handle them:
@@ -1604,6 +1630,109 @@ Connection::Clone(bool aReadOnly,
   return NS_OK;
 }
 
+NS_IMETHODIMP
+Connection::InitializeReadPool(uint32_t aPoolSize)
+{
+  // Like asyncClose(), because that is how the pool gets torn down.
+  NS_ENSURE_TRUE(NS_IsMainThread(), NS_ERROR_NOT_SAME_THREAD);
+
+  AUTO_PROFILER_LABEL("Connection::InitializeReadPool", STORAGE);
+
+  if (!mDBConn)
+    return NS_ERROR_NOT_INITIALIZED;
+  if (!mDatabaseFile)
+    return NS_ERROR_UNEXPECTED;
+  if (aPoolSize < 1 || aPoolSize > MAX_READ_POOL_SIZE ||
+      !mReadPool.IsEmpty()) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  // Readers only avoid blocking on the writer under WAL journaling, where
+  // each of them gets its own snapshot of the database.
+  nsCOMPtr<mozIStorageStatement> stmt;
+  nsresult rv = CreateStatement(NS_LITERAL_CSTRING("PRAGMA journal_mode = wal"),
+                                getter_AddRefs(stmt));
+  NS_ENSURE_SUCCESS(rv, rv);
+  bool hasResult = false;
+  rv = stmt->ExecuteStep(&hasResult);
+  NS_ENSURE_SUCCESS(rv, rv);
+  nsAutoCString journalMode;
+  if (hasResult) {
+    rv = stmt->GetUTF8String(0, journalMode);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+  if (!journalMode.EqualsLiteral("wal"))
+    return NS_ERROR_UNEXPECTED;
+
+  // The same flag twiddling Clone() does for a read-only clone.
+  int flags = mFlags;
+  flags = (~SQLITE_OPEN_READWRITE & flags) | SQLITE_OPEN_READONLY;
+  flags = (~SQLITE_OPEN_CREATE & flags);
+
+  for (uint32_t i = 0; i < aPoolSize; i++) {
+    // The clones only ever run asynchronous statements.
+    RefPtr<Connection> readConn = new Connection(mStorageService, flags,
+                                                 /* aAsyncOnly */ true);
+    rv = initializeClone(readConn, /* aReadOnly */ true);
+    if (NS_FAILED(rv)) {
+      closeReadPool();
+      return rv;
+    }
+    if (mMmapSize > 0) {
+      Unused << readConn->SetMmapSize(mMmapSize);
+    }
+    mReadPool.AppendElement(readConn.forget());
+  }
+
+  MOZ_LOG(gStorageLog, LogLevel::Debug,
+          ("Opened read pool of %u connections for '%s'",
+           aPoolSize, mTelemetryFilename.get()));
+
+  return NS_OK;
+}
+
+Connection *
+Connection::getReadPoolConnection(const nsACString &aSQLStatement)
+{
+  MOZ_ASSERT(threadOpenedOn == NS_GetCurrentThread());
+
+  if (mReadPool.IsEmpty())
+    return nullptr;
+
+  // sqlite3_stmt_readonly would be authoritative, but asynchronous
+  // statements are prepared lazily on the async thread, so classify by the
+  // first keyword instead.  Only plain SELECTs are routed; anything
+  // ambiguous (e.g. WITH, which may front a write) stays on this
+  // connection, which is always correct, just slower.
+  uint32_t start = 0;
+  while (start < aSQLStatement.Length() &&
+         ::isspace(static_cast<unsigned char>(aSQLStatement.CharAt(start)))) {
+    start++;
+  }
+  const nsDependentCSubstring sql(aSQLStatement, start);
+  const nsCaseInsensitiveCStringComparator c;
+  if (!StringBeginsWith(sql, NS_LITERAL_CSTRING("SELECT"), c))
+    return nullptr;
+
+  Connection *readConn = mReadPool[mNextReadPoolIndex];
+  mNextReadPoolIndex = (mNextReadPoolIndex + 1) % mReadPool.Length();
+  return readConn;
+}
+
+void
+Connection::closeReadPool()
+{
+  // AsyncClose() is main thread only.  Off the main thread (e.g. a last
+  // release on another thread running our destructor) just drop the
+  // references and let each clone close itself on destruction.
+  if (NS_IsMainThread()) {
+    for (uint32_t i = 0; i < mReadPool.Length(); i++) {
+      Unused << mReadPool[i]->AsyncClose(nullptr);
+    }
+  }
+  mReadPool.Clear();
+}
+
 NS_IMETHODIMP
 Connection::Interrupt()
 {
@@ -1740,10 +1869,17 @@ Connection::CreateAsyncStatement(const nsACString &aSQLStatement,
   NS_ENSURE_ARG_POINTER(_stmt);
   if (!mDBConn) return NS_ERROR_NOT_INITIALIZED;
 
+  // A SELECT can run on one of the read pool clones so it doesn't
+  // serialize behind writes on this connection.
+  Connection *target = this;
+  if (Connection *readConn = getReadPoolConnection(aSQLStatement)) {
+    target = readConn;
+  }
+
   RefPtr<AsyncStatement> statement(new AsyncStatement());
   NS_ENSURE_TRUE(statement, NS_ERROR_OUT_OF_MEMORY);
 
-  nsresult rv = statement->initialize(this, mDBConn, aSQLStatement);
+  nsresult rv = statement->initialize(target, target->mDBConn, aSQLStatement);
   NS_ENSURE_SUCCESS(rv, rv);
 
   AsyncStatement *rawPtr;
@@ -1781,6 +1917,12 @@ Connection::ExecuteAsync(mozIStorageBaseStatement **aStatements,
     NS_ASSERTION(stmt->getOwner() == this,
                  "Statement must be from this database connection!");
 
+    // A SELECT that was routed to a read pool clone cannot join a batch on
+    // this connection; it has to be executed individually.
+    if (stmt->getOwner() != this && mReadPool.Contains(stmt->getOwner())) {
+      return NS_ERROR_INVALID_ARG;
+    }
+
     // Now append it to our array.
     NS_ENSURE_TRUE(stmts.AppendElement(data), NS_ERROR_OUT_OF_MEMORY);
   }
@@ -2087,6 +2229,45 @@ Connection::SetGrowthIncrement(int32_t aChunkSize, const nsACString &aDatabaseNa
   return NS_OK;
 }
 
+NS_IMETHODIMP
+Connection::SetMmapSize(int64_t aSizeBytes)
+{
+  MOZ_ASSERT(threadOpenedOn == NS_GetCurrentThread());
+
+  if (!mDBConn) return NS_ERROR_NOT_INITIALIZED;
+  if (aSizeBytes < 0) return NS_ERROR_INVALID_ARG;
+
+  nsAutoCString query("PRAGMA mmap_size = ");
+  query.AppendInt(aSizeBytes);
+
+  // The pragma replies with the size actually in effect.
+  nsCOMPtr<mozIStorageStatement> stmt;
+  nsresult rv = CreateStatement(query, getter_AddRefs(stmt));
+  NS_ENSURE_SUCCESS(rv, rv);
+  bool hasResult = false;
+  rv = stmt->ExecuteStep(&hasResult);
+  NS_ENSURE_SUCCESS(rv, rv);
+  int64_t effectiveSize = 0;
+  if (hasResult) {
+    rv = stmt->GetInt64(0, &effectiveSize);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
+  // SQLite caps the size at SQLITE_MAX_MMAP_SIZE, which is 0 when it was
+  // compiled without mmap support on this platform.
+  if (aSizeBytes > 0 && effectiveSize == 0)
+    return NS_ERROR_NOT_AVAILABLE;
+
+  // Read pool clones read the same file, so give them the same mapping.
+  // The OS shares the file-backed pages between the connections.
+  for (uint32_t i = 0; i < mReadPool.Length(); i++) {
+    Unused << mReadPool[i]->SetMmapSize(aSizeBytes);
+  }
+
+  mMmapSize = effectiveSize;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 Connection::EnableModule(const nsACString& aModuleName)
 {
@@ -23,6 +23,7 @@
 #include "mozIStorageCompletionCallback.h"
 
 #include "nsIMutableArray.h"
+#include "nsTArray.h"
 #include "mozilla/Attributes.h"
 
 #include "sqlite3.h"
@@ -324,6 +325,19 @@ private:
 
   bool findFunctionByInstance(nsISupports *aInstance);
 
+  /**
+   * Returns the read pool connection the given SQL statement should execute
+   * on, or nullptr when it must stay on this connection (no pool created,
+   * or the statement is not a plain SELECT).  Must be called on the opener
+   * thread.
+   */
+  Connection *getReadPoolConnection(const nsACString &aSQLStatement);
+
+  /**
+   * Asynchronously closes any read pool clones and empties the pool.
+   */
+  void closeReadPool();
+
   static int sProgressHelper(void *aArg);
   // Generic progress handler
   // Dispatch call to registered progress handler,
@@ -340,6 +354,22 @@ private:
   */
   nsCString mTelemetryFilename;
 
+  /**
+   * Read-only clones created by initializeReadPool().  Asynchronous SELECT
+   * statements are distributed over these round-robin so they don't
+   * serialize behind writes on this connection.
+   *
+   * This must be accessed only on the opener thread.
+   */
+  nsTArray<RefPtr<Connection>> mReadPool;
+  uint32_t mNextReadPoolIndex;
+
+  /**
+   * The effective mmap_size set through setMmapSize(), so later read pool
+   * clones can inherit it.  Only accessed on the opener thread.
+   */
+  int64_t mMmapSize;
+
   /**
    * Lazily created thread for asynchronous statement execution.  Consumers
    * should use getAsyncExecutionTarget rather than directly accessing this
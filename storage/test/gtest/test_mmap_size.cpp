@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: sw=2 ts=2 et lcs=trail\:.,tab\:>~ :
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "storage_test_harness.h"
+
+/**
+ * This file tests setMmapSize, the opt-in memory-mapped I/O configuration.
+ */
+
+TEST(storage_mmap_size, InvalidSize)
+{
+  nsCOMPtr<mozIStorageConnection> db(getDatabase());
+  do_check_eq(NS_ERROR_INVALID_ARG, db->SetMmapSize(-1));
+  blocking_async_close(db);
+}
+
+TEST(storage_mmap_size, EnableAndDisable)
+{
+  nsCOMPtr<mozIStorageConnection> db(getDatabase());
+
+  // Disabling is always possible, even when mmap support is compiled out.
+  do_check_success(db->SetMmapSize(0));
+
+  // Enabling succeeds wherever SQLite was built with a non-zero
+  // SQLITE_MAX_MMAP_SIZE; elsewhere it must report that cleanly.
+  nsresult rv = db->SetMmapSize(2 * 1024 * 1024);
+  do_check_true(NS_SUCCEEDED(rv) || rv == NS_ERROR_NOT_AVAILABLE);
+
+  if (NS_SUCCEEDED(rv)) {
+    // The connection must still answer queries from the mapping.
+    do_check_success(db->ExecuteSimpleSQL(NS_LITERAL_CSTRING(
+      "CREATE TABLE IF NOT EXISTS mmap_test (id INTEGER PRIMARY KEY)")));
+    nsCOMPtr<mozIStorageStatement> stmt;
+    do_check_success(db->CreateStatement(
+      NS_LITERAL_CSTRING("SELECT COUNT(*) FROM mmap_test"),
+      getter_AddRefs(stmt)));
+    bool hasResult = false;
+    do_check_success(stmt->ExecuteStep(&hasResult));
+    do_check_true(hasResult);
+    do_check_success(stmt->Finalize());
+
+    // And mmap can be turned off again.
+    do_check_success(db->SetMmapSize(0));
+  }
+
+  blocking_async_close(db);
+}
@@ -0,0 +1,68 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: sw=2 ts=2 et lcs=trail\:.,tab\:>~ :
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "storage_test_harness.h"
+
+/**
+ * This file tests initializeReadPool, which routes asynchronous SELECT
+ * statements to read-only clones of the connection.
+ */
+
+TEST(storage_read_pool, MemoryDatabase)
+{
+  // A memory database has no file to clone from.
+  nsCOMPtr<mozIStorageConnection> db(getMemoryDatabase());
+  do_check_false(NS_SUCCEEDED(db->InitializeReadPool(2)));
+  blocking_async_close(db);
+}
+
+TEST(storage_read_pool, RoutesSelects)
+{
+  nsCOMPtr<mozIStorageConnection> db(getDatabase());
+  do_check_success(db->ExecuteSimpleSQL(NS_LITERAL_CSTRING(
+    "CREATE TABLE IF NOT EXISTS read_pool_test (id INTEGER PRIMARY KEY)")));
+
+  // Out-of-range sizes are rejected.
+  do_check_false(NS_SUCCEEDED(db->InitializeReadPool(0)));
+  do_check_false(NS_SUCCEEDED(db->InitializeReadPool(100)));
+
+  do_check_success(db->InitializeReadPool(2));
+
+  // Only one pool per connection.
+  do_check_false(NS_SUCCEEDED(db->InitializeReadPool(2)));
+
+  // An asynchronous SELECT runs on a pool clone and still completes.
+  nsCOMPtr<mozIStorageAsyncStatement> stmt;
+  do_check_success(db->CreateAsyncStatement(
+    NS_LITERAL_CSTRING("SELECT COUNT(*) FROM read_pool_test"),
+    getter_AddRefs(stmt)));
+
+  RefPtr<AsyncStatementSpinner> spinner(new AsyncStatementSpinner());
+  nsCOMPtr<mozIStoragePendingStatement> pending;
+  do_check_success(stmt->ExecuteAsync(spinner, getter_AddRefs(pending)));
+  spinner->SpinUntilCompleted();
+  do_check_eq(mozIStorageStatementCallback::REASON_FINISHED,
+              spinner->completionReason);
+
+  // A routed statement cannot join a batch on the owner connection.
+  mozIStorageBaseStatement *stmts[] = { stmt.get() };
+  nsCOMPtr<mozIStoragePendingStatement> batch;
+  do_check_eq(NS_ERROR_INVALID_ARG,
+              db->ExecuteAsync(stmts, 1, nullptr, getter_AddRefs(batch)));
+
+  do_check_success(stmt->Finalize());
+
+  // Writes stay on the owner connection.
+  nsCOMPtr<mozIStorageAsyncStatement> write;
+  do_check_success(db->CreateAsyncStatement(
+    NS_LITERAL_CSTRING("INSERT INTO read_pool_test VALUES (NULL)"),
+    getter_AddRefs(write)));
+  blocking_async_execute(write);
+  do_check_success(write->Finalize());
+
+  // Closing the connection also closes the pool.
+  blocking_async_close(db);
+}
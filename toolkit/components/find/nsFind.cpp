@@ -29,6 +29,8 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/TextEditor.h"
 
+#include <algorithm>
+
 using namespace mozilla;
 
 // Yikes!  Casting a char to unichar can fill with ones!
@@ -934,6 +936,31 @@ nsFind::ResetAll()
 
 #define NBSP_CHARCODE (CHAR_TO_UNICHAR(160))
 #define IsSpace(c) (nsCRT::IsAsciiSpace(c) || (c) == NBSP_CHARCODE)
+
+// Folds a document character the same way the matching loop in nsFind::Find
+// does before comparing it, so that the fast scan over non-matching text
+// agrees with the character-by-character matcher.
+static inline char16_t
+FoldMatchChar(char16_t aChar, bool aCaseSensitive)
+{
+  if (aCaseSensitive) {
+    return aChar;
+  }
+  if (IsUpperCase(aChar)) {
+    aChar = ToLowerCase(aChar);
+  }
+  switch (aChar) {
+    // treat curly and straight quotes as identical
+    case CH_LEFT_SINGLE_QUOTE:
+    case CH_RIGHT_SINGLE_QUOTE:
+      return CH_APOSTROPHE;
+    case CH_LEFT_DOUBLE_QUOTE:
+    case CH_RIGHT_DOUBLE_QUOTE:
+      return CH_QUOTE;
+    default:
+      return aChar;
+  }
+}
 #define OVERFLOW_PINDEX (mFindBackward ? pindex < 0 : pindex > patLen)
 #define DONE_WITH_PINDEX (mFindBackward ? pindex <= 0 : pindex >= patLen)
 #define ALMOST_DONE_WITH_PINDEX (mFindBackward ? pindex <= 0 : pindex >= patLen - 1)
@@ -1146,6 +1173,61 @@ nsFind::Find(const char16_t* aPatText, nsIDOMRange* aSearchRange,
       return NS_OK;
     }
 
+    // Fast path: when we're looking for the start of a new match going
+    // forward, skip ahead to the next character that could begin one with a
+    // tight scan over the fragment instead of taking the full matching
+    // state machine below for every character. A Boyer-Moore shift table
+    // can't be used here because the matcher folds whitespace runs, soft
+    // hyphens and quote variants as it goes, but nearly all time is spent
+    // between matches, where only the first pattern character matters.
+    if (!mFindBackward && !matchAnchorNode && !inWhitespace &&
+        !IsSpace(patStr[0])) {
+      // The character a match would have to start with, folded the same way
+      // the document text is folded below. (Soft hyphens were stripped from
+      // the pattern above, so skipping them along with other non-matching
+      // characters is correct.)
+      char16_t patc0 = FoldMatchChar(patStr[0], mCaseSensitive);
+      int32_t limit = (mIterNode == endNode)
+        ? std::min(fragLen, static_cast<int32_t>(endOffset) + 1)
+        : fragLen;
+      int32_t startindex = findex;
+      if (t1b && mCaseSensitive) {
+        // Latin-1 text with no folding to do: let memchr do the scanning.
+        if (patc0 <= 0xFF) {
+          const char* found = static_cast<const char*>(
+            memchr(t1b + findex, static_cast<unsigned char>(patc0),
+                   limit - findex));
+          findex = found ? static_cast<int32_t>(found - t1b) : limit;
+        } else {
+          findex = limit;  // Can't occur in Latin-1 text.
+        }
+      } else {
+        while (findex < limit &&
+               FoldMatchChar(t2b ? t2b[findex] : CHAR_TO_UNICHAR(t1b[findex]),
+                             mCaseSensitive) != patc0) {
+          ++findex;
+        }
+      }
+      if (findex != startindex) {
+        // Keep the word boundary detection below behaving as if the skipped
+        // characters had been walked one by one.
+        c = FoldMatchChar(t2b ? t2b[findex - 1]
+                              : CHAR_TO_UNICHAR(t1b[findex - 1]),
+                          mCaseSensitive);
+      }
+      if (findex == fragLen) {
+        // Nothing else in this fragment can start a match; pull a new node.
+        frag = nullptr;
+        continue;
+      }
+      if (findex == limit) {
+        // Everything up to the end point was scanned without finding a
+        // place a match could start.
+        ResetAll();
+        return NS_OK;
+      }
+    }
+
     // Save the previous character for word boundary detection
     prevChar = c;
     // The two characters we'll be comparing:
@@ -482,15 +482,13 @@ public:
     NS_PRECONDITION(aURI, "Null URI");
 
     // If we are a content process, always remote the request to the
-    // parent process.
+    // parent process.  Queries are batched up and sent in a single IPC
+    // message per event loop spin, since link-heavy pages can issue
+    // thousands of them at once.
     if (XRE_IsContentProcess()) {
-      URIParams uri;
-      SerializeURI(aURI, uri);
-
-      mozilla::dom::ContentChild* cpc =
-        mozilla::dom::ContentChild::GetSingleton();
-      NS_ASSERTION(cpc, "Content Protocol is NULL!");
-      (void)cpc->SendStartVisitedQuery(uri);
+      History* history = History::GetService();
+      NS_ENSURE_STATE(history);
+      history->ScheduleVisitedQuery(aURI);
       return NS_OK;
     }
 
@@ -2072,6 +2070,48 @@ History::DispatchNotifyVisited(nsIURI* aURI, nsIDocument* aDocument)
   }
 }
 
+void
+History::ScheduleVisitedQuery(nsIURI* aURI)
+{
+  MOZ_ASSERT(XRE_IsContentProcess());
+
+  mPendingVisitedQueries.AppendElement(aURI);
+  if (mPendingVisitedQueries.Length() > 1) {
+    // The runnable dispatched for the first pending query will send them all.
+    return;
+  }
+
+  nsCOMPtr<nsIRunnable> runnable =
+    NS_NewRunnableFunction("History::SendPendingVisitedQueries", [] {
+      nsCOMPtr<IHistory> history = services::GetHistoryService();
+      if (history) {
+        static_cast<History*>(history.get())->SendPendingVisitedQueries();
+      }
+    });
+  NS_DispatchToMainThread(runnable.forget());
+}
+
+void
+History::SendPendingVisitedQueries()
+{
+  MOZ_ASSERT(XRE_IsContentProcess());
+
+  if (mPendingVisitedQueries.IsEmpty()) {
+    return;
+  }
+
+  InfallibleTArray<URIParams> uris(mPendingVisitedQueries.Length());
+  for (nsIURI* uri : mPendingVisitedQueries) {
+    SerializeURI(uri, *uris.AppendElement());
+  }
+  mPendingVisitedQueries.Clear();
+
+  mozilla::dom::ContentChild* cpc =
+    mozilla::dom::ContentChild::GetSingleton();
+  NS_ASSERTION(cpc, "Content Protocol is NULL!");
+  (void)cpc->SendStartVisitedQueries(uris);
+}
+
 class ConcurrentStatementsHolder final : public mozIStorageCompletionCallback {
 public:
   NS_DECL_ISUPPORTS
@@ -2664,7 +2704,7 @@ History::RegisterVisitedCallback(nsIURI* aURI,
     nsresult rv = VisitedQuery::Start(aURI);
 
     // In IPC builds, we are passed a nullptr Link from
-    // ContentParent::RecvStartVisitedQuery.  Since we won't be adding a
+    // ContentParent::RecvStartVisitedQueries.  Since we won't be adding a
     // nullptr entry to our list of observers, and the code after this point
     // assumes that aLink is non-nullptr, we will need to return now.
     if (NS_FAILED(rv) || !aLink) {
@@ -2675,7 +2715,7 @@ History::RegisterVisitedCallback(nsIURI* aURI,
     }
   }
   // In IPC builds, we are passed a nullptr Link from
-  // ContentParent::RecvStartVisitedQuery.  All of our code after this point
+  // ContentParent::RecvStartVisitedQueries.  All of our code after this point
   // assumes aLink is non-nullptr, so we have to return now.
   else if (!aLink) {
     NS_ASSERTION(XRE_IsParentProcess(),
@@ -144,6 +144,18 @@ public:
    */
   void AppendToRecentlyVisitedURIs(nsIURI* aURI);
 
+  /**
+   * Add a visited query for the given URI to the batch sent to the parent
+   * process.  The batch is flushed in a single StartVisitedQueries message
+   * once the current event loop spin completes.  Content process only.
+   */
+  void ScheduleVisitedQuery(nsIURI* aURI);
+
+  /**
+   * Send all pending visited queries to the parent process.
+   */
+  void SendPendingVisitedQueries();
+
 private:
   virtual ~History();
 
@@ -174,6 +186,11 @@ private:
    */
   void DispatchNotifyVisited(nsIURI* aURI, nsIDocument* aDocument);
 
+  /**
+   * URIs waiting to be sent to the parent process by ScheduleVisitedQuery.
+   */
+  nsTArray<nsCOMPtr<nsIURI>> mPendingVisitedQueries;
+
   /**
    * The database handle.  This is initialized lazily by the first call to
    * GetDBConn(), so never use it directly, or, if you really need, always
@@ -105,6 +105,16 @@ using namespace mozilla::places;
 #define PREF_FREC_RELOAD_VISIT_BONUS            "places.frecency.reloadVisitBonus"
 #define PREF_FREC_RELOAD_VISIT_BONUS_DEF        0
 
+// Invalid frecencies (frecency < 0) are recalculated in batches of
+// recalcChunkSize pages, pausing recalcChunkInterval milliseconds in between,
+// so that statements from other consumers (like awesomebar queries) never
+// wait behind one long bulk update.  Together the two values bound how long
+// the recalculation of a backlog can take.
+#define PREF_FREC_RECALC_CHUNK_SIZE             "places.frecency.recalcChunkSize"
+#define PREF_FREC_RECALC_CHUNK_SIZE_DEF         300
+#define PREF_FREC_RECALC_CHUNK_INTERVAL         "places.frecency.recalcChunkInterval"
+#define PREF_FREC_RECALC_CHUNK_INTERVAL_DEF     500
+
 // This is a 'hidden' pref for the purposes of unit tests.
 #define PREF_FREC_DECAY_RATE     "places.frecency.decayRate"
 #define PREF_FREC_DECAY_RATE_DEF 0.975f
@@ -281,6 +291,9 @@ nsNavHistory::nsNavHistory()
   , mEmbedVisits(EMBED_VISITS_INITIAL_CACHE_LENGTH)
   , mHistoryEnabled(true)
   , mNumVisitsForFrecency(10)
+  , mFrecencyRecalcPending(false)
+  , mFrecencyRecalcChunkSize(PREF_FREC_RECALC_CHUNK_SIZE_DEF)
+  , mFrecencyRecalcChunkInterval(PREF_FREC_RECALC_CHUNK_INTERVAL_DEF)
   , mTagsFolder(-1)
   , mDaysOfHistory(-1)
   , mLastCachedStartOfDay(INT64_MAX)
@@ -486,8 +499,13 @@ nsNavHistory::LoadPrefs()
   FRECENCY_PREF(mThirdBucketWeight,        PREF_FREC_THIRD_BUCKET_WEIGHT);
   FRECENCY_PREF(mFourthBucketWeight,       PREF_FREC_FOURTH_BUCKET_WEIGHT);
   FRECENCY_PREF(mDefaultWeight,            PREF_FREC_DEFAULT_BUCKET_WEIGHT);
+  FRECENCY_PREF(mFrecencyRecalcChunkSize,     PREF_FREC_RECALC_CHUNK_SIZE);
+  FRECENCY_PREF(mFrecencyRecalcChunkInterval, PREF_FREC_RECALC_CHUNK_INTERVAL);
 
 #undef FRECENCY_PREF
+
+  mFrecencyRecalcChunkSize = std::max(1, mFrecencyRecalcChunkSize);
+  mFrecencyRecalcChunkInterval = std::max(0, mFrecencyRecalcChunkInterval);
 }
 
 
@@ -1015,10 +1033,11 @@ nsNavHistory::GetHasHistoryEntries(bool* aHasEntries)
 
 namespace {
 
-class InvalidateAllFrecenciesCallback : public AsyncStatementCallback
+class InvalidateFrecenciesCallback : public AsyncStatementCallback
 {
 public:
-  InvalidateAllFrecenciesCallback()
+  explicit InvalidateFrecenciesCallback(bool aManyFrecenciesChanged)
+    : mManyFrecenciesChanged(aManyFrecenciesChanged)
   {
   }
 
@@ -1027,10 +1046,19 @@ public:
     if (aReason == REASON_FINISHED) {
       nsNavHistory *navHistory = nsNavHistory::GetHistoryService();
       NS_ENSURE_STATE(navHistory);
-      navHistory->NotifyManyFrecenciesChanged();
+      if (mManyFrecenciesChanged) {
+        navHistory->NotifyManyFrecenciesChanged();
+      }
+      // Start recalculating the invalidated frecencies right away instead of
+      // waiting for the next idle-daily, so they only stay stale for a
+      // bounded time.
+      (void)navHistory->FixInvalidFrecencies();
     }
     return NS_OK;
   }
+
+private:
+  bool mManyFrecenciesChanged;
 };
 
 } // namespace
@@ -1065,9 +1093,8 @@ nsNavHistory::invalidateFrecencies(const nsCString& aPlaceIdsQueryString)
     invalidFrecenciesSQLFragment.Append(aPlaceIdsQueryString);
     invalidFrecenciesSQLFragment.Append(')');
   }
-  RefPtr<InvalidateAllFrecenciesCallback> cb =
-    aPlaceIdsQueryString.IsEmpty() ? new InvalidateAllFrecenciesCallback()
-                                   : nullptr;
+  RefPtr<InvalidateFrecenciesCallback> cb =
+    new InvalidateFrecenciesCallback(aPlaceIdsQueryString.IsEmpty());
 
   nsCOMPtr<mozIStorageAsyncStatement> stmt = mDB->GetAsyncStatement(
     invalidFrecenciesSQLFragment
@@ -2966,6 +2993,13 @@ nsNavHistory::Observe(nsISupports *aSubject, const char *aTopic,
     // cache would init services that could try to use our APIs.
     mCanNotify = false;
     mObservers.Clear();
+
+    // Stop any ongoing frecency recalculation, the connection is going away.
+    mFrecencyRecalcPending = false;
+    if (mFrecencyRecalcTimer) {
+      mFrecencyRecalcTimer->Cancel();
+      mFrecencyRecalcTimer = nullptr;
+    }
   }
 
 #ifdef MOZ_XUL
@@ -4362,20 +4396,34 @@ class FixInvalidFrecenciesCallback : public AsyncStatementCallbackNotifier
 public:
   FixInvalidFrecenciesCallback()
     : AsyncStatementCallbackNotifier(TOPIC_FRECENCY_UPDATED)
+    , mMoreToRecalculate(false)
   {
   }
 
+  NS_IMETHOD HandleResult(mozIStorageResultSet* aResultSet)
+  {
+    // The trailing SELECT only returns a row if pages with an invalid
+    // frecency remain after this batch.
+    mMoreToRecalculate = true;
+    return NS_OK;
+  }
+
   NS_IMETHOD HandleCompletion(uint16_t aReason)
   {
-    nsresult rv = AsyncStatementCallbackNotifier::HandleCompletion(aReason);
-    NS_ENSURE_SUCCESS(rv, rv);
-    if (aReason == REASON_FINISHED) {
-      nsNavHistory *navHistory = nsNavHistory::GetHistoryService();
-      NS_ENSURE_STATE(navHistory);
-      navHistory->NotifyManyFrecenciesChanged();
+    if (aReason == REASON_FINISHED && !mMoreToRecalculate) {
+      // Only notify the topic once the whole recalculation is done.
+      nsresult rv = AsyncStatementCallbackNotifier::HandleCompletion(aReason);
+      NS_ENSURE_SUCCESS(rv, rv);
     }
+    nsNavHistory *navHistory = nsNavHistory::GetHistoryService();
+    NS_ENSURE_STATE(navHistory);
+    navHistory->OnFrecencyRecalcChunkCompleted(aReason == REASON_FINISHED,
+                                               mMoreToRecalculate);
     return NS_OK;
   }
+
+private:
+  bool mMoreToRecalculate;
 };
 
 } // namespace
@@ -4383,21 +4431,106 @@ public:
 nsresult
 nsNavHistory::FixInvalidFrecencies()
 {
-  nsCOMPtr<mozIStorageAsyncStatement> stmt = mDB->GetAsyncStatement(
+  if (mFrecencyRecalcPending) {
+    return NS_OK;
+  }
+
+  mFrecencyRecalcPending = true;
+  nsresult rv = RecalculateFrecencyChunk();
+  if (NS_FAILED(rv)) {
+    mFrecencyRecalcPending = false;
+  }
+  return rv;
+}
+
+nsresult
+nsNavHistory::RecalculateFrecencyChunk()
+{
+  nsCOMPtr<mozIStorageAsyncStatement> updateStmt = mDB->GetAsyncStatement(
     "UPDATE moz_places "
     "SET frecency = CALCULATE_FRECENCY(id) "
-    "WHERE frecency < 0"
+    "WHERE id IN (SELECT id FROM moz_places WHERE frecency < 0 "
+                 "LIMIT :chunk_size)"
   );
-  NS_ENSURE_STATE(stmt);
+  NS_ENSURE_STATE(updateStmt);
+  nsresult rv = updateStmt->BindInt32ByName(NS_LITERAL_CSTRING("chunk_size"),
+                                            mFrecencyRecalcChunkSize);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsCOMPtr<mozIStorageAsyncStatement> remainingStmt = mDB->GetAsyncStatement(
+    "SELECT 1 FROM moz_places WHERE frecency < 0 LIMIT 1"
+  );
+  NS_ENSURE_STATE(remainingStmt);
 
+  nsCOMPtr<mozIStorageConnection> conn = mDB->MainConn();
+  if (!conn) {
+    return NS_ERROR_UNEXPECTED;
+  }
+
+  mozIStorageBaseStatement *stmts[] = {
+    updateStmt.get()
+  , remainingStmt.get()
+  };
   RefPtr<FixInvalidFrecenciesCallback> callback =
     new FixInvalidFrecenciesCallback();
   nsCOMPtr<mozIStoragePendingStatement> ps;
-  (void)stmt->ExecuteAsync(callback, getter_AddRefs(ps));
+  rv = conn->ExecuteAsync(stmts, ArrayLength(stmts), callback,
+                          getter_AddRefs(ps));
+  NS_ENSURE_SUCCESS(rv, rv);
 
   return NS_OK;
 }
 
+void
+nsNavHistory::OnFrecencyRecalcChunkCompleted(bool aSucceeded, bool aMoreRemain)
+{
+  NS_ASSERTION(NS_IsMainThread(), "This can only be called on the main thread");
+
+  if (!mFrecencyRecalcPending) {
+    // Shutdown cancelled the recalculation while a batch was in flight.
+    return;
+  }
+
+  if (!aSucceeded) {
+    mFrecencyRecalcPending = false;
+    return;
+  }
+
+  if (!aMoreRemain) {
+    mFrecencyRecalcPending = false;
+    NotifyManyFrecenciesChanged();
+    return;
+  }
+
+  // Pause before the next batch, so statements from other consumers get a
+  // chance to take the connection in between.
+  if (!mFrecencyRecalcTimer) {
+    mFrecencyRecalcTimer = do_CreateInstance("@mozilla.org/timer;1");
+  }
+  if (!mFrecencyRecalcTimer ||
+      NS_FAILED(mFrecencyRecalcTimer->InitWithNamedFuncCallback(
+        frecencyRecalcTimerCallback, this, mFrecencyRecalcChunkInterval,
+        nsITimer::TYPE_ONE_SHOT,
+        "nsNavHistory::frecencyRecalcTimerCallback"))) {
+    // Without a timer just go on immediately, it's better to hold the
+    // connection for a while longer than to leave frecencies invalid.
+    if (NS_FAILED(RecalculateFrecencyChunk())) {
+      mFrecencyRecalcPending = false;
+    }
+  }
+}
+
+void
+nsNavHistory::frecencyRecalcTimerCallback(nsITimer* aTimer, void* aClosure)
+{
+  nsNavHistory *history = static_cast<nsNavHistory *>(aClosure);
+  if (history && history->mFrecencyRecalcPending) {
+    if (NS_FAILED(history->RecalculateFrecencyChunk())) {
+      history->mFrecencyRecalcPending = false;
+    }
+  }
+}
+
 
 #ifdef MOZ_XUL
 
@@ -167,9 +167,26 @@ public:
    *  * After a "clear private data"
    *  * After removing visits
    *  * After migrating from older versions
+   * The pages with an invalid frecency form a persistent dirty queue; they
+   * are recalculated in small batches on the async helper thread, with a
+   * pause between batches, so that queries sharing the connection (like the
+   * awesomebar) never wait behind a long bulk update. If a recalculation is
+   * already in progress this is a no-op.
    */
   nsresult FixInvalidFrecencies();
 
+  /**
+   * Called back on the main thread after each frecency recalculation batch.
+   * If more invalid frecencies remain, schedules the next batch, otherwise
+   * notifies observers that many frecencies changed.
+   *
+   * @param aSucceeded
+   *        Whether the batch completed successfully.
+   * @param aMoreRemain
+   *        Whether any page with an invalid frecency remains.
+   */
+  void OnFrecencyRecalcChunkCompleted(bool aSucceeded, bool aMoreRemain);
+
   /**
    * Invalidate the frecencies of a list of places, so they will be recalculated
    * at the first idle-daily notification.
@@ -628,6 +645,20 @@ protected:
   int32_t mUnvisitedTypedBonus;
   int32_t mReloadVisitBonus;
 
+  /**
+   * Recalculates frecency for (at most) the next batch of pages requesting
+   * that, then checks whether any remain. The completion callback invokes
+   * OnFrecencyRecalcChunkCompleted.
+   */
+  nsresult RecalculateFrecencyChunk();
+  static void frecencyRecalcTimerCallback(nsITimer* aTimer, void* aClosure);
+  nsCOMPtr<nsITimer> mFrecencyRecalcTimer;
+  // Whether a chunked frecency recalculation is in flight.
+  bool mFrecencyRecalcPending;
+  // Pages recalculated per batch, and milliseconds between batches.
+  int32_t mFrecencyRecalcChunkSize;
+  int32_t mFrecencyRecalcChunkInterval;
+
   // in nsNavHistoryQuery.cpp
   nsresult TokensToQueries(const nsTArray<QueryKeyValuePair>& aTokens,
                            nsCOMArray<nsNavHistoryQuery>* aQueries,
@@ -938,6 +938,77 @@ static StaticMutex gTelemetryHistogramMutex;
 
 namespace {
 
+// Plain (non-keyed) accumulations are hot enough that taking
+// |gTelemetryHistogramMutex| for each of them shows up in profiles when
+// media, necko and main threads accumulate concurrently. Instead of taking
+// the mutex, TelemetryHistogram::Accumulate() pushes (id, sample) pairs onto
+// this fixed-size multi-producer ring (a Vyukov bounded queue); they are
+// merged into histogram storage by whichever thread next holds the mutex.
+// If the ring is full the producer falls back to taking the mutex itself,
+// so no samples are dropped.
+//
+// Must be a power of two so that positions can wrap freely.
+const uint32_t kPendingSampleQueueSize = 1024;
+// Once this many samples are queued, the enqueueing thread takes the mutex
+// and merges them itself so that samples don't languish in processes that
+// rarely perform a locked telemetry operation.
+const uint32_t kPendingSampleDrainThreshold = kPendingSampleQueueSize / 2;
+
+struct PendingSample
+{
+  // A cell may be claimed by a producer when mSequence equals the enqueue
+  // position, and consumed when it equals the enqueue position + 1.
+  mozilla::Atomic<uint32_t> mSequence;
+  uint32_t mId;
+  uint32_t mSample;
+};
+
+PendingSample gPendingSamples[kPendingSampleQueueSize];
+mozilla::Atomic<uint32_t> gPendingSampleEnqueuePos(0);
+mozilla::Atomic<uint32_t> gPendingSampleDequeuePos(0);
+// The queue may only be used once InitializeGlobalState() has set up the
+// cell sequence numbers.
+mozilla::Atomic<bool> gPendingSampleQueueReady(false);
+
+// NOTE: Does not require |gTelemetryHistogramMutex|; this is the wait-free
+// producer side. Returns false if the queue is not ready or is full, in
+// which case the caller must accumulate under the mutex instead.
+bool
+internal_EnqueuePendingSample(HistogramID aId, uint32_t aSample)
+{
+  if (!gPendingSampleQueueReady) {
+    return false;
+  }
+
+  uint32_t pos = gPendingSampleEnqueuePos;
+  for (;;) {
+    PendingSample& cell = gPendingSamples[pos & (kPendingSampleQueueSize - 1)];
+    uint32_t seq = cell.mSequence;
+    int32_t diff = int32_t(seq - pos);
+    if (diff == 0) {
+      if (gPendingSampleEnqueuePos.compareExchange(pos, pos + 1)) {
+        cell.mId = uint32_t(aId);
+        cell.mSample = aSample;
+        cell.mSequence = pos + 1;
+        return true;
+      }
+      pos = gPendingSampleEnqueuePos;
+    } else if (diff < 0) {
+      // The consumer hasn't freed the cell a full queue length behind us:
+      // the queue is full.
+      return false;
+    } else {
+      pos = gPendingSampleEnqueuePos;
+    }
+  }
+}
+
+uint32_t
+internal_PendingSampleCount()
+{
+  return gPendingSampleEnqueuePos - gPendingSampleDequeuePos;
+}
+
 bool
 internal_RemoteAccumulate(HistogramID aId, uint32_t aSample)
 {
@@ -1036,6 +1107,41 @@ internal_AccumulateChildKeyed(ProcessID aProcessType, HistogramID aId,
   keyed->Add(aKey, aSample, aProcessType);
 }
 
+// Merge all samples queued by internal_EnqueuePendingSample() into histogram
+// storage. The caller must hold |gTelemetryHistogramMutex|, which also makes
+// this a single-consumer operation.
+void
+internal_DrainPendingSamples()
+{
+  for (;;) {
+    uint32_t pos = gPendingSampleDequeuePos;
+    PendingSample& cell = gPendingSamples[pos & (kPendingSampleQueueSize - 1)];
+    uint32_t seq = cell.mSequence;
+    if (int32_t(seq - (pos + 1)) != 0) {
+      // Empty, or a producer claimed the cell but hasn't published it yet;
+      // either way there is nothing more to merge right now.
+      return;
+    }
+    HistogramID id = HistogramID(cell.mId);
+    uint32_t sample = cell.mSample;
+    gPendingSampleDequeuePos = pos + 1;
+    // Free the cell for the producer one queue length ahead. The payload
+    // must be read out before this.
+    cell.mSequence = pos + kPendingSampleQueueSize;
+    internal_Accumulate(id, sample);
+  }
+}
+
+// Take |gTelemetryHistogramMutex| just long enough to merge queued samples
+// into histogram storage. For use by snapshot paths that otherwise run
+// without the mutex; must NOT be called with the mutex held.
+void
+internal_FlushPendingSamples()
+{
+  StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  internal_DrainPendingSamples();
+}
+
 void
 internal_ClearHistogram(HistogramID id, bool onlySubsession)
 {
@@ -1210,6 +1316,10 @@ internal_JSHistogram_Snapshot(JSContext *cx, unsigned argc, JS::Value *vp)
   HistogramID id = data->histogramId;
   MOZ_ASSERT(internal_IsHistogramEnumId(id));
 
+  // Make sure lock-free accumulations from other threads are reflected in
+  // the snapshot.
+  internal_FlushPendingSamples();
+
   // This is not good standard behavior given that we have histogram instances
   // covering multiple processes and two session types.
   // However, changing this requires some broader changes to callers.
@@ -1744,12 +1854,25 @@ void TelemetryHistogram::InitializeGlobalState(bool canRecordBase,
                   " was an intentional change, update the n_values for the following in "
                   "Histograms.json: STARTUP_MEASUREMENT_ERRORS");
 
+  // Set up the pending sample queue: each cell's sequence number starts out
+  // equal to its index (see internal_EnqueuePendingSample).
+  for (uint32_t i = 0; i < kPendingSampleQueueSize; ++i) {
+    gPendingSamples[i].mSequence = i;
+  }
+  gPendingSampleEnqueuePos = 0;
+  gPendingSampleDequeuePos = 0;
+  gPendingSampleQueueReady = true;
+
   gInitDone = true;
 }
 
 void TelemetryHistogram::DeInitializeGlobalState()
 {
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  // Stop accepting lock-free accumulations and merge any that are still
+  // queued while histogram storage exists.
+  gPendingSampleQueueReady = false;
+  internal_DrainPendingSamples();
   gCanRecordBase = false;
   gCanRecordExtended = false;
   gNameToHistogramIDMap.Clear();
@@ -1870,7 +1993,19 @@ TelemetryHistogram::Accumulate(HistogramID aID,
     return;
   }
 
+  // Fast path: queue the sample without taking the mutex. It is merged into
+  // histogram storage by the next thread that holds the mutex, or by us once
+  // enough samples have accumulated.
+  if (internal_EnqueuePendingSample(aID, aSample)) {
+    if (internal_PendingSampleCount() >= kPendingSampleDrainThreshold) {
+      StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+      internal_DrainPendingSamples();
+    }
+    return;
+  }
+
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  internal_DrainPendingSamples();
   internal_Accumulate(aID, aSample);
 }
 
@@ -1896,6 +2031,7 @@ TelemetryHistogram::Accumulate(HistogramID aID,
   }
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  internal_DrainPendingSamples();
   internal_Accumulate(aID, aKey, aSample);
 }
 
@@ -1958,6 +2094,7 @@ TelemetryHistogram::AccumulateCategorical(HistogramID aId,
   }
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  internal_DrainPendingSamples();
   if (!internal_CanRecordBase()) {
     return;
   }
@@ -1975,6 +2112,9 @@ TelemetryHistogram::AccumulateChild(ProcessID aProcessType,
   MOZ_ASSERT(XRE_IsParentProcess());
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
+  // Child batches arrive periodically, so this is a convenient point to
+  // merge our own queued samples too.
+  internal_DrainPendingSamples();
   if (!internal_CanRecordBase()) {
     return;
   }
@@ -2075,6 +2215,10 @@ TelemetryHistogram::CreateHistogramSnapshots(JSContext* aCx,
   }
 #endif
 
+  // Make sure lock-free accumulations from other threads are reflected in
+  // the snapshot.
+  internal_FlushPendingSamples();
+
   // Runs without protection from |gTelemetryHistogramMutex|
   JS::Rooted<JSObject*> root_obj(aCx, JS_NewPlainObject(aCx));
   if (!root_obj) {
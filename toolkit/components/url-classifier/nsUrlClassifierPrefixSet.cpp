@@ -75,7 +75,8 @@ nsUrlClassifierPrefixSet::SetPrefixes(const uint32_t* aArray, uint32_t aLength)
   if (aLength <= 0) {
     if (mIndexPrefixes.Length() > 0) {
       LOG(("Clearing PrefixSet"));
-      mIndexDeltas.Clear();
+      mDeltas.Clear();
+      mIndexDeltaStarts.Clear();
       mIndexPrefixes.Clear();
       mTotalPrefixes = 0;
     }
@@ -102,50 +103,45 @@ nsUrlClassifierPrefixSet::MakePrefixSet(const uint32_t* aPrefixes, uint32_t aLen
 #endif
 
   mIndexPrefixes.Clear();
-  mIndexDeltas.Clear();
+  mDeltas.Clear();
+  mIndexDeltaStarts.Clear();
   mTotalPrefixes = aLength;
 
   mIndexPrefixes.AppendElement(aPrefixes[0]);
-  mIndexDeltas.AppendElement();
+  mIndexDeltaStarts.AppendElement(0);
 
   uint32_t numOfDeltas = 0;
-  uint32_t totalDeltas = 0;
   uint32_t previousItem = aPrefixes[0];
   for (uint32_t i = 1; i < aLength; i++) {
     if ((numOfDeltas >= DELTAS_LIMIT) ||
           (aPrefixes[i] - previousItem >= MAX_INDEX_DIFF)) {
-      // Compact the previous element.
-      // Note there is always at least one element when we get here,
-      // because we created the first element before the loop.
-      mIndexDeltas.LastElement().Compact();
-      if (!mIndexDeltas.AppendElement(fallible)) {
+      if (!mIndexPrefixes.AppendElement(aPrefixes[i], fallible)) {
         return NS_ERROR_OUT_OF_MEMORY;
       }
 
-      if (!mIndexPrefixes.AppendElement(aPrefixes[i], fallible)) {
+      if (!mIndexDeltaStarts.AppendElement(mDeltas.Length(), fallible)) {
         return NS_ERROR_OUT_OF_MEMORY;
       }
 
       numOfDeltas = 0;
     } else {
       uint16_t delta = aPrefixes[i] - previousItem;
-      if (!mIndexDeltas.LastElement().AppendElement(delta, fallible)) {
+      if (!mDeltas.AppendElement(delta, fallible)) {
         return NS_ERROR_OUT_OF_MEMORY;
       }
 
       numOfDeltas++;
-      totalDeltas++;
     }
     previousItem = aPrefixes[i];
   }
 
-  mIndexDeltas.LastElement().Compact();
-  mIndexDeltas.Compact();
+  mDeltas.Compact();
   mIndexPrefixes.Compact();
+  mIndexDeltaStarts.Compact();
 
   LOG(("Total number of indices: %d", aLength));
-  LOG(("Total number of deltas: %d", totalDeltas));
-  LOG(("Total number of delta chunks: %zu", mIndexDeltas.Length()));
+  LOG(("Total number of deltas: %zu", mDeltas.Length()));
+  LOG(("Total number of delta runs: %zu", mIndexPrefixes.Length()));
 
   return NS_OK;
 }
@@ -164,14 +160,16 @@ nsUrlClassifierPrefixSet::GetPrefixesNative(FallibleTArray<uint32_t>& outArray)
 
   for (uint32_t i = 0; i < prefixIdxLength; i++) {
     uint32_t prefix = mIndexPrefixes[i];
+    uint32_t runEnd = (i + 1 < prefixIdxLength) ? mIndexDeltaStarts[i + 1]
+                                                : mDeltas.Length();
 
     if (prefixCnt >= mTotalPrefixes) {
       return NS_ERROR_FAILURE;
     }
     outArray[prefixCnt++] = prefix;
 
-    for (uint32_t j = 0; j < mIndexDeltas[i].Length(); j++) {
-      prefix += mIndexDeltas[i][j];
+    for (uint32_t j = mIndexDeltaStarts[i]; j < runEnd; j++) {
+      prefix += mDeltas[j];
       if (prefixCnt >= mTotalPrefixes) {
         return NS_ERROR_FAILURE;
       }
@@ -267,11 +265,21 @@ nsUrlClassifierPrefixSet::Contains(uint32_t aPrefix, bool* aFound)
 
   // Now search through the deltas for the target.
   uint32_t diff = target - mIndexPrefixes[i];
-  uint32_t deltaSize  = mIndexDeltas[i].Length();
-  uint32_t deltaIndex = 0;
+  uint32_t deltaIndex = mIndexDeltaStarts[i];
+  uint32_t deltaEnd = (i + 1 < mIndexPrefixes.Length())
+                        ? mIndexDeltaStarts[i + 1]
+                        : mDeltas.Length();
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+  if (diff > 0 && mozilla::supports_sse2()) {
+    *aFound = safebrowsing::PrefixSetContainsDeltasSSE2(
+      mDeltas.Elements() + deltaIndex, deltaEnd - deltaIndex, diff);
+    return NS_OK;
+  }
+#endif
 
-  while (diff > 0 && deltaIndex < deltaSize) {
-    diff -= mIndexDeltas[i][deltaIndex];
+  while (diff > 0 && deltaIndex < deltaEnd) {
+    diff -= mDeltas[deltaIndex];
     deltaIndex++;
   }
 
@@ -309,10 +317,8 @@ nsUrlClassifierPrefixSet::SizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeO
 
   size_t n = 0;
   n += aMallocSizeOf(this);
-  n += mIndexDeltas.ShallowSizeOfExcludingThis(aMallocSizeOf);
-  for (uint32_t i = 0; i < mIndexDeltas.Length(); i++) {
-    n += mIndexDeltas[i].ShallowSizeOfExcludingThis(aMallocSizeOf);
-  }
+  n += mDeltas.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  n += mIndexDeltaStarts.ShallowSizeOfExcludingThis(aMallocSizeOf);
   n += mIndexPrefixes.ShallowSizeOfExcludingThis(aMallocSizeOf);
   return n;
 }
@@ -429,50 +435,49 @@ nsUrlClassifierPrefixSet::LoadPrefixes(nsIInputStream* in)
       return NS_ERROR_FILE_CORRUPTED;
     }
 
-    nsTArray<uint32_t> indexStarts;
-    if (!indexStarts.SetLength(indexSize, fallible) ||
-        !mIndexPrefixes.SetLength(indexSize, fallible) ||
-        !mIndexDeltas.SetLength(indexSize, fallible)) {
+    if (!mIndexPrefixes.SetLength(indexSize, fallible) ||
+        !mIndexDeltaStarts.SetLength(indexSize, fallible) ||
+        !mDeltas.SetLength(deltaSize, fallible)) {
       return NS_ERROR_OUT_OF_MEMORY;
     }
 
-    mTotalPrefixes = indexSize;
+    mTotalPrefixes = indexSize + deltaSize;
 
     uint32_t toRead = indexSize*sizeof(uint32_t);
     rv = in->Read(reinterpret_cast<char*>(mIndexPrefixes.Elements()), toRead, &read);
     NS_ENSURE_SUCCESS(rv, rv);
     NS_ENSURE_TRUE(read == toRead, NS_ERROR_FAILURE);
 
-    rv = in->Read(reinterpret_cast<char*>(indexStarts.Elements()), toRead, &read);
+    rv = in->Read(reinterpret_cast<char*>(mIndexDeltaStarts.Elements()), toRead, &read);
     NS_ENSURE_SUCCESS(rv, rv);
     NS_ENSURE_TRUE(read == toRead, NS_ERROR_FAILURE);
 
-    if (indexSize != 0 && indexStarts[0] != 0) {
+    if (mIndexDeltaStarts[0] != 0) {
       return NS_ERROR_FILE_CORRUPTED;
     }
     for (uint32_t i = 0; i < indexSize; i++) {
-      uint32_t numInDelta = i == indexSize - 1 ? deltaSize - indexStarts[i]
-                               : indexStarts[i + 1] - indexStarts[i];
-      if (numInDelta > DELTAS_LIMIT) {
+      uint32_t runEnd = i == indexSize - 1 ? deltaSize
+                           : mIndexDeltaStarts[i + 1];
+      if (runEnd < mIndexDeltaStarts[i] ||
+          runEnd - mIndexDeltaStarts[i] > DELTAS_LIMIT) {
         return NS_ERROR_FILE_CORRUPTED;
       }
-      if (numInDelta > 0) {
-        if (!mIndexDeltas[i].SetLength(numInDelta, fallible)) {
-          return NS_ERROR_OUT_OF_MEMORY;
-        }
-        mTotalPrefixes += numInDelta;
-        toRead = numInDelta * sizeof(uint16_t);
-        rv = in->Read(reinterpret_cast<char*>(mIndexDeltas[i].Elements()), toRead, &read);
-        NS_ENSURE_SUCCESS(rv, rv);
-        NS_ENSURE_TRUE(read == toRead, NS_ERROR_FAILURE);
-      }
+    }
+
+    // The runs are stored back to back in the file, in the same shape as
+    // mDeltas, so the whole delta block is a single read.
+    if (deltaSize > 0) {
+      toRead = deltaSize * sizeof(uint16_t);
+      rv = in->Read(reinterpret_cast<char*>(mDeltas.Elements()), toRead, &read);
+      NS_ENSURE_SUCCESS(rv, rv);
+      NS_ENSURE_TRUE(read == toRead, NS_ERROR_FAILURE);
     }
   } else {
     LOG(("Version magic mismatch, not loading"));
     return NS_ERROR_FILE_CORRUPTED;
   }
 
-  MOZ_ASSERT(mIndexPrefixes.Length() == mIndexDeltas.Length());
+  MOZ_ASSERT(mIndexPrefixes.Length() == mIndexDeltaStarts.Length());
   LOG(("Loading PrefixSet successful"));
 
   return NS_OK;
@@ -501,24 +506,7 @@ nsUrlClassifierPrefixSet::WritePrefixes(nsIOutputStream* out)
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
 
   uint32_t indexSize = mIndexPrefixes.Length();
-  uint32_t indexDeltaSize = mIndexDeltas.Length();
-  uint32_t totalDeltas = 0;
-
-  // Store the shape of mIndexDeltas by noting at which "count" of total
-  // indexes a new subarray starts. This is slightly cumbersome but keeps
-  // file format compatibility.
-  // If we ever update the format, we can gain space by storing the delta
-  // subarray sizes, which fit in bytes.
-  nsTArray<uint32_t> indexStarts;
-  indexStarts.AppendElement(0);
-
-  for (uint32_t i = 0; i < indexDeltaSize; i++) {
-    uint32_t deltaLength = mIndexDeltas[i].Length();
-    totalDeltas += deltaLength;
-    if (!indexStarts.AppendElement(totalDeltas, fallible)) {
-      return NS_ERROR_OUT_OF_MEMORY;
-    }
-  }
+  uint32_t totalDeltas = mDeltas.Length();
 
   rv = out->Write(reinterpret_cast<char*>(&indexSize), writelen, &written);
   NS_ENSURE_SUCCESS(rv, rv);
@@ -533,17 +521,18 @@ nsUrlClassifierPrefixSet::WritePrefixes(nsIOutputStream* out)
   NS_ENSURE_SUCCESS(rv, rv);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
 
-  rv = out->Write(reinterpret_cast<char*>(indexStarts.Elements()), writelen, &written);
+  // The in-memory representation already matches the file format: the
+  // offset of each run into the packed delta array, followed by the
+  // deltas themselves back to back.
+  rv = out->Write(reinterpret_cast<char*>(mIndexDeltaStarts.Elements()), writelen, &written);
   NS_ENSURE_SUCCESS(rv, rv);
   NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
 
   if (totalDeltas > 0) {
-    for (uint32_t i = 0; i < indexDeltaSize; i++) {
-      writelen = mIndexDeltas[i].Length() * sizeof(uint16_t);
-      rv = out->Write(reinterpret_cast<char*>(mIndexDeltas[i].Elements()), writelen, &written);
-      NS_ENSURE_SUCCESS(rv, rv);
-      NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
-    }
+    writelen = totalDeltas * sizeof(uint16_t);
+    rv = out->Write(reinterpret_cast<char*>(mDeltas.Elements()), writelen, &written);
+    NS_ENSURE_SUCCESS(rv, rv);
+    NS_ENSURE_TRUE(written == writelen, NS_ERROR_FAILURE);
   }
 
   LOG(("Saving PrefixSet successful\n"));
@@ -20,6 +20,7 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/Poison.h"
+#include "mozilla/SSE.h"
 
 namespace mozilla {
 namespace safebrowsing {
@@ -74,13 +75,18 @@ private:
   // touch this class's data members.
   mozilla::Mutex mLock;
   // list of fully stored prefixes, that also form the
-  // start of a run of deltas in mIndexDeltas.
+  // start of a run of deltas in mDeltas.
   nsTArray<uint32_t> mIndexPrefixes;
-  // array containing arrays of deltas from indices.
-  // Index to the place that matches the closest lower
-  // prefix from mIndexPrefix. Then every "delta" corresponds
-  // to a prefix in the PrefixSet.
-  nsTArray<nsTArray<uint16_t> > mIndexDeltas;
+  // the delta runs for all index prefixes, packed back to back in one
+  // array. Every "delta" corresponds to a prefix in the PrefixSet.
+  // Packing the runs instead of keeping one heap array per run saves an
+  // allocation and an array header per index prefix and matches the
+  // on-disk format, so the whole array is read with a single Read().
+  nsTArray<uint16_t> mDeltas;
+  // where the run for each index prefix starts in mDeltas. Always the
+  // same length as mIndexPrefixes; the run for the last index prefix
+  // ends at mDeltas.Length().
+  nsTArray<uint32_t> mIndexDeltaStarts;
   // how many prefixes we have.
   uint32_t mTotalPrefixes;
 
@@ -88,4 +94,18 @@ private:
   mozilla::CorruptionCanary mCanary;
 };
 
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+namespace mozilla {
+namespace safebrowsing {
+
+// Defined in nsUrlClassifierPrefixSetSSE2.cpp. Walks one packed delta run
+// and returns whether some prefix of it sums to exactly aDiff. Used by
+// nsUrlClassifierPrefixSet::Contains() when SSE2 is available.
+bool PrefixSetContainsDeltasSSE2(const uint16_t* aDeltas, uint32_t aLength,
+                                 uint32_t aDiff);
+
+} // namespace safebrowsing
+} // namespace mozilla
+#endif
+
 #endif
@@ -0,0 +1,58 @@
+//* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsUrlClassifierPrefixSet.h"
+
+#include <emmintrin.h>
+
+namespace mozilla {
+namespace safebrowsing {
+
+// SSE2 walk over one packed delta run. The scalar loop in
+// nsUrlClassifierPrefixSet::Contains() is a chain of dependent
+// subtractions up to DELTAS_LIMIT long; here we sum eight deltas at a
+// time and skip whole blocks the target provably lies beyond, falling
+// back to the scalar walk only inside the block that straddles it.
+bool
+PrefixSetContainsDeltasSSE2(const uint16_t* aDeltas, uint32_t aLength,
+                            uint32_t aDiff)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  uint32_t i = 0;
+  uint32_t diff = aDiff;
+
+  while (i + 8 <= aLength) {
+    __m128i deltas =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aDeltas + i));
+
+    // Zero-extend the eight 16-bit deltas to 32 bits (they use the full
+    // uint16_t range, so a signed multiply-add would misread them) and
+    // sum them horizontally.
+    __m128i sums = _mm_add_epi32(_mm_unpacklo_epi16(deltas, zero),
+                                 _mm_unpackhi_epi16(deltas, zero));
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 8));
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 4));
+    uint32_t blockSum = uint32_t(_mm_cvtsi128_si32(sums));
+
+    if (blockSum >= diff) {
+      // The prefix we are looking for, if present, lies in this block.
+      break;
+    }
+    diff -= blockSum;
+    i += 8;
+  }
+
+  while (diff > 0 && i < aLength) {
+    diff -= aDeltas[i];
+    i++;
+  }
+
+  return diff == 0;
+}
+
+} // namespace safebrowsing
+} // namespace mozilla
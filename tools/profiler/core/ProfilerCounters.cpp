@@ -0,0 +1,55 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ProfilerCounters.h"
+
+#include "mozilla/ArrayUtils.h"
+#include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/JSONWriter.h"
+
+// The JSON property names for each counter, in ProfilerCounterID order.
+static const char* const kCounterNames[] = {
+  "eventLoopDispatches",
+  "mainThreadDispatches",
+  "paints",
+  "gcSlices",
+  "gcSliceTotalMs",
+  "ipcMessagesSent",
+  "ipcMessagesReceived",
+};
+
+static_assert(mozilla::ArrayLength(kCounterNames) ==
+                size_t(ProfilerCounterID::Count),
+              "kCounterNames must cover every ProfilerCounterID");
+
+// The counter slots themselves. These are plain static storage rather than
+// part of CorePS so that counting works before profiler_init() and after
+// profiler_shutdown(), and never needs the profiler state lock.
+static mozilla::Atomic<int64_t, mozilla::Relaxed>
+  gCounters[size_t(ProfilerCounterID::Count)];
+
+void
+profiler_counter_add(ProfilerCounterID aCounter, int64_t aDelta)
+{
+  MOZ_ASSERT(aCounter < ProfilerCounterID::Count);
+  gCounters[size_t(aCounter)] += aDelta;
+}
+
+int64_t
+profiler_counter_value(ProfilerCounterID aCounter)
+{
+  MOZ_ASSERT(aCounter < ProfilerCounterID::Count);
+  return gCounters[size_t(aCounter)];
+}
+
+void
+ProfilerCountersStreamJSON(mozilla::JSONWriter& aWriter)
+{
+  for (size_t i = 0; i < size_t(ProfilerCounterID::Count); i++) {
+    aWriter.IntProperty(kCounterNames[i], gCounters[i]);
+  }
+}
@@ -1677,6 +1677,14 @@ locked_profiler_stream_json_for_this_process(PSLockRef aLock,
   }
   aWriter.EndArray();
 
+  // Put the current values of the always-on performance counters. These are
+  // totals since process startup, not since the session started.
+  aWriter.StartObjectProperty("counters");
+  {
+    ProfilerCountersStreamJSON(aWriter);
+  }
+  aWriter.EndObject();
+
   double collectionEnd = profiler_time();
 
   // Record timestamps for the collection into the buffer, so that consumers
@@ -121,6 +121,11 @@ class JSONWriter;
 }
 void AppendSharedLibraries(mozilla::JSONWriter& aWriter);
 
+// Write the current values of the always-on performance counters as
+// properties of the object the writer is positioned in. Implemented in
+// ProfilerCounters.cpp.
+void ProfilerCountersStreamJSON(mozilla::JSONWriter& aWriter);
+
 // Convert the array of strings to a bitfield.
 uint32_t ParseFeaturesFromStringArray(const char** aFeatures,
                                       uint32_t aFeatureCount);
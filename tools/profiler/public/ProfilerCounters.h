@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// A fixed table of always-on performance counters. Unlike sampling, the
+// counters impose no periodic work: bumping one is a single relaxed atomic
+// add, cheap enough for hot paths like event dispatch and IPC message
+// reception, and they count whether or not a profiling session is running.
+// When a profile is collected the current values are written into the JSON
+// output (see the "counters" property), so a profile of a misbehaving
+// production box also reports how much work of each kind the process has
+// done since startup.
+//
+// Counter slots are fixed at compile time: subsystems claim an entry in
+// ProfilerCounterID rather than registering at runtime, which keeps the hot
+// path free of any lookup or locking.
+
+#ifndef ProfilerCounters_h
+#define ProfilerCounters_h
+
+#include <stdint.h>
+
+// The available counters. An entry here should describe a monotonically
+// increasing total; derive rates by comparing two snapshots.
+enum class ProfilerCounterID : uint32_t {
+  // Events dispatched to any nsThread.
+  EventLoopDispatches,
+  // Events dispatched to the main thread specifically.
+  MainThreadDispatches,
+  // Paints performed by PresShell.
+  Paints,
+  // Garbage collection slices, and their total duration.
+  GCSlices,
+  GCSliceTotalMs,
+  // IPC messages sent over and received from a MessageChannel link.
+  IpcMessagesSent,
+  IpcMessagesReceived,
+
+  Count
+};
+
+#ifndef MOZ_GECKO_PROFILER
+
+#define PROFILER_COUNTER_ADD(id, delta)
+
+#else // !MOZ_GECKO_PROFILER
+
+#define PROFILER_COUNTER_ADD(id, delta) profiler_counter_add(id, delta)
+
+// Add aDelta to the given counter. Wait-free and safe to call from any
+// thread at any time, including before profiler_init() and after
+// profiler_shutdown().
+void profiler_counter_add(ProfilerCounterID aCounter, int64_t aDelta = 1);
+
+// Read the current value of the given counter.
+int64_t profiler_counter_value(ProfilerCounterID aCounter);
+
+#endif // !MOZ_GECKO_PROFILER
+
+#endif // ProfilerCounters_h
@@ -12,6 +12,7 @@
 #include "gtest/gtest.h"
 
 #include "GeckoProfiler.h"
+#include "ProfilerCounters.h"
 #include "ProfilerMarkerPayload.h"
 #include "jsapi.h"
 #include "js/Initialization.h"
@@ -575,6 +576,30 @@ TEST(GeckoProfiler, Time)
   ASSERT_TRUE(t4 <= t5 && t1 <= t6);
 }
 
+TEST(GeckoProfiler, Counters)
+{
+  // Counters work whether or not the profiler is running.
+  int64_t before = profiler_counter_value(ProfilerCounterID::GCSlices);
+  PROFILER_COUNTER_ADD(ProfilerCounterID::GCSlices, 1);
+  profiler_counter_add(ProfilerCounterID::GCSlices, 2);
+  ASSERT_EQ(before + 3, profiler_counter_value(ProfilerCounterID::GCSlices));
+
+  uint32_t features = ProfilerFeature::StackWalk;
+  const char* filters[] = { "GeckoMain" };
+  profiler_start(PROFILER_DEFAULT_ENTRIES, PROFILER_DEFAULT_INTERVAL,
+                 features, filters, MOZ_ARRAY_LENGTH(filters));
+
+  PROFILER_COUNTER_ADD(ProfilerCounterID::GCSlices, 1);
+  ASSERT_EQ(before + 4, profiler_counter_value(ProfilerCounterID::GCSlices));
+
+  // The counter values are included in the JSON output.
+  UniquePtr<char[]> profile = profiler_get_profile();
+  ASSERT_TRUE(strstr(profile.get(), "counters"));
+  ASSERT_TRUE(strstr(profile.get(), "gcSlices"));
+
+  profiler_stop();
+}
+
 TEST(GeckoProfiler, GetProfile)
 {
   uint32_t features = ProfilerFeature::StackWalk;
@@ -21,6 +21,7 @@
 #include "nsIHttpChannel.h"
 #include "nsIURL.h"
 #include "nsISimpleEnumerator.h"
+#include "nsIClassOfService.h"
 #include "nsISupportsPriority.h"
 #include "nsNetUtil.h"
 #include "nsString.h"
@@ -89,6 +90,7 @@ nsPrefetchNode::nsPrefetchNode(nsPrefetchService *aService,
     , mReferrerURI(aReferrerURI)
     , mPolicyType(aPolicyType)
     , mPreload(aPreload)
+    , mPriority(0)
     , mService(aService)
     , mChannel(nullptr)
     , mBytesRead(0)
@@ -173,6 +175,18 @@ nsPrefetchNode::OpenChannel()
       priorityChannel->AdjustPriority(nsISupportsPriority::PRIORITY_LOWEST);
     }
 
+    if (!mPreload) {
+        // Tail prefetch requests so the HTTP request context holds them
+        // back until the network is otherwise idle for the page; the
+        // connection manager dispatches tailed requests only once the
+        // page's own (non-tailed) loads have finished.
+        nsCOMPtr<nsIClassOfService> cos = do_QueryInterface(mChannel);
+        if (cos) {
+          cos->AddClassFlags(nsIClassOfService::Throttleable |
+                             nsIClassOfService::Tail);
+        }
+    }
+
     rv = mChannel->AsyncOpen2(this);
     if (NS_WARN_IF(NS_FAILED(rv))) {
       // Drop the ref to the channel, because we don't want to end up with
@@ -564,13 +578,24 @@ nsresult
 nsPrefetchService::EnqueueURI(nsIURI *aURI,
                               nsIURI *aReferrerURI,
                               nsIDOMNode *aSource,
+                              int32_t aPriority,
                               nsPrefetchNode **aNode)
 {
     RefPtr<nsPrefetchNode> node = new nsPrefetchNode(this, aURI, aReferrerURI,
                                                      aSource,
                                                      nsIContentPolicy::TYPE_OTHER,
                                                      false);
-    mPrefetchQueue.push_back(node);
+    node->mPriority = aPriority;
+
+    // Keep the queue sorted in descending priority order, FIFO among
+    // entries of equal priority, so the most valuable prefetches claim
+    // the parallel slots first.
+    std::deque<RefPtr<nsPrefetchNode>>::iterator insertAt = mPrefetchQueue.end();
+    while (insertAt != mPrefetchQueue.begin() &&
+           (*(insertAt - 1))->mPriority < aPriority) {
+        insertAt--;
+    }
+    mPrefetchQueue.insert(insertAt, node);
     node.forget(aNode);
     return NS_OK;
 }
@@ -868,8 +893,12 @@ nsPrefetchService::Prefetch(nsIURI *aURI,
         }
     }
 
+    // Rank explicitly requested prefetches (<link rel=prefetch> and the
+    // like) above speculative ones; we have no confidence score of our
+    // own, but an author's assertion is the strongest hint we get.
     RefPtr<nsPrefetchNode> enqueuedNode;
     rv = EnqueueURI(aURI, aReferrerURI, aSource,
+                    aExplicit ? 1 : 0,
                     getter_AddRefs(enqueuedNode));
     NS_ENSURE_SUCCESS(rv, rv);
 
@@ -64,7 +64,8 @@ private:
     void     AddProgressListener();
     void     RemoveProgressListener();
     nsresult EnqueueURI(nsIURI *aURI, nsIURI *aReferrerURI,
-                        nsIDOMNode *aSource, nsPrefetchNode **node);
+                        nsIDOMNode *aSource, int32_t aPriority,
+                        nsPrefetchNode **node);
     void     EmptyPrefetchQueue();
 
     void     StartPrefetching();
@@ -126,6 +127,10 @@ public:
     // prefetches are fetched in different phases (during load and
     // after a page load), therefore we need to distinguish them.
     bool                                  mPreload;
+    // Relative priority of a queued prefetch; the queue is kept sorted
+    // in descending priority order (FIFO among equal priorities).
+    // Explicitly requested prefetches rank above speculative ones.
+    int32_t                               mPriority;
 
 private:
     ~nsPrefetchNode() {}
@@ -354,6 +354,9 @@ void WindowBackBuffer::Create(int aWidth, int aHeight)
                      mWaylandDisplay->GetEventQueue());
   wl_buffer_add_listener(mWaylandBuffer, &buffer_listener, this);
 
+  // Freshly created content is completely out of date.
+  mDirtyRegion = LayoutDeviceIntRect(0, 0, aWidth, aHeight);
+
   mWidth = aWidth;
   mHeight = aHeight;
 }
@@ -408,15 +411,35 @@ WindowBackBuffer::Detach()
   mAttached = false;
 }
 
-bool WindowBackBuffer::Sync(class WindowBackBuffer* aSourceBuffer)
+bool WindowBackBuffer::Sync(class WindowBackBuffer* aSourceBuffer,
+                            const LayoutDeviceIntRegion& aRegion)
 {
   bool bufferSizeMatches = MatchSize(aSourceBuffer);
   if (!bufferSizeMatches) {
     Resize(aSourceBuffer->mWidth, aSourceBuffer->mHeight);
   }
 
-  memcpy(mShmPool.GetImageData(), aSourceBuffer->mShmPool.GetImageData(),
-         aSourceBuffer->mWidth * aSourceBuffer->mHeight * BUFFER_BPP);
+  char* src = static_cast<char*>(aSourceBuffer->mShmPool.GetImageData());
+  char* dst = static_cast<char*>(mShmPool.GetImageData());
+  int stride = aSourceBuffer->mWidth * BUFFER_BPP;
+
+  for (auto iter = aRegion.RectIter(); !iter.Done(); iter.Next()) {
+    LayoutDeviceIntRect r = iter.Get().Intersect(
+        LayoutDeviceIntRect(0, 0, mWidth, mHeight));
+    if (r.IsEmpty()) {
+      continue;
+    }
+    if (r.width == mWidth) {
+      // Full-width spans are contiguous in memory, copy them in one go.
+      memcpy(dst + r.y * stride, src + r.y * stride, r.height * stride);
+      continue;
+    }
+    for (int y = r.y; y < r.YMost(); y++) {
+      memcpy(dst + y * stride + r.x * BUFFER_BPP,
+             src + y * stride + r.x * BUFFER_BPP,
+             r.width * BUFFER_BPP);
+    }
+  }
   return true;
 }
 
@@ -432,6 +455,23 @@ WindowBackBuffer::Lock(const LayoutDeviceIntRegion& aRegion)
                                               mWaylandDisplay->GetSurfaceFormat());
 }
 
+static void
+surface_damage(wl_surface* aSurface, int32_t aX, int32_t aY,
+               int32_t aWidth, int32_t aHeight)
+{
+#ifdef WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION
+  // Prefer damage in buffer coordinates when the compositor supports it.
+  // We always attach buffers at offset 0,0 with scale 1 so the coordinates
+  // are currently identical, but damage_buffer keeps the rects exact.
+  if (wl_proxy_get_version(reinterpret_cast<wl_proxy*>(aSurface)) >=
+      WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION) {
+    wl_surface_damage_buffer(aSurface, aX, aY, aWidth, aHeight);
+    return;
+  }
+#endif
+  wl_surface_damage(aSurface, aX, aY, aWidth, aHeight);
+}
+
 static void
 frame_callback_handler(void *data, struct wl_callback *callback, uint32_t time)
 {
@@ -446,8 +486,7 @@ static const struct wl_callback_listener frame_listener = {
 WindowSurfaceWayland::WindowSurfaceWayland(nsWindow *aWidget)
   : mWidget(aWidget)
   , mWaylandDisplay(WaylandDisplayGet(aWidget->GetWaylandDisplay()))
-  , mFrontBuffer(nullptr)
-  , mBackBuffer(nullptr)
+  , mWaylandBuffer(nullptr)
   , mFrameCallback(nullptr)
   , mFrameCallbackSurface(nullptr)
   , mDelayedCommit(false)
@@ -455,12 +494,17 @@ WindowSurfaceWayland::WindowSurfaceWayland(nsWindow *aWidget)
   , mWaylandMessageLoop(MessageLoop::current())
   , mIsMainThread(NS_IsMainThread())
 {
+  for (int i = 0; i < BACK_BUFFER_NUM; i++) {
+    mBackupBuffer[i] = nullptr;
+  }
 }
 
 WindowSurfaceWayland::~WindowSurfaceWayland()
 {
-  delete mFrontBuffer;
-  delete mBackBuffer;
+  delete mWaylandBuffer;
+  for (int i = 0; i < BACK_BUFFER_NUM; i++) {
+    delete mBackupBuffer[i];
+  }
 
   if (mFrameCallback) {
     wl_callback_destroy(mFrameCallback);
@@ -478,49 +522,79 @@ WindowSurfaceWayland::~WindowSurfaceWayland()
 }
 
 WindowBackBuffer*
-WindowSurfaceWayland::GetBufferToDraw(int aWidth, int aHeight)
-{
-  if (!mFrontBuffer) {
-    mFrontBuffer = new WindowBackBuffer(mWaylandDisplay, aWidth, aHeight);
-    mBackBuffer = new WindowBackBuffer(mWaylandDisplay, aWidth, aHeight);
-    return mFrontBuffer;
-  }
+WindowSurfaceWayland::GetBufferToDraw(int aWidth, int aHeight,
+                                      const LayoutDeviceIntRegion& aWillPaintRegion)
+{
+  if (!mWaylandBuffer) {
+    mWaylandBuffer = new WindowBackBuffer(mWaylandDisplay, aWidth, aHeight);
+    mWaylandBuffer->MarkClean();
+  } else if (!mWaylandBuffer->IsAttached()) {
+    // The compositor released our buffer already; it still holds the most
+    // recently drawn frame so we can draw straight into it again.
+    if (!mWaylandBuffer->MatchSize(aWidth, aHeight)) {
+      mWaylandBuffer->Resize(aWidth, aHeight);
+      // The whole buffer content changes on resize.
+      mFullScreenDamage = true;
+      mWaylandBuffer->MarkClean();
+    }
+  } else {
+    // The drawn buffer is still held by the compositor; take a released
+    // buffer from the pool, or grow the pool if all of them are held too.
+    MOZ_ASSERT(!mDelayedCommit,
+               "Uncommitted buffer switch, screen artifacts ahead.");
+
+    int availableSlot = -1;
+    for (int i = 0; i < BACK_BUFFER_NUM; i++) {
+      if (mBackupBuffer[i] && !mBackupBuffer[i]->IsAttached()) {
+        availableSlot = i;
+        break;
+      }
+      if (!mBackupBuffer[i] && availableSlot == -1) {
+        availableSlot = i;
+      }
+    }
+    if (availableSlot == -1) {
+      NS_WARNING("No drawing buffer available");
+      return nullptr;
+    }
 
-  if (!mFrontBuffer->IsAttached()) {
-    if (!mFrontBuffer->MatchSize(aWidth, aHeight)) {
-      mFrontBuffer->Resize(aWidth, aHeight);
+    if (!mBackupBuffer[availableSlot]) {
+      mBackupBuffer[availableSlot] =
+        new WindowBackBuffer(mWaylandDisplay, aWidth, aHeight);
     }
-    return mFrontBuffer;
-  }
 
-  // Front buffer is used by compositor, draw to back buffer
-  if (mBackBuffer->IsAttached()) {
-    NS_WARNING("No drawing buffer available");
-    return nullptr;
+    WindowBackBuffer* lastBuffer = mWaylandBuffer;
+    mWaylandBuffer = mBackupBuffer[availableSlot];
+    mBackupBuffer[availableSlot] = lastBuffer;
+
+    if (mWaylandBuffer->MatchSize(aWidth, aHeight)) {
+      // Gecko may expect a content already drawn on screen so bring the
+      // stale areas of the reused buffer up to date from the last drawn
+      // frame, except for what is going to be overdrawn anyway. For small
+      // updates such as a blinking caret this copies almost nothing.
+      LayoutDeviceIntRegion staleRegion = mWaylandBuffer->GetDirtyRegion();
+      staleRegion.SubOut(aWillPaintRegion);
+      if (!staleRegion.IsEmpty()) {
+        mWaylandBuffer->Sync(lastBuffer, staleRegion);
+      }
+    } else {
+      // Reused buffer has different size from the new request. Only resize
+      // the new buffer and leave gecko to render new whole content.
+      mWaylandBuffer->Resize(aWidth, aHeight);
+      mFullScreenDamage = true;
+    }
+    mWaylandBuffer->MarkClean();
   }
 
-  MOZ_ASSERT(!mDelayedCommit,
-             "Uncommitted buffer switch, screen artifacts ahead.");
-
-  WindowBackBuffer *tmp = mFrontBuffer;
-  mFrontBuffer = mBackBuffer;
-  mBackBuffer = tmp;
-
-  if (mBackBuffer->MatchSize(aWidth, aHeight)) {
-    // Former front buffer has the same size as a requested one.
-    // Gecko may expect a content already drawn on screen so copy
-    // existing data to the new buffer.
-    mFrontBuffer->Sync(mBackBuffer);
-    // When buffer switches we need to damage whole screen
-    // (https://bugzilla.redhat.com/show_bug.cgi?id=1418260)
-    mFullScreenDamage = true;
-  } else {
-    // Former buffer has different size from the new request. Only resize
-    // the new buffer and leave geck to render new whole content.
-    mFrontBuffer->Resize(aWidth, aHeight);
+  // Every other buffer in the pool now misses the content that is about
+  // to be drawn.
+  for (int i = 0; i < BACK_BUFFER_NUM; i++) {
+    if (mBackupBuffer[i]) {
+      mBackupBuffer[i]->MarkDirty(aWillPaintRegion);
+    }
   }
 
-  return mFrontBuffer;
+  return mWaylandBuffer;
 }
 
 already_AddRefed<gfx::DrawTarget>
@@ -532,7 +606,8 @@ WindowSurfaceWayland::Lock(const LayoutDeviceIntRegion& aRegion)
   // portion requested by aRegion.
   LayoutDeviceIntRect rect = mWidget->GetBounds();
   WindowBackBuffer* buffer = GetBufferToDraw(rect.width,
-                                             rect.height);
+                                             rect.height,
+                                             aRegion);
   if (!buffer) {
     NS_WARNING("No drawing buffer available");
     return nullptr;
@@ -556,12 +631,12 @@ WindowSurfaceWayland::Commit(const LayoutDeviceIntRegion& aInvalidRegion)
 
   if (mFullScreenDamage) {
     LayoutDeviceIntRect rect = mWidget->GetBounds();
-    wl_surface_damage(waylandSurface, 0, 0, rect.width, rect.height);
+    surface_damage(waylandSurface, 0, 0, rect.width, rect.height);
     mFullScreenDamage = false;
   } else {
     for (auto iter = aInvalidRegion.RectIter(); !iter.Done(); iter.Next()) {
       const mozilla::LayoutDeviceIntRect &r = iter.Get();
-      wl_surface_damage(waylandSurface, r.x, r.y, r.width, r.height);
+      surface_damage(waylandSurface, r.x, r.y, r.width, r.height);
     }
   }
 
@@ -587,7 +662,7 @@ WindowSurfaceWayland::Commit(const LayoutDeviceIntRegion& aInvalidRegion)
 
     // There's no pending frame callback so we can draw immediately
     // and create frame callback for possible subsequent drawing.
-    mFrontBuffer->Attach(waylandSurface);
+    mWaylandBuffer->Attach(waylandSurface);
     mDelayedCommit = false;
   }
 }
@@ -619,7 +694,7 @@ WindowSurfaceWayland::FrameCallbackHandler()
     wl_callback_add_listener(mFrameCallback, &frame_listener, this);
     mFrameCallbackSurface = waylandSurface;
 
-    mFrontBuffer->Attach(waylandSurface);
+    mWaylandBuffer->Attach(waylandSurface);
     mDelayedCommit = false;
   }
 }
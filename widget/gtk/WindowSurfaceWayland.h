@@ -15,6 +15,10 @@ namespace widget {
 // We support only 32bpp formats
 #define BUFFER_BPP 4
 
+// Maximum number of released buffers kept for reuse in addition to the
+// buffer which is currently drawn to.
+#define BACK_BUFFER_NUM 2
+
 // Our general connection to Wayland display server,
 // holds our display connection and runs event loop.
 class nsWaylandDisplay : public nsISupports {
@@ -77,7 +81,19 @@ public:
   bool IsAttached() { return mAttached; }
 
   bool Resize(int aWidth, int aHeight);
-  bool Sync(class WindowBackBuffer* aSourceBuffer);
+  bool Sync(class WindowBackBuffer* aSourceBuffer,
+            const LayoutDeviceIntRegion& aRegion);
+
+  // The dirty region marks where this buffer's content is out of date
+  // compared to the most recently drawn frame. WindowSurfaceWayland
+  // maintains it as frames are painted into other buffers of the pool,
+  // so that reusing the buffer only copies what it actually misses.
+  void MarkDirty(const LayoutDeviceIntRegion& aRegion)
+  {
+    mDirtyRegion.OrWith(aRegion);
+  }
+  void MarkClean() { mDirtyRegion.SetEmpty(); }
+  const LayoutDeviceIntRegion& GetDirtyRegion() { return mDirtyRegion; }
 
   bool MatchSize(int aWidth, int aHeight)
   {
@@ -98,6 +114,7 @@ private:
   // wl_buffer is a wayland object that encapsulates the shared memory
   // and passes it to wayland compositor by wl_surface object.
   wl_buffer*          mWaylandBuffer;
+  LayoutDeviceIntRegion mDirtyRegion;
   int                 mWidth;
   int                 mHeight;
   bool                mAttached;
@@ -116,12 +133,17 @@ public:
   void                      FrameCallbackHandler();
 
 private:
-  WindowBackBuffer*         GetBufferToDraw(int aWidth, int aHeight);
+  WindowBackBuffer*         GetBufferToDraw(int aWidth, int aHeight,
+                                            const LayoutDeviceIntRegion& aWillPaintRegion);
 
   nsWindow*                 mWidget;
   nsWaylandDisplay*         mWaylandDisplay;
-  WindowBackBuffer*         mFrontBuffer;
-  WindowBackBuffer*         mBackBuffer;
+  // Buffer we currently draw to; always holds the most recently drawn
+  // frame and is attached to wl_surface on commit.
+  WindowBackBuffer*         mWaylandBuffer;
+  // Released buffers kept for reuse while the compositor still holds
+  // previously attached ones. Allocated on demand.
+  WindowBackBuffer*         mBackupBuffer[BACK_BUFFER_NUM];
   wl_callback*              mFrameCallback;
   wl_surface*               mFrameCallbackSurface;
   bool                      mDelayedCommit;
@@ -2397,6 +2397,25 @@ nsWindow::OnConfigureEvent(GtkWidget *aWidget, GdkEventConfigure *aEvent)
         mPendingConfigures--;
     }
 
+    // During interactive moves and resizes the window manager can queue
+    // configure events faster than we process them, and each one pays for a
+    // rollup check and a window-moved notification. This handler reads the
+    // current geometry rather than the event's coordinates, so it is enough
+    // to run it once for the newest queued configure of this window.
+    GdkDisplay* display = gtk_widget_get_display(aWidget);
+    GdkEvent* peeked;
+    while ((peeked = gdk_display_peek_event(display))) {
+        bool more = peeked->type == GDK_CONFIGURE &&
+                    peeked->any.window == aEvent->window;
+        gdk_event_free(peeked);
+        if (!more)
+            break;
+        gdk_event_free(gdk_display_get_event(display));
+        if (mPendingConfigures > 0) {
+            mPendingConfigures--;
+        }
+    }
+
     LayoutDeviceIntRect screenBounds = GetScreenBounds();
 
     if (mWindowType == eWindowType_toplevel || mWindowType == eWindowType_dialog) {
@@ -2615,10 +2634,37 @@ nsWindow::OnMotionNotifyEvent(GdkEventMotion *aEvent)
     }
 #endif /* MOZ_X11 */
 
+    GdkEventMotion* motionEvent = aEvent;
+    GdkEvent* coalesced = nullptr;
+    if (!mIsX11Display) {
+        // There is no X event queue to peek at here, but high-rate mice
+        // flood the GDK event queue just the same, and each motion pays for
+        // a full dispatch. Swallow all immediately following motion events
+        // for this window and dispatch only the newest state. DOM-visible
+        // history for getCoalescedEvents comes from the content-side
+        // coalescing of the events we do dispatch (CoalescedMouseData), as
+        // it does for the X11 compression above.
+        GdkDisplay* display = gdk_window_get_display(aEvent->window);
+        GdkEvent* peeked;
+        while ((peeked = gdk_display_peek_event(display))) {
+            bool more = peeked->type == GDK_MOTION_NOTIFY &&
+                        peeked->any.window == aEvent->window;
+            gdk_event_free(peeked);
+            if (!more)
+                break;
+            if (coalesced)
+                gdk_event_free(coalesced);
+            coalesced = gdk_display_get_event(display);
+        }
+        if (coalesced) {
+            motionEvent = &coalesced->motion;
+        }
+    }
+
     WidgetMouseEvent event(true, eMouseMove, this, WidgetMouseEvent::eReal);
 
     gdouble pressure = 0;
-    gdk_event_get_axis ((GdkEvent*)aEvent, GDK_AXIS_PRESSURE, &pressure);
+    gdk_event_get_axis ((GdkEvent*)motionEvent, GDK_AXIS_PRESSURE, &pressure);
     // Sometime gdk generate 0 pressure value between normal values
     // We have to ignore that and use last valid value
     if (pressure)
@@ -2642,16 +2688,20 @@ nsWindow::OnMotionNotifyEvent(GdkEventMotion *aEvent)
         event.AssignEventTime(GetWidgetEventTime(aEvent->time));
 #endif /* MOZ_X11 */
     } else {
-        event.mRefPoint = GetRefPoint(this, aEvent);
+        event.mRefPoint = GetRefPoint(this, motionEvent);
 
-        modifierState = aEvent->state;
+        modifierState = motionEvent->state;
 
-        event.AssignEventTime(GetWidgetEventTime(aEvent->time));
+        event.AssignEventTime(GetWidgetEventTime(motionEvent->time));
     }
 
     KeymapWrapper::InitInputEvent(event, modifierState);
 
     DispatchInputEvent(&event);
+
+    if (coalesced) {
+        gdk_event_free(coalesced);
+    }
 }
 
 // If the automatic pointer grab on ButtonPress has deactivated before
@@ -3247,10 +3297,34 @@ nsWindow::OnScrollEvent(GdkEventScroll *aEvent)
         // As of GTK 3.4, all directional scroll events are provided by
         // the GDK_SCROLL_SMOOTH direction on XInput2 devices.
         mLastScrollEventTime = aEvent->time;
+
+        gdouble deltaX = aEvent->delta_x;
+        gdouble deltaY = aEvent->delta_y;
+
+        // High-resolution wheels and touchpads deliver smooth-scroll events
+        // faster than dispatch can usefully consume them. Fold all
+        // immediately following smooth-scroll deltas for this window into
+        // this event; the summed delta scrolls as far in one dispatch.
+        GdkDisplay* display = gdk_window_get_display(aEvent->window);
+        GdkEvent* peeked;
+        while ((peeked = gdk_display_peek_event(display))) {
+            bool more = peeked->type == GDK_SCROLL &&
+                        peeked->any.window == aEvent->window &&
+                        peeked->scroll.direction == GDK_SCROLL_SMOOTH;
+            gdk_event_free(peeked);
+            if (!more)
+                break;
+            GdkEvent* next = gdk_display_get_event(display);
+            deltaX += next->scroll.delta_x;
+            deltaY += next->scroll.delta_y;
+            mLastScrollEventTime = next->scroll.time;
+            gdk_event_free(next);
+        }
+
         // TODO - use a more appropriate scrolling unit than lines.
         // Multiply event deltas by 3 to emulate legacy behaviour.
-        wheelEvent.mDeltaX = aEvent->delta_x * 3;
-        wheelEvent.mDeltaY = aEvent->delta_y * 3;
+        wheelEvent.mDeltaX = deltaX * 3;
+        wheelEvent.mDeltaY = deltaY * 3;
         wheelEvent.mIsNoLineOrPageDelta = true;
         // This next step manually unsets smooth scrolling for touch devices
         // that trigger GDK_SCROLL_SMOOTH. We use the slave device, which
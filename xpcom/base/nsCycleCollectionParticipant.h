@@ -119,9 +119,11 @@ class NS_NO_VTABLE nsCycleCollectionParticipant
 {
 public:
   constexpr explicit nsCycleCollectionParticipant(bool aSkip,
-                                                  bool aTraverseShouldTrace = false)
+                                                  bool aTraverseShouldTrace = false,
+                                                  bool aTraverseThreadSafe = false)
     : mMightSkip(aSkip)
     , mTraverseShouldTrace(aTraverseShouldTrace)
+    , mTraverseThreadSafe(aTraverseThreadSafe)
   {
   }
 
@@ -222,6 +224,16 @@ public:
 
   NS_IMETHOD_(void) DeleteCycleCollectable(void* aPtr) = 0;
 
+  // Returns true if this participant promises that its Traverse() may be
+  // called on a background thread while the main thread is blocked building
+  // the cycle collector graph.  Such a Traverse() must only read state owned
+  // by the object being traversed (no hashtable lookups into shared tables,
+  // no JS engine access, no refcount changes) and must report its children
+  // solely through the given callback.  Note that Unlink() and
+  // DeleteCycleCollectable() are still always called on the main thread.
+  // Declared with e.g. NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_CLASS.
+  bool IsTraverseThreadSafe() const { return mTraverseThreadSafe; }
+
 protected:
   NS_IMETHOD_(bool) CanSkipReal(void* aPtr, bool aRemovingAllowed)
   {
@@ -242,13 +254,15 @@ protected:
 private:
   const bool mMightSkip;
   const bool mTraverseShouldTrace;
+  const bool mTraverseThreadSafe;
 };
 
 class NS_NO_VTABLE nsScriptObjectTracer : public nsCycleCollectionParticipant
 {
 public:
-  constexpr explicit nsScriptObjectTracer(bool aSkip)
-    : nsCycleCollectionParticipant(aSkip, true)
+  constexpr explicit nsScriptObjectTracer(bool aSkip,
+                                          bool aTraverseThreadSafe = false)
+    : nsCycleCollectionParticipant(aSkip, true, aTraverseThreadSafe)
   {
   }
 
@@ -260,8 +274,9 @@ public:
 class NS_NO_VTABLE nsXPCOMCycleCollectionParticipant : public nsScriptObjectTracer
 {
 public:
-  constexpr explicit nsXPCOMCycleCollectionParticipant(bool aSkip)
-    : nsScriptObjectTracer(aSkip)
+  constexpr explicit nsXPCOMCycleCollectionParticipant(bool aSkip,
+                                                       bool aTraverseThreadSafe = false)
+    : nsScriptObjectTracer(aSkip, aTraverseThreadSafe)
   {
   }
 
@@ -646,6 +661,29 @@ static NS_CYCLE_COLLECTION_INNERCLASS NS_CYCLE_COLLECTION_INNERNAME;           \
 #define NS_DECL_CYCLE_COLLECTION_CLASS(_class)                                 \
   NS_DECL_CYCLE_COLLECTION_CLASS_AMBIGUOUS(_class, _class)
 
+// Cycle collector helper for classes whose Traverse() is safe to run on a
+// background thread.  See the comment above
+// nsCycleCollectionParticipant::IsTraverseThreadSafe for the promise a class
+// makes by using this.
+#define NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_CLASS_AMBIGUOUS(_class, _base) \
+class NS_CYCLE_COLLECTION_INNERCLASS                                           \
+ : public nsXPCOMCycleCollectionParticipant                                    \
+{                                                                              \
+public:                                                                        \
+  constexpr explicit NS_CYCLE_COLLECTION_INNERCLASS (bool aSkip = false)       \
+    : nsXPCOMCycleCollectionParticipant(aSkip,                                 \
+                                        /* aTraverseThreadSafe = */ true) {}   \
+private:                                                                       \
+  NS_DECL_CYCLE_COLLECTION_CLASS_BODY(_class, _base)                           \
+  NS_IMPL_GET_XPCOM_CYCLE_COLLECTION_PARTICIPANT(_class)                       \
+};                                                                             \
+NS_CHECK_FOR_RIGHT_PARTICIPANT_IMPL(_class)                                    \
+static NS_CYCLE_COLLECTION_INNERCLASS NS_CYCLE_COLLECTION_INNERNAME;           \
+  NOT_INHERITED_CANT_OVERRIDE
+
+#define NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_CLASS(_class)             \
+  NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_CLASS_AMBIGUOUS(_class, _class)
+
 // Cycle collector helper for ambiguous classes that can sometimes be skipped.
 #define NS_DECL_CYCLE_COLLECTION_SKIPPABLE_CLASS_AMBIGUOUS(_class, _base)        \
 class NS_CYCLE_COLLECTION_INNERCLASS                                             \
@@ -836,6 +874,29 @@ private:                                                                       \
   };                                                                           \
   static NS_CYCLE_COLLECTION_INNERCLASS NS_CYCLE_COLLECTION_INNERNAME;
 
+// Native-class variant of NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_CLASS;
+// see nsCycleCollectionParticipant::IsTraverseThreadSafe for the contract.
+#define NS_DECL_CYCLE_COLLECTION_THREADSAFE_TRAVERSE_NATIVE_CLASS(_class)      \
+  void DeleteCycleCollectable(void)                                            \
+  {                                                                            \
+    delete this;                                                               \
+  }                                                                            \
+  class NS_CYCLE_COLLECTION_INNERCLASS                                         \
+   : public nsCycleCollectionParticipant                                       \
+  {                                                                            \
+public:                                                                        \
+  constexpr explicit NS_CYCLE_COLLECTION_INNERCLASS (bool aSkip = false)       \
+    : nsCycleCollectionParticipant(aSkip, false,                               \
+                                   /* aTraverseThreadSafe = */ true) {}        \
+private:                                                                       \
+    NS_DECL_CYCLE_COLLECTION_NATIVE_CLASS_BODY(_class)                         \
+    static constexpr nsCycleCollectionParticipant* GetParticipant()            \
+    {                                                                          \
+      return &_class::NS_CYCLE_COLLECTION_INNERNAME;                           \
+    }                                                                          \
+  };                                                                           \
+  static NS_CYCLE_COLLECTION_INNERCLASS NS_CYCLE_COLLECTION_INNERNAME;
+
 #define NS_DECL_CYCLE_COLLECTION_SKIPPABLE_NATIVE_CLASS(_class)                \
   void DeleteCycleCollectable(void)                                            \
   {                                                                            \
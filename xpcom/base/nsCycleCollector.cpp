@@ -161,8 +161,11 @@
 /* This must occur *after* base/process_util.h to avoid typedefs conflicts. */
 #include "mozilla/LinkedList.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/Monitor.h"
 #include "mozilla/Move.h"
 #include "mozilla/SegmentedVector.h"
+#include "mozilla/UniquePtr.h"
+#include "prthread.h"
 
 #include "nsCycleCollectionParticipant.h"
 #include "nsCycleCollectionNoteRootCallback.h"
@@ -2103,6 +2106,224 @@ ValueIsGrayCCThing(const JS::Value& value)
            JS::GCThingIsMarkedGray(value.toGCCellPtr());
 }
 
+////////////////////////////////////////////////////////////////////////
+// Off-main-thread traversal.
+//
+// Participants which promise that their Traverse() only reads state owned by
+// the object being traversed (see
+// nsCycleCollectionParticipant::IsTraverseThreadSafe) can be traversed on a
+// background thread while the main thread traverses everything else.  The
+// background thread never touches the graph: it records the refcount and the
+// children reported by Traverse() into a CCOffThreadTraversalJob, and the
+// main thread replays that record into the CCGraphBuilder in node order, so
+// the graph comes out identical to a fully main-thread build.  Scanning and
+// unlinking are unchanged and stay on the main thread.
+//
+// The pipeline never outlives a slice of graph building: every job handed to
+// the background thread is replayed before BuildGraph() returns, so the
+// background thread holds no pointers into the heap while the mutator runs
+// between slices.
+////////////////////////////////////////////////////////////////////////
+
+class CCOffThreadTraversalJob final : public nsCycleCollectionTraversalCallback
+{
+public:
+  explicit CCOffThreadTraversalJob(PtrInfo* aPi)
+    : mPi(aPi)
+    , mTraverseResult(NS_OK)
+    , mRefCount(0)
+    , mCompartmentAddress(0)
+    , mObjName(nullptr)
+    , mDescribedRefCounted(false)
+    , mDescribedGCed(false)
+    , mGCMarked(false)
+  {
+  }
+
+  struct Child
+  {
+    enum Kind
+    {
+      eXPCOM,
+      eNative,
+      eJS
+    };
+
+    Kind mKind;
+    void* mPointer;
+    nsCycleCollectionParticipant* mParticipant;
+    JS::GCCellPtr mJSChild;
+  };
+
+  // nsCycleCollectionTraversalCallback, called on the background thread.
+  NS_IMETHOD_(void) DescribeRefCountedNode(nsrefcnt aRefCount,
+                                           const char* aObjName) override
+  {
+    mDescribedRefCounted = true;
+    mRefCount = aRefCount;
+    mObjName = aObjName;
+  }
+
+  NS_IMETHOD_(void) DescribeGCedNode(bool aIsMarked, const char* aObjName,
+                                     uint64_t aCompartmentAddress) override
+  {
+    mDescribedGCed = true;
+    mGCMarked = aIsMarked;
+    mObjName = aObjName;
+    mCompartmentAddress = aCompartmentAddress;
+  }
+
+  NS_IMETHOD_(void) NoteXPCOMChild(nsISupports* aChild) override
+  {
+    AppendChild(Child::eXPCOM, aChild, nullptr, JS::GCCellPtr());
+  }
+
+  NS_IMETHOD_(void) NoteNativeChild(void* aChild,
+                                    nsCycleCollectionParticipant* aParticipant) override
+  {
+    AppendChild(Child::eNative, aChild, aParticipant, JS::GCCellPtr());
+  }
+
+  NS_IMETHOD_(void) NoteJSChild(const JS::GCCellPtr& aThing) override
+  {
+    AppendChild(Child::eJS, nullptr, nullptr, aThing);
+  }
+
+  NS_IMETHOD_(void) NoteNextEdgeName(const char* aName) override
+  {
+    // Edge names are only consumed with WANT_DEBUG_INFO, and the off-thread
+    // path is disabled while a logger is attached.
+  }
+
+  PtrInfo* mPi;
+  nsresult mTraverseResult;
+  nsrefcnt mRefCount;
+  uint64_t mCompartmentAddress;
+  const char* mObjName;
+  nsTArray<Child> mChildren;
+  bool mDescribedRefCounted;
+  bool mDescribedGCed;
+  bool mGCMarked;
+
+private:
+  void AppendChild(Child::Kind aKind, void* aPointer,
+                   nsCycleCollectionParticipant* aParticipant,
+                   JS::GCCellPtr aJSChild)
+  {
+    Child* child = mChildren.AppendElement();
+    child->mKind = aKind;
+    child->mPointer = aPointer;
+    child->mParticipant = aParticipant;
+    child->mJSChild = aJSChild;
+  }
+};
+
+class CCOffThreadTraverser final
+{
+public:
+  CCOffThreadTraverser()
+    : mMonitor("CCOffThreadTraverser")
+    , mThread(nullptr)
+    , mShutdown(false)
+  {
+  }
+
+  ~CCOffThreadTraverser()
+  {
+    Shutdown();
+  }
+
+  // Spawn the background thread. Returns false on failure, in which case the
+  // caller traverses everything on the main thread as before.
+  bool Start()
+  {
+    MOZ_ASSERT(!mThread);
+    mThread = PR_CreateThread(PR_USER_THREAD, ThreadFunc, this,
+                              PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                              PR_JOINABLE_THREAD, 0);
+    return !!mThread;
+  }
+
+  void Shutdown()
+  {
+    if (!mThread) {
+      return;
+    }
+    {
+      MonitorAutoLock lock(mMonitor);
+      MOZ_ASSERT(mPending.IsEmpty() && mDone.IsEmpty(),
+                 "A traversal job must not outlive its BuildGraph() slice");
+      mShutdown = true;
+      lock.NotifyAll();
+    }
+    PR_JoinThread(mThread);
+    mThread = nullptr;
+  }
+
+  void Dispatch(UniquePtr<CCOffThreadTraversalJob> aJob)
+  {
+    MonitorAutoLock lock(mMonitor);
+    mPending.AppendElement(Move(aJob));
+    lock.NotifyAll();
+  }
+
+  // Block until the background thread has finished recording the traversal
+  // of aPi, and take ownership of the record.
+  UniquePtr<CCOffThreadTraversalJob> WaitFor(PtrInfo* aPi)
+  {
+    MonitorAutoLock lock(mMonitor);
+    for (;;) {
+      for (uint32_t i = 0; i < mDone.Length(); ++i) {
+        if (mDone[i]->mPi == aPi) {
+          UniquePtr<CCOffThreadTraversalJob> job = Move(mDone[i]);
+          mDone.RemoveElementAt(i);
+          return job;
+        }
+      }
+      lock.Wait();
+    }
+  }
+
+private:
+  static void ThreadFunc(void* aArg)
+  {
+    AUTO_PROFILER_REGISTER_THREAD("CC Traverse");
+    NS_SetCurrentThreadName("CC Traverse");
+    static_cast<CCOffThreadTraverser*>(aArg)->Run();
+  }
+
+  void Run()
+  {
+    MonitorAutoLock lock(mMonitor);
+    for (;;) {
+      while (mPending.IsEmpty() && !mShutdown) {
+        lock.Wait();
+      }
+      if (mPending.IsEmpty()) {
+        MOZ_ASSERT(mShutdown);
+        return;
+      }
+
+      UniquePtr<CCOffThreadTraversalJob> job = Move(mPending[0]);
+      mPending.RemoveElementAt(0);
+      {
+        MonitorAutoUnlock unlock(mMonitor);
+        job->mTraverseResult =
+          job->mPi->mParticipant->TraverseNativeAndJS(job->mPi->mPointer, *job);
+      }
+      mDone.AppendElement(Move(job));
+      lock.NotifyAll();
+    }
+  }
+
+  Monitor mMonitor;
+  // Both arrays are guarded by mMonitor.
+  nsTArray<UniquePtr<CCOffThreadTraversalJob>> mPending;
+  nsTArray<UniquePtr<CCOffThreadTraversalJob>> mDone;
+  PRThread* mThread;
+  bool mShutdown;
+};
+
 ////////////////////////////////////////////////////////////////////////
 // Bacon & Rajan's |MarkRoots| routine.
 ////////////////////////////////////////////////////////////////////////
@@ -2123,6 +2344,8 @@ private:
   bool mMergeZones;
   nsAutoPtr<NodePool::Enumerator> mCurrNode;
   uint32_t mNoteChildCount;
+  nsAutoPtr<CCOffThreadTraverser> mOffThreadTraverser;
+  bool mOffThreadTraverserFailed;
 
 public:
   CCGraphBuilder(CCGraph& aGraph,
@@ -2150,6 +2373,9 @@ private:
   PtrInfo* AddWeakMapNode(JS::GCCellPtr aThing);
   PtrInfo* AddWeakMapNode(JSObject* aObject);
 
+  bool EnsureOffThreadTraverser();
+  void ReplayOffThreadTraversal(CCOffThreadTraversalJob& aJob);
+
   void SetFirstChild()
   {
     mCurrPi->SetFirstChild(mEdgeBuilder.Mark());
@@ -2237,6 +2463,7 @@ CCGraphBuilder::CCGraphBuilder(CCGraph& aGraph,
   , mLogger(aLogger)
   , mMergeZones(aMergeZones)
   , mNoteChildCount(0)
+  , mOffThreadTraverserFailed(false)
 {
   if (aCCRuntime) {
     mJSParticipant = aCCRuntime->GCThingParticipant();
@@ -2311,38 +2538,122 @@ CCGraphBuilder::DoneAddingRoots()
   mCurrNode = new NodePool::Enumerator(mGraph.mNodes);
 }
 
+bool
+CCGraphBuilder::EnsureOffThreadTraverser()
+{
+  if (mOffThreadTraverser) {
+    return true;
+  }
+  if (mOffThreadTraverserFailed) {
+    return false;
+  }
+  nsAutoPtr<CCOffThreadTraverser> traverser(new CCOffThreadTraverser());
+  if (!traverser->Start()) {
+    mOffThreadTraverserFailed = true;
+    return false;
+  }
+  mOffThreadTraverser = traverser.forget();
+  return true;
+}
+
+void
+CCGraphBuilder::ReplayOffThreadTraversal(CCOffThreadTraversalJob& aJob)
+{
+  MOZ_RELEASE_ASSERT(!NS_FAILED(aJob.mTraverseResult),
+                     "Cycle collector Traverse method failed");
+
+  if (aJob.mDescribedRefCounted) {
+    DescribeRefCountedNode(aJob.mRefCount, aJob.mObjName);
+  } else if (aJob.mDescribedGCed) {
+    DescribeGCedNode(aJob.mGCMarked, aJob.mObjName, aJob.mCompartmentAddress);
+  }
+
+  for (CCOffThreadTraversalJob::Child& child : aJob.mChildren) {
+    switch (child.mKind) {
+      case CCOffThreadTraversalJob::Child::eXPCOM:
+        NoteXPCOMChild(static_cast<nsISupports*>(child.mPointer));
+        break;
+      case CCOffThreadTraversalJob::Child::eNative:
+        NoteNativeChild(child.mPointer, child.mParticipant);
+        break;
+      case CCOffThreadTraversalJob::Child::eJS:
+        NoteJSChild(child.mJSChild);
+        break;
+    }
+  }
+}
+
 MOZ_NEVER_INLINE bool
 CCGraphBuilder::BuildGraph(SliceBudget& aBudget)
 {
   const intptr_t kNumNodesBetweenTimeChecks = 1000;
   const intptr_t kStep = SliceBudget::CounterReset / kNumNodesBetweenTimeChecks;
 
+  // How many nodes are pulled out of the node pool at once. Nodes whose
+  // participant is thread-safe traversable run their Traverse() on the
+  // background thread while the main thread works through the rest of the
+  // batch, so this bounds both the pipeline depth and how far we can run
+  // past the budget, which is only checked between batches.
+  const uint32_t kTraverseBatchSize = 16;
+
+  struct BatchEntry
+  {
+    PtrInfo* mPi;
+    bool mAtBlockEnd;
+    bool mOffThread;
+  };
+
   MOZ_ASSERT(mCurrNode);
 
   while (!aBudget.isOverBudget() && !mCurrNode->IsDone()) {
-    mNoteChildCount = 0;
+    // Pull a batch of nodes out of the node pool, handing the ones which can
+    // be traversed off the main thread to the background thread. Their
+    // recorded traversals are replayed below, in node order, so the graph is
+    // built exactly as if everything ran on the main thread.
+    AutoTArray<BatchEntry, kTraverseBatchSize> batch;
+    while (batch.Length() < kTraverseBatchSize && !mCurrNode->IsDone()) {
+      PtrInfo* pi = mCurrNode->GetNext();
+      if (!pi) {
+        MOZ_CRASH();
+      }
 
-    PtrInfo* pi = mCurrNode->GetNext();
-    if (!pi) {
-      MOZ_CRASH();
-    }
+      bool offThread = false;
+      // The logger wants edge names and must see traversals in order, so
+      // everything stays on the main thread when logging.
+      if (pi->mParticipant && !mLogger &&
+          pi->mParticipant->IsTraverseThreadSafe() &&
+          EnsureOffThreadTraverser()) {
+        mOffThreadTraverser->Dispatch(MakeUnique<CCOffThreadTraversalJob>(pi));
+        offThread = true;
+      }
 
-    mCurrPi = pi;
+      batch.AppendElement(BatchEntry{ pi, mCurrNode->AtBlockEnd(), offThread });
+    }
 
-    // We need to call SetFirstChild() even on deleted nodes, to set their
-    // firstChild() that may be read by a prior non-deleted neighbor.
-    SetFirstChild();
+    for (BatchEntry& entry : batch) {
+      mNoteChildCount = 0;
+      mCurrPi = entry.mPi;
+
+      // We need to call SetFirstChild() even on deleted nodes, to set their
+      // firstChild() that may be read by a prior non-deleted neighbor.
+      SetFirstChild();
+
+      if (entry.mOffThread) {
+        UniquePtr<CCOffThreadTraversalJob> job =
+          mOffThreadTraverser->WaitFor(entry.mPi);
+        ReplayOffThreadTraversal(*job);
+      } else if (entry.mPi->mParticipant) {
+        nsresult rv =
+          entry.mPi->mParticipant->TraverseNativeAndJS(entry.mPi->mPointer, *this);
+        MOZ_RELEASE_ASSERT(!NS_FAILED(rv), "Cycle collector Traverse method failed");
+      }
 
-    if (pi->mParticipant) {
-      nsresult rv = pi->mParticipant->TraverseNativeAndJS(pi->mPointer, *this);
-      MOZ_RELEASE_ASSERT(!NS_FAILED(rv), "Cycle collector Traverse method failed");
-    }
+      if (entry.mAtBlockEnd) {
+        SetLastChild();
+      }
 
-    if (mCurrNode->AtBlockEnd()) {
-      SetLastChild();
+      aBudget.step(kStep * (mNoteChildCount + 1));
     }
-
-    aBudget.step(kStep * (mNoteChildCount + 1));
   }
 
   if (!mCurrNode->IsDone()) {
@@ -2355,6 +2666,10 @@ CCGraphBuilder::BuildGraph(SliceBudget& aBudget)
 
   mCurrNode = nullptr;
 
+  // Graph building is finished; the background thread has nothing more to do
+  // until the next collection.
+  mOffThreadTraverser = nullptr;
+
   return true;
 }
 
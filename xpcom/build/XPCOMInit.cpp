@@ -73,6 +73,7 @@
 #include "nsICategoryManager.h"
 #include "nsMultiplexInputStream.h"
 
+#include "nsStringBuffer.h"
 #include "nsStringStream.h"
 extern nsresult nsStringInputStreamConstructor(nsISupports*, REFNSIID, void**);
 
@@ -472,6 +473,10 @@ NS_InitXPCOM2(nsIServiceManager** aResult,
 
   NS_InitAtomTable();
 
+  // Set up the per-thread small string buffer cache before strings start
+  // flowing in earnest.
+  nsStringBuffer::InitThreadCache();
+
   mozilla::LogModule::Init();
 
   nsresult rv = NS_OK;
@@ -756,6 +761,7 @@ NS_InitMinimalXPCOM()
   mozilla::TimeStamp::Startup();
   NS_LogInit();
   NS_InitAtomTable();
+  nsStringBuffer::InitThreadCache();
   mozilla::LogModule::Init();
 
   nsresult rv = nsThreadManager::get().Init();
@@ -1045,6 +1051,9 @@ ShutdownXPCOM(nsIServiceManager* aServMgr)
 
   NS_ShutdownAtomTable();
 
+  // Free the main thread's small string buffer cache.
+  nsStringBuffer::ClearThreadCache();
+
   NS_IF_RELEASE(gDebug);
 
   delete sIOThread;
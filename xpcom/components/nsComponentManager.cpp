@@ -302,11 +302,7 @@ nsComponentManagerImpl::Init()
 
   nsCategoryManager::GetSingleton()->SuppressNotifications(true);
 
-  RegisterModule(&kXPCOMModule, nullptr);
-
-  for (uint32_t i = 0; i < sStaticModules->Length(); ++i) {
-    RegisterModule((*sStaticModules)[i], nullptr);
-  }
+  RegisterStaticModules();
 
   bool loadChromeManifests = (XRE_GetProcessType() != GeckoProcessType_GPU);
   if (loadChromeManifests) {
@@ -403,6 +399,66 @@ ProcessSelectorMatches(Module::ProcessSelector aSelector)
 
 static const int kModuleVersionWithSelector = 51;
 
+void
+nsComponentManagerImpl::RegisterStaticModules()
+{
+  mLock.AssertNotCurrentThreadOwns();
+
+  // The static module tables live in .rodata and never change between
+  // startups, so there's no point paying RegisterModule()'s per-module
+  // lock round-trip for each of them. Filter by process selector once,
+  // then register the whole batch under a single lock acquisition.
+  AutoTArray<const mozilla::Module*, 256> modules;
+  modules.AppendElement(&kXPCOMModule);
+  for (uint32_t i = 0; i < sStaticModules->Length(); ++i) {
+    const mozilla::Module* module = (*sStaticModules)[i];
+    if (module->mVersion >= kModuleVersionWithSelector &&
+        !ProcessSelectorMatches(module->selector)) {
+      continue;
+    }
+    modules.AppendElement(module);
+  }
+
+  {
+    MutexLock lock(mLock);
+
+    for (uint32_t i = 0; i < modules.Length(); ++i) {
+      const mozilla::Module* module = modules[i];
+
+      KnownModule* m = new KnownModule(module);
+      mKnownStaticModules.AppendElement(m);
+
+      if (module->mCIDs) {
+        const mozilla::Module::CIDEntry* entry;
+        for (entry = module->mCIDs; entry->cid; ++entry) {
+          RegisterCIDEntryLocked(entry, m);
+        }
+      }
+
+      if (module->mContractIDs) {
+        const mozilla::Module::ContractIDEntry* entry;
+        for (entry = module->mContractIDs; entry->contractid; ++entry) {
+          RegisterContractIDLocked(entry);
+        }
+        MOZ_ASSERT(!entry->cid, "Incorrectly terminated contract list");
+      }
+    }
+  }
+
+  // Category registration calls into the category manager and so must
+  // happen without our lock held.
+  for (uint32_t i = 0; i < modules.Length(); ++i) {
+    if (modules[i]->mCategoryEntries) {
+      const mozilla::Module::CategoryEntry* entry;
+      for (entry = modules[i]->mCategoryEntries; entry->category; ++entry) {
+        nsCategoryManager::GetSingleton()->AddCategoryEntry(entry->category,
+                                                            entry->entry,
+                                                            entry->value);
+      }
+    }
+  }
+}
+
 void
 nsComponentManagerImpl::RegisterModule(const mozilla::Module* aModule,
                                        FileLocation* aFile)
@@ -593,7 +649,7 @@ DoRegisterXPT(FileLocation& aFile)
     rv = data.Copy(buf.get(), len);
   }
   if (NS_SUCCEEDED(rv)) {
-    XPTInterfaceInfoManager::GetSingleton()->RegisterBuffer(buf.get(), len);
+    XPTInterfaceInfoManager::GetSingleton()->RegisterBuffer(Move(buf), len);
   } else {
     nsCString uri;
     aFile.GetURIString(uri);
@@ -259,6 +259,10 @@ public:
   void RegisterModule(const mozilla::Module* aModule,
                       mozilla::FileLocation* aFile);
 
+  // Registers kXPCOMModule and all linked-in static modules in one batch,
+  // taking the lock once for the whole set. Called from Init().
+  void RegisterStaticModules();
+
 
   // Mutex held
   void RegisterCIDEntryLocked(const mozilla::Module::CIDEntry* aEntry,
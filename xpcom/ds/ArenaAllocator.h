@@ -20,6 +20,26 @@
 
 namespace mozilla {
 
+/**
+ * The default chunk allocation policy for ArenaAllocator: chunks come
+ * straight from the malloc heap and go back to it when the allocator is
+ * cleared. Consumers that want to manage chunk memory themselves (for
+ * example, to recycle chunks through a pool) can supply their own policy
+ * providing the same two static methods.
+ */
+struct MallocArenaPolicy
+{
+  static void* AllocateChunk(size_t aSize)
+  {
+    return malloc(aSize);
+  }
+
+  static void FreeChunk(void* aPtr, size_t aSize)
+  {
+    free(aPtr);
+  }
+};
+
 /**
  * A very simple arena allocator based on NSPR's PLArena.
  *
@@ -36,7 +56,8 @@ namespace mozilla {
  *   DoSomething(a.Allocate(i));
  * }
  */
-template<size_t ArenaSize, size_t Alignment=1>
+template<size_t ArenaSize, size_t Alignment=1,
+         typename ChunkPolicy=MallocArenaPolicy>
 class ArenaAllocator
 {
 public:
@@ -95,7 +116,7 @@ public:
     while (a) {
       auto tmp = a;
       a = a->next;
-      free(tmp);
+      ChunkPolicy::FreeChunk(tmp, tmp->Size());
     }
 
     // Reset the list head.
@@ -165,6 +186,13 @@ private:
     size_t Available() const {
       return header.tail - header.offset;
     }
+
+    /**
+     * Calculates the total size of the chunk, including its header.
+     */
+    size_t Size() const {
+      return header.tail - uintptr_t(this);
+    }
   };
 
   /**
@@ -176,7 +204,7 @@ private:
     MOZ_ASSERT(kOffset < aSize);
 
     const size_t chunkSize = aSize + kOffset;
-    void* p = malloc(chunkSize);
+    void* p = ChunkPolicy::AllocateChunk(chunkSize);
     if (!p) {
       return nullptr;
     }
@@ -18,9 +18,9 @@ namespace mozilla {
 
 namespace detail {
 
-template<typename T, size_t ArenaSize, size_t Alignment>
+template<typename T, size_t ArenaSize, size_t Alignment, typename ChunkPolicy>
 T* DuplicateString(const T* aSrc, const CheckedInt<size_t>& aLen,
-                   ArenaAllocator<ArenaSize, Alignment>& aArena);
+                   ArenaAllocator<ArenaSize, Alignment, ChunkPolicy>& aArena);
 
 } // namespace detail
 
@@ -32,9 +32,9 @@ T* DuplicateString(const T* aSrc, const CheckedInt<size_t>& aLen,
  * @param aArena The arena to allocate the string copy out of.
  * @return An arena allocated null-terminated string.
  */
-template<size_t ArenaSize, size_t Alignment>
+template<size_t ArenaSize, size_t Alignment, typename ChunkPolicy>
 char* ArenaStrdup(const char* aStr,
-                  ArenaAllocator<ArenaSize, Alignment>& aArena)
+                  ArenaAllocator<ArenaSize, Alignment, ChunkPolicy>& aArena)
 {
   return detail::DuplicateString(aStr, strlen(aStr), aArena);
 }
@@ -46,9 +46,9 @@ char* ArenaStrdup(const char* aStr,
  * @param aArena The arena to allocate the string copy out of.
  * @return An arena allocated null-terminated string.
  */
-template<size_t ArenaSize, size_t Alignment>
+template<size_t ArenaSize, size_t Alignment, typename ChunkPolicy>
 nsAString::char_type* ArenaStrdup(
-    const nsAString& aStr, ArenaAllocator<ArenaSize, Alignment>& aArena)
+    const nsAString& aStr, ArenaAllocator<ArenaSize, Alignment, ChunkPolicy>& aArena)
 {
   return detail::DuplicateString(aStr.BeginReading(), aStr.Length(), aArena);
 }
@@ -60,9 +60,9 @@ nsAString::char_type* ArenaStrdup(
  * @param aArena The arena to allocate the string copy out of.
  * @return An arena allocated null-terminated string.
  */
-template<size_t ArenaSize, size_t Alignment>
+template<size_t ArenaSize, size_t Alignment, typename ChunkPolicy>
 nsACString::char_type* ArenaStrdup(
-    const nsACString& aStr, ArenaAllocator<ArenaSize, Alignment>& aArena)
+    const nsACString& aStr, ArenaAllocator<ArenaSize, Alignment, ChunkPolicy>& aArena)
 {
   return detail::DuplicateString(aStr.BeginReading(), aStr.Length(), aArena);
 }
@@ -71,9 +71,9 @@ nsACString::char_type* ArenaStrdup(
  * Copies the source string and adds a null terminator. Source string does not
  * have to be null terminated.
  */
-template<typename T, size_t ArenaSize, size_t Alignment>
+template<typename T, size_t ArenaSize, size_t Alignment, typename ChunkPolicy>
 T* detail::DuplicateString(const T* aSrc, const CheckedInt<size_t>& aLen,
-                           ArenaAllocator<ArenaSize, Alignment>& aArena)
+                           ArenaAllocator<ArenaSize, Alignment, ChunkPolicy>& aArena)
 {
   const auto byteLen = (aLen + 1) * sizeof(T);
   if (!byteLen.isValid()) {
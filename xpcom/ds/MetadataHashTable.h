@@ -0,0 +1,359 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_MetadataHashTable_h
+#define mozilla_MetadataHashTable_h
+
+/**
+ * MetadataHashTable is an open-addressing hash table that stores one byte of
+ * metadata per slot in a separate, densely packed control array.  A control
+ * byte is either kEmpty, kDeleted, or the low 7 bits of the entry's hash
+ * ("H2").  Probing inspects 16 control bytes at a time: with SSE2 a whole
+ * group is matched with a handful of instructions, and on other platforms a
+ * portable 8-bytes-at-a-time bit-trick fallback is used.  Compared to
+ * PLDHashTable's double hashing this touches far fewer cache lines per
+ * lookup, because 16 candidate slots are rejected without ever loading the
+ * entries themselves.
+ *
+ * The table is a template over the entry type and a hash policy:
+ *
+ *   struct Policy
+ *   {
+ *     using Lookup = ...;                              // key type
+ *     static PLDHashNumber Hash(const Lookup& aKey);
+ *     static bool Match(const Entry& aEntry, const Lookup& aKey);
+ *   };
+ *
+ * Entries must be movable and must expose the hash of their key via
+ * `PLDHashNumber RehashKey() const` so they can be relocated on growth,
+ * much like PLDHashTable entries.  The table is not thread-safe.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mozilla/Assertions.h"
+#include "mozilla/Attributes.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/Move.h"
+#include "mozilla/OperatorNewExtensions.h"
+#include "nscore.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOZ_METADATA_HASH_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+typedef uint32_t PLDHashNumber;
+
+namespace mozilla {
+
+namespace detail {
+
+// A set of slot indices within one 16-slot group, iterated from an SSE2
+// movemask or from the synthesized mask of the portable fallback.
+class MetadataGroupMatch
+{
+public:
+  explicit MetadataGroupMatch(uint32_t aMask) : mMask(aMask) {}
+
+  bool HasNext() const { return mMask != 0; }
+
+  uint32_t Next()
+  {
+    MOZ_ASSERT(HasNext());
+    uint32_t index = CountTrailingZeroes32(mMask);
+    mMask &= mMask - 1;
+    return index;
+  }
+
+private:
+  uint32_t mMask;
+};
+
+// One aligned group of 16 control bytes.
+class MetadataGroup
+{
+public:
+  static const uint32_t kWidth = 16;
+
+  static const uint8_t kEmpty = 0x80;
+  static const uint8_t kDeleted = 0xFE;
+
+  explicit MetadataGroup(const uint8_t* aCtrl)
+  {
+#ifdef MOZ_METADATA_HASH_TABLE_SSE2
+    mCtrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aCtrl));
+#else
+    memcpy(mBytes, aCtrl, kWidth);
+#endif
+  }
+
+  // Slots whose H2 byte equals aH2.
+  MetadataGroupMatch Match(uint8_t aH2) const
+  {
+#ifdef MOZ_METADATA_HASH_TABLE_SSE2
+    __m128i needle = _mm_set1_epi8(static_cast<char>(aH2));
+    return MetadataGroupMatch(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(mCtrl, needle)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < kWidth; i++) {
+      if (mBytes[i] == aH2) {
+        mask |= 1u << i;
+      }
+    }
+    return MetadataGroupMatch(mask);
+#endif
+  }
+
+  // Slots that are empty (not deleted).  A probe sequence ends at the first
+  // group containing an empty slot.
+  MetadataGroupMatch MatchEmpty() const { return Match(kEmpty); }
+
+  // Slots that can receive a new entry (empty or deleted).  Both have the
+  // sign bit set; H2 bytes never do.
+  MetadataGroupMatch MatchAvailable() const
+  {
+#ifdef MOZ_METADATA_HASH_TABLE_SSE2
+    return MetadataGroupMatch(_mm_movemask_epi8(mCtrl));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < kWidth; i++) {
+      if (mBytes[i] & 0x80) {
+        mask |= 1u << i;
+      }
+    }
+    return MetadataGroupMatch(mask);
+#endif
+  }
+
+private:
+#ifdef MOZ_METADATA_HASH_TABLE_SSE2
+  __m128i mCtrl;
+#else
+  uint8_t mBytes[kWidth];
+#endif
+};
+
+} // namespace detail
+
+template<typename Entry, typename Policy>
+class MetadataHashTable
+{
+  using Group = detail::MetadataGroup;
+  using Lookup = typename Policy::Lookup;
+
+  static const uint32_t kMinCapacity = 16;
+
+public:
+  MetadataHashTable()
+    : mCtrl(nullptr)
+    , mEntries(nullptr)
+    , mCapacity(0)
+    , mCount(0)
+    , mGrowthLeft(0)
+  {
+  }
+
+  ~MetadataHashTable()
+  {
+    Clear();
+    free(mCtrl);
+    free(mEntries);
+  }
+
+  MetadataHashTable(const MetadataHashTable&) = delete;
+  MetadataHashTable& operator=(const MetadataHashTable&) = delete;
+
+  uint32_t Count() const { return mCount; }
+  uint32_t Capacity() const { return mCapacity; }
+
+  // Returns the matching entry, or null if there is none.
+  Entry* Search(const Lookup& aKey) const
+  {
+    if (!mCapacity) {
+      return nullptr;
+    }
+    PLDHashNumber hash = Policy::Hash(aKey);
+    uint8_t h2 = H2(hash);
+    uint32_t groupCount = mCapacity / Group::kWidth;
+    uint32_t groupIndex = H1(hash) & (groupCount - 1);
+    for (uint32_t probes = 0; probes < groupCount; probes++) {
+      Group group(mCtrl + groupIndex * Group::kWidth);
+      for (detail::MetadataGroupMatch match = group.Match(h2);
+           match.HasNext();) {
+        uint32_t slot = groupIndex * Group::kWidth + match.Next();
+        if (MOZ_LIKELY(Policy::Match(mEntries[slot], aKey))) {
+          return &mEntries[slot];
+        }
+      }
+      if (group.MatchEmpty().HasNext()) {
+        return nullptr;
+      }
+      groupIndex = (groupIndex + 1) & (groupCount - 1);
+    }
+    return nullptr;
+  }
+
+  // Adds an entry for aKey, replacing any existing one.  Returns null only
+  // on OOM.
+  Entry* Add(const Lookup& aKey, Entry&& aEntry)
+  {
+    if (Entry* existing = Search(aKey)) {
+      *existing = Move(aEntry);
+      return existing;
+    }
+    return AddNew(aKey, Move(aEntry));
+  }
+
+  // Adds an entry that must not already be present.
+  Entry* AddNew(const Lookup& aKey, Entry&& aEntry)
+  {
+    MOZ_ASSERT(!Search(aKey));
+    if (mGrowthLeft == 0 && !Grow()) {
+      return nullptr;
+    }
+    PLDHashNumber hash = Policy::Hash(aKey);
+    uint32_t slot = FindInsertSlot(hash);
+    if (mCtrl[slot] == Group::kEmpty) {
+      mGrowthLeft--;
+    }
+    mCtrl[slot] = H2(hash);
+    new (KnownNotNull, &mEntries[slot]) Entry(Move(aEntry));
+    mCount++;
+    return &mEntries[slot];
+  }
+
+  // Removes the entry for aKey.  Returns false if there was none.
+  bool Remove(const Lookup& aKey)
+  {
+    Entry* entry = Search(aKey);
+    if (!entry) {
+      return false;
+    }
+    uint32_t slot = entry - mEntries;
+    entry->~Entry();
+    // Keeping a tombstone is only necessary if the slot's group has no empty
+    // slot, i.e. if some probe sequence may have passed through it.
+    Group group(mCtrl + (slot / Group::kWidth) * Group::kWidth);
+    if (group.MatchEmpty().HasNext()) {
+      mCtrl[slot] = Group::kEmpty;
+      mGrowthLeft++;
+    } else {
+      mCtrl[slot] = Group::kDeleted;
+    }
+    mCount--;
+    return true;
+  }
+
+  void Clear()
+  {
+    for (uint32_t i = 0; i < mCapacity; i++) {
+      if (!(mCtrl[i] & 0x80)) {
+        mEntries[i].~Entry();
+      }
+    }
+    if (mCapacity) {
+      memset(mCtrl, Group::kEmpty, mCapacity);
+      mGrowthLeft = MaxLoad(mCapacity);
+    }
+    mCount = 0;
+  }
+
+  // Calls aFunc(Entry&) for every live entry.
+  template<typename Func>
+  void ForEach(Func&& aFunc)
+  {
+    for (uint32_t i = 0; i < mCapacity; i++) {
+      if (!(mCtrl[i] & 0x80)) {
+        aFunc(mEntries[i]);
+      }
+    }
+  }
+
+  size_t ShallowSizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const
+  {
+    return aMallocSizeOf(mCtrl) + aMallocSizeOf(mEntries);
+  }
+
+private:
+  static uint32_t H1(PLDHashNumber aHash) { return aHash >> 7; }
+  static uint8_t H2(PLDHashNumber aHash) { return aHash & 0x7F; }
+
+  // We resize at 7/8 occupancy, like other metadata-probing tables.
+  static uint32_t MaxLoad(uint32_t aCapacity)
+  {
+    return aCapacity - aCapacity / 8;
+  }
+
+  // Finds the slot a new entry with the given hash should go into.  The
+  // caller guarantees no entry with the same key exists.
+  uint32_t FindInsertSlot(PLDHashNumber aHash) const
+  {
+    uint32_t groupCount = mCapacity / Group::kWidth;
+    uint32_t groupIndex = H1(aHash) & (groupCount - 1);
+    for (;;) {
+      Group group(mCtrl + groupIndex * Group::kWidth);
+      detail::MetadataGroupMatch match = group.MatchAvailable();
+      if (match.HasNext()) {
+        return groupIndex * Group::kWidth + match.Next();
+      }
+      groupIndex = (groupIndex + 1) & (groupCount - 1);
+    }
+  }
+
+  MOZ_MUST_USE bool Grow()
+  {
+    uint32_t newCapacity = mCapacity ? mCapacity * 2 : kMinCapacity;
+
+    uint8_t* oldCtrl = mCtrl;
+    Entry* oldEntries = mEntries;
+    uint32_t oldCapacity = mCapacity;
+
+    uint8_t* newCtrl = static_cast<uint8_t*>(malloc(newCapacity));
+    Entry* newEntries =
+      static_cast<Entry*>(malloc(newCapacity * sizeof(Entry)));
+    if (!newCtrl || !newEntries) {
+      free(newCtrl);
+      free(newEntries);
+      return false;
+    }
+    memset(newCtrl, Group::kEmpty, newCapacity);
+
+    mCtrl = newCtrl;
+    mEntries = newEntries;
+    mCapacity = newCapacity;
+    mGrowthLeft = MaxLoad(newCapacity) - mCount;
+
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+      if (!(oldCtrl[i] & 0x80)) {
+        PLDHashNumber hash = oldEntries[i].RehashKey();
+        uint32_t slot = FindInsertSlot(hash);
+        mCtrl[slot] = H2(hash);
+        new (KnownNotNull, &mEntries[slot]) Entry(Move(oldEntries[i]));
+        oldEntries[i].~Entry();
+      }
+    }
+    free(oldCtrl);
+    free(oldEntries);
+    return true;
+  }
+
+  // Control bytes; one per slot, in groups of Group::kWidth.
+  uint8_t* mCtrl;
+  Entry* mEntries;
+  uint32_t mCapacity;    // always zero or a power of two >= kMinCapacity
+  uint32_t mCount;       // live entries
+  uint32_t mGrowthLeft;  // insertions possible before the next resize
+};
+
+} // namespace mozilla
+
+#endif // mozilla_MetadataHashTable_h
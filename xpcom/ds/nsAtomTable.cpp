@@ -9,6 +9,7 @@
 #include "mozilla/HashFunctions.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/StaticMutex.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/Unused.h"
@@ -29,19 +30,22 @@
 // There are two kinds of atoms handled by this module.
 //
 // - Dynamic: the atom itself is heap allocated, as is the nsStringBuffer it
-//   points to. |gAtomTable| holds weak references to dynamic atoms. When the
-//   refcount of a dynamic atom drops to zero, we increment a static counter.
-//   When that counter reaches a certain threshold, we iterate over the atom
-//   table, removing and deleting dynamic atoms with refcount zero. This allows
-//   us to avoid acquiring the atom table lock during normal refcounting.
+//   points to. The atom table holds weak references to dynamic atoms. When
+//   the refcount of a dynamic atom drops to zero, we increment a static
+//   counter. When that counter reaches a certain threshold, we iterate over
+//   the atom table, removing and deleting dynamic atoms with refcount zero.
+//   This allows us to avoid acquiring the atom table locks during normal
+//   refcounting.
 //
 // - Static: the atom itself is heap allocated, but it points to a static
-//   nsStringBuffer. |gAtomTable| effectively owns static atoms, because such
-//   atoms ignore all AddRef/Release calls, which ensures they stay alive until
-//   |gAtomTable| itself is destroyed whereupon they are explicitly deleted.
+//   nsStringBuffer. The atom table effectively owns static atoms, because
+//   such atoms ignore all AddRef/Release calls, which ensures they stay
+//   alive until the atom table itself is destroyed whereupon they are
+//   explicitly deleted.
 //
-// Note that gAtomTable is used on multiple threads, and callers must acquire
-// gAtomTableLock before touching it.
+// The atom table is used on multiple threads. It is split into shards by
+// string hash, each guarded by its own lock, so threads atomizing different
+// strings mostly proceed in parallel; see |gAtomTableShards| below.
 
 using namespace mozilla;
 
@@ -83,8 +87,7 @@ public:
   static void AtomTableClearEntry(PLDHashTable* aTable,
                                   PLDHashEntryHdr* aEntry);
 
-  static void GCAtomTableLocked(const MutexAutoLock& aProofOfLock,
-                                GCKind aKind);
+  static void GCAtomTable(GCKind aKind);
 
   static already_AddRefed<nsAtom> Atomize(const nsACString& aUTF8String);
   static already_AddRefed<nsAtom> Atomize(const nsAString& aUTF16String);
@@ -234,10 +237,18 @@ nsAtom::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const
 /**
  * The shared hash table for atom lookups.
  *
- * Callers must hold gAtomTableLock before manipulating the table.
+ * The table is split into shards, each covering a slice of the hash space
+ * and guarded by its own lock, so that threads atomizing different strings
+ * mostly do not contend.  Callers must hold the shard's lock (obtained via
+ * ShardForHash()) before touching that shard's table.
  */
-static PLDHashTable* gAtomTable;
-static Mutex* gAtomTableLock;
+class AtomTableShard;
+static AtomTableShard* gAtomTableShards;
+
+// Must be a power of two.  16 shards keeps contention negligible even with
+// the parser, style system and workers atomizing concurrently, while each
+// shard still stays dense enough to not waste memory.
+#define ATOM_TABLE_SHARD_COUNT 16
 
 struct AtomTableKey
 {
@@ -356,7 +367,7 @@ static nsAtom*
   sRecentlyUsedMainThreadAtoms[RECENTLY_USED_MAIN_THREAD_ATOM_CACHE_SIZE] = {};
 
 void
-nsAtomFriend::GCAtomTableLocked(const MutexAutoLock& aProofOfLock, GCKind aKind)
+nsAtomFriend::GCAtomTable(GCKind aKind)
 {
   MOZ_ASSERT(NS_IsMainThread());
   for (uint32_t i = 0; i < RECENTLY_USED_MAIN_THREAD_ATOM_CACHE_SIZE; ++i) {
@@ -366,37 +377,42 @@ nsAtomFriend::GCAtomTableLocked(const MutexAutoLock& aProofOfLock, GCKind aKind)
   int32_t removedCount = 0; // Use a non-atomic temporary for cheaper increments.
   nsAutoCString nonZeroRefcountAtoms;
   uint32_t nonZeroRefcountAtomsCount = 0;
-  for (auto i = gAtomTable->Iter(); !i.Done(); i.Next()) {
-    auto entry = static_cast<AtomTableEntry*>(i.Get());
-    if (entry->mAtom->IsStaticAtom()) {
-      continue;
-    }
+  for (uint32_t shardIndex = 0; shardIndex < ATOM_TABLE_SHARD_COUNT;
+       shardIndex++) {
+    AtomTableShard& shard = gAtomTableShards[shardIndex];
+    MutexAutoLock lock(shard.mLock);
+    for (auto i = shard.mTable.Iter(); !i.Done(); i.Next()) {
+      auto entry = static_cast<AtomTableEntry*>(i.Get());
+      if (entry->mAtom->IsStaticAtom()) {
+        continue;
+      }
 
-    nsAtom* atom = entry->mAtom;
-    if (atom->mRefCnt == 0) {
-      i.Remove();
-      delete atom;
-      ++removedCount;
-    }
+      nsAtom* atom = entry->mAtom;
+      if (atom->mRefCnt == 0) {
+        i.Remove();
+        delete atom;
+        ++removedCount;
+      }
 #ifdef NS_FREE_PERMANENT_DATA
-    else if (aKind == GCKind::Shutdown && PR_GetEnv("XPCOM_MEM_BLOAT_LOG")) {
-      // Only report leaking atoms in leak-checking builds in a run
-      // where we are checking for leaks, during shutdown. If
-      // something is anomalous, then we'll assert later in this
-      // function.
-      nsAutoCString name;
-      atom->ToUTF8String(name);
-      if (nonZeroRefcountAtomsCount == 0) {
-        nonZeroRefcountAtoms = name;
-      } else if (nonZeroRefcountAtomsCount < 20) {
-        nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",") + name;
-      } else if (nonZeroRefcountAtomsCount == 20) {
-        nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",...");
+      else if (aKind == GCKind::Shutdown && PR_GetEnv("XPCOM_MEM_BLOAT_LOG")) {
+        // Only report leaking atoms in leak-checking builds in a run
+        // where we are checking for leaks, during shutdown. If
+        // something is anomalous, then we'll assert later in this
+        // function.
+        nsAutoCString name;
+        atom->ToUTF8String(name);
+        if (nonZeroRefcountAtomsCount == 0) {
+          nonZeroRefcountAtoms = name;
+        } else if (nonZeroRefcountAtomsCount < 20) {
+          nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",") + name;
+        } else if (nonZeroRefcountAtomsCount == 20) {
+          nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",...");
+        }
+        nonZeroRefcountAtomsCount++;
       }
-      nonZeroRefcountAtomsCount++;
-    }
 #endif
 
+    }
   }
   if (nonZeroRefcountAtomsCount) {
     nsPrintfCString msg("%d dynamic atom(s) with non-zero refcount: %s",
@@ -427,8 +443,7 @@ static void
 GCAtomTable()
 {
   if (NS_IsMainThread()) {
-    MutexAutoLock lock(*gAtomTableLock);
-    nsAtomFriend::GCAtomTableLocked(lock, GCKind::RegularOperation);
+    nsAtomFriend::GCAtomTable(GCKind::RegularOperation);
   }
 }
 
@@ -536,13 +551,35 @@ static bool gStaticAtomTableSealed = false;
 // shrinking.
 #define ATOM_HASHTABLE_INITIAL_LENGTH  4096
 
+class AtomTableShard
+{
+public:
+  AtomTableShard()
+    : mTable(&AtomTableOps, sizeof(AtomTableEntry),
+             ATOM_HASHTABLE_INITIAL_LENGTH / ATOM_TABLE_SHARD_COUNT)
+    , mLock("Atom Table Shard Lock")
+  {
+  }
+
+  PLDHashTable mTable;
+  Mutex mLock;
+};
+
+// The shard index is taken from the top bits of the hash; PLDHashTable
+// itself consumes the (scrambled) low bits for bucket selection.
+static inline AtomTableShard&
+ShardForHash(uint32_t aHash)
+{
+  return gAtomTableShards[(aHash >> 28) & (ATOM_TABLE_SHARD_COUNT - 1)];
+}
+
 void
 NS_InitAtomTable()
 {
-  MOZ_ASSERT(!gAtomTable);
-  gAtomTable = new PLDHashTable(&AtomTableOps, sizeof(AtomTableEntry),
-                                ATOM_HASHTABLE_INITIAL_LENGTH);
-  gAtomTableLock = new Mutex("Atom Table Lock");
+  MOZ_ASSERT(!gAtomTableShards);
+  static_assert((ATOM_TABLE_SHARD_COUNT & (ATOM_TABLE_SHARD_COUNT - 1)) == 0,
+                "ATOM_TABLE_SHARD_COUNT must be a power of two");
+  gAtomTableShards = new AtomTableShard[ATOM_TABLE_SHARD_COUNT];
 
   // Bug 1340710 has caused us to generate an empty atom at arbitrary times
   // after startup.  If we end up creating one before nsGkAtoms::_empty is
@@ -571,27 +608,27 @@ NS_ShutdownAtomTable()
 #ifdef NS_FREE_PERMANENT_DATA
   // Do a final GC to satisfy leak checking. We skip this step in release
   // builds.
-  {
-    MutexAutoLock lock(*gAtomTableLock);
-    nsAtomFriend::GCAtomTableLocked(lock, GCKind::Shutdown);
-  }
+  nsAtomFriend::GCAtomTable(GCKind::Shutdown);
 #endif
 
-  delete gAtomTable;
-  gAtomTable = nullptr;
-  delete gAtomTableLock;
-  gAtomTableLock = nullptr;
+  delete[] gAtomTableShards;
+  gAtomTableShards = nullptr;
 }
 
 void
 NS_SizeOfAtomTablesIncludingThis(MallocSizeOf aMallocSizeOf,
                                  size_t* aMain, size_t* aStatic)
 {
-  MutexAutoLock lock(*gAtomTableLock);
-  *aMain = gAtomTable->ShallowSizeOfIncludingThis(aMallocSizeOf);
-  for (auto iter = gAtomTable->Iter(); !iter.Done(); iter.Next()) {
-    auto entry = static_cast<AtomTableEntry*>(iter.Get());
-    *aMain += entry->mAtom->SizeOfIncludingThis(aMallocSizeOf);
+  *aMain = 0;
+  for (uint32_t shardIndex = 0; shardIndex < ATOM_TABLE_SHARD_COUNT;
+       shardIndex++) {
+    AtomTableShard& shard = gAtomTableShards[shardIndex];
+    MutexAutoLock lock(shard.mLock);
+    *aMain += shard.mTable.ShallowSizeOfIncludingThis(aMallocSizeOf);
+    for (auto iter = shard.mTable.Iter(); !iter.Done(); iter.Next()) {
+      auto entry = static_cast<AtomTableEntry*>(iter.Get());
+      *aMain += entry->mAtom->SizeOfIncludingThis(aMallocSizeOf);
+    }
   }
 
   // The atoms pointed to by gStaticAtomTable are also pointed to by gAtomTable,
@@ -601,29 +638,15 @@ NS_SizeOfAtomTablesIncludingThis(MallocSizeOf aMallocSizeOf,
            : 0;
 }
 
-static inline AtomTableEntry*
-GetAtomHashEntry(const char* aString, uint32_t aLength, uint32_t* aHashOut)
-{
-  gAtomTableLock->AssertCurrentThreadOwns();
-  AtomTableKey key(aString, aLength, aHashOut);
-  // This is an infallible add.
-  return static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
-}
-
-static inline AtomTableEntry*
-GetAtomHashEntry(const char16_t* aString, uint32_t aLength, uint32_t* aHashOut)
-{
-  gAtomTableLock->AssertCurrentThreadOwns();
-  AtomTableKey key(aString, aLength, aHashOut);
-  // This is an infallible add.
-  return static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
-}
+// Guards gStaticAtomTable during registration; the shard locks only cover
+// the shared atom table itself.
+static StaticMutex gStaticAtomTableLock;
 
 void
 nsAtomFriend::RegisterStaticAtoms(const nsStaticAtom* aAtoms,
                                   uint32_t aAtomCount)
 {
-  MutexAutoLock lock(*gAtomTableLock);
+  StaticMutexAutoLock staticLock(gStaticAtomTableLock);
 
   MOZ_RELEASE_ASSERT(!gStaticAtomTableSealed,
                      "Atom table has already been sealed!");
@@ -641,25 +664,33 @@ nsAtomFriend::RegisterStaticAtoms(const nsStaticAtom* aAtoms,
     uint32_t stringLen = stringBuffer->StorageSize() / sizeof(char16_t) - 1;
 
     uint32_t hash;
-    AtomTableEntry* he =
-      GetAtomHashEntry(static_cast<char16_t*>(stringBuffer->Data()),
-                       stringLen, &hash);
-
-    nsAtom* atom = he->mAtom;
-    if (atom) {
-      // Disallow creating a dynamic atom, and then later, while the
-      // dynamic atom is still alive, registering that same atom as a
-      // static atom.  It causes subtle bugs, and we're programming in
-      // C++ here, not Smalltalk.
-      if (!atom->IsStaticAtom()) {
-        nsAutoCString name;
-        atom->ToUTF8String(name);
-        MOZ_CRASH_UNSAFE_PRINTF(
-          "Static atom registration for %s should be pushed back", name.get());
+    AtomTableKey key(static_cast<char16_t*>(stringBuffer->Data()),
+                     stringLen, &hash);
+
+    nsAtom* atom;
+    {
+      AtomTableShard& shard = ShardForHash(hash);
+      MutexAutoLock lock(shard.mLock);
+      // This is an infallible add.
+      auto he = static_cast<AtomTableEntry*>(shard.mTable.Add(&key));
+
+      atom = he->mAtom;
+      if (atom) {
+        // Disallow creating a dynamic atom, and then later, while the
+        // dynamic atom is still alive, registering that same atom as a
+        // static atom.  It causes subtle bugs, and we're programming in
+        // C++ here, not Smalltalk.
+        if (!atom->IsStaticAtom()) {
+          nsAutoCString name;
+          atom->ToUTF8String(name);
+          MOZ_CRASH_UNSAFE_PRINTF(
+            "Static atom registration for %s should be pushed back",
+            name.get());
+        }
+      } else {
+        atom = new nsAtom(stringBuffer, stringLen, hash);
+        he->mAtom = atom;
       }
-    } else {
-      atom = new nsAtom(stringBuffer, stringLen, hash);
-      he->mAtom = atom;
     }
     *atomp = atom;
 
@@ -687,11 +718,12 @@ NS_Atomize(const char* aUTF8String)
 already_AddRefed<nsAtom>
 nsAtomFriend::Atomize(const nsACString& aUTF8String)
 {
-  MutexAutoLock lock(*gAtomTableLock);
   uint32_t hash;
-  AtomTableEntry* he = GetAtomHashEntry(aUTF8String.Data(),
-                                        aUTF8String.Length(),
-                                        &hash);
+  AtomTableKey key(aUTF8String.Data(), aUTF8String.Length(), &hash);
+  AtomTableShard& shard = ShardForHash(hash);
+  MutexAutoLock lock(shard.mLock);
+  // This is an infallible add.
+  auto he = static_cast<AtomTableEntry*>(shard.mTable.Add(&key));
 
   if (he->mAtom) {
     RefPtr<nsAtom> atom = he->mAtom;
@@ -727,11 +759,12 @@ NS_Atomize(const char16_t* aUTF16String)
 already_AddRefed<nsAtom>
 nsAtomFriend::Atomize(const nsAString& aUTF16String)
 {
-  MutexAutoLock lock(*gAtomTableLock);
   uint32_t hash;
-  AtomTableEntry* he = GetAtomHashEntry(aUTF16String.Data(),
-                                        aUTF16String.Length(),
-                                        &hash);
+  AtomTableKey key(aUTF16String.Data(), aUTF16String.Length(), &hash);
+  AtomTableShard& shard = ShardForHash(hash);
+  MutexAutoLock lock(shard.mLock);
+  // This is an infallible add.
+  auto he = static_cast<AtomTableEntry*>(shard.mTable.Add(&key));
 
   if (he->mAtom) {
     RefPtr<nsAtom> atom = he->mAtom;
@@ -771,8 +804,9 @@ nsAtomFriend::AtomizeMainThread(const nsAString& aUTF16String)
     }
   }
 
-  MutexAutoLock lock(*gAtomTableLock);
-  AtomTableEntry* he = static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
+  AtomTableShard& shard = ShardForHash(hash);
+  MutexAutoLock lock(shard.mLock);
+  AtomTableEntry* he = static_cast<AtomTableEntry*>(shard.mTable.Add(&key));
 
   if (he->mAtom) {
     retVal = he->mAtom;
@@ -797,8 +831,14 @@ nsrefcnt
 NS_GetNumberOfAtoms(void)
 {
   GCAtomTable(); // Trigger a GC so we return a deterministic result.
-  MutexAutoLock lock(*gAtomTableLock);
-  return gAtomTable->EntryCount();
+  nsrefcnt count = 0;
+  for (uint32_t shardIndex = 0; shardIndex < ATOM_TABLE_SHARD_COUNT;
+       shardIndex++) {
+    AtomTableShard& shard = gAtomTableShards[shardIndex];
+    MutexAutoLock lock(shard.mLock);
+    count += shard.mTable.EntryCount();
+  }
+  return count;
 }
 
 int32_t
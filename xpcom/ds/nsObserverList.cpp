@@ -22,6 +22,7 @@ nsObserverList::AddObserver(nsIObserver* anObserver, bool ownsWeak)
       return NS_ERROR_OUT_OF_MEMORY;
     }
 
+    mSnapshot = nullptr;
     return NS_OK;
   }
 
@@ -35,6 +36,7 @@ nsObserverList::AddObserver(nsIObserver* anObserver, bool ownsWeak)
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
+  mSnapshot = nullptr;
   return NS_OK;
 }
 
@@ -44,6 +46,7 @@ nsObserverList::RemoveObserver(nsIObserver* anObserver)
   NS_ASSERTION(anObserver, "Null input");
 
   if (mObservers.RemoveElement(static_cast<nsISupports*>(anObserver))) {
+    mSnapshot = nullptr;
     return NS_OK;
   }
 
@@ -56,6 +59,7 @@ nsObserverList::RemoveObserver(nsIObserver* anObserver)
     return NS_ERROR_FAILURE;
   }
 
+  mSnapshot = nullptr;
   return NS_OK;
 }
 
@@ -81,6 +85,7 @@ nsObserverList::FillObserverArray(nsCOMArray<nsIObserver>& aArray)
       } else {
         // the object has gone away, remove the weakref
         mObservers.RemoveElement(observers[i].asWeak());
+        mSnapshot = nullptr;
       }
     } else {
       aArray.AppendObject(observers[i].asObserver());
@@ -100,16 +105,43 @@ nsObserverList::AppendStrongObservers(nsCOMArray<nsIObserver>& aArray)
   }
 }
 
+already_AddRefed<nsObserverSnapshot>
+nsObserverList::Snapshot()
+{
+  if (!mSnapshot) {
+    mSnapshot = new nsObserverSnapshot();
+    mSnapshot->mRefs = mObservers;
+  }
+
+  RefPtr<nsObserverSnapshot> snapshot = mSnapshot;
+  return snapshot.forget();
+}
+
 void
 nsObserverList::NotifyObservers(nsISupports* aSubject,
                                 const char* aTopic,
                                 const char16_t* someData)
 {
-  nsCOMArray<nsIObserver> observers;
-  FillObserverArray(observers);
-
-  for (int32_t i = 0; i < observers.Count(); ++i) {
-    observers[i]->Observe(aSubject, aTopic, someData);
+  // Iterate the shared snapshot rather than copying the list.  The local
+  // ref keeps the snapshot alive even if an Observe() callback mutates
+  // this list (which replaces mSnapshot rather than touching our copy).
+  RefPtr<nsObserverSnapshot> snapshot = Snapshot();
+
+  // Observers are notified in last-added-first order.
+  for (int32_t i = snapshot->mRefs.Length() - 1; i >= 0; --i) {
+    ObserverRef& o = snapshot->mRefs[i];
+    if (o.isWeakRef) {
+      nsCOMPtr<nsIObserver> observer(do_QueryReferent(o.asWeak()));
+      if (!observer) {
+        // The object has gone away; drop the weakref from the live list.
+        mObservers.RemoveElement(o.asWeak());
+        mSnapshot = nullptr;
+        continue;
+      }
+      observer->Observe(aSubject, aTopic, someData);
+    } else {
+      o.asObserver()->Observe(aSubject, aTopic, someData);
+    }
   }
 }
 
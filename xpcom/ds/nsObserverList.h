@@ -41,6 +41,27 @@ struct ObserverRef
   bool operator==(nsISupports* aRhs) const { return ref == aRhs; }
 };
 
+/**
+ * A refcounted, immutable copy of an observer list at a point in time.
+ *
+ * NotifyObservers() iterates one of these instead of copying the live list
+ * for every notification: the snapshot is built lazily, shared across
+ * successive notifications of the same topic, and replaced (not mutated)
+ * when an observer is added or removed.  A notification in progress keeps
+ * its snapshot alive, so observers registered or unregistered from within
+ * Observe() callbacks never affect the iteration underway.
+ */
+class nsObserverSnapshot final
+{
+public:
+  NS_INLINE_DECL_REFCOUNTING(nsObserverSnapshot)
+
+  nsTArray<ObserverRef> mRefs;
+
+private:
+  ~nsObserverSnapshot() {}
+};
+
 class nsObserverList : public nsCharPtrHashKey
 {
   friend class nsObserverService;
@@ -72,7 +93,14 @@ public:
   void AppendStrongObservers(nsCOMArray<nsIObserver>& aArray);
 
 private:
+  // Returns the cached snapshot of mObservers, building it if necessary.
+  already_AddRefed<nsObserverSnapshot> Snapshot();
+
   nsTArray<ObserverRef> mObservers;
+
+  // Cached snapshot shared by notifications; null when mObservers has
+  // changed since the last notification.
+  RefPtr<nsObserverSnapshot> mSnapshot;
 };
 
 class nsObserverEnumerator final : public nsISimpleEnumerator
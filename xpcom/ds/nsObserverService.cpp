@@ -165,6 +165,7 @@ nsObserverService::Shutdown()
   mShuttingDown = true;
 
   mObserverTopicTable.Clear();
+  mPendingCoalesced.Clear();
 }
 
 nsresult
@@ -313,6 +314,69 @@ NS_IMETHODIMP nsObserverService::NotifyObservers(nsISupports* aSubject,
   return NS_OK;
 }
 
+nsresult
+nsObserverService::NotifyObserversCoalesced(nsISupports* aSubject,
+                                            const char* aTopic,
+                                            const char16_t* aSomeData)
+{
+  LOG(("nsObserverService::NotifyObserversCoalesced(%s)", aTopic));
+
+  NS_ENSURE_VALIDCALL
+  if (NS_WARN_IF(!aTopic)) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  nsDependentCString topic(aTopic);
+  if (PendingNotification* pending = mPendingCoalesced.Get(topic)) {
+    // A notification for this topic is already queued; let it absorb this
+    // one, keeping the most recent subject and data.
+    pending->mSubject = aSubject;
+    pending->mHasData = !!aSomeData;
+    if (aSomeData) {
+      pending->mData = aSomeData;
+    }
+    return NS_OK;
+  }
+
+  PendingNotification* pending = mPendingCoalesced.LookupOrAdd(topic);
+  pending->mSubject = aSubject;
+  pending->mHasData = !!aSomeData;
+  if (aSomeData) {
+    pending->mData = aSomeData;
+  }
+
+  return NS_DispatchToCurrentThread(NewRunnableMethod<nsCString>(
+    "nsObserverService::FireCoalescedNotification",
+    this,
+    &nsObserverService::FireCoalescedNotification,
+    topic));
+}
+
+void
+nsObserverService::FireCoalescedNotification(const nsCString& aTopic)
+{
+  if (mShuttingDown) {
+    return;
+  }
+
+  PendingNotification* pending = mPendingCoalesced.Get(aTopic);
+  if (!pending) {
+    return;
+  }
+
+  nsCOMPtr<nsISupports> subject = pending->mSubject.forget();
+  nsString data;
+  bool hasData = pending->mHasData;
+  if (hasData) {
+    data = pending->mData;
+  }
+  // Remove the entry before notifying so that a notification fired from
+  // within an Observe() callback queues a fresh one.
+  mPendingCoalesced.Remove(aTopic);
+
+  NotifyObservers(subject, aTopic.get(), hasData ? data.get() : nullptr);
+}
+
 NS_IMETHODIMP
 nsObserverService::UnmarkGrayStrongObservers()
 {
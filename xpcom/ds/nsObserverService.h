@@ -11,6 +11,9 @@
 #include "nsObserverList.h"
 #include "nsIMemoryReporter.h"
 #include "nsTHashtable.h"
+#include "nsClassHashtable.h"
+#include "nsHashKeys.h"
+#include "nsString.h"
 #include "mozilla/Attributes.h"
 
 // {D07F5195-E3D1-11d2-8ACD-00105A1B8860}
@@ -41,13 +44,35 @@ public:
   // collector will not traverse them.
   NS_IMETHOD UnmarkGrayStrongObservers();
 
+  // Like NotifyObservers(), but coalesces rapid-fire notifications: if a
+  // notification for aTopic is already queued and has not fired yet, the
+  // queued one absorbs this call (keeping the most recent subject and
+  // data) instead of notifying observers again.  The notification is
+  // delivered asynchronously from the main thread's event loop.  Use this
+  // for "quiet" topics such as cacheservice:empty-cache where observers
+  // only care about the fact that something happened, not how many times.
+  MOZ_MUST_USE nsresult NotifyObserversCoalesced(nsISupports* aSubject,
+                                                 const char* aTopic,
+                                                 const char16_t* aSomeData);
+
 private:
   ~nsObserverService(void);
   void RegisterReporter();
+  void FireCoalescedNotification(const nsCString& aTopic);
+
+  // The subject and data of a queued coalesced notification, keyed by
+  // topic in mPendingCoalesced.
+  struct PendingNotification
+  {
+    nsCOMPtr<nsISupports> mSubject;
+    nsString mData;
+    bool mHasData = false;
+  };
 
   static const size_t kSuspectReferentCount = 100;
   bool mShuttingDown;
   nsTHashtable<nsObserverList> mObserverTopicTable;
+  nsClassHashtable<nsCStringHashKey, PendingNotification> mPendingCoalesced;
 };
 
 NS_DEFINE_STATIC_IID_ACCESSOR(nsObserverService, NS_OBSERVERSERVICE_CID)
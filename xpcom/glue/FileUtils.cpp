@@ -6,6 +6,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "nscore.h"
 #include "private/pprio.h"
@@ -37,7 +38,9 @@
 // within this #if block
 #if defined(MOZILLA_INTERNAL_API)
 
+#include "nsCOMPtr.h"
 #include "nsString.h"
+#include "nsTArray.h"
 
 bool
 mozilla::fallocate(PRFileDesc* aFD, int64_t aLength)
@@ -161,6 +164,101 @@ mozilla::ReadAheadFile(nsIFile* aFile, const size_t aOffset,
 #endif
 }
 
+nsresult
+mozilla::StatChildrenBatch(nsIFile* aDirectory,
+                           const nsTArray<nsCString>& aNativeNames,
+                           nsTArray<ChildFileAttributes>& aAttrsOut)
+{
+  if (!aDirectory) {
+    return NS_ERROR_INVALID_ARG;
+  }
+
+  aAttrsOut.ClearAndRetainStorage();
+  if (!aAttrsOut.SetLength(aNativeNames.Length(), fallible)) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  memset(aAttrsOut.Elements(), 0,
+         aAttrsOut.Length() * sizeof(ChildFileAttributes));
+
+#if defined(XP_UNIX)
+  nsAutoCString dirPath;
+  nsresult rv = aDirectory->GetNativePath(dirPath);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  int flags = O_RDONLY;
+#if defined(O_DIRECTORY)
+  flags |= O_DIRECTORY;
+#endif
+  ScopedClose dirfd(MOZ_TEMP_FAILURE_RETRY(open(dirPath.get(), flags)));
+  if (dirfd < 0) {
+    return errno == ENOENT ? NS_ERROR_FILE_NOT_FOUND : NS_ERROR_FAILURE;
+  }
+
+  for (size_t i = 0; i < aNativeNames.Length(); ++i) {
+    ChildFileAttributes& attrs = aAttrsOut[i];
+
+    // Resolve each child relative to the already opened directory.  This
+    // spares the kernel a full path walk per child, which is where the
+    // time goes on network file systems.
+    struct stat buf;
+    if (MOZ_TEMP_FAILURE_RETRY(
+          fstatat(dirfd, aNativeNames[i].get(), &buf, 0)) != 0) {
+      // A child that cannot be examined is reported as absent, matching
+      // what nsIFile::Exists() would have said.
+      continue;
+    }
+
+    attrs.mExists = true;
+    attrs.mIsDirectory = S_ISDIR(buf.st_mode);
+    attrs.mFileSize = int64_t(buf.st_size);
+    attrs.mLastModifiedTime = PRTime(buf.st_mtime) * PR_MSEC_PER_SEC;
+
+    // fstatat() above follows symlinks the way nsIFile::IsDirectory()
+    // does, so a second, non-following query is needed for the symlink
+    // bit itself.
+    struct stat linkBuf;
+    attrs.mIsSymlink =
+      MOZ_TEMP_FAILURE_RETRY(
+        fstatat(dirfd, aNativeNames[i].get(), &linkBuf,
+                AT_SYMLINK_NOFOLLOW)) == 0 &&
+      S_ISLNK(linkBuf.st_mode);
+  }
+
+  return NS_OK;
+#else
+  // No batched equivalent on this platform; fall back to per-child
+  // nsIFile calls.
+  for (size_t i = 0; i < aNativeNames.Length(); ++i) {
+    ChildFileAttributes& attrs = aAttrsOut[i];
+
+    nsCOMPtr<nsIFile> child;
+    nsresult rv = aDirectory->Clone(getter_AddRefs(child));
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+    rv = child->AppendNative(aNativeNames[i]);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
+    bool exists = false;
+    if (NS_FAILED(child->Exists(&exists)) || !exists) {
+      continue;
+    }
+
+    attrs.mExists = true;
+    child->IsDirectory(&attrs.mIsDirectory);
+    child->IsSymlink(&attrs.mIsSymlink);
+    child->GetFileSize(&attrs.mFileSize);
+    child->GetLastModifiedTime(&attrs.mLastModifiedTime);
+  }
+
+  return NS_OK;
+#endif
+}
+
 #endif // !defined(XPCOM_GLUE)
 
 #if defined(LINUX) && !defined(ANDROID)
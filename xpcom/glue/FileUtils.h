@@ -52,6 +52,10 @@ typedef Scoped<ScopedCloseFDTraits> ScopedClose;
 
 #if defined(MOZILLA_INTERNAL_API)
 
+#include "nsStringFwd.h"
+#include "nsTArrayForwardDeclare.h"
+#include "prtime.h"
+
 /**
  * AutoFDClose is a RAII wrapper for PRFileDesc.
  *
@@ -119,6 +123,36 @@ void ReadAheadFile(nsIFile* aFile, const size_t aOffset = 0,
                    const size_t aCount = SIZE_MAX,
                    filedesc_t* aOutFd = nullptr);
 
+/**
+ * Packed per-child result of StatChildrenBatch().  For children that do
+ * not exist, mExists is false and the remaining fields are zeroed.
+ */
+struct ChildFileAttributes
+{
+  bool mExists;
+  bool mIsDirectory;
+  bool mIsSymlink;
+  int64_t mFileSize;
+  PRTime mLastModifiedTime;  // Milliseconds since the epoch, like nsIFile.
+};
+
+/**
+ * Query file attributes for a set of children of a directory in a single
+ * pass.  On POSIX platforms the directory is opened once and each child is
+ * examined with fstatat(), so the kernel resolves the directory path one
+ * time in total instead of once per child per attribute the way repeated
+ * nsIFile Exists()/IsDirectory()/GetLastModifiedTime() calls do.  Other
+ * platforms fall back to per-child nsIFile calls.  Intended for startup
+ * directory scans that examine many siblings at once.
+ *
+ * @param aDirectory the directory containing the children.
+ * @param aNativeNames leaf names of the children, in the native charset.
+ * @param aAttrsOut receives one entry per name, in the same order.
+ */
+nsresult StatChildrenBatch(nsIFile* aDirectory,
+                           const nsTArray<nsCString>& aNativeNames,
+                           nsTArray<ChildFileAttributes>& aAttrsOut);
+
 #endif // MOZILLA_INTERNAL_API
 
 /**
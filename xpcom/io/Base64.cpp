@@ -6,6 +6,7 @@
 
 #include "Base64.h"
 
+#include "Base64Impl.h"
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/UniquePtrExtensions.h"
@@ -78,6 +79,20 @@ template<typename SrcT, typename DestT>
 static void
 Encode(const SrcT* aSrc, uint32_t aSrcLen, DestT* aDest)
 {
+#ifdef MOZILLA_MAY_SUPPORT_SSSE3
+  // The vector kernel only understands byte-sized characters.
+  if (sizeof(SrcT) == 1 && sizeof(DestT) == 1 && aSrcLen >= 16 &&
+      mozilla::supports_ssse3()) {
+    uint32_t consumed =
+      mozilla::SSSE3::Base64Encode(reinterpret_cast<const uint8_t*>(aSrc),
+                                   aSrcLen,
+                                   reinterpret_cast<char*>(aDest));
+    aSrc += consumed;
+    aDest += (consumed / 3) * 4;
+    aSrcLen -= consumed;
+  }
+#endif
+
   while (aSrcLen >= 3) {
     Encode3to4(aSrc, aDest);
     aSrc += 3;
@@ -479,6 +494,23 @@ Base64DecodeHelper(const SrcT* aBase64, uint32_t aBase64Len, DestT* aBinary,
     }
   }
 
+#ifdef MOZILLA_MAY_SUPPORT_SSSE3
+  // The vector kernel only understands byte-sized characters.  It stops
+  // before any block containing a character outside the alphabet, which
+  // the scalar loop below then rejects.
+  if (sizeof(SrcT) == 1 && sizeof(DestT) == 1 &&
+      mozilla::supports_ssse3()) {
+    uint32_t consumed =
+      mozilla::SSSE3::Base64Decode(reinterpret_cast<const char*>(input),
+                                   inputLength,
+                                   reinterpret_cast<uint8_t*>(binary));
+    input += consumed;
+    inputLength -= consumed;
+    binary += (consumed / 4) * 3;
+    binaryLength += (consumed / 4) * 3;
+  }
+#endif
+
   while (inputLength >= 4) {
     if (!Decode4to3(input, binary, Base64CharToValue<SrcT>)) {
       return NS_ERROR_INVALID_ARG;
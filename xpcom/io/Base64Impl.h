@@ -0,0 +1,47 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_Base64Impl_h__
+#define mozilla_Base64Impl_h__
+
+#include <stdint.h>
+
+#include "mozilla/SSE.h"
+
+namespace mozilla {
+
+#ifdef MOZILLA_MAY_SUPPORT_SSSE3
+namespace SSSE3 {
+
+/**
+ * Encodes as many whole input triplets as the vector kernel can handle
+ * into the standard Base64 alphabet, writing four characters per triplet
+ * to aDest.  Returns the number of input bytes consumed (a multiple of 3,
+ * possibly 0); the caller encodes the remainder with the scalar code.
+ */
+uint32_t Base64Encode(const uint8_t* aSrc, uint32_t aSrcLen, char* aDest);
+
+/**
+ * Decodes as many whole 4-character quanta as the vector kernel can
+ * handle, writing three bytes per quantum to aDest.  Stops at the first
+ * 16-character block containing a character outside the standard Base64
+ * alphabet, leaving rejection to the scalar code.  Returns the number of
+ * input characters consumed (a multiple of 4, possibly 0).
+ *
+ * The kernel stores 16 bytes per 12 decoded, so the caller must have at
+ * least 4 bytes of slack in aDest beyond the decoded output; this holds
+ * for buffers sized at 3/4 of the (un-trimmed) input length as long as at
+ * least 8 input characters are left to the scalar loop, which the kernel
+ * guarantees.
+ */
+uint32_t Base64Decode(const char* aSrc, uint32_t aSrcLen, uint8_t* aDest);
+
+} // namespace SSSE3
+#endif
+
+} // namespace mozilla
+
+#endif // mozilla_Base64Impl_h__
@@ -0,0 +1,146 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <tmmintrin.h>
+
+#include "Base64Impl.h"
+
+// Vectorized Base64 kernels using the pshufb-based technique described by
+// Muła and Lemire in "Faster Base64 Encoding and Decoding Using AVX2
+// Instructions".  Each encode iteration turns 12 input bytes into 16
+// output characters; each decode iteration turns 16 characters into 12
+// bytes.  Everything the kernels can't handle (tails, padding, invalid
+// input) is left to the scalar code in Base64.cpp.
+
+namespace mozilla {
+namespace SSSE3 {
+
+uint32_t
+Base64Encode(const uint8_t* aSrc, uint32_t aSrcLen, char* aDest)
+{
+  // Duplicates bytes so that each 32-bit lane holds one input triplet in
+  // the order the bit twiddling below expects.
+  const __m128i shuf = _mm_setr_epi8(1, 0, 2, 1,
+                                     4, 3, 5, 4,
+                                     7, 6, 8, 7,
+                                     10, 9, 11, 10);
+
+  // Translation from a 6-bit index to an offset that, added to the index,
+  // yields the alphabet character.  The index below is 13 for [A-Z], 0 for
+  // [a-z], 1..10 for [0-9], 11 for '+' and 12 for '/'.
+  const __m128i shiftLut = _mm_setr_epi8('a' - 26,
+                                         '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52,
+                                         '+' - 62, '/' - 63,
+                                         'A', 0, 0);
+
+  uint32_t consumed = 0;
+
+  // Each iteration loads 16 bytes but consumes only 12, so stop while a
+  // full vector load stays inside the input.
+  while (aSrcLen - consumed >= 16) {
+    __m128i in =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + consumed));
+    in = _mm_shuffle_epi8(in, shuf);
+
+    // Isolate the four 6-bit fields of each triplet into separate bytes.
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // Reduce each 6-bit value to one of the 14 shiftLut indices described
+    // above, then add the looked-up offset to get the output character.
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shiftLut, result);
+    result = _mm_add_epi8(result, indices);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest), result);
+
+    aDest += 16;
+    consumed += 12;
+  }
+
+  return consumed;
+}
+
+uint32_t
+Base64Decode(const char* aSrc, uint32_t aSrcLen, uint8_t* aDest)
+{
+  // lutLo/lutHi classify each character by its low and high nibble; a
+  // nonzero AND of the two lookups flags a character outside the
+  // alphabet.  lutRoll maps the high nibble (with '/' special-cased) to
+  // the offset from character code to 6-bit value.
+  const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11,
+                                      0x11, 0x11, 0x11, 0x11,
+                                      0x11, 0x11, 0x13, 0x1A,
+                                      0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02,
+                                      0x04, 0x08, 0x04, 0x08,
+                                      0x10, 0x10, 0x10, 0x10,
+                                      0x10, 0x10, 0x10, 0x10);
+  const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4,
+                                        -65, -65, -71, -71,
+                                        0, 0, 0, 0,
+                                        0, 0, 0, 0);
+  const __m128i mask2F = _mm_set1_epi8(0x2f);
+
+  uint32_t consumed = 0;
+
+  // Each iteration consumes 16 characters and stores 16 bytes of which
+  // only 12 are meaningful.  Stopping while at least 24 characters remain
+  // leaves >= 8 characters (>= 6 output bytes) to the scalar loop, which
+  // keeps the 4 scratch bytes of the final store inside the output
+  // buffer.
+  while (aSrcLen - consumed >= 24) {
+    const __m128i in =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + consumed));
+
+    const __m128i hiNibbles =
+      _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    const __m128i loNibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+    const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+    const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi),
+                                         _mm_setzero_si128()))) {
+      // Some character in this block isn't in the alphabet (this includes
+      // '=' padding); let the scalar loop deal with it.
+      break;
+    }
+
+    const __m128i eq2F = _mm_cmpeq_epi8(in, mask2F);
+    const __m128i roll =
+      _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+    const __m128i values = _mm_add_epi8(in, roll);
+
+    // Pack the 16 6-bit values down to 12 contiguous bytes.
+    const __m128i mergedAbBc =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i packed =
+      _mm_madd_epi16(mergedAbBc, _mm_set1_epi32(0x00011000));
+    const __m128i out =
+      _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6,
+                                             5, 4, 10, 9,
+                                             8, 14, 13, 12,
+                                             -1, -1, -1, -1));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest), out);
+
+    aDest += 12;
+    consumed += 16;
+  }
+
+  return consumed;
+}
+
+} // namespace SSSE3
+} // namespace mozilla
@@ -0,0 +1,263 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/BrotliCompressOutputStream.h"
+
+#include <algorithm>
+#include "brotli/encode.h"
+#include "nsStreamUtils.h"
+
+namespace mozilla {
+
+NS_IMPL_ISUPPORTS(BrotliCompressOutputStream, nsIOutputStream);
+
+// static
+const size_t
+BrotliCompressOutputStream::kMaxBlockSize = 64 * 1024;
+
+// static
+const uint32_t
+BrotliCompressOutputStream::kDefaultQuality = 5;
+
+BrotliCompressOutputStream::BrotliCompressOutputStream(nsIOutputStream* aBaseStream,
+                                                       uint32_t aQuality,
+                                                       size_t aBlockSize)
+  : mBaseStream(aBaseStream)
+  , mQuality(std::max(std::min<uint32_t>(aQuality, BROTLI_MAX_QUALITY),
+                      uint32_t(BROTLI_MIN_QUALITY)))
+  , mBlockSize(std::min(aBlockSize, kMaxBlockSize))
+  , mEncoder(nullptr)
+  , mNextByte(0)
+{
+  MOZ_ASSERT(mBlockSize > 0);
+
+  // This implementation only supports sync base streams.  Verify this in debug
+  // builds.  Note, this can be simpler than the check in
+  // BrotliUncompressInputStream because we don't have to deal with the
+  // nsStringInputStream oddness of being non-blocking and sync.
+#ifdef DEBUG
+  bool baseNonBlocking;
+  nsresult rv = mBaseStream->IsNonBlocking(&baseNonBlocking);
+  MOZ_ASSERT(NS_SUCCEEDED(rv));
+  MOZ_ASSERT(!baseNonBlocking);
+#endif
+}
+
+size_t
+BrotliCompressOutputStream::BlockSize() const
+{
+  return mBlockSize;
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::Close()
+{
+  if (!mBaseStream) {
+    return NS_OK;
+  }
+
+  // Finishing the encoder terminates the brotli stream.  Readers use this
+  // to detect that the data is complete, so it must be written out even
+  // if nothing was ever staged in our buffer.
+  nsresult rv = CompressToBaseStream(BROTLI_OPERATION_FINISH);
+  if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+
+  mBaseStream->Close();
+  mBaseStream = nullptr;
+
+  if (mEncoder) {
+    BrotliEncoderDestroyInstance(mEncoder);
+    mEncoder = nullptr;
+  }
+
+  mBuffer = nullptr;
+  mCompressedBuffer = nullptr;
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::Flush()
+{
+  if (!mBaseStream) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  // A brotli flush emits enough output that a reader can decode all of
+  // the data consumed so far, at a small cost in compression ratio.
+  nsresult rv = CompressToBaseStream(BROTLI_OPERATION_FLUSH);
+  if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+
+  mBaseStream->Flush();
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::Write(const char* aBuf, uint32_t aCount,
+                                  uint32_t* aResultOut)
+{
+  return WriteSegments(NS_CopySegmentToBuffer, const_cast<char*>(aBuf), aCount,
+                       aResultOut);
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::WriteFrom(nsIInputStream*, uint32_t, uint32_t*)
+{
+  return NS_ERROR_NOT_IMPLEMENTED;
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::WriteSegments(nsReadSegmentFun aReader,
+                                          void* aClosure,
+                                          uint32_t aCount,
+                                          uint32_t* aBytesWrittenOut)
+{
+  *aBytesWrittenOut = 0;
+
+  if (!mBaseStream) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  if (!mBuffer) {
+    mBuffer.reset(new (fallible) char[mBlockSize]);
+    if (NS_WARN_IF(!mBuffer)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  while (aCount > 0) {
+    // Determine how much space is left in our flat, uncompressed buffer.
+    MOZ_ASSERT(mNextByte <= mBlockSize);
+    uint32_t remaining = mBlockSize - mNextByte;
+
+    // If it is full, then compress and flush the data to the base stream.
+    if (remaining == 0) {
+      nsresult rv = CompressToBaseStream(BROTLI_OPERATION_PROCESS);
+      if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+
+      // Now the entire buffer should be available for copying.
+      MOZ_ASSERT(!mNextByte);
+      remaining = mBlockSize;
+    }
+
+    uint32_t numToRead = std::min(remaining, aCount);
+    uint32_t numRead = 0;
+
+    nsresult rv = aReader(this, aClosure, &mBuffer[mNextByte],
+                          *aBytesWrittenOut, numToRead, &numRead);
+
+    // As defined in nsIOutputStream.idl, do not pass reader func errors.
+    if (NS_FAILED(rv)) {
+      return NS_OK;
+    }
+
+    // End-of-file
+    if (numRead == 0) {
+      return NS_OK;
+    }
+
+    mNextByte += numRead;
+    *aBytesWrittenOut += numRead;
+    aCount -= numRead;
+  }
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliCompressOutputStream::IsNonBlocking(bool* aNonBlockingOut)
+{
+  *aNonBlockingOut = false;
+  return NS_OK;
+}
+
+BrotliCompressOutputStream::~BrotliCompressOutputStream()
+{
+  Close();
+}
+
+nsresult
+BrotliCompressOutputStream::CompressToBaseStream(int aOperation)
+{
+  MOZ_ASSERT(mBaseStream);
+
+  // Lazily create the encoder and the compressed buffer on our first
+  // flush.  This allows us to report OOM during stream operation.  Both
+  // then get re-used until the stream is closed.
+  if (!mEncoder) {
+    mEncoder = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+    if (NS_WARN_IF(!mEncoder)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+    BrotliEncoderSetParameter(mEncoder, BROTLI_PARAM_QUALITY, mQuality);
+    BrotliEncoderSetParameter(mEncoder, BROTLI_PARAM_SIZE_HINT, 0);
+  }
+
+  if (!mCompressedBuffer) {
+    mCompressedBuffer.reset(new (fallible) char[mBlockSize]);
+    if (NS_WARN_IF(!mCompressedBuffer)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  const uint8_t* nextIn = reinterpret_cast<const uint8_t*>(mBuffer.get());
+  size_t availIn = mNextByte;
+
+  // Note, the encoder buffers data internally, so a PROCESS operation may
+  // consume all of the input without producing any output.  FLUSH and
+  // FINISH instead force everything consumed so far out, so the loop must
+  // continue until the encoder reports it has nothing more to emit.
+  do {
+    uint8_t* nextOut = reinterpret_cast<uint8_t*>(mCompressedBuffer.get());
+    size_t availOut = mBlockSize;
+
+    if (!BrotliEncoderCompressStream(mEncoder,
+                                     static_cast<BrotliEncoderOperation>(aOperation),
+                                     &availIn, &nextIn,
+                                     &availOut, &nextOut, nullptr)) {
+      return NS_ERROR_FAILURE;
+    }
+
+    size_t compressedLength = mBlockSize - availOut;
+    if (compressedLength > 0) {
+      uint32_t numWritten = 0;
+      nsresult rv = WriteAll(mCompressedBuffer.get(), compressedLength,
+                             &numWritten);
+      if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+      MOZ_ASSERT(compressedLength == numWritten);
+    }
+  } while (availIn > 0 || BrotliEncoderHasMoreOutput(mEncoder));
+
+  mNextByte = 0;
+
+  return NS_OK;
+}
+
+nsresult
+BrotliCompressOutputStream::WriteAll(const char* aBuf, uint32_t aCount,
+                                     uint32_t* aBytesWrittenOut)
+{
+  *aBytesWrittenOut = 0;
+
+  if (!mBaseStream) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  uint32_t offset = 0;
+  while (aCount > 0) {
+    uint32_t numWritten = 0;
+    nsresult rv = mBaseStream->Write(aBuf + offset, aCount, &numWritten);
+    if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+    offset += numWritten;
+    aCount -= numWritten;
+    *aBytesWrittenOut += numWritten;
+  }
+
+  return NS_OK;
+}
+
+} // namespace mozilla
@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_BrotliCompressOutputStream_h__
+#define mozilla_BrotliCompressOutputStream_h__
+
+#include "mozilla/Attributes.h"
+#include "mozilla/UniquePtr.h"
+#include "nsCOMPtr.h"
+#include "nsIOutputStream.h"
+#include "nsISupportsImpl.h"
+
+typedef struct BrotliEncoderStateStruct BrotliEncoderState;
+
+namespace mozilla {
+
+// An output stream that compresses data written to it with brotli before
+// passing it on to the base stream.  Compared to SnappyCompressOutputStream
+// this trades some CPU for a significantly better compression ratio, and
+// the quality level lets consumers pick the ratio-vs-speed point that fits
+// their content.  The resulting data is a raw brotli stream; it can be
+// consumed with BrotliUncompressInputStream.
+class BrotliCompressOutputStream final : public nsIOutputStream
+{
+public:
+  // Maximum compression block size.
+  static const size_t kMaxBlockSize;
+
+  // The default compression quality.  Brotli supports qualities from 1
+  // (fastest) to 11 (best ratio).  The default is chosen to compress
+  // better than snappy while remaining fast enough for stream use.
+  static const uint32_t kDefaultQuality;
+
+  // Construct a new blocking output stream to compress data to the given
+  // base stream.  The base stream must also be blocking.  The compression
+  // quality may optionally be set to a value between 1 and 11, and the
+  // compression block size to a value up to kMaxBlockSize.
+  explicit BrotliCompressOutputStream(nsIOutputStream* aBaseStream,
+                                      uint32_t aQuality = kDefaultQuality,
+                                      size_t aBlockSize = kMaxBlockSize);
+
+  // The compression block size.  To optimize stream performance
+  // try to write to the stream in segments at least this size.
+  size_t BlockSize() const;
+
+private:
+  virtual ~BrotliCompressOutputStream();
+
+  // Run the encoder over the data currently staged in mBuffer, writing
+  // any compressed output it produces to the base stream.  aOperation is
+  // one of the BROTLI_OPERATION_* values; flushing and finishing force
+  // the encoder to emit output for everything consumed so far.
+  nsresult CompressToBaseStream(int aOperation);
+  nsresult WriteAll(const char* aBuf, uint32_t aCount,
+                    uint32_t* aBytesWrittenOut);
+
+  nsCOMPtr<nsIOutputStream> mBaseStream;
+  const uint32_t mQuality;
+  const size_t mBlockSize;
+
+  // The encoder carries its window between calls, so it exists for the
+  // lifetime of the stream.  Created lazily so that OOM can be reported
+  // during stream operation.
+  BrotliEncoderState* mEncoder;
+
+  // Buffer holding copied uncompressed data.  This must be copied here
+  // so that the compression can be performed on a single flat buffer.
+  mozilla::UniquePtr<char[]> mBuffer;
+
+  // The next byte in the uncompressed data to copy incoming data to.
+  size_t mNextByte;
+
+  // Buffer the encoder emits compressed data into before it gets written
+  // to the base stream.
+  mozilla::UniquePtr<char[]> mCompressedBuffer;
+
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+  NS_DECL_NSIOUTPUTSTREAM
+};
+
+} // namespace mozilla
+
+#endif // mozilla_BrotliCompressOutputStream_h__
@@ -0,0 +1,280 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/BrotliUncompressInputStream.h"
+
+#include <algorithm>
+#include "brotli/decode.h"
+#include "nsIAsyncInputStream.h"
+#include "nsStreamUtils.h"
+
+namespace mozilla {
+
+NS_IMPL_ISUPPORTS(BrotliUncompressInputStream,
+                  nsIInputStream);
+
+// The size of both the compressed input buffer and the uncompressed
+// output buffer.  Matches BrotliCompressOutputStream::kMaxBlockSize, but
+// nothing requires the two to agree.
+static const size_t kBufferLength = 64 * 1024;
+
+BrotliUncompressInputStream::BrotliUncompressInputStream(nsIInputStream* aBaseStream)
+  : mBaseStream(aBaseStream)
+  , mDecoder(nullptr)
+  , mCompressedBytes(0)
+  , mNextCompressedByte(0)
+  , mUncompressedBytes(0)
+  , mNextByte(0)
+{
+  // This implementation only supports sync base streams.  Verify this in debug
+  // builds.  Note, this is a bit complicated because the streams we support
+  // advertise different capabilities:
+  //  - nsFileInputStream - blocking and sync
+  //  - nsStringInputStream - non-blocking and sync
+  //  - nsPipeInputStream - can be blocking, but provides async interface
+#ifdef DEBUG
+  bool baseNonBlocking;
+  nsresult rv = mBaseStream->IsNonBlocking(&baseNonBlocking);
+  MOZ_ASSERT(NS_SUCCEEDED(rv));
+  if (baseNonBlocking) {
+    nsCOMPtr<nsIAsyncInputStream> async = do_QueryInterface(mBaseStream);
+    MOZ_ASSERT(!async);
+  }
+#endif
+}
+
+NS_IMETHODIMP
+BrotliUncompressInputStream::Close()
+{
+  if (!mBaseStream) {
+    return NS_OK;
+  }
+
+  mBaseStream->Close();
+  mBaseStream = nullptr;
+
+  if (mDecoder) {
+    BrotliDecoderDestroyInstance(mDecoder);
+    mDecoder = nullptr;
+  }
+
+  mUncompressedBuffer = nullptr;
+  mCompressedBuffer = nullptr;
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliUncompressInputStream::Available(uint64_t* aLengthOut)
+{
+  if (!mBaseStream) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  // If we have uncompressed bytes, then we are done.
+  *aLengthOut = UncompressedLength();
+  if (*aLengthOut > 0) {
+    return NS_OK;
+  }
+
+  // Otherwise, attempt to uncompress bytes until we get something or the
+  // underlying stream is drained.  We loop here because the decoder may
+  // have to consume metadata blocks that produce no data.
+  uint32_t bytesRead;
+  do {
+    nsresult rv = UncompressNextChunk(&bytesRead);
+    if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+    *aLengthOut = UncompressedLength();
+  } while (*aLengthOut == 0 && bytesRead);
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliUncompressInputStream::Read(char* aBuf, uint32_t aCount,
+                                  uint32_t* aBytesReadOut)
+{
+  return ReadSegments(NS_CopySegmentToBuffer, aBuf, aCount, aBytesReadOut);
+}
+
+NS_IMETHODIMP
+BrotliUncompressInputStream::ReadSegments(nsWriteSegmentFun aWriter,
+                                          void* aClosure, uint32_t aCount,
+                                          uint32_t* aBytesReadOut)
+{
+  *aBytesReadOut = 0;
+
+  if (!mBaseStream) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  nsresult rv;
+
+  // Do not try to use the base stream's ReadSegments here.  Its very
+  // unlikely we will get a single buffer that contains all of the compressed
+  // data and therefore would have to copy into our own buffer anyways.
+  // Instead, focus on making efficient use of the Read() interface.
+
+  while (aCount > 0) {
+    // We have some decompressed data in our buffer.  Provide it to the
+    // callers writer function.
+    if (mUncompressedBytes > 0) {
+      MOZ_ASSERT(mUncompressedBuffer);
+      uint32_t remaining = UncompressedLength();
+      uint32_t numToWrite = std::min(aCount, remaining);
+      uint32_t numWritten;
+      rv = aWriter(this, aClosure, &mUncompressedBuffer[mNextByte], *aBytesReadOut,
+                   numToWrite, &numWritten);
+
+      // As defined in nsIInputputStream.idl, do not pass writer func errors.
+      if (NS_FAILED(rv)) {
+        return NS_OK;
+      }
+
+      // End-of-file
+      if (numWritten == 0) {
+        return NS_OK;
+      }
+
+      *aBytesReadOut += numWritten;
+      mNextByte += numWritten;
+      MOZ_ASSERT(mNextByte <= mUncompressedBytes);
+
+      if (mNextByte == mUncompressedBytes) {
+        mNextByte = 0;
+        mUncompressedBytes = 0;
+      }
+
+      aCount -= numWritten;
+
+      continue;
+    }
+
+    // Otherwise uncompress the next chunk and loop.  Any resulting data
+    // will set mUncompressedBytes which we check at the top of the loop.
+    uint32_t bytesRead;
+    rv = UncompressNextChunk(&bytesRead);
+    if (NS_FAILED(rv)) { return rv; }
+
+    // If we couldn't read anything and there is no more data to provide
+    // to the caller, then this is eof.
+    if (bytesRead == 0 && mUncompressedBytes == 0) {
+      return NS_OK;
+    }
+  }
+
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+BrotliUncompressInputStream::IsNonBlocking(bool* aNonBlockingOut)
+{
+  *aNonBlockingOut = false;
+  return NS_OK;
+}
+
+BrotliUncompressInputStream::~BrotliUncompressInputStream()
+{
+  Close();
+}
+
+nsresult
+BrotliUncompressInputStream::UncompressNextChunk(uint32_t* aBytesReadOut)
+{
+  // There must not be any uncompressed data already in mUncompressedBuffer.
+  MOZ_ASSERT(mUncompressedBytes == 0);
+  MOZ_ASSERT(mNextByte == 0);
+
+  *aBytesReadOut = 0;
+
+  // Lazily create the decoder and our two buffers so we can report OOM
+  // during stream operation.  These allocations only happen once.  They
+  // are all reused until the stream is closed.
+  if (!mDecoder) {
+    mDecoder = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    if (NS_WARN_IF(!mDecoder)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  if (!mUncompressedBuffer) {
+    mUncompressedBuffer.reset(new (fallible) char[kBufferLength]);
+    if (NS_WARN_IF(!mUncompressedBuffer)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  if (!mCompressedBuffer) {
+    mCompressedBuffer.reset(new (fallible) char[kBufferLength]);
+    if (NS_WARN_IF(!mCompressedBuffer)) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  // The end of the brotli stream was already decoded, so there is nothing
+  // more to provide.  Any trailing data in the base stream is ignored.
+  if (BrotliDecoderIsFinished(mDecoder)) {
+    return NS_OK;
+  }
+
+  for (;;) {
+    // If the decoder has consumed all buffered compressed data, then
+    // refill the buffer from the base stream.
+    if (mNextCompressedByte == mCompressedBytes) {
+      uint32_t bytesRead = 0;
+      nsresult rv = mBaseStream->Read(mCompressedBuffer.get(), kBufferLength,
+                                      &bytesRead);
+      if (NS_WARN_IF(NS_FAILED(rv))) { return rv; }
+
+      mCompressedBytes = bytesRead;
+      mNextCompressedByte = 0;
+      *aBytesReadOut += bytesRead;
+
+      // The base stream hit EOF.  If this happened in the middle of the
+      // brotli stream, then the data was truncated.
+      if (bytesRead == 0) {
+        if (NS_WARN_IF(BrotliDecoderIsUsed(mDecoder))) {
+          return NS_ERROR_CORRUPTED_CONTENT;
+        }
+        return NS_OK;
+      }
+    }
+
+    const uint8_t* nextIn = reinterpret_cast<const uint8_t*>(
+      &mCompressedBuffer[mNextCompressedByte]);
+    size_t availIn = mCompressedBytes - mNextCompressedByte;
+
+    uint8_t* nextOut = reinterpret_cast<uint8_t*>(mUncompressedBuffer.get());
+    size_t availOut = kBufferLength;
+
+    BrotliDecoderResult result =
+      BrotliDecoderDecompressStream(mDecoder, &availIn, &nextIn,
+                                    &availOut, &nextOut, nullptr);
+
+    mNextCompressedByte = mCompressedBytes - availIn;
+    mUncompressedBytes = kBufferLength - availOut;
+
+    if (NS_WARN_IF(result == BROTLI_DECODER_RESULT_ERROR)) {
+      return NS_ERROR_CORRUPTED_CONTENT;
+    }
+
+    // Return to the caller once the decoder has produced data or finished
+    // the stream.  On BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT we loop and
+    // read more compressed data from the base stream.
+    if (mUncompressedBytes > 0 || result == BROTLI_DECODER_RESULT_SUCCESS) {
+      return NS_OK;
+    }
+  }
+}
+
+size_t
+BrotliUncompressInputStream::UncompressedLength() const
+{
+  MOZ_ASSERT(mNextByte <= mUncompressedBytes);
+  return mUncompressedBytes - mNextByte;
+}
+
+} // namespace mozilla
@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_BrotliUncompressInputStream_h__
+#define mozilla_BrotliUncompressInputStream_h__
+
+#include "mozilla/Attributes.h"
+#include "mozilla/UniquePtr.h"
+#include "nsCOMPtr.h"
+#include "nsIInputStream.h"
+#include "nsISupportsImpl.h"
+
+typedef struct BrotliDecoderStateStruct BrotliDecoderState;
+
+namespace mozilla {
+
+// An input stream that uncompresses a raw brotli stream, such as the one
+// produced by BrotliCompressOutputStream, as it reads from the base
+// stream.
+class BrotliUncompressInputStream final : public nsIInputStream
+{
+public:
+  // Construct a new blocking stream to uncompress the given base stream.  The
+  // base stream must also be blocking.  The base stream does not have to be
+  // buffered.
+  explicit BrotliUncompressInputStream(nsIInputStream* aBaseStream);
+
+private:
+  virtual ~BrotliUncompressInputStream();
+
+  // Read more compressed data from the base stream as necessary and run
+  // the decoder until it produces uncompressed data or the streams are
+  // drained.  This may populate mUncompressedBuffer and set
+  // mUncompressedBytes.  This should not be called when the buffer still
+  // holds uncompressed data.
+  nsresult UncompressNextChunk(uint32_t* aBytesReadOut);
+
+  // Convenience routine to determine how many bytes of uncompressed data
+  // we currently have in our buffer.
+  size_t UncompressedLength() const;
+
+  nsCOMPtr<nsIInputStream> mBaseStream;
+
+  // The decoder carries state from chunk to chunk, so it exists for the
+  // lifetime of the stream.  Created lazily so that OOM can be reported
+  // during stream operation.
+  BrotliDecoderState* mDecoder;
+
+  // Buffer holding compressed data read from the base stream that the
+  // decoder has not consumed yet.
+  mozilla::UniquePtr<char[]> mCompressedBuffer;
+
+  // Number of valid bytes in mCompressedBuffer and the next byte for the
+  // decoder to consume.
+  size_t mCompressedBytes;
+  size_t mNextCompressedByte;
+
+  // Buffer storing the resulting uncompressed data.
+  mozilla::UniquePtr<char[]> mUncompressedBuffer;
+
+  // Number of bytes of uncompressed data in mUncompressedBuffer.
+  size_t mUncompressedBytes;
+
+  // Next byte of mUncompressedBuffer to return in ReadSegments().  Must be
+  // less than mUncompressedBytes.
+  size_t mNextByte;
+
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+  NS_DECL_NSIINPUTSTREAM
+};
+
+} // namespace mozilla
+
+#endif // mozilla_BrotliUncompressInputStream_h__
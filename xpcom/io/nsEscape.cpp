@@ -9,6 +9,7 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/BinarySearch.h"
 #include "mozilla/CheckedInt.h"
+#include "nsEscapeImpl.h"
 #include "nsTArray.h"
 #include "nsCRT.h"
 #include "plstr.h"
@@ -168,11 +169,6 @@ nsUnescapeCount(char* aStr)
   char* src = aStr;
   char* dst = aStr;
 
-  char c1[] = " ";
-  char c2[] = " ";
-  char* const pc1 = c1;
-  char* const pc2 = c2;
-
   if (!*src) {
     // A null string was passed in.  Nothing to escape.
     // Returns early as the string might not actually be mutable with
@@ -181,28 +177,37 @@ nsUnescapeCount(char* aStr)
   }
 
   while (*src) {
-    c1[0] = *(src + 1);
-    if (*(src + 1) == '\0') {
-      c2[0] = '\0';
-    } else {
-      c2[0] = *(src + 2);
-    }
-
-    if (*src != HEX_ESCAPE || PL_strpbrk(pc1, hexCharsUpperLower) == 0 ||
-        PL_strpbrk(pc2, hexCharsUpperLower) == 0) {
-      *dst++ = *src++;
-    } else {
-      src++; /* walk over escape */
-      if (*src) {
-        *dst = UNHEX(*src) << 4;
-        src++;
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+    if (mozilla::supports_sse2()) {
+      // In practice almost every character of a URL is not an escape;
+      // move whole runs of them at once instead of walking char by char.
+      size_t run = mozilla::SSE2::UnescapedRunLength(src);
+      if (run) {
+        if (dst != src) {
+          memmove(dst, src, run);
+        }
+        dst += run;
+        src += run;
+        if (!*src) {
+          break;
+        }
       }
-      if (*src) {
-        *dst = (*dst + UNHEX(*src));
-        src++;
+    }
+#endif
+
+    if (*src == HEX_ESCAPE) {
+      const char h1 = *(src + 1);
+      const char h2 = h1 ? *(src + 2) : '\0';
+      if (h1 && strchr(hexCharsUpperLower, h1) &&
+          h2 && strchr(hexCharsUpperLower, h2)) {
+        *dst++ = (UNHEX(h1) << 4) + UNHEX(h2);
+        src += 3;
+        continue;
       }
-      dst++;
     }
+
+    // Not an escape (or a malformed one); copy the character through.
+    *dst++ = *src++;
   }
 
   *dst = 0;
@@ -321,8 +326,42 @@ T_EscapeURL(const typename T::char_type* aPart, size_t aPartLen,
   typename T::char_type tempBuffer[100];
   unsigned int tempBufferPos = 0;
 
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+  // The vector scan recognizes characters that are clean for every URL
+  // component, so it only applies when escaping is driven by component
+  // flags and there's no filter to honor.
+  const bool useSIMD = sizeof(unsigned_char_type) == 1 && !aFilterMask &&
+                       (aFlags & 0x03ff) != 0 && mozilla::supports_sse2();
+#endif
+
   bool previousIsNonASCII = false;
   for (size_t i = 0; i < aPartLen; ++i) {
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+    if (useSIMD && !previousIsNonASCII) {
+      size_t clean = mozilla::SSE2::UrlCleanRunLength(
+        reinterpret_cast<const char*>(src), aPartLen - i);
+      if (clean) {
+        if (writing) {
+          // Flush pending escaped output, then copy the clean run in one
+          // append rather than staging it through tempBuffer.
+          if (tempBufferPos &&
+              !aResult.Append(tempBuffer, tempBufferPos, fallible)) {
+            return NS_ERROR_OUT_OF_MEMORY;
+          }
+          tempBufferPos = 0;
+          if (!aResult.Append(aPart + i, clean, fallible)) {
+            return NS_ERROR_OUT_OF_MEMORY;
+          }
+        }
+        src += clean;
+        i += clean;
+        if (i == aPartLen) {
+          break;
+        }
+      }
+    }
+#endif
+
     unsigned_char_type c = *src++;
 
     // If there is a filter, we wish to skip any characters which match it.
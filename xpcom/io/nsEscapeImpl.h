@@ -0,0 +1,40 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsEscapeImpl_h__
+#define nsEscapeImpl_h__
+
+#include <stddef.h>
+
+#include "mozilla/SSE.h"
+
+namespace mozilla {
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+namespace SSE2 {
+
+/**
+ * Returns the length of the leading run of aLen bytes of aSrc consisting
+ * only of characters that never need URL escaping for any URL component
+ * (alphanumerics and ! $ & ( ) * + , - _ ~).  Only whole 16-byte blocks
+ * are examined, so the returned length understates the run by up to 15
+ * characters; the scalar code picks up from there.
+ */
+size_t UrlCleanRunLength(const char* aSrc, size_t aLen);
+
+/**
+ * Returns the number of leading characters of the null-terminated string
+ * aStr that are neither '%' nor the terminator, i.e. the length of the
+ * run an unescaper can pass through untouched.
+ */
+size_t UnescapedRunLength(const char* aStr);
+
+} // namespace SSE2
+#endif
+
+} // namespace mozilla
+
+#endif // nsEscapeImpl_h__
@@ -0,0 +1,97 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+#include "mozilla/MathAlgorithms.h"
+#include "nsEscapeImpl.h"
+
+namespace mozilla {
+namespace SSE2 {
+
+// Matches bytes in a closed range using signed comparisons.  Input bytes
+// >= 0x80 are negative and never match, which is what both callers want.
+static inline __m128i
+InRange(__m128i aValue, char aLo, char aHi)
+{
+  return _mm_and_si128(_mm_cmpgt_epi8(aValue, _mm_set1_epi8(aLo - 1)),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(aHi + 1), aValue));
+}
+
+size_t
+UrlCleanRunLength(const char* aSrc, size_t aLen)
+{
+  size_t run = 0;
+
+  while (aLen - run >= 16) {
+    const __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + run));
+
+    // The characters with all component bits set in the EscapeChars
+    // matrix: alphanumerics plus ! $ & ( ) * + , - _ ~.  Notably absent
+    // are '%' (so escape sequences stay untouched), apostrophe (escaped
+    // for queries among other components), ':' (esc_Colon), '|' (escaped
+    // after non-ASCII) and '.' and '/', which are escaped for some
+    // components.
+    __m128i clean = InRange(chunk, 0x28, 0x2d);          // ( ) * + , -
+    clean = _mm_or_si128(clean, InRange(chunk, '0', '9'));
+    clean = _mm_or_si128(clean, InRange(chunk, 'A', 'Z'));
+    clean = _mm_or_si128(clean, InRange(chunk, 'a', 'z'));
+    clean = _mm_or_si128(clean,
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('&')));
+    clean = _mm_or_si128(clean,
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('!')));
+    clean = _mm_or_si128(clean,
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('$')));
+    clean = _mm_or_si128(clean,
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+    clean = _mm_or_si128(clean,
+                         _mm_cmpeq_epi8(chunk, _mm_set1_epi8('~')));
+
+    const int dirty = _mm_movemask_epi8(clean) ^ 0xffff;
+    if (dirty) {
+      return run + mozilla::CountTrailingZeroes32(dirty);
+    }
+    run += 16;
+  }
+
+  return run;
+}
+
+size_t
+UnescapedRunLength(const char* aStr)
+{
+  size_t run = 0;
+
+  // The string length isn't known, so align to 16 bytes first; aligned
+  // loads can't cross a page boundary and so can't fault past the
+  // terminator.
+  while (reinterpret_cast<uintptr_t>(aStr + run) & 0xf) {
+    if (!aStr[run] || aStr[run] == '%') {
+      return run;
+    }
+    run++;
+  }
+
+  for (;;) {
+    const __m128i chunk =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(aStr + run));
+
+    const __m128i stop =
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_setzero_si128()),
+                   _mm_cmpeq_epi8(chunk, _mm_set1_epi8('%')));
+
+    const int mask = _mm_movemask_epi8(stop);
+    if (mask) {
+      return run + mozilla::CountTrailingZeroes32(mask);
+    }
+    run += 16;
+  }
+}
+
+} // namespace SSE2
+} // namespace mozilla
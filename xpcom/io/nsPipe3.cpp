@@ -5,6 +5,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <algorithm>
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/IntegerPrintfMacros.h"
 #include "mozilla/ReentrantMonitor.h"
@@ -119,22 +120,51 @@ struct nsPipeReadState
     , mReadLimit(nullptr)
     , mSegment(0)
     , mAvailable(0)
+    , mLocklessAdvance(0)
+    , mActiveRead(false)
+    , mNeedDrain(false)
+  { }
+
+  nsPipeReadState(const nsPipeReadState& aOther)
+    : mReadCursor(aOther.mReadCursor)
+    , mReadLimit(static_cast<char*>(aOther.mReadLimit))
+    , mSegment(aOther.mSegment)
+    , mAvailable(aOther.mAvailable)
+    , mLocklessAdvance(static_cast<uint32_t>(aOther.mLocklessAdvance))
+    // A new stream created from this state never starts out with a read
+    // in progress, regardless of what the source stream was doing.
     , mActiveRead(false)
     , mNeedDrain(false)
   { }
 
   char*    mReadCursor;
-  char*    mReadLimit;
+
+  // The writing thread moves the read limit forward while it fills the
+  // current read segment, so the lockless path in AdvanceReadCursor()
+  // may observe this value without the monitor.  The monitor still
+  // orders every other access.
+  mozilla::Atomic<char*, mozilla::Relaxed> mReadLimit;
+
   int32_t  mSegment;
   uint32_t mAvailable;
 
-  // This flag is managed using the AutoReadSegment RAII stack class.
-  bool     mActiveRead;
+  // Number of bytes the reading thread has consumed from the current
+  // segment without entering the monitor.  This is always strictly less
+  // than the distance from mReadCursor to mReadLimit, so a lockless
+  // advance can never release a segment or unblock the writer.  The
+  // value is folded back into mReadCursor and mAvailable the next time
+  // the monitor is taken for this read state.
+  mozilla::Atomic<uint32_t> mLocklessAdvance;
+
+  // This flag is managed using the AutoReadSegment RAII stack class.  Its
+  // atomic because the lockless path in AdvanceReadCursor() clears it
+  // without entering the monitor.
+  mozilla::Atomic<bool> mActiveRead;
 
   // Set to indicate that the input stream has closed and should be drained,
   // but that drain has been delayed due to an active read.  When the read
   // completes, this flag indicate the drain should then be performed.
-  bool     mNeedDrain;
+  mozilla::Atomic<bool> mNeedDrain;
 };
 
 //-----------------------------------------------------------------------------
@@ -317,6 +347,8 @@ private:
 
   void PeekSegment(const nsPipeReadState& aReadState, uint32_t aIndex,
                    char*& aCursor, char*& aLimit);
+  void FoldLocklessAdvance(nsPipeReadState& aReadState,
+                           const ReentrantMonitorAutoEnter& ev);
   SegmentChangeResult AdvanceReadSegment(nsPipeReadState& aReadState,
                                          const ReentrantMonitorAutoEnter &ev);
   bool ReadSegmentBeingWritten(nsPipeReadState& aReadState);
@@ -512,6 +544,13 @@ private:
 //       allow slower input streams to buffer more data so that we don't
 //       stall processing of the faster input stream.
 //
+// NOTE: A read that does not consume the remainder of its current segment
+//       completes without entering the monitor.  The reading thread instead
+//       publishes the consumed byte count in nsPipeReadState.mLocklessAdvance
+//       and the pipe folds that value back into mReadCursor and mAvailable
+//       the next time the monitor is taken for that stream.  See
+//       nsPipe::AdvanceReadCursor().
+//
 // NOTE: on some systems (notably OS/2), the heap allocator uses an arena for
 // small allocations (e.g., 64 byte allocations).  this means that buffers may
 // be allocated back-to-back.  in the diagram above, for example, mReadLimit
@@ -629,7 +668,7 @@ nsPipe::PeekSegment(const nsPipeReadState& aReadState, uint32_t aIndex,
 {
   if (aIndex == 0) {
     MOZ_DIAGNOSTIC_ASSERT(!aReadState.mReadCursor || mBuffer.GetSegmentCount());
-    aCursor = aReadState.mReadCursor;
+    aCursor = aReadState.mReadCursor + aReadState.mLocklessAdvance;
     aLimit = aReadState.mReadLimit;
   } else {
     uint32_t absoluteIndex = aReadState.mSegment + aIndex;
@@ -647,12 +686,37 @@ nsPipe::PeekSegment(const nsPipeReadState& aReadState, uint32_t aIndex,
   }
 }
 
+void
+nsPipe::FoldLocklessAdvance(nsPipeReadState& aReadState,
+                            const ReentrantMonitorAutoEnter& ev)
+{
+  // May only be called when no lockless read can be in flight for this
+  // read state; either mActiveRead has been observed false or we are on
+  // the reading thread itself.
+  uint32_t advance = aReadState.mLocklessAdvance;
+  if (!advance) {
+    return;
+  }
+
+  aReadState.mReadCursor += advance;
+  MOZ_DIAGNOSTIC_ASSERT(aReadState.mReadCursor < aReadState.mReadLimit);
+
+  MOZ_DIAGNOSTIC_ASSERT(aReadState.mAvailable >= advance);
+  aReadState.mAvailable -= advance;
+
+  aReadState.mLocklessAdvance = 0;
+}
+
 nsresult
 nsPipe::GetReadSegment(nsPipeReadState& aReadState, const char*& aSegment,
                        uint32_t& aLength)
 {
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
+  // Catch the read state up with anything consumed on the lockless path
+  // before examining the cursor.
+  FoldLocklessAdvance(aReadState, mon);
+
   if (aReadState.mReadCursor == aReadState.mReadLimit) {
     return NS_FAILED(mStatus) ? mStatus : NS_BASE_STREAM_WOULD_BLOCK;
   }
@@ -660,8 +724,9 @@ nsPipe::GetReadSegment(nsPipeReadState& aReadState, const char*& aSegment,
   // The input stream locks the pipe while getting the buffer to read from,
   // but then unlocks while actual data copying is taking place.  In
   // order to avoid deleting the buffer out from under this lockless read
-  // set a flag to indicate a read is active.  This flag is only modified
-  // while the lock is held.
+  // set a flag to indicate a read is active.  This flag is only set
+  // while the lock is held, but AdvanceReadCursor() may clear it without
+  // the lock; DrainInputStream() compensates for that race.
   MOZ_DIAGNOSTIC_ASSERT(!aReadState.mActiveRead);
   aReadState.mActiveRead = true;
 
@@ -694,6 +759,35 @@ void
 nsPipe::AdvanceReadCursor(nsPipeReadState& aReadState, uint32_t aBytesRead)
 {
   MOZ_DIAGNOSTIC_ASSERT(aBytesRead > 0);
+  MOZ_DIAGNOSTIC_ASSERT(aReadState.mActiveRead);
+  MOZ_DIAGNOSTIC_ASSERT(!aReadState.mLocklessAdvance);
+
+  // Fast path: if the read leaves data behind in the current segment, then
+  // no segment can be released and the writer can never become unblocked.
+  // There is nobody to notify, so the consumed byte count can simply be
+  // published in mLocklessAdvance without entering the monitor.  It gets
+  // folded back into the read state the next time the monitor is taken
+  // on behalf of this stream.
+  if (aReadState.mReadCursor + aBytesRead < aReadState.mReadLimit) {
+    aReadState.mLocklessAdvance = aBytesRead;
+
+    // Lockless equivalent of ReleaseReadSegment().  Clearing mActiveRead
+    // races with DrainInputStream() setting mNeedDrain; both sides
+    // re-check the other flag after writing so that exactly one of them
+    // performs a deferred drain.
+    aReadState.mActiveRead = false;
+    if (aReadState.mNeedDrain) {
+      nsPipeEvents events;
+      {
+        ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+        if (aReadState.mNeedDrain) {
+          aReadState.mNeedDrain = false;
+          DrainInputStream(aReadState, events);
+        }
+      }
+    }
+    return;
+  }
 
   nsPipeEvents events;
   {
@@ -811,9 +905,22 @@ nsPipe::DrainInputStream(nsPipeReadState& aReadState, nsPipeEvents& aEvents)
   if (aReadState.mActiveRead) {
     MOZ_DIAGNOSTIC_ASSERT(!aReadState.mNeedDrain);
     aReadState.mNeedDrain = true;
-    return;
+
+    // The lockless path in AdvanceReadCursor() may have released the
+    // segment between the check above and setting mNeedDrain, in which
+    // case it can have missed the flag.  Re-check so the drain is not
+    // deferred forever; if the read really is still active, the reader
+    // is guaranteed to observe mNeedDrain when it completes.
+    if (aReadState.mActiveRead) {
+      return;
+    }
+    aReadState.mNeedDrain = false;
   }
 
+  // No lockless read can be in flight now, so any outstanding lockless
+  // advance can be folded in before walking the segment list.
+  FoldLocklessAdvance(aReadState, mon);
+
   while(mWriteSegment >= aReadState.mSegment) {
 
     // If the last segment to free is still being written to, we're done
@@ -1086,7 +1193,7 @@ nsPipe::AllReadCursorsMatchWriteCursor()
   for (uint32_t i = 0; i < mInputList.Length(); ++i) {
     const nsPipeReadState& readState = mInputList[i]->ReadState();
     if (readState.mSegment != mWriteSegment ||
-        readState.mReadCursor != mWriteCursor) {
+        readState.mReadCursor + readState.mLocklessAdvance != mWriteCursor) {
       return false;
     }
   }
@@ -1100,6 +1207,9 @@ nsPipe::RollBackAllReadCursors(char* aWriteCursor)
   for (uint32_t i = 0; i < mInputList.Length(); ++i) {
     nsPipeReadState& readState = mInputList[i]->ReadState();
     MOZ_DIAGNOSTIC_ASSERT(mWriteSegment == readState.mSegment);
+    // A fully consumed segment implies the final advance took the slow
+    // path, so no lockless advance can be pending here.
+    MOZ_DIAGNOSTIC_ASSERT(!readState.mLocklessAdvance);
     MOZ_DIAGNOSTIC_ASSERT(mWriteCursor == readState.mReadCursor);
     MOZ_DIAGNOSTIC_ASSERT(mWriteCursor == readState.mReadLimit);
     readState.mReadCursor = aWriteCursor;
@@ -1286,7 +1396,7 @@ uint32_t
 nsPipeInputStream::Available()
 {
   mPipe->mReentrantMonitor.AssertCurrentThreadIn();
-  return mReadState.mAvailable;
+  return mReadState.mAvailable - mReadState.mLocklessAdvance;
 }
 
 nsresult
@@ -1397,7 +1507,7 @@ nsPipeInputStream::Available(uint64_t* aResult)
     return Status(mon);
   }
 
-  *aResult = (uint64_t)mReadState.mAvailable;
+  *aResult = (uint64_t)(mReadState.mAvailable - mReadState.mLocklessAdvance);
   return NS_OK;
 }
 
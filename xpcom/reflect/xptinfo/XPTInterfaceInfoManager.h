@@ -13,7 +13,9 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/ReentrantMonitor.h"
+#include "mozilla/UniquePtr.h"
 #include "nsDataHashtable.h"
+#include "nsTArray.h"
 
 template<typename T> class nsCOMArray;
 class nsIMemoryReporter;
@@ -40,7 +42,9 @@ public:
 
     void GetScriptableInterfaces(nsCOMArray<nsIInterfaceInfo>& aInterfaces);
 
-    void RegisterBuffer(char *buf, uint32_t length);
+    // Takes ownership of the buffer; parsed interface metadata points
+    // directly into it, so it must stay alive as long as the working set.
+    void RegisterBuffer(UniquePtr<char[]> buf, uint32_t length);
 
     static Mutex& GetResolveLock()
     {
@@ -112,6 +116,11 @@ private:
 
     xptiWorkingSet               mWorkingSet;
     Mutex                        mResolveLock;
+
+    // The raw typelib images. Interface names and other strings decoded by
+    // the XDR layer are borrowed from these buffers instead of being copied
+    // into the struct arena, so they are kept for the manager's lifetime.
+    nsTArray<UniquePtr<char[]>>  mTypelibBuffers;
 };
 
 } // namespace mozilla
@@ -37,6 +37,10 @@ XPTInterfaceInfoManager::SizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf
     // for elsewhere, so don't measure them
     n += mWorkingSet.mIIDTable.ShallowSizeOfExcludingThis(aMallocSizeOf);
     n += mWorkingSet.mNameTable.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    n += mTypelibBuffers.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    for (const auto& buffer : mTypelibBuffers) {
+        n += aMallocSizeOf(buffer.get());
+    }
     return n;
 }
 
@@ -98,10 +102,10 @@ XPTInterfaceInfoManager::InitMemoryReporter()
 }
 
 void
-XPTInterfaceInfoManager::RegisterBuffer(char *buf, uint32_t length)
+XPTInterfaceInfoManager::RegisterBuffer(UniquePtr<char[]> buf, uint32_t length)
 {
     XPTState state;
-    XPT_InitXDRState(&state, buf, length);
+    XPT_InitXDRState(&state, buf.get(), length, /* data_is_persistent = */ true);
 
     XPTCursor curs;
     NotNull<XPTCursor*> cursor = WrapNotNull(&curs);
@@ -111,6 +115,9 @@ XPTInterfaceInfoManager::RegisterBuffer(char *buf, uint32_t length)
 
     XPTHeader *header = nullptr;
     if (XPT_DoHeader(gXPTIStructArena, cursor, &header)) {
+        // The decoded structures borrow their strings from the buffer, so
+        // hold on to it for the lifetime of the working set.
+        mTypelibBuffers.AppendElement(Move(buf));
         RegisterXPTHeader(header);
     }
 }
@@ -47,6 +47,28 @@ public:
    */
   static already_AddRefed<nsStringBuffer> Alloc(size_t aStorageSize);
 
+  /**
+   * Sets up the per-thread recycling cache used to satisfy small Alloc()
+   * requests without going to the heap allocator, and enables it for the
+   * calling (main) thread.  Called once during XPCOM startup; Alloc() and
+   * Release() fall back to plain malloc/free until then.
+   */
+  static void InitThreadCache();
+
+  /**
+   * Enables the recycling cache for the calling thread.  Only call this on
+   * threads whose shutdown path calls ClearThreadCache(); the thread-local
+   * storage runs no destructor at thread exit, so an unpaired enable would
+   * leak the cached buffers when the thread dies.
+   */
+  static void EnableThreadCache();
+
+  /**
+   * Frees the calling thread's recycling cache and everything on its free
+   * lists.  Must be called before a cache-enabled thread exits.
+   */
+  static void ClearThreadCache();
+
   /**
    * Resizes the given string buffer to the specified storage size.  This
    * method must not be called on a readonly string buffer.  Use this API
@@ -10,6 +10,7 @@
 
 #include "mozilla/Atomics.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/ThreadLocal.h"
 
 #ifdef ENABLE_STRING_STATS
 #include <stdio.h>
@@ -38,6 +39,150 @@
 
 using mozilla::Atomic;
 
+// ---------------------------------------------------------------------------
+// Small string buffer recycling.
+//
+// Short heap-allocated strings dominate nsStringBuffer traffic, and unlike
+// auto strings they cannot use inline stack storage because substrings are
+// relocated with memmove.  Instead of handing every small buffer straight
+// back to the allocator, each thread keeps a bounded free list of
+// fixed-size buffers, and small Alloc() requests are rounded up to the
+// class size and satisfied from that list when possible.  This turns the
+// malloc/free pair for the common short string into a couple of pointer
+// moves with no locking.
+
+namespace {
+
+struct SmallBufferCache
+{
+  // Two size classes cover the bulk of short strings: 32 bytes of storage
+  // holds a 15-char UTF-16 (or 31-char UTF-8) string, 64 bytes twice that.
+  static const size_t kClassCount = 2;
+  // Per-class depth limit; at most ~3KiB of cached buffers per thread.
+  static const uint32_t kMaxDepth = 32;
+
+  static size_t ClassSize(size_t aClass) { return size_t(32) << aClass; }
+
+  // Returns the size class able to hold aSize bytes of storage, or
+  // kClassCount if aSize is too big to be cached.
+  static size_t ClassFor(size_t aSize)
+  {
+    if (aSize <= 32) {
+      return 0;
+    }
+    if (aSize <= 64) {
+      return 1;
+    }
+    return kClassCount;
+  }
+
+  // Heads of singly-linked free lists; the link is stored in the first
+  // word of the dead buffer itself.
+  void* mHead[kClassCount];
+  uint32_t mDepth[kClassCount];
+};
+
+static MOZ_THREAD_LOCAL(SmallBufferCache*) sSmallBufferCache;
+static Atomic<bool> sSmallBufferCacheReady(false);
+
+// Takes ownership of aBuffer (a dead, class-sized allocation) if there is
+// room in this thread's cache.  Returns false if the caller should free it.
+static bool
+RecycleSmallBuffer(void* aBuffer, size_t aStorageSize)
+{
+  if (!sSmallBufferCacheReady) {
+    return false;
+  }
+  size_t sizeClass = SmallBufferCache::ClassFor(aStorageSize);
+  if (sizeClass >= SmallBufferCache::kClassCount ||
+      SmallBufferCache::ClassSize(sizeClass) != aStorageSize) {
+    // Only buffers allocated at exactly the class size are recyclable;
+    // anything else (e.g. buffers that have been realloc'ed) must not end
+    // up on the free list or a later Alloc() would overrun it.
+    return false;
+  }
+  // Only threads that called EnableThreadCache() have a cache.  MOZ_THREAD_LOCAL
+  // runs no destructor at thread exit, so caching is restricted to threads
+  // whose shutdown path pairs the enable with ClearThreadCache(); anything
+  // else would strand the cached buffers when the thread dies.
+  SmallBufferCache* cache = sSmallBufferCache.get();
+  if (!cache) {
+    return false;
+  }
+  if (cache->mDepth[sizeClass] >= SmallBufferCache::kMaxDepth) {
+    return false;
+  }
+  *reinterpret_cast<void**>(aBuffer) = cache->mHead[sizeClass];
+  cache->mHead[sizeClass] = aBuffer;
+  cache->mDepth[sizeClass]++;
+  return true;
+}
+
+// Returns a cached class-sized allocation for aSizeClass, or null.
+static void*
+TakeSmallBuffer(size_t aSizeClass)
+{
+  if (!sSmallBufferCacheReady) {
+    return nullptr;
+  }
+  SmallBufferCache* cache = sSmallBufferCache.get();
+  if (!cache || !cache->mHead[aSizeClass]) {
+    return nullptr;
+  }
+  void* buffer = cache->mHead[aSizeClass];
+  cache->mHead[aSizeClass] = *reinterpret_cast<void**>(buffer);
+  cache->mDepth[aSizeClass]--;
+  return buffer;
+}
+
+} // namespace
+
+void
+nsStringBuffer::InitThreadCache()
+{
+  if (sSmallBufferCache.init()) {
+    sSmallBufferCacheReady = true;
+    // The main thread gets its cache here; ShutdownXPCOM tears it down.
+    EnableThreadCache();
+  }
+}
+
+void
+nsStringBuffer::EnableThreadCache()
+{
+  if (!sSmallBufferCacheReady || sSmallBufferCache.get()) {
+    return;
+  }
+  SmallBufferCache* cache =
+    (SmallBufferCache*)calloc(1, sizeof(SmallBufferCache));
+  if (cache) {
+    sSmallBufferCache.set(cache);
+  }
+}
+
+void
+nsStringBuffer::ClearThreadCache()
+{
+  if (!sSmallBufferCacheReady) {
+    return;
+  }
+  SmallBufferCache* cache = sSmallBufferCache.get();
+  if (!cache) {
+    return;
+  }
+  sSmallBufferCache.set(nullptr);
+  for (size_t sizeClass = 0; sizeClass < SmallBufferCache::kClassCount;
+       ++sizeClass) {
+    void* buffer = cache->mHead[sizeClass];
+    while (buffer) {
+      void* next = *reinterpret_cast<void**>(buffer);
+      free(buffer);
+      buffer = next;
+    }
+  }
+  free(cache);
+}
+
 // ---------------------------------------------------------------------------
 
 static const char16_t gNullChar = 0;
@@ -219,7 +364,9 @@ nsStringBuffer::Release()
     count = mRefCount.load(std::memory_order_acquire);
 
     STRING_STAT_INCREMENT(Free);
-    free(this); // we were allocated with |malloc|
+    if (!RecycleSmallBuffer(this, mStorageSize)) {
+      free(this); // we were allocated with |malloc|
+    }
   }
 }
 
@@ -234,8 +381,17 @@ nsStringBuffer::Alloc(size_t aSize)
                sizeof(nsStringBuffer) + aSize > aSize,
                "mStorageSize will truncate");
 
-  nsStringBuffer* hdr =
-    (nsStringBuffer*)malloc(sizeof(nsStringBuffer) + aSize);
+  nsStringBuffer* hdr = nullptr;
+  size_t sizeClass = SmallBufferCache::ClassFor(aSize);
+  if (sizeClass < SmallBufferCache::kClassCount) {
+    // Round small requests up to the class size so the resulting buffer is
+    // recyclable, and try this thread's cache first.
+    aSize = SmallBufferCache::ClassSize(sizeClass);
+    hdr = (nsStringBuffer*)TakeSmallBuffer(sizeClass);
+  }
+  if (!hdr) {
+    hdr = (nsStringBuffer*)malloc(sizeof(nsStringBuffer) + aSize);
+  }
   if (hdr) {
     STRING_STAT_INCREMENT(Alloc);
 
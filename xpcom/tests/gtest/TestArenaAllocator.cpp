@@ -281,6 +281,59 @@ TEST(ArenaAllocator, Clear)
   EXPECT_GT(sz, prev_sz);
 }
 
+namespace {
+
+// A chunk policy that counts the bytes handed out and taken back, so we can
+// verify the allocator routes every chunk through it.
+struct CountingChunkPolicy
+{
+  static size_t sBytesAllocated;
+  static size_t sBytesFreed;
+
+  static void* AllocateChunk(size_t aSize)
+  {
+    sBytesAllocated += aSize;
+    return malloc(aSize);
+  }
+
+  static void FreeChunk(void* aPtr, size_t aSize)
+  {
+    sBytesFreed += aSize;
+    free(aPtr);
+  }
+};
+
+size_t CountingChunkPolicy::sBytesAllocated = 0;
+size_t CountingChunkPolicy::sBytesFreed = 0;
+
+} // namespace
+
+TEST(ArenaAllocator, ChunkPolicy)
+{
+  static const size_t kArenaSize = 1024;
+
+  {
+    ArenaAllocator<kArenaSize, 8, CountingChunkPolicy> a;
+
+    // A small allocation should request exactly one arena-sized chunk.
+    void* x = a.Allocate(8);
+    EXPECT_TRUE(x);
+    EXPECT_EQ(CountingChunkPolicy::sBytesAllocated, kArenaSize);
+
+    // An over-sized allocation should request a larger chunk.
+    x = a.Allocate(kArenaSize * 2);
+    EXPECT_TRUE(x);
+    EXPECT_GT(CountingChunkPolicy::sBytesAllocated, kArenaSize * 3 - 1);
+
+    // Nothing has been freed yet.
+    EXPECT_EQ(CountingChunkPolicy::sBytesFreed, size_t(0));
+  }
+
+  // Destruction must return every byte to the policy.
+  EXPECT_EQ(CountingChunkPolicy::sBytesFreed,
+            CountingChunkPolicy::sBytesAllocated);
+}
+
 TEST(ArenaAllocator, Extensions)
 {
   ArenaAllocator<4096, 8> a;
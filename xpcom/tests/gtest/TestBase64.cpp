@@ -345,6 +345,26 @@ TEST(Base64, RFC4648Decoding)
     }
 }
 
+// Inputs long enough to go through the vectorized encode/decode kernels
+// (which only engage above one vector's worth of data), checked at every
+// length so the kernel/scalar hand-off is covered for each tail size.
+TEST(Base64, LongEncodeDecodeRoundTrip)
+{
+    nsAutoCString binary;
+    for (uint32_t i = 0; i < 1024; ++i) {
+        binary.Append(char(i * 89 + 17));
+
+        nsAutoCString base64;
+        nsresult rv = mozilla::Base64Encode(binary, base64);
+        ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+        nsAutoCString decoded;
+        rv = mozilla::Base64Decode(base64, decoded);
+        ASSERT_TRUE(NS_SUCCEEDED(rv));
+        ASSERT_TRUE(decoded.Equals(binary));
+    }
+}
+
 TEST(Base64, RFC4648DecodingRawPointers)
 {
     for (auto& testcase : sRFC4648TestCases) {
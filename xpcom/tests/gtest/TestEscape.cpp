@@ -69,6 +69,50 @@ TEST(Escape, BadEscapeSequences)
   }
 }
 
+TEST(Escape, LongStrings)
+{
+  // Escape and unescape strings long enough to exercise the vectorized
+  // fast paths, which only engage beyond one vector's worth of input.
+  nsCString unescaped;
+  nsCString escaped;
+  for (uint32_t i = 0; i < 500; ++i) {
+    unescaped.Append("path-segment");
+    escaped.Append("path-segment");
+    unescaped.Append(" /");
+    escaped.Append("%20/");
+
+    nsCString out;
+    nsresult rv = NS_EscapeURL(unescaped, esc_Forced | esc_Directory, out,
+                               fallible);
+    EXPECT_EQ(rv, NS_OK);
+    EXPECT_TRUE(out.Equals(escaped));
+
+    nsCString back(escaped);
+    int32_t count = nsUnescapeCount(back.BeginWriting());
+    EXPECT_EQ(count, int32_t(unescaped.Length()));
+    back.SetLength(count);
+    EXPECT_TRUE(back.Equals(unescaped));
+  }
+}
+
+TEST(Escape, ApostropheInQuery)
+{
+  // Apostrophe must be escaped in queries (its EscapeChars entry lacks the
+  // esc_Query bit). Make the string long enough to engage the vectorized
+  // fast path, which once wrongly treated apostrophe as clean.
+  nsCString unescaped;
+  nsCString escaped;
+  for (uint32_t i = 0; i < 100; ++i) {
+    unescaped.Append("it's");
+    escaped.Append("it%27s");
+  }
+
+  nsCString out;
+  nsresult rv = NS_EscapeURL(unescaped, esc_Query, out, fallible);
+  EXPECT_EQ(rv, NS_OK);
+  EXPECT_TRUE(out.Equals(escaped));
+}
+
 TEST(Escape, nsAppendEscapedHTML)
 {
   const char* srcs[] = {
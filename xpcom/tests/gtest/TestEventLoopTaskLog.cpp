@@ -0,0 +1,48 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/EventLoopTaskLog.h"
+#include "nsString.h"
+#include "gtest/gtest.h"
+
+using mozilla::EventLoopTaskLog;
+
+TEST(EventLoopTaskLog, RecordAndExport)
+{
+  nsTArray<EventLoopTaskLog::Entry> before;
+  EventLoopTaskLog::GetLongTasks(before);
+
+  EventLoopTaskLog::RecordTask(NS_LITERAL_CSTRING("TestTask"), 123.0);
+
+  nsTArray<EventLoopTaskLog::Entry> after;
+  EventLoopTaskLog::GetLongTasks(after);
+
+  // The log is capped at kEntryCount entries.
+  ASSERT_LE(after.Length(), EventLoopTaskLog::kEntryCount);
+  ASSERT_GE(after.Length(), 1u);
+
+  // The newest entry is ours.
+  const EventLoopTaskLog::Entry& entry = after.LastElement();
+  EXPECT_STREQ("TestTask", entry.mName);
+  EXPECT_EQ(123.0, entry.mRunMs);
+  EXPECT_FALSE(entry.mEnd.IsNull());
+}
+
+TEST(EventLoopTaskLog, NameTruncation)
+{
+  nsAutoCString longName;
+  for (int i = 0; i < 10; i++) {
+    longName.AppendLiteral("0123456789");
+  }
+  EventLoopTaskLog::RecordTask(longName, 1.0);
+
+  nsTArray<EventLoopTaskLog::Entry> tasks;
+  EventLoopTaskLog::GetLongTasks(tasks);
+  const EventLoopTaskLog::Entry& entry = tasks.LastElement();
+
+  // Truncated to the entry buffer, still null terminated.
+  EXPECT_EQ(sizeof(entry.mName) - 1, strlen(entry.mName));
+}
@@ -6,8 +6,10 @@
 #include "prio.h"
 #include "prsystem.h"
 
+#include "mozilla/FileUtils.h"
 #include "nsIFile.h"
 #include "nsString.h"
+#include "nsTArray.h"
 #include "nsDirectoryServiceDefs.h"
 #include "nsDirectoryServiceUtils.h"
 
@@ -476,3 +478,63 @@ TEST(TestFile, Tests)
   rv = base->Remove(true);
   VerifyResult(rv, "Cleaning up temp directory");
 }
+
+TEST(TestFile, StatChildrenBatch)
+{
+  nsCOMPtr<nsIFile> base;
+  nsresult rv = NS_GetSpecialDirectory(NS_OS_TEMP_DIR, getter_AddRefs(base));
+  ASSERT_TRUE(VerifyResult(rv, "Getting temp directory"));
+
+  rv = base->AppendNative(nsDependentCString("mozfilebatchtests"));
+  ASSERT_TRUE(VerifyResult(rv, "Appending mozfilebatchtests to temp directory name"));
+
+  // Remove the directory in case tests failed and left it behind.
+  // don't check result since it might not be there
+  base->Remove(true);
+
+  rv = base->Create(nsIFile::DIRECTORY_TYPE, 0700);
+  ASSERT_TRUE(VerifyResult(rv, "Creating temp directory"));
+
+  ASSERT_TRUE(TestCreate(base, "file.txt", nsIFile::NORMAL_FILE_TYPE, 0600));
+  ASSERT_TRUE(TestCreate(base, "subdir", nsIFile::DIRECTORY_TYPE, 0700));
+
+  nsTArray<nsCString> names;
+  names.AppendElement(NS_LITERAL_CSTRING("file.txt"));
+  names.AppendElement(NS_LITERAL_CSTRING("subdir"));
+  names.AppendElement(NS_LITERAL_CSTRING("missing.txt"));
+
+  nsTArray<mozilla::ChildFileAttributes> attrs;
+  rv = mozilla::StatChildrenBatch(base, names, attrs);
+  ASSERT_TRUE(VerifyResult(rv, "StatChildrenBatch"));
+  ASSERT_EQ(names.Length(), attrs.Length());
+
+  EXPECT_TRUE(attrs[0].mExists);
+  EXPECT_FALSE(attrs[0].mIsDirectory);
+
+  EXPECT_TRUE(attrs[1].mExists);
+  EXPECT_TRUE(attrs[1].mIsDirectory);
+
+  EXPECT_FALSE(attrs[2].mExists);
+  EXPECT_FALSE(attrs[2].mIsDirectory);
+  EXPECT_EQ(int64_t(0), attrs[2].mFileSize);
+
+  // The batch must agree with the per-child nsIFile answers.
+  nsCOMPtr<nsIFile> file = NewFile(base);
+  ASSERT_TRUE(file);
+  rv = file->AppendNative(nsDependentCString("file.txt"));
+  ASSERT_TRUE(VerifyResult(rv, "Appending file.txt"));
+
+  int64_t size = -1;
+  rv = file->GetFileSize(&size);
+  ASSERT_TRUE(VerifyResult(rv, "GetFileSize"));
+  EXPECT_EQ(size, attrs[0].mFileSize);
+
+  PRTime modTime = 0;
+  rv = file->GetLastModifiedTime(&modTime);
+  ASSERT_TRUE(VerifyResult(rv, "GetLastModifiedTime"));
+  EXPECT_EQ(modTime, attrs[0].mLastModifiedTime);
+
+  // Clean up temporary stuff
+  rv = base->Remove(true);
+  VerifyResult(rv, "Cleaning up temp directory");
+}
@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/MetadataHashTable.h"
+#include "mozilla/HashFunctions.h"
+#include "gtest/gtest.h"
+
+using namespace mozilla;
+
+namespace {
+
+struct IntEntry
+{
+  uint32_t mKey;
+  uint32_t mValue;
+
+  PLDHashNumber RehashKey() const { return HashGeneric(mKey); }
+};
+
+struct IntPolicy
+{
+  using Lookup = uint32_t;
+  static PLDHashNumber Hash(const Lookup& aKey) { return HashGeneric(aKey); }
+  static bool Match(const IntEntry& aEntry, const Lookup& aKey)
+  {
+    return aEntry.mKey == aKey;
+  }
+};
+
+using IntTable = MetadataHashTable<IntEntry, IntPolicy>;
+
+} // namespace
+
+TEST(MetadataHashTable, AddSearchRemove)
+{
+  IntTable table;
+  EXPECT_EQ(table.Count(), 0u);
+  EXPECT_FALSE(table.Search(42));
+
+  EXPECT_TRUE(table.AddNew(42, IntEntry{ 42, 1 }));
+  EXPECT_EQ(table.Count(), 1u);
+
+  IntEntry* entry = table.Search(42);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->mValue, 1u);
+
+  // Add replaces.
+  EXPECT_TRUE(table.Add(42, IntEntry{ 42, 2 }));
+  EXPECT_EQ(table.Count(), 1u);
+  EXPECT_EQ(table.Search(42)->mValue, 2u);
+
+  EXPECT_TRUE(table.Remove(42));
+  EXPECT_FALSE(table.Search(42));
+  EXPECT_FALSE(table.Remove(42));
+  EXPECT_EQ(table.Count(), 0u);
+}
+
+TEST(MetadataHashTable, GrowthAndIteration)
+{
+  const uint32_t kCount = 10000;
+
+  IntTable table;
+  for (uint32_t i = 0; i < kCount; i++) {
+    ASSERT_TRUE(table.AddNew(i, IntEntry{ i, i * 2 }));
+  }
+  EXPECT_EQ(table.Count(), kCount);
+
+  for (uint32_t i = 0; i < kCount; i++) {
+    IntEntry* entry = table.Search(i);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->mValue, i * 2);
+  }
+  EXPECT_FALSE(table.Search(kCount));
+
+  uint64_t keySum = 0;
+  table.ForEach([&](IntEntry& aEntry) { keySum += aEntry.mKey; });
+  EXPECT_EQ(keySum, uint64_t(kCount) * (kCount - 1) / 2);
+
+  // Remove every other entry and make sure probing still finds the rest.
+  for (uint32_t i = 0; i < kCount; i += 2) {
+    EXPECT_TRUE(table.Remove(i));
+  }
+  EXPECT_EQ(table.Count(), kCount / 2);
+  for (uint32_t i = 0; i < kCount; i++) {
+    EXPECT_EQ(!!table.Search(i), (i % 2) == 1);
+  }
+
+  table.Clear();
+  EXPECT_EQ(table.Count(), 0u);
+  EXPECT_FALSE(table.Search(1));
+}
@@ -441,6 +441,54 @@ TEST(Pipes, Blocking_128k)
   TestPipe2(128 * 1024);
 }
 
+TEST(Pipes, Small_Reads)
+{
+  // Reads that stop short of the end of the current segment complete on
+  // the lockless path in nsPipe::AdvanceReadCursor().  Interleave writes
+  // with reads smaller than the segment size and verify the stream
+  // contents survive the deferred cursor bookkeeping.
+  static const uint32_t segmentSize = 1024;
+  static const uint32_t totalBytes = 16 * 1024;
+  static const uint32_t readSize = 100; // deliberately not a divisor
+
+  nsCOMPtr<nsIInputStream> reader;
+  nsCOMPtr<nsIOutputStream> writer;
+  nsresult rv = NS_NewPipe(getter_AddRefs(reader), getter_AddRefs(writer),
+                           segmentSize, totalBytes,
+                           true, false); // non-blocking - reader, writer
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  nsTArray<char> inputData;
+  testing::CreateData(totalBytes, inputData);
+
+  nsAutoCString outputData;
+
+  uint32_t offset = 0;
+  while (offset < totalBytes) {
+    uint32_t numToWrite = std::min(segmentSize * 2, totalBytes - offset);
+    testing::Write(writer, inputData, offset, numToWrite);
+    offset += numToWrite;
+
+    char buffer[readSize];
+    for (;;) {
+      uint32_t numRead = 0;
+      rv = reader->Read(buffer, readSize, &numRead);
+      if (rv == NS_BASE_STREAM_WOULD_BLOCK || numRead == 0) {
+        break;
+      }
+      ASSERT_TRUE(NS_SUCCEEDED(rv));
+      outputData.Append(buffer, numRead);
+    }
+  }
+
+  rv = writer->Close();
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  nsDependentCSubstring inputString(inputData.Elements(), inputData.Length());
+  ASSERT_EQ(inputString.Length(), outputData.Length());
+  ASSERT_TRUE(inputString.Equals(outputData));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace {
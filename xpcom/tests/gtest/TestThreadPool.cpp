@@ -63,6 +63,38 @@ TEST(ThreadPool, Main)
   EXPECT_EQ(Task::sCount, 100);
 }
 
+TEST(ThreadPool, WorkStealing)
+{
+  nsCOMPtr<nsIThreadPool> pool = do_CreateInstance(NS_THREADPOOL_CONTRACTID);
+  EXPECT_TRUE(pool);
+
+  EXPECT_TRUE(NS_SUCCEEDED(pool->SetThreadLimit(8)));
+  EXPECT_TRUE(NS_SUCCEEDED(pool->SetUseWorkStealing(true)));
+
+  bool workStealing = false;
+  EXPECT_TRUE(NS_SUCCEEDED(pool->GetUseWorkStealing(&workStealing)));
+  EXPECT_TRUE(workStealing);
+
+  Task::sCount = 0;
+  for (int i = 0; i < 100; ++i) {
+    nsCOMPtr<nsIRunnable> task = new Task(i);
+    EXPECT_TRUE(task);
+
+    pool->Dispatch(task, NS_DISPATCH_NORMAL);
+  }
+
+  pool->Shutdown();
+  EXPECT_EQ(Task::sCount, 100);
+
+  // Once the pool has been used, the mode can no longer be changed.
+  nsCOMPtr<nsIThreadPool> pool2 = do_CreateInstance(NS_THREADPOOL_CONTRACTID);
+  EXPECT_TRUE(pool2);
+  nsCOMPtr<nsIRunnable> r = new Task(0);
+  pool2->Dispatch(r, NS_DISPATCH_NORMAL);
+  EXPECT_TRUE(NS_FAILED(pool2->SetUseWorkStealing(true)));
+  pool2->Shutdown();
+}
+
 TEST(ThreadPool, Parallelism)
 {
   nsCOMPtr<nsIThreadPool> pool = do_CreateInstance(NS_THREADPOOL_CONTRACTID);
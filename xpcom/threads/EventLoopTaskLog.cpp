@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=4 tw=99: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/EventLoopTaskLog.h"
+
+#include "MainThreadUtils.h"
+#include "mozilla/Logging.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/StaticMutex.h"
+#include "nsString.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace mozilla {
+
+static LazyLogModule gEventLoopLagLog("EventLoopLag");
+
+// The ring itself. Guarded by gTaskLogMutex; entries are only written for
+// tasks over the threshold, so the lock is rarely contended.
+static EventLoopTaskLog::Entry gTaskLog[EventLoopTaskLog::kEntryCount];
+// Total number of entries ever recorded; gTaskLog[gTaskLogIndex %
+// kEntryCount] is the slot the next entry goes into.
+static uint64_t gTaskLogIndex = 0;
+static StaticMutex gTaskLogMutex;
+
+static const char kThresholdPref[] = "threads.long_task_threshold_ms";
+
+/* static */ uint32_t
+EventLoopTaskLog::ThresholdMs()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  static uint32_t sThresholdMs = 0;
+  static bool sInitialized = false;
+  if (!sInitialized && Preferences::IsServiceAvailable()) {
+    sInitialized = true;
+    Preferences::AddUintVarCache(&sThresholdMs, kThresholdPref, 0);
+  }
+  return sThresholdMs;
+}
+
+/* static */ void
+EventLoopTaskLog::RecordTask(const nsACString& aName, double aRunMs)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  MOZ_LOG(gEventLoopLagLog, LogLevel::Warning,
+          ("Main thread task '%s' ran for %.2fms",
+           PromiseFlatCString(aName).get(), aRunMs));
+
+  StaticMutexAutoLock lock(gTaskLogMutex);
+  Entry& entry = gTaskLog[gTaskLogIndex % kEntryCount];
+  size_t length = std::min(size_t(aName.Length()), sizeof(entry.mName) - 1);
+  memcpy(entry.mName, aName.BeginReading(), length);
+  entry.mName[length] = '\0';
+  entry.mRunMs = aRunMs;
+  entry.mEnd = TimeStamp::Now();
+  gTaskLogIndex++;
+}
+
+/* static */ void
+EventLoopTaskLog::GetLongTasks(nsTArray<Entry>& aTasks)
+{
+  StaticMutexAutoLock lock(gTaskLogMutex);
+  uint64_t count = std::min(gTaskLogIndex, uint64_t(kEntryCount));
+  for (uint64_t i = gTaskLogIndex - count; i < gTaskLogIndex; i++) {
+    aTasks.AppendElement(gTaskLog[i % kEntryCount]);
+  }
+}
+
+} // namespace mozilla
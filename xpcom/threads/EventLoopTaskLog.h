@@ -0,0 +1,58 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=4 tw=99: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_EventLoopTaskLog_h
+#define mozilla_EventLoopTaskLog_h
+
+#include "mozilla/TimeStamp.h"
+#include "nsStringFwd.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+
+// A lightweight, always-on log of slow main-thread tasks. nsThread times
+// each event it runs once the watchdog is enabled and, when a task's run
+// time exceeds the threshold, records the runnable's name (from nsINamed)
+// and duration into a fixed-size ring. Unlike the nightly-only runnable
+// telemetry this works on release builds, so "the browser hung" field
+// reports can name a culprit; the native stack of a task that is *still*
+// running is the hang monitor's job, but by the time the lag is observable
+// here the task has finished, so the name and duration are what we can
+// usefully keep.
+//
+// All methods must be called on the main thread except GetLongTasks(),
+// which may be called from any thread.
+class EventLoopTaskLog
+{
+public:
+  struct Entry
+  {
+    // The runnable name, truncated to fit. Empty slots have mName[0] == 0.
+    char mName[64];
+    // Wall-clock run time of the task in milliseconds.
+    double mRunMs;
+    // When the task finished.
+    TimeStamp mEnd;
+  };
+
+  static const size_t kEntryCount = 64;
+
+  // The run-time threshold in milliseconds above which a task is logged,
+  // from the "threads.long_task_threshold_ms" pref. Zero disables the
+  // watchdog entirely, including the per-task timing in nsThread.
+  static uint32_t ThresholdMs();
+
+  // Record a task that ran for aRunMs milliseconds. Logs a warning through
+  // the "EventLoopLag" log module as well.
+  static void RecordTask(const nsACString& aName, double aRunMs);
+
+  // Export hook: appends the logged tasks, oldest first, to aTasks.
+  static void GetLongTasks(nsTArray<Entry>& aTasks);
+};
+
+} // namespace mozilla
+
+#endif // mozilla_EventLoopTaskLog_h
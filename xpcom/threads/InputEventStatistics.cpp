@@ -6,6 +6,8 @@
 
 #include "InputEventStatistics.h"
 
+#include <algorithm>
+
 #include "nsRefreshDriver.h"
 
 namespace mozilla {
@@ -43,12 +45,69 @@ InputEventStatistics::InputEventStatistics(ConstructorCookie&&)
 
   mMaxInputDuration = TimeDuration::FromMilliseconds(maxDuration);
   mMinInputDuration = TimeDuration::FromMilliseconds(minDuration);
+
+  uint32_t inputInterval =
+    Preferences::GetUint("input_event_queue.default_input_interval",
+                         sDefaultInputInterval);
+  mInputIntervalEstimate = TimeDuration::FromMilliseconds(inputInterval);
+}
+
+void
+InputEventStatistics::UpdateInputInterval(TimeStamp aNow)
+{
+  if (!mEnable) {
+    return;
+  }
+
+  if (!mLastInputTime.IsNull()) {
+    double intervalMs = (aNow - mLastInputTime).ToMilliseconds();
+    if (intervalMs <= sMaxTrackedInputInterval) {
+      // Stochastic approximation of the 75th percentile: step the estimate
+      // up by three units for a longer-than-estimate sample and down by one
+      // unit for a shorter one, so it converges where a quarter of the
+      // samples lie above it.
+      double estimateMs = mInputIntervalEstimate.ToMilliseconds();
+      if (intervalMs > estimateMs) {
+        estimateMs += 3 * sInputIntervalQuantileStep;
+      } else {
+        estimateMs -= sInputIntervalQuantileStep;
+      }
+      estimateMs = std::max(estimateMs, double(sInputIntervalQuantileStep));
+      estimateMs = std::min(estimateMs, double(sMaxTrackedInputInterval));
+      mInputIntervalEstimate = TimeDuration::FromMilliseconds(estimateMs);
+    }
+  }
+
+  mLastInputTime = aNow;
+}
+
+bool
+InputEventStatistics::ExpectingMoreInput(TimeStamp aNow)
+{
+  MOZ_ASSERT(mEnable);
+
+  if (mLastInputTime.IsNull()) {
+    return false;
+  }
+
+  // Bursts aren't perfectly periodic, so allow twice the estimated interval
+  // before concluding that the burst has ended.
+  return (aNow - mLastInputTime).ToMilliseconds() <=
+         mInputIntervalEstimate.ToMilliseconds() * 2;
 }
 
 TimeStamp
 InputEventStatistics::GetInputHandlingStartTime(uint32_t aInputCount)
 {
   MOZ_ASSERT(mEnable);
+
+  if (!ExpectingMoreInput(TimeStamp::Now())) {
+    // The learned inter-input interval says the burst has likely ended, so
+    // there is nothing more to batch into the frame; waiting for the next
+    // tick would only add queueing latency. Process the input immediately.
+    return TimeStamp::Now() - TimeDuration::FromMilliseconds(1);
+  }
+
   Maybe<TimeStamp> nextTickHint = nsRefreshDriver::GetNextTickHint();
 
   if (nextTickHint.isNothing()) {
@@ -30,6 +30,19 @@ class InputEventStatistics
   static const uint16_t sMaxReservedTimeForHandlingInput = 8;
   static const uint16_t sMinReservedTimeForHandlingInput = 1;
 
+  // The default estimate (milliseconds) of the interval between input events
+  // within a burst, roughly one frame of a continuous mouse move or scroll.
+  static const uint16_t sDefaultInputInterval = 16;
+
+  // Inter-input intervals longer than this (milliseconds) mean the previous
+  // burst ended; they say nothing about spacing within a burst, so we don't
+  // learn from them.
+  static const uint16_t sMaxTrackedInputInterval = 250;
+
+  // Step size (milliseconds) for the quantile estimate of the inter-input
+  // interval.
+  static const uint16_t sInputIntervalQuantileStep = 1;
+
   class TimeDurationCircularBuffer
   {
     int16_t mSize;
@@ -64,8 +77,19 @@ class InputEventStatistics
   UniquePtr<TimeDurationCircularBuffer> mLastInputDurations;
   TimeDuration mMaxInputDuration;
   TimeDuration mMinInputDuration;
+
+  // Learned estimate of the 75th percentile of the interval between input
+  // events within a burst, and the time the last input event was enqueued.
+  // Protected by the event queue mutex, like the duration buffer above.
+  TimeDuration mInputIntervalEstimate;
+  TimeStamp mLastInputTime;
+
   bool mEnable;
 
+  // Returns true if, given the learned inter-input interval, another input
+  // event is likely to arrive soon after aNow.
+  bool ExpectingMoreInput(TimeStamp aNow);
+
   // We'd like to have our constructor and destructor be private to enforce our
   // singleton, but because UniquePtr needs to be able to destruct our class we
   // can't. This is a trick that ensures that we're the only code that can
@@ -99,6 +123,10 @@ public:
 
   TimeStamp GetInputHandlingStartTime(uint32_t aInputCount);
 
+  // Called when an input event is enqueued, to learn the inter-input interval
+  // online. Must be called under the same lock as GetInputHandlingStartTime.
+  void UpdateInputInterval(TimeStamp aNow);
+
   void SetEnable(bool aEnable)
   {
     mEnable = aEnable;
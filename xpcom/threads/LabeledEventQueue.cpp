@@ -140,6 +140,36 @@ LabeledEventQueue::NextSchedulerGroup(SchedulerGroup* aGroup)
   return result;
 }
 
+already_AddRefed<nsIRunnable>
+LabeledEventQueue::TakeEventFromGroup(SchedulerGroup* aGroup,
+                                      RunnableEpochQueue* aQueue)
+{
+  MOZ_ASSERT(mLabeled.Get(aGroup) == aQueue);
+
+  sCurrentSchedulerGroup = NextSchedulerGroup(aGroup);
+
+  PopEpoch();
+
+  if (aGroup->DequeueEvent() == SchedulerGroup::NoLongerQueued) {
+    // Now we can take group out of sSchedulerGroups.
+    if (sCurrentSchedulerGroup == aGroup) {
+      // Since we changed sCurrentSchedulerGroup above, we'll only get here
+      // if |aGroup| was the only element in sSchedulerGroups. In that case
+      // set sCurrentSchedulerGroup to null.
+      MOZ_ASSERT(aGroup->getNext() == nullptr);
+      MOZ_ASSERT(aGroup->getPrevious() == nullptr);
+      sCurrentSchedulerGroup = nullptr;
+    }
+    aGroup->removeFrom(*sSchedulerGroups);
+  }
+
+  QueueEntry entry = aQueue->Pop();
+  if (aQueue->IsEmpty()) {
+    mLabeled.Remove(aGroup);
+  }
+  return entry.mRunnable.forget();
+}
+
 already_AddRefed<nsIRunnable>
 LabeledEventQueue::GetEvent(EventPriority* aPriority,
                             const MutexAutoLock& aProofOfLock)
@@ -192,8 +222,12 @@ LabeledEventQueue::GetEvent(EventPriority* aPriority,
   }
 
   // Iterate over each SchedulerGroup once, starting at sCurrentSchedulerGroup.
+  // A background group that has exhausted its run budget is passed over on the
+  // first encounter; we remember it so that it still runs if no other group
+  // has a ready event (over-budget groups must not be starved outright).
   SchedulerGroup* firstGroup = sCurrentSchedulerGroup;
   SchedulerGroup* group = firstGroup;
+  SchedulerGroup* deferredGroup = nullptr;
   do {
     mAvoidActiveTabCount--;
 
@@ -208,32 +242,22 @@ LabeledEventQueue::GetEvent(EventPriority* aPriority,
     QueueEntry entry = queue->FirstElement();
     if (entry.mEpochNumber == epoch.mEpochNumber &&
         IsReadyToRun(entry.mRunnable, group)) {
-      sCurrentSchedulerGroup = NextSchedulerGroup(group);
-
-      PopEpoch();
-
-      if (group->DequeueEvent() == SchedulerGroup::NoLongerQueued) {
-        // Now we can take group out of sSchedulerGroups.
-        if (sCurrentSchedulerGroup == group) {
-          // Since we changed sCurrentSchedulerGroup above, we'll only get here
-          // if |group| was the only element in sSchedulerGroups. In that case
-          // set sCurrentSchedulerGroup to null.
-          MOZ_ASSERT(group->getNext() == nullptr);
-          MOZ_ASSERT(group->getPrevious() == nullptr);
-          sCurrentSchedulerGroup = nullptr;
+      if (group->IsOverRunBudget()) {
+        if (!deferredGroup) {
+          deferredGroup = group;
         }
-        group->removeFrom(*sSchedulerGroups);
+      } else {
+        return TakeEventFromGroup(group, queue);
       }
-      queue->Pop();
-      if (queue->IsEmpty()) {
-        mLabeled.Remove(group);
-      }
-      return entry.mRunnable.forget();
     }
 
     group = NextSchedulerGroup(group);
   } while (group != firstGroup);
 
+  if (deferredGroup) {
+    return TakeEventFromGroup(deferredGroup, mLabeled.Get(deferredGroup));
+  }
+
   return nullptr;
 }
 
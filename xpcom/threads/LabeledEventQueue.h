@@ -132,6 +132,13 @@ private:
   static SchedulerGroup* NextSchedulerGroup(SchedulerGroup* aGroup);
 
   using RunnableEpochQueue = Queue<QueueEntry, 32>;
+
+  // Removes the event at the head of aGroup's queue (which must be aQueue)
+  // and updates the queue bookkeeping, advancing sCurrentSchedulerGroup past
+  // aGroup.
+  already_AddRefed<nsIRunnable> TakeEventFromGroup(SchedulerGroup* aGroup,
+                                                   RunnableEpochQueue* aQueue);
+
   using LabeledMap = nsClassHashtable<nsRefPtrHashKey<SchedulerGroup>, RunnableEpochQueue>;
   using EpochQueue = Queue<Epoch, 8>;
 
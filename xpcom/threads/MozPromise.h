@@ -368,52 +368,61 @@ protected:
   /*
    * A ThenValue tracks a single consumer waiting on the promise. When a consumer
    * invokes promise->Then(...), a ThenValue is created. Once the Promise is
-   * resolved or rejected, a {Resolve,Reject}Runnable is dispatched, which
-   * invokes the resolve/reject method and then deletes the ThenValue.
+   * resolved or rejected, the ThenValue itself is dispatched to the response
+   * target as a runnable, which invokes the resolve/reject method. Acting as
+   * its own runnable avoids allocating a separate runnable object for every
+   * resolution.
    */
   class ThenValueBase : public Request
+                      , public nsIRunnable
+                      , public nsICancelableRunnable
   {
     friend class MozPromise;
     static const uint32_t sMagic = 0xfadece11;
 
   public:
-    class ResolveOrRejectRunnable : public CancelableRunnable
+    // We can't use NS_DECL_THREADSAFE_ISUPPORTS here, because the refcount
+    // lives in MozPromiseRefcountable (via Request). Forward AddRef/Release
+    // to it and hand-roll QueryInterface for the runnable interfaces.
+    NS_IMETHOD_(MozExternalRefCountType) AddRef() override
     {
-    public:
-      ResolveOrRejectRunnable(ThenValueBase* aThenValue, MozPromise* aPromise)
-        : CancelableRunnable(
-            "MozPromise::ThenValueBase::ResolveOrRejectRunnable")
-        , mThenValue(aThenValue)
-        , mPromise(aPromise)
-      {
-        MOZ_DIAGNOSTIC_ASSERT(!mPromise->IsPending());
-      }
+      return Request::AddRef();
+    }
 
-      ~ResolveOrRejectRunnable()
-      {
-        if (mThenValue) {
-          mThenValue->AssertIsDead();
-        }
-      }
+    NS_IMETHOD_(MozExternalRefCountType) Release() override
+    {
+      return Request::Release();
+    }
 
-      NS_IMETHOD Run() override
-      {
-        PROMISE_LOG("ResolveOrRejectRunnable::Run() [this=%p]", this);
-        mThenValue->DoResolveOrReject(mPromise->Value());
-        mThenValue = nullptr;
-        mPromise = nullptr;
-        return NS_OK;
+    NS_IMETHOD QueryInterface(REFNSIID aIID, void** aInstancePtr) override
+    {
+      MOZ_ASSERT(aInstancePtr);
+      if (aIID.Equals(NS_GET_IID(nsIRunnable)) ||
+          aIID.Equals(NS_GET_IID(nsISupports))) {
+        *aInstancePtr = static_cast<nsIRunnable*>(this);
+      } else if (aIID.Equals(NS_GET_IID(nsICancelableRunnable))) {
+        *aInstancePtr = static_cast<nsICancelableRunnable*>(this);
+      } else {
+        *aInstancePtr = nullptr;
+        return NS_ERROR_NO_INTERFACE;
       }
+      AddRef();
+      return NS_OK;
+    }
 
-      nsresult Cancel() override
-      {
-        return Run();
-      }
+    NS_IMETHOD Run() override
+    {
+      PROMISE_ASSERT(mMagic1 == sMagic && mMagic2 == sMagic);
+      PROMISE_LOG("ThenValueBase::Run() [this=%p]", this);
+      RefPtr<MozPromise> promise = mPromise.forget();
+      DoResolveOrReject(promise->Value());
+      return NS_OK;
+    }
 
-    private:
-      RefPtr<ThenValueBase> mThenValue;
-      RefPtr<MozPromise> mPromise;
-    };
+    nsresult Cancel() override
+    {
+      return Run();
+    }
 
     ThenValueBase(nsISerialEventTarget* aResponseTarget,
                   const char* aCallSite)
@@ -454,15 +463,19 @@ protected:
       aPromise->mMutex.AssertCurrentThreadOwns();
       MOZ_ASSERT(!aPromise->IsPending());
 
-      nsCOMPtr<nsIRunnable> r = new ResolveOrRejectRunnable(this, aPromise);
-      PROMISE_LOG("%s Then() call made from %s [Runnable=%p, Promise=%p, ThenValue=%p]",
+      // Hold the promise alive (and its value with it) until Run() consumes
+      // it, then dispatch ourselves directly rather than allocating a
+      // dedicated runnable for the delivery.
+      mPromise = aPromise;
+      PROMISE_LOG("%s Then() call made from %s [Promise=%p, ThenValue=%p]",
                   aPromise->mValue.IsResolve() ? "Resolving" : "Rejecting", mCallSite,
-                  r.get(), aPromise, this);
+                  aPromise, this);
 
       // Promise consumers are allowed to disconnect the Request object and
       // then shut down the thread or task queue that the promise result would
       // be dispatched on. So we unfortunately can't assert that promise
       // dispatch succeeds. :-(
+      nsCOMPtr<nsIRunnable> r = this;
       mResponseTarget->Dispatch(r.forget());
     }
 
@@ -498,6 +511,9 @@ protected:
     }
 
     nsCOMPtr<nsISerialEventTarget> mResponseTarget; // May be released on any thread.
+    // Set (under the promise mutex) when this ThenValue is dispatched to
+    // mResponseTarget, and consumed by Run().
+    RefPtr<MozPromise> mPromise;
 #ifdef PROMISE_DEBUG
     uint32_t mMagic1 = sMagic;
 #endif
@@ -1060,7 +1076,8 @@ protected:
     PROMISE_LOG("MozPromise::~MozPromise [this=%p]", this);
     AssertIsDead();
     // We can't guarantee a completion promise will always be revolved or
-    // rejected since ResolveOrRejectRunnable might not run when dispatch fails.
+    // rejected since the dispatched ThenValue might not run when dispatch
+    // fails.
     if (!mIsCompletionPromise) {
       MOZ_ASSERT(!IsPending());
       MOZ_ASSERT(mThenValues.IsEmpty());
@@ -57,6 +57,10 @@ PrioritizedEventQueue<InnerQueueT>::PutEvent(already_AddRefed<nsIRunnable>&& aEv
     mHighQueue->PutEvent(event.forget(), priority, aProofOfLock);
     break;
   case EventPriority::Input:
+    // Feed the inter-input interval tracker so the input anticipation
+    // window adapts to the observed input rate. The queue mutex serializes
+    // this with GetInputHandlingStartTime.
+    InputEventStatistics::Get().UpdateInputInterval(TimeStamp::Now());
     mInputQueue->PutEvent(event.forget(), priority, aProofOfLock);
     break;
   case EventPriority::Normal:
@@ -136,7 +140,8 @@ PrioritizedEventQueue<InnerQueueT>::SelectQueue(bool aUpdateState,
   // at the wrong time.
   //
   // HIGH: if mProcessHighPriorityQueue
-  // INPUT: if inputCount > 0 && TimeStamp::Now() > mInputHandlingStartTime
+  // INPUT: if inputCount == 1, or if inputCount > 0 &&
+  //        TimeStamp::Now() > mInputHandlingStartTime
   // NORMAL: if normalPending
   //
   // If we still don't have an event, then we take events from the queues
@@ -156,7 +161,12 @@ PrioritizedEventQueue<InnerQueueT>::SelectQueue(bool aUpdateState,
     queue = EventPriority::High;
   } else if (inputCount > 0 && (mInputQueueState == STATE_FLUSHING ||
                                 (mInputQueueState == STATE_ENABLED &&
-                                 TimeStamp::Now() > mInputHandlingStartTime))) {
+                                 (inputCount == 1 ||
+                                  TimeStamp::Now() > mInputHandlingStartTime)))) {
+    // Deferring input handling toward the next refresh tick only pays off
+    // for a stream of input events that can be batched into the frame. A
+    // lone pending event is the discrete case (a click or a key press),
+    // where the deferral just adds queueing latency, so handle it now.
     queue = EventPriority::Input;
   } else if (normalPending) {
     MOZ_ASSERT(mInputQueueState != STATE_FLUSHING,
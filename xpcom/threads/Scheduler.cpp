@@ -614,6 +614,7 @@ Scheduler::EventLoopActivation::SetEvent(nsIRunnable* aEvent,
   mProcessingEvent = aEvent != nullptr;
 
   if (aEvent) {
+    mEventStart = TimeStamp::Now();
     SchedulerImpl::StartEvent(*this);
   }
 }
@@ -778,6 +779,30 @@ Scheduler::Yield()
   sScheduler->Yield();
 }
 
+/* static */ bool
+Scheduler::ShouldYield()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  EventLoopActivation* activation = EventLoopActivation::Current();
+  if (!activation) {
+    return false;
+  }
+
+  TimeStamp start = activation->EventStart();
+  if (start.IsNull()) {
+    return false;
+  }
+
+  if ((TimeStamp::Now() - start).ToMilliseconds() <
+      SchedulerGroup::kRunBudgetMs) {
+    return false;
+  }
+
+  // Only worth yielding if there's something else to run.
+  return NS_HasPendingEvents();
+}
+
 /* static */ bool
 Scheduler::UnlabeledEventRunning()
 {
@@ -11,6 +11,7 @@
 #include "mozilla/EventQueue.h"
 #include "mozilla/RefPtr.h"
 #include "mozilla/ThreadLocal.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/UniquePtr.h"
 #include "nsTArray.h"
 #include "nsILabelableRunnable.h"
@@ -71,6 +72,14 @@ public:
 
   static void Yield();
 
+  // Returns true when a long-running event should stop and let the rest of
+  // the queue run. This is the case when the current event has been running
+  // for longer than SchedulerGroup::kRunBudgetMs and other events are
+  // pending. Long runnables that have natural interruption points should
+  // poll this and, when it returns true, return early after re-dispatching a
+  // continuation for their remaining work. Main thread only.
+  static bool ShouldYield();
+
   static bool UnlabeledEventRunning();
   static bool AnyEventRunning();
 
@@ -91,12 +100,23 @@ public:
     bool IsLabeled() { return mIsLabeled; }
     EventGroups& EventGroupsAffected() { return mEventGroups; }
 
+    // When the current thread's innermost activation is processing an event,
+    // returns the time that event started running. Otherwise returns a null
+    // TimeStamp.
+    TimeStamp EventStart() const
+    {
+      return mProcessingEvent ? mEventStart : TimeStamp();
+    }
+
+    static EventLoopActivation* Current() { return sTopActivation.get(); }
+
   private:
     EventLoopActivation* mPrev;
     bool mProcessingEvent;
     bool mIsLabeled;
     EventGroups mEventGroups;
     EventPriority mPriority;
+    TimeStamp mEventStart;
 
     static MOZ_THREAD_LOCAL(EventLoopActivation*) sTopActivation;
   };
@@ -350,6 +350,34 @@ SchedulerGroup::SetValidatingAccess(ValidationType aType)
   js::EnableAccessValidation(jsapi.cx(), validating);
 }
 
+void
+SchedulerGroup::AddRunTime(TimeDuration aDuration)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  TimeStamp now = TimeStamp::Now();
+  if (mRunWindowStart.IsNull() ||
+      (now - mRunWindowStart).ToMilliseconds() > kRunWindowMs) {
+    mRunWindowStart = now;
+    mRunTimeInWindow = TimeDuration();
+  }
+  mRunTimeInWindow += aDuration;
+}
+
+bool
+SchedulerGroup::IsOverRunBudget() const
+{
+  if (!IsBackground()) {
+    return false;
+  }
+  if (mRunWindowStart.IsNull() ||
+      (TimeStamp::Now() - mRunWindowStart).ToMilliseconds() > kRunWindowMs) {
+    // The window has expired, so the group gets a fresh budget.
+    return false;
+  }
+  return mRunTimeInWindow.ToMilliseconds() > kRunBudgetMs;
+}
+
 SchedulerGroup::Runnable::Runnable(already_AddRefed<nsIRunnable>&& aRunnable,
                                    SchedulerGroup* aGroup)
   : mozilla::Runnable("SchedulerGroup::Runnable")
@@ -389,12 +417,14 @@ SchedulerGroup::Runnable::Run()
 
   nsresult result;
 
+  TimeStamp start = TimeStamp::Now();
   {
 #ifdef EARLY_BETA_OR_EARLIER
     AutoCollectVsyncTelemetry telemetry(this);
 #endif
     result = mRunnable->Run();
   }
+  mGroup->AddRunTime(TimeStamp::Now() - start);
 
   // The runnable's destructor can have side effects, so try to execute it in
   // the scope of the TabGroup.
@@ -52,6 +52,22 @@ public:
   // "background" state.
   virtual bool IsBackground() const { return false; }
 
+  // The run budget bounds how much main thread time a background group can
+  // consume while other groups have work queued: a background group that has
+  // run for more than kRunBudgetMs within the last kRunWindowMs is passed
+  // over by LabeledEventQueue as long as some other group has a runnable
+  // event. Foreground groups are never throttled.
+  static const uint32_t kRunWindowMs = 100;
+  static const uint32_t kRunBudgetMs = 50;
+
+  // Charges aDuration of main thread execution time to this group. Called by
+  // SchedulerGroup::Runnable after running the underlying runnable.
+  void AddRunTime(TimeDuration aDuration);
+
+  // Returns true if this group is in the background and has exhausted its
+  // run budget for the current window.
+  bool IsOverRunBudget() const;
+
   // This function returns true if it's currently safe to run code associated
   // with this SchedulerGroup. It will return true either if we're inside an
   // unlabeled runnable or if we're inside a runnable labeled with this
@@ -201,6 +217,12 @@ protected:
   // (across all queues).
   size_t mEventCount = 0;
 
+  // Run budget accounting, only touched on the main thread. mRunWindowStart
+  // is the beginning of the current accounting window; mRunTimeInWindow is
+  // how much execution time this group has been charged within it.
+  TimeStamp mRunWindowStart;
+  TimeDuration mRunTimeInWindow;
+
   nsCOMPtr<nsISerialEventTarget> mEventTargets[size_t(TaskCategory::Count)];
   RefPtr<AbstractThread> mAbstractThreads[size_t(TaskCategory::Count)];
 };
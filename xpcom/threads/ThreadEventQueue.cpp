@@ -47,11 +47,64 @@ private:
   RefPtr<ThreadEventQueue> mOwner;
 };
 
+template<class InnerQueueT>
+ThreadEventQueue<InnerQueueT>::MPSCInbox::MPSCInbox()
+{
+  // Start out with a stub node so that push and pop never race over an empty
+  // list.
+  Node* stub = new Node();
+  mHead = stub;
+  mTail = stub;
+}
+
+template<class InnerQueueT>
+ThreadEventQueue<InnerQueueT>::MPSCInbox::~MPSCInbox()
+{
+  Node* node = mTail;
+  while (node) {
+    Node* next = node->mNext;
+    delete node;
+    node = next;
+  }
+}
+
+template<class InnerQueueT>
+void
+ThreadEventQueue<InnerQueueT>::MPSCInbox::Push(already_AddRefed<nsIRunnable> aEvent)
+{
+  Node* node = new Node(Move(aEvent));
+  Node* prev = mHead.exchange(node);
+  // Between the exchange above and the store below the list is briefly
+  // broken; the consumer simply observes an empty inbox until the store
+  // lands, and the sleeping handshake in PutEventInternal runs after this
+  // store, so no wakeup is lost.
+  prev->mNext = node;
+}
+
+template<class InnerQueueT>
+already_AddRefed<nsIRunnable>
+ThreadEventQueue<InnerQueueT>::MPSCInbox::Pop()
+{
+  Node* tail = mTail;
+  Node* next = tail->mNext;
+  if (!next) {
+    return nullptr;
+  }
+  nsCOMPtr<nsIRunnable> event = next->mEvent.forget();
+  mTail = next;
+  delete tail;
+  return event.forget();
+}
+
 template<class InnerQueueT>
 ThreadEventQueue<InnerQueueT>::ThreadEventQueue(UniquePtr<InnerQueueT> aQueue)
   : mBaseQueue(Move(aQueue))
   , mLock("ThreadEventQueue")
   , mEventsAvailable(mLock, "EventsAvail")
+  , mInboxPushers(0)
+  , mInboxDoomed(false)
+  , mConsumerSleeping(false)
+  , mHasObserver(false)
 {
   static_assert(IsBaseOf<AbstractEventQueue, InnerQueueT>::value,
                 "InnerQueueT must be an AbstractEventQueue subclass");
@@ -82,6 +135,32 @@ ThreadEventQueue<InnerQueueT>::PutEventInternal(already_AddRefed<nsIRunnable>&&
   LeakRefPtr<nsIRunnable> event(Move(aEvent));
   nsCOMPtr<nsIThreadObserver> obs;
 
+  // Fast path: normal-priority dispatches from other threads can go through
+  // the lock-free inbox as long as nothing needs the lock-protected state.
+  // An observer must see OnDispatchedEvent for every dispatch, so the fast
+  // path is disabled while one is installed. Nested queues do not matter
+  // here: dispatches to the thread target land in mBaseQueue regardless,
+  // which is exactly where the inbox drains to.
+  if (!aSink && aPriority == EventPriority::Normal && !mHasObserver &&
+      !mInboxDoomed) {
+    ++mInboxPushers;
+    // Recheck now that shutdown can see us; ShutdownIfNoPendingEvents dooms
+    // the inbox first and then waits for mInboxPushers to drop to zero.
+    if (!mInboxDoomed && !mHasObserver) {
+      mInbox.Push(event.take());
+      --mInboxPushers;
+      // The push above is visible before this read, and GetEvent sets
+      // mConsumerSleeping before rechecking the inbox, so one side always
+      // sees the other and the wakeup cannot be lost.
+      if (mConsumerSleeping) {
+        MutexAutoLock lock(mLock);
+        mEventsAvailable.Notify();
+      }
+      return true;
+    }
+    --mInboxPushers;
+  }
+
   {
     MutexAutoLock lock(mLock);
 
@@ -115,6 +194,18 @@ ThreadEventQueue<InnerQueueT>::PutEventInternal(already_AddRefed<nsIRunnable>&&
   return true;
 }
 
+template<class InnerQueueT>
+bool
+ThreadEventQueue<InnerQueueT>::DrainInbox(const MutexAutoLock& aProofOfLock)
+{
+  bool drained = false;
+  while (nsCOMPtr<nsIRunnable> event = mInbox.Pop()) {
+    mBaseQueue->PutEvent(event.forget(), EventPriority::Normal, aProofOfLock);
+    drained = true;
+  }
+  return drained;
+}
+
 template<class InnerQueueT>
 already_AddRefed<nsIRunnable>
 ThreadEventQueue<InnerQueueT>::GetEvent(bool aMayWait,
@@ -124,6 +215,8 @@ ThreadEventQueue<InnerQueueT>::GetEvent(bool aMayWait,
 
   nsCOMPtr<nsIRunnable> event;
   for (;;) {
+    DrainInbox(lock);
+
     if (mNestedQueues.IsEmpty()) {
       event = mBaseQueue->GetEvent(aPriority, lock);
     } else {
@@ -136,7 +229,15 @@ ThreadEventQueue<InnerQueueT>::GetEvent(bool aMayWait,
       break;
     }
 
-    mEventsAvailable.Wait();
+    // Announce that we are about to sleep and then look at the inbox one
+    // last time. PutEventInternal pushes before checking mConsumerSleeping,
+    // so either we see the event here or the producer sees the flag and
+    // notifies us.
+    mConsumerSleeping = true;
+    if (!DrainInbox(lock)) {
+      mEventsAvailable.Wait();
+    }
+    mConsumerSleeping = false;
   }
 
   return event.forget();
@@ -148,6 +249,8 @@ ThreadEventQueue<InnerQueueT>::HasPendingEvent()
 {
   MutexAutoLock lock(mLock);
 
+  DrainInbox(lock);
+
   // We always get events from the topmost queue when there are nested queues.
   if (mNestedQueues.IsEmpty()) {
     return mBaseQueue->HasReadyEvent(lock);
@@ -161,10 +264,21 @@ bool
 ThreadEventQueue<InnerQueueT>::ShutdownIfNoPendingEvents()
 {
   MutexAutoLock lock(mLock);
+
+  // Close the lock-free inbox first and wait for any producer that already
+  // passed the doom check to finish its push, then pull whatever landed in
+  // the inbox into the base queue so it counts as a pending event.
+  mInboxDoomed = true;
+  while (mInboxPushers > 0) {
+    PR_Sleep(PR_INTERVAL_NO_WAIT);
+  }
+  DrainInbox(lock);
+
   if (mNestedQueues.IsEmpty() && mBaseQueue->IsEmpty(lock)) {
     mEventsAreDoomed = true;
     return true;
   }
+  mInboxDoomed = false;
   return false;
 }
 
@@ -265,6 +379,21 @@ ThreadEventQueue<InnerQueueT>::SetObserver(nsIThreadObserver* aObserver)
 {
   MutexAutoLock lock(mLock);
   mObserver = aObserver;
+  mHasObserver = !!aObserver;
+  if (aObserver) {
+    // Close the fast path before the observer takes effect, mirroring
+    // ShutdownIfNoPendingEvents: wait out any producer that already passed
+    // the mHasObserver check (it either pushed before we looked or will
+    // recheck and take the locked path), then move whatever landed in the
+    // inbox into the base queue. Otherwise an already-pushed event would be
+    // appended behind a later locked-path dispatch from the same producer,
+    // inverting same-producer FIFO order, and a racing push could complete
+    // without the observer ever seeing OnDispatchedEvent for it.
+    while (mInboxPushers > 0) {
+      PR_Sleep(PR_INTERVAL_NO_WAIT);
+    }
+    DrainInbox(lock);
+  }
 }
 
 namespace mozilla {
@@ -8,6 +8,7 @@
 #define mozilla_ThreadEventQueue_h
 
 #include "mozilla/AbstractEventQueue.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/CondVar.h"
 #include "mozilla/SynchronizedEventQueue.h"
 #include "nsCOMPtr.h"
@@ -86,12 +87,56 @@ public:
 private:
   class NestedSink;
 
+  // A lock-free multi-producer/single-consumer inbox (Vyukov-style
+  // intrusive list with a stub node) that normal-priority cross-thread
+  // dispatches are pushed onto without taking mLock. The consumer drains
+  // the inbox into mBaseQueue, under mLock, whenever it looks at the
+  // queue. Relative ordering of events from a single producer is
+  // preserved; ordering between producers is unspecified, as it already
+  // is for lock-based dispatch.
+  class MPSCInbox
+  {
+  public:
+    MPSCInbox();
+    ~MPSCInbox();
+
+    // May be called from any thread.
+    void Push(already_AddRefed<nsIRunnable> aEvent);
+
+    // Must only be called by the single consumer.
+    already_AddRefed<nsIRunnable> Pop();
+
+  private:
+    struct Node
+    {
+      explicit Node(already_AddRefed<nsIRunnable> aEvent)
+        : mNext(nullptr)
+        , mEvent(aEvent)
+      {}
+      Node()
+        : mNext(nullptr)
+      {}
+
+      Atomic<Node*, ReleaseAcquire> mNext;
+      nsCOMPtr<nsIRunnable> mEvent;
+    };
+
+    // The push end; producers exchange themselves in.
+    Atomic<Node*> mHead;
+    // The pop end; owned by the consumer.
+    Node* mTail;
+  };
+
   virtual ~ThreadEventQueue();
 
   bool PutEventInternal(already_AddRefed<nsIRunnable>&& aEvent,
                         EventPriority aPriority,
                         NestedSink* aQueue);
 
+  // Moves everything in mInbox into mBaseQueue. Returns true if at least one
+  // event was moved. Must be called on the consumer thread.
+  bool DrainInbox(const MutexAutoLock& aProofOfLock);
+
   UniquePtr<InnerQueueT> mBaseQueue;
 
   struct NestedQueueItem
@@ -111,6 +156,19 @@ private:
   Mutex mLock;
   CondVar mEventsAvailable;
 
+  MPSCInbox mInbox;
+  // The number of producers currently inside MPSCInbox::Push. Shutdown waits
+  // for this to hit zero after dooming the inbox so that no push can be lost.
+  Atomic<uint32_t> mInboxPushers;
+  // Mirrors mEventsAreDoomed for the lock-free dispatch path.
+  Atomic<bool> mInboxDoomed;
+  // True while the consumer is (about to be) blocked in GetEvent. Producers
+  // only take mLock to notify mEventsAvailable when this is set.
+  Atomic<bool> mConsumerSleeping;
+  // Mirrors whether mObserver is non-null; an observer must be told about
+  // every dispatch, which requires the slow path.
+  Atomic<bool> mHasObserver;
+
   bool mEventsAreDoomed = false;
   nsCOMPtr<nsIThreadObserver> mObserver;
 };
@@ -13,6 +13,7 @@
 #include "nsThreadSyncDispatch.h"
 #include "nsThreadUtils.h"
 #include "nsXPCOMPrivate.h" // for gXPCOMThreadsShutDown
+#include "ProfilerCounters.h"
 
 #ifdef MOZ_TASK_TRACER
 #include "GeckoTaskTracer.h"
@@ -137,6 +138,11 @@ ThreadEventTarget::Dispatch(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlag
     return NS_ERROR_ILLEGAL_DURING_SHUTDOWN;
   }
 
+  PROFILER_COUNTER_ADD(ProfilerCounterID::EventLoopDispatches, 1);
+  if (mIsMainThread) {
+    PROFILER_COUNTER_ADD(ProfilerCounterID::MainThreadDispatches, 1);
+  }
+
 #ifdef MOZ_TASK_TRACER
   nsCOMPtr<nsIRunnable> tracedRunnable = CreateTracedRunnable(event.take());
   (static_cast<TracedRunnable*>(tracedRunnable.get()))->DispatchTask();
@@ -64,15 +64,20 @@ class ThrottledEventQueue::Inner final : public nsIObserver
   // we only execute one event at a time we just re-use a single instance
   // of this class while there are events left in the queue.
   class Executor final : public Runnable
+                       , public nsIRunnablePriority
   {
     RefPtr<Inner> mInner;
 
+    ~Executor() = default;
+
   public:
     explicit Executor(Inner* aInner)
       : Runnable("ThrottledEventQueue::Inner::Executor")
       , mInner(aInner)
     { }
 
+    NS_DECL_ISUPPORTS_INHERITED
+
     NS_IMETHODIMP
     Run() override
     {
@@ -80,6 +85,12 @@ class ThrottledEventQueue::Inner final : public nsIObserver
       return NS_OK;
     }
 
+    NS_IMETHODIMP
+    GetPriority(uint32_t* aPriority) override
+    {
+      return mInner->CurrentPriority(aPriority);
+    }
+
     NS_IMETHODIMP
     GetName(nsACString& aName) override
     {
@@ -102,11 +113,17 @@ class ThrottledEventQueue::Inner final : public nsIObserver
   // any thread, protected by mutex
   bool mShutdownStarted;
 
+  // The priority of the event the pending executor was dispatched for.
+  // Atomic rather than mutex-protected because the base target reads it
+  // synchronously from Dispatch, while we hold the mutex.
+  Atomic<uint32_t, Relaxed> mExecutorPriority;
+
   explicit Inner(nsISerialEventTarget* aBaseTarget)
     : mMutex("ThrottledEventQueue")
     , mIdleCondVar(mMutex, "ThrottledEventQueue:Idle")
     , mBaseTarget(aBaseTarget)
     , mShutdownStarted(false)
+    , mExecutorPriority(nsIRunnablePriority::PRIORITY_NORMAL)
   {
   }
 
@@ -145,6 +162,28 @@ class ThrottledEventQueue::Inner final : public nsIObserver
     return NS_OK;
   }
 
+  static uint32_t
+  PriorityOf(nsIRunnable* aEvent)
+  {
+    uint32_t priority = nsIRunnablePriority::PRIORITY_NORMAL;
+    if (nsCOMPtr<nsIRunnablePriority> prio = do_QueryInterface(aEvent)) {
+      Unused << prio->GetPriority(&priority);
+    }
+    return priority;
+  }
+
+  nsresult
+  CurrentPriority(uint32_t* aPriority)
+  {
+    // Forward the priority of the runnable the executor was dispatched
+    // for, so that a prioritized base target can run the executor ahead
+    // of its normal events. The base target queries this synchronously
+    // while we hold mMutex, so the priority is published to an atomic
+    // when the executor is dispatched rather than peeked at here.
+    *aPriority = mExecutorPriority;
+    return NS_OK;
+  }
+
   void
   ExecuteRunnable()
   {
@@ -174,6 +213,8 @@ class ThrottledEventQueue::Inner final : public nsIObserver
         // Dispatch the next base target runnable to attempt to execute
         // the next throttled event.  We must do this before executing
         // the event in case the event spins the event loop.
+        nsCOMPtr<nsIRunnable> next = mEventQueue.PeekEvent(lock);
+        mExecutorPriority = PriorityOf(next);
         MOZ_ALWAYS_SUCCEEDS(
           mBaseTarget->Dispatch(mExecutor, NS_DISPATCH_NORMAL));
       }
@@ -328,13 +369,15 @@ public:
     MOZ_ASSERT(aFlags == NS_DISPATCH_NORMAL ||
                aFlags == NS_DISPATCH_AT_END);
 
+    nsCOMPtr<nsIRunnable> event(Move(aEvent));
+
     // Any thread
     MutexAutoLock lock(mMutex);
 
     // If we are shutting down, just fall back to our base target
     // directly.
     if (mShutdownStarted) {
-      return mBaseTarget->Dispatch(Move(aEvent), aFlags);
+      return mBaseTarget->Dispatch(event.forget(), aFlags);
     }
 
     // We are not currently processing events, so we must start
@@ -345,6 +388,9 @@ public:
       // Note, this creates a ref cycle keeping the inner alive
       // until the queue is drained.
       mExecutor = new Executor(this);
+      // The event being dispatched will be at the head of the queue, so
+      // the executor runs on its behalf and at its priority.
+      mExecutorPriority = PriorityOf(event);
       nsresult rv = mBaseTarget->Dispatch(mExecutor, NS_DISPATCH_NORMAL);
       if (NS_WARN_IF(NS_FAILED(rv))) {
         mExecutor = nullptr;
@@ -354,7 +400,7 @@ public:
 
     // Only add the event to the underlying queue if are able to
     // dispatch to our base target.
-    mEventQueue.PutEvent(Move(aEvent), EventPriority::Normal, lock);
+    mEventQueue.PutEvent(event.forget(), EventPriority::Normal, lock);
     return NS_OK;
   }
 
@@ -375,6 +421,10 @@ public:
   NS_DECL_THREADSAFE_ISUPPORTS
 };
 
+NS_IMPL_ISUPPORTS_INHERITED(ThrottledEventQueue::Inner::Executor,
+                            Runnable,
+                            nsIRunnablePriority)
+
 NS_IMPL_ISUPPORTS(ThrottledEventQueue::Inner, nsIObserver);
 
 NS_IMPL_ISUPPORTS(ThrottledEventQueue,
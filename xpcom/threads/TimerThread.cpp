@@ -17,6 +17,7 @@
 #include "mozilla/ArenaAllocator.h"
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/BinarySearch.h"
+#include "mozilla/Preferences.h"
 
 #include <math.h>
 
@@ -28,6 +29,14 @@ using namespace mozilla::tasktracer;
 
 NS_IMPL_ISUPPORTS(TimerThread, nsIRunnable, nsIObserver)
 
+// The slack window, in milliseconds, within which low-precision timers
+// (TYPE_ONE_SHOT_LOW_PRECISION and friends) may fire early or late so that
+// several timers can share one wakeup of the timer thread.
+#define TIMER_DEFAULT_COALESCING_SLACK_MS 50
+
+static mozilla::Atomic<uint32_t, mozilla::Relaxed>
+  sCoalescingSlackMs(TIMER_DEFAULT_COALESCING_SLACK_MS);
+
 TimerThread::TimerThread() :
   mInitialized(false),
   mMonitor("TimerThread.mMonitor"),
@@ -80,6 +89,9 @@ TimerObserverRunnable::Run()
     observerService->AddObserver(mObserver, "suspend_process_notification", false);
     observerService->AddObserver(mObserver, "resume_process_notification", false);
   }
+  Preferences::AddAtomicUintVarCache(&sCoalescingSlackMs,
+                                     "timer.coalescing_slack_ms",
+                                     TIMER_DEFAULT_COALESCING_SLACK_MS);
   return NS_OK;
 }
 
@@ -491,6 +503,14 @@ TimerThread::Run()
       if (!mTimers.IsEmpty()) {
         TimeStamp timeout = mTimers[0]->Value()->mTimeout;
 
+        // Low-precision timers may fire anywhere within a slack window
+        // around their deadline so that several of them can ride on a
+        // single wakeup.
+        TimeDuration slack;
+        if (mTimers[0]->Value()->IsLowPrecision()) {
+          slack = TimeDuration::FromMilliseconds(sCoalescingSlackMs);
+        }
+
         // Don't wait at all (even for PR_INTERVAL_NO_WAIT) if the next timer
         // is due now or overdue.
         //
@@ -512,10 +532,26 @@ TimerThread::Run()
           forceRunNextTimer = true;
         }
 
-        if (microseconds < mAllowedEarlyFiringMicroseconds) {
+        // Since we are already awake, fire a low-precision timer up to its
+        // slack early rather than scheduling another wakeup for it.
+        if (microseconds <
+            mAllowedEarlyFiringMicroseconds + slack.ToMicroseconds()) {
           forceRunNextTimer = false;
           goto next; // round down; execute event now
         }
+
+        // Otherwise sleep to the end of the slack window, unless some other
+        // timer is due before that: waking up for that timer will fire this
+        // one too (see above), coalescing the two wakeups.
+        if (slack != TimeDuration()) {
+          TimeStamp deadline = timeout + slack;
+          TimeStamp second = SecondTimerDeadlineInternal();
+          if (!second.IsNull() && second < deadline) {
+            deadline = second;
+          }
+          microseconds = (deadline - now).ToMilliseconds() * 1000;
+        }
+
         waitFor = PR_MicrosecondsToInterval(
           static_cast<uint32_t>(microseconds)); // Floor is accurate enough.
         if (waitFor == 0) {
@@ -694,6 +730,23 @@ TimerThread::AddTimerInternal(nsTimerImpl* aTimer)
   return true;
 }
 
+// Returns the deadline of the second-soonest timer in the heap, or a null
+// TimeStamp if there is at most one timer.  In a binary heap the second
+// smallest entry is the smaller of the root's two children, so this is O(1).
+TimeStamp
+TimerThread::SecondTimerDeadlineInternal()
+{
+  mMonitor.AssertCurrentThreadOwns();
+  if (mTimers.Length() < 2) {
+    return TimeStamp();
+  }
+  TimeStamp second = mTimers[1]->Timeout();
+  if (mTimers.Length() > 2 && mTimers[2]->Timeout() < second) {
+    second = mTimers[2]->Timeout();
+  }
+  return second;
+}
+
 bool
 TimerThread::RemoveTimerInternal(nsTimerImpl* aTimer)
 {
@@ -5,8 +5,111 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "nsProxyRelease.h"
+
+#include "mozilla/Logging.h"
+#include "mozilla/StaticMutex.h"
+#include "nsDataHashtable.h"
+#include "nsHashKeys.h"
+#include "nsTArray.h"
 #include "nsThreadUtils.h"
 
+using namespace mozilla;
+
+// Log module for proxy release instrumentation...
+//
+//    set MOZ_LOG=ProxyRelease:4
+//
+// This logs each proxied release with its labelling name and a running
+// count per name, which is useful for attributing cross-thread release
+// storms (e.g. media or necko tear-down) to the classes responsible.
+static LazyLogModule sProxyReleaseLog("ProxyRelease");
+
+namespace {
+
+// A buffer of doomed objects headed for a single event target.  Instead of
+// paying a dispatch and a full event-loop iteration for every proxied
+// release, releases are appended here and drained by a single
+// DrainProxyReleasesEvent per event-loop spin of the target.  An entry
+// exists in sProxyReleaseBatches exactly while a drain event is pending on
+// its target.
+struct ProxyReleaseBatch
+{
+  nsCOMPtr<nsIEventTarget> mTarget;
+  nsTArray<nsISupports*> mDoomed;
+};
+
+static StaticMutex sProxyReleaseLock;
+
+// Batches with a drain event in flight; usually holds at most one entry
+// (the main thread).  Created lazily and deliberately leaked.
+static nsTArray<ProxyReleaseBatch>* sProxyReleaseBatches;
+
+class DrainProxyReleasesEvent : public CancelableRunnable
+{
+public:
+  explicit DrainProxyReleasesEvent(nsIEventTarget* aTarget)
+    : CancelableRunnable("DrainProxyReleasesEvent")
+    , mTarget(aTarget)
+  {
+  }
+
+  NS_IMETHOD Run() override
+  {
+    nsTArray<nsISupports*> doomed;
+    {
+      StaticMutexAutoLock lock(sProxyReleaseLock);
+      for (size_t i = 0; i < sProxyReleaseBatches->Length(); ++i) {
+        ProxyReleaseBatch& batch = (*sProxyReleaseBatches)[i];
+        if (batch.mTarget == mTarget) {
+          doomed.SwapElements(batch.mDoomed);
+          // Removing the entry means the next proxied release to this
+          // target schedules a fresh drain event.
+          sProxyReleaseBatches->RemoveElementAt(i);
+          break;
+        }
+      }
+    }
+
+    MOZ_LOG(sProxyReleaseLog, LogLevel::Debug,
+            ("draining %zu proxied releases", doomed.Length()));
+
+    // Release with the lock dropped; releasing an object may recursively
+    // proxy further releases.
+    for (size_t i = 0; i < doomed.Length(); ++i) {
+      NS_RELEASE(doomed[i]);
+    }
+    return NS_OK;
+  }
+
+  nsresult Cancel() override
+  {
+    return Run();
+  }
+
+private:
+  nsCOMPtr<nsIEventTarget> mTarget;
+};
+
+// Tallies proxied releases per labelling name.  Only called when the log
+// module is enabled; the table is guarded by sProxyReleaseLock.
+static void
+CountProxiedRelease(const char* aName)
+{
+  static nsDataHashtable<nsCharPtrHashKey, uint32_t>* sCounts;
+
+  StaticMutexAutoLock lock(sProxyReleaseLock);
+  if (!sCounts) {
+    sCounts = new nsDataHashtable<nsCharPtrHashKey, uint32_t>();
+  }
+
+  const char* name = aName ? aName : "<unknown>";
+  uint32_t count = ++sCounts->GetOrInsert(name);
+  MOZ_LOG(sProxyReleaseLog, LogLevel::Info,
+          ("%s: %u proxied releases", name, count));
+}
+
+} // namespace
+
 namespace detail {
 
 /* static */ void
@@ -15,8 +118,69 @@ ProxyReleaseChooser<true>::ProxyReleaseISupports(const char* aName,
                                                  nsISupports* aDoomed,
                                                  bool aAlwaysProxy)
 {
-  ::detail::ProxyRelease<nsISupports>(aName, aTarget, dont_AddRef(aDoomed),
-                                      aAlwaysProxy);
+  // Auto-managing release of the pointer.
+  nsCOMPtr<nsISupports> doomed = dont_AddRef(aDoomed);
+
+  if (!doomed || !aTarget) {
+    return;
+  }
+
+  if (!aAlwaysProxy) {
+    bool onCurrentThread = false;
+    nsresult rv = aTarget->IsOnCurrentThread(&onCurrentThread);
+    if (NS_SUCCEEDED(rv) && onCurrentThread) {
+      return;
+    }
+  }
+
+  if (MOZ_LOG_TEST(sProxyReleaseLog, LogLevel::Info)) {
+    CountProxiedRelease(aName);
+  }
+
+  bool needDispatch;
+  {
+    StaticMutexAutoLock lock(sProxyReleaseLock);
+    if (!sProxyReleaseBatches) {
+      sProxyReleaseBatches = new nsTArray<ProxyReleaseBatch>();
+    }
+
+    ProxyReleaseBatch* batch = nullptr;
+    for (size_t i = 0; i < sProxyReleaseBatches->Length(); ++i) {
+      if ((*sProxyReleaseBatches)[i].mTarget == aTarget) {
+        batch = &(*sProxyReleaseBatches)[i];
+        break;
+      }
+    }
+
+    // If the target already has a drain event pending, that event absorbs
+    // this release and no dispatch is needed.
+    needDispatch = !batch;
+    if (!batch) {
+      batch = sProxyReleaseBatches->AppendElement();
+      batch->mTarget = aTarget;
+    }
+    batch->mDoomed.AppendElement(doomed.forget().take());
+  }
+
+  if (!needDispatch) {
+    return;
+  }
+
+  nsCOMPtr<nsIRunnable> ev = new DrainProxyReleasesEvent(aTarget);
+  nsresult rv = aTarget->Dispatch(ev.forget(), NS_DISPATCH_NORMAL);
+  if (NS_FAILED(rv)) {
+    NS_WARNING("failed to post proxy release event, leaking!");
+    // It is better to leak the doomed objects than risk crashing as a
+    // result of deleting them on the wrong thread.  Drop the batch entry
+    // so later releases to this target try a fresh dispatch.
+    StaticMutexAutoLock lock(sProxyReleaseLock);
+    for (size_t i = 0; i < sProxyReleaseBatches->Length(); ++i) {
+      if ((*sProxyReleaseBatches)[i].mTarget == aTarget) {
+        sProxyReleaseBatches->RemoveElementAt(i);
+        break;
+      }
+    }
+  }
 }
 
 } // namespace detail
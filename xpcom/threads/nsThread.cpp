@@ -20,10 +20,12 @@
 #include "nsAutoPtr.h"
 #include "nsCOMPtr.h"
 #include "nsQueryObject.h"
+#include "nsStringBuffer.h"
 #include "pratom.h"
 #include "mozilla/CycleCollectedJSContext.h"
 #include "mozilla/Logging.h"
 #include "nsIObserverService.h"
+#include "mozilla/EventLoopTaskLog.h"
 #include "mozilla/HangMonitor.h"
 #include "mozilla/IOInterposer.h"
 #include "mozilla/ipc/MessageChannel.h"
@@ -400,6 +402,10 @@ nsThread::ThreadFunc(void* aArg)
 
   mozilla::IOInterposer::RegisterCurrentThread();
 
+  // Let this thread recycle small string buffers; the matching
+  // ClearThreadCache() below runs before the thread exits.
+  nsStringBuffer::EnableThreadCache();
+
   // This must come after the call to nsThreadManager::RegisterCurrentThread(),
   // because that call is needed to properly set up this thread as an nsThread,
   // which profiler_register_thread() requires. See bug 1347007.
@@ -448,6 +454,10 @@ nsThread::ThreadFunc(void* aArg)
 
   mozilla::IOInterposer::UnregisterCurrentThread();
 
+  // Hand any cached string buffers back to the allocator.  String
+  // allocations after this point simply fall back to plain malloc/free.
+  nsStringBuffer::ClearThreadCache();
+
   // Inform the threadmanager that this thread is going away
   nsThreadManager::get().UnregisterCurrentThread(*self);
 
@@ -886,7 +896,6 @@ void canary_alarm_handler(int signum)
     }                                                                          \
   } while(0)
 
-#ifndef RELEASE_OR_BETA
 static bool
 GetLabeledRunnableName(nsIRunnable* aEvent, nsACString& aName)
 {
@@ -905,7 +914,6 @@ GetLabeledRunnableName(nsIRunnable* aEvent, nsACString& aName)
 
   return labeled;
 }
-#endif
 
 NS_IMETHODIMP
 nsThread::ProcessNextEvent(bool aMayWait, bool* aResult)
@@ -1034,7 +1042,28 @@ nsThread::ProcessNextEvent(bool aMayWait, bool* aResult)
       if (priority == EventPriority::Input) {
         timeDurationHelper.emplace();
       }
+
+      // Time the task when the long-task watchdog is enabled, so that slow
+      // main-thread tasks can be attributed in the field (see
+      // EventLoopTaskLog). The name has to be captured up front because a
+      // runnable may drop the state its GetName() reports while running.
+      nsAutoCString taskName;
+      TimeStamp taskStart;
+      uint32_t taskThresholdMs =
+        MAIN_THREAD == mIsMainThread ? EventLoopTaskLog::ThresholdMs() : 0;
+      if (taskThresholdMs) {
+        GetLabeledRunnableName(event, taskName);
+        taskStart = TimeStamp::Now();
+      }
+
       event->Run();
+
+      if (taskThresholdMs) {
+        double runMs = (TimeStamp::Now() - taskStart).ToMilliseconds();
+        if (runMs >= taskThresholdMs) {
+          EventLoopTaskLog::RecordTask(taskName, runMs);
+        }
+      }
     } else if (aMayWait) {
       MOZ_ASSERT(ShuttingDown(),
                  "This should only happen when shutting down");
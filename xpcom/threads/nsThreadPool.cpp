@@ -45,11 +45,15 @@ NS_IMPL_CI_INTERFACE_GETTER(nsThreadPool, nsIThreadPool, nsIEventTarget)
 nsThreadPool::nsThreadPool()
   : mMutex("[nsThreadPool.mMutex]")
   , mEventsAvailable(mMutex, "[nsThreadPool.mEventsAvailable]")
+  , mNextShard(0)
+  , mPendingEvents(0)
+  , mHaveAllThreads(false)
   , mThreadLimit(DEFAULT_THREAD_LIMIT)
   , mIdleThreadLimit(DEFAULT_IDLE_THREAD_LIMIT)
   , mIdleThreadTimeout(DEFAULT_IDLE_THREAD_TIMEOUT)
   , mIdleCount(0)
   , mStackSize(nsIThreadManager::DEFAULT_STACK_SIZE)
+  , mUseWorkStealing(false)
   , mShutdown(false)
 {
   LOG(("THRD-P(%p) constructor!!!\n", this));
@@ -72,6 +76,10 @@ nsThreadPool::PutEvent(nsIRunnable* aEvent)
 nsresult
 nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
 {
+  if (mUseWorkStealing) {
+    return PutEventWorkStealing(Move(aEvent), aFlags);
+  }
+
   // Avoid spawning a new thread while holding the event queue lock...
 
   bool spawnThread = false;
@@ -105,9 +113,99 @@ nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
     return NS_OK;
   }
 
+  return SpawnThread(stackSize);
+}
+
+nsresult
+nsThreadPool::PutEventWorkStealing(already_AddRefed<nsIRunnable> aEvent,
+                                   uint32_t aFlags)
+{
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  // Enqueue on a round-robin shard under that shard's lock only.  The shard
+  // array is fixed for the lifetime of the pool's threads, so it is safe to
+  // index it without mMutex.
+  uint32_t shard = ++mNextShard % mWorkerQueues.Length();
+  {
+    WorkerQueue* queue = mWorkerQueues[shard].get();
+    MutexAutoLock lock(queue->mMutex);
+    // Recheck under the shard lock.  Shutdown() sets mShutdown and then
+    // visits every shard under its lock after the workers have exited, so
+    // either this push lands before that visit and the event is drained
+    // there (or by a still-running worker), or this recheck observes the
+    // shutdown and the dispatch fails cleanly.
+    if (NS_WARN_IF(mShutdown)) {
+      return NS_ERROR_NOT_AVAILABLE;
+    }
+    queue->mEvents.PutEvent(Move(aEvent), EventPriority::Normal, lock);
+  }
+  ++mPendingEvents;
+
+  // Only touch the pool-wide mutex when a sleeping worker needs a wakeup or
+  // when a new thread may need to be spawned.  The push above is ordered
+  // before this read, and workers publish a nonzero mIdleCount before their
+  // final queue recheck (see Run()), so one side always sees the other and
+  // the wakeup cannot be lost.  Under steady load with all threads busy
+  // this dispatch path never contends on mMutex.
+  if (mIdleCount == 0 && mHaveAllThreads) {
+    return NS_OK;
+  }
+
+  bool spawnThread = false;
+  uint32_t stackSize = 0;
+  {
+    MutexAutoLock lock(mMutex);
+    if (mShutdown) {
+      // The event was already handed off to a shard above and will be run
+      // by a draining worker or by Shutdown() itself; just don't spawn a
+      // new thread.
+      return NS_OK;
+    }
+    if (mThreads.Count() < (int32_t)mThreadLimit &&
+        !(aFlags & NS_DISPATCH_AT_END) &&
+        mPendingEvents >= mIdleCount) {
+      spawnThread = true;
+    }
+    mEventsAvailable.Notify();
+    stackSize = mStackSize;
+  }
+
+  if (!spawnThread) {
+    return NS_OK;
+  }
+
+  return SpawnThread(stackSize);
+}
+
+already_AddRefed<nsIRunnable>
+nsThreadPool::TakeEventWorkStealing(uint32_t aPreferredShard)
+{
+  if (mPendingEvents == 0) {
+    return nullptr;
+  }
+
+  // Drain our own shard first; once it is empty, steal from the others.
+  uint32_t shardCount = mWorkerQueues.Length();
+  for (uint32_t i = 0; i < shardCount; ++i) {
+    WorkerQueue* queue = mWorkerQueues[(aPreferredShard + i) % shardCount].get();
+    MutexAutoLock lock(queue->mMutex);
+    nsCOMPtr<nsIRunnable> event = queue->mEvents.GetEvent(nullptr, lock);
+    if (event) {
+      --mPendingEvents;
+      return event.forget();
+    }
+  }
+  return nullptr;
+}
+
+nsresult
+nsThreadPool::SpawnThread(uint32_t aStackSize)
+{
   nsCOMPtr<nsIThread> thread;
   nsresult rv = NS_NewNamedThread(mThreadNaming.GetNextThreadName(mName),
-                                  getter_AddRefs(thread), nullptr, stackSize);
+                                  getter_AddRefs(thread), nullptr, aStackSize);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     return NS_ERROR_UNEXPECTED;
   }
@@ -117,6 +215,9 @@ nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
     MutexAutoLock lock(mMutex);
     if (mThreads.Count() < (int32_t)mThreadLimit) {
       mThreads.AppendObject(thread);
+      if (mThreads.Count() == (int32_t)mThreadLimit) {
+        mHaveAllThreads = true;
+      }
     } else {
       killThread = true;  // okay, we don't need this thread anymore
     }
@@ -175,12 +276,45 @@ nsThreadPool::Run()
     listener->OnThreadCreated();
   }
 
+  const bool workStealing = mUseWorkStealing;
+  uint32_t preferredShard = 0;
+  if (workStealing) {
+    MutexAutoLock lock(mMutex);
+    int32_t index = mThreads.IndexOf(current);
+    if (index >= 0 && !mWorkerQueues.IsEmpty()) {
+      preferredShard = static_cast<uint32_t>(index) % mWorkerQueues.Length();
+    }
+  }
+
   do {
     nsCOMPtr<nsIRunnable> event;
-    {
+    if (workStealing) {
+      // Fast path: take an event without touching the pool-wide mutex.
+      event = TakeEventWorkStealing(preferredShard);
+      if (event && wasIdle) {
+        wasIdle = false;
+        --mIdleCount;
+      }
+    }
+    if (!event) {
       MutexAutoLock lock(mMutex);
 
-      event = mEvents.GetEvent(nullptr, lock);
+      if (workStealing) {
+        // Announce that we are about to go idle *before* the final queue
+        // recheck.  PutEventWorkStealing pushes its event before reading
+        // mIdleCount, so either the recheck below sees that event or the
+        // dispatcher sees a nonzero idle count and takes mMutex to notify
+        // us; the wakeup cannot be lost.  This is the same handshake
+        // ThreadEventQueue's consumer performs with mConsumerSleeping.
+        if (!wasIdle) {
+          wasIdle = true;
+          idleSince = PR_IntervalNow();
+          ++mIdleCount;
+        }
+        event = TakeEventWorkStealing(preferredShard);
+      } else {
+        event = mEvents.GetEvent(nullptr, lock);
+      }
       if (!event) {
         PRIntervalTime now     = PR_IntervalNow();
         PRIntervalTime timeout = PR_MillisecondsToInterval(mIdleThreadTimeout);
@@ -212,6 +346,9 @@ nsThreadPool::Run()
             --mIdleCount;
           }
           shutdownThreadOnExit = mThreads.RemoveObject(current);
+          if (shutdownThreadOnExit) {
+            mHaveAllThreads = false;
+          }
         } else {
           PRIntervalTime delta = timeout - (now - idleSince);
           LOG(("THRD-P(%p) %s waiting [%d]\n", this, mName.BeginReading(), delta));
@@ -344,6 +481,31 @@ nsThreadPool::Shutdown()
     threads[i]->Shutdown();
   }
 
+  // With work stealing, a dispatcher can pass its first shutdown check and
+  // then push into a shard without ever taking mMutex.  All workers are
+  // gone by now, so visit every shard: taking each shard lock here means
+  // any later dispatch sees mShutdown under that lock and fails, and any
+  // event that landed first is run here so a dispatch that reported
+  // success is never dropped.
+  for (uint32_t i = 0; i < mWorkerQueues.Length(); ++i) {
+    WorkerQueue* queue = mWorkerQueues[i].get();
+    for (;;) {
+      nsCOMPtr<nsIRunnable> event;
+      {
+        MutexAutoLock lock(queue->mMutex);
+        event = queue->mEvents.GetEvent(nullptr, lock);
+      }
+      if (!event) {
+        break;
+      }
+      // The matching increment may still be in flight in the dispatcher;
+      // any transient underflow corrects itself once it lands, and nothing
+      // consults mPendingEvents after shutdown.
+      --mPendingEvents;
+      event->Run();
+    }
+  }
+
   return NS_OK;
 }
 
@@ -364,12 +526,50 @@ nsThreadPool::SetThreadLimit(uint32_t aValue)
     mIdleThreadLimit = mThreadLimit;
   }
 
+  // The work-stealing shard array is sized once, in SetUseWorkStealing, and
+  // never resized afterwards: dispatchers index it without holding mMutex,
+  // so growing it here could race with a concurrent dispatch.  If the
+  // thread limit changes later the shard count simply no longer matches the
+  // worker count; extra workers share shards, and workers drain shards
+  // beyond their own by stealing from them.
+
   if (static_cast<uint32_t>(mThreads.Count()) > mThreadLimit) {
     mEventsAvailable.NotifyAll();  // wake up threads so they observe this change
   }
   return NS_OK;
 }
 
+NS_IMETHODIMP
+nsThreadPool::GetUseWorkStealing(bool* aValue)
+{
+  *aValue = mUseWorkStealing;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsThreadPool::SetUseWorkStealing(bool aValue)
+{
+  MutexAutoLock lock(mMutex);
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  // The shard array must be sized before the pool has any threads or
+  // pending events so that the dispatch path can read it without locking.
+  if (NS_WARN_IF(!mThreads.IsEmpty() || !mEvents.IsEmpty(lock) ||
+                 mPendingEvents > 0)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  LOG(("THRD-P(%p) work stealing [%d]\n", this, aValue));
+  mWorkerQueues.Clear();
+  if (aValue) {
+    for (uint32_t i = 0; i < mThreadLimit; ++i) {
+      mWorkerQueues.AppendElement(MakeUnique<WorkerQueue>());
+    }
+  }
+  mUseWorkStealing = aValue;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsThreadPool::GetIdleThreadLimit(uint32_t* aValue)
 {
@@ -15,9 +15,12 @@
 #include "nsThreadUtils.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/AlreadyAddRefed.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/EventQueue.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/Monitor.h"
+#include "mozilla/UniquePtr.h"
+#include "nsTArray.h"
 
 class nsThreadPool final
   : public nsIThreadPool
@@ -34,21 +37,47 @@ public:
 private:
   ~nsThreadPool();
 
+  // One shard of the work-stealing queue.  Each shard has its own lock so
+  // that dispatchers landing on different shards do not contend with each
+  // other or with the pool-wide mutex.
+  struct WorkerQueue
+  {
+    WorkerQueue()
+      : mMutex("nsThreadPool.WorkerQueue.mMutex")
+    {}
+    mozilla::Mutex mMutex;
+    mozilla::EventQueue mEvents;
+  };
+
   void ShutdownThread(nsIThread* aThread);
   nsresult PutEvent(nsIRunnable* aEvent);
   nsresult PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags);
+  nsresult PutEventWorkStealing(already_AddRefed<nsIRunnable> aEvent,
+                                uint32_t aFlags);
+  already_AddRefed<nsIRunnable> TakeEventWorkStealing(uint32_t aPreferredShard);
+  nsresult SpawnThread(uint32_t aStackSize);
 
   nsCOMArray<nsIThread> mThreads;
   mozilla::Mutex        mMutex;
   mozilla::CondVar      mEventsAvailable;
   mozilla::EventQueue   mEvents;
+  // Non-empty iff work stealing was enabled before the first dispatch.  The
+  // array is sized once, in SetUseWorkStealing, and never resized
+  // afterwards, so the dispatch path may index it without holding mMutex.
+  nsTArray<mozilla::UniquePtr<WorkerQueue>> mWorkerQueues;
+  mozilla::Atomic<uint32_t> mNextShard;
+  mozilla::Atomic<uint32_t> mPendingEvents;
+  mozilla::Atomic<bool>     mHaveAllThreads;
   uint32_t              mThreadLimit;
   uint32_t              mIdleThreadLimit;
   uint32_t              mIdleThreadTimeout;
-  uint32_t              mIdleCount;
+  mozilla::Atomic<uint32_t> mIdleCount;
   uint32_t              mStackSize;
   nsCOMPtr<nsIThreadPoolListener> mListener;
-  bool                  mShutdown;
+  mozilla::Atomic<bool, mozilla::Relaxed> mUseWorkStealing;
+  // Written under mMutex, but also read without it by Dispatch() and the
+  // work-stealing dispatch path (which rechecks it under the shard lock).
+  mozilla::Atomic<bool, mozilla::ReleaseAcquire> mShutdown;
   nsCString             mName;
   nsThreadPoolNaming    mThreadNaming;
 };
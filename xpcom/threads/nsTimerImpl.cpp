@@ -561,8 +561,11 @@ nsTimerImpl::LogFiring(const Callback& aCallback, uint8_t aType, uint32_t aDelay
   switch (aType) {
     case nsITimer::TYPE_ONE_SHOT:                     typeStr = "ONE_SHOT  "; break;
     case nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY:        typeStr = "ONE_LOW   "; break;
+    case nsITimer::TYPE_ONE_SHOT_LOW_PRECISION:       typeStr = "ONE_COARSE"; break;
     case nsITimer::TYPE_REPEATING_SLACK:              typeStr = "SLACK     "; break;
     case nsITimer::TYPE_REPEATING_SLACK_LOW_PRIORITY: typeStr = "SLACK_LOW "; break;
+    case nsITimer::TYPE_REPEATING_SLACK_LOW_PRECISION:
+                                                      typeStr = "SLACK_CRSE"; break;
     case nsITimer::TYPE_REPEATING_PRECISE:          /* fall through */
     case nsITimer::TYPE_REPEATING_PRECISE_CAN_SKIP:   typeStr = "PRECISE   "; break;
     default:                              MOZ_CRASH("bad type");
@@ -156,8 +156,9 @@ public:
         nsITimer::TYPE_REPEATING_PRECISE <
           nsITimer::TYPE_REPEATING_PRECISE_CAN_SKIP,
         "invalid ordering of timer types!");
-    return mType >= nsITimer::TYPE_REPEATING_SLACK &&
-           mType < nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY;
+    return (mType >= nsITimer::TYPE_REPEATING_SLACK &&
+            mType < nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY) ||
+           mType == nsITimer::TYPE_REPEATING_SLACK_LOW_PRECISION;
   }
 
   bool IsLowPriority() const
@@ -169,7 +170,14 @@ public:
   bool IsSlack() const
   {
     return mType == nsITimer::TYPE_REPEATING_SLACK ||
-           mType == nsITimer::TYPE_REPEATING_SLACK_LOW_PRIORITY;
+           mType == nsITimer::TYPE_REPEATING_SLACK_LOW_PRIORITY ||
+           mType == nsITimer::TYPE_REPEATING_SLACK_LOW_PRECISION;
+  }
+
+  bool IsLowPrecision() const
+  {
+    return mType == nsITimer::TYPE_ONE_SHOT_LOW_PRECISION ||
+           mType == nsITimer::TYPE_REPEATING_SLACK_LOW_PRECISION;
   }
 
   void GetName(nsACString& aName);
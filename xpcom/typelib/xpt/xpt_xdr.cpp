@@ -39,11 +39,13 @@ CHECK_COUNT(NotNull<XPTCursor*> cursor, uint32_t space)
 }
 
 XPT_PUBLIC_API(void)
-XPT_InitXDRState(XPTState* state, char *data, uint32_t len)
+XPT_InitXDRState(XPTState* state, char *data, uint32_t len,
+                 bool data_is_persistent)
 {
     state->next_cursor[0] = state->next_cursor[1] = 1;
     state->pool_data = data;
     state->pool_allocated = len;
+    state->data_is_persistent = data_is_persistent;
 }
 
 /* All offsets are 1-based */
@@ -127,6 +129,14 @@ XPT_DoCString(XPTArena *arena, NotNull<XPTCursor*> cursor, char **identp,
     XPT_ASSERT(len > 0);
 
     if (!ignore) {
+        /* Strings in the data pool are null-terminated in the image, so when
+         * the pool is persistent we can hand out a pointer into it rather
+         * than making an arena copy of every identifier. */
+        if (cursor->state->data_is_persistent) {
+            *identp = start;
+            return true;
+        }
+
         char *ident = (char*)XPT_CALLOC1(arena, len + 1u);
         if (!ident)
             return false;
@@ -57,6 +57,10 @@ struct XPTState {
     uint32_t         next_cursor[2];
     char             *pool_data;
     uint32_t         pool_allocated;
+    /* True if pool_data outlives everything decoded from it, in which case
+     * strings are returned as pointers into the pool instead of arena
+     * copies. */
+    bool             data_is_persistent;
 };
 
 struct XPTCursor {
@@ -67,7 +71,8 @@ struct XPTCursor {
 };
 
 extern XPT_PUBLIC_API(void)
-XPT_InitXDRState(XPTState* state, char* data, uint32_t len);
+XPT_InitXDRState(XPTState* state, char* data, uint32_t len,
+                 bool data_is_persistent = false);
 
 extern XPT_PUBLIC_API(bool)
 XPT_MakeCursor(XPTState *state, XPTPool pool, uint32_t len,